@@ -21,6 +21,16 @@
 // Include the full set of available modules.
 #include "../source/modules.hpp"
 
+// Optionally, a VirtualCPUOrg instruction set compiled in ahead of time ('make compiled').
+#ifdef MABE_COMPILED_INST_SET
+#include MABE_COMPILED_INST_SET
+#endif
+
+// Optionally, event actions compiled to C++ by 'MABE --emit-cpp' ('make aot').
+#ifdef MABE_NATIVE_EVENTS
+#include MABE_NATIVE_EVENTS
+#endif
+
 int main(int argc, char* argv[])
 {
   // Build the MABE controller, passing in the command-line arguments.
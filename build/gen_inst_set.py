@@ -0,0 +1,147 @@
+"""Generate a compiled VirtualCPUOrg instruction set from an instruction set file.
+
+Usage: python3 gen_inst_set.py INST_SET_FILE [-o OUTPUT.hpp]    (default: CompiledInstSet.hpp)
+
+The instruction modules in source/orgs/instructions are scanned to find the member function
+behind each instruction name. The header written holds the instruction names as a constexpr
+table, plus a single Dispatch() function. Dispatch() switches on the instruction ID and calls
+each instruction's member function directly, so the compiler can inline the bodies.
+Including the header (e.g., 'make compiled') registers it with VirtualCPUOrg. VirtualCPUOrg
+uses it when inst_set_input_filename lists the same instructions. Otherwise it keeps the
+usual per-instruction functions.
+"""
+import os
+import re
+import sys
+
+SOURCE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'source')
+INST_DIR = os.path.join(SOURCE_DIR, 'orgs', 'instructions')
+
+CLASS_RE = re.compile(r'class\s+(\w+)\s*:\s*public\s+Module\b')
+FUNC_RE = re.compile(r'(\w+)\s*=\s*\[this\]\([^)]*\)\s*\{\s*(\w+)\(hw,\s*inst\);\s*\}')
+ADD_RE = re.compile(r'AddFunc<[^>]*>\(\s*(".*?"|[^,]+?)\s*,\s*(\w+)\s*\)', re.S)
+PREFIX_RE = re.compile(r'std::string\s+(\w+)\s*=\s*"(\w*)"')
+
+
+def scan_instructions():
+    """Map each instruction name (or 'prefix*' for lettered families) to (class, method, file)."""
+    insts = {}
+    for filename in sorted(os.listdir(INST_DIR)):
+        if not filename.endswith('.hpp'):
+            continue
+        with open(os.path.join(INST_DIR, filename)) as f:
+            code = f.read()
+        class_match = CLASS_RE.search(code)
+        if not class_match:
+            continue
+        funcs = dict(FUNC_RE.findall(code))
+        prefixes = dict(PREFIX_RE.findall(code))
+        for name_expr, func_var in ADD_RE.findall(code):
+            if func_var not in funcs:
+                continue
+            if name_expr.startswith('"'):
+                name = name_expr.strip('"')
+            elif name_expr.split()[0] in prefixes:     # e.g., s + (char)('A' + i)
+                name = prefixes[name_expr.split()[0]] + '*'
+            else:
+                continue
+            insts[name] = (class_match.group(1), funcs[func_var], filename)
+    return insts
+
+
+def find_inst(insts, name):
+    if name in insts:
+        return insts[name]
+    for pattern, info in insts.items():
+        if pattern.endswith('*') and name[:-1] == pattern[:-1] and len(name) == len(pattern):
+            if 'A' <= name[-1] <= 'Z':
+                return info
+    return None
+
+
+def read_inst_set(filename):
+    """Instruction names, as VirtualCPUOrg reads them (comments, spaces and blank lines removed)."""
+    names = []
+    with open(filename) as f:
+        for line in f:
+            line = re.split(r'//|#', line)[0]
+            line = ''.join(line.split())
+            if line:
+                names.append(line)
+    return names
+
+
+def generate(inst_set_file, output_file):
+    names = read_inst_set(inst_set_file)
+    insts = scan_instructions()
+    calls = []
+    for name in names:
+        info = find_inst(insts, name)
+        if info is None:
+            sys.exit(f"Error: instruction '{name}' not found in {INST_DIR}")
+        calls.append(info)
+    classes = sorted({cls: filename for cls, _, filename in calls}.items())
+    include_dir = os.path.relpath(INST_DIR, os.path.dirname(os.path.abspath(output_file)))
+
+    out = [f"// Generated by build/gen_inst_set.py from {os.path.basename(inst_set_file)}; do not edit.",
+           "",
+           "#ifndef MABE_COMPILED_INST_SET_H",
+           "#define MABE_COMPILED_INST_SET_H",
+           "",
+           "#include <array>",
+           ""]
+    out += [f'#include "{include_dir}/{filename}"' for _, filename in classes]
+    out += ["",
+            "namespace mabe::compiled_inst_set {",
+            "  using org_t = VirtualCPUOrg;",
+            "",
+            f"  constexpr std::array<const char *, {len(names)}> names = {{",
+            *[f'    "{name}",' for name in names],
+            "  };",
+            ""]
+    out += [f"  inline emp::Ptr<{cls}> mod_{cls} = nullptr;" for cls, _ in classes]
+    out += ["",
+            "  /// Find the first module of the given type.",
+            "  template <typename MOD_T>",
+            "  bool FindModule(MABE & control, emp::Ptr<MOD_T> & mod_ptr) {",
+            "    for (size_t mod_id = 0; mod_id < control.GetNumModules(); ++mod_id) {",
+            "      MOD_T * found = dynamic_cast<MOD_T *>(&control.GetModule((int) mod_id));",
+            "      if (found) { mod_ptr = found; return true; }",
+            "    }",
+            "    return false;",
+            "  }",
+            "",
+            "  inline bool Bind(MABE & control) {",
+            "    return " + "\n        && ".join(f"FindModule(control, mod_{cls})" for cls, _ in classes) + ";",
+            "  }",
+            "",
+            "  inline void Dispatch(org_t & hw, const org_t::inst_t & inst) {",
+            "    switch (inst.id) {"]
+    out += [f"    case {inst_id}: mod_{cls}->{method}(hw, inst); return;    // {name}"
+            for inst_id, (name, (cls, method, _)) in enumerate(zip(names, calls))]
+    out += ["    }",
+            "  }",
+            "",
+            "  inline const bool registered =",
+            "    org_t::SetCompiledInstSet({ {names.begin(), names.end()}, Bind, Dispatch });",
+            "}",
+            "",
+            "#endif",
+            ""]
+    with open(output_file, 'w') as f:
+        f.write("\n".join(out))
+
+
+if __name__ == '__main__':
+    args = sys.argv[1:]
+    output = 'CompiledInstSet.hpp'
+    if '-o' in args:
+        pos = args.index('-o')
+        if pos + 1 >= len(args):
+            sys.exit(__doc__)
+        output = args[pos + 1]
+        del args[pos:pos + 2]
+    if len(args) != 1:
+        print(__doc__)
+        sys.exit(2)
+    generate(args[0], output)
@@ -0,0 +1,49 @@
+"""Read a DataFile written with format = "binary" into a dict of numpy arrays (by column name).
+
+Usage: python3 read_binary.py output.bin    (prints column names and row counts)
+"""
+import struct
+import sys
+
+import numpy as np
+
+
+def read_binary(filename):
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'MABECOL1':
+        raise ValueError(f"'{filename}' is not a MABE binary DataFile")
+    pos = 8
+    (num_cols,) = struct.unpack_from('<I', data, pos)
+    pos += 4
+    names, is_string = [], []
+    for _ in range(num_cols):
+        (name_len,) = struct.unpack_from('<I', data, pos)
+        pos += 4
+        names.append(data[pos:pos + name_len].decode())
+        pos += name_len
+        is_string.append(data[pos] == 1)
+        pos += 1
+
+    chunks = [[] for _ in range(num_cols)]
+    while pos < len(data):
+        (num_rows,) = struct.unpack_from('<Q', data, pos)
+        pos += 8
+        for col in range(num_cols):
+            if not is_string[col]:
+                chunks[col].append(np.frombuffer(data, dtype='<f8', count=num_rows, offset=pos))
+                pos += 8 * num_rows
+                continue
+            ends = np.frombuffer(data, dtype='<u8', count=num_rows, offset=pos)
+            pos += 8 * num_rows
+            starts = np.concatenate(([0], ends[:-1]))
+            chunks[col].append(np.array([data[pos + s:pos + e].decode() for s, e in zip(starts, ends)]))
+            pos += int(ends[-1]) if num_rows else 0
+
+    return {name: (np.concatenate(parts) if parts else np.array([]))
+            for name, parts in zip(names, chunks)}
+
+
+if __name__ == '__main__':
+    for name, values in read_binary(sys.argv[1]).items():
+        print(f"{name}: {len(values)} rows")
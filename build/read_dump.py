@@ -0,0 +1,63 @@
+"""Rebuild a population from a PopulationDump file, including differential dumps.
+
+Usage: python3 read_dump.py population.csv [UPDATE]    (or a format = "binary" dump)
+
+Prints the organisms, as of the last dump at or before UPDATE (default: the last dump), as
+CSV rows of position and traits.  In differential files, change 0 starts a keyframe (the
+population is replaced), 1 and 2 set a position's traits, and 3 empties it.  A keyframe with
+no living organisms has no rows, so it cannot be seen; the previous organisms stay listed.
+"""
+import csv
+import sys
+
+KEYFRAME, PLACED, CHANGED, REMOVED = range(4)
+
+
+def read_rows(filename):
+    """Return (trait names, rows) with each row as (update, position, change, trait values)."""
+    with open(filename, 'rb') as f:
+        is_binary = f.read(8) == b'MABECOL1'
+    if is_binary:
+        from read_binary import read_binary     # Needs numpy; csv files do not.
+        columns = read_binary(filename)
+        names = [name for name in columns if name not in ('update', 'position', 'change')]
+        num_rows = len(columns['update'])
+        changes = columns.get('change', [KEYFRAME] * num_rows)
+        rows = [(int(columns['update'][i]), int(columns['position'][i]), int(changes[i]),
+                 [columns[name][i] for name in names]) for i in range(num_rows)]
+        return names, rows
+
+    with open(filename, newline='') as f:
+        reader = csv.reader(f)
+        header = next(reader)
+        has_change = len(header) > 2 and header[2] == 'change'
+        first_trait = 3 if has_change else 2
+        rows = [(int(row[0]), int(row[1]), int(row[2]) if has_change else KEYFRAME, row[first_trait:])
+                for row in reader]
+        return header[first_trait:], rows
+
+
+def rebuild(rows, update=None):
+    """Return {position: trait values} as of the last dump at or before 'update'."""
+    orgs = {}
+    last_update = None
+    for row_update, pos, change, values in rows:
+        if update is not None and row_update > update:
+            break
+        if change == KEYFRAME and row_update != last_update:
+            orgs = {}                   # A new keyframe replaces the whole population.
+        last_update = row_update
+        if change == REMOVED:
+            orgs.pop(pos, None)
+        else:
+            orgs[pos] = values
+    return orgs
+
+
+if __name__ == '__main__':
+    names, rows = read_rows(sys.argv[1])
+    orgs = rebuild(rows, int(sys.argv[2]) if len(sys.argv) > 2 else None)
+    writer = csv.writer(sys.stdout)
+    writer.writerow(['position'] + names)
+    for pos in sorted(orgs):
+        writer.writerow([pos] + list(orgs[pos]))
@@ -0,0 +1,39 @@
+"""Read an instruction trace written by VirtualCPUOrg (trace_size > 0) and print it.
+
+Usage: python3 read_trace.py trace.mtr [position]    (one line per traced instruction)
+
+Each line shows: update [position] instruction_pointer: instruction (insts executed so far)
+"""
+import struct
+import sys
+
+
+def read_trace(filename):
+    """Return (op_names, records), with records as (time, source, site, op, value) tuples."""
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'MABETRC1':
+        raise ValueError(f"'{filename}' is not a MABE trace file")
+    pos = 8
+    (num_ops,) = struct.unpack_from('<I', data, pos)
+    pos += 4
+    op_names = []
+    for _ in range(num_ops):
+        (name_len,) = struct.unpack_from('<I', data, pos)
+        pos += 4
+        op_names.append(data[pos:pos + name_len].decode())
+        pos += name_len
+    (num_records,) = struct.unpack_from('<Q', data, pos)
+    pos += 8
+    records = list(struct.iter_unpack('<QIIII', data[pos:pos + 24 * num_records]))
+    return op_names, records
+
+
+if __name__ == '__main__':
+    op_names, records = read_trace(sys.argv[1])
+    only_source = int(sys.argv[2]) if len(sys.argv) > 2 else None
+    for time, source, site, op, value in records:
+        if only_source is not None and source != only_source:
+            continue
+        name = op_names[op] if op < len(op_names) else f"op{op}"
+        print(f"{time} [{source}] {site}: {name} ({value})")
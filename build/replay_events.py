@@ -0,0 +1,99 @@
+"""Replay an event log written by the LogEvents module to rebuild the run's phylogeny.
+
+Usage: python3 replay_events.py events.mel [phylogeny.csv]    (ALife standard phylogeny format)
+       python3 replay_events.py events.mel --lineage POP POS   (lineage of the org now at POP:POS)
+
+A lineage is printed from the organism back to its injected ancestor, one line per organism:
+replay ID, birth update, and genome ID (look genomes up in the ArchiveGenomes archive).
+"""
+import sys
+
+INJECT, BIRTH, DEATH, SWAP, POP_SWAP = range(5)
+ALIVE = None
+
+
+def read_varint(data, pos):
+    value, shift = 0, 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def read_events(filename):
+    """Return records as (update, kind, pop, pos, other_pop, other_pos, genome_id) tuples."""
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'MABEEVT1':
+        raise ValueError(f"'{filename}' is not a MABE event log")
+    pos = 8
+    records = []
+    while pos < len(data):
+        count, pos = read_varint(data, pos)
+        _, pos = read_varint(data, pos)           # Block size in bytes.
+        update = 0
+        for _ in range(count):
+            delta, pos = read_varint(data, pos)
+            update += delta
+            kind = data[pos]
+            pos += 1
+            fields = []
+            for _ in range(5):
+                value, pos = read_varint(data, pos)
+                fields.append(value)
+            org_pop, org_pos, other_pop, other_pos, genome = fields
+            records.append((update, kind, org_pop, org_pos, other_pop,
+                            other_pos - 1 if other_pos else None, genome - 1 if genome else None))
+    return records
+
+
+def replay(records):
+    """Return (orgs, occupant): orgs as [parent, genome_id, birth, death] by replay ID."""
+    orgs, occupant = [], {}
+    for update, kind, pop, pos, other_pop, other_pos, genome in records:
+        if kind in (INJECT, BIRTH):
+            parent = occupant.get((other_pop, other_pos)) if kind == BIRTH else None
+            orgs.append([parent, genome, update, ALIVE])
+            occupant[(pop, pos)] = len(orgs) - 1
+        elif kind == DEATH:
+            org_id = occupant.pop((pop, pos), None)
+            if org_id is not None:
+                orgs[org_id][3] = update
+        elif kind == SWAP:
+            org1 = occupant.pop((pop, pos), None)
+            org2 = occupant.pop((other_pop, other_pos), None)
+            if org2 is not None:
+                occupant[(pop, pos)] = org2
+            if org1 is not None:
+                occupant[(other_pop, other_pos)] = org1
+        elif kind == POP_SWAP:
+            swap = {pop: other_pop, other_pop: pop}
+            occupant = {(swap.get(p, p), q): org_id for (p, q), org_id in occupant.items()}
+    return orgs, occupant
+
+
+def write_phylogeny(orgs, out):
+    out.write("id,ancestor_list,origin_time,destruction_time,genome_id\n")
+    for org_id, (parent, genome, birth, death) in enumerate(orgs):
+        ancestors = "none" if parent is None else parent
+        death = "inf" if death is ALIVE else death
+        genome = "" if genome is None else genome
+        out.write(f"{org_id},[{ancestors}],{birth},{death},{genome}\n")
+
+
+if __name__ == '__main__':
+    orgs, occupant = replay(read_events(sys.argv[1]))
+    if len(sys.argv) > 4 and sys.argv[2] == '--lineage':
+        org_id = occupant.get((int(sys.argv[3]), int(sys.argv[4])))
+        while org_id is not None:
+            parent, genome, birth, _ = orgs[org_id]
+            print(f"{org_id} {birth} {'' if genome is None else genome}")
+            org_id = parent
+    elif len(sys.argv) > 2:
+        with open(sys.argv[2], 'w') as out:
+            write_phylogeny(orgs, out)
+    else:
+        write_phylogeny(orgs, sys.stdout)
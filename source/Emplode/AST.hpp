@@ -11,11 +11,16 @@
 #ifndef EMPLODE_AST_HPP
 #define EMPLODE_AST_HPP
 
+#include <array>
+#include <span>
+#include <type_traits>
+
 #include "emp/base/assert.hpp"
 #include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
 #include "emp/tools/String.hpp"
 
+#include "Arena.hpp"
 #include "Symbol.hpp"
 #include "Symbol_Scope.hpp"
 #include "Symbol_Object.hpp"
@@ -24,7 +29,7 @@
 namespace emplode {
 
   /// Base class for all AST Nodes.
-  class ASTNode {
+  class ASTNode : public ArenaAllocated {
   protected:
     using symbol_ptr_t = emp::Ptr<Symbol>;
     using symbol_vector_t = emp::vector<symbol_ptr_t>;
@@ -74,17 +79,31 @@ namespace emplode {
       if (out && out->IsTemporary()) out.Delete();
     }
 
-    /// Run process, convert the return value to a double, and clean up the symbol if needed.
+    /// Run process and return the result as a double.  Nodes that can calculate a number
+    /// without building a temporary Symbol for it override this.
+    virtual double ProcessDouble() { return SymbolAs<double>(Process()); }
+
+    /// Convert a symbol returned by Process() to the given type, deleting it if temporary.
     template <typename T>
-    T ProcessAs() {
-      symbol_ptr_t symbol_ptr = Process();                // Run process, collecting the result.
+    static T SymbolAs(symbol_ptr_t symbol_ptr) {
       if (!symbol_ptr) return T();                        // Any non value will return a zero.
       T result = symbol_ptr->As<T>();                     // Convert the result to the return type.
       if (symbol_ptr->IsTemporary()) symbol_ptr.Delete(); // If we are done with input; delete the symbol!
       return result;
     }
 
+    /// Run process, convert the return value to a double, and clean up the symbol if needed.
+    template <typename T>
+    T ProcessAs() {
+      if constexpr (std::is_same_v<T, double>) return ProcessDouble();
+      else return SymbolAs<T>(Process());
+    }
+
     virtual void PrintAST(std::ostream & os=std::cout, size_t indent=0) = 0;
+
+    /// Add the objects whose member functions this node (or any below it) calls to 'objs';
+    /// calls to global functions add a nullptr.
+    virtual void CollectCalls(emp::vector<emp::Ptr<EmplodeType>> & /* objs */) { }
   };
 
   /// An ASTNode representing an internal node.
@@ -110,6 +129,10 @@ namespace emplode {
       children.push_back(child);
       child->SetParent(this);
     }
+
+    void CollectCalls(emp::vector<emp::Ptr<EmplodeType>> & objs) override {
+      for (auto child : children) child->CollectCalls(objs);
+    }
   };
 
   /// An ASTNode representing a leaf in the tree (i.e., a variable or literal)
@@ -138,6 +161,15 @@ namespace emplode {
 
     bool IsLeaf() const override { return true; }
 
+    /// Is this leaf a literal owned by the tree (rather than a variable in some scope)?
+    bool IsLiteral() const { return own_symbol; }
+
+    void CollectCalls(emp::vector<emp::Ptr<EmplodeType>> & objs) override {
+      if (!symbol_ptr->IsFunction()) return;
+      emp::Ptr<Symbol_Scope> scope = symbol_ptr->GetScope();
+      objs.push_back(scope ? scope->GetObjectPtr() : nullptr);
+    }
+
     symbol_ptr_t Process() override { 
       #ifndef NDEBUG
       emp::notify::Verbose(
@@ -269,6 +301,11 @@ namespace emplode {
       return GetSymbolTable().MakeTempSymbol(result);
     }
 
+    double ProcessDouble() override {
+      emp_assert(children.size() == 1);
+      return fun(children[0]->ProcessDouble());
+    }
+
     void Write(std::ostream & os, const emp::String & offset) const override { 
       os << name;
       children[0]->Write(os, offset);
@@ -283,8 +320,13 @@ namespace emplode {
 
   /// Binary operations.
   class ASTNode_Op2 : public ASTNode_Internal {
+  public:
+    using num_fun_t = double(*)(double, double);
+
   protected:
     std::function< emp::Datum(emp::Datum, emp::Datum) > fun;
+    num_fun_t num_fun = nullptr;  ///< Unboxed version, used when both inputs are numeric.
+
   public:
     ASTNode_Op2(const emp::String & name, int _line=-1) : ASTNode_Internal(name) {
       line_id = _line;
@@ -296,6 +338,8 @@ namespace emplode {
     bool HasValue() const override { return true; }
 
     void SetFun(std::function< emp::Datum(emp::Datum, emp::Datum) > _fun) { fun = _fun; }
+    void SetNumFun(num_fun_t _fun) { num_fun = _fun; }
+    num_fun_t GetNumFun() const { return num_fun; }
 
     symbol_ptr_t Process() override {
       emp_assert(children.size() == 2);
@@ -305,11 +349,25 @@ namespace emplode {
         "AST: Processing binary op: ", name
       );
       #endif
+      // Types are checked on each call since a variable can change between number and string.
+      if (num_fun && children[0]->IsNumeric() && children[1]->IsNumeric()) {
+        const double out_val = num_fun(children[0]->ProcessAs<double>(),
+                                       children[1]->ProcessAs<double>());
+        return GetSymbolTable().MakeTempSymbol(out_val);
+      }
       auto out_val = fun(children[0]->template ProcessAs<emp::Datum>(),
                          children[1]->template ProcessAs<emp::Datum>());
       return GetSymbolTable().MakeTempSymbol(out_val);
     }
 
+    double ProcessDouble() override {
+      emp_assert(children.size() == 2);
+      if (num_fun && children[0]->IsNumeric() && children[1]->IsNumeric()) {
+        return num_fun(children[0]->ProcessDouble(), children[1]->ProcessDouble());
+      }
+      return SymbolAs<double>(Process());
+    }
+
     void Write(std::ostream & os, const emp::String & offset) const override { 
       children[0]->Write(os, offset);
       os << " " << name << " ";
@@ -454,7 +512,74 @@ namespace emplode {
     }
   };
 
+  /// A PARALLEL block: statements that the host may run at the same time.  Which of them
+  /// actually overlap (based on the objects each one calls into) is decided by the symbol
+  /// table's parallel runner; there is a barrier at the end of the block.
+  class ASTNode_Parallel : public ASTNode_Internal {
+  public:
+    ASTNode_Parallel(node_ptr_t body, int _line=-1) {
+      AddChild(body);
+      line_id = _line;
+    }
+
+    symbol_ptr_t Process() override {
+      #ifndef NDEBUG
+      emp::notify::Verbose(
+        "Emplode::AST",
+        "AST: Processing PARALLEL"
+      );
+      #endif
+
+      node_vector_t statements;
+      node_ptr_t body = children[0];
+      if (body->IsBlock()) {
+        for (size_t i = 0; i < body->GetNumChildren(); ++i) statements.push_back(body->GetChild(i));
+      }
+      else statements.push_back(body);
+
+      SymbolTableBase::call_objs_t calls(statements.size());
+      for (size_t i = 0; i < statements.size(); ++i) statements[i]->CollectCalls(calls[i]);
+      GetSymbolTable().RunParallel(calls, [&statements](size_t id){ statements[id]->ProcessVoid(); });
+      return nullptr;
+    }
+
+    void Write(std::ostream & os, const emp::String & offset) const override {
+      os << "PARALLEL {\n" << offset << "  ";
+      children[0]->Write(os, offset);
+      os << "}";
+    }
+
+    void PrintAST(std::ostream & os=std::cout, size_t indent=0) override {
+      for (size_t i = 0; i < indent; ++i) os << " ";
+      os << "ASTNode_Parallel: " << GetName() << std::endl;
+      for (auto child : children) child->PrintAST(os, indent+2);
+    }
+  };
+
   class ASTNode_Call : public ASTNode_Internal {
+  private:
+    static constexpr size_t MAX_NUMBER_ARGS = 8;  ///< Most arguments for ProcessDouble() calls.
+
+    /// Process all of the arguments and call the provided function symbol on them.
+    symbol_ptr_t Call(symbol_ptr_t fun) {
+      // Collect all arguments and call
+      symbol_vector_t args;
+      for (size_t i = 1; i < children.size(); i++) {
+        args.push_back(children[i]->Process());
+      }
+
+      emp::notify::Verbose(
+        "Emplode::AST",
+        "AST: Calling function '", fun->GetName(), " with ", args.size(), " arguments."
+      );
+
+      symbol_ptr_t result = fun->Call(args);
+
+      // Cleanup and return
+      for (auto arg : args) if (arg->IsTemporary()) arg.Delete();
+      return result;
+    }
+
   public:
     ASTNode_Call(node_ptr_t fun, const node_vector_t & args, int _line=-1) {
       AddChild(fun);
@@ -478,23 +603,33 @@ namespace emplode {
       #endif
 
 
-      symbol_ptr_t fun = children[0]->Process();
+      return Call(children[0]->Process());
+    }
 
-      // Collect all arguments and call
-      symbol_vector_t args;
-      for (size_t i = 1; i < children.size(); i++) {
-        args.push_back(children[i]->Process());
+    /// Calls that only need a number skip building Symbols for numeric arguments and for the
+    /// result when the function provides a NumberFun (see Symbol_Function::SetNumberFun()).
+    double ProcessDouble() override {
+      emp_assert(children.size() >= 1);
+      symbol_ptr_t fun = children[0]->Process();
+      const size_t num_args = children.size() - 1;
+      emp::Ptr<const NumberFun> number_fun = nullptr;
+      if (fun->IsFunction() && num_args <= MAX_NUMBER_ARGS) {
+        number_fun = fun->AsFunction().GetNumberFun(num_args);
       }
+      if (!number_fun) return SymbolAs<double>(Call(fun));
 
-      emp::notify::Verbose(
-        "Emplode::AST",
-        "AST: Calling function '", fun->GetName(), " with ", args.size(), " arguments."
-      );
+      std::array<CallArg, MAX_NUMBER_ARGS> args;
+      for (size_t i = 0; i < num_args; ++i) {
+        if ((number_fun->number_params >> i) & 1) args[i].value = children[i+1]->ProcessDouble();
+        else args[i].symbol = children[i+1]->Process();
+      }
 
-      symbol_ptr_t result = fun->Call(args);
+      const double result = number_fun->fun(std::span<const CallArg>(args.data(), num_args));
 
       // Cleanup and return
-      for (auto arg : args) if (arg->IsTemporary()) arg.Delete();
+      for (size_t i = 0; i < num_args; ++i) {
+        if (args[i].symbol && args[i].symbol->IsTemporary()) args[i].symbol.Delete();
+      }
       return result;
     }
 
@@ -0,0 +1,127 @@
+/**
+ *  @note This file is part of Emplode, currently within https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Arena.hpp
+ *  @brief Pooled memory for the many small objects (AST nodes and symbols) that Emplode makes.
+ *  @note Status: BETA
+ *
+ *  A large config builds thousands of AST nodes and symbols, and running it makes a temporary
+ *  symbol for nearly every value computed.  Classes derived from ArenaAllocated get their
+ *  memory from a shared Arena instead of the general-purpose heap: objects are carved from
+ *  64 KB chunks (so a tree's nodes tend to be near each other in memory) and deleted objects
+ *  go onto a free list for their size, to be reused by the next object of that size.  Chunks
+ *  are only given back when the arena itself is destroyed, all at once.
+ *
+ *  Development Notes:
+ *  - The shared arena is never destroyed (the OS reclaims it at exit), so objects can still be
+ *    deleted safely during static destruction.
+ *  - Objects larger than MAX_BLOCK bytes use the regular heap.
+ *  - A mutex guards each call, since PARALLEL blocks make temporaries from several threads.
+ */
+
+#ifndef EMPLODE_ARENA_HPP
+#define EMPLODE_ARENA_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace emplode {
+
+  class Arena {
+  public:
+    static constexpr size_t ALIGN = alignof(std::max_align_t);
+    static constexpr size_t MAX_BLOCK = 512;           ///< Largest size pooled (in bytes).
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+  private:
+    static constexpr size_t NUM_CLASSES = MAX_BLOCK / ALIGN;
+
+    struct FreeBlock { FreeBlock * next; };
+
+    std::mutex arena_mutex;
+    std::array<FreeBlock *, NUM_CLASSES> free_lists{};   ///< Recycled blocks for each size.
+    emp::vector<std::unique_ptr<std::byte[]>> chunks;
+    std::byte * chunk_pos = nullptr;                     ///< Next unused byte in the last chunk.
+    size_t chunk_left = 0;                               ///< Unused bytes in the last chunk.
+    size_t num_live = 0;                                 ///< Pooled blocks currently in use.
+
+    static size_t ToClass(size_t size) { return (size + ALIGN - 1) / ALIGN - 1; }
+
+  public:
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena & operator=(const Arena &) = delete;
+
+    /// The arena shared by all ArenaAllocated objects.
+    static Arena & Shared() {
+      static Arena * shared = new Arena;
+      return *shared;
+    }
+
+    size_t GetNumLive() {
+      std::lock_guard<std::mutex> lock(arena_mutex);
+      return num_live;
+    }
+    size_t GetNumChunks() {
+      std::lock_guard<std::mutex> lock(arena_mutex);
+      return chunks.size();
+    }
+
+    void * Allocate(size_t size) {
+      if (size == 0) size = 1;
+      if (size > MAX_BLOCK) return ::operator new(size);
+
+      const size_t class_id = ToClass(size);
+      std::lock_guard<std::mutex> lock(arena_mutex);
+      ++num_live;
+      if (FreeBlock * block = free_lists[class_id]) {
+        free_lists[class_id] = block->next;
+        return block;
+      }
+      const size_t block_size = (class_id + 1) * ALIGN;
+      if (chunk_left < block_size) {
+        // Start a new chunk; any tail of the old one is too small for this block and unused.
+        chunks.emplace_back(new std::byte[CHUNK_SIZE]);
+        chunk_pos = chunks.back().get();
+        chunk_left = CHUNK_SIZE;
+      }
+      void * out = chunk_pos;
+      chunk_pos += block_size;
+      chunk_left -= block_size;
+      return out;
+    }
+
+    /// Return memory from Allocate(); 'size' must be the size it was allocated with.
+    void Free(void * ptr, size_t size) {
+      if (!ptr) return;
+      if (size == 0) size = 1;
+      if (size > MAX_BLOCK) { ::operator delete(ptr); return; }
+
+      const size_t class_id = ToClass(size);
+      std::lock_guard<std::mutex> lock(arena_mutex);
+      emp_assert(num_live > 0, "Freeing more arena blocks than were allocated.");
+      --num_live;
+      FreeBlock * block = static_cast<FreeBlock *>(ptr);
+      block->next = free_lists[class_id];
+      free_lists[class_id] = block;
+    }
+  };
+
+  /// Base class for objects to be allocated from the shared arena.  Deleting through a base
+  /// pointer must reach the full object size, so derived hierarchies need virtual destructors.
+  struct ArenaAllocated {
+    static void * operator new(size_t size) { return Arena::Shared().Allocate(size); }
+    static void operator delete(void * ptr, size_t size) { Arena::Shared().Free(ptr, size); }
+  };
+
+}
+
+#endif
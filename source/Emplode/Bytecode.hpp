@@ -0,0 +1,438 @@
+/**
+ *  @note This file is part of Emplode, currently within https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Bytecode.hpp
+ *  @brief Lower an event action's AST into a flat register program and run it.
+ *  @note Status: ALPHA
+ *
+ *  Walking the AST for numeric work allocates a temporary Symbol at every operator and
+ *  makes a virtual call at every node.  A BytecodeProgram instead resolves each variable to
+ *  its Symbol once, keeps intermediate values in a vector of doubles, and turns IF / WHILE /
+ *  BREAK / CONTINUE into jumps.
+ *
+ *  Only pure numeric expressions (variables, literals, negation, and the binary operators)
+ *  and assignments of them to plain variables are lowered.  Anything else (function calls,
+ *  strings, events, etc.) stays an EXEC instruction that simply processes its original node,
+ *  so every script still runs; it just runs faster where it can.
+ *
+ *  Symbols can change type at run time (e.g., a variable assigned a string), so each LOAD
+ *  re-checks that its symbol is still numeric.  If not, the statement that used it falls
+ *  back to processing its original AST node, giving exactly the interpreted result.
+ *
+ *  A program can also be written out as C++ (WriteCpp(), e.g. via 'MABE --emit-cpp'), with
+ *  registers as locals and jumps as gotos.  Once that code is compiled in and registered
+ *  (RegisterNative()), a program built from the same source runs it in place of the loop in
+ *  Run(); it still reads its symbols and fallback nodes from this program.
+ */
+
+#ifndef EMPLODE_BYTECODE_HPP
+#define EMPLODE_BYTECODE_HPP
+
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/math.hpp"
+
+#include "AST.hpp"
+
+namespace emplode {
+
+  class BytecodeProgram {
+  public:
+    /// A program compiled ahead of time by WriteCpp().
+    using native_fun_t = void (*)(const BytecodeProgram &);
+
+  private:
+    using symbol_ptr_t = emp::Ptr<Symbol>;
+    using node_ptr_t = emp::Ptr<ASTNode>;
+
+    static constexpr size_t NO_TARGET = std::numeric_limits<size_t>::max();
+
+    enum class OpCode {
+      LOAD,                                     // reg[a] = sym
+      NEG,                                      // reg[a] = -reg[b]
+      ADD, SUB, MUL, DIV, MOD, POW,             // reg[a] = reg[b] OP reg[c]
+      EQU, NEQ, LESS, LESS_EQU, GTR, GTR_EQU,
+      AND, OR,
+      STORE,                                    // sym = reg[a]   (else process node)
+      EVAL,                                     // reg[a] = node as double
+      JUMP_IF_ZERO,                             // if (reg[a] == 0) goto b   (test is node)
+      JUMP,                                     // goto b
+      EXEC                                      // process node; break -> b, continue -> c
+    };
+
+    struct Op {
+      OpCode code;
+      size_t a = 0;
+      size_t b = 0;
+      size_t c = 0;
+      symbol_ptr_t sym = nullptr;
+      node_ptr_t node = nullptr;
+    };
+
+    /// Jump targets for BREAK and CONTINUE inside the loop currently being compiled.
+    struct LoopInfo {
+      size_t continue_pos = NO_TARGET;
+      emp::vector<size_t> break_jumps;   ///< Ops to patch with the loop end.
+    };
+
+    emp::vector<Op> code;
+    emp::vector<double> regs;
+    size_t num_regs = 0;
+    emp::Ptr<LoopInfo> cur_loop = nullptr;
+    emp::String signature;                  ///< Source plus op codes; identifies native code.
+    native_fun_t native_fun = nullptr;
+
+    /// Native versions of programs, by signature.
+    static std::unordered_map<std::string, native_fun_t> & GetNatives() {
+      static std::unordered_map<std::string, native_fun_t> natives;
+      return natives;
+    }
+
+    size_t AddOp(OpCode opcode, size_t a=0, size_t b=0, size_t c=0,
+                 symbol_ptr_t sym=nullptr, node_ptr_t node=nullptr) {
+      code.push_back(Op{opcode, a, b, c, sym, node});
+      return code.size() - 1;
+    }
+
+    static bool LookupBinary(const emp::String & name, OpCode & opcode) {
+      if (name == "+") opcode = OpCode::ADD;
+      else if (name == "-") opcode = OpCode::SUB;
+      else if (name == "*") opcode = OpCode::MUL;
+      else if (name == "/") opcode = OpCode::DIV;
+      else if (name == "%") opcode = OpCode::MOD;
+      else if (name == "**") opcode = OpCode::POW;
+      else if (name == "==") opcode = OpCode::EQU;
+      else if (name == "!=") opcode = OpCode::NEQ;
+      else if (name == "<")  opcode = OpCode::LESS;
+      else if (name == "<=") opcode = OpCode::LESS_EQU;
+      else if (name == ">")  opcode = OpCode::GTR;
+      else if (name == ">=") opcode = OpCode::GTR_EQU;
+      else if (name == "&&") opcode = OpCode::AND;
+      else if (name == "||") opcode = OpCode::OR;
+      else return false;
+      return true;
+    }
+
+    /// Try to lower a pure numeric expression; return its register or NO_TARGET on failure
+    /// (in which case any partial code is removed).
+    size_t CompileExpr(node_ptr_t node) {
+      const size_t start_code = code.size();
+      const size_t start_regs = num_regs;
+      const size_t out_reg = CompileExpr_Impl(node);
+      if (out_reg == NO_TARGET) {
+        code.resize(start_code);
+        num_regs = start_regs;
+      }
+      return out_reg;
+    }
+
+    size_t CompileExpr_Impl(node_ptr_t node) {
+      if (auto leaf = node.DynamicCast<ASTNode_Leaf>()) {
+        Symbol & symbol = leaf->GetSymbol();
+        if (!symbol.IsNumeric() || symbol.IsFunction()) return NO_TARGET;
+        const size_t reg = num_regs++;
+        AddOp(OpCode::LOAD, reg, 0, 0, &symbol);
+        return reg;
+      }
+      if (auto op1 = node.DynamicCast<ASTNode_Op1>()) {
+        if (op1->GetName() != "unary negation") return NO_TARGET;
+        const size_t in_reg = CompileExpr_Impl(op1->GetChild(0));
+        if (in_reg == NO_TARGET) return NO_TARGET;
+        const size_t reg = num_regs++;
+        AddOp(OpCode::NEG, reg, in_reg);
+        return reg;
+      }
+      if (auto op2 = node.DynamicCast<ASTNode_Op2>()) {
+        OpCode opcode;
+        if (!LookupBinary(op2->GetName(), opcode)) return NO_TARGET;
+        const size_t reg1 = CompileExpr_Impl(op2->GetChild(0));
+        if (reg1 == NO_TARGET) return NO_TARGET;
+        const size_t reg2 = CompileExpr_Impl(op2->GetChild(1));
+        if (reg2 == NO_TARGET) return NO_TARGET;
+        const size_t reg = num_regs++;
+        AddOp(opcode, reg, reg1, reg2);
+        return reg;
+      }
+      return NO_TARGET;
+    }
+
+    /// Lower a test expression; impure tests are evaluated through their AST node.
+    size_t CompileTest(node_ptr_t node) {
+      size_t reg = CompileExpr(node);
+      if (reg == NO_TARGET) {
+        reg = num_regs++;
+        AddOp(OpCode::EVAL, reg, 0, 0, nullptr, node);
+      }
+      return reg;
+    }
+
+    void AddExec(node_ptr_t node) {
+      // Break and continue can only reach us from here if they are outside of any loop in
+      // this program; in that case they stop the program (as the interpreter would).
+      const size_t continue_pos = cur_loop ? cur_loop->continue_pos : NO_TARGET;
+      const size_t pos = AddOp(OpCode::EXEC, 0, NO_TARGET, continue_pos, nullptr, node);
+      if (cur_loop) cur_loop->break_jumps.push_back(pos);
+    }
+
+    void CompileStatement(node_ptr_t node) {
+      if (auto block = node.DynamicCast<ASTNode_Block>()) {
+        for (size_t i = 0; i < block->GetNumChildren(); ++i) CompileStatement(block->GetChild(i));
+        return;
+      }
+
+      if (auto leaf = node.DynamicCast<ASTNode_Leaf>()) {
+        Symbol & symbol = leaf->GetSymbol();
+        if (cur_loop && symbol.IsBreak()) {
+          cur_loop->break_jumps.push_back(AddOp(OpCode::JUMP, 0, NO_TARGET));
+          return;
+        }
+        if (cur_loop && symbol.IsContinue()) {
+          AddOp(OpCode::JUMP, 0, cur_loop->continue_pos);
+          return;
+        }
+        // A lone value as a statement has no effect unless it is a break/continue signal.
+        if (!symbol.IsBreak() && !symbol.IsContinue()) return;
+      }
+
+      if (auto assign = node.DynamicCast<ASTNode_Assign>()) {
+        auto lhs = assign->GetChild(0).DynamicCast<ASTNode_Leaf>();
+        if (lhs && lhs->GetSymbol().IsNumeric() && !lhs->GetSymbol().IsFunction()) {
+          const size_t reg = CompileExpr(assign->GetChild(1));
+          if (reg != NO_TARGET) {
+            AddOp(OpCode::STORE, reg, 0, 0, &lhs->GetSymbol(), node);
+            return;
+          }
+        }
+      }
+
+      if (auto if_node = node.DynamicCast<ASTNode_If>()) {
+        const size_t test_reg = CompileTest(if_node->GetChild(0));
+        const size_t skip_pos =
+          AddOp(OpCode::JUMP_IF_ZERO, test_reg, NO_TARGET, 0, nullptr, if_node->GetChild(0));
+        CompileStatement(if_node->GetChild(1));
+        if (if_node->GetNumChildren() > 2) {
+          const size_t end_pos = AddOp(OpCode::JUMP, 0, NO_TARGET);
+          code[skip_pos].b = code.size();
+          CompileStatement(if_node->GetChild(2));
+          code[end_pos].b = code.size();
+        }
+        else code[skip_pos].b = code.size();
+        return;
+      }
+
+      if (auto while_node = node.DynamicCast<ASTNode_While>()) {
+        LoopInfo loop;
+        loop.continue_pos = code.size();
+        const size_t test_reg = CompileTest(while_node->GetChild(0));
+        loop.break_jumps.push_back(
+          AddOp(OpCode::JUMP_IF_ZERO, test_reg, NO_TARGET, 0, nullptr, while_node->GetChild(0))
+        );
+
+        emp::Ptr<LoopInfo> outer_loop = cur_loop;
+        cur_loop = &loop;
+        CompileStatement(while_node->GetChild(1));
+        cur_loop = outer_loop;
+
+        AddOp(OpCode::JUMP, 0, loop.continue_pos);
+        for (size_t pos : loop.break_jumps) code[pos].b = code.size();
+        return;
+      }
+
+      AddExec(node);
+    }
+
+  public:
+    BytecodeProgram(node_ptr_t root) { Compile(root); }
+
+    size_t GetSize() const { return code.size(); }
+    size_t GetNumRegisters() const { return num_regs; }
+
+    void Compile(node_ptr_t root) {
+      code.resize(0);
+      num_regs = 0;
+      cur_loop = nullptr;
+      CompileStatement(root);
+      regs.resize(num_regs);
+
+      // The op codes are part of the signature, since they depend on symbol types as well
+      // as on the source.
+      std::stringstream ss;
+      root->Write(ss);
+      signature = ss.str();
+      for (const Op & op : code) {
+        signature += emp::MakeString("\n", (int) op.code, ' ', op.a, ' ', op.b, ' ', op.c);
+      }
+      auto native_it = GetNatives().find(signature);
+      native_fun = (native_it == GetNatives().end()) ? nullptr : native_it->second;
+    }
+
+    /// Provide native code for programs with the given signature; true so it can set a static.
+    static bool RegisterNative(const emp::String & in_signature, native_fun_t fun) {
+      GetNatives()[in_signature] = fun;
+      return true;
+    }
+    static bool HasNatives() { return GetNatives().size(); }
+
+    bool IsNative() const { return native_fun != nullptr; }
+    const emp::String & GetSignature() const { return signature; }
+
+    // Accessors for native code.
+    Symbol & GetOpSymbol(size_t pos) const { return *code[pos].sym; }
+    ASTNode & GetOpNode(size_t pos) const { return *code[pos].node; }
+
+    /// Write this program as a C++ function with the given name; it matches Run() step for
+    /// step, with a label before each jump target.
+    void WriteCpp(std::ostream & os, const emp::String & fun_name) const {
+      std::set<size_t> targets;
+      for (const Op & op : code) {
+        if (op.code == OpCode::JUMP || op.code == OpCode::JUMP_IF_ZERO) targets.insert(op.b);
+        if (op.code == OpCode::EXEC) {
+          if (op.b != NO_TARGET) targets.insert(op.b);
+          if (op.c != NO_TARGET) targets.insert(op.c);
+        }
+      }
+      auto jump = [](size_t target) {
+        return target == NO_TARGET ? emp::String("return;") : emp::MakeString("goto L", target, ";");
+      };
+      auto r = [](size_t reg) { return emp::MakeString("r", reg); };
+
+      os << "  inline void " << fun_name << "(const emplode::BytecodeProgram & prog) {\n"
+         << "    [[maybe_unused]] bool fallback = false;\n";
+      for (size_t reg = 0; reg < num_regs; ++reg) os << "    double " << r(reg) << " = 0.0;\n";
+      for (size_t pc = 0; pc < code.size(); ++pc) {
+        const Op & op = code[pc];
+        if (targets.contains(pc)) os << "   L" << pc << ":\n";
+        os << "    ";
+        const emp::String symbol = emp::MakeString("prog.GetOpSymbol(", pc, ")");
+        const emp::String node = emp::MakeString("prog.GetOpNode(", pc, ")");
+        const emp::String a = r(op.a), b = r(op.b), c = r(op.c);
+        switch (op.code) {
+        case OpCode::LOAD:
+          os << "if (!" << symbol << ".IsNumeric()) fallback = true; "
+             << a << " = " << symbol << ".AsDouble();";
+          break;
+        case OpCode::NEG:      os << a << " = -" << b << ";"; break;
+        case OpCode::ADD:      os << a << " = " << b << " + " << c << ";"; break;
+        case OpCode::SUB:      os << a << " = " << b << " - " << c << ";"; break;
+        case OpCode::MUL:      os << a << " = " << b << " * " << c << ";"; break;
+        case OpCode::DIV:      os << a << " = " << b << " / " << c << ";"; break;
+        case OpCode::MOD:
+          os << a << " = (emp::Datum(" << b << ") % emp::Datum(" << c << ")).AsDouble();";
+          break;
+        case OpCode::POW:      os << a << " = emp::Pow(" << b << ", " << c << ");"; break;
+        case OpCode::EQU:      os << a << " = " << b << " == " << c << ";"; break;
+        case OpCode::NEQ:      os << a << " = " << b << " != " << c << ";"; break;
+        case OpCode::LESS:     os << a << " = " << b << " < " << c << ";"; break;
+        case OpCode::LESS_EQU: os << a << " = " << b << " <= " << c << ";"; break;
+        case OpCode::GTR:      os << a << " = " << b << " > " << c << ";"; break;
+        case OpCode::GTR_EQU:  os << a << " = " << b << " >= " << c << ";"; break;
+        case OpCode::AND:
+          os << a << " = (" << b << " != 0.0) && (" << c << " != 0.0);";
+          break;
+        case OpCode::OR:
+          os << a << " = (" << b << " != 0.0) || (" << c << " != 0.0);";
+          break;
+        case OpCode::STORE:
+          os << "if (fallback || !" << symbol << ".IsNumeric()) " << node << ".ProcessVoid(); "
+             << "else " << symbol << ".SetValue(" << a << "); fallback = false;";
+          break;
+        case OpCode::EVAL:
+          os << a << " = " << node << ".ProcessAs<double>();";
+          break;
+        case OpCode::JUMP_IF_ZERO:
+          os << "if ((fallback ? " << node << ".ProcessAs<double>() : " << a << ") == 0.0) "
+             << "{ fallback = false; " << jump(op.b) << " } fallback = false;";
+          break;
+        case OpCode::JUMP:
+          os << jump(op.b);
+          break;
+        case OpCode::EXEC:
+          os << "if (emp::Ptr<emplode::Symbol> out = " << node << ".Process()) {\n"
+             << "      if (out->IsBreak()) " << jump(op.b) << "\n"
+             << "      else if (out->IsContinue()) " << jump(op.c) << "\n"
+             << "      else if (out->IsTemporary()) out.Delete();\n"
+             << "    }";
+          break;
+        }
+        os << "\n";
+      }
+      if (targets.contains(code.size())) os << "   L" << code.size() << ": ;\n";
+      os << "  }\n";
+    }
+
+    /// Run the program once; equivalent to root->ProcessVoid() on the original AST.
+    void Run() {
+      if (native_fun) { native_fun(*this); return; }
+      bool fallback = false;  // Has a LOAD found a symbol that is no longer numeric?
+      size_t pc = 0;
+      while (pc < code.size()) {
+        const Op & op = code[pc++];
+        switch (op.code) {
+        case OpCode::LOAD:
+          if (!op.sym->IsNumeric()) fallback = true;
+          regs[op.a] = op.sym->AsDouble();
+          break;
+        case OpCode::NEG:      regs[op.a] = -regs[op.b]; break;
+        case OpCode::ADD:      regs[op.a] = regs[op.b] + regs[op.c]; break;
+        case OpCode::SUB:      regs[op.a] = regs[op.b] - regs[op.c]; break;
+        case OpCode::MUL:      regs[op.a] = regs[op.b] * regs[op.c]; break;
+        case OpCode::DIV:      regs[op.a] = regs[op.b] / regs[op.c]; break;
+        case OpCode::MOD:
+          regs[op.a] = (emp::Datum(regs[op.b]) % emp::Datum(regs[op.c])).AsDouble();
+          break;
+        case OpCode::POW:      regs[op.a] = emp::Pow(regs[op.b], regs[op.c]); break;
+        case OpCode::EQU:      regs[op.a] = regs[op.b] == regs[op.c]; break;
+        case OpCode::NEQ:      regs[op.a] = regs[op.b] != regs[op.c]; break;
+        case OpCode::LESS:     regs[op.a] = regs[op.b] < regs[op.c]; break;
+        case OpCode::LESS_EQU: regs[op.a] = regs[op.b] <= regs[op.c]; break;
+        case OpCode::GTR:      regs[op.a] = regs[op.b] > regs[op.c]; break;
+        case OpCode::GTR_EQU:  regs[op.a] = regs[op.b] >= regs[op.c]; break;
+        case OpCode::AND:      regs[op.a] = (regs[op.b] != 0.0) && (regs[op.c] != 0.0); break;
+        case OpCode::OR:       regs[op.a] = (regs[op.b] != 0.0) || (regs[op.c] != 0.0); break;
+        case OpCode::STORE:
+          if (fallback || !op.sym->IsNumeric()) op.node->ProcessVoid();
+          else op.sym->SetValue(regs[op.a]);
+          fallback = false;
+          break;
+        case OpCode::EVAL:
+          regs[op.a] = op.node->ProcessAs<double>();
+          break;
+        case OpCode::JUMP_IF_ZERO: {
+          const double test = fallback ? op.node->ProcessAs<double>() : regs[op.a];
+          fallback = false;
+          if (test == 0.0) pc = op.b;
+          break;
+        }
+        case OpCode::JUMP:
+          pc = op.b;
+          break;
+        case OpCode::EXEC: {
+          symbol_ptr_t out = op.node->Process();
+          if (!out) break;
+          if (out->IsBreak()) {
+            if (op.b == NO_TARGET) return;
+            pc = op.b;
+          }
+          else if (out->IsContinue()) {
+            if (op.c == NO_TARGET) return;
+            pc = op.c;
+          }
+          else if (out->IsTemporary()) out.Delete();
+          break;
+        }
+        }
+      }
+    }
+  };
+
+}
+
+#endif
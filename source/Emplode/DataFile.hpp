@@ -6,15 +6,48 @@
  *  @file  DataFile.hpp
  *  @brief Manages a DataFile object for config.
  *  @note Status: BETA
+ *
+ *  Each column writes its value straight into a reused row buffer: numbers are formatted with
+ *  std::to_chars (six significant digits, as a stream would print them), and typed columns
+ *  (AddColumnDouble, AddColumnInt, AddColumnString) skip building a string per value.  The
+ *  output stream is looked up once, at the first write, so 'filename' must be set by then.
+ *
+ *  By default each row is written as soon as WRITE is called, but the file is only flushed
+ *  every 'flush_rows' rows (0 = only by FLUSH and at the end of the run).  With 'async' on,
+ *  rows are still formatted immediately (so they capture the current state), but are collected
+ *  into blocks of 'flush_interval' rows that a background thread writes to the file.  Buffered
+ *  rows are always written by FLUSH or when the DataFile is destroyed at the end of a run.
+ *
+ *  Setting 'format' to "binary" writes typed columns with no text formatting.  Rows are
+ *  collected into groups of 'flush_interval' rows (and written in the background if 'async'
+ *  is also on).  All values are host-endian:
+ *    header: "MABECOL1", uint32 column count, then for each column:
+ *            uint32 name length, name bytes, uint8 type (0 = double, 1 = string)
+ *    groups: uint64 row count, then for each column:
+ *            double columns: one double per row;
+ *            string columns: one uint64 end offset per row, then the concatenated characters.
+ *  A column's type is set by its first value; numeric columns convert any later strings, and
+ *  string columns store later numbers in their text form.
  */
 
 #ifndef EMPLODE_DATA_FILE_HPP
 #define EMPLODE_DATA_FILE_HPP
 
+#include <charconv>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
 
+#include "emp/base/notify.hpp"
 #include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
+#include "emp/data/Datum.hpp"
 #include "emp/io/StreamManager.hpp"
 #include "emp/tools/String.hpp"
 
@@ -22,15 +55,121 @@
 
 namespace emplode {
 
+  /// Writes blocks of text to a stream from a background thread.  Buffers are recycled once
+  /// written, and at most MAX_QUEUED blocks can be waiting (Push() blocks beyond that).
+  class AsyncStreamWriter {
+  private:
+    static constexpr size_t MAX_QUEUED = 8;
+
+    std::ostream & os;
+    std::mutex mutex;
+    std::condition_variable work_cv;     ///< Signaled when there is work (or we should stop).
+    std::condition_variable done_cv;     ///< Signaled when a block has been written.
+    std::deque<std::string> queue;       ///< Blocks waiting to be written.
+    emp::vector<std::string> free_bufs;  ///< Written blocks, cleared for reuse.
+    bool writing = false;                ///< Is the background thread writing a block now?
+    bool stop = false;                   ///< Should the background thread exit once idle?
+    std::thread thread;
+
+    void Run() {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        work_cv.wait(lock, [this](){ return stop || queue.size(); });
+        if (queue.empty()) break;  // Only reached when stopping with nothing left to write.
+        std::string block = std::move(queue.front());
+        queue.pop_front();
+        writing = true;
+        lock.unlock();
+        os.write(block.data(), (std::streamsize) block.size());
+        os.flush();
+        block.clear();
+        lock.lock();
+        writing = false;
+        free_bufs.push_back(std::move(block));
+        done_cv.notify_all();
+      }
+    }
+
+    /// Every live writer, so that all of them can be paused at once (main thread only).
+    static std::set<AsyncStreamWriter *> & GetWriters() {
+      static std::set<AsyncStreamWriter *> writers;
+      return writers;
+    }
+
+  public:
+    AsyncStreamWriter(std::ostream & in_os) : os(in_os), thread([this](){ Run(); }) {
+      GetWriters().insert(this);
+    }
+    AsyncStreamWriter(const AsyncStreamWriter &) = delete;
+    ~AsyncStreamWriter() {
+      Pause();  // Remaining blocks are written before the thread exits.
+      GetWriters().erase(this);
+    }
+
+    /// Write everything queued, then end the background thread; the next Push() starts a new
+    /// one.  Used before forking, since a child process gets no copy of this thread.
+    void Pause() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      work_cv.notify_one();
+      if (thread.joinable()) thread.join();
+      stop = false;
+    }
+
+    /// Pause every live writer.
+    static void PauseAll() { for (AsyncStreamWriter * writer : GetWriters()) writer->Pause(); }
+
+    /// Get an empty buffer to fill (reusing the memory of a previously written block).
+    std::string GetBuffer() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (free_bufs.empty()) return std::string();
+      std::string out = std::move(free_bufs.back());
+      free_bufs.pop_back();
+      return out;
+    }
+
+    /// Queue a block to be written.
+    void Push(std::string && block) {
+      std::unique_lock<std::mutex> lock(mutex);
+      done_cv.wait(lock, [this](){ return queue.size() < MAX_QUEUED; });
+      queue.push_back(std::move(block));
+      if (!thread.joinable()) thread = std::thread([this](){ Run(); });  // Restart after Pause().
+      lock.unlock();
+      work_cv.notify_one();
+    }
+
+    /// Block until all queued text has been written and flushed.
+    void Wait() {
+      std::unique_lock<std::mutex> lock(mutex);
+      done_cv.wait(lock, [this](){ return queue.empty() && !writing; });
+    }
+  };
+
   /// A DataFile maintains an output file that has specified columns and can be generate
   /// dynamically.
   class DataFile : public EmplodeType {
   private:
     using data_fun_t = std::function<emp::String()>;
+    using value_fun_t = std::function<emp::Datum()>;
+    using double_fun_t = std::function<double()>;
+    using int_fun_t = std::function<int64_t()>;
+    using string_fun_t = std::function<std::string_view()>;
+    using append_fun_t = std::function<void(std::string &)>;
     using setup_fun_t = std::function<void()>;
     struct ColumnInfo {
       emp::String header;
-      data_fun_t fun;
+      append_fun_t append_fun; ///< Append this column's text for the current row.
+      value_fun_t value_fun;   ///< Unformatted value, for binary output.
+    };
+
+    /// Values for one column of the binary row group currently being collected.
+    struct BinaryColumn {
+      bool is_numeric = true;
+      emp::vector<double> values;    ///< Numeric values, one per row.
+      std::string chars;             ///< String values, concatenated.
+      emp::vector<uint64_t> ends;    ///< End offset in chars of each string value.
     };
 
     emp::String name="";                 ///< Unique name for this object.
@@ -40,17 +179,220 @@ namespace emplode {
     emp::vector<ColumnInfo> cols;        ///< Data about columns maintainted.
     emp::vector<setup_fun_t> setup;      ///< Commands to run before writing columns.
 
+    bool async = false;                  ///< Should rows be written by a background thread?
+    size_t flush_interval = 100;         ///< Rows to collect before each background write.
+    std::unique_ptr<AsyncStreamWriter> async_writer;  ///< Background writer (if started)
+    std::string pending;                 ///< Formatted rows not yet handed to the writer.
+    size_t pending_rows = 0;             ///< Number of rows collected but not yet written.
+
+    emp::String format = "csv";          ///< Output format: "csv" or "binary"
+    emp::vector<BinaryColumn> bin_cols;  ///< Row group being collected (binary format only)
+    bool bin_started = false;            ///< Have column types been set from the first row?
+    bool bin_need_header = false;        ///< Does the binary header still need to be written?
+
+    size_t flush_rows = 0;               ///< Rows between flushes of csv output (0 = only at FLUSH)
+    emp::Ptr<std::ostream> out_stream = nullptr;  ///< Output stream, bound at the first write.
+    bool out_is_new = false;             ///< Was the output stream new when it was bound?
+    std::string row_buffer;              ///< Reused buffer for formatting rows.
+    size_t rows_since_flush = 0;         ///< Rows written since the stream was last flushed.
+
+    /// While the columns of a row are being computed, active_row is nonzero and unique to
+    /// that row, so columns can share work (such as a scan of the same trait).
+    static inline size_t active_row = 0;
+    static inline size_t last_row = 0;
+
+  public:
+    /// Groups the summaries computed during its lifetime as one row (see GetActiveRow()).
+    struct RowScope {
+      RowScope() { active_row = ++last_row; }
+      ~RowScope() { active_row = 0; }
+    };
+
+    /// Append a number as a stream would print it by default (up to six significant digits).
+    static void AppendNumber(std::string & out, double value) {
+      char buffer[32];
+      const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                        std::chars_format::general, 6);
+      out.append(buffer, result.ptr);
+    }
+
+    static void AppendInt(std::string & out, int64_t value) {
+      char buffer[24];
+      const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+      out.append(buffer, result.ptr);
+    }
+
+    /// Append a script value: numbers as numbers, other strings as quoted literals.
+    static void AppendDatum(std::string & out, const emp::Datum & value) {
+      if (value.IsDouble()) AppendNumber(out, value.AsDouble());
+      else {
+        const emp::String str = value.AsString();
+        if (emp::is_number(str)) out += str.str();
+        else out += emp::MakeLiteral(str).str();
+      }
+    }
+
+  private:
+
+    /// Get the output stream, looking it up (and noting if it is new) only the first time.
+    std::ostream & GetStream() {
+      if (!out_stream) {
+        out_is_new = !files->Has(filename);
+        out_stream = &files->GetOutputStream(filename);
+      }
+      return *out_stream;
+    }
+
+    AsyncStreamWriter & GetAsyncWriter() {
+      if (!async_writer) async_writer = std::make_unique<AsyncStreamWriter>(GetStream());
+      return *async_writer;
+    }
+
+    /// Write a block of output directly or, in async mode, via the background writer.
+    void Emit(std::string && block) {
+      if (async) GetAsyncWriter().Push(std::move(block));
+      else {
+        std::ostream & file = GetStream();
+        file.write(block.data(), (std::streamsize) block.size());
+        file.flush();
+      }
+    }
+
+    /// Append the current row of csv columns (and a newline) to 'out'.
+    void AppendRow(std::string & out) {
+      for (auto fun : setup) fun();
+      RowScope row_scope;
+      for (size_t i = 0; i < cols.size(); ++i) {
+        if (i) out += ',';
+        cols[i].append_fun(out);
+      }
+      out += '\n';
+    }
+
+    template <typename T>
+    static void AppendRaw(std::string & out, const T & value) {
+      out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    size_t WriteBinary() {
+      // The first row sets up the columns and records if the file is new.
+      if (!bin_started) {
+        GetStream();  // Create the stream so others see it exists.
+        bin_need_header = out_is_new;
+        bin_cols.resize(cols.size());
+      }
+
+      for (auto fun : setup) fun();
+      RowScope row_scope;
+      for (size_t i = 0; i < cols.size(); ++i) {
+        const emp::Datum value = cols[i].value_fun();
+        BinaryColumn & col = bin_cols[i];
+        if (!bin_started) col.is_numeric = value.IsDouble();
+        if (col.is_numeric) col.values.push_back(value.AsDouble());
+        else {
+          col.chars += value.AsString().str();
+          col.ends.push_back(col.chars.size());
+        }
+      }
+      bin_started = true;
+
+      if (++pending_rows >= flush_interval) EmitBinaryGroup();
+      return 1;
+    }
+
+    /// Write out the collected binary rows as one group (preceded by the header if needed).
+    void EmitBinaryGroup() {
+      std::string block = async ? GetAsyncWriter().GetBuffer() : std::string();
+      if (bin_need_header) {
+        block.append("MABECOL1");
+        AppendRaw<uint32_t>(block, (uint32_t) cols.size());
+        for (size_t i = 0; i < cols.size(); ++i) {
+          AppendRaw<uint32_t>(block, (uint32_t) cols[i].header.size());
+          block.append(cols[i].header.str());
+          AppendRaw<uint8_t>(block, bin_cols[i].is_numeric ? 0 : 1);
+        }
+        bin_need_header = false;
+      }
+
+      AppendRaw<uint64_t>(block, pending_rows);
+      for (BinaryColumn & col : bin_cols) {
+        if (col.is_numeric) {
+          block.append(reinterpret_cast<const char *>(col.values.data()),
+                       col.values.size() * sizeof(double));
+          col.values.resize(0);
+        }
+        else {
+          block.append(reinterpret_cast<const char *>(col.ends.data()),
+                       col.ends.size() * sizeof(uint64_t));
+          block.append(col.chars);
+          col.ends.resize(0);
+          col.chars.clear();
+        }
+      }
+      pending_rows = 0;
+      Emit(std::move(block));
+    }
+
+    void AppendHeaders(std::string & out) {
+      for (size_t i = 0; i < cols.size(); ++i) {
+        if (i) out += ',';
+        out += cols[i].header.str();
+      }
+      out += '\n';
+    }
+
+    /// Hand any formatted rows to the background writer.
+    void PushPending() {
+      if (pending.empty()) return;
+      async_writer->Push(std::move(pending));
+      pending = async_writer->GetBuffer();
+      pending_rows = 0;
+    }
+
+    size_t WriteAsync() {
+      // Start the writer the first time through (including the headers if the file is new).
+      if (!async_writer) {
+        GetAsyncWriter();
+        if (out_is_new) AppendHeaders(pending);
+      }
+
+      AppendRow(pending);
+
+      if (++pending_rows >= flush_interval) PushPending();
+      return 1;
+    }
+
   public:
     DataFile() = delete;
     DataFile(const emp::String & in_name, emp::StreamManager & _files)
       : name(in_name), files(&_files) { }
-    DataFile(const DataFile &) = default;
-    ~DataFile() { }
+    /// Copies share configuration and columns, but not any rows waiting to be written.
+    DataFile(const DataFile & in)
+      : EmplodeType(in), name(in.name), files(in.files), filename(in.filename)
+      , cols(in.cols), setup(in.setup), async(in.async), flush_interval(in.flush_interval)
+      , format(in.format), flush_rows(in.flush_rows) { }
+    ~DataFile() { Flush(); }
 
-    DataFile & operator=(const DataFile &) = default;
+    DataFile & operator=(const DataFile & in) {
+      EmplodeType::operator=(in);
+      name = in.name;
+      files = in.files;
+      filename = in.filename;
+      cols = in.cols;
+      setup = in.setup;
+      async = in.async;
+      flush_interval = in.flush_interval;
+      format = in.format;
+      flush_rows = in.flush_rows;
+      out_stream = nullptr;   // Rebind, in case the filename changed.
+      return *this;
+    }
 
     emp::String GetName() const { return name; }
 
+    /// ID of the row whose columns are being computed right now (0 if none).
+    static size_t GetActiveRow() { return active_row; }
+
     // Setup member functions associated with population.
     static void InitType(TypeInfo & info) {
       info.AddMemberFunction("NUM_COLS",
@@ -59,15 +401,57 @@ namespace emplode {
       info.AddMemberFunction("WRITE",
         [](DataFile & df) { return df.Write(); },
         "Add on the next line of data.");
+      info.AddMemberFunction("FLUSH",
+        [](DataFile & df) { df.Flush(); return 0; },
+        "Make sure all rows are written out and flushed to the file.");
     }
 
     void SetupConfig() override {
       LinkVar(filename, "filename", "Name to use for this file.");
+      LinkVar(async, "async", "Write rows from a background thread? (0=off, 1=on)");
+      LinkVar(flush_interval, "flush_interval",
+              "With async or binary output, how many rows should be collected before each write?");
+      LinkVar(format, "format", "Output format: \"csv\" (text) or \"binary\" (typed columns).");
+      LinkVar(flush_rows, "flush_rows",
+              "With csv output, how many rows should be written between flushes? (0 = only at FLUSH or exit)");
+    }
+
+    /// Add a column of text.  If value_fun is provided, it is used instead of fun: its value
+    /// is formatted directly (numbers as numbers, strings as literals) or stored in binary form.
+    size_t AddColumn(const emp::String & header, data_fun_t fun, value_fun_t value_fun=nullptr) {
+      size_t col_id = cols.size();
+      if (value_fun) {
+        cols.push_back(ColumnInfo{header,
+          [value_fun](std::string & out){ AppendDatum(out, value_fun()); }, value_fun});
+      }
+      else {
+        cols.push_back(ColumnInfo{header, [fun](std::string & out){ out += fun().str(); },
+                                  [fun](){ return emp::Datum(fun()); }});
+      }
+      return col_id;
+    }
+
+    /// Add a numeric column.
+    size_t AddColumnDouble(const emp::String & header, double_fun_t fun) {
+      size_t col_id = cols.size();
+      cols.push_back(ColumnInfo{header, [fun](std::string & out){ AppendNumber(out, fun()); },
+                                [fun](){ return emp::Datum(fun()); }});
+      return col_id;
     }
 
-    size_t AddColumn(const emp::String & header, data_fun_t fun) {
+    /// Add an integer column (written exactly, with no rounding to six digits).
+    size_t AddColumnInt(const emp::String & header, int_fun_t fun) {
       size_t col_id = cols.size();
-      cols.push_back(ColumnInfo{header,fun});
+      cols.push_back(ColumnInfo{header, [fun](std::string & out){ AppendInt(out, fun()); },
+                                [fun](){ return emp::Datum((double) fun()); }});
+      return col_id;
+    }
+
+    /// Add a column of text written as is; 'fun' may return a view of text it owns.
+    size_t AddColumnString(const emp::String & header, string_fun_t fun) {
+      size_t col_id = cols.size();
+      cols.push_back(ColumnInfo{header, [fun](std::string & out){ out += fun(); },
+                                [fun](){ return emp::Datum(emp::String(std::string(fun()))); }});
       return col_id;
     }
 
@@ -78,31 +462,42 @@ namespace emplode {
     }
 
     size_t Write() {
-      const bool file_exists = files->Has(filename);           // Is file is already setup?
-      std::ostream & file = files->GetOutputStream(filename);  // File to write to.
-
-      // If we need headers, set them up!
-      if (!file_exists) {
-        for (size_t i = 0; i < cols.size(); ++i) {
-          if (i) file << ",";
-          file << cols[i].header;
-        }
-        file << std::endl;
+      if (format == "binary") return WriteBinary();
+      if (format != "csv") {
+        emp::notify::Error("DataFile '", name, "' has unknown format '", format,
+                           "'; options are \"csv\" or \"binary\".");
+        return 0;
       }
+      if (async || async_writer) return WriteAsync();
 
-      // Do any setup for the columns.
-      for (auto fun : setup) fun();
+      // The first write binds the stream; add headers if the file is new.
+      const bool first_write = !out_stream;
+      std::ostream & file = GetStream();
+      row_buffer.clear();
+      if (first_write && out_is_new) AppendHeaders(row_buffer);
 
-      // Now print out each entry.
-      for (size_t i = 0; i < cols.size(); ++i) {
-        if (i) file << ",";
-        file << cols[i].fun();
+      AppendRow(row_buffer);
+      file.write(row_buffer.data(), (std::streamsize) row_buffer.size());
+      if (flush_rows && ++rows_since_flush >= flush_rows) {
+        file.flush();
+        rows_since_flush = 0;
       }
-      file << std::endl;
 
       return 1;
     }
 
+    /// Write out any rows still buffered for the background writer and wait until done.
+    void Flush() {
+      if (bin_started && pending_rows) EmitBinaryGroup();
+      if (!async_writer) {
+        if (out_stream) out_stream->flush();
+        rows_since_flush = 0;
+        return;
+      }
+      PushPending();
+      async_writer->Wait();
+    }
+
     static emp::String EMPGetTypeName() { return "emplode::DataFile"; }
   };
 }
@@ -70,6 +70,8 @@
 
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "emp/base/assert.hpp"
@@ -87,6 +89,7 @@
 #include "Parser.hpp"
 #include "Symbol_Function.hpp"
 #include "SymbolTable.hpp"
+#include "TokenCache.hpp"
 #include "TypeInfo.hpp"
 
 namespace emplode {
@@ -101,6 +104,33 @@ namespace emplode {
     Lexer lexer;               ///< Lexer to process input code.
     Parser parser;             ///< Parser to transform token stream into an abstract syntax tree.
     ASTNode_Block ast_root;    ///< Abstract syntax tree version of input file.
+    TokenCache token_cache;    ///< Optional on-disk cache of tokenized files.
+
+    /// A statement passed to Execute(), already parsed.  Identifiers in the AST point directly
+    /// to their symbols, so the parse is only valid until another symbol is added.
+    struct ExecInfo {
+      emp::Ptr<ASTNode_Block> block = nullptr;  ///< Temporary block holding the expression.
+      emp::Ptr<ASTNode> expr = nullptr;         ///< Parsed statement.
+      size_t symbol_version = 0;                ///< Symbol_Scope::GetSymbolVersion() when parsed.
+    };
+    std::unordered_map<std::string, ExecInfo> exec_cache;  ///< Parsed statements, by text.
+    static constexpr size_t MAX_EXEC_CACHE = 4096;         ///< Statements to keep parsed.
+
+    /// Tokenize and parse a single statement, placing it in a new temporary block.
+    ExecInfo ParseExec(std::string_view statement) {
+      ExecInfo info;
+      auto tokens = lexer.Tokenize(statement, "eval command"); // Convert to a TokenStream.
+      tokens.push_back(lexer.ToToken(";"));                    // Ensure a semi-colon at end.
+      pos_t pos = tokens.begin();                              // Start are beginning of stream.
+      ParseState state{pos, symbol_table, symbol_table.GetRootScope(), lexer};
+      info.expr = parser.ParseStatement(state);                // Convert tokens to AST
+
+      // Now place the expression in a temporary block.
+      info.block = emp::NewPtr<ASTNode_Block>(symbol_table.GetRootScope(), 0);
+      info.block->SetSymbolTable(state.GetSymbolTable());
+      info.block->AddChild(info.expr);
+      return info;
+    }
 
     emp::String ConcatLexemes(pos_t start_pos, pos_t end_pos) const {
       emp_assert(start_pos <= end_pos);
@@ -197,7 +227,7 @@ namespace emplode {
             emp::String out_string = exec_fun(expression);
             if (!emp::is_number(out_string)) return emp::MakeLiteral(out_string);
             return out_string;
-          });
+          }, [exec_fun,expression](){ return exec_fun(expression); });
         },
         "Add a column to the associated DataFile.  Args: title, string to execute for result"
       );
@@ -210,6 +240,10 @@ namespace emplode {
       );
     }
 
+    ~Emplode() {
+      for (auto & [statement, info] : exec_cache) info.block.Delete();
+    }
+
     // Prevent copy or move since we are using lambdas that capture 'this'
     Emplode(const Emplode &) = delete;
     Emplode(Emplode &&) = delete;
@@ -252,9 +286,19 @@ namespace emplode {
     SymbolTable & GetSymbolTable() { return symbol_table; }
     const SymbolTable & GetSymbolTable() const { return symbol_table; }
 
+    /// Cache tokenized config files in 'dir' (keyed by contents); empty string turns off.
+    void SetTokenCacheDir(const emp::String & dir) { token_cache.SetDir(dir); }
+
+    /// Tokenize a file into the token cache without running it.
+    void Preparse(const emp::String & filename) { token_cache.Tokenize(lexer, filename); }
+
     /// Load a single, specified configuration from a stream.
     void Load(std::istream & is, const emp::String & stream_name) {
-      emp::TokenStream tokens = lexer.Tokenize(is, stream_name); // Convert to more-usable tokens.
+      LoadTokens(lexer.Tokenize(is, stream_name));               // Convert to more-usable tokens.
+    }
+
+    /// Parse and run a stream of tokens.
+    void LoadTokens(emp::TokenStream tokens) {
       pos_t pos = tokens.begin();                                // Start at beginning of input.
 
       // Parse and run the program, starting from the outer scope.
@@ -270,9 +314,7 @@ namespace emplode {
 
     /// Load a single, specified configuration file.
     void Load(const emp::String & filename) {
-      std::ifstream file(filename);  // Open the provided file.
-      Load(file, filename);          // Load contents
-      file.close();                  // Close the file (now that it's loaded)
+      LoadTokens(token_cache.Tokenize(lexer, filename));
     }
 
     /// Sequentially load a series of configuration files.
@@ -297,29 +339,45 @@ namespace emplode {
       ast_root.AddChild(cur_block);
     }
 
-    // Load the provided statement, run it, and return the resulting value.
+    // Load the provided statement, run it, and return the resulting value.  Statements that
+    // do not declare anything stay parsed (e.g., for DataFile columns run on every row) until
+    // a new symbol is added anywhere, which could change what their identifiers refer to.
     emp::Datum Execute(std::string_view statement, emp::Ptr<Symbol_Scope> scope=nullptr) {
       if (!scope) scope = &symbol_table.GetRootScope();        // Default scope to root level.
-      auto tokens = lexer.Tokenize(statement, "eval command"); // Convert to a TokenStream.
-      tokens.push_back(lexer.ToToken(";"));                    // Ensure a semi-colon at end.
-      pos_t pos = tokens.begin();                              // Start are beginning of stream.
-      ParseState state{pos, symbol_table, symbol_table.GetRootScope(), lexer};
-      auto cur_expr = parser.ParseStatement(state);            // Convert tokens to AST
-
-      // Now place the expression in a temporary block.
-      auto cur_block = emp::NewPtr<ASTNode_Block>(symbol_table.GetRootScope(), 0);
-      cur_block->SetSymbolTable(state.GetSymbolTable());
-      cur_block->AddChild(cur_expr);
+      ExecInfo info;
+      bool keep_info = false;
+      auto cache_it = exec_cache.find(std::string(statement));
+      if (cache_it != exec_cache.end() &&
+          cache_it->second.symbol_version == Symbol_Scope::GetSymbolVersion()) {
+        info = cache_it->second;
+        keep_info = true;
+      }
+      else {
+        const size_t version = Symbol_Scope::GetSymbolVersion();
+        info = ParseExec(statement);
+        info.symbol_version = version;
+        if (version == Symbol_Scope::GetSymbolVersion()) {   // Parse did not declare anything.
+          if (cache_it != exec_cache.end()) {
+            cache_it->second.block.Delete();
+            cache_it->second = info;
+            keep_info = true;
+          }
+          else if (exec_cache.size() < MAX_EXEC_CACHE) {
+            exec_cache.emplace(std::string(statement), info);
+            keep_info = true;
+          }
+        }
+      }
 
       // Process just the expressions so that we can get a result from it.
-      auto result_ptr = cur_expr->Process();                // Process AST to get result symbol.
+      auto result_ptr = info.expr->Process();               // Process AST to get result symbol.
       emp::Datum result;
       if (result_ptr) {
         if (result_ptr->IsNumeric()) result = result_ptr->AsDouble(); // Result is numeric output.
         else result = result_ptr->AsString();                         // Result is string output.
         if (result_ptr->IsTemporary()) result_ptr.Delete();           // Delete temp result symbol.
       }
-      cur_block.Delete();                                   // Delete the temporary AST.
+      if (!keep_info) info.block.Delete();                  // Delete the temporary AST.
       return result;                                        // Return the result string.
     }
 
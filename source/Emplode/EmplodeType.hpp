@@ -57,6 +57,9 @@ namespace emplode {
     // Override CopyValue() if more needs to happen.
     virtual bool CopyValue(const EmplodeType &) { return false; }
 
+    /// Optional function called just before any scripted call to a member function.
+    virtual void BeforeMemberCall() { }
+
     Symbol_Scope & AsScope() {
       emp_assert(!symbol_ptr.IsNull());
       return *symbol_ptr.DynamicCast<Symbol_Scope>();
@@ -85,10 +88,22 @@ namespace emplode {
 
       for (const MemberFunInfo & member_info : member_map) {
         member_fun_t linked_fun = [this, &member_info](const emp::vector<symbol_ptr_t> & args){
+          BeforeMemberCall();
           return member_info.fun(*this, args);
         };
-        symbol_ptr->AddFunction(member_info.name, linked_fun,
-                                member_info.desc, member_info.return_type).SetBuiltin();
+        Symbol_Function & fun_symbol =
+          symbol_ptr->AddFunction(member_info.name, linked_fun,
+                                  member_info.desc, member_info.return_type);
+        fun_symbol.SetBuiltin();
+        if (member_info.number_fun) {
+          fun_symbol.SetNumberFun(NumberFun{
+            [this, &member_info](std::span<const CallArg> args){
+              BeforeMemberCall();
+              return member_info.number_fun.fun(*this, args);
+            },
+            member_info.number_fun.number_params
+          });
+        }
 
         // std::cout << "Adding member function '" << member_info.name << "' to object '"
         //           << symbol_ptr->GetName() << "'." << std::endl;
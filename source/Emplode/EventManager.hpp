@@ -19,17 +19,33 @@
  *  A event TRIGGER occurs to signify an event in a run (such as a new update or a
  *  collision); it specifies the signal that it is triggering and a set of associated
  *  data (to provide args to the actions)
+ *
+ *  An action may also be TIMED on its first argument, as in:
+ *    @UPDATE(Var ud IN [100:100]) ...          // Updates 100, 200, 300, ...
+ *    @UPDATE(Var ud IN [0:10:500]) ...         // Every 10 updates through update 500.
+ *  The range gives [start:step:stop]; step defaults to 1 and stop to "never".  Timed actions
+ *  are kept in a priority queue by the next value they are due, so a trigger where nothing is
+ *  due (and no untimed actions exist) returns before any argument symbols are even set.
  * 
  */
 
 #ifndef EMPLODE_EVENT_MANAGER_HPP
 #define EMPLODE_EVENT_MANAGER_HPP
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+
 #include "emp/base/map.hpp"
 #include "emp/base/Ptr.hpp"
 #include "emp/tools/String.hpp"
 
 #include "AST.hpp"
+#include "Bytecode.hpp"
 
 namespace emplode {
 
@@ -41,23 +57,45 @@ namespace emplode {
     using node_vec_t = emp::vector< node_ptr_t >;
     struct Event;
 
+  public:
+    /// Optional callback to report the time (in nanoseconds) taken by each triggered action.
+    using profile_fun_t = std::function<void(const emp::String & label, uint64_t ns)>;
+
+    /// When should an action run, based on the value of the first trigger argument?
+    struct ActionTiming {
+      bool active = false;  ///< If false, run on every trigger.
+      double start = 0.0;
+      double step = 1.0;    ///< Values <= 0 indicate a single run at 'start'.
+      double stop = std::numeric_limits<double>::infinity();
+    };
+
+  private:
     std::unordered_map<emp::String, emp::Ptr<Event>> event_map;
     SymbolTableBase & symbol_table;
+    profile_fun_t profile_fun;
+    bool compile_actions = false;   ///< Run actions as bytecode rather than walking the AST?
 
     struct Action {
       emp::String signal_name;
       node_vec_t params;
       node_ptr_t action;
       size_t def_line;
-
-      Action(const emp::String & _signal, node_vec_t _params, node_ptr_t _action, size_t _line)
-      : signal_name(_signal), params(_params), action(_action), def_line(_line) { }
+      emp::String label;          ///< Name used when profiling this action.
+      emp::Ptr<BytecodeProgram> program = nullptr;  ///< Compiled on first use, if enabled.
+      ActionTiming timing;
+      bool due = false;           ///< For timed actions: should the current trigger run this?
+
+      Action(const emp::String & _signal, node_vec_t _params, node_ptr_t _action, size_t _line,
+             ActionTiming _timing)
+      : signal_name(_signal), params(_params), action(_action), def_line(_line)
+      , label(emp::MakeString("@", _signal, " (line ", _line, ")")), timing(_timing) { }
       ~Action() {
         for (auto x : params) x.Delete();
         action.Delete();
+        if (program) program.Delete();
       }
 
-      void Trigger(const symbol_vec_t & args) {
+      void Trigger(const symbol_vec_t & args, bool compile) {
         if (args.size() < params.size()) {
           std::cerr << "ERROR: Trigger for signal '" << signal_name
                     << "' (defined on " << def_line << ") called with " << args.size()
@@ -84,7 +122,13 @@ namespace emplode {
           }
         }
 
-        // Once all of the parameter values are in place, run the action!
+        // Once all of the parameter values are in place, run the action!  Programs with
+        // native versions compiled in always run that way.
+        if (compile || BytecodeProgram::HasNatives()) {
+          if (!program) program = emp::NewPtr<BytecodeProgram>(action);
+          program->Run();
+          return;
+        }
         symbol_ptr_t result = action->Process();
         if (result && result->IsTemporary()) result.Delete();
       }
@@ -102,14 +146,69 @@ namespace emplode {
       emp::String signal_name;
       size_t num_params;
       emp::vector<emp::Ptr<Action>> actions;
+      size_t num_untimed = 0;      ///< How many actions run on every trigger?
+
+      /// Timed actions, ordered by the next trigger value at which each is due.
+      using due_t = std::pair<double, size_t>;  // (next value, action id)
+      std::priority_queue<due_t, std::vector<due_t>, std::greater<due_t>> schedule;
+
+      /// Numeric argument symbols are kept between triggers rather than reallocated.
+      symbol_vec_t arg_symbols;
 
       Event(const emp::String & _name, size_t _params)
         : signal_name(_name), num_params(_params) { }
-      ~Event() { for (auto ptr : actions) ptr.Delete(); }
+      ~Event() {
+        for (auto ptr : actions) ptr.Delete();
+        for (auto ptr : arg_symbols) if (ptr) ptr.Delete();
+      }
+
+      void AddAction(emp::Ptr<Action> action_ptr) {
+        const ActionTiming & timing = action_ptr->timing;
+        if (!timing.active) ++num_untimed;
+        else if (timing.start <= timing.stop) schedule.push({timing.start, actions.size()});
+        actions.push_back(action_ptr);
+      }
+
+      /// Flag the timed actions due at 'value'; return true if any are.
+      bool MarkDue(double value) {
+        bool any_due = false;
+        while (schedule.size() && schedule.top().first <= value) {
+          auto [next, action_id] = schedule.top();
+          schedule.pop();
+          Action & action = *actions[action_id];
+          const double step = action.timing.step;
+          if (next < value) {                             // Missed value; catch up.
+            if (step <= 0.0) continue;
+            next += std::ceil((value - next) / step) * step;
+          }
+          if (next == value) {
+            action.due = any_due = true;
+            if (step <= 0.0) continue;
+            next += step;
+          }
+          if (next <= action.timing.stop) schedule.push({next, action_id});
+        }
+        return any_due;
+      }
+
+      void Trigger(symbol_vec_t args, const profile_fun_t & profile_fun, bool compile) {
+        if (profile_fun) {
+          for (emp::Ptr<Action> action : actions) {
+            if (action->timing.active && !action->due) continue;
+            action->due = false;
+            const auto start = std::chrono::steady_clock::now();
+            action->Trigger(args, compile);
+            const auto duration = std::chrono::steady_clock::now() - start;
+            profile_fun(action->label,
+              (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+          }
+          return;
+        }
 
-      void Trigger(symbol_vec_t args) {
         for (emp::Ptr<Action> action : actions) {
-          action->Trigger(args);
+          if (action->timing.active && !action->due) continue;
+          action->due = false;
+          action->Trigger(args, compile);
         }
       }
 
@@ -130,6 +229,13 @@ namespace emplode {
       }
     }
 
+    /// Set a function to be called with the run time of each action (empty to turn off).
+    void SetProfileFun(profile_fun_t in_fun) { profile_fun = in_fun; }
+
+    /// Should actions be compiled to bytecode (on their first trigger) and run that way?
+    void SetCompileActions(bool in) { compile_actions = in; }
+    bool GetCompileActions() const { return compile_actions; }
+
     bool HasSignal(const emp::String & signal_name) const {
       return emp::Has(event_map, signal_name);
     }
@@ -148,13 +254,14 @@ namespace emplode {
       const emp::String & signal_name,  ///< Name of signal to trigger using
       node_vec_t params,                ///< Parameters to set before taking action
       node_ptr_t action,                ///< Abstract syntax tree to run when triggered
-      size_t def_line                   ///< What file line was this defined on?
+      size_t def_line,                  ///< What file line was this defined on?
+      ActionTiming timing={}            ///< When should this action run? (default: always)
     ) {
       // @CAO Needs to become a user-level error?
       emp_assert(emp::Has(event_map, signal_name), "Unknown signal used!", signal_name);
 
-      auto action_ptr = emp::NewPtr<Action>(signal_name, params, action, def_line);
-      event_map[signal_name]->actions.push_back(action_ptr);
+      auto action_ptr = emp::NewPtr<Action>(signal_name, params, action, def_line, timing);
+      event_map[signal_name]->AddAction(action_ptr);
 
       return true;
     }
@@ -164,11 +271,20 @@ namespace emplode {
       // @CAO Make into user-level error.
       emp_assert(emp::Has(event_map, signal_name), "Unknown signal being triggered!", signal_name);
 
-      const emp::String location = emp::MakeString("trigger of ", signal_name);
-      symbol_vec_t symbol_args = { symbol_table.ValueToSymbol(args, location)... };
-      event_map[signal_name]->Trigger(symbol_args);
+      Event & event = *event_map[signal_name];
+      bool any_due = false;
+      if constexpr (sizeof...(ARG_TS) > 0) {
+        if (event.schedule.size()) any_due = event.MarkDue(FirstAsDouble(args...));
+      }
+      if (!any_due && event.num_untimed == 0) return true;   // Nothing to do this time.
+
+      // Reuse symbols for numeric arguments; others are converted as temporaries.
+      symbol_vec_t symbol_args(sizeof...(ARG_TS));
+      size_t arg_id = 0;
+      (SetArgSymbol(event, symbol_args, arg_id++, args), ...);
+      event.Trigger(symbol_args, profile_fun, compile_actions);
 
-      // Now that all of the actions have been run, clean up the symbol_args.
+      // Now that all of the actions have been run, clean up the temporary symbol_args.
       for (auto symbol_ptr : symbol_args) {
         if (symbol_ptr->IsTemporary()) symbol_ptr.Delete();
       }
@@ -176,12 +292,57 @@ namespace emplode {
       return true;
     }
 
+  private:
+    template <typename T, typename... EXTRA_TS>
+    static double FirstAsDouble(const T & first, const EXTRA_TS &...) {
+      if constexpr (std::is_arithmetic<T>()) return (double) first;
+      else return std::nan("");  // Non-numeric triggers never match a timed action.
+    }
+
+    template <typename T>
+    void SetArgSymbol(Event & event, symbol_vec_t & symbol_args, size_t arg_id, T & value) {
+      if constexpr (std::is_arithmetic<T>()) {
+        if (event.arg_symbols.size() <= arg_id) event.arg_symbols.resize(arg_id+1, nullptr);
+        symbol_ptr_t & arg_ptr = event.arg_symbols[arg_id];
+        if (arg_ptr) arg_ptr->SetValue((double) value);
+        else arg_ptr = emp::NewPtr<Symbol_Var>("__Arg", (double) value, "Trigger argument", nullptr);
+        symbol_args[arg_id] = arg_ptr;
+      } else {
+        const emp::String location = emp::MakeString("trigger of ", event.signal_name);
+        symbol_args[arg_id] = symbol_table.ValueToSymbol(value, location);
+      }
+    }
+
+  public:
     /// Print all of the events being tracked here.
     void Write(std::ostream & os) const {
       for (auto [name, ptr] : event_map) {
         ptr->Write(os);
       }
     }
+
+    /// Write every action as native C++ code (see BytecodeProgram::WriteCpp()), each one
+    /// registered under its signature; include the output after Emplode to use it.
+    void WriteCpp(std::ostream & os) const {
+      os << "// Native event actions, generated by EventManager::WriteCpp(); do not edit.\n\n"
+         << "#ifndef EMPLODE_NATIVE_EVENTS_H\n"
+         << "#define EMPLODE_NATIVE_EVENTS_H\n\n"
+         << "namespace emplode::native_events {\n";
+      std::set<emp::String> signatures;
+      for (auto [name, event_ptr] : event_map) {
+        for (emp::Ptr<Action> action : event_ptr->actions) {
+          BytecodeProgram program(action->action);
+          if (!signatures.insert(program.GetSignature()).second) continue;  // Already written.
+          const emp::String fun_name = emp::MakeString("Action", signatures.size());
+          os << "\n  // " << action->label << "\n";
+          program.WriteCpp(os, fun_name);
+          os << "  inline const bool " << fun_name << "_registered =\n"
+             << "    emplode::BytecodeProgram::RegisterNative(" << emp::to_literal(program.GetSignature())
+             << ", " << fun_name << ");\n";
+        }
+      }
+      os << "}\n\n#endif\n";
+    }
   };
 
 
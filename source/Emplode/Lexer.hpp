@@ -33,7 +33,7 @@ namespace emplode {
 
       // Keywords have top priority, especially over identifiers.   Most are simply reserved words.
       token_keyword = AddToken("Keyword",
-        "(BREAK)|(CONTINUE)|(ELSE)|(IF)|(WHILE)"
+        "(BREAK)|(CONTINUE)|(ELSE)|(IF)|(PARALLEL)|(WHILE)"
         // Reserved keywords below.
         "|(AND)|(AUTO)|(CASE)|(CAST)|(CATCH)|(CLASS)|(CONST)|(DEBUG)"
         "|(DEFAULT)|(DEFINE)|(DELETE)|(DO)|(EVENT)|(EVERY)|(FALSE)|(FOR)|(FOREACH)"
@@ -27,6 +27,7 @@
  *    ASTPtr ParseVar(ParseState & state, bool create_ok=false, bool scan_scopes=true);
  *    ASTPtr ParseValue(ParseState & state);
  *    ASTPtr ParseExpression(ParseState & state, bool decl_ok=false, size_t prec_limit=1000);
+ *    double ParseConstant(ParseState & state);  // Expression evaluated immediately.
  *    Symbol & ParseDeclaration(ParseState & state);
  *    ASTPtr ParseEvent(ParseState & state);
  *    ASTPtr ParseKeywordStatement(ParseState & state);   // IF, WHILE, etc
@@ -269,6 +270,9 @@ namespace emplode {
                                                     bool decl_ok=false,
                                                     size_t prec_limit=1000);
 
+    /// Parse an expression and evaluate it now (for values needed at parse time).
+    double ParseConstant(ParseState & state);
+
     /// Parse the declaration of a variable and return the newly created Symbol
     Symbol & ParseDeclaration(ParseState & state);
 
@@ -355,9 +359,20 @@ namespace emplode {
 
     // First check for a unary negation at the start of the value.
     if (state.UseIfChar('-')) {
-      auto out_val = emp::NewPtr<ASTNode_Op1>("unary negation", state.GetLine());
+      const int line_id = state.GetLine();
+      emp::Ptr<ASTNode> in_node = ParseValue(state);
+
+      // Negating a numeric literal can be done now rather than each time it is used.
+      auto in_leaf = in_node.DynamicCast<ASTNode_Leaf>();
+      if (in_leaf && in_leaf->IsLiteral() && in_leaf->IsNumeric()) {
+        const double value = -in_leaf->GetSymbol().AsDouble();
+        in_node.Delete();
+        return MakeTempLeaf(value, line_id);
+      }
+
+      auto out_val = emp::NewPtr<ASTNode_Op1>("unary negation", line_id);
       out_val->SetFun( [](double val){ return -val; } );
-      out_val->AddChild(ParseValue(state));
+      out_val->AddChild(in_node);
       return out_val;
     }
 
@@ -422,6 +437,37 @@ namespace emplode {
     else if (symbol == "&&") out_val->SetFun( [](emp::Datum v1, emp::Datum v2){ return v1 && v2; } );
     else if (symbol == "||") out_val->SetFun( [](emp::Datum v1, emp::Datum v2){ return v1 || v2; } );
 
+    // Unboxed versions for when both sides are known to be numeric.
+    using num_fun_t = ASTNode_Op2::num_fun_t;
+    num_fun_t num_fun = nullptr;
+    if (symbol == "+") num_fun = [](double v1, double v2){ return v1 + v2; };
+    else if (symbol == "-") num_fun = [](double v1, double v2){ return v1 - v2; };
+    else if (symbol == "**") num_fun = [](double v1, double v2){ return emp::Pow(v1, v2); };
+    else if (symbol == "*") num_fun = [](double v1, double v2){ return v1 * v2; };
+    else if (symbol == "/") num_fun = [](double v1, double v2){ return v1 / v2; };
+    else if (symbol == "%") num_fun = [](double v1, double v2){ return (emp::Datum(v1) % emp::Datum(v2)).AsDouble(); };
+    else if (symbol == "==") num_fun = [](double v1, double v2){ return (double) (v1 == v2); };
+    else if (symbol == "!=") num_fun = [](double v1, double v2){ return (double) (v1 != v2); };
+    else if (symbol == "<")  num_fun = [](double v1, double v2){ return (double) (v1 < v2); };
+    else if (symbol == "<=") num_fun = [](double v1, double v2){ return (double) (v1 <= v2); };
+    else if (symbol == ">")  num_fun = [](double v1, double v2){ return (double) (v1 > v2); };
+    else if (symbol == ">=") num_fun = [](double v1, double v2){ return (double) (v1 >= v2); };
+    else if (symbol == "&&") num_fun = [](double v1, double v2){ return (double) (v1 != 0.0 && v2 != 0.0); };
+    else if (symbol == "||") num_fun = [](double v1, double v2){ return (double) (v1 != 0.0 || v2 != 0.0); };
+    out_val->SetNumFun(num_fun);
+
+    // Fold operations on two numeric literals into a single literal.
+    auto leaf1 = in_node1.DynamicCast<ASTNode_Leaf>();
+    auto leaf2 = in_node2.DynamicCast<ASTNode_Leaf>();
+    if (num_fun && leaf1 && leaf2 && leaf1->IsLiteral() && leaf2->IsLiteral() &&
+        leaf1->IsNumeric() && leaf2->IsNumeric()) {
+      const double value = num_fun(leaf1->GetSymbol().AsDouble(), leaf2->GetSymbol().AsDouble());
+      in_node1.Delete();
+      in_node2.Delete();
+      out_val.Delete();
+      return MakeTempLeaf(value, op_token.line_id);
+    }
+
     out_val->AddChild(in_node1);
     out_val->AddChild(in_node2);
 
@@ -512,6 +558,18 @@ namespace emplode {
     return state.AddObject(type_name, var_name);
   }
 
+  // Parse an expression and evaluate it immediately.
+  double Parser::ParseConstant(ParseState & state) {
+    // Operators need a symbol table to build their results, so evaluate inside a block.
+    auto block = emp::NewPtr<ASTNode_Block>(state.GetScope(), state.GetLine());
+    block->SetSymbolTable(state.GetSymbolTable());
+    emp::Ptr<ASTNode> node = ParseExpression(state);
+    block->AddChild(node);
+    const double value = node->ProcessAs<double>();
+    block.Delete();
+    return value;
+  }
+
   // Parse an event description.
   emp::Ptr<ASTNode> Parser::ParseEvent(ParseState & state) {
     emp::Token start_token = state.AsToken();
@@ -521,8 +579,23 @@ namespace emplode {
     state.UseRequiredChar('(', "Expected parentheses after '", trigger_name, "' for args.");
 
     emp::vector<emp::Ptr<ASTNode>> args;
+    EventManager::ActionTiming timing;
     while (state.AsChar() != ')') {
       args.push_back( ParseExpression(state, true) );
+
+      // The first arg may be limited to a range of values: IN [start:step:stop]
+      if (state.UseIfLexeme("IN")) {
+        if (args.size() != 1) state.Error("Only the first event argument can have an IN range.");
+        state.UseRequiredChar('[', "Expected '[' to begin IN range.");
+        timing.active = true;
+        timing.start = ParseConstant(state);
+        if (state.UseIfChar(':')) {
+          timing.step = ParseConstant(state);
+          if (state.UseIfChar(':')) timing.stop = ParseConstant(state);
+        }
+        state.UseRequiredChar(']', "Expected ']' to end IN range.");
+      }
+
       state.UseIfChar(',');                     // Skip comma if next (does allow trailing comma)
     }
     state.UseRequiredChar(')', "Event args must end in a ')'");
@@ -536,7 +609,7 @@ namespace emplode {
 
     Debug("Building event '", trigger_name, "' with args ", args);
 
-    state.AddAction(trigger_name, args, action_block, start_token.line_id);
+    state.AddAction(trigger_name, args, action_block, start_token.line_id, timing);
 
     return nullptr;
   }
@@ -563,6 +636,12 @@ namespace emplode {
       return emp::NewPtr<ASTNode_While>(test_node, body_node, keyword_line);
     }
 
+    else if (state.UseIfLexeme("PARALLEL")) {
+      emp::Ptr<ASTNode> body_node = ParseStatement(state);
+      if (!body_node) return nullptr;         // Empty block; nothing to run.
+      return emp::NewPtr<ASTNode_Parallel>(body_node, keyword_line);
+    }
+
     else if (state.UseIfLexeme("BREAK")) { return MakeBreakLeaf(keyword_line); }
 
     else if (state.UseIfLexeme("CONTINUE")) { return MakeContinueLeaf(keyword_line); }
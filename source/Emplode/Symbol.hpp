@@ -22,6 +22,9 @@
 #ifndef EMPLODE_SYMBOL_HPP
 #define EMPLODE_SYMBOL_HPP
 
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <type_traits>
 
 #include "emp/base/assert.hpp"
@@ -35,6 +38,8 @@
 #include "emp/tools/String.hpp"
 #include "emp/tools/value_utils.hpp"
 
+#include "Arena.hpp"
+
 namespace emplode {
 
   class EmplodeType;
@@ -43,7 +48,7 @@ namespace emplode {
   class Symbol_Scope;
   class TypeInfo;
 
-  class Symbol {
+  class Symbol : public ArenaAllocated {
   protected:
     emp::String name;             ///< Unique name for symbol; empty name implies temporary.
     emp::String desc;             ///< Description to put in comments for this symbol.
@@ -417,6 +422,30 @@ namespace emplode {
     symbol_ptr_t Clone() const override { return emp::NewPtr<this_t>(*this); }
   };
 
+  /// One argument to a function run through Symbol_Function::CallNumber(); parameters that
+  /// take a number are given 'value' directly, and any other parameter gets 'symbol'.
+  struct CallArg {
+    double value = 0.0;
+    emp::Ptr<Symbol> symbol = nullptr;
+  };
+
+  /// A wrapped function that returns a number, called without building any Symbols for
+  /// numeric arguments or for its result.
+  struct NumberFun {
+    std::function<double(std::span<const CallArg>)> fun;
+    uint32_t number_params = 0;    ///< Bit i is set if parameter i takes CallArg::value.
+
+    explicit operator bool() const { return (bool) fun; }
+  };
+
+  /// A NumberFun for a member function, still needing the object to call it on.
+  struct MemberNumberFun {
+    std::function<double(EmplodeType &, std::span<const CallArg>)> fun;
+    uint32_t number_params = 0;    ///< Bit i is set if parameter i takes CallArg::value.
+
+    explicit operator bool() const { return (bool) fun; }
+  };
+
 
   ////////////////////////////////////////////////////
   //  Function definitions...
@@ -45,11 +45,13 @@ namespace emplode {
 
   class SymbolTable : public SymbolTableBase {
   protected:
+    // File streams are declared first so they are destroyed last, after the objects in
+    // root_scope (such as DataFiles) that may still need to write to them.
+    emp::StreamManager file_map;                                    ///< File streams by name.
     Symbol_Scope root_scope;                                        ///< Outermost (global) scope.
     EventManager event_manager;                                     ///< Event setup & tracking
     std::unordered_map<emp::String, emp::Ptr<TypeInfo>> type_map;   ///< Types, lookup by name.
     std::unordered_map<emp::TypeID, emp::Ptr<TypeInfo>> typeid_map; ///< Types, lookup by TypeID.
-    emp::StreamManager file_map;                                    ///< File streams by name.
 
   public:
     SymbolTable(const emp::String & name)
@@ -102,7 +104,8 @@ namespace emplode {
       auto emplode_fun = WrapFunction(name, fun);
       using return_t = typename emp::FunInfo<FUN_T>::return_t;
       emp::TypeID return_id = emp::GetTypeID<return_t>();
-      root_scope.AddBuiltinFunction(name, emplode_fun, desc, return_id);
+      root_scope.AddBuiltinFunction(name, emplode_fun, desc, return_id)
+        .SetNumberFun(WrapNumberFunction(fun));
     }
 
     /// To add a type, provide the type name (that can be referred to in a script) and a function
@@ -192,7 +195,8 @@ namespace emplode {
 
 
     emp::Ptr<Symbol_Object> MakeTempObjSymbol(emp::TypeID type_id,
-                                              emp::Ptr<EmplodeType> value_ptr=nullptr) override {
+                                              emp::Ptr<EmplodeType> value_ptr=nullptr,
+                                              bool move_value=false) override {
       TypeInfo & type_info = *typeid_map[type_id];
       emp_assert(type_info.GetOwned(),
                  "Only symbol-owned types can be temporary since they are deleted dynamically.",
@@ -204,7 +208,10 @@ namespace emplode {
 
       new_symbol->SetTemporary();                              // Mark new symbol to be deleted.
       new_obj->Setup(*new_symbol);                             // Setup new object with its symbol.
-      if (value_ptr) type_info.CopyObj(*value_ptr, *new_obj);  // Copy value in, if we have one.
+      if (value_ptr) {                                         // Copy value in, if we have one.
+        if (move_value) type_info.MoveObj(*value_ptr, *new_obj);
+        else type_info.CopyObj(*value_ptr, *new_obj);
+      }
 
       return new_symbol;
     }
@@ -220,10 +227,11 @@ namespace emplode {
       const emp::String & name,
       emp::vector< emp::Ptr<ASTNode> > params,
       emp::Ptr<ASTNode_Block> action,
-      size_t def_line
+      size_t def_line,
+      EventManager::ActionTiming timing={}
     ) {
       action->SetSymbolTable(*this);
-      return event_manager.AddAction(name, params, action, def_line);
+      return event_manager.AddAction(name, params, action, def_line, timing);
     }
 
     /// Trigger all events of a type (ignoring trigger values)
@@ -232,9 +240,21 @@ namespace emplode {
       return event_manager.Trigger(signal_name, std::forward<ARG_Ts>(args)...);
     }
 
+    /// Report the run time of each triggered event action to 'fun' (empty function turns off).
+    void SetEventProfileFun(EventManager::profile_fun_t fun) {
+      event_manager.SetProfileFun(fun);
+    }
+
+    /// Run event actions as compiled bytecode rather than by walking their AST?
+    void SetCompileEvents(bool in) { event_manager.SetCompileActions(in); }
+    bool GetCompileEvents() const { return event_manager.GetCompileActions(); }
+
     /// Print all of the events to the provided stream.
     void PrintEvents(std::ostream & os) const { event_manager.Write(os); }
 
+    /// Write all of the event actions to the provided stream as native C++ code.
+    void WriteEventsCpp(std::ostream & os) const { event_manager.WriteCpp(os); }
+
   };
 
 }
@@ -11,6 +11,11 @@
 #ifndef EMPLODE_SYMBOL_TABLE_BASE_HPP
 #define EMPLODE_SYMBOL_TABLE_BASE_HPP
 
+#include <functional>
+#include <optional>
+#include <span>
+#include <tuple>
+
 #include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
 #include "emp/datastructs/tuple_utils.hpp"
@@ -32,16 +37,37 @@ namespace emplode {
     using symbol_vector_t = const emp::vector<symbol_ptr_t> &;
     using target_t = symbol_ptr_t( symbol_vector_t );
 
-    /// Allocate a temporary (unnamed) object symbol with a given value.
+    /// For each statement in a PARALLEL block, the objects (e.g., modules) whose member
+    /// functions it calls; a nullptr entry stands for a call to a global function.
+    using call_objs_t = emp::vector<emp::vector<emp::Ptr<EmplodeType>>>;
+    using parallel_fun_t = std::function<void(const call_objs_t &, const std::function<void(size_t)> &)>;
+
+  protected:
+    parallel_fun_t parallel_fun;    ///< Host-provided runner for PARALLEL blocks (if any).
+
+  public:
+    /// Let the host decide how the statements of a PARALLEL block are run, given the objects
+    /// each one calls into; it must call run_statement(id) exactly once for each statement.
+    void SetParallelFun(parallel_fun_t fun) { parallel_fun = fun; }
+
+    /// Run the statements of a PARALLEL block; without a host runner, they are run in order.
+    void RunParallel(const call_objs_t & calls, const std::function<void(size_t)> & run_statement) {
+      if (parallel_fun) { parallel_fun(calls, run_statement); return; }
+      for (size_t id = 0; id < calls.size(); ++id) run_statement(id);
+    }
+
+    /// Allocate a temporary (unnamed) object symbol with a given value; if move_value is set,
+    /// the value may be taken (with the type's move function) rather than copied.
     /// NOTE: Caller is responsible for deleting the created symbol!
     virtual emp::Ptr<Symbol_Object>
-    MakeTempObjSymbol(emp::TypeID type_id, emp::Ptr<EmplodeType> value_ptr=nullptr) = 0;
+    MakeTempObjSymbol(emp::TypeID type_id, emp::Ptr<EmplodeType> value_ptr=nullptr,
+                      bool move_value=false) = 0;
 
     /// Allocate a temporary symbol with the given type and value.
     template <typename T>
     auto MakeTempSymbol(T value) {
       if constexpr (std::is_base_of<EmplodeType, T>()) {
-        return MakeTempObjSymbol(emp::GetTypeID<T>(), &value);
+        return MakeTempObjSymbol(emp::GetTypeID<T>(), &value, true);   // 'value' is our copy.
       } else {
         auto out_symbol = emp::NewPtr<Symbol_Var>("__Temp", value, "", nullptr);
         out_symbol->SetTemporary();
@@ -102,6 +128,65 @@ namespace emplode {
     }
 
 
+    /// Holds one converted argument for the duration of a wrapped function call; by default,
+    /// the argument is converted with Symbol::As() (so value parameters can be moved from).
+    template <typename T>
+    struct ArgValue {
+      using value_t = decltype(std::declval<Symbol &>().template As<T>());
+      value_t value;
+      ArgValue(Symbol & symbol) : value(symbol.template As<T>()) { }
+      value_t && Get() { return static_cast<value_t &&>(value); }
+    };
+
+    /// Const references to Emplode types bind directly to the object in the symbol when it
+    /// already has that type (e.g., an OrgList passed to EVAL); only other objects are converted
+    /// into a temporary that lives until the call returns.
+    template <typename T>
+      requires (std::is_base_of_v<EmplodeType, T> && std::is_move_constructible_v<T>)
+    struct ArgValue<const T &> {
+      emp::Ptr<const T> ptr = nullptr;
+      std::optional<T> temp;
+      ArgValue(Symbol & symbol) {
+        emp::Ptr<EmplodeType> obj_ptr = symbol.GetObjectPtr();
+        if (obj_ptr) ptr = obj_ptr.DynamicCast<T>();
+        if (!ptr) { temp.emplace(symbol.template As<T>()); ptr = &*temp; }
+      }
+      const T & Get() { return *ptr; }
+    };
+
+    /// Holds one argument for a CallNumber() call.  Numeric parameters take CallArg::value as
+    /// is; any other parameter is converted from CallArg::symbol, as with ArgValue.
+    template <typename T>
+    struct CallArgValue {
+      ArgValue<T> arg;
+      CallArgValue(const CallArg & in) : arg(*in.symbol) { }
+      decltype(auto) Get() { return arg.Get(); }
+    };
+
+    template <typename T>
+      requires std::is_arithmetic_v<std::decay_t<T>>
+    struct CallArgValue<T> {
+      std::decay_t<T> value;
+      CallArgValue(const CallArg & in) : value(static_cast<std::decay_t<T>>(in.value)) { }
+      std::decay_t<T> & Get() { return value; }
+    };
+
+    /// Can a function with these types be wrapped as a NumberFun?  It must return a number and
+    /// take a fixed list of parameters (not a vector of symbols).
+    template <typename RETURN_T, typename... PARAM_Ts>
+    static constexpr bool IsNumberCallable() {
+      return std::is_arithmetic_v<std::decay_t<RETURN_T>> && sizeof...(PARAM_Ts) <= 32 &&
+             (!std::is_same_v<PARAM_Ts, symbol_vector_t> && ...);
+    }
+
+    /// Flag each parameter that takes a number directly (for NumberFun::number_params).
+    template <typename... PARAM_Ts>
+    static constexpr uint32_t NumberParams() {
+      uint32_t out = 0, bit = 1;
+      ((out |= (std::is_arithmetic_v<std::decay_t<PARAM_Ts>> ? bit : 0), bit <<= 1), ...);
+      return out;
+    }
+
     /// A generic helper class for wrapping functions (must be specialized based on argument count)
     template <typename FUN_T, typename INDEX_Ts> struct WrapFunction_impl;
 
@@ -120,6 +205,16 @@ namespace emplode {
         };
       }
 
+      template <typename FUN_T>
+      static NumberFun ConvertNumberFun(FUN_T fun) {
+        if constexpr (IsNumberCallable<RETURN_T>()) {
+          return NumberFun{ [fun=fun](std::span<const CallArg>) {
+            return static_cast<double>(fun());
+          }, 0 };
+        }
+        else return NumberFun{};
+      }
+
     };
 
     /// Specialization for functions with AT LEAST ONE argument.
@@ -180,14 +275,30 @@ namespace emplode {
             }
             //@CAO should collect file position information for the above errors.
 
+            ArgValue<PARAM1_T> arg1(*args[0]);
+            std::tuple<ArgValue<PARAM_Ts>...> arg_values(*args[INDEX_VALS+1]...);
             return st.ValueToSymbol(
-              fun(args[0]->As<PARAM1_T>(), args[INDEX_VALS+1]->template As<PARAM_Ts>()...),
+              fun(arg1.Get(), std::get<INDEX_VALS>(arg_values).Get()...),
               name
             );
           }
         };      
       }
 
+      // Stand-alone function as a NumberFun (empty if it does not qualify).
+      template <typename FUN_T>
+      static NumberFun ConvertNumberFun(FUN_T fun) {
+        if constexpr (IsNumberCallable<RETURN_T, PARAM1_T, PARAM_Ts...>()) {
+          return NumberFun{ [fun=fun](std::span<const CallArg> args) {
+            emp_assert(args.size() == 1 + sizeof...(PARAM_Ts), args.size());
+            CallArgValue<PARAM1_T> arg1(args[0]);
+            std::tuple<CallArgValue<PARAM_Ts>...> arg_values{args[INDEX_VALS+1]...};
+            return static_cast<double>(fun(arg1.Get(), std::get<INDEX_VALS>(arg_values).Get()...));
+          }, NumberParams<PARAM1_T, PARAM_Ts...>() };
+        }
+        else return NumberFun{};
+      }
+
       // Member function (with at least one argument)...
       template <typename FUN_T>
       static auto ConvertMemberFun(const emp::String & name, FUN_T fun, SymbolTableBase & st) {  
@@ -238,11 +349,31 @@ namespace emplode {
             }
             //@CAO should collect file position information for the above errors.
 
-            return st.ValueToSymbol( fun(*typed_ptr, args[INDEX_VALS]->template As<PARAM_Ts>()...), name );
+            std::tuple<ArgValue<PARAM_Ts>...> arg_values(*args[INDEX_VALS]...);
+            return st.ValueToSymbol( fun(*typed_ptr, std::get<INDEX_VALS>(arg_values).Get()...), name );
           }
         };
       }
 
+      // Member function as a MemberNumberFun (empty if it does not qualify).
+      template <typename FUN_T>
+      static MemberNumberFun ConvertMemberNumberFun([[maybe_unused]] const emp::String & name, FUN_T fun) {
+        if constexpr (IsNumberCallable<RETURN_T, PARAM_Ts...>()) {
+          return MemberNumberFun{
+            [name=name,fun=fun](EmplodeType & obj, [[maybe_unused]] std::span<const CallArg> args) {
+              emp_assert(args.size() == sizeof...(PARAM_Ts), name, args.size());
+              emp::Ptr<EmplodeType> obj_ptr(&obj);
+              auto typed_ptr = obj_ptr.DynamicCast<std::remove_reference_t<PARAM1_T>>();
+              emp_assert(typed_ptr, "Internal error: member function call on wrong object type!", name);
+              std::tuple<CallArgValue<PARAM_Ts>...> arg_values{args[INDEX_VALS]...};
+              return static_cast<double>(fun(*typed_ptr, std::get<INDEX_VALS>(arg_values).Get()...));
+            },
+            NumberParams<PARAM_Ts...>()
+          };
+        }
+        else return MemberNumberFun{};
+      }
+
     };
 
     // Wrap a provided function to make it take a vector of Ptr<Symbol> and return a
@@ -283,6 +414,29 @@ namespace emplode {
       return helper_t::ConvertMemberFun(name, fun, *this);
     }
 
+    // Wrap a function that returns a number so that it can be called with CallArgs and return
+    // its result directly; returns an empty NumberFun for other functions.
+    template <typename FUN_T>
+    static NumberFun WrapNumberFunction(FUN_T fun) {
+      using info_t = emp::FunInfo<FUN_T>;
+      using fun_t = typename info_t::fun_t;
+      if constexpr (info_t::num_args == 0) {
+        return WrapFunction_impl<fun_t, emp::ValPack<>>::ConvertNumberFun(fun);
+      } else {
+        using index_t = emp::ValPackCount<info_t::num_args-1>;
+        return WrapFunction_impl<fun_t, index_t>::ConvertNumberFun(fun);
+      }
+    }
+
+    // As WrapNumberFunction(), but for member functions (called with the object first).
+    template <typename FUN_T>
+    static MemberNumberFun WrapMemberNumberFunction(const emp::String & name, FUN_T fun) {
+      using info_t = emp::FunInfo<FUN_T>;
+      using index_t = emp::ValPackCount<info_t::num_args-1>;
+      using helper_t = WrapFunction_impl<typename info_t::fun_t, index_t>;
+      return helper_t::ConvertMemberNumberFun(name, fun);
+    }
+
   };
 
 }
@@ -33,8 +33,17 @@ namespace emplode {
     struct FunInfo {
       std_fun_t fun;            // Unified-form function.
       int num_params;        // How many arguments does this function take?
+      NumberFun number_fun;  // Optional faster form, for functions that return a number.
     };
 
+    /// Find the overload that a call with this many arguments will use.
+    emp::Ptr<const FunInfo> FindOverload(size_t num_args) const {
+      for (const auto & x : overloads) {
+        if (x.num_params == -1 || x.num_params == (int) num_args) return &x;
+      }
+      return nullptr;
+    }
+
     emp::vector<FunInfo> overloads;  // Set of overload options for this function.
     emp::TypeID return_type;         // All overloads must share a return type.
 
@@ -49,7 +58,7 @@ namespace emplode {
                     emp::TypeID _ret_type)
       : Symbol(_name, _desc, _scope), return_type(_ret_type)
     {
-      overloads.push_back( FunInfo{fun, num_params} );
+      overloads.push_back( FunInfo{fun, num_params, NumberFun{}} );
     }
 
     Symbol_Function(const Symbol_Function &) = default;
@@ -83,13 +92,34 @@ namespace emplode {
     }
 
 
+    /// Provide a faster form of the most recently added overload (see CallNumber()).
+    Symbol_Function & SetNumberFun(NumberFun in_fun) {
+      emp_assert(overloads.size() > 0);
+      overloads.back().number_fun = std::move(in_fun);
+      return *this;
+    }
+
+    /// Get the faster form of the overload used for this many arguments, if it has one.
+    emp::Ptr<const NumberFun> GetNumberFun(size_t num_args) const {
+      emp::Ptr<const FunInfo> info = FindOverload(num_args);
+      if (!info || !info->number_fun) return nullptr;
+      return &info->number_fun;
+    }
+
+    /// Call a function that has a NumberFun for this many arguments, returning its result
+    /// directly; each argument must be set up as the NumberFun's number_params indicate.
+    double CallNumber(std::span<const CallArg> args) const {
+      emp::Ptr<const NumberFun> number_fun = GetNumberFun(args.size());
+      emp_assert(number_fun, "No numeric form of function.", name, args.size());
+      return number_fun->fun(args);
+    }
+
     symbol_ptr_t Call( const emp::vector<symbol_ptr_t> & args ) override {
       emp_assert(overloads.size() > 0);
 
       // Find the correct overloads...
-      for (auto & x : overloads) {
-        if (x.num_params == -1 || x.num_params == (int) args.size()) return x.fun(args);
-      }
+      emp::Ptr<const FunInfo> info = FindOverload(args.size());
+      if (info) return info->fun(args);
 
       emp::String msg =
         emp::MakeString("No overload for function '", name, "' that takes ", args.size(),
@@ -39,7 +39,8 @@ namespace emplode {
       
     Symbol_Object(const Symbol_Object & in) = delete;
     Symbol_Object(Symbol_Object && in)
-      : Symbol_Scope(std::move(in)), obj_ptr(in.obj_ptr), obj_owned(in.obj_owned)
+      : Symbol_Scope(std::move(in)), obj_ptr(in.obj_ptr), type_info_ptr(in.type_info_ptr)
+      , obj_owned(in.obj_owned)
     {
       // Remove the object from the incoming symbol.
       in.obj_ptr = nullptr;    
@@ -47,8 +48,10 @@ namespace emplode {
     }
 
     ~Symbol_Object() {
-      // If this scope owns its object pointer, delete it now.
-      if (obj_owned) obj_ptr.Delete();
+      // If this scope owns its object pointer, release it now (by default, delete it).
+      if (!obj_owned) return;
+      if (type_info_ptr) type_info_ptr->ReleaseObj(obj_ptr);
+      else obj_ptr.Delete();
     }
 
     emp::Ptr<EmplodeType> GetObjectPtr() override { return obj_ptr; }  
@@ -34,12 +34,17 @@ namespace emplode {
     using const_symbol_ptr_t = emp::Ptr<const Symbol>;
     emp::map< emp::String, symbol_ptr_t > symbol_map;   ///< Map of names to entries.
 
+    /// Bumped whenever any scope gains a symbol; a new name can shadow an outer one, so code
+    /// that caches how identifiers were resolved must check this has not changed.
+    static inline size_t symbol_version = 0;
+
     template <typename T, typename... ARGS>
     T & Add(const emp::String & name, ARGS &&... args) {
       auto new_ptr = emp::NewPtr<T>(name, std::forward<ARGS>(args)...);
       emp_assert(!emp::Has(symbol_map, name), "Do not redeclare functions or variables!",
                  name);
       symbol_map[name] = new_ptr;
+      ++symbol_version;
       return *new_ptr;
     }
 
@@ -67,6 +72,8 @@ namespace emplode {
 
     emp::String GetTypename() const override { return "Scope"; }
 
+    static size_t GetSymbolVersion() { return symbol_version; }
+
     bool IsScope() const override { return true; }
     bool IsLocal() const override { return true; }  // @CAO, for now assuming all scopes are local!
 
@@ -174,7 +181,9 @@ namespace emplode {
     }
 
     /// Add an internal scope inside of this one.
-    Symbol_Scope & AddScope(const emp::String & name, const emp::String & desc) {
+    Symbol_Scope & AddScope(const emp::String & name, const emp::String & desc,
+                            bool is_builtin = false) {
+      if (is_builtin) return AddBuiltin<Symbol_Scope>(name, desc, this);
       return Add<Symbol_Scope>(name, desc, this);
     }
 
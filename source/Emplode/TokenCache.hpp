@@ -0,0 +1,145 @@
+/**
+ *  @note This file is part of Emplode, currently within https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TokenCache.hpp
+ *  @brief Save and reload the token stream for a config file, keyed by its contents.
+ *  @note Status: ALPHA
+ *
+ *  A batch of runs re-reads the same config file in every run.  With a cache directory set,
+ *  the first run writes the file's tokens into <dir>/<content hash>.tokens and later runs
+ *  load them directly instead of re-running the lexer.  Any edit to the file changes its
+ *  hash, so stale entries are never used (they are simply left behind).
+ *
+ *  Parsing itself cannot be cached: it declares variables and builds modules as it goes,
+ *  and command-line settings (-s) are applied afterward, so they do not affect the key.
+ */
+
+#ifndef EMPLODE_TOKEN_CACHE_HPP
+#define EMPLODE_TOKEN_CACHE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "emp/compiler/Lexer.hpp"
+#include "emp/tools/String.hpp"
+
+namespace emplode {
+
+  class TokenCache {
+  private:
+    static constexpr uint64_t CACHE_VERSION = 2;  ///< Bump if token ids change.
+    static constexpr char MAGIC[8] = {'E','M','P','T','O','K','E','N'};
+
+    emp::String dir;
+
+    static uint64_t HashContents(const std::string & contents) {
+      uint64_t hash = 14695981039346656037ull;         // 64-bit FNV-1a
+      for (unsigned char c : contents) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    template <typename T>
+    static void WriteRaw(std::ostream & os, T value) {
+      os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static bool ReadRaw(std::istream & is, T & value) {
+      return (bool) is.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    emp::String CacheFilename(uint64_t hash) const {
+      std::stringstream ss;
+      ss << std::hex << hash;
+      return emp::MakeString(dir, "/", ss.str(), ".tokens");
+    }
+
+    bool Read(const emp::String & cache_file, uint64_t hash, size_t num_chars,
+              emp::TokenStream & tokens) const {
+      std::ifstream is(cache_file, std::ios::binary);
+      if (!is) return false;
+      char magic[8];
+      uint64_t version = 0, file_hash = 0, file_chars = 0, num_tokens = 0;
+      if (!is.read(magic, 8) || !std::equal(magic, magic+8, MAGIC)) return false;
+      if (!ReadRaw(is, version) || version != CACHE_VERSION) return false;
+      if (!ReadRaw(is, file_hash) || file_hash != hash) return false;
+      if (!ReadRaw(is, file_chars) || file_chars != num_chars) return false;
+      if (!ReadRaw(is, num_tokens)) return false;
+
+      for (uint64_t i = 0; i < num_tokens; ++i) {
+        int32_t id = 0;
+        uint32_t line = 0, length = 0;
+        if (!ReadRaw(is, id) || !ReadRaw(is, line) || !ReadRaw(is, length)) return false;
+        std::string lexeme(length, '\0');
+        if (!is.read(lexeme.data(), length)) return false;
+        tokens.Add(emp::Token(id, lexeme, line));
+      }
+      return true;
+    }
+
+    void Write(const emp::String & cache_file, uint64_t hash, size_t num_chars,
+               const emp::TokenStream & tokens) const {
+      std::filesystem::create_directories(dir.str());
+      // Write to a temporary name and rename, so parallel runs never see a partial file.
+      const emp::String temp_file = emp::MakeString(cache_file, ".", std::random_device{}(), ".tmp");
+      {
+        std::ofstream os(temp_file, std::ios::binary);
+        os.write(MAGIC, 8);
+        WriteRaw<uint64_t>(os, CACHE_VERSION);
+        WriteRaw<uint64_t>(os, hash);
+        WriteRaw<uint64_t>(os, num_chars);
+        WriteRaw<uint64_t>(os, tokens.size());
+        for (size_t i = 0; i < tokens.size(); ++i) {
+          const emp::Token & token = tokens.Get(i);
+          WriteRaw<int32_t>(os, token.id);
+          WriteRaw<uint32_t>(os, (uint32_t) token.line_id);
+          WriteRaw<uint32_t>(os, (uint32_t) token.lexeme.size());
+          os.write(token.lexeme.data(), token.lexeme.size());
+        }
+      }
+      std::error_code ec;
+      std::filesystem::rename(temp_file.str(), cache_file.str(), ec);
+      if (ec) std::filesystem::remove(temp_file.str(), ec);
+    }
+
+  public:
+    TokenCache(const emp::String & _dir="") : dir(_dir) { }
+
+    bool IsActive() const { return dir.size(); }
+    const emp::String & GetDir() const { return dir; }
+    void SetDir(const emp::String & _dir) { dir = _dir; }
+
+    /// Tokenize the contents of 'filename', using (and refreshing) the cache when active.
+    template <typename LEXER_T>
+    emp::TokenStream Tokenize(LEXER_T & lexer, const emp::String & filename) const {
+      std::ifstream file(filename);
+      if (!IsActive()) return lexer.Tokenize(file, filename);
+
+      std::stringstream ss;
+      ss << file.rdbuf();
+      const std::string contents = ss.str();
+      const uint64_t hash = HashContents(contents);
+      const emp::String cache_file = CacheFilename(hash);
+
+      emp::TokenStream tokens(filename);
+      if (Read(cache_file, hash, contents.size(), tokens)) return tokens;
+
+      std::istringstream is(contents);
+      tokens = lexer.Tokenize(is, filename);
+      Write(cache_file, hash, contents.size(), tokens);
+      return tokens;
+    }
+  };
+
+}
+
+#endif
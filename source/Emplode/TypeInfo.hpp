@@ -31,10 +31,12 @@ namespace emplode {
     emp::String desc;
     fun_t fun;
     emp::TypeID return_type;
+    MemberNumberFun number_fun;   ///< Faster form, if the function returns a number.
 
     MemberFunInfo(const emp::String & in_name, const emp::String & in_desc,
-                  fun_t in_fun, emp::TypeID in_rtype)
-      : name(in_name), desc(in_desc), fun(in_fun), return_type(in_rtype) {}
+                  fun_t in_fun, emp::TypeID in_rtype, MemberNumberFun in_number_fun={})
+      : name(in_name), desc(in_desc), fun(in_fun), return_type(in_rtype)
+      , number_fun(std::move(in_number_fun)) {}
   };
 
   // TypeInfo tracks a particular type to be used in the configuration language.
@@ -42,6 +44,8 @@ namespace emplode {
   private:
     using init_fun_t = std::function<emp::Ptr<EmplodeType> (const emp::String &)>;
     using copy_fun_t = std::function<bool (const EmplodeType &, EmplodeType &)>;
+    using move_fun_t = std::function<bool (EmplodeType &, EmplodeType &)>;
+    using release_fun_t = std::function<void (emp::Ptr<EmplodeType>)>;
 
     SymbolTableBase & symbol_table; // Which symbol table are we part of?
 
@@ -52,6 +56,8 @@ namespace emplode {
 
     init_fun_t init_fun;
     copy_fun_t copy_fun;
+    move_fun_t move_fun;       // Optional: take a value (e.g., a function result) without a copy.
+    release_fun_t release_fun; // Optional: dispose of objects (e.g., back to a pool) vs. delete.
     bool config_owned = false; // Should objects of this type be managed by Emplode?
 
     emp::vector< MemberFunInfo > member_funs;
@@ -88,6 +94,18 @@ namespace emplode {
       if (copy_fun) return copy_fun(from, to);
       return false;
     }
+    bool MoveObj(EmplodeType & from, EmplodeType & to) const {
+      if (move_fun) return move_fun(from, to);
+      return CopyObj(from, to);
+    }
+    /// Dispose of an owned object built by MakeObj().
+    void ReleaseObj(emp::Ptr<EmplodeType> obj_ptr) const {
+      if (release_fun) release_fun(obj_ptr);
+      else obj_ptr.Delete();
+    }
+
+    void SetMoveFun(move_fun_t _move) { move_fun = _move; }
+    void SetReleaseFun(release_fun_t _release) { release_fun = _release; }
 
     // Link this TypeInfo object to a real C++ type.
     // @CAO It would be nice to test to make sure this is an EmplodeType, but not possible with a TypeID.
@@ -110,7 +128,8 @@ namespace emplode {
 
       // Add this member function to the library we are building.
       using return_t = typename emp::FunInfo<FUN_T>::return_t;
-      member_funs.emplace_back(name, desc, member_fun, emp::GetTypeID<return_t>());
+      member_funs.emplace_back(name, desc, member_fun, emp::GetTypeID<return_t>(),
+                               symbol_table.WrapMemberNumberFunction(name, fun));
     }
   };
 
@@ -0,0 +1,215 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  AnalyzeInBackground.hpp
+ *  @brief MABE module to summarize a population on a background thread.
+ *
+ *  On updates start, start+interval, ... (and whenever ANALYZE() is called from the config)
+ *  the module captures a PopView of 'target_pop' and hands it to MABE's background thread,
+ *  so the run continues while the analysis is done.  Each analysis writes one row with the
+ *  update, the number of organisms, and for each trait its mean, standard deviation, min,
+ *  max, and number of distinct values (all values of multi-value traits are pooled).  If
+ *  'distances' is on, the row also gets the mean pairwise Euclidean distance between
+ *  organisms over those traits, which takes time quadratic in the population size.
+ *
+ *  Rows are written in update order, since background tasks run one at a time.  If more than
+ *  'max_backlog' analyses are waiting, the run waits for them to catch up.
+ *
+ *  The file and traits are checked during setup, on the main thread; background tasks only
+ *  compute and write rows, and a failed write is reported by the main thread.
+ */
+
+#ifndef MABE_ANALYZE_IN_BACKGROUND_HPP
+#define MABE_ANALYZE_IN_BACKGROUND_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_set>
+
+#include "emp/base/notify.hpp"
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../core/PopView.hpp"
+
+namespace mabe {
+
+  class AnalyzeInBackground : public Module {
+  private:
+    int target_pop_id = 0;               ///< Population to analyze.
+    emp::String trait_names = "";        ///< Comma-separated traits (empty = all numeric).
+    emp::String filename = "background.csv";
+    size_t start = 0;                    ///< First update to analyze on.
+    size_t interval = 0;                 ///< Updates between analyses (0 = only via ANALYZE()).
+    bool distances = false;              ///< Include mean pairwise distance?
+    size_t max_backlog = 4;              ///< Analyses that may wait before the run waits.
+    size_t num_submitted = 0;
+
+    // Set up on the main thread, then only used by background tasks.
+    std::ofstream file;
+    emp::vector<emp::String> columns;    ///< Traits in the file.
+    std::atomic<bool> write_failed{false};   ///< Set by a background task; reported by main.
+    bool reported_failure = false;
+    bool file_ok = false;                ///< Was the file opened during setup?
+
+    /// Traits to analyze in a view.
+    emp::vector<emp::String> GetTraits(const PopView & view) const {
+      emp::String names = trait_names;
+      emp::remove_whitespace(names);
+      if (names.empty()) return view.GetTraitNames();
+      emp::vector<emp::String> out;
+      for (const emp::String & name : names.Slice(",")) {
+        if (name.empty()) continue;
+        if (view.HasTrait(name)) out.push_back(name);
+        else emp::notify::Warning("AnalyzeInBackground '", GetName(), "' has no numeric trait '",
+                                  name, "' to analyze.");
+      }
+      return out;
+    }
+
+    double MeanDistance(const PopView & view) const {
+      const size_t num_orgs = view.GetNumOrgs();
+      if (num_orgs < 2) return 0.0;
+      double total = 0.0;
+      for (size_t org1 = 0; org1 + 1 < num_orgs; ++org1) {
+        for (size_t org2 = org1 + 1; org2 < num_orgs; ++org2) {
+          double dist_sq = 0.0;
+          for (const emp::String & name : columns) {
+            for (size_t i = 0; i < view.GetValueCount(name); ++i) {
+              const double diff = view.GetValue(org1, name, i) - view.GetValue(org2, name, i);
+              dist_sq += diff * diff;
+            }
+          }
+          total += std::sqrt(dist_sq);
+        }
+      }
+      return total / (double) (num_orgs * (num_orgs - 1) / 2);
+    }
+
+    /// Summarize one view and write its row (runs on the background thread).
+    void Analyze(const PopView & view) {
+      if (!file) { write_failed = true; return; }
+      std::string row;
+      emplode::DataFile::AppendInt(row, (int64_t) view.GetUpdate());
+      row += ',';
+      emplode::DataFile::AppendInt(row, (int64_t) view.GetNumOrgs());
+      for (const emp::String & name : columns) {
+        std::span<const double> values = view.GetValues(name);
+        double total = 0.0, total_sq = 0.0;
+        double min_val = std::numeric_limits<double>::infinity();
+        double max_val = -std::numeric_limits<double>::infinity();
+        std::unordered_set<double> distinct;
+        for (double value : values) {
+          total += value;
+          total_sq += value * value;
+          min_val = std::min(min_val, value);
+          max_val = std::max(max_val, value);
+          distinct.insert(value);
+        }
+        const double N = (double) values.size();
+        const double mean = values.size() ? total / N : 0.0;
+        const double var = values.size() ? std::max(total_sq / N - mean * mean, 0.0) : 0.0;
+        for (double stat : {mean, std::sqrt(var), values.size() ? min_val : 0.0,
+                            values.size() ? max_val : 0.0, (double) distinct.size()}) {
+          row += ',';
+          emplode::DataFile::AppendNumber(row, stat);
+        }
+      }
+      if (distances) {
+        row += ',';
+        emplode::DataFile::AppendNumber(row, MeanDistance(view));
+      }
+      row += '\n';
+      file.write(row.data(), (std::streamsize) row.size());
+      if (!file) write_failed = true;
+    }
+
+    /// Report (once, on the main thread) any write that failed in the background.
+    void CheckBackground() {
+      if (!write_failed || reported_failure) return;
+      reported_failure = true;
+      emp::notify::Error("AnalyzeInBackground '", GetName(), "' could not write to '", filename, "'.");
+    }
+
+  public:
+    AnalyzeInBackground(mabe::MABE & control,
+                        const emp::String & name="AnalyzeInBackground",
+                        const emp::String & desc="Module to summarize a population on a background thread.")
+      : Module(control, name, desc)
+    {
+      SetAnalyzeMod(true);
+    }
+    ~AnalyzeInBackground() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("ANALYZE",
+        [](AnalyzeInBackground & mod) { return mod.Submit(); },
+        "Capture the target population now and analyze it in the background; returns analyses pending.");
+      info.AddMemberFunction("NUM_ANALYSES",
+        [](AnalyzeInBackground & mod) { return mod.num_submitted; },
+        "Number of analyses started so far.");
+    }
+
+    void SetupConfig() override {
+      LinkPop(target_pop_id, "target_pop", "Population to analyze.");
+      LinkVar(trait_names, "traits", "Comma-separated list of numeric traits (empty for all of them).");
+      LinkVar(filename, "filename", "File to write a row to for each analysis.");
+      LinkVar(start, "start", "First update to analyze the population on.");
+      LinkVar(interval, "interval", "Updates between analyses (0 = only when ANALYZE() is called).");
+      LinkVar(distances, "distances", "Include the mean pairwise distance between organisms? (slow for large populations)");
+      LinkVar(max_backlog, "max_backlog", "Analyses that may be waiting before the run waits for them (0 = no limit).");
+    }
+
+    void SetupModule() override {
+      file.open(filename);
+      file_ok = (bool) file;
+      if (!file_ok) {
+        emp::notify::Error("AnalyzeInBackground '", GetName(), "' could not open '", filename, "'.");
+      }
+    }
+
+    /// Traits are only all known once data maps are locked; pick the columns and write the
+    /// header.
+    void SetupDataMap(emp::DataMap &) override {
+      if (!file_ok) return;
+      columns = GetTraits(*control.ViewPopulation(control.GetPopulation(target_pop_id)));
+      file << "update,num_orgs";
+      for (const emp::String & name : columns) {
+        for (const char * stat : {"_mean", "_sd", "_min", "_max", "_distinct"}) file << ',' << name << stat;
+      }
+      if (distances) file << ",mean_distance";
+      file << '\n';
+    }
+
+    /// Capture the population and queue its analysis; returns the number of tasks pending.
+    size_t Submit() {
+      CheckBackground();
+      if (!file_ok) return 0;     // Already reported during setup.
+      PopView::view_ptr_t view = control.ViewPopulation(control.GetPopulation(target_pop_id));
+      if (max_backlog) control.WaitForBackground(max_backlog - 1);
+      control.RunInBackground([this, view](){ Analyze(*view); });
+      ++num_submitted;
+      return control.GetNumBackgroundTasks();
+    }
+
+    void OnUpdate(size_t update) override {
+      if (interval && update >= start && (update - start) % interval == 0) Submit();
+    }
+
+    void BeforeExit() override {
+      control.WaitForBackground();
+      if (file_ok) file.flush();
+      CheckBackground();
+    }
+  };
+
+  MABE_REGISTER_MODULE(AnalyzeInBackground, "Summarize a population on a background thread.");
+}
+
+#endif
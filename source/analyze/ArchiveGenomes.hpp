@@ -0,0 +1,128 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  ArchiveGenomes.hpp
+ *  @brief MABE module to store each distinct genome once, as a delta from its parent's genome.
+ *
+ *  Every injected or newborn organism gets a 'genome_id' trait.  A genome that has been seen
+ *  before (matched by Organism::GetGenomeHash()) reuses its existing ID; a new genome is
+ *  appended to 'filename' as a compact binary delta from its parent's genome (see
+ *  tools/GenomeArchive.hpp for the format), so point mutations and small insertions or
+ *  deletions cost a few bytes rather than a full genome.
+ *
+ *  Outputs can then record the ID in place of the genome, e.g. in a DataFile:
+ *
+ *    max_file.ADD_COLUMN( "Genome ID", "best_org.TRAIT('genome_id')" );
+ *
+ *  or as the taxon trait of AnalyzeSystematics (taxon_trait = "genome_id"), and genomes are
+ *  recovered from the archive with GenomeArchiveReader.
+ *
+ *  Genomes are written as each organism's ToString(), which is only built for new genomes.
+ */
+
+#ifndef MABE_ARCHIVE_GENOMES_HPP
+#define MABE_ARCHIVE_GENOMES_HPP
+
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../tools/GenomeArchive.hpp"
+
+namespace mabe {
+
+  class ArchiveGenomes : public Module {
+  private:
+    emp::String filename = "genomes.mga";   ///< File to write the archive to.
+
+    OwnedTrait<size_t> genome_id{this, "genome_id", "Archive ID of this organism's genome"};
+
+    std::ofstream file;
+    std::unique_ptr<GenomeArchiveWriter> writer;
+    std::unordered_map<uint64_t, size_t> id_by_fingerprint;
+
+    /// Find or add the ID for an organism's genome, delta-encoded against its parent.
+    void Archive(Organism & org, emp::Ptr<Organism> parent) {
+      emp_assert(writer);
+      const uint64_t hash = org.GetGenomeHash();
+      size_t parent_id = GenomeArchive::NO_PARENT;
+      if (parent && genome_id(*parent) != GenomeArchive::NO_PARENT) {
+        parent_id = genome_id(*parent);
+        if (hash == parent->GetGenomeHash()) { genome_id(org) = parent_id; return; }  // Unmutated.
+      }
+
+      auto [it, is_new] = id_by_fingerprint.try_emplace(hash, 0);
+      if (is_new) {
+        const std::string genome = org.ToString().str();
+        std::string parent_genome;
+        if (parent_id != GenomeArchive::NO_PARENT) parent_genome = parent->ToString().str();
+        it->second = writer->Add(genome, parent_id, &parent_genome);
+      }
+      genome_id(org) = it->second;
+    }
+
+  public:
+    ArchiveGenomes(mabe::MABE & control,
+                   const emp::String & name="ArchiveGenomes",
+                   const emp::String & desc="Module to archive each distinct genome once, as a delta from its parent.")
+      : Module(control, name, desc)
+    {
+      SetAnalyzeMod(true);
+      SetConcurrentUpdate(true);  // Update steps only use this module's own data and file.
+    }
+    ~ArchiveGenomes() { }
+
+    /// Approximate bytes held by the fingerprint table (node and bucket overhead included).
+    size_t GetNumBytes() const override {
+      return id_by_fingerprint.size() * (sizeof(uint64_t) + sizeof(size_t) + 2 * sizeof(void *))
+           + id_by_fingerprint.bucket_count() * sizeof(void *);
+    }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("NUM_GENOMES",
+        [](ArchiveGenomes & mod) { return mod.writer ? mod.writer->GetNumGenomes() : 0; },
+        "Number of distinct genomes archived so far.");
+      info.AddMemberFunction("NUM_BYTES",
+        [](ArchiveGenomes & mod) { return mod.writer ? mod.writer->GetNumBytes() : 0; },
+        "Number of bytes written to the archive so far.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(filename, "filename", "File to write archived genomes to.");
+      genome_id.SetDefault(GenomeArchive::NO_PARENT);
+    }
+
+    void SetupModule() override {
+      file.open(filename, std::ios::binary);
+      if (!file) {
+        emp::notify::Error("Module '", GetName(), "' could not open genome archive '", filename, "'.");
+      }
+      writer = std::make_unique<GenomeArchiveWriter>(file);
+    }
+
+    void OnInjectReady(Organism & org, Population &) override {
+      Archive(org, nullptr);
+    }
+
+    void OnOffspringReady(Organism & offspring, OrgPosition ppos, Population &) override {
+      emp::Ptr<Organism> parent = nullptr;
+      if (ppos.IsOccupied()) parent = ppos.OrgPtr();
+      Archive(offspring, parent);
+    }
+
+    void OnUpdate(size_t) override { writer->Flush(); }
+
+    void BeforeExit() override {
+      writer->Flush();
+      file.close();
+    }
+  };
+
+  MABE_REGISTER_MODULE(ArchiveGenomes, "Archive each distinct genome once, as a delta from its parent genome.");
+}
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  CompactPopulation.hpp
+ *  @brief MABE module to periodically lay out a population's organism storage in order.
+ *
+ *  After many generations, the DataMaps and genomes of a population's organisms are spread
+ *  across the heap in birth order, so a scan by an evaluator or selector misses the cache for
+ *  nearly every organism.  On updates start, start+interval, ... (and, if 'on_replace' is set,
+ *  whenever the population's contents are swapped in, as with REPLACE_WITH), this module calls
+ *  Population::Compact() to move each organism's storage into fresh allocations in position
+ *  order.  Organisms keep their addresses and positions, so other modules are unaffected.
+ *
+ *  Compacting copies every living organism's storage, so it is best run every few hundred
+ *  updates or once per generation rather than every update.
+ */
+
+#ifndef MABE_COMPACT_POPULATION_HPP
+#define MABE_COMPACT_POPULATION_HPP
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+namespace mabe {
+
+  class CompactPopulation : public Module {
+  private:
+    int target_pop_id = 0;               ///< Population to compact.
+    size_t start = 0;                    ///< First update to compact on.
+    size_t interval = 500;               ///< Updates between compactions (0 = none on a timer).
+    bool on_replace = false;             ///< Also compact when the population is swapped in?
+    size_t num_compactions = 0;
+
+  public:
+    CompactPopulation(mabe::MABE & control,
+                      const emp::String & name="CompactPopulation",
+                      const emp::String & desc="Module to lay out a population's organism storage in order.")
+      : Module(control, name, desc)
+    {
+      SetAnalyzeMod(true);
+    }
+    ~CompactPopulation() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("COMPACT",
+        [](CompactPopulation & mod) { mod.Compact(); return mod.num_compactions; },
+        "Lay out the target population's storage in order now; returns compactions so far.");
+      info.AddMemberFunction("NUM_COMPACTIONS",
+        [](CompactPopulation & mod) { return mod.num_compactions; },
+        "Number of times the target population has been compacted.");
+    }
+
+    void SetupConfig() override {
+      LinkPop(target_pop_id, "target_pop", "Population to compact.");
+      LinkVar(start, "start", "First update to compact the population on.");
+      LinkVar(interval, "interval", "Updates between compactions (0 = only when COMPACT() is called).");
+      LinkVar(on_replace, "on_replace", "Also compact whenever the population's contents are swapped in (e.g., REPLACE_WITH)?");
+    }
+
+    void Compact() {
+      control.GetPopulation(target_pop_id).Compact();
+      ++num_compactions;
+    }
+
+    void OnUpdate(size_t update) override {
+      if (interval && update >= start && (update - start) % interval == 0) Compact();
+    }
+
+    void OnPopSwap(Population & pop1, Population & pop2) override {
+      if (!on_replace) return;
+      if (pop1.GetID() == target_pop_id || pop2.GetID() == target_pop_id) Compact();
+    }
+  };
+
+  MABE_REGISTER_MODULE(CompactPopulation, "Lay out a population's organism storage in order.");
+}
+
+#endif
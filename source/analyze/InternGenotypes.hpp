@@ -0,0 +1,103 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  InternGenotypes.hpp
+ *  @brief MABE module to keep one stored genome per genotype in clone-heavy populations.
+ *
+ *  Each organism placed in 'target_pop' is looked up by Organism::GetGenomeHash() in a table
+ *  of genotypes.  If a living organism with the same genotype is already listed, the newcomer
+ *  switches to sharing that organism's genome storage (Organism::ShareGenome(); currently
+ *  BitsOrg), so a population with dozens of genotypes among thousands of organisms holds only
+ *  dozens of genomes.  Offspring that arise independently with the same genome (e.g., by
+ *  back mutation, or in other lineages) are merged as well, which copy-on-write alone misses.
+ *
+ *  A genotype's entry lasts as long as the organism it lists; when that organism dies, the
+ *  next organism placed with the genotype takes its place.  Swapping populations (as with
+ *  REPLACE_WITH in generational configs) rebuilds the table from the new target contents.
+ *
+ *  To skip re-evaluating repeated genotypes, combine this module with an evaluator's
+ *  memo_size option, which keeps results per genome fingerprint.
+ */
+
+#ifndef MABE_INTERN_GENOTYPES_HPP
+#define MABE_INTERN_GENOTYPES_HPP
+
+#include <unordered_map>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+namespace mabe {
+
+  class InternGenotypes : public Module {
+  private:
+    int target_pop_id = 0;                   ///< Population whose genotypes are interned.
+
+    std::unordered_map<uint64_t, emp::Ptr<Organism>> genotypes;  ///< Listed org per genome hash.
+    std::unordered_map<const Organism *, uint64_t> listed;        ///< Hash of each listed org.
+    size_t num_shared = 0;                   ///< Placements that switched to a listed genome.
+
+    void Intern(emp::Ptr<Organism> org_ptr) {
+      const uint64_t hash = org_ptr->GetGenomeHash();
+      auto [it, is_new] = genotypes.try_emplace(hash, org_ptr);
+      if (is_new) listed[org_ptr.Raw()] = hash;
+      else if (it->second != org_ptr && org_ptr->ShareGenome(*it->second)) ++num_shared;
+    }
+
+  public:
+    InternGenotypes(mabe::MABE & control,
+                    const emp::String & name="InternGenotypes",
+                    const emp::String & desc="Module to share one stored genome among organisms of each genotype.")
+      : Module(control, name, desc)
+    { SetAnalyzeMod(true); }
+    ~InternGenotypes() { }
+
+    /// Approximate bytes held by the genotype tables (node and bucket overhead included).
+    size_t GetNumBytes() const override {
+      return (genotypes.size() + listed.size()) * (2 * sizeof(uint64_t) + 2 * sizeof(void *))
+           + (genotypes.bucket_count() + listed.bucket_count()) * sizeof(void *);
+    }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("NUM_GENOTYPES",
+        [](InternGenotypes & mod) { return mod.genotypes.size(); },
+        "Number of genotypes currently listed.");
+      info.AddMemberFunction("NUM_SHARED",
+        [](InternGenotypes & mod) { return mod.num_shared; },
+        "Number of placed organisms that switched to sharing a listed genome.");
+    }
+
+    void SetupConfig() override {
+      LinkPop(target_pop_id, "target_pop", "Population whose genotypes should be interned.");
+    }
+
+    void OnPlacement(OrgPosition pos) override {
+      if (pos.PopID() == target_pop_id) Intern(pos.OrgPtr());
+    }
+
+    void BeforeDeath(OrgPosition pos) override {
+      // Listed organisms may have moved to other populations, so check every death.
+      auto it = listed.find(pos.OrgPtr().Raw());
+      if (it == listed.end()) return;
+      genotypes.erase(it->second);
+      listed.erase(it);
+    }
+
+    void OnPopSwap(Population & pop1, Population & pop2) override {
+      // The target population has new contents; rebuild the table from them.
+      if (pop1.GetID() != target_pop_id && pop2.GetID() != target_pop_id) return;
+      genotypes.clear();
+      listed.clear();
+      Population & pop = control.GetPopulation(target_pop_id);
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        if (pop.IsOccupied(pos)) Intern(&pop[pos]);
+      }
+    }
+  };
+
+  MABE_REGISTER_MODULE(InternGenotypes, "Share one stored genome among all organisms of each genotype.");
+}
+
+#endif
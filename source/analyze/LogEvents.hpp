@@ -0,0 +1,79 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  LogEvents.hpp
+ *  @brief MABE module to log every birth, death, and move to a compact binary file.
+ *
+ *  Each placement, death, and swap of organisms is written as a small record (see
+ *  tools/EventLog.hpp), and encoding and writing happen on a background thread.  After the
+ *  run, EventReplay (or build/replay_events.py) rebuilds the full phylogeny from the log, so
+ *  lineages can be studied without running AnalyzeSystematics during the simulation.
+ *
+ *  When used with ArchiveGenomes (genome_trait = "genome_id"), each new organism's record
+ *  also holds its genome's archive ID, so the genomes along any lineage can be recovered
+ *  (and re-evaluated) from the genome archive.
+ */
+
+#ifndef MABE_LOG_EVENTS_HPP
+#define MABE_LOG_EVENTS_HPP
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../tools/EventLog.hpp"
+
+namespace mabe {
+
+  class LogEvents : public Module {
+  private:
+    emp::String filename = "events.mel";   ///< File to write the event log to.
+    emp::String genome_trait = "";         ///< Trait with each organism's genome ID ("" = none).
+    size_t block_size = 4096;              ///< Events encoded and written together.
+
+    EventLogWriter writer;
+
+  public:
+    LogEvents(mabe::MABE & control,
+              const emp::String & name="LogEvents",
+              const emp::String & desc="Module to log every birth, death, and move for replay after a run.")
+      : Module(control, name, desc)
+    { SetAnalyzeMod(true); }
+    ~LogEvents() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("NUM_EVENTS",
+        [](LogEvents & mod) { return mod.writer.GetNumEvents(); },
+        "Number of events logged so far.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(filename, "filename", "File to write the event log to.");
+      LinkVar(genome_trait, "genome_trait",
+              "Trait holding each organism's genome ID, e.g. from ArchiveGenomes (\"\" = none).");
+      LinkVar(block_size, "block_size", "Number of events to encode and write at once.");
+    }
+
+    void SetupModule() override {
+      if (genome_trait.size()) AddRequiredTrait<size_t>(genome_trait);
+      if (!writer.Open(filename, block_size)) {
+        emp::notify::Error("Module '", GetName(), "' could not open event log '", filename, "'.");
+      }
+      control.AddForkFun([this](){ writer.Pause(); });
+    }
+
+    void SetupDataMap(emp::DataMap & dmap) override {
+      if (!writer.IsOpen()) return;
+      control.SetEventLog(&writer, genome_trait.size() ? dmap.GetID(genome_trait) : emp::MAX_SIZE_T);
+    }
+
+    void BeforeExit() override {
+      control.SetEventLog(nullptr);
+      writer.Close();
+    }
+  };
+
+  MABE_REGISTER_MODULE(LogEvents, "Log every birth, death, and move to a compact binary file.");
+}
+
+#endif
@@ -0,0 +1,422 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  PopulationDump.hpp
+ *  @brief MABE module to write selected traits of every organism in a population.
+ *
+ *  Each dump writes one row per living organism in 'target_pop': the update, the organism's
+ *  position, and the listed traits.  Dumps happen on updates start, start+interval, ... (with
+ *  interval > 0), and whenever the DUMP() function is called from the config.
+ *
+ *  Trait values are read directly out of each organism's DataMap by their DataLayout IDs,
+ *  which are looked up once at the first dump.  Supported trait types are double, int,
+ *  size_t, and bool (including multi-value traits, which become one column per value),
+ *  emp::String, and emp::vector<double> (written as a quoted, space-separated list).
+ *
+ *  With format = "csv" each dump is formatted into one buffer and written at once; the file
+ *  is flushed at the end of the run.  With format = "binary" each dump is one row group in the
+ *  same typed-column format as a binary DataFile (see emplode::DataFile; numeric traits are
+ *  stored as doubles), so it can be read with build/read_binary.py.
+ *
+ *  With differential = 1, only the first dump (and every 'keyframe_interval'-th after it) is
+ *  a full keyframe; other dumps only have rows for positions that changed since the previous
+ *  dump.  A "change" column follows the position: 0 = keyframe row, 1 = a new organism was
+ *  placed there, 2 = the same organism with changed trait values, 3 = the organism there was
+ *  removed (its trait fields are empty, or NaN in binary).  New organisms are found from
+ *  placement and swap signals (a per-position dirty bitset); changed values by comparing each
+ *  organism's values to those last written.  Resizing or swapping the population forces the
+ *  next dump to be a keyframe.  build/read_dump.py rebuilds the population at any dump.
+ */
+
+#ifndef MABE_POPULATION_DUMP_HPP
+#define MABE_POPULATION_DUMP_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+#include "emp/base/notify.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/data/DataMap.hpp"
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+namespace mabe {
+
+  class PopulationDump : public Module {
+  private:
+    enum class Kind { DOUBLE, INT, SIZE_T, BOOL, STRING, VECTOR };
+    enum class Change { KEYFRAME=0, PLACED, CHANGED, REMOVED };
+
+    struct Column {
+      emp::String header;
+      size_t trait_id;       ///< ID of the trait in the population's DataLayout.
+      size_t count;          ///< Number of values the trait holds.
+      size_t index;          ///< Which of those values this column is.
+      Kind kind;
+      bool IsNumeric() const { return kind != Kind::STRING && kind != Kind::VECTOR; }
+    };
+
+    int target_pop_id = 0;               ///< Population to dump.
+    emp::String trait_names = "";        ///< Comma-separated traits to include.
+    emp::String filename = "population.csv";
+    emp::String format = "csv";          ///< "csv" or "binary"
+    size_t start = 0;                    ///< First update to dump on.
+    size_t interval = 0;                 ///< Updates between dumps (0 = only via DUMP()).
+    bool differential = false;           ///< Write only changed positions between keyframes?
+    size_t keyframe_interval = 0;        ///< Dumps per keyframe (0 = only the first).
+
+    emp::vector<Column> columns;         ///< Trait columns (after update and position).
+    bool is_binary = false;
+    bool is_ready = false;               ///< Have the columns and file been set up?
+    std::ofstream file;
+    std::string buffer;                  ///< Reused output buffer for one dump.
+    size_t num_dumps = 0;
+
+    // Differential dumps.
+    emp::BitVector dirty;                ///< Positions with a new organism since the last dump.
+    emp::BitVector written;              ///< Positions holding an organism as of the last dump.
+    emp::vector<std::string> last_values;  ///< Raw trait values written for each position.
+    std::string scratch_values;
+    bool force_keyframe = false;
+
+    // Binary row group being collected.
+    emp::vector<emp::vector<double>> bin_values;  ///< Numeric values, per column.
+    emp::vector<std::string> bin_chars;           ///< Concatenated strings, per column.
+    emp::vector<emp::vector<uint64_t>> bin_ends;  ///< End offsets of strings, per column.
+
+    template <typename T>
+    static void AppendRaw(std::string & out, const T & value) {
+      out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /// Report an error and return false.
+    template <typename... Ts>
+    bool Fail(Ts &&... args) {
+      emp::notify::Error("PopulationDump '", GetName(), "' ", std::forward<Ts>(args)...);
+      return false;
+    }
+
+    /// Look up a trait in the layout and add its column(s).
+    bool AddTraitColumns(const emp::DataLayout & layout, const emp::String & name) {
+      if (!layout.HasName(name)) return Fail("cannot find trait '", name, "'.");
+      const size_t id = layout.GetID(name);
+      const size_t count = layout.GetCount(id);
+      Kind kind;
+      if (layout.IsType<double>(id)) kind = Kind::DOUBLE;
+      else if (layout.IsType<int>(id)) kind = Kind::INT;
+      else if (layout.IsType<size_t>(id)) kind = Kind::SIZE_T;
+      else if (layout.IsType<bool>(id)) kind = Kind::BOOL;
+      else if (layout.IsType<emp::String>(id) && count == 1) kind = Kind::STRING;
+      else if (layout.IsType<emp::vector<double>>(id) && count == 1) kind = Kind::VECTOR;
+      else return Fail("cannot write trait '", name, "'; its type is not supported.");
+
+      if (count == 1) columns.push_back(Column{name, id, 1, 0, kind});
+      else for (size_t i = 0; i < count; ++i) {
+        columns.push_back(Column{name + "[" + emp::String(std::to_string(i)) + "]", id, count, i, kind});
+      }
+      return true;
+    }
+
+    /// Set up columns from the population's layout and open the file (done at the first dump).
+    bool Setup(Population & pop) {
+      if (format != "csv" && format != "binary") {
+        return Fail("has unknown format '", format, "'; options are \"csv\" or \"binary\".");
+      }
+      is_binary = (format == "binary");
+      if (!pop.HasDataLayout()) return false;   // No organisms yet; try again next time.
+      const emp::DataLayout & layout = pop.GetDataLayout();
+      columns.resize(0);
+      emp::String names = trait_names;
+      emp::remove_whitespace(names);
+      for (const emp::String & name : names.Slice(",")) {
+        if (name.size() && !AddTraitColumns(layout, name)) return false;
+      }
+
+      file.open(filename, is_binary ? std::ios::binary : std::ios::out);
+      if (!file) return Fail("could not open '", filename, "'.");
+
+      // Headers.
+      buffer.clear();
+      if (is_binary) {
+        buffer.append("MABECOL1");
+        AppendRaw<uint32_t>(buffer, (uint32_t) columns.size() + 2);
+        auto add_header = [this](const std::string & header, bool is_numeric){
+          AppendRaw<uint32_t>(buffer, (uint32_t) header.size());
+          buffer.append(header);
+          AppendRaw<uint8_t>(buffer, is_numeric ? 0 : 1);
+        };
+        add_header("update", true);
+        add_header("position", true);
+        if (differential) add_header("change", true);
+        for (const Column & col : columns) add_header(col.header.str(), col.IsNumeric());
+        bin_values.resize(columns.size());
+        bin_chars.resize(columns.size());
+        bin_ends.resize(columns.size());
+      }
+      else {
+        buffer.append(differential ? "update,position,change" : "update,position");
+        for (const Column & col : columns) (buffer += ',') += col.header.str();
+        buffer += '\n';
+      }
+      file.write(buffer.data(), (std::streamsize) buffer.size());
+      is_ready = true;
+      force_keyframe = true;
+      return true;
+    }
+
+    template <typename T>
+    static T GetValue(const emp::DataMap & dmap, const Column & col) {
+      if (col.count == 1) return dmap.Get<T>(col.trait_id);
+      return dmap.Get<T>(col.trait_id, col.count)[col.index];
+    }
+
+    /// Read a numeric value straight out of a DataMap.
+    static double GetNumber(const emp::DataMap & dmap, const Column & col) {
+      switch (col.kind) {
+        case Kind::DOUBLE: return GetValue<double>(dmap, col);
+        case Kind::INT:    return GetValue<int>(dmap, col);
+        case Kind::SIZE_T: return (double) GetValue<size_t>(dmap, col);
+        case Kind::BOOL:   return GetValue<bool>(dmap, col);
+        default: return 0.0;
+      }
+    }
+
+    /// Append a vector trait as space-separated values.
+    static void AppendList(std::string & out, const emp::DataMap & dmap, const Column & col) {
+      const emp::vector<double> & values = dmap.Get<emp::vector<double>>(col.trait_id);
+      for (size_t i = 0; i < values.size(); ++i) {
+        if (i) out += ' ';
+        emplode::DataFile::AppendNumber(out, values[i]);
+      }
+    }
+
+    /// Append a value's text form, as written in csv output.
+    static void AppendText(std::string & out, const emp::DataMap & dmap, const Column & col) {
+      switch (col.kind) {
+        case Kind::DOUBLE:
+          emplode::DataFile::AppendNumber(out, GetNumber(dmap, col));
+          break;
+        case Kind::STRING:
+          out += emp::MakeLiteral(dmap.Get<emp::String>(col.trait_id)).str();
+          break;
+        case Kind::VECTOR:
+          out += '"';
+          AppendList(out, dmap, col);
+          out += '"';
+          break;
+        case Kind::INT:
+          emplode::DataFile::AppendInt(out, GetValue<int>(dmap, col));
+          break;
+        case Kind::SIZE_T:
+          emplode::DataFile::AppendInt(out, (int64_t) GetValue<size_t>(dmap, col));
+          break;
+        case Kind::BOOL:
+          emplode::DataFile::AppendInt(out, GetValue<bool>(dmap, col));
+      }
+    }
+
+    /// All of the values an organism would write, as raw bytes (to detect changes).
+    void GetRawValues(const emp::DataMap & dmap, std::string & out) const {
+      out.clear();
+      for (const Column & col : columns) {
+        if (col.IsNumeric()) AppendRaw<double>(out, GetNumber(dmap, col));
+        else {
+          if (col.kind == Kind::STRING) out += dmap.Get<emp::String>(col.trait_id).str();
+          else AppendList(out, dmap, col);
+          out += '\0';
+        }
+      }
+    }
+
+    /// Call fun(pos, change, dmap_ptr) for each row of this dump, in position order; dmap_ptr
+    /// is nullptr for removed organisms.  Returns the number of rows.
+    template <typename FUN_T>
+    size_t ForEachRow(Population & pop, FUN_T && fun) {
+      size_t num_rows = 0;
+      if (!differential) {
+        for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+          if (!pop.IsOccupied(pos)) continue;
+          fun(pos, Change::KEYFRAME, &pop[pos].GetDataMap());
+          ++num_rows;
+        }
+        return num_rows;
+      }
+
+      const bool keyframe = force_keyframe || (keyframe_interval && num_dumps % keyframe_interval == 0);
+      const size_t num_pos = std::max(pop.GetSize(), last_values.size());
+      last_values.resize(num_pos);
+      written.Resize(num_pos);
+      dirty.Resize(num_pos);
+      for (size_t pos = 0; pos < num_pos; ++pos) {
+        if (pop.IsOccupied(pos)) {
+          const emp::DataMap & dmap = pop[pos].GetDataMap();
+          GetRawValues(dmap, scratch_values);
+          Change change = Change::KEYFRAME;
+          if (!keyframe) {
+            if (dirty.Has(pos) || !written.Has(pos)) change = Change::PLACED;
+            else if (scratch_values != last_values[pos]) change = Change::CHANGED;
+            else continue;                              // Unchanged; no row.
+          }
+          fun(pos, change, &dmap);
+          ++num_rows;
+          std::swap(last_values[pos], scratch_values);
+          written.Set(pos);
+        }
+        else if (written.Has(pos)) {
+          if (!keyframe) { fun(pos, Change::REMOVED, nullptr); ++num_rows; }
+          written.Set(pos, false);
+          last_values[pos].clear();
+        }
+      }
+      last_values.resize(pop.GetSize());
+      written.Resize(pop.GetSize());
+      dirty.Resize(pop.GetSize());
+      dirty.Clear();
+      force_keyframe = false;
+      return num_rows;
+    }
+
+    void MarkDirty(OrgPosition pos) {
+      if (pos.PopID() != target_pop_id) return;
+      if (pos.Pos() >= dirty.GetSize()) dirty.Resize(pos.Pos() + 1);
+      dirty.Set(pos.Pos());
+    }
+
+    size_t DumpCSV(Population & pop, size_t update) {
+      return ForEachRow(pop, [this, update](size_t pos, Change change, const emp::DataMap * dmap) {
+        emplode::DataFile::AppendInt(buffer, (int64_t) update);
+        buffer += ',';
+        emplode::DataFile::AppendInt(buffer, (int64_t) pos);
+        if (differential) {
+          buffer += ',';
+          emplode::DataFile::AppendInt(buffer, (int64_t) change);
+        }
+        for (const Column & col : columns) {
+          buffer += ',';
+          if (dmap) AppendText(buffer, *dmap, col);
+        }
+        buffer += '\n';
+      });
+    }
+
+    size_t DumpBinary(Population & pop, size_t update) {
+      std::string positions, changes;
+      const uint64_t num_rows = ForEachRow(pop,
+        [this, &positions, &changes](size_t pos, Change change, const emp::DataMap * dmap) {
+          AppendRaw<double>(positions, (double) pos);
+          AppendRaw<double>(changes, (double) change);
+          for (size_t i = 0; i < columns.size(); ++i) {
+            const Column & col = columns[i];
+            if (col.IsNumeric()) bin_values[i].push_back(dmap ? GetNumber(*dmap, col) : std::nan(""));
+            else {                                      // Removed organisms get empty strings.
+              if (dmap && col.kind == Kind::STRING) bin_chars[i] += dmap->Get<emp::String>(col.trait_id).str();
+              else if (dmap) AppendList(bin_chars[i], *dmap, col);
+              bin_ends[i].push_back(bin_chars[i].size());
+            }
+          }
+        });
+
+      AppendRaw<uint64_t>(buffer, num_rows);
+      for (uint64_t row = 0; row < num_rows; ++row) AppendRaw<double>(buffer, (double) update);
+      buffer += positions;
+      if (differential) buffer += changes;
+      for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].IsNumeric()) {
+          buffer.append(reinterpret_cast<const char *>(bin_values[i].data()),
+                        bin_values[i].size() * sizeof(double));
+          bin_values[i].resize(0);
+        }
+        else {
+          buffer.append(reinterpret_cast<const char *>(bin_ends[i].data()),
+                        bin_ends[i].size() * sizeof(uint64_t));
+          buffer += bin_chars[i];
+          bin_ends[i].resize(0);
+          bin_chars[i].clear();
+        }
+      }
+      return num_rows;
+    }
+
+  public:
+    PopulationDump(mabe::MABE & control,
+                   const emp::String & name="PopulationDump",
+                   const emp::String & desc="Module to write selected traits of every organism in a population.")
+      : Module(control, name, desc)
+    {
+      SetAnalyzeMod(true);
+      SetConcurrentUpdate(true);  // Update steps only use this module's own data and file.
+    }
+    ~PopulationDump() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("DUMP",
+        [](PopulationDump & mod) { return mod.Dump(); },
+        "Write a row for every organism in the target population now; returns rows written.");
+      info.AddMemberFunction("NUM_DUMPS",
+        [](PopulationDump & mod) { return mod.num_dumps; },
+        "Number of dumps written so far.");
+    }
+
+    void SetupConfig() override {
+      LinkPop(target_pop_id, "target_pop", "Population to write out.");
+      LinkVar(trait_names, "traits", "Comma-separated list of traits to write for each organism.");
+      LinkVar(filename, "filename", "File to write to.");
+      LinkVar(format, "format", "Output format: \"csv\" (text) or \"binary\" (typed columns).");
+      LinkVar(start, "start", "First update to write the population on.");
+      LinkVar(interval, "interval", "Updates between writes (0 = only when DUMP() is called).");
+      LinkVar(differential, "differential", "After the first dump, write only positions that changed since the previous one?");
+      LinkVar(keyframe_interval, "keyframe_interval", "With differential, write a full dump every this many dumps (0 = only the first).");
+    }
+
+    /// Write one row per living organism (or, with differential, per changed position);
+    /// returns the number of rows written.
+    size_t Dump() {
+      Population & pop = control.GetPopulation(target_pop_id);
+      if (!is_ready && !Setup(pop)) return 0;
+      buffer.clear();
+      const size_t update = control.GetUpdate();
+      const size_t num_rows = is_binary ? DumpBinary(pop, update) : DumpCSV(pop, update);
+      file.write(buffer.data(), (std::streamsize) buffer.size());
+      ++num_dumps;
+      return num_rows;
+    }
+
+    void OnUpdate(size_t update) override {
+      if (interval && update >= start && (update - start) % interval == 0) Dump();
+    }
+
+    void OnPlacement(OrgPosition pos) override {
+      if (!differential) { Module::OnPlacement(pos); return; }
+      MarkDirty(pos);
+    }
+
+    void OnSwap(OrgPosition pos1, OrgPosition pos2) override {
+      if (!differential) { Module::OnSwap(pos1, pos2); return; }
+      MarkDirty(pos1);
+      MarkDirty(pos2);
+    }
+
+    void OnPopResize(Population & pop, size_t old_size) override {
+      if (!differential) { Module::OnPopResize(pop, old_size); return; }
+      if (pop.GetID() == target_pop_id) force_keyframe = true;
+    }
+
+    void OnPopSwap(Population & pop1, Population & pop2) override {
+      if (!differential) { Module::OnPopSwap(pop1, pop2); return; }
+      if (pop1.GetID() == target_pop_id || pop2.GetID() == target_pop_id) force_keyframe = true;
+    }
+
+    void BeforeExit() override {
+      if (file.is_open()) file.flush();
+    }
+  };
+
+  MABE_REGISTER_MODULE(PopulationDump, "Write selected traits of every organism in a population.");
+}
+
+#endif
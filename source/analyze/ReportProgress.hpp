@@ -0,0 +1,155 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  ReportProgress.hpp
+ *  @brief MABE module to print a rate-limited status line and write a heartbeat file.
+ *
+ *  At most once every 'interval' seconds, this module rewrites a single status line on
+ *  stderr and (if heartbeat_file is set) replaces a small "key value" file with the current
+ *  update, updates per second, ETA, resident memory, and number of living organisms.
+ *
+ *  There is no general way to know when a config will call EXIT(), so the ETA uses the
+ *  'max_update' setting (0 = no ETA); set it to the update bound the config exits on.
+ *
+ *  Between reports the only work done is one integer comparison per update: after each report
+ *  the module estimates how many updates will pass before the next interval is up, and only
+ *  reads the clock again once that many have gone by.
+ */
+
+#ifndef MABE_REPORT_PROGRESS_HPP
+#define MABE_REPORT_PROGRESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+namespace mabe {
+
+  class ReportProgress : public Module {
+  private:
+    using clock_t = std::chrono::steady_clock;
+
+    double interval = 5.0;           ///< Seconds between reports.
+    size_t max_update = 0;           ///< Update the run is expected to end on (0 = unknown).
+    emp::String heartbeat_file = ""; ///< File to replace with current status (empty = none).
+    bool print_status = true;        ///< Print a status line to stderr?
+
+    clock_t::time_point start_time;
+    clock_t::time_point last_time;
+    size_t start_update = 0;
+    size_t last_update = 0;
+    size_t next_check = 0;           ///< Next update on which to look at the clock.
+    bool line_open = false;          ///< Is a status line waiting to be ended with a newline?
+
+    static double Seconds(clock_t::duration duration) {
+      return std::chrono::duration<double>(duration).count();
+    }
+
+    /// Resident memory of this process, in bytes (0 if unavailable).
+    static size_t GetRSS() {
+#if defined(__linux__)
+      std::ifstream statm("/proc/self/statm");
+      size_t total_pages = 0, resident_pages = 0;
+      if (statm >> total_pages >> resident_pages) {
+        return resident_pages * (size_t) sysconf(_SC_PAGESIZE);
+      }
+#endif
+      return 0;
+    }
+
+    void Report(size_t update, clock_t::time_point now) {
+      const double recent_rate = (update - last_update) / std::max(Seconds(now - last_time), 1e-9);
+      const double overall_rate = (update - start_update) / std::max(Seconds(now - start_time), 1e-9);
+      const double eta = (max_update > update && overall_rate > 0.0)
+                       ? (max_update - update) / overall_rate : -1.0;
+      const size_t rss = GetRSS();
+      const uint64_t num_alive = control.GetRunStats().GetNumAlive();
+
+      if (print_status) {
+        std::cerr << "\r[" << GetName() << "] update " << update;
+        if (max_update) std::cerr << "/" << max_update;
+        std::cerr << "  " << (size_t) recent_rate << " ud/s";
+        if (eta >= 0.0) std::cerr << "  ETA " << (size_t) eta << "s";
+        std::cerr << "  RSS " << rss / (1024 * 1024) << "MB  alive " << num_alive << "    " << std::flush;
+        line_open = true;
+      }
+
+      if (heartbeat_file.size()) {
+        // Write a new file and rename it over the old, so readers never see a partial file.
+        const emp::String tmp_file = heartbeat_file + ".tmp";
+        {
+          std::ofstream out(tmp_file);
+          out << "update " << update << '\n'
+              << "max_update " << max_update << '\n'
+              << "updates_per_sec " << recent_rate << '\n'
+              << "eta_sec " << eta << '\n'
+              << "rss_bytes " << rss << '\n'
+              << "orgs_alive " << num_alive << '\n'
+              << "elapsed_sec " << Seconds(now - start_time) << '\n';
+        }
+        std::rename(tmp_file.c_str(), heartbeat_file.c_str());
+      }
+
+      last_time = now;
+      last_update = update;
+    }
+
+  public:
+    ReportProgress(mabe::MABE & control,
+                   const emp::String & name="ReportProgress",
+                   const emp::String & desc="Module to periodically report run progress.")
+      : Module(control, name, desc)
+    { SetAnalyzeMod(true); }
+    ~ReportProgress() { }
+
+    void SetupConfig() override {
+      LinkVar(interval, "interval", "Seconds between progress reports.");
+      LinkVar(max_update, "max_update", "Update the run ends on, for ETA (0 = no ETA).");
+      LinkVar(heartbeat_file, "heartbeat_file", "File to overwrite with status at each report (\"\" = none).");
+      LinkVar(print_status, "print_status", "Print a status line to stderr? (0=off; 1=on)");
+    }
+
+    void SetupModule() override {
+      if (interval <= 0.0) interval = 1.0;
+      start_time = last_time = clock_t::now();
+      start_update = last_update = next_check = control.GetUpdate();
+      control.AddForkFun([this](){      // Don't leave forked runs to finish our status line.
+        if (line_open) std::cerr << std::endl;
+        line_open = false;
+      });
+    }
+
+    void OnUpdate(size_t update) override {
+      if (update < next_check) return;
+
+      const clock_t::time_point now = clock_t::now();
+      const double elapsed = Seconds(now - last_time);
+      if (elapsed >= interval) Report(update, now);
+
+      // Estimate how many updates fit in the rest of this interval; look again after half.
+      const double since_report = Seconds(now - last_time);
+      const double rate = (update - start_update + 1) / std::max(Seconds(now - start_time), 1e-9);
+      const double updates_left = rate * (interval - since_report) / 2.0;
+      next_check = update + std::max<size_t>(1, (size_t) std::min(updates_left, 1e9));
+    }
+
+    void BeforeExit() override {
+      if (line_open) std::cerr << std::endl;
+    }
+  };
+
+  MABE_REGISTER_MODULE(ReportProgress, "Periodically report updates per second, ETA, and memory use.");
+}
+
+#endif
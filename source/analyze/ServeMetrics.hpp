@@ -0,0 +1,261 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  ServeMetrics.hpp
+ *  @brief MABE module to serve live run metrics over HTTP in Prometheus text format.
+ *
+ *  A background thread answers every HTTP request on 'port' with the most recent metrics:
+ *  the run throughput counters, population sizes, the profiler table (when profile=1), and
+ *  any trait summaries listed in 'summaries' (e.g., "fitness:max,fitness:mean").
+ *
+ *  The server never touches simulation state.  Metrics are rendered to text on the simulation
+ *  thread and published through an atomic pointer; a scrape only raises an atomic flag asking
+ *  for a fresh snapshot at the end of the next update.  An update in which no scrape arrived
+ *  costs one atomic load, and scrapes see values at most one update (and one scrape) old.
+ *
+ *  Only available on POSIX systems; elsewhere the module prints a warning and does nothing.
+ *  A FORK stops the server for good, since the forked runs cannot share one port.
+ */
+
+#ifndef MABE_SERVE_METRICS_HPP
+#define MABE_SERVE_METRICS_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MABE_SERVE_METRICS_POSIX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+namespace mabe {
+
+  class ServeMetrics : public Module {
+  private:
+    using summary_fun_t = std::function<emplode::Symbol_Var(const Population &)>;
+    struct Summary {
+      emp::String trait;
+      emp::String type;
+      summary_fun_t fun;
+    };
+
+    int port = 9464;                      ///< TCP port to listen on.
+    emp::String address = "127.0.0.1";    ///< Address to bind to ("0.0.0.0" for all).
+    int target_pop_id = 0;                ///< Population for trait summaries.
+    emp::String summaries = "";           ///< Comma-separated trait:summary pairs.
+
+    emp::vector<Summary> summary_funs;
+    std::atomic<std::shared_ptr<const std::string>> snapshot;  ///< Latest rendered metrics.
+    std::atomic<bool> snapshot_wanted{true};   ///< Has a scrape asked for fresh metrics?
+    std::atomic<bool> stopping{false};
+    std::thread server_thread;
+    int listen_fd = -1;
+
+    /// Escape a Prometheus label value.
+    static std::string Label(const emp::String & in) {
+      std::string out;
+      for (char c : in) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') { out += "\\n"; continue; }
+        out += c;
+      }
+      return out;
+    }
+
+    /// Build the metrics text (simulation thread only).
+    std::shared_ptr<const std::string> Render() {
+      std::stringstream ss;
+      const auto & stats = control.GetRunStats();
+      auto counter = [&ss](const char * name, const char * help, uint64_t value) {
+        ss << "# HELP " << name << ' ' << help << "\n# TYPE " << name << " counter\n"
+           << name << ' ' << value << '\n';
+      };
+      ss << "# HELP mabe_update Current update.\n# TYPE mabe_update gauge\n"
+         << "mabe_update " << control.GetUpdate() << '\n';
+      counter("mabe_births_total", "Organisms placed with a parent.", stats.births);
+      counter("mabe_injections_total", "Organisms placed without a parent.", stats.injections);
+      counter("mabe_deaths_total", "Organisms removed from populations.", stats.deaths);
+      counter("mabe_evaluations_total", "Organisms passed to evaluation functions.", stats.evaluations);
+      counter("mabe_insts_executed_total", "Process steps run by organisms.", stats.insts_executed);
+      counter("mabe_allocations_total", "Organisms built with a new allocation.", stats.allocations);
+
+      ss << "# HELP mabe_population_size Positions in each population.\n"
+         << "# TYPE mabe_population_size gauge\n";
+      for (size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id) {
+        const Population & pop = control.GetPopulation(pop_id);
+        ss << "mabe_population_size{pop=\"" << Label(pop.GetName()) << "\"} " << pop.GetSize() << '\n';
+      }
+      ss << "# HELP mabe_population_orgs Living organisms in each population.\n"
+         << "# TYPE mabe_population_orgs gauge\n";
+      for (size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id) {
+        const Population & pop = control.GetPopulation(pop_id);
+        ss << "mabe_population_orgs{pop=\"" << Label(pop.GetName()) << "\"} " << pop.GetNumOrgs() << '\n';
+      }
+
+      const Profiler & profiler = control.GetProfiler();
+      if (profiler.GetSize()) {
+        ss << "# HELP mabe_profile_calls_total Calls to each profiled signal or event.\n"
+           << "# TYPE mabe_profile_calls_total counter\n";
+        for (size_t slot = 0; slot < profiler.GetSize(); ++slot) {
+          const auto & entry = profiler.GetEntry(slot);
+          ss << "mabe_profile_calls_total{entry=\"" << Label(entry.name) << "\"} " << entry.count << '\n';
+        }
+        ss << "# HELP mabe_profile_seconds_total Time spent in each profiled signal or event.\n"
+           << "# TYPE mabe_profile_seconds_total counter\n";
+        for (size_t slot = 0; slot < profiler.GetSize(); ++slot) {
+          const auto & entry = profiler.GetEntry(slot);
+          ss << "mabe_profile_seconds_total{entry=\"" << Label(entry.name) << "\"} "
+             << (entry.total_ns / 1.0e9) << '\n';
+        }
+      }
+
+      if (summary_funs.size()) {
+        const Population & pop = control.GetPopulation(target_pop_id);
+        ss << "# HELP mabe_trait_summary Configured trait summaries.\n"
+           << "# TYPE mabe_trait_summary gauge\n";
+        for (const Summary & summary : summary_funs) {
+          ss << "mabe_trait_summary{pop=\"" << Label(pop.GetName())
+             << "\",trait=\"" << Label(summary.trait) << "\",summary=\"" << Label(summary.type)
+             << "\"} " << summary.fun(pop).AsDouble() << '\n';
+        }
+      }
+      return std::make_shared<const std::string>(ss.str());
+    }
+
+#ifdef MABE_SERVE_METRICS_POSIX
+    bool StartServer() {
+      listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+      if (listen_fd < 0) return false;
+      int reuse = 1;
+      setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons((uint16_t) port);
+      if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1 ||
+          bind(listen_fd, (sockaddr *) &addr, sizeof(addr)) != 0 ||
+          listen(listen_fd, 8) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+      }
+      server_thread = std::thread([this](){ Serve(); });
+      return true;
+    }
+
+    /// Server loop (background thread): answer each connection with the latest snapshot.
+    void Serve() {
+      while (!stopping) {
+        pollfd pfd{listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 250) <= 0) continue;    // Wake periodically to check 'stopping'.
+        const int client = accept(listen_fd, nullptr, nullptr);
+        if (client < 0) continue;
+
+        char request[1024];
+        pollfd cfd{client, POLLIN, 0};
+        if (poll(&cfd, 1, 1000) > 0) (void) recv(client, request, sizeof(request), 0);  // Any request.
+
+        snapshot_wanted = true;
+        std::shared_ptr<const std::string> body = snapshot.load();
+        static const std::string no_text;
+        const std::string & text = body ? *body : no_text;
+        const std::string header = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                   "Content-Length: " + std::to_string(text.size()) +
+                                   "\r\nConnection: close\r\n\r\n";
+        SendAll(client, header);
+        SendAll(client, text);
+        close(client);
+      }
+    }
+
+    static void SendAll(int fd, const std::string & text) {
+#ifdef MSG_NOSIGNAL
+      constexpr int flags = MSG_NOSIGNAL;   // A closed connection should not raise SIGPIPE.
+#else
+      constexpr int flags = 0;
+#endif
+      size_t sent = 0;
+      while (sent < text.size()) {
+        const ssize_t result = send(fd, text.data() + sent, text.size() - sent, flags);
+        if (result <= 0) return;
+        sent += (size_t) result;
+      }
+    }
+#endif
+
+    void StopServer() {
+      stopping = true;
+      if (server_thread.joinable()) server_thread.join();
+#ifdef MABE_SERVE_METRICS_POSIX
+      if (listen_fd >= 0) close(listen_fd);
+#endif
+      listen_fd = -1;
+    }
+
+  public:
+    ServeMetrics(mabe::MABE & control,
+                 const emp::String & name="ServeMetrics",
+                 const emp::String & desc="Module to serve live metrics over HTTP (Prometheus format).")
+      : Module(control, name, desc)
+    { SetAnalyzeMod(true); }
+    ~ServeMetrics() { StopServer(); }
+
+    void SetupConfig() override {
+      LinkVar(port, "port", "TCP port to serve metrics on.");
+      LinkVar(address, "address", "Address to listen on (\"0.0.0.0\" for all interfaces).");
+      LinkPop(target_pop_id, "target_pop", "Population to compute trait summaries on.");
+      LinkVar(summaries, "summaries", "Trait summaries to serve, as comma-separated trait:summary pairs.");
+    }
+
+    void SetupModule() override {
+      Population & pop = control.GetPopulation(target_pop_id);
+      emp::remove_whitespace(summaries);
+      for (const emp::String & entry : emp::slice(summaries, ',')) {
+        if (entry.empty()) continue;
+        emp::vector<emp::String> parts = emp::slice(entry, ':');
+        if (parts.size() != 2) {
+          emp::notify::Error("Module '", GetName(), "' summary '", entry, "' must be trait:summary.");
+          continue;
+        }
+        summary_funs.push_back(Summary{parts[0], parts[1],
+          control.GetConfigScript().BuildTraitSummary<Population>(parts[0], parts[1], pop.GetDataLayout())});
+      }
+
+      snapshot = Render();
+      control.AddForkFun([this](){ StopServer(); });
+#ifdef MABE_SERVE_METRICS_POSIX
+      if (!StartServer()) {
+        emp::notify::Warning("Module '", GetName(), "' could not listen on ", address, ":", port, ".");
+      }
+#else
+      emp::notify::Warning("Module '", GetName(), "' is only supported on POSIX systems.");
+#endif
+    }
+
+    void OnUpdate(size_t) override {
+      // Only render when a scrape has asked for it since the last snapshot.
+      if (snapshot_wanted.load(std::memory_order_relaxed)) {
+        snapshot_wanted = false;
+        snapshot = Render();
+      }
+    }
+
+    void BeforeExit() override { StopServer(); }
+  };
+
+  MABE_REGISTER_MODULE(ServeMetrics, "Serve run metrics over HTTP in Prometheus text format.");
+}
+
+#endif
@@ -10,8 +10,18 @@
 #ifndef MABE_ANALYZE_SYSTEMATICS_MODULE_H
 #define MABE_ANALYZE_SYSTEMATICS_MODULE_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
+#include "../tools/BackgroundQueue.hpp"
 #include "emp/Evolve/Systematics.hpp"
 #include "emp/data/DataFile.hpp"
 
@@ -26,6 +36,31 @@ private:
     RequiredTraitAsString taxon_trait{this,"genome"};  ///< Which trait should taxa be based on?
     emp::Systematics <Organism, emp::String> sys;      ///< The systematics manager.
 
+    // Compact taxon info: keep only a hash of each taxon's info in memory, optionally
+    // recording the full info on disk the first time each hash appears.
+    bool hash_taxon_info = false;          ///< Store a hash instead of the full info string?
+    emp::String info_file_name;            ///< Where to record hash -> info (empty = nowhere).
+    std::ofstream info_file;
+    std::unordered_set<uint64_t> recorded_hashes;
+
+    /// Info used to delineate taxa for an organism (its full trait string or a hash of it).
+    emp::String MakeTaxonInfo(Organism & org) {
+      const emp::String & info = taxon_trait.Get(org);
+      if (!hash_taxon_info) return info;
+
+      uint64_t hash = 14695981039346656037ull;         // 64-bit FNV-1a
+      for (unsigned char c : info) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+      }
+      std::stringstream ss;
+      ss << std::hex << hash;
+      if (info_file.is_open() && recorded_hashes.insert(hash).second) {
+        info_file << ss.str() << ",\"" << info << "\"\n";
+      }
+      return ss.str();
+    }
+
     // Output
     UpdateRange snapshot_range;            ///< Updates to start and stop snapshots + frequency.
     emp::String snapshot_file_root_name;   ///< Root name of the snapshot files.
@@ -33,14 +68,223 @@ private:
     emp::String data_file_name;            ///< Name of the data file.
     emp::DataFile data;                    ///< Data file object.
 
+    // Asynchronous snapshots: copy the fields of each taxon into an immutable list on the
+    // main thread, then format and write the file on a background thread.
+    struct TaxonRecord {
+      size_t id;
+      size_t parent_id;                    ///< emp::MAX_SIZE_T if no parent.
+      double origin_time;
+      double destruction_time;
+      size_t num_orgs;
+      size_t tot_orgs;
+      size_t num_offspring;
+      size_t tot_offspring;
+      size_t depth;
+      emp::String info;
+    };
+    using snapshot_t = std::shared_ptr<const emp::vector<TaxonRecord>>;
+    bool async_snapshots = false;          ///< Write snapshots from a background thread?
+    bool binary_snapshots = false;         ///< With async_snapshots, use binary (.phylo) files?
+    std::thread snapshot_thread;           ///< Writer for the most recent snapshot.
+
+    // Whole-tree metrics are expensive, but the tree only changes on births, deaths, and
+    // updates; cache each metric until the tree next changes.
+    using taxon_ptr_t = emp::Ptr<emp::Taxon<emp::String>>;
+    struct CachedMetric {
+      size_t version = emp::MAX_SIZE_T;   ///< Tree version this value was computed for.
+      double value = 0.0;
+    };
+    size_t tree_version = 0;               ///< Incremented whenever the tree may have changed.
+    CachedMetric mpd_cache;
+    CachedMetric pd_cache;
+    CachedMetric depth_cache;
+    size_t mpd_samples = 0;                ///< If > 0, estimate MPD from this many random pairs.
+    double mpd_margin = 0.0;               ///< 95% margin of error of the last MPD estimate.
+
+    // Asynchronous events: births, deaths, swaps, and updates are appended to a batch on the
+    // main thread (taxon info is computed there, while the organism still exists) and each
+    // batch is applied to the tree on a dedicated thread.  Anything that reads the tree calls
+    // SyncEvents() first.
+    struct SysEvent {
+      enum kind_t : uint8_t { BIRTH, INJECT, DEATH, SWAP, UPDATE } kind;
+      emp::WorldPosition pos;
+      emp::WorldPosition other;            ///< Parent for births, second position for swaps.
+      emp::String info;                    ///< Taxon info for births and injections.
+    };
+    static constexpr size_t EVENT_BATCH_SIZE = 4096;
+    bool async_events = false;             ///< Apply events to the tree on another thread?
+    emp::vector<SysEvent> pending_events;  ///< Events not yet handed to the thread.
+    BackgroundQueue event_thread;
+    emp::Ptr<Organism> placeholder_org = nullptr;  ///< Stands in for organisms in queued births.
+    const emp::String * queued_info = nullptr;     ///< Info of the queued birth being applied.
+
+    void ApplyEvents(const emp::vector<SysEvent> & events) {
+      for (const SysEvent & event : events) {
+        switch (event.kind) {
+        case SysEvent::BIRTH:
+        case SysEvent::INJECT:
+          queued_info = &event.info;
+          if (event.kind == SysEvent::BIRTH) sys.AddOrg(*placeholder_org, event.pos, event.other);
+          else sys.AddOrg(*placeholder_org, event.pos, nullptr);
+          queued_info = nullptr;
+          break;
+        case SysEvent::DEATH:  sys.RemoveOrg(event.pos); break;
+        case SysEvent::SWAP:   sys.SwapPositions(event.pos, event.other); break;
+        case SysEvent::UPDATE: sys.Update(); break;
+        }
+      }
+    }
+
+    /// Hand the current batch of events to the systematics thread.
+    void FlushEvents() {
+      if (pending_events.empty()) return;
+      event_thread.Submit([this, events = std::move(pending_events)](){ ApplyEvents(events); });
+      pending_events.clear();
+      pending_events.reserve(EVENT_BATCH_SIZE);
+    }
+
+    void QueueEvent(SysEvent && event) {
+      pending_events.push_back(std::move(event));
+      if (pending_events.size() >= EVENT_BATCH_SIZE) FlushEvents();
+    }
+
+    /// Wait until every event so far has been applied to the tree.
+    void SyncEvents() {
+      if (!async_events) return;
+      FlushEvents();
+      try { event_thread.Wait(); }
+      catch (const std::exception & error) {
+        emp::notify::Error("AnalyzeSystematics '", GetName(), "' failed to update the tree: ", error.what());
+      }
+    }
+
+    /// Number of taxon-to-parent steps between two taxa (through their closest ancestor).
+    static size_t CalcTaxonDistance(taxon_ptr_t taxon1, taxon_ptr_t taxon2) {
+      std::unordered_set<taxon_ptr_t> lineage;
+      for (taxon_ptr_t t = taxon1; t; t = t->GetParent()) lineage.insert(t);
+      size_t steps2 = 0;
+      for (taxon_ptr_t t = taxon2; t; t = t->GetParent(), ++steps2) {
+        if (lineage.count(t)) {
+          size_t steps1 = 0;
+          for (taxon_ptr_t t1 = taxon1; t1 != t; t1 = t1->GetParent()) ++steps1;
+          return steps1 + steps2;
+        }
+      }
+      return steps2 + lineage.size();   // No shared ancestor was stored.
+    }
+
+    /// Estimate the mean pairwise distance among active taxa from random pairs, recording
+    /// the 95% margin of error in mpd_margin.
+    double EstimateMeanPairwiseDistance() {
+      emp::vector<taxon_ptr_t> active(sys.GetActive().begin(), sys.GetActive().end());
+      mpd_margin = 0.0;
+      if (active.size() < 2) return 0.0;
+      emp::Random & random = control.GetRandom();
+      double total = 0.0, total_sq = 0.0;
+      for (size_t i = 0; i < mpd_samples; ++i) {
+        const size_t pos1 = random.GetUInt(active.size());
+        size_t pos2 = random.GetUInt(active.size() - 1);
+        if (pos2 >= pos1) ++pos2;
+        const double dist = (double) CalcTaxonDistance(active[pos1], active[pos2]);
+        total += dist;
+        total_sq += dist * dist;
+      }
+      const double N = (double) mpd_samples;
+      const double mean = total / N;
+      const double var = (N > 1) ? (total_sq - total * mean) / (N - 1) : 0.0;
+      mpd_margin = 1.96 * std::sqrt(std::max(var, 0.0) / N);
+      return mean;
+    }
+
+    snapshot_t CollectSnapshot() const {
+      auto records = std::make_shared<emp::vector<TaxonRecord>>();
+      auto add_taxa = [&records](const auto & taxa) {
+        for (taxon_ptr_t taxon : taxa) {
+          taxon_ptr_t parent = taxon->GetParent();
+          records->push_back(TaxonRecord{
+            taxon->GetID(), parent ? parent->GetID() : emp::MAX_SIZE_T,
+            taxon->GetOriginationTime(), taxon->GetDestructionTime(),
+            taxon->GetNumOrgs(), taxon->GetTotOrgs(), taxon->GetNumOff(),
+            taxon->GetTotOffspring(), taxon->GetDepth(), taxon->GetInfo()
+          });
+        }
+      };
+      add_taxa(sys.GetActive());
+      add_taxa(sys.GetAncestors());
+      add_taxa(sys.GetOutside());
+      return records;
+    }
+
+    static void WriteSnapshotCSV(const emp::vector<TaxonRecord> & records, const emp::String & filename) {
+      std::ofstream os(filename);
+      os << "id,ancestor_list,origin_time,destruction_time,num_orgs,tot_orgs,num_offspring,"
+         << "total_offspring,depth,taxon_info\n";
+      for (const TaxonRecord & r : records) {
+        os << r.id << ",[";
+        if (r.parent_id == emp::MAX_SIZE_T) os << "NONE";
+        else os << r.parent_id;
+        os << "]," << r.origin_time << "," << r.destruction_time << "," << r.num_orgs << ","
+           << r.tot_orgs << "," << r.num_offspring << "," << r.tot_offspring << "," << r.depth
+           << ",\"" << r.info << "\"\n";
+      }
+    }
+
+    /// Binary layout: "MABEPHYL", uint64 version, uint64 count, then per taxon seven uint64
+    /// fields (id, parent_id, num_orgs, tot_orgs, num_offspring, tot_offspring, depth), two
+    /// doubles (origin_time, destruction_time), and uint64 info length followed by its chars.
+    static void WriteSnapshotBinary(const emp::vector<TaxonRecord> & records, const emp::String & filename) {
+      std::ofstream os(filename, std::ios::binary);
+      auto write = [&os](auto value){ os.write(reinterpret_cast<const char *>(&value), sizeof(value)); };
+      os.write("MABEPHYL", 8);
+      write((uint64_t) 1);
+      write((uint64_t) records.size());
+      for (const TaxonRecord & r : records) {
+        write((uint64_t) r.id);            write((uint64_t) r.parent_id);
+        write((uint64_t) r.num_orgs);      write((uint64_t) r.tot_orgs);
+        write((uint64_t) r.num_offspring); write((uint64_t) r.tot_offspring);
+        write((uint64_t) r.depth);
+        write(r.origin_time);              write(r.destruction_time);
+        write((uint64_t) r.info.size());
+        os.write(r.info.data(), (std::streamsize) r.info.size());
+      }
+    }
+
+    /// Write a snapshot of the phylogeny; 'filename' has no extension.
+    void WriteSnapshot(const emp::String & filename) {
+      SyncEvents();
+      if (!async_snapshots) {
+        sys.Snapshot(filename + ".csv");
+        return;
+      }
+      snapshot_t records = CollectSnapshot();
+      if (snapshot_thread.joinable()) snapshot_thread.join();  // One writer at a time.
+      const bool binary = binary_snapshots;
+      snapshot_thread = std::thread([records, filename, binary](){
+        if (binary) WriteSnapshotBinary(*records, filename + ".phylo");
+        else WriteSnapshotCSV(*records, filename + ".csv");
+      });
+    }
+
+    /// Return a cached metric, recalculating it only if the tree has changed.
+    template <typename FUN_T>
+    double GetCached(CachedMetric & cache, FUN_T calc_fun) {
+      if (cache.version != tree_version) {
+        SyncEvents();
+        cache.value = calc_fun();
+        cache.version = tree_version;
+      }
+      return cache.value;
+    }
+
 public:
     AnalyzeSystematics(mabe::MABE & control,
                const emp::String & name="AnalyzeSystematics",
                const emp::String & desc="Module to track the population's phylogeny.")
       : Module(control, name, desc)
       , sys([this](Organism& org){
+              if (queued_info) return *queued_info;
               org.GenerateOutput();
-              return taxon_trait.Get(org);
+              return MakeTaxonInfo(org);
             }, true, store_ancestors, store_outside, true)
       , snapshot_file_root_name("phylogeny")
       , data_file_name("phylogenetic_data.csv")
@@ -49,21 +293,57 @@ public:
       taxon_trait.SetConfigName("taxon_info");
       taxon_trait.SetConfigDesc("Trait for identification of unique taxa.");
       SetAnalyzeMod(true);    ///< Mark this module as an analyze module.
+      SetConcurrentUpdate(true);  ///< OnUpdate only touches the tree and its own files.
+    }
+    ~AnalyzeSystematics() {
+      SyncEvents();
+      event_thread.Stop();
+      if (snapshot_thread.joinable()) snapshot_thread.join();
+    }
+
+    /// Approximate bytes held by tracked taxa (each in a set) and recorded info hashes.
+    size_t GetNumBytes() const override {
+      const_cast<AnalyzeSystematics *>(this)->SyncEvents();     // Count the tree as it stands.
+      const size_t num_taxa = sys.GetActive().size() + sys.GetAncestors().size() + sys.GetOutside().size();
+      return num_taxa * (sizeof(emp::Taxon<emp::String>) + 4 * sizeof(void *))
+           + recorded_hashes.size() * (sizeof(uint64_t) + 2 * sizeof(void *));
     }
-    ~AnalyzeSystematics() { }
 
     void SetupConfig() override {
       // Settings for the systematic manager.
       LinkVar(store_outside, "store_outside", "Store all taxa that ever existed.(1 = TRUE)" );
       LinkVar(store_ancestors, "store_ancestors", "Store all ancestors of extant taxa.(1 = TRUE)" );
+      LinkVar(hash_taxon_info, "hash_taxon_info", "Store a 64-bit hash of the taxon info rather than the full string, to save memory on long runs.(1 = TRUE)" );
+      LinkVar(info_file_name, "taxon_info_file", "With hash_taxon_info, file to record each hash's full info in when first seen (empty = don't record).");
       // Settings for output files.
       LinkVar(data_file_name, "data_file_name", "Filename for systematics data file.");
       LinkVar(snapshot_file_root_name, "snapshot_file_root_name", "Filename for snapshot files (will have update number and .csv appended to end)");
       LinkRange(snapshot_range, "snapshot_updates", "Which updates should we output a snapshot of the phylogeny?");
+      LinkVar(async_snapshots, "async_snapshots", "Write snapshots from a background thread so the run continues immediately.(1 = TRUE)");
+      LinkVar(binary_snapshots, "binary_snapshots", "With async_snapshots, write binary .phylo files instead of .csv.(1 = TRUE)");
       LinkRange(data_range, "data_updates", "Which updates should we output a data from the phylogeny?");
+      LinkVar(async_events, "async_events", "Update the phylogeny from a separate thread so births and deaths do not wait on it (do not combine with FORK).(1 = TRUE)");
+      LinkVar(mpd_samples, "mpd_samples", "Estimate mean pairwise distance from this many random pairs of taxa (0 = exact).");
     }
 
     void SetupModule() override {
+      // The manager was built before config was loaded; apply the storage settings now so
+      // that store_ancestors=0 actually prunes extinct lineages.
+      sys.SetStoreAncestors(store_ancestors);
+      sys.SetStoreOutside(store_outside);
+
+      // Forked runs get no copy of the event or snapshot threads; finish and join them first.
+      control.AddForkFun([this](){
+        SyncEvents();
+        event_thread.Stop();
+        if (snapshot_thread.joinable()) snapshot_thread.join();
+      });
+
+      if (hash_taxon_info && info_file_name.size()) {
+        info_file.open(info_file_name);
+        info_file << "taxon_hash,taxon_info\n";
+      }
+
       // Setup the data file
       data = emp::DataFile(data_file_name);
       sys.AddPhylogeneticDiversityDataNode();
@@ -83,28 +363,45 @@ public:
     }
       
     void OnUpdate(size_t update) override {
-      sys.Update();
+      ++tree_version;
+      if (async_events) {
+        QueueEvent({SysEvent::UPDATE, {}, {}, {}});
+        if (data_range.IsValid(update)) SyncEvents();   // Data nodes read the tree.
+        else FlushEvents();
+      }
+      else sys.Update();
 
       if (snapshot_range.IsValid(update)) {
-        sys.Snapshot(snapshot_file_root_name + "_" + emp::MakeString(update) + ".csv");
+        WriteSnapshot(snapshot_file_root_name + "_" + emp::MakeString(update));
       }
       data.Update(update);      
     }
+
+    void BeforeExit() override { SyncEvents(); }
     
     void TakeManualSnapshot(){
-      sys.Snapshot(snapshot_file_root_name + "_manual_" + emp::MakeString(control.GetUpdate()) + ".csv");
+      WriteSnapshot(snapshot_file_root_name + "_manual_" + emp::MakeString(control.GetUpdate()));
     }
 
     double CheckMeanPairwiseDistance() {
-      double mpd;
-      if (std::isnan(sys.GetMeanPairwiseDistance())) {
-          //std::cout << "Mean pairwise distance is NaN" << std::endl;
-          mpd = 0;
-      }
-      else {
-          mpd = sys.GetMeanPairwiseDistance();
-      }
-      return mpd;
+      return GetCached(mpd_cache, [this](){
+        if (mpd_samples) return EstimateMeanPairwiseDistance();
+        const double mpd = sys.GetMeanPairwiseDistance();
+        return std::isnan(mpd) ? 0.0 : mpd;
+      });
+    }
+
+    double GetMeanPairwiseDistanceMargin() {
+      CheckMeanPairwiseDistance();
+      return mpd_margin;
+    }
+
+    double GetPhylogeneticDiversity() {
+      return GetCached(pd_cache, [this](){ return (double) sys.GetPhylogeneticDiversity(); });
+    }
+
+    double GetMaxDepth() {
+      return GetCached(depth_cache, [this](){ return (double) sys.GetMaxDepth(); });
     }
     
     static void InitType(emplode::TypeInfo & info) {
@@ -119,16 +416,37 @@ public:
             return mod.CheckMeanPairwiseDistance();
           },
           "Check mean pairwise distance");
+      info.AddMemberFunction("MPD_MARGIN",
+          [](AnalyzeSystematics & mod) { return mod.GetMeanPairwiseDistanceMargin(); },
+          "95% margin of error for a sampled mean pairwise distance (0 if exact)");
+      info.AddMemberFunction("PHYLO_DIVERSITY",
+          [](AnalyzeSystematics & mod) { return mod.GetPhylogeneticDiversity(); },
+          "Phylogenetic diversity of the current tree (cached until the tree changes)");
+      info.AddMemberFunction("MAX_DEPTH",
+          [](AnalyzeSystematics & mod) { return mod.GetMaxDepth(); },
+          "Depth of the deepest extant lineage (cached until the tree changes)");
     }
 
     void BeforeDeath(OrgPosition pos) override {
       // Notify the systematics manager when an organism dies.
-      sys.RemoveOrg({pos.Pos(), (size_t)pos.PopID()});
+      ++tree_version;
+      if (async_events) QueueEvent({SysEvent::DEATH, {pos.Pos(), (size_t)pos.PopID()}, {}, {}});
+      else sys.RemoveOrg({pos.Pos(), (size_t)pos.PopID()});
     }
 
     void BeforePlacement(Organism& org, OrgPosition pos, OrgPosition ppos) override {
       // Notify the systematics manager when an organism is born.
-      if (ppos.IsValid()) {
+      ++tree_version;
+      if (async_events) {
+        if (!placeholder_org) placeholder_org = &pos.PopPtr()->GetEmptyOrg();
+        org.GenerateOutput();
+        if (ppos.IsValid()) {
+          QueueEvent({SysEvent::BIRTH, {pos.Pos(), (size_t)pos.PopID()},
+                      {ppos.Pos(), (size_t)ppos.PopID()}, MakeTaxonInfo(org)});
+        }
+        else QueueEvent({SysEvent::INJECT, {pos.Pos(), (size_t)pos.PopID()}, {}, MakeTaxonInfo(org)});
+      }
+      else if (ppos.IsValid()) {
         sys.AddOrg(org, {pos.Pos(), (size_t)pos.PopID()}, {ppos.Pos(), (size_t)ppos.PopID()});
       } else {
         // We're injecting so no parent
@@ -141,7 +459,22 @@ public:
 
     void OnSwap(OrgPosition pos1, OrgPosition pos2) override {
       // Notify the systematics manager when an organism is moved.
-      sys.SwapPositions({pos1.Pos(), (size_t)pos1.PopID()}, {pos2.Pos(), (size_t)pos2.PopID()});
+      if (async_events) {
+        QueueEvent({SysEvent::SWAP, {pos1.Pos(), (size_t)pos1.PopID()}, {pos2.Pos(), (size_t)pos2.PopID()}, {}});
+      }
+      else sys.SwapPositions({pos1.Pos(), (size_t)pos1.PopID()}, {pos2.Pos(), (size_t)pos2.PopID()});
+    }
+
+    void OnPopSwap(Population & pop1, Population & pop2) override {
+      // Every position may have changed populations; move each in the systematics manager too.
+      const size_t max_size = std::max(pop1.GetSize(), pop2.GetSize());
+      for (size_t pos = 0; pos < max_size; ++pos) {
+        if (!pop1.IsOccupied(pos) && !pop2.IsOccupied(pos)) continue;
+        if (async_events) {
+          QueueEvent({SysEvent::SWAP, {pos, (size_t)pop1.GetID()}, {pos, (size_t)pop2.GetID()}, {}});
+        }
+        else sys.SwapPositions({pos, (size_t)pop1.GetID()}, {pos, (size_t)pop2.GetID()});
+      }
     }
 };
 
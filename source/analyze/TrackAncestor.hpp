@@ -5,11 +5,18 @@
  *
  *  @file  TrackAncestor.hpp
  *  @brief MABE module to track info about the ancestor of each organism.
+ *
+ *  Each injected organism starts a new clade, which its descendants inherit.  Living counts
+ *  per clade are kept up to date on every placement and death, along with a list of surviving
+ *  clades sorted by size (each count change moves one clade to the edge of its group of equal
+ *  counts), so the number of surviving clades and the dominant clade are O(1) queries.
  */
 
 #ifndef MABE_TRACK_ANCESTOR_HPP
 #define MABE_TRACK_ANCESTOR_HPP
 
+#include <fstream>
+
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 
@@ -21,30 +28,151 @@ namespace mabe {
     OwnedTrait<double> inject_time{this, "inject_time", "Update this lineage was injected"};
     OwnedTrait<size_t> clade_id{this, "clade_id", "Unique ID for the clade from this ancestor"};
 
+    static constexpr size_t NOT_EXTINCT = (size_t) -1;
+
+    struct CladeInfo {
+      size_t num_living = 0;               ///< Organisms from this clade currently alive.
+      size_t first_update = 0;             ///< Update the clade's ancestor was injected.
+      size_t extinct_update = NOT_EXTINCT; ///< Update the clade's last organism died.
+      size_t rank = 0;                     ///< Position in 'order' (while surviving).
+    };
+
     size_t next_clade = 0; // What value should the next clade ID have?
+    emp::vector<CladeInfo> clades;     ///< Info on each clade, by clade ID.
+    emp::vector<size_t> order;         ///< Surviving clade IDs, largest living count first.
+    emp::vector<size_t> first_at;      ///< For each count, first position in 'order' with it.
+    emp::vector<size_t> num_at;        ///< For each count, number of clades with it.
+    size_t num_extinct = 0;            ///< Total clades that have gone extinct.
+    size_t update_new = 0;             ///< Clades started since the last output.
+    size_t update_extinct = 0;         ///< Clades gone extinct since the last output.
+
+    emp::String filename = "";         ///< File for per-update clade summaries ("" = none).
+    std::ofstream file;
+    size_t last_output = (size_t) -1;  ///< Update of the most recent output line.
+
+    void SwapRanks(size_t pos1, size_t pos2) {
+      std::swap(order[pos1], order[pos2]);
+      clades[order[pos1]].rank = pos1;
+      clades[order[pos2]].rank = pos2;
+    }
+
+    void AddToClade(size_t id) {
+      if (id >= clades.size()) clades.resize(id+1);
+      CladeInfo & clade = clades[id];
+      const size_t count = clade.num_living++;
+      if (count + 2 > num_at.size()) { num_at.resize(count + 2, 0); first_at.resize(count + 2, 0); }
+
+      size_t pos = order.size();
+      if (count == 0) {                    // New (or revived) clade: smallest, so add at end.
+        clade.rank = pos;
+        order.push_back(id);
+      } else {                             // Move to the front of its count group, then grow.
+        pos = first_at[count];
+        SwapRanks(pos, clade.rank);
+        if (--num_at[count]) first_at[count] = pos + 1;
+      }
+      if (num_at[count+1]++ == 0) first_at[count+1] = pos;
+    }
+
+    void RemoveFromClade(size_t id) {
+      emp_assert(id < clades.size() && clades[id].num_living > 0, id);
+      CladeInfo & clade = clades[id];
+      const size_t count = clade.num_living--;
+
+      // Move to the back of its count group, then shrink.
+      const size_t pos = first_at[count] + num_at[count] - 1;
+      SwapRanks(pos, clade.rank);
+      --num_at[count];
+      if (count > 1) {                     // Now first in the next-smaller count group.
+        ++num_at[count-1];
+        first_at[count-1] = pos;
+      } else {                             // Last organism; the clade is at the end of 'order'.
+        emp_assert(pos + 1 == order.size());
+        order.pop_back();
+        clade.extinct_update = control.GetUpdate();
+        ++num_extinct;
+        ++update_extinct;
+      }
+    }
+
+    void WriteSummary(size_t update) {
+      if (!file.is_open() || update == last_output) return;
+      file << update << ',' << GetNumSurviving() << ',' << next_clade << ','
+           << GetDominantClade() << ',' << GetDominantCount() << ','
+           << update_new << ',' << update_extinct << '\n';
+      update_new = update_extinct = 0;
+      last_output = update;
+    }
 
   public:
     TrackAncestor(mabe::MABE & control,
                 const emp::String & name="TrackAncestor",
-                const emp::String & desc="Module to choose the top fitness organisms for replication.")
+                const emp::String & desc="Module to track the ancestor (and clade) of each organism.")
       : Module(control, name, desc)
-    { SetAnalyzeMod(true); } 
+    {
+      SetAnalyzeMod(true);
+      SetConcurrentUpdate(true);  // Update steps only use this module's own data and file.
+    }
     ~TrackAncestor() { }
 
+    /// Number of clades with at least one living organism.
+    size_t GetNumSurviving() const { return order.size(); }
+
+    /// Clade with the most living organisms (ties broken arbitrarily); NOT_EXTINCT if none.
+    size_t GetDominantClade() const { return order.size() ? order[0] : NOT_EXTINCT; }
+    size_t GetDominantCount() const { return order.size() ? clades[order[0]].num_living : 0; }
+
+    size_t GetCladeSize(size_t id) const { return id < clades.size() ? clades[id].num_living : 0; }
+    size_t GetNumExtinct() const { return num_extinct; }
+
     // Setup member functions associated with this class.
-    static void InitType(emplode::TypeInfo &) {
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("NUM_CLADES",
+        [](TrackAncestor & mod) { return mod.GetNumSurviving(); },
+        "Number of clades with living organisms.");
+      info.AddMemberFunction("NUM_EXTINCT",
+        [](TrackAncestor & mod) { return mod.GetNumExtinct(); },
+        "Number of clades that have gone extinct.");
+      info.AddMemberFunction("DOMINANT_CLADE",
+        [](TrackAncestor & mod) { return mod.GetDominantClade(); },
+        "ID of the clade with the most living organisms.");
+      info.AddMemberFunction("DOMINANT_COUNT",
+        [](TrackAncestor & mod) { return mod.GetDominantCount(); },
+        "Number of living organisms in the dominant clade.");
+      info.AddMemberFunction("CLADE_SIZE",
+        [](TrackAncestor & mod, size_t id) { return mod.GetCladeSize(id); },
+        "Number of living organisms in the clade with the given ID.");
     }
 
     void SetupConfig() override {
+      LinkVar(filename, "output_file",
+              "File for per-update clade counts, dominant clade, and extinctions (\"\" = none).");
     }
 
     void SetupModule() override {
+      if (filename.size()) {
+        file.open(filename.str());
+        if (!file) {
+          emp::notify::Error("Module '", GetName(), "' could not open output file '", filename, "'.");
+          return;
+        }
+        file << "update,num_clades,total_clades,dominant_clade,dominant_count,new_clades,extinctions\n";
+      }
     }
 
     void OnInjectReady(Organism & org, Population &) override {
       inject_time(org) = static_cast<double>(control.GetUpdate());
       clade_id(org) = next_clade++;
+      clades.resize(next_clade);
+      clades.back().first_update = control.GetUpdate();
+      ++update_new;
     }
+
+    void OnPlacement(OrgPosition pos) override { AddToClade(clade_id(*pos.OrgPtr())); }
+    void BeforeDeath(OrgPosition pos) override { RemoveFromClade(clade_id(*pos.OrgPtr())); }
+
+    void BeforeUpdate(size_t update) override { WriteSummary(update); }
+    void BeforeExit() override { WriteSummary(control.GetUpdate()); }
   };
 
   MABE_REGISTER_MODULE(TrackAncestor, "Track info about the original ancestor of each organism.");
@@ -0,0 +1,118 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024
+ *
+ *  @file  TraitHistory.hpp
+ *  @brief MABE module to keep the last few recorded values of numeric traits on each organism.
+ *
+ *  For each trait X listed, every organism gets a trait X_history holding 'depth' doubles in
+ *  its DataMap, most recent first.  On updates start, start+interval, ... (and whenever
+ *  RECORD() is called), each one moves back a place with a block copy and the current value
+ *  of X goes in front.  Equations can then read X[-1] for the latest record, X[-2] for the
+ *  one before, and so on (e.g., "fitness - fitness[-10]" for the gain over the last ten
+ *  records).  An organism's first record fills its whole history with the same value, so an
+ *  organism younger than 'depth' records compares against that first value (usually its
+ *  value when it was born).
+ */
+
+#ifndef MABE_TRAIT_HISTORY_HPP
+#define MABE_TRAIT_HISTORY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "emp/base/notify.hpp"
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+namespace mabe {
+
+  class TraitHistory : public Module {
+  private:
+    int target_pop_id = 0;               ///< Population to record.
+    emp::String trait_names = "fitness"; ///< Comma-separated traits to keep histories for.
+    size_t depth = 10;                   ///< Records kept for each trait.
+    size_t start = 0;                    ///< First update to record on.
+    size_t interval = 1;                 ///< Updates between records (0 = only via RECORD()).
+    emp::vector<emp::String> traits;
+    size_t num_records = 0;
+
+  public:
+    TraitHistory(mabe::MABE & control,
+                 const emp::String & name="TraitHistory",
+                 const emp::String & desc="Module to keep recent values of traits on each organism.")
+      : Module(control, name, desc)
+    {
+      SetAnalyzeMod(true);
+    }
+    ~TraitHistory() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("RECORD",
+        [](TraitHistory & mod) { mod.Record(); return mod.num_records; },
+        "Record the current trait values into each organism's history; returns records so far.");
+      info.AddMemberFunction("NUM_RECORDS",
+        [](TraitHistory & mod) { return mod.num_records; },
+        "Number of times trait values have been recorded.");
+    }
+
+    void SetupConfig() override {
+      LinkPop(target_pop_id, "target_pop", "Population to keep trait histories in.");
+      LinkVar(trait_names, "traits", "Comma-separated list of numeric traits to keep histories for.");
+      LinkVar(depth, "depth", "Number of past values to keep for each trait (read as trait[-1] to trait[-depth]).");
+      LinkVar(start, "start", "First update to record values on.");
+      LinkVar(interval, "interval", "Updates between records (0 = only when RECORD() is called).");
+    }
+
+    void SetupModule() override {
+      if (depth == 0) {
+        emp::notify::Error("TraitHistory '", GetName(), "' needs a depth of at least 1.");
+        depth = 1;
+      }
+      emp::String names = trait_names;
+      emp::remove_whitespace(names);
+      traits.resize(0);
+      for (const emp::String & name : names.Slice(",")) {
+        if (name.empty()) continue;
+        AddRequiredTrait<double>(name);
+        AddOwnedTrait<double>(name + "_history", "Recent values of " + name + " (most recent first)",
+                              std::numeric_limits<double>::quiet_NaN(), depth);
+        traits.push_back(name);
+      }
+    }
+
+    /// Push the current value of each trait onto the front of its history, for every organism.
+    void Record() {
+      Population & pop = control.GetPopulation(target_pop_id);
+      ++num_records;
+      if (pop.GetNumOrgs() == 0) return;
+      const emp::DataLayout & layout = pop.GetDataLayout();
+      for (const emp::String & name : traits) {
+        const size_t trait_id = layout.GetID(name);
+        const size_t history_id = layout.GetID(name + "_history");
+        for (size_t pos : pop.GetLivingPositions()) {
+          emp::DataMap & dmap = pop[pos].GetDataMap();
+          const double value = dmap.Get<double>(trait_id);
+          double * history = &dmap.Get<double>(history_id);
+          if (std::isnan(history[0])) std::fill(history, history + depth, value);  // First record.
+          else {
+            std::memmove(history + 1, history, (depth - 1) * sizeof(double));
+            history[0] = value;
+          }
+        }
+      }
+    }
+
+    void OnUpdate(size_t update) override {
+      if (interval && update >= start && (update - start) % interval == 0) Record();
+    }
+  };
+
+  MABE_REGISTER_MODULE(TraitHistory, "Keep recent values of traits on each organism.");
+}
+
+#endif
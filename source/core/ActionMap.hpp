@@ -17,9 +17,13 @@
 #define MABE_ACTION_MAP_H
 
 
+#include <algorithm>
+#include <any>
 #include <functional>
+#include <span>
 #include <unordered_map>
 #include "emp/base/assert.hpp"
+#include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
 #include "emp/functional/AnyFunction.hpp"
 #include "emp/meta/TypePack.hpp"
@@ -33,6 +37,7 @@ namespace mabe {
     emp::String name;  ///< Human-readable name of an action
     emp::vector<emp::AnyFunction> function_vec; ///< Collection of functions associated with this action
     emp::DataMap data; ///< Generic datamap for any additional data a module wants the organism to have 
+    emp::vector<std::any> typed_func_vec; ///< The same functions as their original std::function types
 
     Action(const emp::String& _name, emp::AnyFunction _func) :
         name(_name),
@@ -45,6 +50,21 @@ namespace mabe {
         function_vec(),
         data(){ ; }
     Action() = default;
+
+    /// Get the functions as std::functions of the given signature, so that callers can skip the
+    /// AnyFunction dispatch.  Returns fewer functions than function_vec if any were added
+    /// without their typed version (e.g., through the constructor).
+    template <typename RETURN, typename... PARAMS>
+    emp::vector<std::function<RETURN(PARAMS...)>> GetTypedFuncs() const {
+      using fun_t = std::function<RETURN(PARAMS...)>;
+      emp::vector<fun_t> out;
+      for (const std::any & fun : typed_func_vec) {
+        const fun_t * fun_ptr = std::any_cast<fun_t>(&fun);
+        emp_assert(fun_ptr, "Action function has a different signature.", name);
+        if (fun_ptr) out.push_back(*fun_ptr);
+      }
+      return out;
+    }
   };
 
   /// \brief An inter-module collection of functions that can be called by organisms. Functions are accessed by their type signature. 
@@ -71,6 +91,7 @@ namespace mabe {
 
       emp::vector<emp::AnyFunction>& action_vec = action.function_vec;
       action_vec.emplace_back(in_func);
+      action.typed_func_vec.emplace_back(in_func);
       return action;
     }
 
@@ -83,5 +104,77 @@ namespace mabe {
     }
   };
 
+  /// \brief A frozen, vector-indexed view of all actions in an ActionMap with one signature.
+  ///
+  /// Build it once after setup; actions then have integer IDs (in name order) and their
+  /// functions are stored contiguously as typed std::functions, so they can be bound or called
+  /// without any hashing or AnyFunction dispatch.  The view refers to the original actions, so
+  /// the ActionMap must outlive it and should not have functions added after it is built.
+  template <typename RETURN, typename... PARAMS>
+  class ActionTable {
+  public:
+    using fun_t = std::function<RETURN(PARAMS...)>;
+
+  private:
+    emp::vector<emp::Ptr<Action>> actions;   ///< Actions, indexed by ID.
+    emp::vector<size_t> func_starts;         ///< Start of each action's functions in func_vec.
+    emp::vector<fun_t> func_vec;             ///< All functions, grouped by action.
+    std::unordered_map<emp::String, size_t> id_map;
+
+  public:
+    ActionTable(ActionMap & action_map) {
+      const emp::TypeID func_type = emp::GetTypeID<RETURN(PARAMS...)>();
+      if (action_map.find(func_type) == action_map.end()) { func_starts.push_back(0); return; }
+
+      emp::vector<emp::String> names;
+      for (auto & [name, action] : action_map.GetFuncs<RETURN, PARAMS...>()) names.push_back(name);
+      std::sort(names.begin(), names.end());
+
+      std::unordered_map<emp::String, Action> & typed_map = action_map.GetFuncs<RETURN, PARAMS...>();
+      for (const emp::String & name : names) {
+        Action & action = typed_map[name];
+        id_map[name] = actions.size();
+        actions.push_back(&action);
+        func_starts.push_back(func_vec.size());
+        emp::vector<fun_t> typed_funcs = action.GetTypedFuncs<RETURN, PARAMS...>();
+        if (typed_funcs.size() == action.function_vec.size()) {
+          for (fun_t & fun : typed_funcs) func_vec.push_back(std::move(fun));
+        }
+        else {  // Some functions were added untyped; call all of them generically.
+          for (emp::AnyFunction & any_fun : action.function_vec) {
+            emp::Ptr<emp::AnyFunction> fun_ptr = &any_fun;
+            func_vec.push_back([fun_ptr](PARAMS... args){
+              return fun_ptr->Call<RETURN, PARAMS...>(std::forward<PARAMS>(args)...);
+            });
+          }
+        }
+      }
+      func_starts.push_back(func_vec.size());
+    }
+
+    size_t GetSize() const { return actions.size(); }
+    bool Has(const emp::String & name) const { return id_map.count(name); }
+
+    /// Return the ID of the named action, or MAX_SIZE_T if there is none.
+    size_t GetID(const emp::String & name) const {
+      auto it = id_map.find(name);
+      return (it == id_map.end()) ? emp::MAX_SIZE_T : it->second;
+    }
+
+    const emp::String & GetName(size_t id) const { return actions[id]->name; }
+    Action & GetAction(size_t id) const { return *actions[id]; }
+    size_t GetNumFuncs(size_t id) const { return func_starts[id+1] - func_starts[id]; }
+
+    /// All functions for an action, in the order they were added.
+    std::span<const fun_t> GetFuncs(size_t id) const {
+      return std::span<const fun_t>(func_vec.data() + func_starts[id], GetNumFuncs(id));
+    }
+
+    /// Run all functions of an action, in order.
+    void CallAll(size_t id, PARAMS... args) const {
+      for (const fun_t & fun : GetFuncs(id)) fun(args...);
+    }
+  };
+
 }
 #endif
@@ -5,14 +5,62 @@
  *
  *  @file  Batch.hpp
  *  @brief Manager for batches of MABE runs.
+ *
+ *  A batch file lists factors and replicates; every combination becomes one run of MABE.
+ *  Keywords:
+ *    config <args>          : Command-line arguments to include in every run.
+ *    factor <name> <opts..> : Variable to try with each option (all combinations are run).
+ *    jobs <N>               : Number of runs to execute at once (default 1; -j overrides).
+ *    log <filename>         : CSV manifest recording the status of every run.
+ *    mabe <executable>      : MABE executable to use for runs.
+ *    replicate <N>          : Number of replicates of each factor combination.
+ *    run_log <pattern>      : File to capture each run's output (variables are substituted).
+ *    set <name> <value>     : Set a variable to use in ${name} substitutions.
+ *    skip_if_exists <pattern> : Skip runs whose output file already exists (to resume a batch).
+ *
+ *  Early stopping (local backend):
+ *    stop_watch <pattern> <column> : CSV file written by each run, and the column to watch.
+ *    stop_patience <N>      : Stop a run once the column has not improved for N updates.
+ *    stop_target <value>    : Stop a run once the column reaches value.
+ *
+ *  While a watched run executes, the batch reads new rows of its CSV file every few seconds.
+ *  Progress is measured with the file's "update" column, if it has one (otherwise by rows).
+ *  When the policy is met, the batch creates the run's stop file (passed to MABE with
+ *  --stop_file), and the run exits cleanly at the start of its next update, freeing its job
+ *  slot for a pending run.
+ *
+ *  Cluster runs (SLURM job arrays):
+ *    backend <local|slurm>  : Run on this machine (default) or as a SLURM job array.
+ *    slurm <option>         : Extra #SBATCH option for each task (e.g., --time=4:00:00).
+ *    script_dir <dir>       : Where SLURM scripts, task output, and status go (default batch_slurm).
+ *    submit <yes|no>        : Submit the job array with sbatch, or only write the scripts.
+ *
+ *  For SLURM, script_dir/runs.csv lists each task (task,seed,run_log,output,command); each
+ *  task writes its exit status to script_dir/status/, and a final job (run after the whole
+ *  array) collects them into script_dir/status.csv (task,status).
  */
 
 #ifndef MABE_BATCH_HPP
 #define MABE_BATCH_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#endif
+
 #include "emp/base/vector.hpp"
 #include "emp/base/notify.hpp"
 #include "emp/io/File.hpp"
@@ -28,6 +76,26 @@ namespace mabe {
       FactorInfo(const emp::String & _name) : name(_name) { }
     };
 
+    /// Details about a single run in the batch.
+    struct RunInfo {
+      int seed = 0;
+      emp::String command;   ///< Full command line, with variables substituted.
+      emp::String run_log;   ///< File to capture run output (empty to use the console).
+      emp::String output;    ///< File whose existence means the run is already done.
+      emp::String watch_file; ///< CSV file to watch for early stopping (if any).
+      int status = 0;        ///< Exit status of the run.
+      bool skipped = false;  ///< Was this run skipped since its output already exists?
+      bool stopped = false;  ///< Was this run stopped early by the stopping policy?
+    };
+
+    /// Progress of a watched run: the best value seen and when it was reached.
+    struct WatchState {
+      size_t rows_read = 0;
+      double best = -std::numeric_limits<double>::infinity();
+      double best_update = 0.0;
+      double last_update = 0.0;
+    };
+
     emp::File batch_file;
     emp::String exe_name;
 
@@ -35,6 +103,21 @@ namespace mabe {
     emp::vector<FactorInfo> factors;          ///< Set of factors to combinatorically vary.
     emp::String log_file;                     ///< Where should run details be saved?
     int replicates = 1;                       ///< How many replicates of each factor combination?
+    size_t num_jobs = 1;                      ///< How many runs should be executed at once?
+    emp::String run_log_pattern;              ///< Per-run output capture file (if any).
+    emp::String output_pattern;               ///< Output file whose existence skips a run.
+
+    emp::String stop_watch_pattern;           ///< CSV file to watch in each run (if any).
+    emp::String stop_column;                  ///< Column of the watched file to track.
+    double stop_patience = 0.0;               ///< Updates without improvement before stopping.
+    bool has_stop_target = false;             ///< Should runs stop at stop_target?
+    double stop_target = 0.0;                 ///< Value of stop_column that ends a run.
+    static constexpr size_t STOP_POLL_MS = 2000;  ///< How often to read watched files.
+
+    emp::String backend = "local";            ///< Where to run: "local" or "slurm"
+    emp::vector<emp::String> slurm_options;   ///< Extra #SBATCH lines for each task.
+    emp::String script_dir = "batch_slurm";   ///< Directory for cluster scripts and status.
+    bool submit = true;                       ///< Should cluster jobs be submitted right away?
 
     std::unordered_map<emp::String, emp::String> var_set; ///< Variable to use in script.
 
@@ -66,6 +149,295 @@ namespace mabe {
       return true;
     }
 
+    /// Convert a raw result from std::system() into an exit status.
+    static int DecodeStatus(int raw_status) {
+#if defined(WIFEXITED)
+      if (WIFEXITED(raw_status)) return WEXITSTATUS(raw_status);
+      return -1;  // Killed by a signal.
+#else
+      return raw_status;
+#endif
+    }
+
+    /// Expand all factor combinations and replicates into the full list of runs.
+    emp::vector<RunInfo> BuildRuns() {
+      emp::vector<RunInfo> runs;
+      int seed = 1;  // Seeds start at 1 and work their way up.
+
+      // Loop through combinations of factors.
+      emp::vector<size_t> ids(factors.size());
+      for (auto & x : ids) x = 0;
+
+      while (true) {
+        // Set variables using the current factors.
+        for (size_t i = 0; i < ids.size(); ++i) {
+          var_set[factors[i].name] = factors[i].options[ids[i]];
+        }
+
+        // Generate the base run string.
+        std::stringstream ss;
+        ss << exe_name;
+        for (const emp::String & option : config_options) {
+          ss << " " << option;
+        }
+        ss << " -s random_seed=${seed}";
+
+        // Do all replicates in this treatment.
+        for (int i = 0; i < replicates; ++i) {
+          RunInfo run;
+          run.seed = seed++;
+          var_set["seed"] = emp::MakeString(run.seed);
+
+          // Substitute in variables.
+          run.command = ss.str();
+          run.command.ReplaceVars(var_set);
+          run.run_log = run_log_pattern;
+          run.run_log.ReplaceVars(var_set);
+          run.output = output_pattern;
+          run.output.ReplaceVars(var_set);
+          run.watch_file = stop_watch_pattern;
+          run.watch_file.ReplaceVars(var_set);
+          runs.push_back(run);
+        }
+
+        // Move on to the next factors.
+        size_t inc_pos = 0;
+        while(inc_pos < factors.size() && ++ids[inc_pos] == factors[inc_pos].options.size()) {
+          ids[inc_pos++] = 0; // Reset the current factor and move to the next.
+        }
+        if (inc_pos == factors.size()) break; // We've gone through all factors!
+      }
+
+      return runs;
+    }
+
+    bool IsStopping() const {
+      return stop_watch_pattern.size() && (stop_patience > 0.0 || has_stop_target);
+    }
+
+    /// Split a CSV line into fields, dropping surrounding quotes and spaces.
+    static emp::vector<emp::String> SplitCSV(const std::string & line) {
+      emp::vector<emp::String> fields;
+      std::stringstream ss(line);
+      std::string field;
+      while (std::getline(ss, field, ',')) {
+        const size_t start = field.find_first_not_of(" \t\r\"");
+        const size_t end = field.find_last_not_of(" \t\r\"");
+        fields.push_back(start == std::string::npos ? "" : field.substr(start, end - start + 1));
+      }
+      return fields;
+    }
+
+    /// Read any new complete rows of a run's watched file; return true if it should stop.
+    bool CheckStop(const emp::String & filename, WatchState & state) const {
+      std::ifstream file(filename.str());
+      std::string line;
+      if (!file || !std::getline(file, line) || file.eof()) return false;
+      const emp::vector<emp::String> header = SplitCSV(line);
+      const size_t value_col = std::find(header.begin(), header.end(), stop_column) - header.begin();
+      const size_t update_col = std::find(header.begin(), header.end(), "update") - header.begin();
+      if (value_col == header.size()) return false;  // Column not written yet.
+
+      for (size_t row = 1; std::getline(file, line) && !file.eof(); ++row) {  // Skip partial lines.
+        if (row <= state.rows_read) continue;
+        state.rows_read = row;
+        const emp::vector<emp::String> fields = SplitCSV(line);
+        if (value_col >= fields.size()) continue;
+        const double value = std::strtod(fields[value_col].c_str(), nullptr);
+        const double update = (update_col < fields.size())
+                            ? std::strtod(fields[update_col].c_str(), nullptr) : (double) row;
+        if (value > state.best) { state.best = value; state.best_update = update; }
+        state.last_update = update;
+        if (has_stop_target && value >= stop_target) return true;
+      }
+      return stop_patience > 0.0 && state.rows_read > 0
+          && state.last_update - state.best_update >= stop_patience;
+    }
+
+    /// Run a single job (blocking until it finishes).  With a stopping policy, watch the run's
+    /// output and create its stop file once the policy is met.
+    void ExecuteRun(RunInfo & run) const {
+      namespace fs = std::filesystem;
+      emp::String exe_string = run.command;
+      emp::String stop_file;
+      if (IsStopping()) {
+        stop_file = run.watch_file + ".stop";
+        fs::remove(stop_file.str());
+        exe_string += emp::MakeString(" --stop_file \"", stop_file, "\"");
+      }
+      if (run.run_log.size()) {
+        const fs::path log_dir = fs::path(run.run_log.str()).parent_path();
+        if (!log_dir.empty()) fs::create_directories(log_dir);
+        exe_string += emp::MakeString(" > \"", run.run_log, "\" 2>&1");
+      }
+      if (!IsStopping()) {
+        run.status = DecodeStatus(std::system(exe_string.c_str()));
+        return;
+      }
+
+      std::atomic<bool> done{false};
+      std::thread watcher([this, &run, &done, &stop_file](){
+        const auto start_time = fs::file_time_type::clock::now();
+        WatchState state;
+        while (!done) {
+          for (size_t ms = 0; ms < STOP_POLL_MS && !done; ms += 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          }
+          // Ignore files left from an earlier run until this run rewrites them.
+          std::error_code ec;
+          const auto mod_time = fs::last_write_time(run.watch_file.str(), ec);
+          if (done || ec || mod_time < start_time) continue;
+          if (CheckStop(run.watch_file, state)) {
+            std::ofstream(stop_file.str()) << "stop\n";
+            run.stopped = true;
+            return;
+          }
+        }
+      });
+      run.status = DecodeStatus(std::system(exe_string.c_str()));
+      done = true;
+      watcher.join();
+      fs::remove(stop_file.str());
+    }
+
+    /// Execute all runs, keeping up to num_jobs running at once.
+    void ExecuteRuns(emp::vector<RunInfo> & runs) {
+      std::atomic<size_t> next_run{0};
+      std::mutex print_mutex;
+      auto worker = [&](){
+        for (size_t id = next_run++; id < runs.size(); id = next_run++) {
+          RunInfo & run = runs[id];
+          if (run.output.size() && std::filesystem::exists(run.output.str())) {
+            run.skipped = true;
+            std::lock_guard<std::mutex> lock(print_mutex);
+            emp::notify::Message("BATCH SKIP (output exists): ", run.output);
+            continue;
+          }
+          {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            emp::notify::Message("BATCH COMMAND: ", run.command);
+          }
+          ExecuteRun(run);
+        }
+      };
+
+      const size_t num_threads = std::max<size_t>(1, std::min(num_jobs, runs.size()));
+      if (num_threads == 1) { worker(); return; }
+      emp::vector<std::thread> threads;
+      for (size_t i = 0; i < num_threads; ++i) threads.emplace_back(worker);
+      for (auto & thread : threads) thread.join();
+    }
+
+    /// Run a command and return the first line of its output (empty if it failed).
+    static emp::String CaptureOutput(const emp::String & command) {
+      emp::String out;
+#if defined(__unix__) || defined(__APPLE__)
+      if (FILE * pipe = popen(command.c_str(), "r")) {
+        char buffer[256];
+        if (fgets(buffer, sizeof(buffer), pipe)) out = buffer;
+        if (DecodeStatus(pclose(pipe)) != 0) out = "";
+      }
+#endif
+      while (out.size() && (out.back() == '\n' || out.back() == '\r')) out.pop_back();
+      return out;
+    }
+
+    /// Write a SLURM job array (one task per run not already done) and, if requested, submit
+    /// it along with a follow-up job that collects task statuses.
+    void RunSlurm(emp::vector<RunInfo> & runs) {
+      namespace fs = std::filesystem;
+      fs::create_directories(fs::path(script_dir.str()) / "status");
+
+      std::ofstream runs_file((fs::path(script_dir.str()) / "runs.txt").string());
+      std::ofstream table_file((fs::path(script_dir.str()) / "runs.csv").string());
+      table_file << "task,seed,run_log,output,command\n";
+      size_t num_tasks = 0;
+      for (RunInfo & run : runs) {
+        if (run.output.size() && fs::exists(run.output.str())) { run.skipped = true; continue; }
+        ++num_tasks;
+        emp::String exe_string = run.command;
+        if (run.run_log.size()) {
+          const fs::path log_dir = fs::path(run.run_log.str()).parent_path();
+          if (!log_dir.empty()) fs::create_directories(log_dir);
+          exe_string += emp::MakeString(" > \"", run.run_log, "\" 2>&1");
+        }
+        runs_file << exe_string << '\n';
+        table_file << num_tasks << ',' << run.seed << ',' << emp::MakeLiteral(run.run_log) << ','
+                   << emp::MakeLiteral(run.output) << ',' << emp::MakeLiteral(run.command) << '\n';
+      }
+      emp::notify::Message("BATCH: ", num_tasks, " SLURM tasks (", runs.size() - num_tasks,
+                           " skipped) written to '", script_dir, "'.");
+      if (num_tasks == 0) return;
+
+      const emp::String array_script = (fs::path(script_dir.str()) / "array.sbatch").string();
+      std::ofstream array_file(array_script.str());
+      array_file << "#!/bin/bash\n"
+                 << "#SBATCH --job-name=mabe_batch\n"
+                 << "#SBATCH --array=1-" << num_tasks;
+      if (num_jobs > 1) array_file << "%" << num_jobs;   // Limit simultaneous tasks.
+      array_file << "\n#SBATCH --output=" << script_dir << "/task_%a.out\n";
+      for (const emp::String & option : slurm_options) array_file << "#SBATCH " << option << "\n";
+      array_file << "CMD=$(sed -n \"${SLURM_ARRAY_TASK_ID}p\" \"" << script_dir << "/runs.txt\")\n"
+                 << "bash -c \"$CMD\"\n"
+                 << "STATUS=$?\n"
+                 << "echo \"${SLURM_ARRAY_TASK_ID},${STATUS}\" > \"" << script_dir
+                 << "/status/task_${SLURM_ARRAY_TASK_ID}.csv\"\n"
+                 << "exit $STATUS\n";
+      array_file.close();
+
+      const emp::String collect_script = (fs::path(script_dir.str()) / "collect.sbatch").string();
+      std::ofstream collect_file(collect_script.str());
+      collect_file << "#!/bin/bash\n"
+                   << "#SBATCH --job-name=mabe_collect\n"
+                   << "#SBATCH --output=" << script_dir << "/collect.out\n"
+                   << "(echo task,status; cat \"" << script_dir << "\"/status/task_*.csv | sort -t, -n -k1)"
+                   << " > \"" << script_dir << "/status.csv\"\n";
+      collect_file.close();
+
+      if (!submit) {
+        emp::notify::Message("BATCH: submit with 'sbatch ", array_script, "'.");
+        return;
+      }
+      const emp::String job_id = CaptureOutput(emp::MakeString("sbatch --parsable \"", array_script, "\""));
+      if (job_id.empty()) {
+        emp::notify::Error("Unable to submit SLURM job array '", array_script, "'.");
+        return;
+      }
+      emp::notify::Message("BATCH: submitted SLURM job array ", job_id, ".");
+      const emp::String collect_id = CaptureOutput(emp::MakeString(
+        "sbatch --parsable --dependency=afterany:", job_id, " \"", collect_script, "\""));
+      if (collect_id.empty()) emp::notify::Error("Unable to submit SLURM collection job.");
+    }
+
+    /// Print a summary of the batch and record each run in the log file (if one was given).
+    void ReportRuns(const emp::vector<RunInfo> & runs) {
+      size_t num_skipped = 0;
+      emp::vector<const RunInfo *> failed;
+      size_t num_stopped = 0;
+      for (const RunInfo & run : runs) {
+        if (run.skipped) ++num_skipped;
+        else if (run.status != 0) failed.push_back(&run);
+        num_stopped += run.stopped;
+      }
+      emp::notify::Message("BATCH COMPLETE: ", runs.size() - num_skipped - failed.size(),
+                           " succeeded, ", failed.size(), " failed, ", num_skipped, " skipped.");
+      if (IsStopping()) emp::notify::Message("  ", num_stopped, " runs were stopped early.");
+      for (const RunInfo * run : failed) {
+        emp::notify::Message("  FAILED (status ", run->status, "): ", run->command,
+                             run->run_log.size() ? emp::MakeString(" [log: ", run->run_log, "]") : "");
+      }
+
+      if (log_file.size()) {
+        std::ofstream log(log_file.str());
+        log << "seed,status,skipped,stopped,run_log,output,command\n";
+        for (const RunInfo & run : runs) {
+          log << run.seed << ',' << run.status << ',' << run.skipped << ',' << run.stopped << ','
+              << emp::MakeLiteral(run.run_log) << ',' << emp::MakeLiteral(run.output) << ','
+              << emp::MakeLiteral(run.command) << '\n';
+        }
+      }
+    }
+
   public:
     Batch(const emp::String & filename, const emp::String & _exe_name) 
     : batch_file(filename), exe_name(_exe_name) {
@@ -73,16 +445,29 @@ namespace mabe {
       batch_file.CompressWhitespace();
     }
 
+    /// Override the number of concurrent runs (e.g., from the command line).
+    void SetNumJobs(size_t in_jobs) { num_jobs = in_jobs; }
+
     void Process() {
       // Loop through batch file, processing line-by-line.
       for (emp::String line : batch_file) {
         emp::String keyword = line.PopWord();
-        if (keyword == "config") {               // Set a config options on command line
+        if (keyword == "backend") {              // Where should runs be executed?
+          Require(line.size(), "'backend' must specify 'local' or 'slurm'.");
+          backend = line.PopWord();
+          Require(backend == "local" || backend == "slurm",
+                  "'backend' must be 'local' or 'slurm', not '", backend, "'.");
+        } else if (keyword == "config") {        // Set a config options on command line
           Require(line.size(), "'config' must specify option to include.");
           config_options.push_back(line);
         } else if (keyword == "factor") {        // A range of variables to try in all combinations
           bool result = Process_Factor(line);
           if (!result) return;
+        } else if (keyword == "jobs") {          // How many runs at once?
+          Require(line.size(), "'jobs' must specify the number of concurrent runs.");
+          const int jobs = line.PopSigned();
+          Require(jobs > 0, "'jobs' must be at least 1.");
+          num_jobs = (size_t) jobs;
         } else if (keyword == "log") {      // A file to log output of runs
           Require(line.size(), "'log' must specify filename.");
           log_file = line.PopWord();
@@ -95,6 +480,35 @@ namespace mabe {
           Require(line.size(), "'replicate' must specify number of replicates.");
           replicates = line.PopSigned();;
           Require(!line.size(), "Only one value should be specified in 'replicate'; text follows '", replicates, "'.");
+        } else if (keyword == "run_log") {       // Capture run output into these files
+          Require(line.size(), "'run_log' must specify a filename pattern.");
+          run_log_pattern = line.PopWord();
+        } else if (keyword == "skip_if_exists") { // Resume: skip runs with existing output
+          Require(line.size(), "'skip_if_exists' must specify a filename pattern.");
+          output_pattern = line.PopWord();
+        } else if (keyword == "script_dir") {    // Where to put cluster scripts
+          Require(line.size(), "'script_dir' must specify a directory.");
+          script_dir = line.PopWord();
+        } else if (keyword == "slurm") {         // Extra option for SLURM tasks
+          Require(line.size(), "'slurm' must specify an sbatch option.");
+          slurm_options.push_back(line);
+        } else if (keyword == "stop_watch") {    // File and column that early stopping tracks
+          Require(line.size(), "'stop_watch' must specify a filename pattern and a column.");
+          stop_watch_pattern = line.PopWord();
+          Require(line.size(), "'stop_watch' must specify which column to watch.");
+          stop_column = line.PopWord();
+        } else if (keyword == "stop_patience") { // Updates without improvement before stopping
+          Require(line.size(), "'stop_patience' must specify a number of updates.");
+          stop_patience = std::strtod(line.PopWord().c_str(), nullptr);
+          Require(stop_patience > 0.0, "'stop_patience' must be positive.");
+        } else if (keyword == "stop_target") {   // Value that ends a run
+          Require(line.size(), "'stop_target' must specify a value.");
+          stop_target = std::strtod(line.PopWord().c_str(), nullptr);
+          has_stop_target = true;
+        } else if (keyword == "submit") {        // Submit cluster jobs, or just write scripts?
+          const emp::String setting = line.PopWord();
+          Require(setting == "yes" || setting == "no", "'submit' must be 'yes' or 'no'.");
+          submit = (setting == "yes");
         } else if (keyword == "set") {           // Set a local variable value
           Require(line.size(), "'set' must specify variable name and value to set to.");
           emp::String var = line.PopWord();
@@ -116,47 +530,19 @@ namespace mabe {
         emp::notify::Message("  ", factor.name, " with ", factor.options.size(), " options.");
       }
 
-      int seed = 1;  // Seeds start at 1 and work their way up.
-
-      // Loop through combinations of factors.
-      emp::vector<size_t> ids(factors.size());
-      for (auto & x : ids) x = 0;
-
-      while (true) {
-        // Set variables using the current factors.
-        for (size_t i = 0; i < ids.size(); ++i) {
-          var_set[factors[i].name] = factors[i].options[ids[i]];
-        }
-
-        // Generate the base run string.
-        std::stringstream ss;
-        ss << exe_name;
-        for (const emp::String & option : config_options) {
-          ss << " " << option;
-        }
-        ss << " -s random_seed={$seed}";
-
-        // Do all replicates in this treatment.
-        for (int i = 0; i < replicates; ++i) {
-          // Prep the random seed.
-          var_set["seed"] = seed++;
-
-          // Substitute in variables.
-          emp::String exe_string(ss.str());
-          exe_string.ReplaceVars(var_set);
-
-          // And run the executable
-          emp::notify::Message("BATCH COMMAND: ", exe_string);
-          std::system(exe_string.c_str());
-        }
+      if (num_jobs > 1 && backend == "local") emp::notify::Message("Running up to ", num_jobs, " jobs at once.");
+      if (stop_watch_pattern.size() && !IsStopping()) {
+        emp::notify::Warning("'stop_watch' needs 'stop_patience' or 'stop_target' to stop runs.");
+      }
 
-        // Move on to the next factors.
-        size_t inc_pos = 0;
-        while(inc_pos < factors.size() && ++ids[inc_pos] == factors[inc_pos].options.size()) {
-          ids[inc_pos++] = 0; // Reset the current factor and move to the next.
-        }
-        if (inc_pos == factors.size()) break; // We've gone through all factors!
+      emp::vector<RunInfo> runs = BuildRuns();
+      if (backend == "slurm") {
+        if (IsStopping()) emp::notify::Warning("Early stopping is only available for local batches.");
+        RunSlurm(runs);
+        return;
       }
+      ExecuteRuns(runs);
+      ReportRuns(runs);
     }
   };
 
@@ -0,0 +1,137 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Builder.hpp
+ *  @brief Typed C++ interface for setting up a MABE run without a config file.
+ *  @note Status: ALPHA
+ *
+ *  Custom drivers (like build/MABE.cpp) can use a Builder in place of a config script:
+ *
+ *    mabe::MABE control(argc, argv);
+ *    control.SetupEmpty<mabe::EmptyOrganismManager>();
+ *    mabe::Builder builder(control);
+ *    auto & main_pop = builder.AddPopulation("main_pop");
+ *    auto & next_pop = builder.AddPopulation("next_pop");
+ *    auto & orgs = builder.AddOrgType<mabe::BitsOrg>("bits_org");
+ *    auto & nk = builder.AddModule<mabe::EvalNK>("eval_nk");
+ *    auto & elite = builder.AddModule<mabe::SelectElite>("select_elite");
+ *    builder.Set(nk, "N", 100).Set(nk, "K", 3).Set(elite, "top_count", 10);
+ *    builder.OnUpdate([&](size_t){
+ *      nk.Evaluate(main_pop);
+ *      elite.Select(main_pop, next_pop, 1000);
+ *      control.MoveOrgs(next_pop, main_pop, true);
+ *    });
+ *    if (!builder.Setup()) return 1;
+ *    control.Inject(main_pop, orgs.GetName(), 1000);
+ *    control.Update(1000);
+ *
+ *  Modules are built through the same types as in a config file, so they get the same
+ *  settings and defaults; the update step, though, is plain C++ calling module member
+ *  functions directly, with no equation parsing, symbol lookup, or value boxing.
+ *  Settings are checked once, when set: the value must be numeric for a numeric setting and
+ *  a string (or a Population, for population settings) otherwise.
+ */
+
+#ifndef MABE_BUILDER_HPP
+#define MABE_BUILDER_HPP
+
+#include <functional>
+#include <type_traits>
+
+#include "emp/base/notify.hpp"
+#include "emp/meta/TypeID.hpp"
+#include "emp/tools/String.hpp"
+
+#include "MABE.hpp"
+#include "OrganismManager.hpp"
+#include "Population.hpp"
+
+namespace mabe {
+
+  class Builder {
+  private:
+    MABE & control;
+
+    emplode::SymbolTable & GetTable() { return control.GetConfigScript().GetSymbolTable(); }
+    emplode::Symbol_Scope & GetRoot() { return GetTable().GetRootScope(); }
+
+    /// Build a named object of a type known to the config, in the global scope.
+    template <typename T>
+    T & MakeObject(const emp::String & name) {
+      emp_assert(GetTable().HasTypeID(emp::GetTypeID<T>()),
+                 "Type must be registered (e.g., with MABE_REGISTER_MODULE) to be built.");
+      emplode::Symbol_Object & symbol = GetTable().MakeObjSymbol(emp::GetTypeID<T>(), name, GetRoot());
+      return *symbol.GetObjectPtr().DynamicCast<T>();
+    }
+
+    template <typename T>
+    void SetSymbol(emplode::Symbol_Scope & scope, const emp::String & setting, const T & value) {
+      static_assert(std::is_arithmetic_v<T> || std::is_convertible_v<T, emp::String>,
+                    "Settings must be given a number or a string.");
+      emp::Ptr<emplode::Symbol> symbol = scope.GetSymbol(setting);
+      if (!symbol) {
+        emp::notify::Error("'", scope.GetName(), "' has no setting '", setting, "'.");
+      }
+      else if constexpr (std::is_arithmetic_v<T>) {
+        if (symbol->IsNumeric()) symbol->SetValue((double) value);
+        else emp::notify::Error("Setting '", scope.GetName(), ".", setting, "' is not numeric.");
+      }
+      else {
+        if (symbol->IsString()) symbol->SetString(emp::String(value));
+        else emp::notify::Error("Setting '", scope.GetName(), ".", setting, "' is not a string.");
+      }
+    }
+
+  public:
+    Builder(MABE & in_control) : control(in_control) { }
+
+    MABE & GetControl() { return control; }
+
+    Population & AddPopulation(const emp::String & name) { return MakeObject<Population>(name); }
+
+    /// Add a module of a registered type, configured by its defaults until settings are changed.
+    template <typename MOD_T>
+    MOD_T & AddModule(const emp::String & name) {
+      static_assert(std::is_base_of_v<ModuleBase, MOD_T>, "AddModule() requires a module type.");
+      return MakeObject<MOD_T>(name);
+    }
+
+    /// Add a manager for a registered organism type (e.g., AddOrgType<BitsOrg>("bits_org")).
+    template <typename ORG_T>
+    OrganismManager<ORG_T> & AddOrgType(const emp::String & name) {
+      return MakeObject<OrganismManager<ORG_T>>(name);
+    }
+
+    /// Change a module's setting (by its config name); returns this builder for chaining.
+    template <typename T>
+    Builder & Set(ModuleBase & mod, const emp::String & setting, const T & value) {
+      SetSymbol(mod.AsScope(), setting, value);
+      return *this;
+    }
+    Builder & Set(ModuleBase & mod, const emp::String & setting, const Population & pop) {
+      SetSymbol(mod.AsScope(), setting, pop.GetName());
+      return *this;
+    }
+
+    /// Change a global setting such as "random_seed" or "num_threads".
+    template <typename T>
+    Builder & SetGlobal(const emp::String & setting, const T & value) {
+      SetSymbol(GetRoot(), setting, value);
+      return *this;
+    }
+
+    /// Run 'fun' every update (given the update number), after all modules have updated.
+    Builder & OnUpdate(std::function<void(size_t)> fun) {
+      control.AddUpdateFun(fun);
+      return *this;
+    }
+
+    /// Finish setup (command-line arguments, module setup, and trait checks); false to exit.
+    bool Setup() { return control.Setup(); }
+  };
+
+}
+
+#endif
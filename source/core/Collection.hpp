@@ -31,11 +31,16 @@
  *  .Insert(item) will allow you to insert an organism position, a populaiton, or another
  *  collection into this collection.
  * 
- *  .Clear() empties this collection.
+ *  .Clear() empties this collection; .Reset() does too, but keeps its storage for reuse
+ *  (see CollectionPool, at the end of this file).
  * 
- *  Collections can also be modified with |= (or, equivalently +=) or &=.
+ *  Collections can also be modified with |= (or, equivalently +=), &=, or -=.
+ * 
+ *  .GatherTrait(trait_id, out) or .ScatterTrait(trait_id, in) copy one trait between the
+ *  organisms and a flat array, in collection order.
  * 
  *  .GetAlive() returns a new collection with just the living organisms from this one.
+ *  .CountAlive() and .ForEachAlive(fun) count or visit those organisms without building one.
  * 
  *  -- Usage in MABEScript --
  *   Collections have various MABEScript member functions:
@@ -48,20 +53,29 @@
  *  -- Implementation --
  *  Internally, a Collection is represented by a map; keys are pointers to the included Populations
  *  and values are a PopInfo class (a flag for "do we included the whole population" and a
- *  BitVector indicating the positions that are included if not the whole population).
+ *  BitVector indicating the positions that are included if not the whole population).  The map
+ *  is a sorted vector, since most collections hold only one or two populations.
+ *
+ *  Each PopInfo also builds (on demand) a list of its included positions, so At() and
+ *  IteratorAt() find an organism by index in constant time rather than scanning the BitVector.
+ *  The list is rebuilt on the first lookup after the positions change; since that lookup
+ *  modifies the collection, the first At() after a change should not race with other threads.
  * 
  *  A CollectionIterator will track the current population being iterated through, and the position
  *  currently indicated.  When an iterator reached the end, it's population pointer is set to 
  *  nullptr.
  * 
  *  -- TODO ---
- *  + Add a Remove() function.
+ *  + Add Remove() for single positions and populations.
  */
 
 #ifndef MABE_COLLECTION_H
 #define MABE_COLLECTION_H
 
+#include <algorithm>
+#include <mutex>
 #include <set>
+#include <span>
 #include <sstream>
 
 #include "emp/base/Ptr.hpp"
@@ -87,12 +101,13 @@ namespace mabe {
     using base_t =
       OrgIterator_Interface<DERIVED_T, ORG_T, emp::match_const_t<Population,COLLECTION_T>>;
     using this_t = CollectionIterator_Interface<DERIVED_T, ORG_T>;
+    friend base_t;
 
-    void IncPosition() override;
-    void DecPosition() override;
-    void ShiftPosition(int shift=1) override;
-    void ToBegin() override;
-    void ToEnd() override;
+    void IncPosition();
+    void DecPosition();
+    void ShiftPosition(int shift=1);
+    void ToBegin();
+    void ToEnd();
 
   public:
     /// Constructor where you can optionally supply population pointer and position.
@@ -166,6 +181,12 @@ namespace mabe {
       bool is_mutable = false; ///< Are we allowed to change this population?
       emp::BitVector pos_set;  ///< Which positions are we using for this population?
 
+      mutable emp::vector<uint32_t> pos_index; ///< Included positions, in order (when built).
+      mutable bool index_ok = false;           ///< Does pos_index match pos_set?
+
+      /// Access pos_set for modification; the position index will need to be rebuilt.
+      emp::BitVector & EditPosSet() { index_ok = false; return pos_set; }
+
       /// Identify how many positions we have.
       size_t GetSize(pop_ptr_t pop_ptr) const {
         if (full_pop) return pop_ptr->GetSize();
@@ -187,16 +208,24 @@ namespace mabe {
         return (size_t) pos_set.FindOne(pos+1);
       }
 
+      /// Included positions, in order (building the index if needed); not for full populations.
+      std::span<const uint32_t> GetPositions() const {
+        emp_assert(!full_pop);
+        if (!index_ok) {
+          pos_index.resize(0);
+          for (int pos = pos_set.FindOne(); pos != -1; pos = pos_set.FindOne(pos+1)) {
+            pos_index.push_back((uint32_t) pos);
+          }
+          index_ok = true;
+        }
+        return std::span<const uint32_t>(pos_index.data(), pos_index.size());
+      }
+
       /// Remap an ID from the collection to a population position.
-      size_t GetPos(size_t org_id) {
+      size_t GetPos(size_t org_id) const {
         if (full_pop) return org_id;
-
-        size_t cur_pos = pos_set.FindOne();
-        while(org_id) {
-          org_id--;
-          cur_pos = pos_set.FindOne(cur_pos+1);
-        }
-        return cur_pos;
+        emp_assert(org_id < GetPositions().size(), org_id, pos_index.size());
+        return GetPositions()[org_id];
       }
 
       /// Insert a single position into the pos_set.
@@ -204,31 +233,111 @@ namespace mabe {
         if (full_pop) return;
         // Make sure we have room for this position and then set it.
         if (pos_set.GetSize() <= pos) pos_set.Resize(pos+1);
-        pos_set.Set(pos);
+        EditPosSet().Set(pos);
       }
 
       /// Shift this population to using the pos_set.
       void RemoveFull(pop_ptr_t pop_ptr) {
         if (!full_pop) return;              // Already not a full population.
         pos_set.Resize(pop_ptr->GetSize()); // Resize position set to have room for all positions.
-        pos_set.SetAll();                   // Initially include all orgs.
+        EditPosSet().SetAll();              // Initially include all orgs.
         full_pop = false;                   // Record that pop is no longer officially full.
       }
 
-      bool IsEmpty(pop_ptr_t pop_ptr) {
+      bool IsEmpty(pop_ptr_t pop_ptr) const {
         if (full_pop) return pop_ptr->IsEmpty();
-        size_t cur_pos = 0;
-        while(cur_pos < pop_ptr->GetSize()) {
-          cur_pos = pos_set.FindOne(cur_pos+1);
-          if (!pop_ptr->IsEmpty()) return false;
+        for (int pos = pos_set.FindOne(); pos != -1; pos = pos_set.FindOne(pos+1)) {
+          if (pop_ptr->IsOccupied((size_t) pos)) return false;
         }
         return true;
       }
     };
 
+    /// Map from population pointers to their PopInfo, kept as a vector sorted by pointer
+    /// (the same order a std::map would use) to avoid allocating a node per population.
+    class PopMap {
+    private:
+      using entry_t = std::pair<pop_ptr_t, PopInfo>;
+      emp::vector<entry_t> entries;
+      emp::vector<entry_t> spare;   ///< Entries removed by reset(), kept for their storage.
+
+      static bool KeyLess(const entry_t & entry, const pop_ptr_t & key) { return entry.first < key; }
+
+      /// Build an empty entry for a population, reusing spare storage (its own, if possible).
+      entry_t MakeEntry(const pop_ptr_t & key) {
+        if (spare.empty()) return entry_t{key, PopInfo{}};
+        auto spare_it = std::find_if(spare.begin(), spare.end(),
+                                     [&key](const entry_t & entry){ return entry.first == key; });
+        if (spare_it == spare.end()) spare_it = spare.end() - 1;
+        entry_t entry = std::move(*spare_it);
+        if (spare_it != spare.end() - 1) *spare_it = std::move(spare.back());
+        spare.pop_back();
+
+        // Position bits are only kept for the same population, and only if it has not shrunk.
+        PopInfo & info = entry.second;
+        info.full_pop = false;
+        info.is_mutable = false;
+        if (entry.first == key && info.pos_set.GetSize() <= key->GetSize()) info.pos_set.Clear();
+        else info.pos_set.Resize(0);
+        info.pos_index.resize(0);
+        info.index_ok = false;
+        entry.first = key;
+        return entry;
+      }
+
+    public:
+      PopMap() = default;
+      PopMap(const PopMap & in) : entries(in.entries) { }   // Spare storage is not copied.
+      PopMap(PopMap &&) = default;
+      PopMap & operator=(const PopMap & in) {   // Fill from spare storage where possible.
+        if (this == &in) return *this;
+        reset();
+        for (const entry_t & entry : in.entries) {
+          entries.push_back(MakeEntry(entry.first));
+          entries.back().second = entry.second;
+        }
+        return *this;
+      }
+      PopMap & operator=(PopMap &&) = default;
+
+      using iterator = typename emp::vector<entry_t>::iterator;
+      using const_iterator = typename emp::vector<entry_t>::const_iterator;
+
+      iterator begin() { return entries.begin(); }
+      iterator end() { return entries.end(); }
+      const_iterator begin() const { return entries.begin(); }
+      const_iterator end() const { return entries.end(); }
+      size_t size() const { return entries.size(); }
+      void clear() { entries.clear(); spare.clear(); }
+
+      /// Remove all entries, but keep their storage to reuse for the next ones added.
+      void reset() {
+        for (entry_t & entry : entries) spare.push_back(std::move(entry));
+        entries.resize(0);
+      }
+
+      iterator find(const pop_ptr_t & key) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, KeyLess);
+        return (it != entries.end() && it->first == key) ? it : entries.end();
+      }
+      const_iterator find(const pop_ptr_t & key) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, KeyLess);
+        return (it != entries.end() && it->first == key) ? it : entries.end();
+      }
+
+      /// Find the info for a population, adding (empty) info if it is not already here.
+      PopInfo & operator[](const pop_ptr_t & key) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, KeyLess);
+        if (it == entries.end() || it->first != key) it = entries.insert(it, MakeEntry(key));
+        return it->second;
+      }
+
+      iterator erase(iterator it) { return entries.erase(it); }
+    };
+
     // Link each population in the collection (by its pointer) to info about which organisms
     // are included.
-    using pos_map_t = std::map<pop_ptr_t, PopInfo>;
+    using pos_map_t = PopMap;
     pos_map_t pos_map;
 
     // Helper Functions
@@ -245,6 +354,17 @@ namespace mabe {
       return pos_map.find(pop_ptr.ConstCast<mabe::Population>());
     }
 
+    /// Apply a word-parallel operation 'a op= b' where the position sets may differ in size;
+    /// missing positions count as zeros, and 'a' keeps at least its own size.
+    template <typename FUN_T>
+    static void BitOperate(emp::BitVector & a, const emp::BitVector & b, FUN_T && op) {
+      if (a.GetSize() < b.GetSize()) a.Resize(b.GetSize());
+      if (a.GetSize() == b.GetSize()) { op(a, b); return; }
+      emp::BitVector b_sized(b);
+      b_sized.Resize(a.GetSize());
+      op(a, b_sized);
+    }
+
     // Take an iterator that may be in an illegal state and restore it to a legal state.
     // Return whether it was originally valid.
     template <typename T>
@@ -255,12 +375,13 @@ namespace mabe {
       auto info_it = GetInfoIT(cur_pop);      // Look up this population's info.
 
       // If we have an invalid population, jump to end and signal that it was invalid.
-      if (info_it != pos_map.end()) {
+      if (info_it == pos_map.end()) {
         it.Set(nullptr, 0);
         return false;
       }
 
       // We now know we have a valid population.  Check if we are at a valid position.
+      if (info_it->second.full_pop && it.Pos() < cur_pop->GetSize()) return true;
       if (info_it->second.pos_set.Has(it.Pos())) return true;
 
       // Must move to a valid position, either in this population, another population, or end.
@@ -370,7 +491,7 @@ namespace mabe {
     /// Calculate the total number of positions represented in this collection.
     size_t GetSize() const noexcept override {
       size_t count = 0;
-      for (auto [pop_ptr, pop_info] : pos_map) {
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
         count += pop_info.GetSize(pop_ptr);
       }
       return count;
@@ -379,7 +500,7 @@ namespace mabe {
     /// Determine if there are any (living) organisms in this collection.
     bool IsEmpty() const noexcept override {
       // If we find an organism in any population, return false; otherwise return true.
-      for (auto [pop_ptr, pop_info] : pos_map) {
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
         if (!pop_info.IsEmpty(pop_ptr)) return false;
       }
       return true;
@@ -390,7 +511,7 @@ namespace mabe {
     const_iterator_t ConstIteratorAt(size_t org_id) const { return IteratorAt(org_id); }
 
     Organism & At(size_t org_id) override {
-      for (auto [pop_ptr, pop_info] : pos_map) {
+      for (auto & [pop_ptr, pop_info] : pos_map) {
         const size_t pop_size = pop_info.GetSize(pop_ptr);
 
         // If the ID is in the current population, get it.
@@ -410,18 +531,48 @@ namespace mabe {
     }
 
     const Organism & At(size_t org_id) const override {
-      for (auto [pop_ptr, pop_info] : pos_map) {
-        if (org_id < pop_info.GetSize(pop_ptr)) {
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
+        const size_t pop_size = pop_info.GetSize(pop_ptr);
+        if (org_id < pop_size) {
           size_t pop_id = pop_info.GetPos(org_id);
           return pop_ptr->At(pop_id);
         }
-        org_id -= pop_info.GetSize(pop_ptr);
+        org_id -= pop_size;
       }
 
       emp::notify::Error("Trying to find org id out of range for a collection.");
       return pos_map.begin()->first->At(0); // Return the first organism since out of range.
     }
 
+    /// Copy trait 'trait_id' of each organism in this collection into 'out', in collection order
+    /// (see Population::GatherTrait()); empty positions give T{}.
+    template <typename T>
+    void GatherTrait(size_t trait_id, std::span<T> out, ThreadPool * pool=nullptr) const {
+      emp_assert(out.size() >= GetSize(), out.size(), GetSize());
+      size_t offset = 0;
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
+        const size_t pop_size = pop_info.GetSize(pop_ptr);
+        if (pop_info.full_pop) pop_ptr->GatherTrait<T>(trait_id, out.subspan(offset, pop_size), false, pool);
+        else pop_ptr->GatherTraitAt<T>(trait_id, pop_info.GetPositions(), out.subspan(offset, pop_size), pool);
+        offset += pop_size;
+      }
+    }
+
+    /// Copy values from 'in' (in collection order) into trait 'trait_id' of each organism in
+    /// this collection; values for empty positions are ignored.
+    template <typename T>
+    void ScatterTrait(size_t trait_id, std::span<const T> in, ThreadPool * pool=nullptr) {
+      emp_assert(in.size() >= GetSize(), in.size(), GetSize());
+      size_t offset = 0;
+      for (auto & [pop_ptr, pop_info] : pos_map) {
+        emp_assert(pop_info.is_mutable, "Cannot use ScatterTrait() on a const Population in Collection.");
+        const size_t pop_size = pop_info.GetSize(pop_ptr);
+        if (pop_info.full_pop) pop_ptr->ScatterTrait<T>(trait_id, in.subspan(offset, pop_size), false, pool);
+        else pop_ptr->ScatterTraitAt<T>(trait_id, pop_info.GetPositions(), in.subspan(offset, pop_size), pool);
+        offset += pop_size;
+      }
+    }
+
     // Always return a constant organism.
     const Organism & ConstAt(size_t org_id) const { return At(org_id); }
 
@@ -429,7 +580,7 @@ namespace mabe {
     const Organism & operator[](size_t org_id) const { return At(org_id); }
 
     bool HasPopulation(const mabe::Population & pop) const {
-      return emp::Has(pos_map, (Population *) &pop);
+      return pos_map.find((Population *) &pop) != pos_map.end();
     }
 
     bool HasPosition(const OrgPosition & pos) const {
@@ -443,7 +594,7 @@ namespace mabe {
     emp::String ToString() const override {
       std::stringstream ss;
       bool first = true;
-      for (auto [pop_ptr, pop_info] : pos_map) {
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
         if (first) first = false;
         else ss << ',';
 
@@ -528,6 +679,10 @@ namespace mabe {
     /// Remove all entries from a collection.
     Collection & Clear() { pos_map.clear(); return *this; }
 
+    /// Remove all entries, but keep the position sets and indices that held them, so that
+    /// refilling the collection (with the same populations) allocates nothing.
+    Collection & Reset() { pos_map.reset(); return *this; }
+
     /// Add a Population to this collection.
     template <typename... Ts>
     Collection & Insert(Population & pop, Ts &&... extras) {
@@ -572,6 +727,19 @@ namespace mabe {
       return Insert( pi.AsPosition(), std::forward<Ts>(extras)... );
     }
 
+    /// Add a set of positions from a single population, sizing the position set only once.
+    Collection & InsertPositions(Population & pop, std::span<const size_t> positions) {
+      if (positions.size() == 0) return *this;
+      PopInfo & pop_info = pos_map[&pop];
+      pop_info.is_mutable = true;
+      if (pop_info.full_pop) return *this;
+      const size_t max_pos = *std::max_element(positions.begin(), positions.end());
+      if (pop_info.pos_set.GetSize() <= max_pos) pop_info.pos_set.Resize(max_pos+1);
+      emp::BitVector & pos_set = pop_info.EditPosSet();
+      for (size_t pos : positions) pos_set.Set(pos);
+      return *this;
+    }
+
     /// Add a whole other collection.
     template <typename... Ts>
     Collection & Insert(const Collection & in_collection, Ts &&... extras) {
@@ -587,20 +755,9 @@ namespace mabe {
         // If we're adding a full population, do so.
         if (in_pop_info.full_pop) { pop_info.full_pop = true; continue; }
 
-        // Otherwise add just the entries we need to.
-        emp::BitVector & pos_set = pop_info.pos_set;
-        emp::BitVector in_pos_set = in_pop_info.pos_set;
-
-        // Make sure both position sets are the size of the larger one.
-        if (in_pos_set.GetSize() < pos_set.GetSize()) {
-          in_pos_set.Resize(pos_set.GetSize());
-        }
-        else if (pos_set.GetSize() < in_pos_set.GetSize()) {
-          pos_set.Resize(in_pos_set.GetSize());
-        }
-
-        // Use 'OR' to find the union of the sets.
-        pos_set |= in_pos_set;
+        // Otherwise add just the entries we need to; use 'OR' to find the union of the sets.
+        BitOperate(pop_info.EditPosSet(), in_pop_info.pos_set,
+                   [](emp::BitVector & a, const emp::BitVector & b){ a |= b; });
       }
 
       return Insert( std::forward<Ts>(extras)... );  // Insert anything else provided.
@@ -634,6 +791,7 @@ namespace mabe {
         pop_info.RemoveFull(pop_ptr); 
 
         // Scan through organisms, removing inclusion of those that are empty.
+        pop_info.index_ok = false;
         for (int pos = pos_set.FindOne(); pos != -1; pos = pos_set.FindOne(pos+1)) {
           if (!pop_ptr->IsOccupied((size_t) pos)) pos_set.Set(pos,false);
         }
@@ -642,11 +800,44 @@ namespace mabe {
       return *this;
     }
 
-    /// Produce a new collection limited to living organisms.
-    Collection GetAlive() const {
-      Collection out(*this);
-      out.RemoveEmpty();
-      return out;
+    /// Produce a new collection limited to living organisms (with storage from the pool).
+    Collection GetAlive() const;
+
+    /// Count the living organisms in this collection without building a new collection.
+    size_t CountAlive() const {
+      size_t count = 0;
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
+        if (pop_info.full_pop) { count += pop_ptr->GetNumOrgs(); continue; }
+        const emp::BitVector & pos_set = pop_info.pos_set;
+        const emp::BitVector & occupied = pop_ptr->GetOccupied();
+        for (int pos = pos_set.FindOne(); pos != -1; pos = pos_set.FindOne(pos+1)) {
+          count += ((size_t) pos < occupied.GetSize()) && occupied.Has((size_t) pos);
+        }
+      }
+      return count;
+    }
+
+    /// Call fun(Organism &) on each living organism, in the same order that iterating over
+    /// GetAlive() would visit them, without copying this collection.
+    template <typename FUN_T>
+    void ForEachAlive(FUN_T && fun) const {
+      for (const auto & [pop_ptr, pop_info] : pos_map) {
+        Population & pop = *pop_ptr;
+        if (pop_info.full_pop) {
+          const size_t pop_size = pop.GetSize();
+          if (pop.GetNumOrgs() == pop_size) {        // Full populations need no checks.
+            for (size_t pos = 0; pos < pop_size; ++pos) fun(pop[pos]);
+          } else {                                    // Otherwise skip empty runs.
+            for (Organism & org : pop.Living()) fun(org);
+          }
+          continue;
+        }
+        const emp::BitVector & pos_set = pop_info.pos_set;
+        const emp::BitVector & occupied = pop.GetOccupied();
+        for (int pos = pos_set.FindOne(); pos != -1; pos = pos_set.FindOne(pos+1)) {
+          if ((size_t) pos < occupied.GetSize() && occupied.Has((size_t) pos)) fun(pop[(size_t) pos]);
+        }
+      }
     }
 
     /// Merge this collection with another collection.
@@ -671,7 +862,8 @@ namespace mabe {
         // Otherwise populations must be the same!  If 'in' pop is full, keep this one as is!
         if (!in_it->second.full_pop) {
           cur_it->second.RemoveFull(cur_it->first);         // Shift first pop to individuals
-          cur_it->second.pos_set &= in_it->second.pos_set;  // Now pick out the intersection.
+          BitOperate(cur_it->second.EditPosSet(), in_it->second.pos_set,  // Now pick out the
+                     [](emp::BitVector & a, const emp::BitVector & b){ a &= b; }); // intersection.
         }
 
         // Move on to the next populations.
@@ -685,6 +877,23 @@ namespace mabe {
       return *this;
     }
 
+    /// Remove all positions that are in another collection.
+    Collection & operator-= (const Collection & in_collection) {
+      for (const auto & [pop_ptr, in_pop_info] : in_collection.pos_map) {
+        auto cur_it = pos_map.find(pop_ptr);
+        if (cur_it == pos_map.end()) continue;              // Nothing to remove from this pop.
+        if (in_pop_info.full_pop) { pos_map.erase(cur_it); continue; }  // Remove whole pop.
+
+        cur_it->second.RemoveFull(pop_ptr);                 // Shift this pop to individuals
+        BitOperate(cur_it->second.EditPosSet(), in_pop_info.pos_set,    // and clear the
+                   [](emp::BitVector & a, const emp::BitVector & b){ a &= ~b; });  // others.
+      }
+      return *this;
+    }
+
+    /// Remove all positions that are in another collection (same as -=).
+    Collection & Remove(const Collection & in_collection) { return *this -= in_collection; }
+
     static emp::String EMPGetTypeName() { return "mabe::Collection"; }
   };
 
@@ -746,6 +955,100 @@ namespace mabe {
     if (base_t::IsValid() == false) IncPosition();
   }
 
+
+  /// Recycled storage for the many short-lived collections built each update.
+  ///
+  /// Script calls such as FILTER, GetAlive(), and every SELECT or birth return a new
+  /// Collection, whose position sets are sized to the whole population; most are gone again by
+  /// the end of the update.  The pool keeps the storage of finished collections (after Reset(),
+  /// so their position sets and indices keep their capacity) for the next one needed; once it
+  /// has warmed up, refilling a collection for the same populations allocates nothing.
+  ///
+  ///   Acquire() / Release(ptr) - A heap Collection (as used for script OrgList objects).
+  ///   Take() / Give(collection) - A Collection value; its storage is moved in and out.
+  ///
+  /// Shared() is the pool used throughout MABE; like the Emplode arena it is never destroyed,
+  /// so script symbols can still release their collections during static destruction.  A mutex
+  /// guards each call, since PARALLEL blocks can build OrgLists on several threads.
+  class CollectionPool {
+  private:
+    static constexpr size_t MAX_FREE = 256;    ///< Collections kept beyond this are deleted.
+
+    std::mutex pool_mutex;
+    emp::vector<emp::Ptr<Collection>> free_list;   ///< Reset collections, with their storage.
+    emp::vector<emp::Ptr<Collection>> husks;       ///< Collections whose storage was taken.
+    size_t num_made = 0;                           ///< Collections that had to be allocated.
+    size_t num_reused = 0;                         ///< Requests served from the pool.
+
+  public:
+    CollectionPool() = default;
+    CollectionPool(const CollectionPool &) = delete;
+    ~CollectionPool() {
+      for (emp::Ptr<Collection> ptr : free_list) ptr.Delete();
+      for (emp::Ptr<Collection> ptr : husks) ptr.Delete();
+    }
+
+    static CollectionPool & Shared() {
+      static CollectionPool & pool = *new CollectionPool;
+      return pool;
+    }
+
+    size_t GetNumMade() const { return num_made; }
+    size_t GetNumReused() const { return num_reused; }
+    size_t GetNumFree() const { return free_list.size(); }
+
+    /// Get an empty heap Collection; return it with Release() (or delete it as usual).
+    emp::Ptr<Collection> Acquire() {
+      std::lock_guard<std::mutex> lock(pool_mutex);
+      emp::vector<emp::Ptr<Collection>> & from = free_list.size() ? free_list : husks;
+      if (from.empty()) { ++num_made; return emp::NewPtr<Collection>(); }
+      ++num_reused;
+      emp::Ptr<Collection> out = from.back();
+      from.pop_back();
+      return out;
+    }
+
+    /// Finish with a collection from Acquire(); its storage is kept for the next one.
+    void Release(emp::Ptr<Collection> ptr) {
+      ptr->Reset();
+      std::lock_guard<std::mutex> lock(pool_mutex);
+      if (free_list.size() >= MAX_FREE) { ptr.Delete(); return; }
+      free_list.push_back(ptr);
+    }
+
+    /// Get an empty Collection value, with storage from a finished collection if available.
+    Collection Take() {
+      std::lock_guard<std::mutex> lock(pool_mutex);
+      if (free_list.empty()) { ++num_made; return Collection(); }
+      ++num_reused;
+      emp::Ptr<Collection> ptr = free_list.back();
+      free_list.pop_back();
+      Collection out(std::move(*ptr));
+      if (husks.size() < MAX_FREE) husks.push_back(ptr);
+      else ptr.Delete();
+      return out;
+    }
+
+    /// Finish with a Collection value; its storage is moved into the pool.
+    void Give(Collection && in) {
+      std::lock_guard<std::mutex> lock(pool_mutex);
+      if (free_list.size() >= MAX_FREE) return;    // 'in' keeps its storage and frees it.
+      emp::Ptr<Collection> ptr;
+      if (husks.size()) { ptr = husks.back(); husks.pop_back(); }
+      else ptr = emp::NewPtr<Collection>();
+      *ptr = std::move(in);
+      ptr->Reset();
+      free_list.push_back(ptr);
+    }
+  };
+
+  Collection Collection::GetAlive() const {
+    Collection out = CollectionPool::Shared().Take();
+    out = *this;
+    out.RemoveEmpty();
+    return out;
+  }
+
 }
 
 #endif
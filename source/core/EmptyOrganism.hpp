@@ -18,12 +18,11 @@ namespace mabe {
   /// An EmptyOrganism is used as a placeholder in an empty cell in a population.
   class EmptyOrganism : public Organism {
   public:
-    EmptyOrganism(OrganismManager<EmptyOrganism> & _manager) : Organism(_manager) { ; }
+    EmptyOrganism(OrganismManager<EmptyOrganism> & _manager) : Organism(_manager, true) { ; }
     emp::Ptr<OrgType> Clone() const override { emp_error("Do not clone EmptyOrganism"); return nullptr; }
     emp::String ToString() const override { return "[empty]"; }
     size_t Mutate(emp::Random &) override { emp_error("EmptyOrganism cannot Mutate()"); return -1; }
     void Randomize(emp::Random &) override { emp_error("EmptyOrganism cannot Randomize()"); }
-    bool IsEmpty() const noexcept override { return true; }
   };
 
   class EmptyOrganismManager : public OrganismManager<EmptyOrganism> {
@@ -5,13 +5,35 @@
  *
  *  @file  EvalModule.hpp
  *  @brief A module base class to simplify the creation of evaluation modules.
+ *
+ *  If an evaluator wraps its per-organism function with CacheEval(), setting its cache_evals
+ *  option will skip organisms whose genome has not changed since this evaluator last stored
+ *  results on them (survivors, clones, and offspring without mutations).  Calling RESET from
+ *  a script invalidates all cached results.  Only use caching when the evaluation depends
+ *  only on the genome and the evaluator's own state, and no other module overwrites its traits.
+ *
+ *  Evaluators that override EvaluateOrganism() also support eval_offspring: each offspring is
+ *  scored as soon as it is made (from OnOffspringReady, right after mutation, while its genome
+ *  is still in cache), and a later EVAL skips it.  This has the same requirements as caching.
+ *
+ *  Evaluators that score organisms through EvalModule::EvaluateOrgs() can set cost_trait to a
+ *  trait or equation (such as genome_length) estimating each organism's evaluation time; in
+ *  parallel runs, costly organisms are then started first so threads finish together.
+ *
+ *  Evaluators can also use Memoize() to look up results by a genome fingerprint; setting the
+ *  memo_size option keeps up to that many results in a least-recently-used cache across the
+ *  run, so genotypes rediscovered in other lineages are not recomputed.
  */
 
 #ifndef MABE_EVAL_MODULE_H
 #define MABE_EVAL_MODULE_H
 
+#include <atomic>
+
 #include "emp/base/notify.hpp"
 
+#include "../tools/MemoCache.hpp"
+
 #include "MABE.hpp"
 #include "Module.hpp"
 
@@ -19,6 +41,73 @@ namespace mabe {
 
   template <typename DERIVED_T>
   class EvalModule : public Module {
+  protected:
+    bool cache_evals = false;                ///< Skip orgs with still-valid results?
+    bool eval_offspring = false;             ///< Evaluate offspring as soon as they are made?
+    size_t eval_epoch = 1;                   ///< Advanced whenever all prior results go stale.
+    std::atomic<size_t> num_evaluated{0};    ///< Organisms actually evaluated.
+    std::atomic<size_t> num_skipped{0};      ///< Organisms skipped due to cached results.
+    size_t memo_size = 0;                    ///< Max results to memoize by genome (0 = off).
+    emp::String cost_trait;                  ///< Equation estimating evaluation cost ("" = none).
+    MemoCache<double> memo;                  ///< Results keyed by genome fingerprint.
+
+    void SetupConfig_Internal() override {
+      Module::SetupConfig_Internal();
+      LinkVar(cache_evals, "cache_evals",
+              "Skip organisms whose genomes are unchanged since this module evaluated them?");
+      LinkVar(eval_offspring, "eval_offspring",
+              "Evaluate each offspring right after it is mutated (while its genome is in cache),"
+              " so EVAL can skip it?");
+      LinkVar(memo_size, "memo_size",
+              "Number of results to remember by genome fingerprint (0 = no memo).");
+      LinkVar(cost_trait, "cost_trait",
+              "Trait or equation estimating each organism's evaluation time, to balance threads"
+              " (e.g., genome_length; empty for none).");
+    }
+
+    /// Size the memo once, on the main thread, before any evaluation can use it.
+    void SetupModule_Internal() override {
+      Module::SetupModule_Internal();
+      memo.SetCapacity(memo_size);
+    }
+
+    /// Run eval_fun on each living organism with MABE::EvaluateOrgs(), using cost_trait (if
+    /// set) to decide which organisms to start first.
+    template <typename FUN_T>
+    double EvaluateOrgs(const Collection & orgs, FUN_T && eval_fun) {
+      if (cost_trait.empty() || orgs.IsEmpty()) return control.EvaluateOrgs(orgs, eval_fun);
+      auto cost_fun = control.BuildTraitEquation(orgs.GetDataLayout(), cost_trait);
+      return control.EvaluateOrgs(orgs, eval_fun, cost_fun);
+    }
+
+    /// Return the memoized result for a genome fingerprint, or calculate it with fun().
+    template <typename FUN_T>
+    double Memoize(uint64_t genome_key, FUN_T && fun) {
+      if (!memo.IsActive()) return fun();
+      return memo.Get(genome_key, std::forward<FUN_T>(fun));
+    }
+
+    /// Wrap a per-organism evaluation function so that, when caching is on, organisms with a
+    /// valid prior result are skipped; 'get_cached' must return that result from org traits.
+    template <typename EVAL_FUN_T, typename CACHED_FUN_T>
+    auto CacheEval(EVAL_FUN_T eval_fun, CACHED_FUN_T get_cached) {
+      return [this, eval_fun, get_cached](Organism & org) -> double {
+        const bool use_records = cache_evals || eval_offspring;
+        if (use_records && org.HasEvalRecord(this, eval_epoch)) {
+          ++num_skipped;
+          return get_cached(org);
+        }
+        const double result = eval_fun(org);
+        ++num_evaluated;
+        if (use_records) org.SetEvalRecord(this, eval_epoch);
+        return result;
+      };
+    }
+
+    /// Evaluate one organism that may not be in a population yet, storing its results in its
+    /// traits; return false if this evaluator can only work on whole collections.
+    virtual bool EvaluateOrganism(Organism &) { return false; }
+
   public:
     EvalModule(mabe::MABE & control,
                emp::String name,
@@ -29,27 +118,78 @@ namespace mabe {
     }
     ~EvalModule() { }
 
+    size_t GetNumBytes() const override { return memo.GetNumBytes(); }
+
+    void OnOffspringReady(Organism & offspring, OrgPosition ppos, Population & target_pop) override {
+      if (!eval_offspring) {                    // Stop listening for offspring.
+        Module::OnOffspringReady(offspring, ppos, target_pop);
+        return;
+      }
+      if (offspring.HasEvalRecord(this, eval_epoch)) return;   // Unmutated clone; still valid.
+      if (!EvaluateOrganism(offspring)) {
+        emp::notify::Warning("Module '", name, "' cannot evaluate single organisms; turning off eval_offspring.");
+        eval_offspring = false;
+        return;
+      }
+      ++num_evaluated;
+      offspring.SetEvalRecord(this, eval_epoch);
+    }
+
     // Setup member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction("EVAL",
-                             [](DERIVED_T & mod, Collection list) { return mod.Evaluate(list); },
+                             [](DERIVED_T & mod, const Collection & list) { return mod.Evaluate(list); },
                              "Evaluate all orgs in the OrgList.");
       info.AddMemberFunction("RESET",
-                             [](DERIVED_T & mod) { return mod.Reset(); },
+                             [](DERIVED_T & mod) { mod.InvalidateEvalCache(); return mod.Reset(); },
                              "Regenerate the landscape with current config values.");
+      info.AddMemberFunction("NUM_EVALUATED",
+                             [](DERIVED_T & mod) { return mod.GetNumEvaluated(); },
+                             "Return the number of organisms actually evaluated so far.");
+      info.AddMemberFunction("NUM_SKIPPED",
+                             [](DERIVED_T & mod) { return mod.GetNumSkipped(); },
+                             "Return the number of evaluations skipped due to cached results.");
+      info.AddMemberFunction("MEMO_HIT_RATE",
+                             [](DERIVED_T & mod) { return mod.memo.GetHitRate(); },
+                             "Return the fraction of memo lookups that found a stored result.");
+      info.AddMemberFunction("MEMO_SIZE",
+                             [](DERIVED_T & mod) { return mod.memo.GetSize(); },
+                             "Return the number of results currently memoized.");
+      info.AddMemberFunction("MEMO_BYTES",
+                             [](DERIVED_T & mod) { return mod.memo.GetNumBytes(); },
+                             "Return the approximate memory used by memoized results.");
     }
 
     /// Run this evaluator on the provided collection.
     virtual double EvaluateCollection(const Collection & orgs) = 0;
 
+  protected:
+    /// Evaluate a collection built just for this call, then return its storage to the pool.
+    double EvaluateTemp(Collection && orgs) {
+      const double result = Evaluate(orgs);
+      CollectionPool::Shared().Give(std::move(orgs));
+      return result;
+    }
+
+  public:
     /// Run this evaluator on the provided collection.
     double Evaluate(const Collection & orgs) { return EvaluateCollection(orgs); };
 
     /// If a population is provided to Evaluate, first convert it to a Collection.
-    double Evaluate(Population & pop) { return Evaluate( Collection(pop) ); }
+    double Evaluate(Population & pop) {
+      Collection orgs = CollectionPool::Shared().Take();
+      orgs.Insert(pop);
+      return EvaluateTemp(std::move(orgs));
+    }
 
     /// If a string is provided to Evaluate, convert it to a Collection.
-    double Evaluate(const emp::String & in) { return Evaluate( control.ToCollection(in) ); }
+    double Evaluate(const emp::String & in) { return EvaluateTemp( control.ToCollection(in) ); }
+
+    size_t GetNumEvaluated() const { return num_evaluated; }
+    size_t GetNumSkipped() const { return num_skipped; }
+
+    /// Mark all previously cached results from this evaluator as out of date.
+    void InvalidateEvalCache() { ++eval_epoch; memo.Clear(); }
 
     /// Re-randomize all of the entries.
     virtual double Reset() { emp::notify::Message("Module '", name, "' cannot be reset."); return 0.0;  }
@@ -16,8 +16,25 @@
 #ifndef MABE_MABE_HPP
 #define MABE_MABE_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <limits>
+#include <span>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "emp/base/array.hpp"
 #include "emp/base/Ptr.hpp"
@@ -33,6 +50,12 @@
 #include "emp/tools/String.hpp"
 
 #include "../Emplode/Emplode.hpp"
+#include "../tools/ActiveCases.hpp"
+#include "../tools/BackgroundQueue.hpp"
+#include "../tools/Checkpoint.hpp"
+#include "../tools/ConflictSchedule.hpp"
+#include "../tools/GenomeHash.hpp"
+#include "../tools/ThreadPool.hpp"
 
 #include "Batch.hpp"
 #include "Collection.hpp"
@@ -41,6 +64,8 @@
 #include "MABEScript.hpp"
 #include "ModuleBase.hpp"
 #include "Population.hpp"
+#include "PopSnapshot.hpp"
+#include "PopView.hpp"
 #include "SigListener.hpp"
 #include "TraitManager.hpp"
 #include "ActionMap.hpp"
@@ -74,6 +99,7 @@ namespace mabe {
     emp::DataMap org_data_map;
 
     TraitManager<ModuleBase> trait_man; ///< Manage consistent read/write access to traits
+    BackgroundQueue background_jobs;    ///< Analysis tasks running while evolution continues.
 
     // --- Config information for command-line arguments ---
     struct ArgInfo {
@@ -96,25 +122,114 @@ namespace mabe {
     emp::vector<emp::String> config_filenames; ///< Names of configuration files to load.
     emp::vector<emp::String> config_settings;  ///< Additional config commands to run.
     emp::String gen_filename;                  ///< Name of output file to generate.
+    emp::String emit_cpp_filename;             ///< File to write native event actions to.
+    emp::String restore_filename;              ///< Checkpoint to continue the run from.
+    emp::String stop_filename;                 ///< Exit cleanly once this file exists.
+    bool run_batch = false;                    ///< Should config_filenames be run as a batch?
+    bool preparse_only = false;                ///< Only fill the token cache, then exit?
+    size_t batch_jobs = 0;                     ///< Concurrent batch runs (0 = use batch file)
+    size_t num_replicates = 0;                 ///< Replicates to run in this process (0 = none)
+    int first_replicate_seed = 1;              ///< Random seed of the first replicate.
+    std::function<void(MABE &)> setup_empty_fun; ///< Repeat SetupEmpty() on a replicate.
+    static constexpr size_t REPLICATE_UPDATES = 1000000; ///< Update limit for each replicate.
+    bool restored = false;                     ///< Was this run restored from a checkpoint?
+
+    /// Fingerprints of one position as saved in the last checkpoint (state_hash 0 = empty).
+    struct CheckpointSlot {
+      uint64_t state_hash = 0;   ///< Organism type and SaveState() bytes.
+      uint64_t trait_hash = 0;   ///< Checkpointed trait values.
+    };
+    emp::String last_checkpoint;   ///< Checkpoint the next delta builds on ("" = none yet).
+    std::unordered_map<emp::String, emp::vector<CheckpointSlot>> checkpoint_slots; ///< By pop name.
     MABEScript config_script;                  ///< Configuration information for this run.
+    ThreadPool thread_pool;                    ///< Worker threads for parallel evaluation.
+    std::unordered_map<emp::String, ActiveCases> active_cases; ///< Shared test-case samples.
+    Profiler profiler;                         ///< Signal and event timings (if profiling).
+    bool profiling = false;                    ///< Should signals and events be timed?
+    bool parallel_births = false;              ///< Build bulk offspring/injects across the thread pool?
+    bool balance_evals = false;                ///< Time evaluations to balance threads by cost?
+    bool concurrent_modules = false;           ///< Run independent update modules at once?
+    ConflictSchedule before_update_stages;     ///< Concurrent stages for before_update_sig.
+    ConflictSchedule on_update_stages;         ///< Concurrent stages for on_update_sig.
+    static constexpr uint64_t BIRTH_SALT = 0xB1278;  ///< Salt for parallel birth random streams.
+    static constexpr uint64_t INJECT_SALT = 0x17EC7; ///< Salt for parallel inject random streams.
+    static constexpr uint64_t CROSSOVER_SALT = 0xC7055; ///< Salt for parallel recombination streams.
+    static constexpr uint64_t FORK_SALT = 0xF0124;      ///< Salt for seeding forked runs.
+    emp::vector<std::function<void()>> sync_funs;    ///< Deferred work to finish at sync points.
+    emp::vector<std::function<void()>> fork_funs;    ///< Stop module threads before a FORK.
+    emp::vector<std::function<void(size_t)>> update_funs; ///< C++ steps run after UPDATE events.
+    bool links_frozen = false;                 ///< Has Setup() resolved all name-based links?
+    mutable bool warned_name_lookup = false;   ///< Debug: was a late name lookup reported?
+
+    /// Debug builds: after Setup(), warn (once) about populations or modules being looked up
+    /// by name while a module is handling a signal; such names should be resolved during setup
+    /// (e.g., with LinkPop or LinkModule, which store IDs) rather than on every call.
+    void CheckNameLookup([[maybe_unused]] const char * kind,
+                         [[maybe_unused]] std::string_view name) const {
+#ifndef NDEBUG
+      if (!links_frozen || warned_name_lookup) return;
+      for (auto sig_ptr : sig_ptrs) {
+        if (!sig_ptr->cur_mod) continue;
+        warned_name_lookup = true;
+        emp::notify::Warning("Module '", sig_ptr->cur_mod->GetName(), "' looked up ", kind, " '",
+                             name, "' by name during signal '", sig_ptr->name,
+                             "'; resolve it in SetupModule() instead.");
+        return;
+      }
+#endif
+    }
     
     // ----------- Helper Functions -----------    
     void ShowHelp();       ///< Print information on how to run the software.
     void ShowModules();    ///< List all available modules in the current compilation.
     void RunBatch();       ///< Process a whole series of MABE runs.
+    void RunReplicates();  ///< Run replicates of this configuration on separate threads.
     void ProcessArgs();    ///< Process all arguments passed in on the command line.
     /// Setup a function as deprecated so we can phase it out.
     void Setup_CommandLine(); ///< Process all command-line args.
     void Setup_Modules();     ///< Run SetupModule() method on each module we've loaded.
+    /// Run the statements of a script PARALLEL block, overlapping those that only call into
+    /// modules marked with SetConcurrentCalls() whose traits do not conflict.
+    void RunParallelStatements(const emplode::SymbolTableBase::call_objs_t & calls,
+                               const std::function<void(size_t)> & run_statement);
+
+    /// Find which modules listening to an update signal can run together.
+    void BuildUpdateStages(const sig_base_t & sig, ConflictSchedule & stages);
+
+    /// Trigger an update signal, running each stage of modules across the thread pool.
+    void TriggerUpdateStages(SigListener<ModuleBase,void,size_t> & sig,
+                             const ConflictSchedule & stages, size_t ud);
+
     void UpdateSignals();     ///< Link signals only to modules that respond to them.
 
+    /// Build one offspring of org and place it; record its position in 'placed' if successful.
+    void PlaceOffspring(const Organism & org, OrgPosition ppos, Population & target_pop,
+                        bool do_mutations, emp::vector<size_t> & placed, Collection & other_list);
+
+    /// Place an offspring that has already been built (and mutated, if needed).
+    void PlaceNewOffspring(emp::Ptr<Organism> new_org, OrgPosition ppos, Population & target_pop,
+                           emp::vector<size_t> & placed, Collection & other_list);
+
+    /// Can DoBirths() from these parents mutate offspring in parallel?
+    bool CanMutateInParallel(std::span<const OrgPosition> parents) const;
+
   public:
     MABE();                        ///< MABE default constructor (for testing)
     MABE(int argc, char* argv[]);  ///< MABE command-line constructor.
+    MABE(const emp::vector<emp::String> & in_args);  ///< Constructor with pre-split arguments.
     MABE(const MABE &) = delete;
     MABE(MABE &&) = delete;
     ~MABE() {
+      WaitForBackground();                            // Finish background analyses...
       before_exit_sig.Trigger();                      // Notify modules of end...
+      if (profiling) {                                // Report timings if requested.
+        std::cout << "\nProfile of signals and events:\n";
+        profiler.WriteTable(std::cout);
+      }
+      if (report_memory) {                            // Report memory use if requested.
+        std::cout << "\nMemory use by populations and modules:\n";
+        WriteMemoryReport(std::cout);
+      }
 
       for (auto pop_ptr : pops) {                     // Delete all populations.
         ClearPop(*pop_ptr);
@@ -140,9 +255,189 @@ namespace mabe {
       random.ResetSeed(in_seed);
     }
 
+    size_t GetNumThreads() const override { return thread_pool.GetNumThreads(); }
+    void SetNumThreads(size_t in_threads) override { thread_pool.SetNumThreads(in_threads); }
+    ThreadPool & GetThreadPool() override { return thread_pool; }
+
+    /// Get the named set of active test cases, creating it if needed.  Selectors that sample
+    /// test cases set its sample size during SetupModule(); evaluators then use GetSample() to
+    /// score only the cases that will be used.
+    ActiveCases & GetActiveCases(const emp::String & name) {
+      return active_cases.try_emplace(name, name.str()).first->second;
+    }
+
+    /// When on, DoBirths() from organisms whose Mutate() is thread safe clones all offspring,
+    /// mutates them across the thread pool (each with a random stream keyed by update and birth
+    /// number, so results do not depend on thread count), and then places them in order.
+    /// Inject() by type name likewise initializes new organisms in parallel when their type's
+    /// Initialize() is thread safe.
+    bool GetParallelBirths() const override { return parallel_births; }
+    void SetParallelBirths(bool in_parallel) override { parallel_births = in_parallel; }
+    bool GetBalanceEvals() const override { return balance_evals; }
+    void SetBalanceEvals(bool in_balance) override { balance_evals = in_balance; }
+
+    /// When on, modules marked with SetConcurrentUpdate() whose traits do not conflict (no
+    /// trait is used by both and written by either) run their BeforeUpdate() and OnUpdate()
+    /// across the thread pool at the same time; all other modules still run in order.
+    bool GetConcurrentModules() const override { return concurrent_modules; }
+    void SetConcurrentModules(bool in_concurrent) override {
+      concurrent_modules = in_concurrent;
+      RescanSignals();
+    }
+
+    /// Register a function to run at every sync point.  Modules that defer work from worker
+    /// threads (such as queued births) finish it there, on the main thread.
+    void AddSyncFun(std::function<void()> fun) { sync_funs.push_back(fun); }
+
+    /// Register a function to run just before FORK copies this process.  It must finish and
+    /// join every thread its module owns (threads that start on demand may start again later),
+    /// so that no other thread holds a lock when the process is copied.
+    void AddForkFun(std::function<void()> fun) { fork_funs.push_back(fun); }
+
+    /// A sync point: run all deferred work in registration order.  Called at the end of each
+    /// update, and by schedulers after running organisms in parallel.
+    void Sync() { for (auto & fun : sync_funs) fun(); }
+
+    /// Register a C++ function to run every update (given the update number), after modules
+    /// and any script UPDATE events; used by drivers that skip the script layer (see Builder).
+    void AddUpdateFun(std::function<void(size_t)> fun) { update_funs.push_back(fun); }
+
+    /// Turn on (or off) timing of all module signals and script events.
+    bool GetProfiling() const override { return profiling; }
+    void SetProfiling(bool in_profiling) override {
+      profiling = in_profiling;
+      emp::Ptr<Profiler> prof_ptr = profiling ? &profiler : nullptr;
+      for (auto sig_ptr : sig_ptrs) sig_ptr->SetProfiler(prof_ptr);
+      if (profiling) {
+        config_script.GetSymbolTable().SetEventProfileFun(
+          [this](const emp::String & label, uint64_t ns){ profiler.Record(label, ns); });
+      }
+      else config_script.GetSymbolTable().SetEventProfileFun(nullptr);
+    }
+
+    /// Also record hardware counters (cycles, instructions, LLC and branch misses) for each
+    /// profiled module signal; only takes effect while profiling is on.
+    bool GetProfileCounters() const override { return profiler.GetHardwareCounters(); }
+    void SetProfileCounters(bool in_counters) override {
+      if (!profiler.SetHardwareCounters(in_counters)) {
+        emp::notify::Warning("Hardware performance counters are not available on this system; ",
+                             "profiling will record timings only.");
+      }
+    }
+    const Profiler & GetProfiler() const { return profiler; }
+
+    /// Approximate bytes held by all populations (organisms, DataMaps, genomes, etc.).
+    size_t GetPopBytes() const override {
+      size_t num_bytes = 0;
+      for (emp::Ptr<Population> pop_ptr : pops) num_bytes += pop_ptr->GetNumBytes();
+      return num_bytes;
+    }
+
+    /// Approximate bytes of large data held by all modules (see ModuleBase::GetNumBytes()).
+    size_t GetModuleBytes() const override {
+      size_t num_bytes = 0;
+      for (emp::Ptr<ModuleBase> mod_ptr : modules) num_bytes += mod_ptr->GetNumBytes();
+      return num_bytes;
+    }
+
+    /// Print a table of memory use by each population and each module that reports any.
+    void WriteMemoryReport(std::ostream & os) const;
+    bool WriteProfile(const emp::String & filename) const override {
+      return profiler.WriteCSV(filename);
+    }
+
     // --- Tools to setup runs ---
     bool Setup();
 
+    /// Save organisms, traits, update, and module state so the run can be continued with
+    /// Restore().  The full state of the master random number generator is saved (and the
+    /// generator is left untouched), so the restored run draws the same random values as this
+    /// one, and writing checkpoints never changes the course of a run.
+    bool Checkpoint(const emp::String & filename) override;
+
+    /// Save only what changed since the last checkpoint written or restored: organisms whose
+    /// type, state, or traits differ (found by fingerprint, so changes from any source are
+    /// caught), organisms removed, and new population sizes, plus the RNG and all module state.
+    /// Restoring a delta first restores the checkpoint it builds on (recursively, back to a
+    /// full checkpoint).  Without an earlier checkpoint, a full one is written instead.
+    bool CheckpointDelta(const emp::String & filename) override;
+
+    /// Fork this process into num_forks copies of the run (Unix only).  Population memory is
+    /// shared copy-on-write, so forking is far cheaper than writing and restoring checkpoints.
+    /// Each child gets its own random seed and moves into its own directory (dir_prefix + ID),
+    /// then continues the run; the return value is the child's ID (1 to num_forks).  The
+    /// original process waits for all children to finish and then exits, returning 0.
+    /// Files that are already open are shared by every child, so fork before output begins.
+    /// Background threads (tasks, DataFile writers, and any a module stops with AddForkFun)
+    /// are finished and joined first, since only the calling thread is copied into children.
+    size_t Fork(size_t num_forks, const emp::String & dir_prefix="fork_") override;
+
+    /// Continue a run from a checkpoint; must be called after Setup() with the same
+    /// configuration that was used to write the checkpoint.
+    bool Restore(const emp::String & filename);
+
+  private:
+    bool WriteCheckpoint(const emp::String & filename, bool delta);
+    bool RestoreFile(const emp::String & filename);
+
+    /// Serialize an organism's SaveState() and checkpointed traits; false if state cannot be saved.
+    static bool SaveOrgRecord(const Organism & org, const emp::vector<emp::Ptr<TraitInfo>> & traits,
+                              std::string & state, std::string & trait_bytes) {
+      std::ostringstream state_os(std::ios::binary), trait_os(std::ios::binary);
+      CheckpointWriter state_out(state_os), trait_out(trait_os);
+      if (!org.SaveState(state_out)) return false;
+      for (emp::Ptr<TraitInfo> trait_ptr : traits) trait_ptr->SaveValue(org.GetDataMap(), trait_out);
+      state = state_os.str();
+      trait_bytes = trait_os.str();
+      return true;
+    }
+
+    static CheckpointSlot CalcCheckpointSlot(const emp::String & type_name, const std::string & state,
+                                             const std::string & trait_bytes) {
+      const uint64_t sites[2] = { GenomeHash::CalcBytes(std::string_view(type_name.data(), type_name.size())),
+                                  GenomeHash::CalcBytes(state) };
+      const uint64_t state_hash = GenomeHash::Calc(2, [&sites](size_t i){ return sites[i]; });
+      return CheckpointSlot{ state_hash ? state_hash : 1, GenomeHash::CalcBytes(trait_bytes) };
+    }
+
+    /// Fingerprint every organism, so the next delta is relative to the current state.
+    void RecordCheckpointSlots(const emp::String & filename);
+
+  public:
+
+    /// Write all living organisms in a population (numeric traits and genomes) to a
+    /// column-oriented snapshot file; see PopSnapshot.hpp for the layout.
+    bool WriteSnapshot(const Population & pop, const emp::String & filename) {
+      if (!WritePopSnapshot(pop, trait_man.GetCheckpointTraits(), filename)) {
+        emp::notify::Error("Unable to write population snapshot '", filename, "'.");
+        return false;
+      }
+      return true;
+    }
+
+    /// Capture an immutable copy of a population's numeric traits (and optionally genomes)
+    /// that background tasks can read while the run continues.
+    PopView::view_ptr_t ViewPopulation(const Population & pop, bool with_genomes=false) {
+      return PopView::Capture(pop, trait_man.GetCheckpointTraits(), GetUpdate(), with_genomes);
+    }
+
+    /// Run a task on the background thread, after any tasks already submitted.  Tasks must
+    /// not touch populations or organisms directly; give them a PopView instead.
+    void RunInBackground(std::function<void()> task) { background_jobs.Submit(std::move(task)); }
+    size_t GetNumBackgroundTasks() { return background_jobs.GetNumPending(); }
+
+    /// Wait until at most 'max_pending' background tasks remain (by default, none).
+    void WaitForBackground(size_t max_pending=0) {
+      try { background_jobs.Wait(max_pending); }
+      catch (const std::exception & error) {
+        emp::notify::Error("Background task failed: ", error.what());
+      }
+    }
+
+    /// Replace the organisms in a population with those from a snapshot file (for example, to
+    /// re-evaluate them).  Traits not stored in the snapshot are left at their defaults.
+    bool LoadSnapshot(Population & pop, const emp::String & filename);
+
     /// Build a placeholder organism for "empty" positions in a Population
     template <typename EMPTY_MANAGER_T> void SetupEmpty();
 
@@ -153,12 +448,14 @@ namespace mabe {
 
     size_t GetNumPopulations() const { return pops.size(); }
     int GetPopID(std::string_view pop_name) const {
+      CheckNameLookup("population", pop_name);
       return emp::FindEval(pops, [pop_name](const auto & p){ return p->GetName() == pop_name; });
     }
     const ActionMap & GetActionMap(size_t id) const { return action_maps[id]; }
     ActionMap & GetActionMap(size_t id) { return action_maps[id]; }
 
     size_t GetPopulationID(const emp::String & name) const {
+      CheckNameLookup("population", name);
       for (size_t id = 0; id < pops.size(); ++id) {
         if (pops[id]->GetName() == name) return id;
       }
@@ -226,6 +523,40 @@ namespace mabe {
                        bool do_mutations=true);
 
 
+    /// Give birth to one offspring from each parent provided (in order) into target_pop.
+    /// Room is reserved up front, 'before repro' is triggered once for each run of identical
+    /// consecutive parents, and all placements are returned in a single Collection (and sent
+    /// to OnPlacementBatch listeners as a single batch).
+    Collection DoBirths(std::span<const OrgPosition> parents,
+                        Population & target_pop,
+                        bool do_mutations=true);
+
+    /// Give birth to one recombined offspring from each pair of parents (parents[2i] and
+    /// parents[2i+1]) into target_pop.  Each offspring starts as a clone of the first parent,
+    /// takes part of the second parent's genome with RecombineInPlace(), and is then mutated
+    /// (if do_mutations); 'before repro' is triggered on the first parent of each pair.
+    Collection DoPairedBirths(std::span<const OrgPosition> parents,
+                              Population & target_pop,
+                              bool do_mutations=true);
+
+    /// Give birth to birth_count offspring, where each parent is chosen (just before its birth)
+    /// by calling choose_parent(birth_id) and must return a parent OrgPosition.  Selection and
+    /// births are interleaved, so random draws happen in the same order as one DoBirth per parent.
+    template <typename FUN_T>
+    Collection DoBirths(size_t birth_count,
+                        FUN_T && choose_parent,
+                        Population & target_pop,
+                        bool do_mutations=true);
+
+    /// Give birth to one offspring from each parent provided (in order) into target_pop, but
+    /// build every offspring before placing any, so no placement can replace a parent that has
+    /// yet to reproduce.  prepare(i) is called just before the offspring of parents[i] is built.
+    template <typename FUN_T>
+    Collection DoBirthsBuildFirst(std::span<const OrgPosition> parents,
+                                  FUN_T && prepare,
+                                  Population & target_pop,
+                                  bool do_mutations=true);
+
     /// A shortcut to DoBirth where only the parent position needs to be supplied;
     /// Return all offspring placed.
     Collection Replicate(OrgPosition ppos, Population & target_pop,
@@ -234,9 +565,7 @@ namespace mabe {
     }
 
     /// Remove all organisms from a population; does not change size.
-    void ClearPop(Population & pop) {
-      for (PopIterator pos = pop.begin(); pos != pop.end(); ++pos) ClearOrgAt(pos);
-    }
+    void ClearPop(Population & pop) { ClearAllOrgs(pop); }
 
     /// Resize a population while clearing all of the organisms in it.
     void EmptyPop(Population & pop, size_t new_size=0) {
@@ -247,10 +576,12 @@ namespace mabe {
     /// Copy all of the organisms into a new population (clearing orgs already there)
     void CopyPop(const Population & from_pop, Population & to_pop) override {
       EmptyPop(to_pop, from_pop.GetSize()); 
+      BeginPlacementBatch();
       for (size_t pos=0; pos < from_pop.GetSize(); ++pos) {
         if (from_pop.IsEmpty(pos)) continue;
         InjectAt(from_pop[pos], to_pop.IteratorAt(pos));
       }
+      EndPlacementBatch();
     }
 
     /// Move all organisms from one population to another.
@@ -278,19 +609,36 @@ namespace mabe {
     Collection ToCollection(const emp::String & load_str);
 
     Collection GetAlivePopulation(size_t id) {
-      Collection col(GetPopulation(id));
-      col.RemoveEmpty();
+      Collection col = CollectionPool::Shared().Take();
+      col.Insert(GetPopulation(id)).RemoveEmpty();
       return col;
     }
 
+    /// Run an evaluation function (Organism & -> double) on each living organism in a
+    /// collection, splitting the work across the thread pool if num_threads > 1.  The function
+    /// must only modify the organism it is given.  Returns the highest result (0.0 if no orgs
+    /// are alive); the result is the same for any number of threads.
+    template <typename FUN_T>
+    double EvaluateOrgs(const Collection & orgs, FUN_T && eval_fun);
+
+    /// As above, but when running in parallel, cost_fun (Organism & -> double) estimates how
+    /// long each evaluation will take, so that costly organisms are started first and threads
+    /// finish together (see ThreadPool::ForEachByCost()).  With balance_evals on, cost_fun is
+    /// not needed: each evaluation's measured time is used as the estimate for next time.
+    template <typename FUN_T, typename COST_FUN_T>
+    double EvaluateOrgs(const Collection & orgs, FUN_T && eval_fun, COST_FUN_T && cost_fun);
+
 
     // --- Module Management ---
 
     /// Get the unique id of a module with the specified name.
     int GetModuleID(const emp::String & mod_name) const {
+      CheckNameLookup("module", mod_name);
       return emp::FindEval(modules, [mod_name](const auto & m){ return m->GetName() == mod_name; });
     }
 
+    size_t GetNumModules() const { return modules.size(); }
+
     /// Get a reference to a module with the specified ID.
     const ModuleBase & GetModule(int id) const { return *modules[(size_t) id]; }
     ModuleBase & GetModule(int id) { return *modules[(size_t) id]; }
@@ -317,6 +665,13 @@ namespace mabe {
     /// Resets ALL traits for a given organism to their default values
     void ResetTraits(Organism& org){
       trait_man.ResetAll(org.GetDataMap());
+      org.MarkOutputStale();   // Output traits were reset too.
+    }
+
+    /// Resets only traits marked SetPerLifetime() (e.g., per-lifetime counters) to defaults.
+    void ResetLifetimeTraits(Organism& org){
+      trait_man.ResetLifetime(org.GetDataMap());
+      org.MarkOutputStale();
     }
 
     /// Return the DataMap for organisms
@@ -338,6 +693,12 @@ namespace mabe {
       return BuildTraitEquation(pop.GetDataLayout(), equation);
     }
 
+    /// Calculate an equation for each organism in a population or collection, in order.
+    template <typename CONTAINER_T>
+    emp::vector<double> EvalTraitEquation(CONTAINER_T & orgs, const emp::String & equation) {
+      return config_script.EvalTraitEquation(orgs, equation);
+    }
+
     const std::set<emp::String> & GetEquationTraits(const emp::String & equation) {
       return config_script.GetEquationTraits(equation);
     }
@@ -352,6 +713,7 @@ namespace mabe {
     emp::Datum Execute(const emp::String & cmd) { return config_script.Execute(cmd); }
 
     bool OK();           ///< Sanity checks for debugging
+    bool CheckIntegrity(); ///< Sanity checks for this update, as set by check_interval/samples.
 
     // Checks for which modules are actively being triggered.
     using mod_ptr_t = emp::Ptr<ModuleBase>;
@@ -362,13 +724,17 @@ namespace mabe {
     bool OnInjectReady_IsTriggered(mod_ptr_t mod) { return on_inject_ready_sig.cur_mod == mod; };
     bool BeforePlacement_IsTriggered(mod_ptr_t mod) { return before_placement_sig.cur_mod == mod; };
     bool OnPlacement_IsTriggered(mod_ptr_t mod) { return on_placement_sig.cur_mod == mod; };
+    bool OnPlacementBatch_IsTriggered(mod_ptr_t mod) { return on_placement_batch_sig.cur_mod == mod; };
     bool BeforeMutate_IsTriggered(mod_ptr_t mod) { return before_mutate_sig.cur_mod == mod; };
     bool OnMutate_IsTriggered(mod_ptr_t mod) { return on_mutate_sig.cur_mod == mod; };
     bool BeforeDeath_IsTriggered(mod_ptr_t mod) { return before_death_sig.cur_mod == mod; };
+    bool BeforeDeathBatch_IsTriggered(mod_ptr_t mod) { return before_death_batch_sig.cur_mod == mod; };
     bool BeforeSwap_IsTriggered(mod_ptr_t mod) { return before_swap_sig.cur_mod == mod; };
     bool OnSwap_IsTriggered(mod_ptr_t mod) { return on_swap_sig.cur_mod == mod; };
     bool BeforePopResize_IsTriggered(mod_ptr_t mod) { return before_pop_resize_sig.cur_mod == mod; };
     bool OnPopResize_IsTriggered(mod_ptr_t mod) { return on_pop_resize_sig.cur_mod == mod; };
+    bool BeforePopSwap_IsTriggered(mod_ptr_t mod) { return before_pop_swap_sig.cur_mod == mod; };
+    bool OnPopSwap_IsTriggered(mod_ptr_t mod) { return on_pop_swap_sig.cur_mod == mod; };
     bool BeforeExit_IsTriggered(mod_ptr_t mod) { return before_exit_sig.cur_mod == mod; };
     bool OnHelp_IsTriggered(mod_ptr_t mod) { return on_help_sig.cur_mod == mod; };
   };
@@ -448,12 +814,72 @@ namespace mabe {
 
     mabe::Batch batch(config_filenames[0], args[0]);
     batch.Process();
+    if (batch_jobs) batch.SetNumJobs(batch_jobs);
     batch.Run();
   }
 
+  /// Each replicate gets its own controller (and so its own random generator, populations, and
+  /// modules), built from the same arguments plus its own random_seed.  Modules share
+  /// read-only data between them through SharedResources.  Output file names should differ
+  /// between replicates (e.g., by including random_seed), or they will overwrite each other.
+  void MABE::RunReplicates() {
+    exit_now = true;  // This controller only launches the replicates.
+
+    if (!setup_empty_fun) {
+      emp::notify::Error("Replicates require SetupEmpty() to be called before Setup().");
+      return;
+    }
+
+    // Copy the arguments, leaving out the --replicates option.
+    emp::vector<emp::String> base_args;
+    for (size_t pos = 0; pos < args.size(); ++pos) {
+      if (pos && (args[pos] == "--replicates" || args[pos] == "-R")) {
+        while (pos+1 < args.size() && args[pos+1][0] != '-') ++pos;
+      }
+      else base_args.push_back(args[pos]);
+    }
+
+    std::cout << "Running " << num_replicates << " replicates with seeds " << first_replicate_seed
+              << " to " << (first_replicate_seed + (int) num_replicates - 1) << "." << std::endl;
+    emp::vector<std::thread> threads;
+    for (size_t rep_id = 0; rep_id < num_replicates; ++rep_id) {
+      const int seed = first_replicate_seed + (int) rep_id;
+      threads.emplace_back([this, &base_args, seed](){
+        emp::vector<emp::String> rep_args = base_args;
+        rep_args.push_back("-s");
+        rep_args.push_back(emp::String("random_seed=") + std::to_string(seed));
+        MABE replicate(rep_args);
+        setup_empty_fun(replicate);
+        if (replicate.Setup()) replicate.Update(REPLICATE_UPDATES);
+      });
+    }
+    for (std::thread & thread : threads) thread.join();
+  }
+
   void MABE::ProcessArgs() {
     arg_set.emplace_back("--batch", "-b",    "[filename]    ", "Process a full batch of runs",
-      [this](const emp::vector<emp::String> & in){ config_filenames = in; RunBatch(); } );    
+      [this](const emp::vector<emp::String> & in){ config_filenames = in; run_batch = true; } );
+    arg_set.emplace_back("--jobs", "-j", "[N]           ", "Number of batch runs to execute at once",
+      [this](const emp::vector<emp::String> & in){
+        const long long jobs = (in.size() == 1) ? std::atoll(in[0].c_str()) : 0;
+        if (jobs < 1) {
+          std::cout << "'--jobs' must be followed by a single positive number.\n";
+          exit_now = true;
+        }
+        else batch_jobs = (size_t) jobs;
+      });
+    arg_set.emplace_back("--cache", "-c",   "[dir]         ", "Reuse tokenized config files cached in dir",
+      [this](const emp::vector<emp::String> & in){
+        config_script.SetTokenCacheDir(in.size() ? in[0] : emp::String("mabe_cache"));
+      });
+    arg_set.emplace_back("--emit-cpp", "-e", "[filename]    ", "Write event actions as C++ (see 'make aot')",
+      [this](const emp::vector<emp::String> & in) {
+        if (in.size() != 1) {
+          std::cout << "'--emit-cpp' must be followed by a single filename.\n";
+          exit_now = true;
+        }
+        else emit_cpp_filename = in[0];
+      });
     arg_set.emplace_back("--filename", "-f", "[filename...] ", "Filenames of configuration settings",
       [this](const emp::vector<emp::String> & in){ config_filenames = in; } );
     arg_set.emplace_back("--generate", "-g", "[filename]    ", "Generate a new output file",
@@ -479,6 +905,31 @@ namespace mabe {
       });
     arg_set.emplace_back("--modules", "-m", "              ", "Module list",
       [this](const emp::vector<emp::String> &){ ShowModules(); } );
+    arg_set.emplace_back("--preparse", "-p", "[dir]         ", "Tokenize config files into the cache and exit",
+      [this](const emp::vector<emp::String> & in){
+        config_script.SetTokenCacheDir(in.size() ? in[0] : emp::String("mabe_cache"));
+        preparse_only = true;
+      });
+    arg_set.emplace_back("--replicates", "-R", "[N] [seed]    ", "Run N replicates on N threads (seeds from 'seed')",
+      [this](const emp::vector<emp::String> & in){
+        const long long count = (in.size() >= 1 && in.size() <= 2) ? std::atoll(in[0].c_str()) : 0;
+        if (count < 1) {
+          std::cout << "'--replicates' must be followed by a positive count (and optional first seed).\n";
+          exit_now = true;
+        }
+        else {
+          num_replicates = (size_t) count;
+          if (in.size() == 2) first_replicate_seed = std::atoi(in[1].c_str());
+        }
+      });
+    arg_set.emplace_back("--restore", "-r", "[filename]    ", "Continue a run from a checkpoint file",
+      [this](const emp::vector<emp::String> & in) {
+        if (in.size() != 1) {
+          std::cout << "'--restore' must be followed by a single filename.\n";
+          exit_now = true;
+        }
+        else restore_filename = in[0];
+      });
     arg_set.emplace_back("--set", "-s", "[param=value] ", "Set specified parameter",
       [this](const emp::vector<emp::String> & in){
         std::cout << "Adding command-line setting:";
@@ -487,6 +938,14 @@ namespace mabe {
         emp::Append(config_settings, in);
         config_settings.push_back(";"); // Extra semi-colon so not needed on command line.
       });
+    arg_set.emplace_back("--stop_file", "-x", "[filename]    ", "Exit at the next update once this file exists",
+      [this](const emp::vector<emp::String> & in) {
+        if (in.size() != 1) {
+          std::cout << "'--stop_file' must be followed by a single filename.\n";
+          exit_now = true;
+        }
+        else stop_filename = in[0];
+      });
     arg_set.emplace_back("--version", "-v", "              ", "Version ID of MABE",
       [this](const emp::vector<emp::String> &){
         std::cout << "MABE v" << VERSION << "\n";
@@ -523,12 +982,24 @@ namespace mabe {
     }
 
     if (show_help) ShowHelp();
+    else if (run_batch && !exit_now) RunBatch();
+    else if (num_replicates && !exit_now) RunReplicates();
   }
 
   void MABE::Setup_CommandLine() {
     ProcessArgs();         // Deal with command-line inputs.
     if (exit_now) return;  // If command-line arguments require exit (e.g., after '--help')
 
+    // If we are only filling the token cache, do so without running anything.
+    if (preparse_only) {
+      for (const emp::String & fn : config_filenames) {
+        std::cout << "Preparsing file '" << fn << "'." << std::endl;
+        config_script.Preparse(fn);
+      }
+      exit_now = true;
+      return;
+    }
+
     // If filenames have been specified on command line, load each in order.
     if (config_filenames.size()) {
       std::cout << "Loading file(s): " << emp::MakeQuotedList(config_filenames) << std::endl;
@@ -547,6 +1018,14 @@ namespace mabe {
       config_script.Write(gen_filename);
       exit_now = true;
     }    
+
+    // If we are compiling the event actions to C++, do so and then exit.
+    if (emit_cpp_filename != "") {
+      std::cout << "Writing event actions as C++ to '" << emit_cpp_filename << "'." << std::endl;
+      std::ofstream out_file(emit_cpp_filename);
+      config_script.GetSymbolTable().WriteEventsCpp(out_file);
+      exit_now = true;
+    }
   }
 
   /// As part of the main Setup(), run SetupModule() method on each module we've loaded.
@@ -570,6 +1049,7 @@ namespace mabe {
     trait_man.Verify(verbose);            // Make sure modules are accessing traits consistently
     trait_man.RegisterAll(org_data_map);  // Load in all of the traits to the DataMap
     org_data_map.LockLayout();            // Freeze the data map into its current state
+    trait_man.BuildResetImage(org_data_map);  // Precompute default values for fast resets.
 
     // Alert modules (especially org managers) to the final set of traits.
     for (emp::Ptr<ModuleBase> mod_ptr : modules) {
@@ -581,7 +1061,7 @@ namespace mabe {
   /// Link signals to the modules that implement responses to those signals.
   void MABE::UpdateSignals() {
     // Clear all module vectors.
-    for (auto modv : sig_ptrs) modv->resize(0);
+    for (auto modv : sig_ptrs) { modv->resize(0); modv->prof_slots.resize(0); }
 
     // Loop through each module to update its signals.
     for (emp::Ptr<ModuleBase> mod_ptr : modules) {
@@ -591,10 +1071,82 @@ namespace mabe {
       }
     }
 
+    BuildUpdateStages(before_update_sig, before_update_stages);
+    BuildUpdateStages(on_update_sig, on_update_stages);
+
     // Now that we have scanned the signals, we can turn off the re-scan flag.
     rescan_signals = false;
   }
 
+  void MABE::RunParallelStatements(const emplode::SymbolTableBase::call_objs_t & calls,
+                                   const std::function<void(size_t)> & run_statement) {
+    // A statement can overlap others only if everything it calls is a member function of a
+    // module that opted in with SetConcurrentCalls() (so its trait use is known and it touches
+    // no shared state); anything else (e.g., a selection, a population or global function)
+    // runs on its own, in order.
+    emp::vector<emp::vector<emp::Ptr<ModuleBase>>> call_mods(calls.size());
+    emp::vector<bool> is_safe(calls.size(), true);
+    for (size_t id = 0; id < calls.size(); ++id) {
+      if (calls[id].size() == 0) is_safe[id] = false;
+      for (emp::Ptr<emplode::EmplodeType> obj : calls[id]) {
+        emp::Ptr<ModuleBase> mod_ptr = obj ? dynamic_cast<ModuleBase *>(obj.Raw()) : nullptr;
+        if (mod_ptr && mod_ptr->IsConcurrentCalls()) call_mods[id].push_back(mod_ptr);
+        else is_safe[id] = false;
+      }
+    }
+
+    ConflictSchedule stages;
+    stages.BuildOptIn(calls.size(), [&is_safe](size_t id) { return is_safe[id]; },
+                      [this,&call_mods](size_t id1, size_t id2) {
+      for (emp::Ptr<ModuleBase> mod1 : call_mods[id1]) {
+        for (emp::Ptr<ModuleBase> mod2 : call_mods[id2]) {
+          if (mod1 == mod2 || trait_man.HasTraitConflict(mod1, mod2)) return true;
+        }
+      }
+      return false;
+    });
+
+    for (size_t stage_id = 0; stage_id < stages.GetNumStages(); ++stage_id) {
+      const emp::vector<size_t> & stage = stages.GetStage(stage_id);
+      if (stage.size() == 1) run_statement(stage[0]);
+      else thread_pool.ForEachTask(stage.size(), [&](size_t id){ run_statement(stage[id]); });
+    }
+  }
+
+  void MABE::BuildUpdateStages(const sig_base_t & sig, ConflictSchedule & stages) {
+    if (!concurrent_modules) { stages.Build(0, [](size_t, size_t){ return true; }); return; }
+    stages.BuildOptIn(sig.size(), [&sig](size_t id) { return sig[id]->IsConcurrentUpdate(); },
+                      [this,&sig](size_t id1, size_t id2) {
+      return trait_man.HasTraitConflict(sig[id1], sig[id2]);
+    });
+    if (verbose && !stages.IsSerial()) {
+      std::cout << "Running " << sig.size() << " '" << sig.name << "' modules in "
+                << stages.GetNumStages() << " stages." << std::endl;
+    }
+  }
+
+  void MABE::TriggerUpdateStages(SigListener<ModuleBase,void,size_t> & sig,
+                                 const ConflictSchedule & stages, size_t ud) {
+    // Timing is per module and not thread safe, so profiling runs everything in order.
+    if (stages.IsSerial() || stages.GetNumTasks() != sig.size() || sig.profiler ||
+        !thread_pool.IsParallel()) {
+      sig.Trigger(ud);
+      return;
+    }
+    for (size_t stage_id = 0; stage_id < stages.GetNumStages(); ++stage_id) {
+      const emp::vector<size_t> & stage = stages.GetStage(stage_id);
+      if (stage.size() == 1) {
+        sig.cur_mod = sig[stage[0]];
+        (sig.cur_mod.Raw()->*sig.fun)(ud);
+        sig.cur_mod = nullptr;
+        continue;
+      }
+      thread_pool.ForEachTask(stage.size(), [&sig, &stage, ud](size_t id) {
+        (sig[stage[id]].Raw()->*sig.fun)(ud);
+      });
+    }
+  }
+
 
   // ---------------- PUBLIC MEMBER FUNCTIONS -----------------
 
@@ -612,6 +1164,25 @@ namespace mabe {
     pop_type.AddMemberFunction("INJECT", inject_fun,
       "Inject organisms into population.  Args: org_name, org_count; Return: OrgList of injected orgs.");
 
+    std::function<int(Population &, const emp::String &)> snapshot_fun =
+      [this](Population & pop, const emp::String & filename) {
+        return (int) WriteSnapshot(pop, filename);
+      };
+    pop_type.AddMemberFunction("SNAPSHOT", snapshot_fun,
+      "Write all organisms to a column-oriented binary file.  Args: filename; Return: success.");
+    std::function<int(Population &, const emp::String &)> load_snapshot_fun =
+      [this](Population & pop, const emp::String & filename) {
+        return (int) LoadSnapshot(pop, filename);
+      };
+    pop_type.AddMemberFunction("LOAD_SNAPSHOT", load_snapshot_fun,
+      "Replace organisms with those from a SNAPSHOT file.  Args: filename; Return: success.");
+
+    config_script.GetSymbolTable().SetParallelFun(
+      [this](const emplode::SymbolTableBase::call_objs_t & calls,
+             const std::function<void(size_t)> & run_statement) {
+        RunParallelStatements(calls, run_statement);
+      });
+
     // Setup all known modules as available types in the config file.
     for (auto & [type_name,mod] : GetModuleMap()) {
       auto mod_init_fun = [this,mod=&mod](const emp::String & name) -> emp::Ptr<emplode::EmplodeType> {
@@ -630,6 +1201,11 @@ namespace mabe {
     args = emp::cl::ArgsToStrings(argc, argv);
   }
 
+  MABE::MABE(const emp::vector<emp::String> & in_args) : MABE()
+  {
+    args = in_args;
+  }
+
   bool MABE::Setup() {
     // Read in command line arguments, respond to flags, load associated files, and deal with
     // any other command-line settings.
@@ -640,22 +1216,445 @@ namespace mabe {
     Setup_Traits();     // Make sure module traits do not clash.
     UpdateSignals();    // Setup the appropriate modules to be linked with each signal.
     SetupBase();        // Call Setup on MABEBase (which will report errors)
+    links_frozen = true;  // Names in module links are resolved; later lookups are slow paths.
+
+    // If we were asked to continue a previous run, load its state now that modules are ready.
+    if (restore_filename != "" && !Restore(restore_filename)) return false;
+
+    return true;
+  }
+
+  namespace internal {
+    static constexpr const char * CHECKPOINT_MAGIC = "MABE-CHECKPOINT";
+    static constexpr uint32_t CHECKPOINT_VERSION = 2;
+    static constexpr uint32_t CHECKPOINT_EMPTY = (uint32_t) -1;  ///< Type ID for empty positions.
+    static constexpr const char * CHECKPOINT_DELTA_MAGIC = "MABE-CHECKPOINT-DELTA";
+    static constexpr uint32_t CHECKPOINT_SAME_ORG = (uint32_t) -2; ///< Delta: only traits changed.
+    static constexpr uint64_t CHECKPOINT_END = (uint64_t) -1;     ///< Delta: no more positions.
+  }
+
+  bool MABE::Checkpoint(const emp::String & filename) { return WriteCheckpoint(filename, false); }
+
+  bool MABE::CheckpointDelta(const emp::String & filename) {
+    if (last_checkpoint.empty()) {
+      emp::notify::Warning("No earlier checkpoint for delta '", filename, "'; writing a full checkpoint.");
+    }
+    return WriteCheckpoint(filename, !last_checkpoint.empty());
+  }
+
+  /// Checkpoint layout: header (magic, version, update, RNG state, run stats), trait table,
+  /// organism type table, each population (name, size, per position: type ID, organism state,
+  /// then trait values in trait table order), and finally one named block per module.
+  ///
+  /// A delta uses its own magic and adds the name of the checkpoint it builds on after the
+  /// version.  Its populations list only changed positions, each as position and type ID
+  /// (CHECKPOINT_EMPTY if removed; CHECKPOINT_SAME_ORG if only traits changed, followed by the
+  /// traits), ending with CHECKPOINT_END.
+  bool MABE::WriteCheckpoint(const emp::String & filename, bool delta) {
+    using namespace internal;
+    std::ofstream file(filename.str(), std::ios::binary);
+    if (!file) {
+      emp::notify::Error("Unable to open checkpoint file '", filename, "' for writing.");
+      return false;
+    }
+    CheckpointWriter out(file);
+
+    out.Write<std::string>(delta ? CHECKPOINT_DELTA_MAGIC : CHECKPOINT_MAGIC);
+    out.Write(CHECKPOINT_VERSION);
+    if (delta) out.Write(last_checkpoint);
+    out.Write<uint64_t>(update);
+    // The generator holds only plain values, so its bytes are its full state.
+    static_assert(std::is_trivially_copyable_v<emp::Random>);
+    out.Write(std::string(reinterpret_cast<const char *>(&random), sizeof(emp::Random)));
+    out.Write(emp::vector<uint64_t>{ run_stats.births, run_stats.injections, run_stats.deaths,
+      run_stats.evaluations, run_stats.insts_executed, run_stats.allocations });
+
+    const emp::vector<emp::Ptr<TraitInfo>> traits = trait_man.GetCheckpointTraits();
+    out.Write<uint64_t>(traits.size());
+    for (emp::Ptr<TraitInfo> trait_ptr : traits) {
+      out.Write(trait_ptr->GetName());
+      out.Write(emp::String(trait_ptr->GetType().GetName()));
+      out.Write<uint64_t>(trait_ptr->GetValueCount());
+    }
+
+    // Organism types are written once and referred to by ID.
+    emp::vector<emp::String> type_names;
+    std::unordered_map<emp::String, uint32_t> type_ids;
+    for (emp::Ptr<Population> pop_ptr : pops) {
+      for (size_t pos = 0; pos < pop_ptr->GetSize(); ++pos) {
+        if (pop_ptr->IsEmpty(pos)) continue;
+        const emp::String & type_name = (*pop_ptr)[pos].GetManagerName();
+        if (type_ids.find(type_name) == type_ids.end()) {
+          type_ids[type_name] = (uint32_t) type_names.size();
+          type_names.push_back(type_name);
+        }
+      }
+    }
+    out.Write(type_names);
+
+    std::unordered_map<emp::String, emp::vector<CheckpointSlot>> new_slots;
+    std::string state, trait_bytes;
+    out.Write<uint64_t>(pops.size());
+    for (emp::Ptr<Population> pop_ptr : pops) {
+      out.Write(pop_ptr->GetName());
+      out.Write<uint64_t>(pop_ptr->GetSize());
+      emp::vector<CheckpointSlot> & slots = new_slots[pop_ptr->GetName()];
+      slots.resize(pop_ptr->GetSize());
+      const emp::vector<CheckpointSlot> & old_slots = checkpoint_slots[pop_ptr->GetName()];
+      for (size_t pos = 0; pos < pop_ptr->GetSize(); ++pos) {
+        const CheckpointSlot old_slot = (delta && pos < old_slots.size()) ? old_slots[pos] : CheckpointSlot{};
+        if (pop_ptr->IsEmpty(pos)) {
+          if (!delta) out.Write(CHECKPOINT_EMPTY);
+          else if (old_slot.state_hash) { out.Write<uint64_t>(pos); out.Write(CHECKPOINT_EMPTY); }
+          continue;
+        }
+        const Organism & org = (*pop_ptr)[pos];
+        if (!SaveOrgRecord(org, traits, state, trait_bytes)) {
+          emp::notify::Error("Organism type '", org.GetManagerName(),
+                             "' does not support checkpoints; '", filename, "' is incomplete.");
+          return false;
+        }
+        slots[pos] = CalcCheckpointSlot(org.GetManagerName(), state, trait_bytes);
+        if (delta && slots[pos].state_hash == old_slot.state_hash) {
+          if (slots[pos].trait_hash == old_slot.trait_hash) continue;   // Unchanged.
+          out.Write<uint64_t>(pos);
+          out.Write(CHECKPOINT_SAME_ORG);
+          out.WriteBytes(trait_bytes.data(), trait_bytes.size());
+          continue;
+        }
+        if (delta) out.Write<uint64_t>(pos);
+        out.Write(type_ids[org.GetManagerName()]);
+        out.WriteBytes(state.data(), state.size());
+        out.WriteBytes(trait_bytes.data(), trait_bytes.size());
+      }
+      if (delta) out.Write(CHECKPOINT_END);
+    }
+
+    out.Write<uint64_t>(modules.size());
+    for (emp::Ptr<ModuleBase> mod_ptr : modules) {
+      out.Write(mod_ptr->GetName());
+      out.WriteBlock([mod_ptr](CheckpointWriter & block){ mod_ptr->SaveState(block); });
+    }
+
+    if (!out.IsOK()) {
+      emp::notify::Error("Error writing checkpoint file '", filename, "'.");
+      return false;
+    }
+    checkpoint_slots = std::move(new_slots);
+    last_checkpoint = std::filesystem::absolute(filename.str()).string();  // Forks change directory.
+    return true;
+  }
+
+  void MABE::RecordCheckpointSlots(const emp::String & filename) {
+    const emp::vector<emp::Ptr<TraitInfo>> traits = trait_man.GetCheckpointTraits();
+    std::string state, trait_bytes;
+    checkpoint_slots.clear();
+    for (emp::Ptr<Population> pop_ptr : pops) {
+      emp::vector<CheckpointSlot> & slots = checkpoint_slots[pop_ptr->GetName()];
+      slots.resize(pop_ptr->GetSize());
+      for (size_t pos = 0; pos < pop_ptr->GetSize(); ++pos) {
+        if (pop_ptr->IsEmpty(pos)) continue;
+        const Organism & org = (*pop_ptr)[pos];
+        if (SaveOrgRecord(org, traits, state, trait_bytes)) {
+          slots[pos] = CalcCheckpointSlot(org.GetManagerName(), state, trait_bytes);
+        }
+      }
+    }
+    last_checkpoint = std::filesystem::absolute(filename.str()).string();
+  }
+
+  void MABE::WriteMemoryReport(std::ostream & os) const {
+    const std::ios::fmtflags old_flags = os.flags();
+    const std::streamsize old_precision = os.precision();
+    auto write_line = [&os](const emp::String & label, size_t num_bytes, const emp::String & note) {
+      os << "  " << std::left << std::setw(32) << label << std::right << std::setw(12)
+         << std::fixed << std::setprecision(2) << (num_bytes / 1048576.0) << " MB" << note << '\n';
+    };
+    size_t total = 0;
+    for (emp::Ptr<Population> pop_ptr : pops) {
+      const size_t num_bytes = pop_ptr->GetNumBytes();
+      write_line("pop " + pop_ptr->GetName(), num_bytes,
+                 emp::MakeString("  (", pop_ptr->GetNumOrgs(), " orgs)"));
+      total += num_bytes;
+    }
+    for (emp::Ptr<ModuleBase> mod_ptr : modules) {
+      const size_t num_bytes = mod_ptr->GetNumBytes();
+      if (num_bytes == 0) continue;
+      write_line("module " + mod_ptr->GetName(), num_bytes, "");
+      total += num_bytes;
+    }
+    write_line("total", total, emp::MakeString("  (", run_stats.allocations, " allocations, ",
+                                               update_allocations, " in last update)"));
+    os.flags(old_flags);
+    os.precision(old_precision);
+  }
+
+  size_t MABE::Fork(size_t num_forks, const emp::String & dir_prefix) {
+#if defined(__unix__) || defined(__APPLE__)
+    // Only the calling thread is copied into a child, so stop every other thread first; one
+    // holding a lock when we fork would leave that lock held forever in the child.
+    WaitForBackground();
+    background_jobs.Stop();
+    for (auto & fun : fork_funs) fun();
+    emplode::AsyncStreamWriter::PauseAll();
+    std::cout.flush();
+    std::cerr.flush();
+    const size_t num_threads = thread_pool.GetNumThreads();
+    thread_pool.SetNumThreads(1);
+
+    emp::vector<pid_t> children;
+    for (size_t fork_id = 1; fork_id <= num_forks; ++fork_id) {
+      const pid_t pid = fork();
+      if (pid < 0) {
+        emp::notify::Warning("Unable to fork run ", fork_id, " of ", num_forks, ".");
+        break;
+      }
+      if (pid == 0) {   // In the child: give it its own random seed and output directory.
+        random.ResetSeed(GetRandomStreams().CalcSeed(update, FORK_SALT, fork_id));
+        const std::filesystem::path dir((dir_prefix + emp::MakeString(fork_id)).str());
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        if (error) {
+          emp::notify::Error("Forked run ", fork_id, " could not create directory '",
+                             dir.string(), "': ", error.message());
+        }
+        else {
+          std::filesystem::current_path(dir, error);
+          if (error) {
+            emp::notify::Error("Forked run ", fork_id, " could not move to directory '",
+                               dir.string(), "': ", error.message());
+          }
+        }
+        thread_pool.SetNumThreads(num_threads);
+        return fork_id;
+      }
+      children.push_back(pid);
+    }
+
+    // In the original process: wait for every child to complete, then end this run.
+    for (size_t i = 0; i < children.size(); ++i) {
+      int status = 0;
+      if (waitpid(children[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        emp::notify::Warning("Forked run ", i + 1, " did not exit cleanly.");
+      }
+    }
+    thread_pool.SetNumThreads(num_threads);
+    RequestExit();
+    return 0;
+#else
+    (void) num_forks; (void) dir_prefix;
+    emp::notify::Error("FORK is only available on Unix systems.");
+    return 0;
+#endif
+  }
 
+  bool MABE::Restore(const emp::String & filename) {
+    if (!RestoreFile(filename)) return false;
+    RecordCheckpointSlots(filename);   // Later deltas can build on this checkpoint.
+    restored = true;
+    std::cout << "Restored run from '" << filename << "' at update " << update << "." << std::endl;
+    return true;
+  }
+
+  bool MABE::RestoreFile(const emp::String & filename) {
+    using namespace internal;
+    std::ifstream file(filename.str(), std::ios::binary);
+    if (!file) {
+      emp::notify::Error("Unable to open checkpoint file '", filename, "'.");
+      return false;
+    }
+    CheckpointReader in(file);
+
+    const std::string magic = in.Read<std::string>();
+    const bool delta = (magic == CHECKPOINT_DELTA_MAGIC);
+    if ((!delta && magic != CHECKPOINT_MAGIC) || in.Read<uint32_t>() != CHECKPOINT_VERSION) {
+      emp::notify::Error("File '", filename, "' is not a checkpoint from this version of MABE.");
+      return false;
+    }
+
+    // A delta applies on top of the checkpoint it was written after; if that file has moved
+    // along with the delta, look for it in the delta's directory.
+    if (delta) {
+      std::filesystem::path base_path(in.Read<emp::String>().str());
+      if (!std::filesystem::exists(base_path)) {
+        base_path = std::filesystem::path(filename.str()).parent_path() / base_path.filename();
+      }
+      if (!RestoreFile(base_path.string())) return false;
+    }
+
+    update = in.Read<uint64_t>();
+    const std::string random_state = in.Read<std::string>();
+    if (random_state.size() != sizeof(emp::Random)) {
+      emp::notify::Error("Checkpoint '", filename, "' has a random number generator state from another build.");
+      return false;
+    }
+    std::memcpy(static_cast<void *>(&random), random_state.data(), sizeof(emp::Random));
+    const emp::vector<uint64_t> stats = in.Read<emp::vector<uint64_t>>();
+
+    // The traits in the checkpoint must exactly match those of the current configuration.
+    const emp::vector<emp::Ptr<TraitInfo>> traits = trait_man.GetCheckpointTraits();
+    const uint64_t num_traits = in.Read<uint64_t>();
+    bool traits_match = (num_traits == traits.size());
+    for (size_t i = 0; i < num_traits; ++i) {
+      const emp::String name = in.Read<emp::String>();
+      const emp::String type_name = in.Read<emp::String>();
+      const uint64_t count = in.Read<uint64_t>();
+      traits_match = traits_match && name == traits[i]->GetName()
+        && type_name == emp::String(traits[i]->GetType().GetName())
+        && count == traits[i]->GetValueCount();
+    }
+    if (!traits_match) {
+      emp::notify::Error("Traits in checkpoint '", filename,
+                         "' do not match the current configuration.");
+      return false;
+    }
+
+    emp::vector<int> type_mods;
+    for (const emp::String & type_name : in.Read<emp::vector<emp::String>>()) {
+      type_mods.push_back(GetModuleID(type_name));
+      if (type_mods.back() < 0) {
+        emp::notify::Error("Checkpoint '", filename, "' uses unknown organism type '", type_name, "'.");
+        return false;
+      }
+    }
+
+    const uint64_t num_pops = in.Read<uint64_t>();
+    for (size_t i = 0; i < num_pops; ++i) {
+      const emp::String pop_name = in.Read<emp::String>();
+      const uint64_t pop_size = in.Read<uint64_t>();
+      const size_t pop_id = GetPopulationID(pop_name);
+      if (pop_id == emp::MAX_SIZE_T) {
+        emp::notify::Error("Checkpoint '", filename, "' uses unknown population '", pop_name, "'.");
+        return false;
+      }
+      Population & pop = GetPopulation(pop_id);
+      if (delta) ResizePop(pop, pop_size);   // Deltas list only the positions that changed.
+      else EmptyPop(pop, pop_size);
+      for (size_t i = 0; delta || i < pop_size; ++i) {
+        const uint64_t pos = delta ? in.Read<uint64_t>() : i;
+        if (pos == CHECKPOINT_END || !in.IsOK()) break;
+        const uint32_t type_id = in.Read<uint32_t>();
+        if (pos >= pop_size || (type_id >= type_mods.size() && type_id != CHECKPOINT_EMPTY
+                                && type_id != CHECKPOINT_SAME_ORG)) {
+          emp::notify::Error("Checkpoint '", filename, "' is corrupt.");
+          return false;
+        }
+        if (type_id == CHECKPOINT_EMPTY) { ClearOrgAt(pop.IteratorAt(pos)); continue; }
+        if (type_id == CHECKPOINT_SAME_ORG) {
+          if (pop.IsEmpty(pos)) {
+            emp::notify::Error("Checkpoint '", filename, "' does not match the checkpoint it builds on.");
+            return false;
+          }
+          for (emp::Ptr<TraitInfo> trait_ptr : traits) trait_ptr->LoadValue(pop[pos].GetDataMap(), in);
+          continue;
+        }
+        emp::Ptr<Organism> org_ptr = GetModule(type_mods[type_id]).Make<Organism>();
+        org_ptr->LoadState(in);
+        for (emp::Ptr<TraitInfo> trait_ptr : traits) trait_ptr->LoadValue(org_ptr->GetDataMap(), in);
+        AddOrgAt(org_ptr, pop.IteratorAt(pos));
+      }
+    }
+
+    // Module state comes last so that it overrides anything set while placing organisms.
+    const uint64_t num_mods = in.Read<uint64_t>();
+    for (size_t i = 0; i < num_mods; ++i) {
+      const emp::String mod_name = in.Read<emp::String>();
+      const int mod_id = GetModuleID(mod_name);
+      if (mod_id < 0) {
+        emp::notify::Warning("Ignoring state for unknown module '", mod_name, "' in checkpoint.");
+        in.SkipBlock();
+      }
+      else in.ReadBlock([this,mod_id](CheckpointReader & block){ GetModule(mod_id).LoadState(block); });
+    }
+
+    if (!in.IsOK() || stats.size() != 6) {
+      emp::notify::Error("Checkpoint '", filename, "' ended unexpectedly.");
+      return false;
+    }
+    run_stats = RunStats{ stats[0], stats[1], stats[2], stats[3], stats[4], stats[5] };
+    return true;
+  }
+
+  bool MABE::LoadSnapshot(Population & pop, const emp::String & filename) {
+    PopSnapshot snapshot;
+    if (!snapshot.Load(filename)) {
+      emp::notify::Error("Unable to load population snapshot '", filename, "'.");
+      return false;
+    }
+
+    emp::vector<int> type_mods;
+    for (const emp::String & type_name : snapshot.GetTypeNames()) {
+      type_mods.push_back(GetModuleID(type_name));
+      if (type_mods.back() < 0) {
+        emp::notify::Error("Snapshot '", filename, "' uses unknown organism type '", type_name, "'.");
+        return false;
+      }
+    }
+
+    // Check every row before changing the population.
+    const size_t num_orgs = snapshot.GetNumOrgs();
+    const size_t new_size = std::max<size_t>(pop.GetSize(), snapshot.GetPopSize());
+    std::span<const uint64_t> positions = snapshot.GetPositions();
+    std::span<const uint32_t> type_ids = snapshot.GetTypeIDs();
+    if (positions.size() != num_orgs || type_ids.size() != num_orgs) {
+      emp::notify::Error("Snapshot '", filename, "' is missing its position or type column.");
+      return false;
+    }
+    if (!snapshot.HasGenomes()) {
+      emp::notify::Error("Snapshot '", filename, "' is missing its genome column.");
+      return false;
+    }
+    for (size_t org_id = 0; org_id < num_orgs; ++org_id) {
+      if (type_ids[org_id] >= type_mods.size()) {
+        emp::notify::Error("Snapshot '", filename, "' row ", org_id, " has unknown type id ",
+                           type_ids[org_id], " (only ", type_mods.size(), " types).");
+        return false;
+      }
+      if (positions[org_id] >= new_size) {
+        emp::notify::Error("Snapshot '", filename, "' row ", org_id, " has position ",
+                           positions[org_id], " outside of the population (size ", new_size, ").");
+        return false;
+      }
+    }
+
+    const emp::vector<emp::Ptr<TraitInfo>> traits = trait_man.GetCheckpointTraits();
+    EmptyPop(pop, new_size);
+    for (size_t org_id = 0; org_id < num_orgs; ++org_id) {
+      emp::Ptr<Organism> org_ptr = GetModule(type_mods[type_ids[org_id]]).Make<Organism>();
+      std::istringstream genome_is(std::string(snapshot.GetGenome(org_id)), std::ios::binary);
+      CheckpointReader genome_in(genome_is);
+      org_ptr->LoadState(genome_in);
+      for (emp::Ptr<TraitInfo> trait_ptr : traits) {
+        snapshot.LoadTrait(org_id, *trait_ptr, org_ptr->GetDataMap());
+      }
+      AddOrgAt(org_ptr, pop.IteratorAt(positions[org_id]));
+    }
     return true;
   }
 
   /// Update MABE world.
   void MABE::Update(size_t num_updates) {
-    if (update == 0) config_script.Trigger("START");
+    if (update == 0 && !restored) config_script.Trigger("START");
 
     const size_t target_update = update + num_updates;
     while (update < target_update && !exit_now) {
-      emp_assert(OK(), update);                 // In debug mode, keep checking MABE integrity
+      // Let an outside process (such as a batch run with early stopping) end the run.
+      if (stop_filename.size() && std::filesystem::exists(stop_filename.str())) {
+        std::cout << "Stop file '" << stop_filename << "' found; exiting." << std::endl;
+        RequestExit();
+        break;
+      }
+      emp_assert(CheckIntegrity(), update);     // In debug mode, keep checking MABE integrity
       if (rescan_signals) UpdateSignals();      // If we have reason to, update module signals
-      before_update_sig.Trigger(update);        // Signal that a new update is about to begin
+      const uint64_t prev_allocations = run_stats.allocations;
+      TriggerUpdateStages(before_update_sig, before_update_stages, update); // Update about to begin
       update++;                                 // Increment 'update' to start new update
-      on_update_sig.Trigger(update);            // Signal all modules about the new update
+      MarkStateChanged();                       // Modules may change any trait from here on
+      TriggerUpdateStages(on_update_sig, on_update_stages, update);         // Signal the new update
       config_script.Trigger("UPDATE", update);  // Trigger any updated-based events
+      for (auto & fun : update_funs) fun(update); // Run any C++ update steps
+      Sync();                                   // Finish deferred work (e.g., queued births)
+      update_allocations = run_stats.allocations - prev_allocations;
     }
   }
 
@@ -668,6 +1667,7 @@ namespace mabe {
     empty_manager.SetBuiltIn();         // Don't write the empty manager to config.
 
     empty_org = empty_manager.template Make<Organism>();
+    setup_empty_fun = [](MABE & replicate){ replicate.SetupEmpty<EMPTY_MANAGER_T>(); };
   }
 
   /// New populations must be given a name and an optional size.
@@ -697,7 +1697,9 @@ namespace mabe {
   /// if more than one is added, return the position of the final injection.
   Collection MABE::Inject(Population & pop, const Organism & org, size_t copy_count) {
     emp_assert(org.GetDataMap().SameLayout(org_data_map));
-    Collection placement_set;
+    Collection placement_set = CollectionPool::Shared().Take();
+    ReservePop(pop, pop.GetSize() + copy_count);
+    BeginPlacementBatch();
     for (size_t i = 0; i < copy_count; i++) {
       emp::Ptr<Organism> inject_org = org.CloneOrganism();
       on_inject_ready_sig.Trigger(*inject_org, pop);
@@ -710,6 +1712,7 @@ namespace mabe {
         emp::notify::Error("Invalid position; failed to inject organism ", i, "!");
       }
     }
+    EndPlacementBatch();
     return placement_set;
   }
 
@@ -736,13 +1739,44 @@ namespace mabe {
             "' into population ", pop.GetID());
 
     auto & org_manager = GetModule(type_name);            // Look up type of organism.
-    Collection placement_set;                             // Track set of positions placed.
-    for (size_t i = 0; i < copy_count; i++) {             // Loop through, injecting each instance.
-      auto org_ptr = org_manager.Make<Organism>(random);  // ...Build an org of this type.
-      OrgPosition pos = InjectInstance(pop, org_ptr);     // ...Inject it into the population.
-      placement_set.Insert(pos);                          // ...Record the position.
+    Collection placement_set = CollectionPool::Shared().Take();  // Track set of positions placed.
+    ReservePop(pop, pop.GetSize() + copy_count);
+    BeginPlacementBatch();
+
+    // Organism types that allow it are initialized across the thread pool, each from its own
+    // random stream; check with a first (uninitialized) clone.
+    emp::vector<emp::Ptr<Organism>> new_orgs;
+    if (parallel_births && thread_pool.IsParallel() && copy_count >= 2) {
+      new_orgs.push_back(org_manager.Make<Organism>());
+      if (!new_orgs[0]->IsInitializeThreadSafe()) { new_orgs[0].Delete(); new_orgs.resize(0); }
+    }
+
+    if (new_orgs.size()) {
+      // Clone every organism, initialize them all across the pool, then place them in order.
+      new_orgs.resize(copy_count);
+      for (size_t i = 1; i < copy_count; i++) new_orgs[i] = org_manager.Make<Organism>();
+      const RandomStreams streams = GetRandomStreams();
+      const int pop_id = pop.GetID();
+      const size_t call_id = NextStreamCall();
+      thread_pool.ForEachChunk(copy_count, [&](size_t, size_t start, size_t end) {
+        emp::Random rng(1);
+        for (size_t i = start; i < end; ++i) {
+          streams.Reseed(rng, update, call_id, pop_id, i, INJECT_SALT);
+          new_orgs[i]->Initialize(rng);
+          new_orgs[i]->MarkGenomeChanged();
+        }
+      });
+      for (emp::Ptr<Organism> org_ptr : new_orgs) placement_set.Insert(InjectInstance(pop, org_ptr));
+    }
+    else {
+      for (size_t i = 0; i < copy_count; i++) {           // Loop through, injecting each instance.
+        auto org_ptr = org_manager.Make<Organism>(random); // ...Build an org of this type.
+        OrgPosition pos = InjectInstance(pop, org_ptr);   // ...Inject it into the population.
+        placement_set.Insert(pos);                        // ...Record the position.
+      }
     }
 
+    EndPlacementBatch();
     return placement_set;                                 // Return last position injected.
   }
 
@@ -774,7 +1808,7 @@ namespace mabe {
     before_repro_sig.Trigger(ppos);                 // Signal reproduction event.
     OrgPosition pos;                                // Position of each offspring placed.
     emp::Ptr<Organism> new_org;
-    Collection birth_list;                          // Track positions of all offspring.
+    Collection birth_list = CollectionPool::Shared().Take();  // Track positions of all offspring.
     for (size_t i = 0; i < birth_count; i++) {      // Loop through offspring, adding each
       new_org = do_mutations ? org.MakeOffspringOrganism(random) : org.CloneOrganism();
 
@@ -787,8 +1821,184 @@ namespace mabe {
         AddOrgAt(new_org, pos, ppos);
         birth_list.Insert(pos);
       }
-      else new_org.Delete();
+      else new_org->Recycle();
+    }
+    return birth_list;
+  }
+
+  void MABE::PlaceOffspring(const Organism & org, OrgPosition ppos, Population & target_pop,
+                            bool do_mutations, emp::vector<size_t> & placed,
+                            Collection & other_list) {
+    emp_assert(org.IsEmpty() == false);   // Empty cells cannot reproduce.
+    emp::Ptr<Organism> new_org = do_mutations ? org.MakeOffspringOrganism(random) : org.CloneOrganism();
+    PlaceNewOffspring(new_org, ppos, target_pop, placed, other_list);
+  }
+
+  void MABE::PlaceNewOffspring(emp::Ptr<Organism> new_org, OrgPosition ppos, Population & target_pop,
+                               emp::vector<size_t> & placed, Collection & other_list) {
+    on_offspring_ready_sig.Trigger(*new_org, ppos, target_pop);
+    OrgPosition pos = target_pop.PlaceBirth(*new_org, ppos);
+
+    if (!pos.IsValid()) { new_org->Recycle(); return; }
+    AddOrgAt(new_org, pos, ppos);
+    if (pos.IsInPop(target_pop)) placed.push_back(pos.Pos());
+    else other_list.Insert(pos);    // Placement function moved offspring to another population.
+  }
+
+  Collection MABE::DoBirths(std::span<const OrgPosition> parents,
+                            Population & target_pop,
+                            bool do_mutations) {
+    emp::vector<size_t> placed;       // Positions of offspring in target_pop.
+    placed.reserve(parents.size());
+    Collection birth_list = CollectionPool::Shared().Take();
+    ReservePop(target_pop, target_pop.GetSize() + parents.size());
+
+    BeginPlacementBatch();
+    if (do_mutations && CanMutateInParallel(parents)) {
+      // Clone every offspring, mutate them all across the pool, then place them in order.
+      emp::vector<emp::Ptr<Organism>> offspring(parents.size());
+      for (size_t i = 0; i < parents.size(); ++i) {
+        OrgPosition ppos = parents[i];
+        if (i == 0 || ppos != parents[i-1]) before_repro_sig.Trigger(ppos);
+        emp_assert(ppos->IsEmpty() == false);   // Empty cells cannot reproduce.
+        offspring[i] = ppos->CloneOrganism();
+      }
+      const RandomStreams streams = GetRandomStreams();
+      const int pop_id = target_pop.GetID();
+      const size_t call_id = NextStreamCall();
+      thread_pool.ForEachChunk(offspring.size(), [&](size_t, size_t start, size_t end) {
+        emp::Random rng(1);
+        for (size_t i = start; i < end; ++i) {
+          streams.Reseed(rng, update, call_id, pop_id, i, BIRTH_SALT);
+          if (offspring[i]->Mutate(rng)) offspring[i]->MarkGenomeChanged();
+        }
+      });
+      for (size_t i = 0; i < parents.size(); ++i) {
+        PlaceNewOffspring(offspring[i], parents[i], target_pop, placed, birth_list);
+      }
     }
+    else {
+      for (size_t i = 0; i < parents.size(); ++i) {
+        OrgPosition ppos = parents[i];
+        if (i == 0 || ppos != parents[i-1]) before_repro_sig.Trigger(ppos);
+        PlaceOffspring(*ppos, ppos, target_pop, do_mutations, placed, birth_list);
+      }
+    }
+    EndPlacementBatch();
+
+    birth_list.InsertPositions(target_pop, std::span<const size_t>(placed.data(), placed.size()));
+    return birth_list;
+  }
+
+  Collection MABE::DoPairedBirths(std::span<const OrgPosition> parents,
+                                  Population & target_pop,
+                                  bool do_mutations) {
+    emp_assert(parents.size() % 2 == 0, parents.size());
+    const size_t num_births = parents.size() / 2;
+    emp::vector<emp::Ptr<Organism>> offspring(num_births);
+    for (size_t i = 0; i < num_births; ++i) {
+      OrgPosition ppos = parents[2*i];
+      emp_assert(ppos->IsEmpty() == false);     // Empty cells cannot reproduce.
+      emp_assert(parents[2*i+1]->IsEmpty() == false);
+      before_repro_sig.Trigger(ppos);
+      offspring[i] = ppos->CloneOrganism();
+    }
+
+    // Recombine (and mutate) each offspring; a type that cannot recombine keeps its clone.
+    std::atomic<size_t> num_failed = 0;
+    auto build = [&](size_t i, emp::Random & rng) {
+      if (!offspring[i]->RecombineInPlace(*parents[2*i+1], rng)) ++num_failed;
+      if (do_mutations) offspring[i]->Mutate(rng);
+      offspring[i]->MarkGenomeChanged();
+    };
+    if (CanMutateInParallel(parents)) {
+      const RandomStreams streams = GetRandomStreams();
+      const int pop_id = target_pop.GetID();
+      const size_t call_id = NextStreamCall();
+      thread_pool.ForEachChunk(num_births, [&](size_t, size_t start, size_t end) {
+        emp::Random rng(1);
+        for (size_t i = start; i < end; ++i) {
+          streams.Reseed(rng, update, call_id, pop_id, i, CROSSOVER_SALT);
+          build(i, rng);
+        }
+      });
+    }
+    else for (size_t i = 0; i < num_births; ++i) build(i, random);
+    if (num_failed) {
+      emp::notify::Error(num_failed.load(), " of ", num_births, " offspring could not be recombined;",
+                         " their organism type does not support RecombineInPlace().");
+    }
+
+    emp::vector<size_t> placed;       // Positions of offspring in target_pop.
+    placed.reserve(num_births);
+    Collection birth_list = CollectionPool::Shared().Take();
+    ReservePop(target_pop, target_pop.GetSize() + num_births);
+    BeginPlacementBatch();
+    for (size_t i = 0; i < num_births; ++i) {
+      PlaceNewOffspring(offspring[i], parents[2*i], target_pop, placed, birth_list);
+    }
+    EndPlacementBatch();
+
+    birth_list.InsertPositions(target_pop, std::span<const size_t>(placed.data(), placed.size()));
+    return birth_list;
+  }
+
+  bool MABE::CanMutateInParallel(std::span<const OrgPosition> parents) const {
+    if (!parallel_births || !thread_pool.IsParallel() || parents.size() < 2) return false;
+    for (size_t i = 0; i < parents.size(); ++i) {
+      if (i && parents[i] == parents[i-1]) continue;
+      if (!parents[i]->IsMutateThreadSafe()) return false;
+    }
+    return true;
+  }
+
+  template <typename FUN_T>
+  Collection MABE::DoBirths(size_t birth_count,
+                            FUN_T && choose_parent,
+                            Population & target_pop,
+                            bool do_mutations) {
+    emp::vector<size_t> placed;       // Positions of offspring in target_pop.
+    placed.reserve(birth_count);
+    Collection birth_list = CollectionPool::Shared().Take();
+    ReservePop(target_pop, target_pop.GetSize() + birth_count);
+
+    BeginPlacementBatch();
+    for (size_t birth_id = 0; birth_id < birth_count; ++birth_id) {
+      OrgPosition ppos = choose_parent(birth_id);
+      before_repro_sig.Trigger(ppos);
+      PlaceOffspring(*ppos, ppos, target_pop, do_mutations, placed, birth_list);
+    }
+    EndPlacementBatch();
+
+    birth_list.InsertPositions(target_pop, std::span<const size_t>(placed.data(), placed.size()));
+    return birth_list;
+  }
+
+  template <typename FUN_T>
+  Collection MABE::DoBirthsBuildFirst(std::span<const OrgPosition> parents,
+                                      FUN_T && prepare,
+                                      Population & target_pop,
+                                      bool do_mutations) {
+    emp::vector<emp::Ptr<Organism>> offspring(parents.size());
+    for (size_t i = 0; i < parents.size(); ++i) {
+      OrgPosition ppos = parents[i];
+      emp_assert(ppos->IsEmpty() == false);     // Empty cells cannot reproduce.
+      before_repro_sig.Trigger(ppos);
+      prepare(i);
+      offspring[i] = do_mutations ? ppos->MakeOffspringOrganism(random) : ppos->CloneOrganism();
+    }
+
+    emp::vector<size_t> placed;       // Positions of offspring in target_pop.
+    placed.reserve(parents.size());
+    Collection birth_list = CollectionPool::Shared().Take();
+    ReservePop(target_pop, target_pop.GetSize() + parents.size());
+    BeginPlacementBatch();
+    for (size_t i = 0; i < parents.size(); ++i) {
+      PlaceNewOffspring(offspring[i], parents[i], target_pop, placed, birth_list);
+    }
+    EndPlacementBatch();
+
+    birth_list.InsertPositions(target_pop, std::span<const size_t>(placed.data(), placed.size()));
     return birth_list;
   }
 
@@ -809,12 +2019,19 @@ namespace mabe {
   }
 
   void MABE::MoveOrgs(Population & from_pop, Population & to_pop, bool reset_to) {
-    // Get the starting point for the new organisms to ove to.
-    Population::iterator_t it_to = reset_to ? to_pop.begin() : to_pop.end();
+    // If we are replacing the "to" population, just exchange the organism storage and then
+    // clear out the old organisms.
+    if (reset_to) {
+      SwapPops(from_pop, to_pop);
+      EmptyPop(from_pop, 0);
+      return;
+    }
+
+    // Get the starting point for the new organisms to move to.
+    Population::iterator_t it_to = to_pop.end();
 
     // Prepare the "to" population before moving the new organisms in.
-    if (reset_to) EmptyPop(to_pop, from_pop.GetSize());   // Clear out the population.
-    else ResizePop(to_pop, to_pop.GetSize() + from_pop.GetSize());
+    ResizePop(to_pop, to_pop.GetSize() + from_pop.GetSize());
 
     // Move the organisms over
     for (auto it_from = from_pop.begin(); it_from != from_pop.end(); ++it_from, ++it_to) {
@@ -828,16 +2045,76 @@ namespace mabe {
   /// Return a random position from a designated population with a living organism in it.
   OrgPosition MABE::GetRandomOrgPos(Population & pop) {
     emp_assert(pop.GetNumOrgs() > 0, "GetRandomOrgPos cannot be called if there are no orgs.");
-    OrgPosition pos = GetRandomPos(pop);
-    while (pos.IsEmpty()) pos = GetRandomPos(pop);
-    return pos;
+    return pop.IteratorAt( pop.GetRandomLivingPos(random) );
   }
 
 
   // --- Collection Management ---
 
+  template <typename FUN_T>
+  double MABE::EvaluateOrgs(const Collection & orgs, FUN_T && eval_fun) {
+    // If we are running serially, just step through the living orgs in place.
+    if (!thread_pool.IsParallel()) {
+      double max_result = 0.0;
+      bool first = true;
+      size_t count = 0;
+      orgs.ForEachAlive([&](Organism & org) {
+        const double result = eval_fun(org);
+        if (first || Reduce::IsNewMax(result, max_result)) max_result = result;
+        first = false;
+        ++count;
+      });
+      std::atomic_ref<uint64_t>(run_stats.evaluations) += count;  // PARALLEL blocks may overlap.
+      MarkStateChanged();
+      return max_result;
+    }
+
+    // Balanced evaluations use each organism's last measured cost.
+    if (balance_evals) {
+      return EvaluateOrgs(orgs, eval_fun, [](const Organism & org){ return org.GetEvalCost(); });
+    }
+
+    // Otherwise flatten the living orgs so that chunks can be indexed directly.
+    emp::vector<emp::Ptr<Organism>> org_ptrs;
+    org_ptrs.reserve(orgs.CountAlive());
+    orgs.ForEachAlive([&org_ptrs](Organism & org){ org_ptrs.push_back(&org); });
+    std::atomic_ref<uint64_t>(run_stats.evaluations) += org_ptrs.size();
+    MarkStateChanged();
+
+    return thread_pool.MaxOf(org_ptrs.size(),
+                             [&org_ptrs, &eval_fun](size_t id){ return eval_fun(*org_ptrs[id]); });
+  }
+
+  template <typename FUN_T, typename COST_FUN_T>
+  double MABE::EvaluateOrgs(const Collection & orgs, FUN_T && eval_fun, COST_FUN_T && cost_fun) {
+    if (!thread_pool.IsParallel()) return EvaluateOrgs(orgs, eval_fun);
+
+    emp::vector<emp::Ptr<Organism>> org_ptrs;
+    emp::vector<double> costs;
+    org_ptrs.reserve(orgs.CountAlive());
+    costs.reserve(org_ptrs.capacity());
+    orgs.ForEachAlive([&org_ptrs, &costs, &cost_fun](Organism & org){
+      org_ptrs.push_back(&org);
+      costs.push_back((double) cost_fun(org));
+    });
+    std::atomic_ref<uint64_t>(run_stats.evaluations) += org_ptrs.size();
+    MarkStateChanged();
+
+    // Results are kept by id, so the max (taken in id order) does not depend on scheduling.
+    emp::vector<double> results(org_ptrs.size());
+    thread_pool.ForEachByCost(costs, [this, &org_ptrs, &results, &eval_fun](size_t id) {
+      if (!balance_evals) { results[id] = eval_fun(*org_ptrs[id]); return; }
+      const auto start = std::chrono::steady_clock::now();
+      results[id] = eval_fun(*org_ptrs[id]);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      org_ptrs[id]->SetEvalCost(elapsed.count());
+    });
+    if (results.empty()) return 0.0;
+    return results[Reduce::ArgMaxOf(results.size(), [&results](size_t id){ return results[id]; })];
+  }
+
   Collection MABE::ToCollection(const emp::String & load_str) {
-    Collection out;
+    Collection out = CollectionPool::Shared().Take();
     auto slices = emp::view_slices(load_str, ',');
     for (auto name : slices) {
       int pop_id = GetPopID(name);
@@ -854,6 +2131,40 @@ namespace mabe {
     return result;
   }
 
+  /// A full OK() runs every check_interval updates.  Other updates only check population
+  /// counts, the positions changed since the last check, and check_samples random positions
+  /// per population (drawn from a random stream, so the master generator is untouched).
+  bool MABE::CheckIntegrity() {
+    static constexpr uint64_t INTEGRITY_SALT = 0x1D7E6;
+    const bool full_check = check_interval && (update % check_interval == 0);
+
+    // If more positions changed than exist, checking everything is no slower.
+    size_t total_size = 0;
+    for (auto pop_ptr : pops) total_size += pop_ptr->GetSize();
+    if (full_check || touched_positions.size() > total_size) {
+      touched_positions.resize(0);
+      return OK();
+    }
+
+    bool result = true;
+    for (auto pop_ptr : pops) result &= pop_ptr->OKCounts();
+    for (OrgPosition pos : touched_positions) {
+      if (pos.Pos() < pos.Pop().GetSize()) result &= pos.Pop().OKPosition(pos.Pos());
+    }
+    touched_positions.resize(0);
+
+    if (check_samples) {
+      emp::Random check_random = GetRandomStreams().Make(update, INTEGRITY_SALT);
+      for (auto pop_ptr : pops) {
+        if (pop_ptr->GetSize() == 0) continue;
+        for (size_t i = 0; i < check_samples; ++i) {
+          result &= pop_ptr->OKPosition(check_random.GetUInt(pop_ptr->GetSize()));
+        }
+      }
+    }
+    return result;
+  }
+
 }
 
 #endif
@@ -10,12 +10,20 @@
 #ifndef MABE_MABE_BASE_H
 #define MABE_MABE_BASE_H
 
+#include <atomic>
+
 #include "emp/base/array.hpp"
 #include "emp/base/notify.hpp"
 #include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "emp/polyfill/span.hpp"
 #include "emp/tools/String.hpp"
 
+#include "../tools/EventLog.hpp"
+#include "../tools/RandomStreams.hpp"
+#include "../tools/ThreadPool.hpp"
+
 #include "ModuleBase.hpp"
 #include "Population.hpp"
 #include "SigListener.hpp"
@@ -28,11 +36,43 @@ namespace mabe {
   /// operations to manipulate organisms is a population listed as private.
 
   class MABEBase {
+  public:
+    /// Running totals of key events in a run, kept cheaply for throughput reporting.
+    struct RunStats {
+      uint64_t births = 0;          ///< Organisms placed with a parent.
+      uint64_t injections = 0;      ///< Organisms placed without a parent.
+      uint64_t deaths = 0;          ///< Organisms removed from a population.
+      uint64_t evaluations = 0;     ///< Organisms passed to an evaluation function.
+      uint64_t insts_executed = 0;  ///< Process steps (e.g., CPU instructions) run by organisms.
+      uint64_t allocations = 0;     ///< Organisms built with a new memory allocation.
+
+      /// Organisms currently alive across all populations.
+      uint64_t GetNumAlive() const { return births + injections - deaths; }
+    };
+
   protected:
     bool exit_now=false;     ///< Do we need to immediately clean up and exit the run?
     emp::Random random;      ///< Master random number generator
     size_t update = 0;       ///< How many times has Update() been called?
+    size_t stream_update = 0;   ///< Update in which stream_calls was last reset.
+    size_t stream_calls = 0;    ///< Calls to NextStreamCall() so far in stream_update.
     bool verbose = false;    ///< Should we output extra information during setup?
+    RunStats run_stats;      ///< Counts of births, deaths, evaluations, etc.
+    uint64_t update_allocations = 0;  ///< Organisms newly allocated during the last update.
+    bool report_memory = false;       ///< Print memory use by population and module at exit?
+    std::atomic<uint64_t> state_version{0};  ///< Changes whenever organisms or traits may have.
+
+    // Debug integrity checks (see MABE::CheckIntegrity); none of this is used when NDEBUG is set.
+    size_t check_interval = 1;   ///< Run full integrity checks every this many updates (0=never).
+    size_t check_samples = 0;    ///< Random positions per population to check on other updates.
+    emp::vector<OrgPosition> touched_positions;  ///< Positions changed since the last check.
+
+    /// Note a position whose organism changed, so the next integrity check looks at it.
+    void TouchPosition([[maybe_unused]] OrgPosition pos) {
+#ifndef NDEBUG
+      touched_positions.push_back(pos);
+#endif
+    }
 
     /// Maintain a master array of pointers to all SigListeners.
     using sig_base_t = SigListenerBase<ModuleBase>;
@@ -57,12 +97,16 @@ namespace mabe {
     SigListener<ModuleBase,void,Organism &, OrgPosition, OrgPosition> before_placement_sig;
     // OnPlacement(OrgPosition placement_pos)
     SigListener<ModuleBase,void,OrgPosition> on_placement_sig;
+    // OnPlacementBatch(std::span<const OrgPosition> placement_positions)
+    SigListener<ModuleBase,void,std::span<const OrgPosition>> on_placement_batch_sig;
     // BeforeMutate(Organism & org)
     SigListener<ModuleBase,void,Organism &> before_mutate_sig; // TO IMPLEMENT
     // OnMutate(Organism & org)
     SigListener<ModuleBase,void,Organism &> on_mutate_sig; // TO IMPLEMENT
     // BeforeDeath(OrgPosition remove_pos)
     SigListener<ModuleBase,void,OrgPosition> before_death_sig;
+    // BeforeDeathBatch(std::span<const OrgPosition> remove_positions)
+    SigListener<ModuleBase,void,std::span<const OrgPosition>> before_death_batch_sig;
     // BeforeSwap(OrgPosition pos1, OrgPosition pos2)
     SigListener<ModuleBase,void,OrgPosition,OrgPosition> before_swap_sig;
     // OnSwap(OrgPosition pos1, OrgPosition pos2)
@@ -71,6 +115,10 @@ namespace mabe {
     SigListener<ModuleBase,void,Population &,size_t> before_pop_resize_sig;
     // OnPopResize(Population & pop, size_t old_size)
     SigListener<ModuleBase,void,Population &,size_t> on_pop_resize_sig;
+    // BeforePopSwap(Population & pop1, Population & pop2)
+    SigListener<ModuleBase,void,Population &,Population &> before_pop_swap_sig;
+    // OnPopSwap(Population & pop1, Population & pop2)
+    SigListener<ModuleBase,void,Population &,Population &> on_pop_swap_sig;
     // BeforeExit()
     SigListener<ModuleBase,void> before_exit_sig;
     // OnHelp()
@@ -80,6 +128,30 @@ namespace mabe {
     /// told to rescan the signals (perhaps because new functionality was enabled.)
     bool rescan_signals = true;
 
+    // Batch listeners hear about placements made during a bulk operation all at once.
+    size_t placement_batch_depth = 0;            ///< Bulk operations currently in progress.
+    emp::vector<OrgPosition> pending_placements; ///< Placements not yet sent to batch listeners.
+    emp::vector<OrgPosition> death_batch;        ///< Scratch space for batched deaths.
+
+    // Optional log of every placement, death, and move (see tools/EventLog.hpp).
+    emp::Ptr<EventLogWriter> event_log = nullptr;  ///< Log to write events to (if any).
+    size_t event_genome_trait = emp::MAX_SIZE_T;   ///< DataMap ID of genome IDs to log.
+
+    void LogEvent(EventRecord::Kind kind, OrgPosition pos, OrgPosition other=OrgPosition(),
+                  uint64_t genome_id=EventRecord::NO_GENOME) {
+      EventRecord record;
+      record.update = update;
+      record.kind = kind;
+      record.pop = (uint16_t) pos.PopID();
+      record.pos = (uint32_t) pos.Pos();
+      if (other.IsValid()) {
+        record.other_pop = (uint16_t) other.PopID();
+        record.other_pos = (uint32_t) other.Pos();
+      }
+      record.genome_id = genome_id;
+      event_log->Add(record);
+    }
+
     // Protected constructor so that base class cannot be instantiated except from derived class.
     MABEBase()
     : before_update_sig("before_update", ModuleBase::SIG_BeforeUpdate, &ModuleBase::BeforeUpdate, sig_ptrs)
@@ -89,13 +161,17 @@ namespace mabe {
     , on_inject_ready_sig("on_inject_ready", ModuleBase::SIG_OnInjectReady, &ModuleBase::OnInjectReady, sig_ptrs)
     , before_placement_sig("before_placement", ModuleBase::SIG_BeforePlacement, &ModuleBase::BeforePlacement, sig_ptrs)
     , on_placement_sig("on_placement", ModuleBase::SIG_OnPlacement, &ModuleBase::OnPlacement, sig_ptrs)
+    , on_placement_batch_sig("on_placement_batch", ModuleBase::SIG_OnPlacementBatch, &ModuleBase::OnPlacementBatch, sig_ptrs)
     , before_mutate_sig("before_mutate", ModuleBase::SIG_BeforeMutate, &ModuleBase::BeforeMutate, sig_ptrs)
     , on_mutate_sig("on_mutate", ModuleBase::SIG_OnMutate, &ModuleBase::OnMutate, sig_ptrs)
     , before_death_sig("before_death", ModuleBase::SIG_BeforeDeath, &ModuleBase::BeforeDeath, sig_ptrs)
+    , before_death_batch_sig("before_death_batch", ModuleBase::SIG_BeforeDeathBatch, &ModuleBase::BeforeDeathBatch, sig_ptrs)
     , before_swap_sig("before_swap", ModuleBase::SIG_BeforeSwap, &ModuleBase::BeforeSwap, sig_ptrs)
     , on_swap_sig("on_swap", ModuleBase::SIG_OnSwap, &ModuleBase::OnSwap, sig_ptrs)
     , before_pop_resize_sig("before_pop_resize", ModuleBase::SIG_BeforePopResize, &ModuleBase::BeforePopResize, sig_ptrs)
     , on_pop_resize_sig("on_pop_resize", ModuleBase::SIG_OnPopResize, &ModuleBase::OnPopResize, sig_ptrs)
+    , before_pop_swap_sig("before_pop_swap", ModuleBase::SIG_BeforePopSwap, &ModuleBase::BeforePopSwap, sig_ptrs)
+    , on_pop_swap_sig("on_pop_swap", ModuleBase::SIG_OnPopSwap, &ModuleBase::OnPopSwap, sig_ptrs)
     , before_exit_sig("before_exit", ModuleBase::SIG_BeforeExit, &ModuleBase::BeforeExit, sig_ptrs)
     , on_help_sig("on_help", ModuleBase::SIG_OnHelp, &ModuleBase::OnHelp, sig_ptrs)
     { ;  }
@@ -112,7 +188,52 @@ namespace mabe {
     // --- Basic accessors ---
     emp::Random & GetRandom() { return random; }
     size_t GetUpdate() const noexcept { return update; }
+
+    /// Random streams are derived from the master seed; they do not advance the master
+    /// random number generator, so they can be safely used from multiple threads.
+    RandomStreams GetRandomStreams() const { return RandomStreams(random.GetSeed()); }
+
+    /// Reset a caller-owned generator to a stream unique to the current update and the
+    /// provided position; use 'salt' to get distinct streams for different uses of one position.
+    void SeedRandomStream(emp::Random & rng, OrgPosition pos, uint64_t salt=0) const {
+      GetRandomStreams().Reseed(rng, update, pos.PopID(), pos.Pos(), salt);
+    }
+
+    /// Build a generator for a stream unique to the current update and the provided position.
+    emp::Random GetRandomStream(OrgPosition pos, uint64_t salt=0) const {
+      return GetRandomStreams().Make(update, pos.PopID(), pos.Pos(), salt);
+    }
+    /// Number each call within an update that derives per-birth random streams, so that two
+    /// calls on the same population in one update do not replay the same streams.  Call only
+    /// from the main thread, where calls happen in a reproducible order.
+    size_t NextStreamCall() {
+      if (stream_update != update) { stream_update = update; stream_calls = 0; }
+      return stream_calls++;
+    }
+
     bool GetVerbose() const { return verbose; }
+    size_t GetCheckInterval() const { return check_interval; }
+    void SetCheckInterval(size_t in_interval) { check_interval = in_interval; }
+    size_t GetCheckSamples() const { return check_samples; }
+    void SetCheckSamples(size_t in_samples) { check_samples = in_samples; }
+    const RunStats & GetRunStats() const { return run_stats; }
+    RunStats & GetRunStats() { return run_stats; }
+    uint64_t GetUpdateAllocations() const { return update_allocations; }
+    bool GetReportMemory() const { return report_memory; }
+    void SetReportMemory(bool in_report) { report_memory = in_report; }
+
+    /// Version number for the state of all populations; any result computed from organisms
+    /// is still valid as long as this has not changed.  Placements, deaths, and moves change
+    /// it automatically; anything else that writes to organism traits must call MarkStateChanged().
+    uint64_t GetStateVersion() const { return state_version.load(std::memory_order_relaxed); }
+    void MarkStateChanged() { state_version.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Log every placement, death, and move to 'log' (nullptr to stop); if 'genome_trait' is
+    /// a valid DataMap ID, it holds the size_t genome ID to log for each new organism.
+    void SetEventLog(emp::Ptr<EventLogWriter> log, size_t genome_trait=emp::MAX_SIZE_T) {
+      event_log = log;
+      event_genome_trait = genome_trait;
+    }
 
     /// Trigger exit from run.
     void RequestExit() { exit_now = true; }
@@ -120,6 +241,24 @@ namespace mabe {
     /// Setup signals to be rescanned; call this if any signal is updated in a module.
     void RescanSignals() { rescan_signals = true; }
 
+    /// Hold OnPlacementBatch signals until the matching EndPlacementBatch(), then send all of
+    /// the placements made in between as one batch.  Per-organism OnPlacement is unaffected.
+    /// Batches may nest; only the outermost End sends the signal.
+    void BeginPlacementBatch() { ++placement_batch_depth; }
+    void EndPlacementBatch() {
+      emp_assert(placement_batch_depth > 0);
+      if (--placement_batch_depth == 0) FlushPlacements();
+    }
+
+    /// Send any held placements to batch listeners.  Called before organisms can die or move,
+    /// so batch listeners always hear about a placement before anything else happens to it.
+    void FlushPlacements() {
+      if (pending_placements.size() == 0) return;
+      on_placement_batch_sig.Trigger(
+        std::span<const OrgPosition>(pending_placements.data(), pending_placements.size()));
+      pending_placements.resize(0);
+    }
+
     /// All insertions of organisms into a population should come through AddOrgAt
     /// @param[in] org_ptr points to the organism being added (which will now be owned by the population).
     /// @param[in] pos is the position to perform the insertion.
@@ -129,7 +268,20 @@ namespace mabe {
       ClearOrgAt(pos);                                   // Clear any organism already in this position.
       before_placement_sig.Trigger(*org_ptr, pos, ppos); // Notify listeners org is about to be placed.
       pos.PopPtr()->SetOrg(pos.Pos(), org_ptr);          // Put the new organism in place.
+      TouchPosition(pos);
+      MarkStateChanged();
+      if (ppos.IsValid()) ++run_stats.births;            // Track births vs. injections.
+      else ++run_stats.injections;
+      if (event_log) {
+        const uint64_t genome_id = (event_genome_trait == emp::MAX_SIZE_T) ? EventRecord::NO_GENOME
+                                 : org_ptr->GetTrait<size_t>(event_genome_trait);
+        LogEvent(ppos.IsValid() ? EventRecord::BIRTH : EventRecord::INJECT, pos, ppos, genome_id);
+      }
       on_placement_sig.Trigger(pos);                     // Notify listeners org has been placed.
+      if (on_placement_batch_sig.size()) {               // Batch listeners: send now or hold.
+        if (placement_batch_depth) pending_placements.push_back(pos);
+        else on_placement_batch_sig.Trigger(std::span<const OrgPosition>(&pos, 1));
+      }
     }
 
     /// All permanent deletion of organisms from a population should come through here.
@@ -140,19 +292,58 @@ namespace mabe {
       emp_assert(pos.IsValid());
       if (pos.IsEmpty()) return;                    // Already empty? Nothing to remove!
 
+      FlushPlacements();
+      if (before_death_batch_sig.size()) {
+        before_death_batch_sig.Trigger(std::span<const OrgPosition>(&pos, 1));
+      }
+      RemoveOrgAt(pos);
+    }
+
+    /// Remove all organisms from a population (its size is unchanged).  Batch listeners get a
+    /// single BeforeDeathBatch with every position while all organisms are still in place;
+    /// per-organism listeners then see the same BeforeDeath calls as a ClearOrgAt() loop.
+    void ClearAllOrgs(Population & pop) {
+      FlushPlacements();
+      if (before_death_batch_sig.size()) {
+        death_batch.resize(0);
+        for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+          if (pop.IsOccupied(pos)) death_batch.push_back(OrgPosition(pop, pos));
+        }
+        if (death_batch.size()) {
+          before_death_batch_sig.Trigger(
+            std::span<const OrgPosition>(death_batch.data(), death_batch.size()));
+        }
+      }
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        if (pop.IsOccupied(pos)) RemoveOrgAt(OrgPosition(pop, pos));
+      }
+    }
+
+    /// Send the per-organism death signal and remove the organism; batch listeners must
+    /// already have been notified.
+    void RemoveOrgAt(OrgPosition pos) {
       before_death_sig.Trigger(pos);                // Send signal of current organism dying.
-      pos.Pop().ExtractOrg(pos.Pos()).Delete();     // Delete current organism.
+      if (event_log) LogEvent(EventRecord::DEATH, pos);
+      pos.Pop().ExtractOrg(pos.Pos())->Recycle();   // Return org to its manager for reuse.
+      TouchPosition(pos);
+      MarkStateChanged();
+      ++run_stats.deaths;
     }
 
     /// All movement of organisms from one population position to another should come through here.
     void SwapOrgs(OrgPosition pos1, OrgPosition pos2) {
       emp_assert(pos1.IsValid());
       emp_assert(pos2.IsValid());
+      FlushPlacements();
       before_swap_sig.Trigger(pos1, pos2);
       emp::Ptr<Organism> org1 = pos1.PopPtr()->ExtractOrg(pos1.Pos());
       emp::Ptr<Organism> org2 = pos2.PopPtr()->ExtractOrg(pos2.Pos());
       if (!org1->IsEmpty()) pos2.PopPtr()->SetOrg(pos2.Pos(), org1);
       if (!org2->IsEmpty()) pos1.PopPtr()->SetOrg(pos1.Pos(), org2);
+      TouchPosition(pos1);
+      TouchPosition(pos2);
+      MarkStateChanged();
+      if (event_log) LogEvent(EventRecord::SWAP, pos1, pos2);
       on_swap_sig.Trigger(pos1, pos2);
     }
 
@@ -163,6 +354,7 @@ namespace mabe {
       const size_t old_size = pop.GetSize();                // Track the starting size.
       if (old_size == new_size) return;                     // If size isn't changing, we're done!
 
+      FlushPlacements();
       before_pop_resize_sig.Trigger(pop, new_size);         // Signal that resize about to happen.
 
       for (size_t pos = new_size; pos < old_size; pos++) {  // Clear all orgs out of range.
@@ -170,14 +362,39 @@ namespace mabe {
       }
 
       pop.Resize(new_size);                                 // Do the actual resize.
+      MarkStateChanged();
 
       on_pop_resize_sig.Trigger(pop, old_size);             // Signal that resize has happened.
     }
 
+    /// Exchange ALL organisms between two populations (each org keeps its position), as a
+    /// single operation with one pair of signals rather than per-organism swaps.
+    void SwapPops(Population & pop1, Population & pop2) {
+      if (&pop1 == &pop2) return;
+      FlushPlacements();
+      before_pop_swap_sig.Trigger(pop1, pop2);
+      pop1.SwapOrgs(pop2);
+      MarkStateChanged();
+      if (event_log) {
+        EventRecord record;
+        record.update = update;
+        record.kind = EventRecord::POP_SWAP;
+        record.pop = (uint16_t) pop1.GetID();
+        record.other_pop = (uint16_t) pop2.GetID();
+        record.other_pos = 0;
+        event_log->Add(record);
+      }
+      on_pop_swap_sig.Trigger(pop1, pop2);
+    }
+
+    /// Pre-allocate room for a population to grow to 'capacity' positions; size is unchanged.
+    void ReservePop(Population & pop, size_t capacity) { pop.Reserve(capacity); }
+
     /// Add a single, empty position onto the end of a population.
     PopIterator PushEmpty(Population & pop) {
       before_pop_resize_sig.Trigger(pop, pop.GetSize()+1);
       PopIterator it = pop.PushEmpty();
+      MarkStateChanged();
       on_pop_resize_sig.Trigger(pop, pop.GetSize()-1);
       return it;
     }
@@ -185,6 +402,25 @@ namespace mabe {
     // Interface function for MABEScript
     virtual size_t GetRandomSeed() const = 0;
     virtual void SetRandomSeed(size_t in_seed) = 0;
+    virtual size_t GetNumThreads() const = 0;
+    virtual void SetNumThreads(size_t in_threads) = 0;
+    virtual ThreadPool & GetThreadPool() = 0;
+    virtual bool GetParallelBirths() const = 0;
+    virtual void SetParallelBirths(bool in_parallel) = 0;
+    virtual bool GetBalanceEvals() const = 0;
+    virtual void SetBalanceEvals(bool in_balance) = 0;
+    virtual bool GetConcurrentModules() const = 0;
+    virtual void SetConcurrentModules(bool in_concurrent) = 0;
+    virtual bool GetProfiling() const = 0;
+    virtual void SetProfiling(bool in_profiling) = 0;
+    virtual bool GetProfileCounters() const = 0;
+    virtual void SetProfileCounters(bool in_counters) = 0;
+    virtual bool WriteProfile(const emp::String & filename) const = 0;
+    virtual bool Checkpoint(const emp::String & filename) = 0;
+    virtual bool CheckpointDelta(const emp::String & filename) = 0;
+    virtual size_t Fork(size_t num_forks, const emp::String & dir_prefix) = 0;
+    virtual size_t GetPopBytes() const = 0;
+    virtual size_t GetModuleBytes() const = 0;
     virtual Population & AddPopulation(const emp::String & name, size_t pop_size=0) = 0;
     virtual void CopyPop(const Population & from_pop, Population & to_pop) = 0;
     virtual void MoveOrgs(Population & from_pop, Population & to_pop, bool reset_to) = 0;
@@ -10,8 +10,16 @@
 #ifndef MABE_MABE_SCRIPT_HPP
 #define MABE_MABE_SCRIPT_HPP
 
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 #include "emp/base/array.hpp"
 #include "emp/base/Ptr.hpp"
@@ -31,7 +39,10 @@
 #include "ModuleBase.hpp"
 #include "Population.hpp"
 #include "SigListener.hpp"
+#include "TraitEquation.hpp"
 #include "TraitManager.hpp"
+#include "../tools/Histogram.hpp"
+#include "../tools/QuantileSketch.hpp"
 
 namespace mabe {
 
@@ -41,23 +52,262 @@ namespace mabe {
   private:
     MABEBase & control;
     emp::SimpleParser dm_parser;       ///< Parser to process functions on a data map
+    emp::Ptr<emplode::Symbol_Scope> stats_scope = nullptr;  ///< Read-only STATS entries.
 
     using Symbol_Var = emplode::Symbol_Var;
 
+    // Numeric trait values scanned for the DataFile row being written, keyed on the group's
+    // address and the trait equation, so several columns summarizing one trait share a scan.
+    std::unordered_map<emp::String, emp::vector<double>> row_trait_values;
+    size_t row_trait_id = 0;           ///< DataFile row that row_trait_values belong to.
+
+    // Memo of pure queries on a Population (the values of a numeric trait equation, and FILTER
+    // results), keyed on the population's address, the query, and the equation with current
+    // script values filled in.  Cleared whenever control's state version changes: on every
+    // placement, death, move, evaluation, scripted module call, and new update.
+    std::unordered_map<emp::String, emp::vector<double>> memo_values;
+    std::unordered_map<emp::String, Collection> memo_filters;
+    uint64_t memo_version = (uint64_t) -1;  ///< State version that the memos belong to.
+    bool memo_queries = true;          ///< Should population queries be memoized?
+    size_t memo_hits = 0;
+    size_t memo_misses = 0;
+
+    /// Groups smaller than this are scanned on one thread; the hand-off would cost more.
+    static constexpr size_t MIN_PARALLEL_ORGS = 4 * TraitEquation::BLOCK_SIZE;
+    static constexpr size_t SUMMARY_SEGMENT = 16 * TraitEquation::BLOCK_SIZE;  ///< Orgs per partial summary.
+
     struct PreprocessResults {
       emp::String result;             // Updated string
       emp::vector<emp::Datum> values; // Numerical values kept aside, if preserve_nums=true;
     };
 
+    // Compiled data-map functions, keyed on the layout, the pre-processed equation, and any
+    // numerical values pulled out during pre-processing.  Layouts are owned by the run and
+    // persist until it ends, so their addresses are stable keys.
+    using dm_fun_t = decltype( std::declval<emp::SimpleParser &>().BuildMathFunction(
+      std::declval<const emp::DataLayout &>(), emp::String(), emp::vector<emp::Datum>()) );
+    using equ_key_t = std::tuple<const emp::DataLayout *, emp::String, emp::vector<double>>;
+    struct EquationInfo {
+      dm_fun_t dm_fun;          ///< Parser-built version (or bytecode wrapper, if using variables).
+      TraitEquation compiled;   ///< Bytecode version; only valid for simple arithmetic.
+      emp::String var_equation; ///< For the parser: script variables wrapped as ${name} ("" = none).
+      emp::String var_result;   ///< var_equation as pre-processed when dm_fun was last built.
+      emp::vector<double> var_values;   ///< Values pulled out of var_result at that time.
+    };
+    std::map<equ_key_t, EquationInfo> equation_cache;
+    size_t equation_cache_hits = 0;
+    size_t equation_cache_misses = 0;
+
+    /// Track how quickly a counter is changing, measured between successive reads.
+    struct RateTracker {
+      using clock_t = std::chrono::steady_clock;
+      uint64_t last_count = 0;
+      clock_t::time_point last_time = clock_t::now();
+
+      double Update(uint64_t count) {
+        const clock_t::time_point now = clock_t::now();
+        const double secs = std::chrono::duration<double>(now - last_time).count();
+        const double rate = (secs > 0.0) ? (count - last_count) / secs : 0.0;
+        last_count = count;
+        last_time = now;
+        return rate;
+      }
+    };
+    RateTracker births_rate, deaths_rate, evals_rate, insts_rate;
+
+    /// Find a numeric script variable that an equation can refer to by name.
+    TraitEquation::var_fun_t LookupVar(const emp::String & name) {
+      emp::Ptr<emplode::Symbol> symbol = GetSymbolTable().GetRootScope().LookupSymbol(name);
+      if (!symbol || !symbol->IsNumeric()) return TraitEquation::var_fun_t();
+      return [symbol](){ return symbol->AsDouble(); };
+    }
+
+    /// Wrap the names of script variables (that are not traits) in an equation as ${name}, so
+    /// that pre-processing drops in their current values.
+    emp::String SubstituteVars(const emp::DataLayout & data_layout, const emp::String & equation) {
+      emp::String out;
+      char quote = 0;     // Inside of a string literal?
+      for (size_t pos = 0; pos < equation.size();) {
+        const char c = equation[pos];
+        if (quote) { if (c == quote) quote = 0; out += equation[pos++]; continue; }
+        if (c == '"' || c == '\'') { quote = c; out += equation[pos++]; continue; }
+        const bool after_id = pos && (std::isalnum(equation[pos-1]) || equation[pos-1] == '_' ||
+                                      equation[pos-1] == '$' || equation[pos-1] == '.');
+        if (after_id || !(std::isalpha(c) || c == '_')) { out += equation[pos++]; continue; }
+
+        size_t end = pos;
+        while (end < equation.size() && (std::isalnum(equation[end]) || equation[end] == '_')) ++end;
+        const emp::String name = equation.substr(pos, end-pos);
+        size_t next = end;
+        while (next < equation.size() && std::isspace(equation[next])) ++next;
+        const bool is_fun = (next < equation.size() && equation[next] == '(');
+        if (!is_fun && !data_layout.HasName(name) && LookupVar(name)) out += emp::MakeString("${", name, "}");
+        else out += name;
+        pos = end;
+      }
+      return out;
+    }
+
+    /// Find (or build) the compiled forms of an equation for a given layout.  Names of script
+    /// variables are bound (not copied) into the bytecode, so an equation like "fitness < cutoff"
+    /// is compiled once and always uses the current value of 'cutoff'.  Equations that only
+    /// the parser can run get one entry with their variables' values filled in, rebuilt
+    /// whenever those values change (so changing values never grows the cache).
+    const EquationInfo & GetEquationInfo(const emp::DataLayout & data_layout,
+                                         const emp::String & equation) {
+      auto pp_equ = Preprocess(equation, true);
+      emp::vector<double> key_values;
+      for (const emp::Datum & value : pp_equ.values) key_values.push_back(value.NativeDouble());
+      equ_key_t key{&data_layout, pp_equ.result, key_values};
+
+      auto cache_it = equation_cache.find(key);
+      if (cache_it != equation_cache.end()) {
+        ++equation_cache_hits;
+        if (cache_it->second.var_equation.size()) RefreshVarEquation(data_layout, cache_it->second);
+        return cache_it->second;
+      }
+
+      EquationInfo info;
+      info.compiled.Compile(data_layout, pp_equ.result, key_values,
+                            [this](const emp::String & name){ return LookupVar(name); });
+      if (info.compiled.GetNumVars() || info.compiled.HasIndexedTraits()) {  // Parser can't do these.
+        info.dm_fun = [compiled=info.compiled](const emp::DataMap & dmap){ return compiled.Eval(dmap); };
+      }
+      else {
+        // The parser can only use variables with their values filled in; keep the wrapped form
+        // and rebuild (in this same entry) whenever those values change.
+        const emp::String var_equation = SubstituteVars(data_layout, pp_equ.result);
+        if (var_equation != pp_equ.result) info.var_equation = var_equation;
+        else info.dm_fun = dm_parser.BuildMathFunction(data_layout, pp_equ.result, pp_equ.values);
+      }
+      ++equation_cache_misses;
+      EquationInfo & new_info = equation_cache.emplace(std::move(key), std::move(info)).first->second;
+      if (new_info.var_equation.size()) RefreshVarEquation(data_layout, new_info);
+      return new_info;
+    }
+
+    /// Rebuild the parser version of an equation that uses script variables, if any of their
+    /// values have changed since it was last built.
+    void RefreshVarEquation(const emp::DataLayout & data_layout, EquationInfo & info) {
+      auto pp_vars = Preprocess(info.var_equation, true);
+      emp::vector<double> values;
+      for (const emp::Datum & value : pp_vars.values) values.push_back(value.NativeDouble());
+      if (info.var_result.size() && pp_vars.result == info.var_result && values == info.var_values) {
+        return;
+      }
+      info.dm_fun = dm_parser.BuildMathFunction(data_layout, pp_vars.result, pp_vars.values);
+      info.var_result = pp_vars.result;
+      info.var_values = std::move(values);
+    }
+
   public:
     /// Build a function to scan a data map, run a provided equation on its entries,
-    /// and return the result.
+    /// and return the result.  Equations already compiled for this layout are reused.
     auto BuildTraitEquation(const emp::DataLayout & data_layout, emp::String equation) {
-      auto pp_equ = Preprocess(equation, true);
-      auto dm_fun = dm_parser.BuildMathFunction(data_layout, pp_equ.result, pp_equ.values);
+      const dm_fun_t & dm_fun = GetEquationInfo(data_layout, equation).dm_fun;
       return [dm_fun](const Organism & org){ return dm_fun(org.GetDataMap()); };
     }
 
+    /// Build a function that runs a provided equation directly on any data map with the given
+    /// layout (for maps that do not belong to an organism).
+    auto BuildDataMapEquation(const emp::DataLayout & data_layout, emp::String equation) {
+      return GetEquationInfo(data_layout, equation).dm_fun;
+    }
+
+    /// Calculate an equation for every organism in a Population or Collection, in order.
+    /// Simple arithmetic equations are run as bytecode over blocks of organisms; anything
+    /// else falls back to the parser-built function, one organism at a time.  Large groups are
+    /// split into chunks across the thread pool; each chunk fills its own range of results, so
+    /// the output does not depend on the number of threads.
+    template <typename CONTAINER_T>
+    emp::vector<double> EvalTraitEquation(CONTAINER_T & orgs, const emp::String & equation) {
+      emp::vector<const emp::DataMap *> maps;
+      maps.reserve(orgs.GetSize());
+      for (auto it = orgs.begin(); it != orgs.end(); ++it) maps.push_back(&(*it).GetDataMap());
+
+      emp::vector<double> results(maps.size());
+      if (maps.size() == 0) return results;
+
+      const EquationInfo & info = GetEquationInfo(orgs.GetDataLayout(), equation);
+      const emp::vector<double> var_values = info.compiled.ReadVars();  // Read on this thread.
+      auto eval_range = [&info, &maps, &results, &var_values](size_t, size_t start, size_t end) {
+        if (info.compiled.IsValid()) {
+          const size_t count = end - start;
+          info.compiled.Eval(std::span<const emp::DataMap * const>(maps.data() + start, count),
+                             std::span<double>(results.data() + start, count),
+                             std::span<const double>(var_values.data(), var_values.size()));
+        } else {
+          for (size_t i = start; i < end; ++i) {
+            results[i] = static_cast<double>(info.dm_fun(*maps[i]));
+          }
+        }
+      };
+
+      ThreadPool & pool = control.GetThreadPool();
+      if (!pool.IsParallel() || maps.size() <= MIN_PARALLEL_ORGS) eval_range(0, 0, maps.size());
+      else pool.ForEachChunk(maps.size(), eval_range);
+      return results;
+    }
+
+    /// Feed the values of a numeric trait equation over a group into a summary with Add() and
+    /// Merge() (e.g., a QuantileSketch or Histogram) without storing them: each fixed segment
+    /// of SUMMARY_SEGMENT organisms is evaluated one block at a time into its own copy of
+    /// 'proto', and the copies are merged in order at the end.  Segments do not depend on the
+    /// thread count, so neither do approximate summaries.
+    template <typename CONTAINER_T, typename SUMMARY_T>
+    SUMMARY_T SummarizeTraitEquation(CONTAINER_T & orgs, const emp::String & equation,
+                                     const SUMMARY_T & proto) {
+      emp::vector<const emp::DataMap *> maps;
+      maps.reserve(orgs.GetSize());
+      for (auto it = orgs.begin(); it != orgs.end(); ++it) maps.push_back(&(*it).GetDataMap());
+      if (maps.size() == 0) return proto;
+
+      const EquationInfo & info = GetEquationInfo(orgs.GetDataLayout(), equation);
+      const emp::vector<double> var_values = info.compiled.ReadVars();  // Read on this thread.
+      ThreadPool & pool = control.GetThreadPool();
+      const bool parallel = pool.IsParallel() && maps.size() > MIN_PARALLEL_ORGS;
+      const size_t num_segments = (maps.size() + SUMMARY_SEGMENT - 1) / SUMMARY_SEGMENT;
+      emp::vector<SUMMARY_T> summaries(num_segments, proto);
+
+      auto eval_segment = [&info, &maps, &summaries, &var_values](size_t segment) {
+        constexpr size_t BLOCK_SIZE = TraitEquation::BLOCK_SIZE;
+        std::array<double, BLOCK_SIZE> block;
+        SUMMARY_T & summary = summaries[segment];
+        const size_t start = segment * SUMMARY_SEGMENT;
+        const size_t end = std::min(start + SUMMARY_SEGMENT, maps.size());
+        for (size_t block_start = start; block_start < end; block_start += BLOCK_SIZE) {
+          const size_t count = std::min(BLOCK_SIZE, end - block_start);
+          if (info.compiled.IsValid()) {
+            info.compiled.Eval(std::span<const emp::DataMap * const>(maps.data() + block_start, count),
+                               std::span<double>(block.data(), count),
+                               std::span<const double>(var_values.data(), var_values.size()));
+          } else {
+            for (size_t i = 0; i < count; ++i) {
+              block[i] = static_cast<double>(info.dm_fun(*maps[block_start + i]));
+            }
+          }
+          for (size_t i = 0; i < count; ++i) summary.Add(block[i]);
+        }
+      };
+
+      if (parallel) pool.ForEach(num_segments, eval_segment);
+      else for (size_t segment = 0; segment < num_segments; ++segment) eval_segment(segment);
+      for (size_t i = 1; i < summaries.size(); ++i) summaries[0].Merge(summaries[i]);
+      return summaries[0];
+    }
+
+    /// Add a read-only entry to the STATS scope (e.g., counters kept by a module).
+    void AddStat(const emp::String & name, std::function<double()> get_fun, const emp::String & desc) {
+      emp_assert(stats_scope, "STATS must be set up before adding entries.");
+      stats_scope->LinkFuns<double>(name, get_fun,
+        [name](double){ emp::notify::Error("STATS.", name, " is read only."); }, desc, true);
+    }
+
+    size_t GetEquationCacheHits() const { return equation_cache_hits; }
+    size_t GetEquationCacheMisses() const { return equation_cache_misses; }
+    size_t GetEquationCacheSize() const { return equation_cache.size(); }
+    void ClearEquationCache() { equation_cache.clear(); }
+
     /// Scan an equation and return the names of all traits it is using.
     const std::set<emp::String> & GetEquationTraits(const emp::String & equation) {
       return dm_parser.GetNamesUsed(equation);
@@ -192,9 +442,105 @@ namespace mabe {
 
     /// Build a function that takes a trait equation, builds it, and runs it on a container.
     /// Output is a function in the form:  TO_T(const FROM_T &, string equation, TO_T default)
+    /// During a DataFile row, return the (cached) values of a numeric trait equation over a
+    /// group; return nullptr if not in a row or if the equation is not numeric.
+    template <typename FROM_T>
+    emp::Ptr<emp::vector<double>> GetRowTraitValues(FROM_T & group, const emp::String & equation) {
+      const size_t row_id = emplode::DataFile::GetActiveRow();
+      if (!row_id) return nullptr;
+      if (row_id != row_trait_id) {
+        row_trait_values.clear();
+        row_trait_id = row_id;
+      }
+
+      const emp::String key = emp::MakeString((uintptr_t) &group, ":", equation);
+      auto it = row_trait_values.find(key);
+      if (it != row_trait_values.end()) return &it->second;
+
+      // Non-numeric traits are summarized as strings; leave those to BuildTraitSummary.
+      const emp::String trait_fun = Preprocess(equation).result;
+      if (!IsNumericEquation(group.GetDataLayout(), trait_fun)) return nullptr;
+
+      emp::vector<double> & values = row_trait_values[key];
+      values = EvalTraitEquation(group, trait_fun);
+      return &values;
+    }
+
+    /// Build the memo key for a query on a population, clearing old memos if the population
+    /// state has changed since they were made; return "" if memos are turned off.
+    emp::String GetMemoKey(const Population & pop, const emp::String & query,
+                           const emp::String & equation) {
+      if (!memo_queries) return "";
+      // Fill in script variables too, so the key changes whenever their values do.
+      const emp::String pp_equ = Preprocess(equation).result;
+      const emp::String key = emp::MakeString((uintptr_t) &pop, ":", query, ":",
+        Preprocess(SubstituteVars(pop.GetDataLayout(), pp_equ)).result);
+      if (memo_version != control.GetStateVersion()) {
+        memo_values.clear();
+        memo_filters.clear();
+        memo_version = control.GetStateVersion();
+      }
+      return key;
+    }
+
+    /// Return the (memoized) values of a numeric trait equation over a population; return
+    /// nullptr for other groups, if memos are off, or if the equation is not numeric.
+    template <typename FROM_T>
+    emp::Ptr<emp::vector<double>> GetMemoTraitValues(FROM_T & group, const emp::String & equation) {
+      if constexpr (!std::is_same<FROM_T,Population>()) return nullptr;
+      else {
+        const emp::String key = GetMemoKey(group, "values", equation);
+        if (key.empty()) return nullptr;
+        auto it = memo_values.find(key);
+        if (it != memo_values.end()) { ++memo_hits; return &it->second; }
+
+        const emp::String trait_fun = Preprocess(equation).result;
+        if (!IsNumericEquation(group.GetDataLayout(), trait_fun)) return nullptr;
+        ++memo_misses;
+        emp::vector<double> & values = memo_values[key];
+        values = EvalTraitEquation(group, trait_fun);
+        return &values;
+      }
+    }
+
+    /// Will an (already pre-processed) equation produce a single number for each organism?
+    /// A lone trait that is not a single number is summarized as a string instead.
+    static bool IsNumericEquation(const emp::DataLayout & data_layout, const emp::String & trait_fun) {
+      if (!emp::is_identifier(trait_fun) || !data_layout.HasName(trait_fun)) return true;
+      const size_t trait_id = data_layout.GetID(trait_fun);
+      return data_layout.IsNumeric(trait_id) && data_layout.GetCount(trait_id) == 1;
+    }
+
+    /// As IsNumericEquation(), but report an error naming the script function if not.
+    static bool RequireNumericEquation(const emp::DataLayout & data_layout, const emp::String & trait_fun,
+                                       const emp::String & fun_name) {
+      if (IsNumericEquation(data_layout, trait_fun)) return true;
+      emp::notify::Error(fun_name, " needs a numeric trait (or equation); '", trait_fun, "' is not.");
+      return false;
+    }
+
     template <typename FROM_T=Collection> 
     auto BuildTraitFunction(const emp::String & fun_type) {
       return [this,fun_type](FROM_T & group, const emp::String & equation) {
+        // Numeric equations are calculated for the whole group at once (in parallel for large
+        // groups) and then summarized.  Index lookups only touch one organism, so skip them.
+        if (!emp::is_digits(fun_type)) {
+          emp::vector<double> group_values;
+          emp::Ptr<emp::vector<double>> values = GetMemoTraitValues(group, equation);
+          if (!values) values = GetRowTraitValues(group, equation);
+          if (!values) {
+            const emp::String trait_fun = Preprocess(equation).result;
+            if (IsNumericEquation(group.GetDataLayout(), trait_fun)) {
+              group_values = EvalTraitEquation(group, trait_fun);
+              values = &group_values;
+            }
+          }
+          if (values) {
+            auto summary_fun = BuildCollectFun<double, emp::vector<double>>(fun_type,
+                                                                            [](double v){ return v; });
+            if (summary_fun) return summary_fun(*values);
+          }
+        }
         auto trait_fun = BuildTraitSummary<FROM_T>(equation, fun_type, group.GetDataLayout());
         return trait_fun(group);
       };
@@ -229,20 +575,67 @@ namespace mabe {
       type_info.AddMemberFunction("CALC_ENTROPY", BuildTraitFunction<GROUP_T>("entropy"),
         "Determine the entropy of values for a trait (or equation).");
 
+      type_info.AddMemberFunction("CALC_QUANTILE",
+        [this](GROUP_T & group, const emp::String & equation, double quantile) {
+          const emp::String trait_fun = Preprocess(equation).result;
+          if (!RequireNumericEquation(group.GetDataLayout(), trait_fun, "CALC_QUANTILE")) return 0.0;
+          return SummarizeTraitEquation(group, trait_fun, QuantileSketch()).GetQuantile(quantile);
+        },
+        "Estimate the value of a trait (or equation) at a quantile (0.0 to 1.0) in bounded memory.");
+      type_info.AddMemberFunction("HISTOGRAM",
+        [this](GROUP_T & group, const emp::String & equation, size_t num_bins) -> emp::String {
+          const emp::String trait_fun = Preprocess(equation).result;
+          if (!RequireNumericEquation(group.GetDataLayout(), trait_fun, "HISTOGRAM")) return "[]";
+          // Find the range first (without storing values), then count the bins.
+          struct ValueRange {
+            double min_val = std::numeric_limits<double>::infinity();
+            double max_val = -std::numeric_limits<double>::infinity();
+            void Add(double value) { min_val = std::min(min_val, value); max_val = std::max(max_val, value); }
+            void Merge(const ValueRange & other) { Add(other.min_val); Add(other.max_val); }
+          };
+          const ValueRange range = SummarizeTraitEquation(group, trait_fun, ValueRange{});
+          if (range.min_val > range.max_val) return Histogram(num_bins).ToString();
+          const Histogram proto(num_bins, range.min_val, range.max_val);
+          return SummarizeTraitEquation(group, trait_fun, proto).ToString();
+        },
+        "List the counts of a trait (or equation) in evenly spaced bins from its min to its max.");
+      type_info.AddMemberFunction("HISTOGRAM_RANGE",
+        [this](GROUP_T & group, const emp::String & equation, size_t num_bins, double min_val, double max_val)
+          -> emp::String {
+          const emp::String trait_fun = Preprocess(equation).result;
+          if (!RequireNumericEquation(group.GetDataLayout(), trait_fun, "HISTOGRAM_RANGE")) return "[]";
+          const Histogram proto(num_bins, min_val, max_val);
+          return SummarizeTraitEquation(group, trait_fun, proto).ToString();
+        },
+        "List the counts of a trait (or equation) in evenly spaced bins (args: equation, bins, min, max).");
+      type_info.AddMemberFunction("LOG_HISTOGRAM",
+        [this](GROUP_T & group, const emp::String & equation, size_t num_bins, double min_val, double max_val)
+          -> emp::String {
+          const emp::String trait_fun = Preprocess(equation).result;
+          if (!RequireNumericEquation(group.GetDataLayout(), trait_fun, "LOG_HISTOGRAM")) return "[]";
+          if (min_val <= 0.0) {
+            emp::notify::Error("LOG_HISTOGRAM needs a positive minimum; given ", min_val, ".");
+            return "[]";
+          }
+          const Histogram proto(num_bins, min_val, max_val, true);
+          return SummarizeTraitEquation(group, trait_fun, proto).ToString();
+        },
+        "List the counts of a trait (or equation) in log-spaced bins (args: equation, bins, min, max).");
+
+      auto min_id_fun = BuildTraitFunction<GROUP_T>("min_id");
       type_info.AddMemberFunction("FIND_MIN",
-        [this](GROUP_T & group, const emp::String & trait_equation) -> Collection {
-          if (group.IsEmpty()) Collection{};
-          auto trait_fun =
-            BuildTraitSummary<GROUP_T>(trait_equation, "min_id", group.GetDataLayout());
-          return group.IteratorAt(trait_fun(group)).AsPosition();
+        [min_id_fun](GROUP_T & group, const emp::String & trait_equation) -> Collection {
+          Collection out = CollectionPool::Shared().Take();
+          if (!group.IsEmpty()) out.Insert(group.IteratorAt(min_id_fun(group, trait_equation)).AsPosition());
+          return out;
         },
         "Produce OrgList with just the org with the minimum value of the provided function.");
+      auto max_id_fun = BuildTraitFunction<GROUP_T>("max_id");
       type_info.AddMemberFunction("FIND_MAX",
-        [this](GROUP_T & group, const emp::String & trait_equation) -> Collection {
-          if (group.IsEmpty()) Collection{};
-          auto trait_fun =
-            BuildTraitSummary<GROUP_T>(trait_equation, "max_id", group.GetDataLayout());
-          return group.IteratorAt(trait_fun(group)).AsPosition();
+        [max_id_fun](GROUP_T & group, const emp::String & trait_equation) -> Collection {
+          Collection out = CollectionPool::Shared().Take();
+          if (!group.IsEmpty()) out.Insert(group.IteratorAt(max_id_fun(group, trait_equation)).AsPosition());
+          return out;
         },
         "Produce OrgList with just the org with the maximum value of the provided function.");
     }
@@ -258,6 +651,57 @@ namespace mabe {
                               [this](){ return control.GetRandomSeed(); },
                               [this](int seed){ control.SetRandomSeed(seed); },
                               "Seed for random number generator; use 0 to base on time.");
+      root_scope.LinkFuns<int>("num_threads",
+                              [this](){ return (int) control.GetNumThreads(); },
+                              [this](int count){ control.SetNumThreads(count > 0 ? count : 0); },
+                              "Threads to use for evaluation; 1 is serial, 0 uses all cores.");
+      root_scope.LinkFuns<int>("pin_threads",
+                              [this](){ return (int) control.GetThreadPool().GetPinThreads(); },
+                              [this](int on){ control.GetThreadPool().SetPinThreads(on != 0); },
+                              "Pin threads to NUMA nodes, giving each a fixed share of work? (1=yes; Linux)");
+      root_scope.LinkFuns<int>("parallel_births",
+                              [this](){ return (int) control.GetParallelBirths(); },
+                              [this](int on){ control.SetParallelBirths(on != 0); },
+                              "Mutate bulk offspring and initialize bulk injects across threads when org types allow? (1=yes)");
+      root_scope.LinkFuns<int>("balance_evals",
+                              [this](){ return (int) control.GetBalanceEvals(); },
+                              [this](int on){ control.SetBalanceEvals(on != 0); },
+                              "Time each parallel evaluation and start costly organisms (and their offspring) first? (1=yes)");
+      root_scope.LinkFuns<int>("concurrent_modules",
+                              [this](){ return (int) control.GetConcurrentModules(); },
+                              [this](int on){ control.SetConcurrentModules(on != 0); },
+                              "Run update steps of independent modules (marked as safe) at the same time? (1=yes)");
+      root_scope.LinkFuns<int>("check_interval",
+                              [this](){ return (int) control.GetCheckInterval(); },
+                              [this](int count){ control.SetCheckInterval(count > 0 ? count : 0); },
+                              "Debug builds: run full integrity checks every N updates (0=never).");
+      root_scope.LinkFuns<int>("check_samples",
+                              [this](){ return (int) control.GetCheckSamples(); },
+                              [this](int count){ control.SetCheckSamples(count > 0 ? count : 0); },
+                              "Debug builds: random positions per population to check on other updates.");
+      root_scope.LinkFuns<int>("profile",
+                              [this](){ return (int) control.GetProfiling(); },
+                              [this](int on){ control.SetProfiling(on != 0); },
+                              "Time each module signal and script event? (1=yes; table printed at exit)");
+      root_scope.LinkFuns<int>("profile_counters",
+                              [this](){ return (int) control.GetProfileCounters(); },
+                              [this](int on){ control.SetProfileCounters(on != 0); },
+                              "With profile=1, also count cycles, instructions, and cache/branch misses (Linux).");
+      root_scope.LinkFuns<int>("report_memory",
+                              [this](){ return (int) control.GetReportMemory(); },
+                              [this](int on){ control.SetReportMemory(on != 0); },
+                              "Print approximate memory use by each population and module at exit? (1=yes)");
+      root_scope.LinkFuns<int>("memo_queries",
+                              [this](){ return (int) memo_queries; },
+                              [this](int on){ memo_queries = (on != 0); memo_version = (uint64_t) -1; },
+                              "Reuse population query results (CALC_*, FILTER, etc.) until orgs or traits change? (1=yes)");
+      root_scope.LinkFuns<int>("compile_events",
+                              [this](){ return (int) GetSymbolTable().GetCompileEvents(); },
+                              [this](int on){ GetSymbolTable().SetCompileEvents(on != 0); },
+                              "Run event actions as compiled bytecode? (1=yes; same results, faster math)");
+
+      // Setup STATS as a read-only scope with throughput counters.
+      SetupStats(root_scope);
 
       // Setup "Population" as a type in the config file.
       auto pop_init_fun = [this](const emp::String & name) { return &control.AddPopulation(name); };
@@ -272,7 +716,24 @@ namespace mabe {
                                              pop_init_fun, pop_copy_fun);
 
       // Setup "Collection" as another config type.
-      emplode::TypeInfo & collect_type = AddType<Collection>("OrgList", "Collection of organism pointers");
+      // OrgLists are mostly temporaries (function results), so they are drawn from the shared
+      // CollectionPool and moved, rather than copied, out of the functions that build them.
+      auto collect_init_fun = [](const emp::String & /*name*/) {
+        return emp::Ptr<EmplodeType>(CollectionPool::Shared().Acquire());
+      };
+      emplode::TypeInfo & collect_type = AddType<Collection>("OrgList", "Collection of organism pointers",
+                                                 collect_init_fun, GetSymbolTable().DefaultCopyFun<Collection>(), true);
+      collect_type.SetMoveFun([](EmplodeType & from, EmplodeType & to) {
+        emp::Ptr<Collection> from_ptr = dynamic_cast<Collection *>(&from);
+        emp::Ptr<Collection> to_ptr = dynamic_cast<Collection *>(&to);
+        if (!from_ptr || !to_ptr) return false;
+        std::swap(*from_ptr, *to_ptr);                        // 'to' was empty; keep its storage.
+        CollectionPool::Shared().Give(std::move(*from_ptr));
+        return true;
+      });
+      collect_type.SetReleaseFun([](emp::Ptr<EmplodeType> obj_ptr) {
+        CollectionPool::Shared().Release(obj_ptr.DynamicCast<Collection>());
+      });
 
       Initialize_GroupType<Population>(pop_type);
       Initialize_GroupType<Collection>(collect_type);
@@ -285,19 +746,45 @@ namespace mabe {
         [this](Population & to_pop, Population & from_pop){
           control.MoveOrgs(from_pop, to_pop, false); return 0;
         }, "Move all organisms organisms from another population, adding after current orgs." );
+      pop_type.AddMemberFunction("SWAP_WITH",
+        [this](Population & pop1, Population & pop2){
+          control.SwapPops(pop1, pop2); return 0;
+        }, "Exchange all organisms with another population in a single step." );
 
       pop_type.AddMemberFunction("FILTER",
         [this](Population & pop, const emp::String & trait_equation) -> Collection {
-          Collection out_collect;
+          const emp::String memo_key = GetMemoKey(pop, "FILTER", trait_equation);
+          if (memo_key.size()) {
+            auto it = memo_filters.find(memo_key);
+            if (it != memo_filters.end()) { ++memo_hits; return it->second; }
+            ++memo_misses;
+          }
+          Collection out_collect = CollectionPool::Shared().Take();
           if (pop.GetNumOrgs() > 0) { // Only do this work if we actually have organisms!
-            auto filter = BuildTraitEquation(pop.GetDataLayout(), trait_equation);
-            for (auto it = pop.begin(); it != pop.end(); ++it) {
-              if (filter(*it)) out_collect.Insert(it);
+            const emp::vector<double> results = EvalTraitEquation(pop, trait_equation);
+            // Each chunk gathers its own passing positions; join them in order.
+            ThreadPool & pool = control.GetThreadPool();
+            const bool parallel = pool.IsParallel() && results.size() > MIN_PARALLEL_ORGS;
+            const size_t num_chunks = parallel ? pool.CalcNumChunks(results.size()) : 1;
+            emp::vector<emp::vector<size_t>> chunk_passed(num_chunks);
+            auto filter_range = [&results, &chunk_passed](size_t chunk_id, size_t start, size_t end) {
+              for (size_t pos = start; pos < end; ++pos) {
+                if (results[pos]) chunk_passed[chunk_id].push_back(pos);
+              }
+            };
+            if (parallel) pool.ForEachChunk(results.size(), filter_range);
+            else filter_range(0, 0, results.size());
+            emp::vector<size_t> passed = std::move(chunk_passed[0]);
+            for (size_t i = 1; i < chunk_passed.size(); ++i) {
+              passed.insert(passed.end(), chunk_passed[i].begin(), chunk_passed[i].end());
             }
+            out_collect.InsertPositions(pop, std::span<const size_t>(passed.data(), passed.size()));
           }
+          if (memo_key.size()) memo_filters[memo_key] = out_collect;
           return out_collect;
         },
-        "Produce OrgList with just the orgs that pass through the filter criteria.");
+        "Produce OrgList with just the orgs that pass through the filter criteria.\n"
+        "Script variables can be named directly (e.g. \"fitness < cutoff\") to use their current values.");
 
       // ------ DEPRECATED FUNCTION NAMES ------
       Deprecate("EVAL", "EXEC");
@@ -309,6 +796,24 @@ namespace mabe {
       AddFunction("EXIT", [this](){ control.RequestExit(); return 0; }, "Exit from this MABE run.");
       AddFunction("GET_UPDATE", [this](){ return control.GetUpdate(); }, "Get current update.");
       AddFunction("GET_VERBOSE", [this](){ return control.GetVerbose(); }, "Has the verbose flag been set?");
+      std::function<int(const emp::String &)> write_profile_fun =
+        [this](const emp::String & filename) { return (int) control.WriteProfile(filename); };
+      AddFunction("WRITE_PROFILE", write_profile_fun,
+        "Write signal and event timings (so far) to the named CSV file; requires 'profile = 1'.");
+      std::function<int(const emp::String &)> checkpoint_fun =
+        [this](const emp::String & filename) { return (int) control.Checkpoint(filename); };
+      AddFunction("CHECKPOINT", checkpoint_fun,
+        "Save the full run state to the named file; continue a run from it with '--restore'.");
+      std::function<int(const emp::String &)> checkpoint_delta_fun =
+        [this](const emp::String & filename) { return (int) control.CheckpointDelta(filename); };
+      AddFunction("CHECKPOINT_DELTA", checkpoint_delta_fun,
+        "Save only the organisms changed since the last checkpoint (plus RNG and module state);\n"
+        "'--restore' on it loads the earlier checkpoints it builds on first.");
+      std::function<size_t(size_t)> fork_fun =
+        [this](size_t num_forks) { return control.Fork(num_forks, "fork_"); };
+      AddFunction("FORK", fork_fun,
+        "Fork the run into N copies (Unix only), each with its own seed and directory 'fork_ID';\n"
+        "returns the copy's ID (1 to N), or 0 in the original, which waits for all and exits.");
       AddFunction("DEBUG_AST", [this](){ control.PrintAST(); return 0; }, "Print the current state of the Abstract Syntax Tree.");
 
       std::function<emp::String(const emp::String &)> preprocess_fun =
@@ -321,6 +826,53 @@ namespace mabe {
     }
 
 
+    /// Build the STATS scope; rates are measured over the time since that rate was last read,
+    /// so each should be read at most once per output (e.g., in a single DataFile column).
+    void SetupStats(emplode::Symbol_Scope & root_scope) {
+      stats_scope = &root_scope.AddScope("STATS", "Run-time statistics (read only).", true);
+      auto add_stat = [this](const emp::String & name, std::function<double()> get_fun,
+                             const emp::String & desc) { AddStat(name, get_fun, desc); };
+      const auto & run_stats = control.GetRunStats();
+      add_stat("births", [&run_stats](){ return (double) run_stats.births; },
+               "Total organisms born (placed with a parent).");
+      add_stat("injections", [&run_stats](){ return (double) run_stats.injections; },
+               "Total organisms injected (placed without a parent).");
+      add_stat("deaths", [&run_stats](){ return (double) run_stats.deaths; },
+               "Total organisms removed from populations.");
+      add_stat("alive", [&run_stats](){ return (double) run_stats.GetNumAlive(); },
+               "Organisms currently alive in all populations (see pop.NUM_ORGS() for one).");
+      add_stat("evaluations", [&run_stats](){ return (double) run_stats.evaluations; },
+               "Total organisms passed to evaluation modules.");
+      add_stat("insts_executed", [&run_stats](){ return (double) run_stats.insts_executed; },
+               "Total process steps (e.g., CPU instructions) run by organisms.");
+      add_stat("allocations", [&run_stats](){ return (double) run_stats.allocations; },
+               "Total organisms built with a new memory allocation.");
+      add_stat("update_allocations", [this](){ return (double) control.GetUpdateAllocations(); },
+               "Organisms built with a new memory allocation during the last update.");
+      add_stat("pop_bytes", [this](){ return (double) control.GetPopBytes(); },
+               "Approximate bytes held by all populations (see pop.NUM_BYTES() for one).");
+      add_stat("module_bytes", [this](){ return (double) control.GetModuleBytes(); },
+               "Approximate bytes held by module archives, caches, and weight maps.");
+      add_stat("memo_hits", [this](){ return (double) memo_hits; },
+               "Population queries answered from the per-update memo.");
+      add_stat("memo_misses", [this](){ return (double) memo_misses; },
+               "Population queries that had to be calculated and were then memoized.");
+      add_stat("collections_made", [](){ return (double) CollectionPool::Shared().GetNumMade(); },
+               "OrgLists (and other collections) that needed new storage.");
+      add_stat("collections_reused", [](){ return (double) CollectionPool::Shared().GetNumReused(); },
+               "OrgLists (and other collections) built from recycled storage.");
+      add_stat("births_per_sec", [this,&run_stats](){ return births_rate.Update(run_stats.births); },
+               "Births per second since last read.");
+      add_stat("deaths_per_sec", [this,&run_stats](){ return deaths_rate.Update(run_stats.deaths); },
+               "Deaths per second since last read.");
+      add_stat("evals_per_sec",
+               [this,&run_stats](){ return evals_rate.Update(run_stats.evaluations); },
+               "Evaluations per second since last read.");
+      add_stat("insts_per_sec",
+               [this,&run_stats](){ return insts_rate.Update(run_stats.insts_executed); },
+               "Process steps per second since last read.");
+    }
+
     void Deprecate(const emp::String & old_name, const emp::String & new_name) {
       auto dep_fun = [this,old_name,new_name](const emp::vector<emp::Ptr<emplode::Symbol>> &){
           std::cerr << "Function '" << old_name << "' deprecated; use '" << new_name << "'\n";
@@ -10,6 +10,8 @@
 #ifndef MABE_MANAGER_MODULE_H
 #define MABE_MANAGER_MODULE_H
 
+#include <type_traits>
+
 #include "emp/meta/TypeID.hpp"
 
 #include "MABE.hpp"
@@ -41,6 +43,13 @@ namespace mabe {
 
     auto & SharedData() { return GetManager().data; }
     const auto & SharedData() const { return GetManager().data; }
+
+    /// Clone this object as its own type, straight through its manager (no dynamic casts).
+    [[nodiscard]] emp::Ptr<MANAGED_T> CloneProduct() const {
+      return GetManager().CloneManaged(static_cast<const MANAGED_T &>(*this));
+    }
+
+    [[nodiscard]] emp::Ptr<OrgType> Clone() const override { return CloneProduct(); }
   };
 
 
@@ -61,6 +70,16 @@ namespace mabe {
     /// Maintain a prototype for the objects being created.
     emp::Ptr<BASE_T> obj_prototype;
 
+    /// Released objects kept to be reused (via copy assignment) the next time a clone is needed,
+    /// so that their internal storage (DataMap, genome, etc.) does not need to be reallocated.
+    emp::vector<emp::Ptr<MANAGED_T>> free_pool;
+    size_t max_pool_size = 4096;  ///< Maximum number of released objects to hold onto.
+    size_t num_allocated = 0;     ///< Number of objects created by new allocations.
+    size_t num_reused = 0;        ///< Number of objects created by reusing a released object.
+
+    /// Objects can only be reused if they can be copy-assigned.
+    static constexpr bool can_reuse = std::is_copy_assignable_v<MANAGED_T>;
+
   public:
     ManagerModule(MABE & in_control, const emp::String & in_name, const emp::String & in_desc="")
       : Module(in_control, in_name, in_desc)
@@ -68,7 +87,10 @@ namespace mabe {
       SetManageMod(); // @CAO should specify what type of object is managed.
       obj_prototype = emp::NewPtr<managed_t>(*this);
     }
-    virtual ~ManagerModule() { obj_prototype.Delete(); }
+    virtual ~ManagerModule() {
+      obj_prototype.Delete();
+      for (auto obj_ptr : free_pool) obj_ptr.Delete();
+    }
 
     data_t & GetManagedData() { return data; }
     const data_t & GetManagedData() const { return data; }
@@ -79,9 +101,74 @@ namespace mabe {
     /// Also get the TypeID for more run-time type management.
     emp::TypeID GetObjType() const override { return emp::GetTypeID<managed_t>(); }
 
-    /// Create a clone of the provided object; default to using copy constructor.
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("NUM_ALLOCATED",
+                             [](ManagerModule & mod) { return mod.GetNumAllocated(); },
+                             "Number of objects built with a new memory allocation.");
+      info.AddMemberFunction("NUM_REUSED",
+                             [](ManagerModule & mod) { return mod.GetNumReused(); },
+                             "Number of objects built by reusing a released object.");
+      // Managed types can add their own functions, e.g. to report data shared by all objects.
+      if constexpr (requires { MANAGED_T::template InitManagerType<ManagerModule>(info); }) {
+        MANAGED_T::template InitManagerType<ManagerModule>(info);
+      }
+    }
+
+    size_t GetNumAllocated() const { return num_allocated; }
+    size_t GetNumReused() const { return num_reused; }
+    size_t GetPoolSize() const { return free_pool.size(); }
+
+    /// Bytes held by the prototype and the released objects kept for reuse.
+    size_t GetNumBytes() const override {
+      size_t num_bytes = free_pool.capacity() * sizeof(emp::Ptr<MANAGED_T>);
+      if constexpr (requires (const MANAGED_T & obj) { obj.GetNumBytes(); }) {
+        num_bytes += obj_prototype->GetNumBytes();
+        for (auto obj_ptr : free_pool) num_bytes += obj_ptr->GetNumBytes();
+      }
+      return num_bytes;
+    }
+    size_t GetMaxPoolSize() const { return max_pool_size; }
+
+    /// Limit how many released objects are kept for reuse; 0 disables reuse.
+    void SetMaxPoolSize(size_t in_max) {
+      max_pool_size = in_max;
+      while (free_pool.size() > max_pool_size) {
+        free_pool.back().Delete();
+        free_pool.pop_back();
+      }
+    }
+
+    /// Create a clone of the provided object; reuse a released object if one is available
+    /// (copy assignment keeps its DataMap and genome storage), otherwise use the copy constructor.
+    emp::Ptr<managed_t> CloneManaged(const managed_t & obj) {
+      if constexpr (can_reuse) {
+        if (free_pool.size()) {
+          emp::Ptr<managed_t> obj_ptr = free_pool.back();
+          free_pool.pop_back();
+          *obj_ptr = obj;
+          ++num_reused;
+          return obj_ptr;
+        }
+      }
+      ++num_allocated;
+      ++control.GetRunStats().allocations;
+      return emp::NewPtr<managed_t>(obj);
+    }
+
     emp::Ptr<OrgType> CloneObject_impl(const OrgType & obj) override {
-      return emp::NewPtr<managed_t>( (const managed_t &) obj );
+      return CloneManaged( (const managed_t &) obj );
+    }
+
+    /// Take back an object that is no longer needed; hold onto it for reuse if possible.
+    void RecycleObject(emp::Ptr<OrgType> obj_ptr) override {
+      if constexpr (can_reuse) {
+        if (free_pool.size() < max_pool_size) {
+          free_pool.push_back(obj_ptr.DynamicCast<managed_t>());
+          return;
+        }
+      }
+      obj_ptr.Delete();
     }
 
     /// Create a random object from scratch.  Default to using the obj_prototype object.
@@ -95,6 +182,7 @@ namespace mabe {
     emp::Ptr<OrgType> MakeRandom_impl(emp::Random & random) override {
       auto obj_ptr = obj_prototype->Clone();
       obj_ptr->Initialize(random);
+      obj_ptr->MarkGenomeChanged();
       return obj_ptr;
     }
 
@@ -123,6 +211,7 @@ namespace mabe {
 
     void SetupDataMap(emp::DataMap & in_dm) override {
       obj_prototype->SetDataMap(in_dm);
+      obj_prototype->SetupDataMap(in_dm);
     }
 
     void SetupConfig() override {
@@ -68,6 +68,9 @@ namespace mabe {
 
     TraitManager<ModuleBase> & GetTraitManager() override { return control.GetTraitManager(); }
 
+    /// Scripted calls into a module (e.g., an evaluation) may write to any trait.
+    void BeforeMemberCall() override { control.MarkStateChanged(); }
+
     void SetupConfig_Internal() override {
       emp_assert( setup_config_internal_run == false,
                   "SetupConfig_Internal() should be run only once.");
@@ -81,7 +84,7 @@ namespace mabe {
       }      
     }
 
-    void SetupModule_Internal() override final {
+    void SetupModule_Internal() override {
       emp_assert( setup_module_internal_run == false,
                   "SetupModule_Internal() should be run only once.");
       EMP_DEBUG( setup_module_internal_run = true; )
@@ -342,6 +345,16 @@ namespace mabe {
       control.RescanSignals();
     }
 
+    // Format:  OnPlacementBatch(std::span<const OrgPosition> placement_positions)
+    // Trigger: One or more new organisms have been placed in populations (after any OnPlacement).
+    // Args:    Positions of the new organisms, in the order they were placed.
+    // Note:    Bulk operations (DoBirths, CopyPop) send their placements in one batch; other
+    //          placements arrive one at a time.  Override this OR OnPlacement, not both.
+    void OnPlacementBatch(std::span<const OrgPosition>) override {
+      has_signal[SIG_OnPlacementBatch] = false;
+      control.RescanSignals();
+    }
+
     // Format:  BeforeMutate(Organism & org)
     // Trigger: Mutate is about to run on an organism.
     // Args:    Organism about to mutate.
@@ -366,6 +379,16 @@ namespace mabe {
       control.RescanSignals();
     }
 
+    // Format:  BeforeDeathBatch(std::span<const OrgPosition> remove_positions)
+    // Trigger: One or more organisms are about to die (before any BeforeDeath).
+    // Args:    Positions of the organisms about to die; all are still in place.
+    // Note:    Clearing a whole population sends one batch; other deaths arrive one at a time.
+    //          Override this OR BeforeDeath, not both.
+    void BeforeDeathBatch(std::span<const OrgPosition>) override {
+      has_signal[SIG_BeforeDeathBatch] = false;
+      control.RescanSignals();
+    }
+
     // Format:  BeforeSwap(OrgPosition pos1, OrgPosition pos2)
     // Trigger: Two organisms' positions in the population are about to move.
     // Args:    Positions of organisms about to be swapped.
@@ -398,6 +421,22 @@ namespace mabe {
       control.RescanSignals();
     }
 
+    // Format:  BeforePopSwap(Population & pop1, Population & pop2)
+    // Trigger: Two populations are about to exchange all of their organisms.
+    // Args:    Populations about to be swapped.
+    void BeforePopSwap(Population &, Population &) override {
+      has_signal[SIG_BeforePopSwap] = false;
+      control.RescanSignals();
+    }
+
+    // Format:  OnPopSwap(Population & pop1, Population & pop2)
+    // Trigger: Two populations have just exchanged all of their organisms.
+    // Args:    Populations just swapped; organisms keep their positions within the swap.
+    void OnPopSwap(Population &, Population &) override {
+      has_signal[SIG_OnPopSwap] = false;
+      control.RescanSignals();
+    }
+
     // Format:  BeforeExit()
     // Trigger: Run immediately before MABE is about to exit.
     void BeforeExit() override {
@@ -431,13 +470,17 @@ namespace mabe {
     bool OnInjectReady_IsTriggered() override { return control.OnInjectReady_IsTriggered(this); };
     bool BeforePlacement_IsTriggered() override { return control.BeforePlacement_IsTriggered(this); };
     bool OnPlacement_IsTriggered() override { return control.OnPlacement_IsTriggered(this); };
+    bool OnPlacementBatch_IsTriggered() override { return control.OnPlacementBatch_IsTriggered(this); };
     bool BeforeMutate_IsTriggered() override { return control.BeforeMutate_IsTriggered(this); };
     bool OnMutate_IsTriggered() override { return control.OnMutate_IsTriggered(this); };
     bool BeforeDeath_IsTriggered() override { return control.BeforeDeath_IsTriggered(this); };
+    bool BeforeDeathBatch_IsTriggered() override { return control.BeforeDeathBatch_IsTriggered(this); };
     bool BeforeSwap_IsTriggered() override { return control.BeforeSwap_IsTriggered(this); };
     bool OnSwap_IsTriggered() override { return control.OnSwap_IsTriggered(this); };
     bool BeforePopResize_IsTriggered() override { return control.BeforePopResize_IsTriggered(this); };
     bool OnPopResize_IsTriggered() override { return control.OnPopResize_IsTriggered(this); };
+    bool BeforePopSwap_IsTriggered() override { return control.BeforePopSwap_IsTriggered(this); };
+    bool OnPopSwap_IsTriggered() override { return control.OnPopSwap_IsTriggered(this); };
     bool BeforeExit_IsTriggered() override { return control.BeforeExit_IsTriggered(this); };
     bool OnHelp_IsTriggered() override { return control.OnHelp_IsTriggered(this); };
 
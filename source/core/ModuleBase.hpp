@@ -34,12 +34,16 @@
  *       : Placement location has been identified (For birth or inject)
  *     OnPlacement(OrgPosition placement_pos)
  *       : New organism has been placed in the population.
+ *     OnPlacementBatch(std::span<const OrgPosition> placement_positions)
+ *       : One or more new organisms have been placed (alternative to OnPlacement).
  *     BeforeMutate(Organism & org)
  *       : Mutate is about to run on an organism.
  *     OnMutate(Organism & org)
  *       : Organism has had its genome changed due to mutation.
  *     BeforeDeath(OrgPosition remove_pos)
  *       : Organism is about to die.
+ *     BeforeDeathBatch(std::span<const OrgPosition> remove_positions)
+ *       : One or more organisms are about to die (alternative to BeforeDeath).
  *     BeforeSwap(OrgPosition pos1, OrgPosition pos2)
  *       : Two organisms' positions in the population are about to move.
  *     OnSwap(OrgPosition pos1, OrgPosition pos2)
@@ -48,6 +52,10 @@
  *       : Full population is about to be resized.
  *     OnPopResize(Population & pop, size_t old_size)
  *       : Full population has just been resized.
+ *     BeforePopSwap(Population & pop1, Population & pop2)
+ *       : Two populations are about to exchange all of their organisms.
+ *     OnPopSwap(Population & pop1, Population & pop2)
+ *       : Two populations have just exchanged all of their organisms.
  *     BeforeExit()
  *       : Run immediately before MABE is about to exit.
  *     OnHelp()
@@ -66,6 +74,7 @@
 #include "emp/base/vector.hpp"
 #include "emp/datastructs/map_utils.hpp"
 #include "emp/datastructs/reference_vector.hpp"
+#include "emp/polyfill/span.hpp"
 #include "emp/tools/String.hpp"
 
 #include "../Emplode/Emplode.hpp"
@@ -94,11 +103,14 @@ namespace mabe {
   class ModuleBase : public EmplodeType, public TraitHolder {
     friend MABE;
     friend BaseTrait;
+    friend OrgType;
   protected:
     emp::String name;          ///< Unique name for this module.
     emp::String desc;          ///< Description for this module.
     mabe::MABE & control;      ///< Reference to main mabe controller using module
     bool is_builtin=false;     ///< Is this a built-in module not for config?
+    bool concurrent_update=false; ///< Can BeforeUpdate/OnUpdate run alongside other modules?
+    bool concurrent_calls=false;  ///< Can script calls run alongside others in PARALLEL?
 
     /// Informative tags about this module.  Expected tags include:
     ///   "Analyze"     : Makes measurements on the population.
@@ -131,13 +143,17 @@ namespace mabe {
       SIG_OnInjectReady,
       SIG_BeforePlacement,
       SIG_OnPlacement,
+      SIG_OnPlacementBatch,
       SIG_BeforeMutate,
       SIG_OnMutate,
       SIG_BeforeDeath,
+      SIG_BeforeDeathBatch,
       SIG_BeforeSwap,
       SIG_OnSwap,
       SIG_BeforePopResize,
       SIG_OnPopResize,
+      SIG_BeforePopSwap,
+      SIG_OnPopSwap,
       SIG_BeforeExit,
       SIG_OnHelp,
       NUM_SIGNALS,
@@ -161,6 +177,9 @@ namespace mabe {
       emp_assert(false, "Make_impl() must be overridden for ManagerModule.");
       return nullptr;
     }
+    virtual void RecycleObject(emp::Ptr<OrgType>) {
+      emp_assert(false, "RecycleObject() must be overridden for ManagerModule.");
+    }
 
   public:
     ModuleBase(MABE & in_control, const emp::String & in_name, const emp::String & in_desc="")
@@ -192,6 +211,20 @@ namespace mabe {
     bool IsBuiltIn() const { return is_builtin; }
     void SetBuiltIn(bool _in=true) { is_builtin = _in; }
 
+    /// A module should only be marked concurrent if its BeforeUpdate() and OnUpdate() touch
+    /// nothing but its own state, files, and declared traits: no random numbers from control,
+    /// no births, deaths, or moves, and no output to the terminal.
+    bool IsConcurrentUpdate() const { return concurrent_update; }
+    void SetConcurrentUpdate(bool _in=true) { concurrent_update = _in; }
+
+    /// Calls to this module's member functions in a script PARALLEL block may overlap other
+    /// statements only if it is marked here.  That requires every member function to meet the
+    /// rules above and to change only its own declared traits: selection, placement, birth,
+    /// and replication all share the random number generator and populations, so they must
+    /// never be marked.
+    bool IsConcurrentCalls() const { return concurrent_calls; }
+    void SetConcurrentCalls(bool _in=true) { concurrent_calls = _in; }
+
     bool IsAnalyzeMod() const { return emp::Has(action_tags, "Analyze"); }
     bool IsEvaluateMod() const { return emp::Has(action_tags, "Evaluate"); }
     bool IsInterfaceMod() const { return emp::Has(action_tags, "Interface"); }
@@ -228,6 +261,16 @@ namespace mabe {
     /// Internal notification of DataMaps being locked in.
     virtual void SetupDataMap_Internal(emp::DataMap &) = 0;
 
+    /// Save any internal state needed to continue a run from a checkpoint.
+    virtual void SaveState(CheckpointWriter &) const { /* By default, no state to save. */ }
+
+    /// Restore internal state written by SaveState(); called after organisms are restored.
+    virtual void LoadState(CheckpointReader &) { /* By default, no state to load. */ }
+
+    /// Approximate bytes of large data held by this module (archives, caches, weight maps);
+    /// used for memory reports, so it should be cheap to compute.
+    virtual size_t GetNumBytes() const { return 0; }
+
     // ----==== SIGNALS ====----
 
     // Base classes for signals to be called (More details in Module.h)
@@ -239,13 +282,17 @@ namespace mabe {
     virtual void OnInjectReady(Organism &, Population &) = 0;
     virtual void BeforePlacement(Organism &, OrgPosition, OrgPosition) = 0;
     virtual void OnPlacement(OrgPosition) = 0;
+    virtual void OnPlacementBatch(std::span<const OrgPosition>) = 0;
     virtual void BeforeMutate(Organism &) = 0;
     virtual void OnMutate(Organism &) = 0;
     virtual void BeforeDeath(OrgPosition) = 0;
+    virtual void BeforeDeathBatch(std::span<const OrgPosition>) = 0;
     virtual void BeforeSwap(OrgPosition, OrgPosition) = 0;
     virtual void OnSwap(OrgPosition, OrgPosition) = 0;
     virtual void BeforePopResize(Population &, size_t) = 0;
     virtual void OnPopResize(Population &, size_t) = 0;
+    virtual void BeforePopSwap(Population &, Population &) = 0;
+    virtual void OnPopSwap(Population &, Population &) = 0;
     virtual void BeforeExit() = 0;
     virtual void OnHelp() = 0;
 
@@ -259,13 +306,17 @@ namespace mabe {
     virtual bool OnInjectReady_IsTriggered() = 0;
     virtual bool BeforePlacement_IsTriggered() = 0;
     virtual bool OnPlacement_IsTriggered() = 0;
+    virtual bool OnPlacementBatch_IsTriggered() = 0;
     virtual bool BeforeMutate_IsTriggered() = 0;
     virtual bool OnMutate_IsTriggered() = 0;
     virtual bool BeforeDeath_IsTriggered() = 0;
+    virtual bool BeforeDeathBatch_IsTriggered() = 0;
     virtual bool BeforeSwap_IsTriggered() = 0;
     virtual bool OnSwap_IsTriggered() = 0;
     virtual bool BeforePopResize_IsTriggered() = 0;
     virtual bool OnPopResize_IsTriggered() = 0;
+    virtual bool BeforePopSwap_IsTriggered() = 0;
+    virtual bool OnPopSwap_IsTriggered() = 0;
     virtual bool BeforeExit_IsTriggered() = 0;
     virtual bool OnHelp_IsTriggered() = 0;
 
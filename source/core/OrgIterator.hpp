@@ -9,7 +9,10 @@
  *  Organisms in MABE are stored in indexed collections (typically Population objects).
  *  This class allows you to refer to the position of an organism and step through sets of organisms.
  * 
- *  An OrgIterator_Interface sets up all of the virtual functions in all iterators.
+ *  An OrgIterator_Interface sets up the shared interface for all iterators.  It is a curiously
+ *  recurring template: derived iterators supply IncPosition(), DecPosition(), ShiftPosition(),
+ *  ToBegin(), and ToEnd() (and declare the interface a friend), which are called directly on the
+ *  derived type, so stepping an iterator involves no virtual calls and can be fully inlined.
  *
  *  @todo Add a reverse iterator.
  *  @todo Fix operator-- which can go off of the beginning of the world.
@@ -59,12 +62,8 @@ namespace mabe {
     using container_ptr_t = emp::Ptr<CONTAINER_T>;
     using pop_t = emp::match_const_t<Population, CONTAINER_T>;
 
-    // Helper functions to be overloaded in derived classes.
-    virtual void IncPosition() = 0;
-    virtual void DecPosition() = 0;
-    virtual void ShiftPosition(int=1) = 0;
-    virtual void ToBegin() = 0;
-    virtual void ToEnd() = 0;
+    // Helper functions that DERIVED_T must provide: IncPosition(), DecPosition(),
+    // ShiftPosition(int), ToBegin(), and ToEnd().
 
     DERIVED_T & AsDerived() { return (DERIVED_T &) *this; }
 
@@ -80,7 +79,7 @@ namespace mabe {
     OrgIterator_Interface(const this_t &) = default;
 
     /// Destructor
-    virtual ~OrgIterator_Interface() { }
+    ~OrgIterator_Interface() { }
 
     /// Copy operator
     this_t & operator=(const this_t & in) = default;
@@ -144,25 +143,25 @@ namespace mabe {
     bool IsInPop(const Population & pop) const { return ConstPopPtr() == &pop; }
 
     /// Advance iterator to the next non-empty cell in the world.
-    DERIVED_T & operator++() { IncPosition(); return AsDerived(); }
+    DERIVED_T & operator++() { AsDerived().IncPosition(); return AsDerived(); }
 
     /// Postfix++: advance iterator to the next non-empty cell in the world.
     DERIVED_T operator++(int) {
       DERIVED_T out = AsDerived();
-      IncPosition();
+      AsDerived().IncPosition();
       return out;
     }
 
     /// Backup iterator to the previous non-empty cell in the world.
     DERIVED_T & operator--() {
-      DecPosition();
+      AsDerived().DecPosition();
       return AsDerived();
     }
 
     /// Postfix--: Backup iterator to the previous non-empty cell in the world.
     DERIVED_T operator--(int) {
       DERIVED_T out = AsDerived();
-      DecPosition();
+      AsDerived().DecPosition();
       return out;
     }
 
@@ -181,15 +180,18 @@ namespace mabe {
 
     // Compound math operations...
     DERIVED_T & operator+=(int x) {
-      ShiftPosition(x);
+      AsDerived().ShiftPosition(x);
       return AsDerived();
     }
 
     DERIVED_T & operator-=(int x) {
-      ShiftPosition(-x);
+      AsDerived().ShiftPosition(-x);
       return AsDerived();
     }
 
+    /// Iterators are equal if they refer to the same position in the same container.
+    bool operator==(const this_t & in) const { return pop_ptr == in.pop_ptr && pos == in.pos; }
+
     auto operator<=>(const this_t & in) const {
         return (pop_ptr == in.pop_ptr) ? (pos <=>  in.pos) : (pop_ptr <=> in.pop_ptr);
     }
@@ -237,11 +239,13 @@ namespace mabe {
   protected:
     using base_t = OrgIterator_Interface<OrgPosition>;
 
-    void IncPosition() override { emp_error("IncPosition(shift_size) not defined in OrgPosition."); }
-    void DecPosition() override { emp_error("DecPosition(shift_size) not defined in OrgPosition."); }
-    void ShiftPosition(int=1) override { emp_error("ShiftPosition(shift_size) not defined in OrgPosition."); }
-    void ToBegin() override { emp_error("ToBegin() not defined in OrgPosition."); }
-    void ToEnd() override { emp_error("ToEnd() not defined in OrgPosition."); }
+    friend base_t;
+
+    void IncPosition() { emp_error("IncPosition(shift_size) not defined in OrgPosition."); }
+    void DecPosition() { emp_error("DecPosition(shift_size) not defined in OrgPosition."); }
+    void ShiftPosition(int=1) { emp_error("ShiftPosition(shift_size) not defined in OrgPosition."); }
+    void ToBegin() { emp_error("ToBegin() not defined in OrgPosition."); }
+    void ToEnd() { emp_error("ToEnd() not defined in OrgPosition."); }
 
   public:
     /// Constructor where you can optionally supply population pointer and position.
@@ -263,11 +267,13 @@ namespace mabe {
   protected:
     using base_t = OrgIterator_Interface<ConstOrgPosition, const Organism>;
 
-    void IncPosition() override { emp_error("IncPosition(shift_size) not defined in ConstOrgPosition."); }
-    void DecPosition() override { emp_error("DecPosition(shift_size) not defined in ConstOrgPosition."); }
-    void ShiftPosition(int=1) override { emp_error("ShiftPosition(shift_size) not defined in ConstOrgPosition."); }
-    void ToBegin() override { emp_error("ToBegin() not defined in ConstOrgPosition."); }
-    void ToEnd() override { emp_error("ToEnd() not defined in ConstOrgPosition."); }
+    friend base_t;
+
+    void IncPosition() { emp_error("IncPosition(shift_size) not defined in ConstOrgPosition."); }
+    void DecPosition() { emp_error("DecPosition(shift_size) not defined in ConstOrgPosition."); }
+    void ShiftPosition(int=1) { emp_error("ShiftPosition(shift_size) not defined in ConstOrgPosition."); }
+    void ToBegin() { emp_error("ToBegin() not defined in ConstOrgPosition."); }
+    void ToEnd() { emp_error("ToEnd() not defined in ConstOrgPosition."); }
 
   public:
     /// Constructor where you can optionally supply population pointer and position.
@@ -45,6 +45,8 @@ namespace mabe {
     emp::String config_name;                  ///< Trait name in config file.
     emp::String config_desc;                  ///< Description for trait name in config file.
     size_t id = emp::MAX_SIZE_T;              ///< ID of this trait in the DataMap.
+    TraitInfo::Usage usage = TraitInfo::Usage::EVAL;  ///< Declared access frequency.
+    bool usage_set = false;                   ///< Was a usage declared for this trait?
 
   public:
     BaseTrait(Access _a, bool _m, emp::Ptr<TraitHolder> _hp, const emp::String & _n,
@@ -85,7 +87,8 @@ namespace mabe {
     void SetName(const emp::String & _name) { name = _name; }
     void SetConfigName(const emp::String & _name) { config_name = _name; }
     void SetConfigDesc(const emp::String & _desc) { config_desc = _desc; }
-    void SetupDataMap(const emp::DataMap & dm) { id = dm.GetID(name); }
+    void SetUsage(TraitInfo::Usage _usage) { usage = _usage; usage_set = true; }
+    virtual void SetupDataMap(const emp::DataMap & dm) { id = dm.GetID(name); }
 
     virtual bool ReadOK() const = 0;
     virtual bool WriteOK() const = 0;
@@ -119,6 +122,15 @@ namespace mabe {
       else return org.GetTrait<T>(id);
     }
 
+    /// View() gives read access without a copy when the organism stores this trait's value
+    /// itself (see Organism::GetTraitView()); otherwise it generates the organism's output and
+    /// returns the trait.
+    const T & View(mabe::Organism & org) const requires (!MULTI) {
+      if (const void * view = org.GetTraitView(id)) return *static_cast<const T *>(view);
+      org.GenerateOutput();
+      return org.GetTrait<T>(id);
+    }
+
     /// A trait supplied with an organism converts to the trait reference for that organism.
     inline get_t operator()(mabe::Organism & org) const { return Get(org); }
 
@@ -150,7 +162,9 @@ namespace mabe {
     //  @CAO: Needs cleanup and better integration with TraitInfo.
     void AddTrait() override {
       emp_assert(module_ptr, "Internal error - module pointer should have been set before AddTrait is called.");
-      module_ptr->GetTraitManager().AddTrait<T>(module_ptr, ACCESS, name, desc, default_value, GetCount());
+      TraitInfo & info =
+        module_ptr->GetTraitManager().AddTrait<T>(module_ptr, ACCESS, name, desc, default_value, GetCount());
+      if (usage_set) info.SetUsage(usage);
     }
 
     bool ReadOK() const override {
@@ -206,6 +220,34 @@ namespace mabe {
     bool OtherWriteOK() const override { return true; }
   };
 
+  /// A read-only trait whose value is derived from the organism each time it is read, such as
+  /// its current position.  Nothing is stored in the DataMap, so nothing has to keep it up to
+  /// date (placements, swaps, and population swaps are all reflected automatically).  FUN_T is
+  /// a default-constructible function object taking a const Organism.
+  template <typename T, typename FUN_T>
+  struct ComputedTrait : public BaseTrait {
+    ComputedTrait(emp::Ptr<TraitHolder> held_ptr, const emp::String & name, const emp::String & desc="")
+      : BaseTrait(TraitInfo::Access::OPTIONAL, false, held_ptr, name, desc) { }
+
+    T Get(const mabe::Organism & org) const { return FUN_T{}(org); }
+    inline T operator()(const mabe::Organism & org) const { return Get(org); }
+
+    void AddTrait() override { }                           // Computed traits are never stored...
+    void SetupDataMap(const emp::DataMap &) override { }   // ...so they have no DataMap ID.
+
+    bool ReadOK() const override { return true; }
+    bool WriteOK() const override { return false; }
+    bool OtherReadOK() const override { return true; }
+    bool OtherWriteOK() const override { return false; }
+  };
+
+  struct CalcOrgPosition {
+    template <typename ORG_T> auto operator()(const ORG_T & org) const { return org.GetPosition(); }
+  };
+
+  /// An organism's current position (population and index), computed from the organism.
+  using PositionTrait = ComputedTrait<OrgPosition, CalcOrgPosition>;
+
   template <typename T> ConfigPlaceholder<T> AsConfig(T & in_var) { return in_var; }
 
   // Traits that are read- and write-protected.
@@ -15,6 +15,8 @@
 #ifndef MABE_ORG_TYPE_HPP
 #define MABE_ORG_TYPE_HPP
 
+#include <array>
+
 #include "ModuleBase.hpp"
 
 namespace mabe {
@@ -24,15 +26,72 @@ namespace mabe {
   // A class type managed by a ManagerModule.
   class OrgType {
   protected:
-    ModuleBase & manager;    ///< Manager for the specific organism type
+    /// Manager for the specific organism type (a pointer so that organisms can be reassigned)
+    emp::Ptr<ModuleBase> manager;
+
+    /// Evaluators whose results (stored in traits) are still valid for the current genome.
+    /// Copies keep these records, since they have the same genome and traits.
+    struct EvalRecord {
+      const void * evaluator = nullptr;
+      size_t epoch = 0;
+    };
+    static constexpr size_t MAX_EVAL_RECORDS = 2;
+    std::array<EvalRecord, MAX_EVAL_RECORDS> eval_records{};
+
+    /// Seconds this object's last timed evaluation took (0 if never timed); copies keep it, so
+    /// offspring start with their parent's cost as an estimate of their own.
+    float eval_cost = 0.0f;
+
+    /// Do output traits already reflect the current genome?  Only set by organism types whose
+    /// GenerateOutput() depends on nothing else (see MarkOutputReady()).
+    bool output_ready = false;
 
   public:
-    OrgType(ModuleBase & _man) : manager(_man) { ; }
+    OrgType(ModuleBase & _man) : manager(&_man) { ; }
     virtual ~OrgType() { ; }
 
     /// Get the manager for this type of organism.
-    Module & GetManager() { return (Module&) manager; }
-    const Module & GetManager() const { return (Module&) manager; }
+    Module & GetManager() { return (Module&) *manager; }
+    const Module & GetManager() const { return (Module&) *manager; }
+
+    /// Get the name of the module managing this type of organism.
+    const emp::String & GetManagerName() const { return manager->GetName(); }
+
+    /// Hand this object back to its manager to be reused for a future clone (or deleted).
+    /// The object must not be used again after this call.
+    void Recycle() { manager->RecycleObject(this); }
+
+    /// Indicate that the genome has changed, so no previous evaluation is still valid.
+    /// Organism types that change their genome outside of Mutate() or Initialize() (for
+    /// example, during execution) should call this themselves.
+    void MarkGenomeChanged() { eval_records.fill(EvalRecord{}); output_ready = false; }
+
+    /// Output traits are up to date, so GenerateOutput() can skip regenerating them until the
+    /// genome changes.  This lets every evaluator call GenerateOutput() without repeating work.
+    void MarkOutputReady() { output_ready = true; }
+    void MarkOutputStale() { output_ready = false; }
+    bool IsOutputReady() const { return output_ready; }
+
+    /// Does this object have a valid evaluation from the given evaluator and epoch?
+    bool HasEvalRecord(const void * evaluator, size_t epoch) const {
+      for (const EvalRecord & record : eval_records) {
+        if (record.evaluator == evaluator) return record.epoch == epoch;
+      }
+      return false;
+    }
+
+    /// Record that an evaluator has stored valid results for the current genome.
+    void SetEvalRecord(const void * evaluator, size_t epoch) {
+      size_t slot = 0;
+      for (size_t i = 0; i < MAX_EVAL_RECORDS; ++i) {
+        if (eval_records[i].evaluator == evaluator) { slot = i; break; }
+        if (eval_records[i].evaluator == nullptr) slot = i;
+      }
+      eval_records[slot] = EvalRecord{evaluator, epoch};
+    }
+
+    double GetEvalCost() const { return eval_cost; }
+    void SetEvalCost(double seconds) { eval_cost = (float) seconds; }
 
     /// The class below is a placeholder for storing any manager-specific data that the organisms
     /// should have access to.  A derived organism class should derive it's managed data from this
@@ -49,17 +108,38 @@ namespace mabe {
     /// @note We MUST be able to make a copy of organisms for MABE to function.  If this function
     /// is not overridden, the organism manager (which knows the derived type) will try to make a
     /// clone using the copy constructor.
-    [[nodiscard]] virtual emp::Ptr<OrgType> Clone() const { return manager.CloneObject(*this); }
+    [[nodiscard]] virtual emp::Ptr<OrgType> Clone() const { return manager->CloneObject(*this); }
 
     /// Modify this organism based on configured mutation parameters.
     /// @note For evolution to function, we need to be able to mutate offspring.
     virtual size_t Mutate(emp::Random & random) = 0;
 
+    /// Can Mutate() run on several organisms of this type at once?  It must use only the
+    /// random generator it is given and this object's own state (no shared scratch space).
+    /// Clone() followed by Mutate() must also be equivalent to MakeOffspring(); if the type
+    /// supports RecombineInPlace(), that must be thread safe as well.
+    virtual bool IsMutateThreadSafe() const { return false; }
+
+    /// Can Initialize() run on several organisms of this type at once?  As with Mutate(), it
+    /// must use only the random generator it is given and this object's own state.
+    virtual bool IsInitializeThreadSafe() const { return false; }
+
+    /// Replace part of this organism's genome (normally a fresh clone of the first parent) with
+    /// the matching part of parent2's, using the crossover configured for this type (see
+    /// tools/Crossover.hpp).  Returns false if this type cannot recombine with parent2.
+    virtual bool RecombineInPlace(const OrgType & /* parent2 */, emp::Random & /* random */) {
+      return false;
+    }
+
     /// Merge this organism's genome with that of another organism to produce an offspring.
+    /// By default, clone this organism and use RecombineInPlace().
     /// @note Required for basic sexual recombination to work.
     [[nodiscard]] virtual emp::Ptr<OrgType>
-    Recombine(emp::Ptr<OrgType> /* parent2 */, emp::Random & /* random */) const {
-      emp_assert(false, "Recombine() must be overridden for it to work.");
+    Recombine(emp::Ptr<OrgType> parent2, emp::Random & random) const {
+      emp::Ptr<OrgType> offspring = Clone();
+      if (offspring->RecombineInPlace(*parent2, random)) return offspring;
+      offspring.Delete();
+      emp_assert(false, "Recombine() or RecombineInPlace() must be overridden for it to work.");
       return nullptr;
     }
 
@@ -76,7 +156,7 @@ namespace mabe {
     /// Produce an asexual offspring WITH MUTATIONS.  By default, use Clone() and then Mutate().
     [[nodiscard]] virtual emp::Ptr<OrgType> MakeOffspring(emp::Random & random) const {
       emp::Ptr<OrgType> offspring = Clone();
-      offspring->Mutate(random);
+      if (offspring->Mutate(random)) offspring->MarkGenomeChanged();
       return offspring;
     }
 
@@ -86,6 +166,7 @@ namespace mabe {
     MakeOffspring(emp::Ptr<OrgType> parent2, emp::Random & random) const {
       emp::Ptr<OrgType> offspring = Recombine(parent2, random);
       offspring->Mutate(random);
+      offspring->MarkGenomeChanged();
       return offspring;
     }
 
@@ -94,7 +175,10 @@ namespace mabe {
     [[nodiscard]] virtual emp::vector<emp::Ptr<OrgType>> 
     MakeOffspring(emp::vector<emp::Ptr<OrgType>> other_parents, emp::Random & random) const {
       emp::vector<emp::Ptr<OrgType>> all_offspring = Recombine(other_parents, random);
-      for (auto offspring : all_offspring) offspring->Mutate(random);
+      for (auto offspring : all_offspring) {
+        offspring->Mutate(random);
+        offspring->MarkGenomeChanged();
+      }
       return all_offspring;
     }
 
@@ -122,6 +206,28 @@ namespace mabe {
 
     /// Run the organisms a single time step; only implemented for continuous execution organisms.
     virtual bool ProcessStep() { return false; }
+
+    /// Would the next ProcessStep() touch only this organism (no births, population changes,
+    /// or shared random numbers)?  Such steps may run in parallel with other organisms'.
+    virtual bool IsNextStepLocal() const { return false; }
+
+    /// Run up to max_steps steps for as long as each one is local; return the number of steps
+    /// used, adding those where ProcessStep() did something to num_processed.  Override to run
+    /// a batch of steps without a virtual call per step.
+    virtual size_t ProcessLocalSteps(size_t max_steps, size_t & num_processed) {
+      size_t num_used = 0;
+      for (; num_used < max_steps && IsNextStepLocal(); ++num_used) {
+        if (ProcessStep()) ++num_processed;
+      }
+      return num_used;
+    }
+
+    /// Write any state not held in traits (typically the genome) to a checkpoint.
+    /// @note Required for CHECKPOINT to save this organism type; returns false if unsupported.
+    virtual bool SaveState(CheckpointWriter & /*out*/) const { return false; }
+
+    /// Restore the state written by SaveState(); return false if unsupported.
+    virtual bool LoadState(CheckpointReader & /*in*/) { return false; }
  
     // virtual bool AddEvent(const emp::String & event_name, int event_id) { return false; }
     // virtual void TriggerEvent(int) { ; }
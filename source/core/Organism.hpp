@@ -27,20 +27,46 @@
 #ifndef MABE_ORGANISM_H
 #define MABE_ORGANISM_H
 
+#include <memory>
+#include <type_traits>
+#include <utility>
+
 #include "emp/base/assert.hpp"
 #include "emp/base/vector.hpp"
 #include "emp/data/AnnotatedType.hpp"
 #include "emp/tools/String.hpp"
 
 #include "OrgType.hpp"
+#include "../tools/GenomeHash.hpp"
 
 namespace mabe {
 
+  class OrgPosition;
   class Population;
 
+  /// Holds storage that organisms have moved out of during Relocate(), so that it is freed only
+  /// after every organism has been given new storage (otherwise each new allocation would just
+  /// reuse the hole left by the previous organism).
+  class RelocationBin {
+  private:
+    emp::vector<std::shared_ptr<void>> held;
+
+  public:
+    template <typename T>
+    void Keep(T && obj) { held.push_back(std::make_shared<std::decay_t<T>>(std::forward<T>(obj))); }
+    size_t GetSize() const { return held.size(); }
+  };
+
   class Organism : public OrgType, public emp::AnnotatedType {
   private:
     emp::Ptr<Population> pop_ptr = nullptr;
+    size_t pop_pos = 0;                  ///< Index in pop_ptr (valid only if pop_ptr is set).
+    bool is_empty = false;               ///< Is this a placeholder for an empty cell?
+
+  protected:
+    /// Only placeholder types (EmptyOrganism) should mark themselves as empty.
+    Organism(ModuleBase & _man, bool in_empty) : OrgType(_man), is_empty(in_empty) { ; }
+
   public:
     Organism(ModuleBase & _man) : OrgType(_man) { ; }
     virtual ~Organism() {
@@ -50,17 +76,24 @@ namespace mabe {
       );
     }
 
-    /// Test if this organism represents an empty cell.
-    virtual bool IsEmpty() const noexcept { return false; }
+    /// Test if this organism represents an empty cell (a flag, so no virtual call is needed).
+    bool IsEmpty() const noexcept { return is_empty; }
 
     emp::Ptr<Population> GetPopPtr() const { return pop_ptr; }
     Population & GetPopulation() { return *pop_ptr; }
-    void SetPopulation(Population & in) { pop_ptr = &in; }
+    size_t GetPopPos() const { return pop_pos; }
+    void SetPopulation(Population & in, size_t pos) { pop_ptr = &in; pop_pos = pos; }
     void ClearPopulation() { pop_ptr = nullptr; }
 
+    /// Current position of this organism; defined in Population.hpp.
+    OrgPosition GetPosition() const;
+
     /// Specialty version of Clone to return an Organism type.
+    /// (A clone always has the same type as the original, so no dynamic cast is needed.)
     [[nodiscard]] virtual emp::Ptr<Organism> CloneOrganism() const {
-      return OrgType::Clone().DynamicCast<Organism>();
+      emp::Ptr<OrgType> clone_ptr = Clone();
+      emp_assert(clone_ptr.DynamicCast<Organism>());
+      return clone_ptr.Cast<Organism>();
     }
 
     [[nodiscard]] emp::Ptr<Organism>
@@ -93,6 +126,44 @@ namespace mabe {
       return OrgType::MakeOffspring(other_parents, random);
     }
 
+    /// A 64-bit fingerprint of this organism's genome; organisms with equal genomes have
+    /// equal hashes.  Organism types should override this to hash their genome directly
+    /// (see tools/GenomeHash.hpp); the default hashes ToString().
+    virtual uint64_t GetGenomeHash() const {
+      const emp::String genome = ToString();
+      return GenomeHash::CalcBytes(std::string_view(genome.data(), genome.size()));
+    }
+
+    /// If 'other' has the same type and an identical genome, switch to sharing its genome
+    /// storage and return true.  Types that cannot share genomes return false.
+    virtual bool ShareGenome(const Organism & /*other*/) { return false; }
+
+    /// Organism types that store a trait's value in their own storage (such as a direct-encoded
+    /// genome) can return a pointer to it here, so readers need neither GenerateOutput() nor a
+    /// copy in the DataMap.  The pointer must be to the trait's type; nullptr means no view.
+    virtual const void * GetTraitView(size_t /*trait_id*/) const { return nullptr; }
+
+    /// Prototype only: the DataMap layout is locked, so trait IDs can be looked up.
+    virtual void SetupDataMap(const emp::DataMap & /*dm*/) { ; }
+
+    /// Approximate bytes held by this organism object and any genome or hardware storage it
+    /// owns outside of its DataMap; types with such storage should override this.  Storage
+    /// shared between organisms should be divided among those sharing it.
+    virtual size_t GetObjectBytes() const { return sizeof(Organism); }
+
+    /// Approximate bytes held by this organism, including its DataMap (for memory reports).
+    size_t GetNumBytes() const { return GetObjectBytes() + GetDataMap().GetSize(); }
+
+    /// Move this organism's storage into fresh allocations, leaving the old storage in 'bin'.
+    /// Called on each organism in position order (see Population::Compact()), so storage ends
+    /// up in population order.  Types that own a genome outside of their DataMap should
+    /// override this to also move that genome (unless it is shared), after calling this one.
+    virtual void Relocate(RelocationBin & bin) {
+      emp::DataMap & data_map = GetDataMap();
+      emp::DataMap fresh(data_map);
+      bin.Keep(std::move(data_map));
+      data_map = std::move(fresh);
+    }
 
 
 
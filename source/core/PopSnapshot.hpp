@@ -0,0 +1,297 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  PopSnapshot.hpp
+ *  @brief Fixed-layout, column-oriented snapshot files of all organisms in a population.
+ *
+ *  A snapshot stores each numeric trait as a contiguous array (one entry per living organism,
+ *  or several if the trait has multiple values), along with the position and organism type of
+ *  each organism and its genome (as written by OrgType::SaveState).  Analysis tools can map the
+ *  file into memory and use the arrays directly, with no parsing.
+ *
+ *  File layout:
+ *    bytes 0-7   : magic string "MABESNAP"
+ *    bytes 8-15  : uint64 size of the metadata section (M)
+ *    bytes 16-   : metadata, in CheckpointWriter encoding:
+ *                    uint32 version, string pop_name, uint64 pop_size, uint64 num_orgs,
+ *                    vector<string> org type names,
+ *                    uint64 column count, then for each column:
+ *                      string name, string type code, uint64 values per org, uint64 offset
+ *    data section: starts at 16+M rounded up to a multiple of 8; each column's offset is
+ *                  relative to this start and is also a multiple of 8.
+ *
+ *  Type codes are "f64", "f32", "i32", "i64", "u32", "u64", and "bool" (one byte).  Built-in
+ *  columns are "_position" (u64), "_type" (u32 index into type names), and "_genome_offsets"
+ *  (u64, num_orgs+1 entries) which index into the "_genome_blob" (u8) column.
+ *
+ *  DEVELOPER NOTES:
+ *  - Values are host-endian, like checkpoints.
+ *  - Non-numeric traits are not included; genomes are the way to recover full organisms.
+ */
+
+#ifndef MABE_POP_SNAPSHOT_H
+#define MABE_POP_SNAPSHOT_H
+
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/tools/String.hpp"
+
+#include "../tools/Checkpoint.hpp"
+
+#include "Population.hpp"
+#include "TraitInfo.hpp"
+
+namespace mabe {
+
+  namespace internal {
+    static constexpr const char * SNAPSHOT_MAGIC = "MABESNAP";
+    static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+    template <typename T> constexpr const char * SnapshotTypeCode() {
+      if constexpr (std::is_same_v<T, double>) return "f64";
+      else if constexpr (std::is_same_v<T, float>) return "f32";
+      else if constexpr (std::is_same_v<T, int>) return "i32";
+      else if constexpr (std::is_same_v<T, int64_t>) return "i64";
+      else if constexpr (std::is_same_v<T, uint32_t>) return "u32";
+      else if constexpr (std::is_same_v<T, uint64_t>) return "u64";
+      else if constexpr (std::is_same_v<T, bool>) return "bool";
+      else if constexpr (std::is_same_v<T, uint8_t>) return "u8";
+      else return "";
+    }
+
+    /// Call fun.template operator()<T>() with the snapshot type of a trait; false if none.
+    template <typename FUN_T>
+    bool ForSnapshotType(const TraitInfo & trait, FUN_T && fun) {
+      if (trait.GetType() == emp::GetTypeID<double>()) fun.template operator()<double>();
+      else if (trait.GetType() == emp::GetTypeID<float>()) fun.template operator()<float>();
+      else if (trait.GetType() == emp::GetTypeID<int>()) fun.template operator()<int>();
+      else if (trait.GetType() == emp::GetTypeID<int64_t>()) fun.template operator()<int64_t>();
+      else if (trait.GetType() == emp::GetTypeID<uint32_t>()) fun.template operator()<uint32_t>();
+      else if (trait.GetType() == emp::GetTypeID<uint64_t>()) fun.template operator()<uint64_t>();
+      else if (trait.GetType() == emp::GetTypeID<bool>()) fun.template operator()<bool>();
+      else return false;
+      return true;
+    }
+
+    static constexpr size_t SnapshotAlign(size_t pos) { return (pos + 7) & ~((size_t) 7); }
+  }
+
+  /// Write a snapshot of all living organisms in 'pop', including each of the given traits
+  /// that has a numeric type.  Returns false if the file could not be written.
+  static bool WritePopSnapshot(const Population & pop,
+                               const emp::vector<emp::Ptr<TraitInfo>> & traits,
+                               const emp::String & filename)
+  {
+    using namespace internal;
+    struct Column {
+      emp::String name;
+      emp::String type;
+      uint64_t count;
+      std::string bytes;
+    };
+
+    // Collect organism positions, types, and genomes.
+    emp::vector<size_t> org_pos;
+    for (size_t pos = 0; pos < pop.GetSize(); ++pos) if (!pop.IsEmpty(pos)) org_pos.push_back(pos);
+    const size_t num_orgs = org_pos.size();
+
+    emp::vector<uint64_t> positions(num_orgs);
+    emp::vector<uint32_t> type_ids(num_orgs);
+    emp::vector<uint64_t> genome_offsets(num_orgs+1, 0);
+    emp::vector<emp::String> type_names;
+    std::unordered_map<emp::String, uint32_t> type_map;
+    std::ostringstream genome_os(std::ios::binary);
+    CheckpointWriter genome_out(genome_os);
+    for (size_t i = 0; i < num_orgs; ++i) {
+      const Organism & org = pop[org_pos[i]];
+      positions[i] = org_pos[i];
+      auto [it, added] = type_map.try_emplace(org.GetManagerName(), (uint32_t) type_names.size());
+      if (added) type_names.push_back(org.GetManagerName());
+      type_ids[i] = it->second;
+      org.SaveState(genome_out);  // Organism types without SaveState() get an empty genome.
+      genome_offsets[i+1] = (uint64_t) genome_os.tellp();
+    }
+
+    auto to_bytes = [](const auto & vec) {
+      return std::string(reinterpret_cast<const char *>(vec.data()), vec.size() * sizeof(vec[0]));
+    };
+    emp::vector<Column> columns;
+    columns.push_back(Column{"_position", SnapshotTypeCode<uint64_t>(), 1, to_bytes(positions)});
+    columns.push_back(Column{"_type", SnapshotTypeCode<uint32_t>(), 1, to_bytes(type_ids)});
+    columns.push_back(Column{"_genome_offsets", SnapshotTypeCode<uint64_t>(), 1, to_bytes(genome_offsets)});
+    columns.push_back(Column{"_genome_blob", SnapshotTypeCode<uint8_t>(), 0, genome_os.str()});
+
+    // Each numeric trait becomes one column, copied organism by organism.
+    for (emp::Ptr<TraitInfo> trait_ptr : traits) {
+      ForSnapshotType(*trait_ptr, [&]<typename T>(){
+        const size_t count = trait_ptr->GetValueCount();
+        std::string bytes(num_orgs * count * sizeof(T), '\0');
+        for (size_t i = 0; i < num_orgs; ++i) {
+          const T * vals = &pop[org_pos[i]].GetDataMap().template Get<T>(trait_ptr->GetName());
+          std::memcpy(bytes.data() + i * count * sizeof(T), vals, count * sizeof(T));
+        }
+        columns.push_back(Column{trait_ptr->GetName(), SnapshotTypeCode<T>(), count, std::move(bytes)});
+      });
+    }
+
+    // Build the metadata now that all column sizes (and so offsets) are known.
+    std::ostringstream meta_os(std::ios::binary);
+    CheckpointWriter meta(meta_os);
+    meta.Write(SNAPSHOT_VERSION);
+    meta.Write(pop.GetName());
+    meta.Write<uint64_t>(pop.GetSize());
+    meta.Write<uint64_t>(num_orgs);
+    meta.Write(type_names);
+    meta.Write<uint64_t>(columns.size());
+    size_t offset = 0;
+    for (const Column & column : columns) {
+      meta.Write(column.name);
+      meta.Write(column.type);
+      meta.Write<uint64_t>(column.count);
+      meta.Write<uint64_t>(offset);
+      offset = SnapshotAlign(offset + column.bytes.size());
+    }
+    const std::string meta_str = meta_os.str();
+
+    std::ofstream file(filename.str(), std::ios::binary);
+    if (!file) return false;
+    const uint64_t meta_size = meta_str.size();
+    file.write(SNAPSHOT_MAGIC, 8);
+    file.write(reinterpret_cast<const char *>(&meta_size), sizeof(meta_size));
+    file.write(meta_str.data(), (std::streamsize) meta_size);
+    const char padding[8] = {0};
+    file.write(padding, (std::streamsize) (SnapshotAlign(16 + meta_size) - 16 - meta_size));
+    for (const Column & column : columns) {
+      file.write(column.bytes.data(), (std::streamsize) column.bytes.size());
+      file.write(padding, (std::streamsize) (SnapshotAlign(column.bytes.size()) - column.bytes.size()));
+    }
+    return (bool) file;
+  }
+
+  /// Read access to a population snapshot written by WritePopSnapshot().
+  class PopSnapshot {
+  public:
+    struct Column {
+      emp::String name;
+      emp::String type;       ///< Type code (e.g., "f64")
+      uint64_t count = 0;     ///< Values per organism (0 for the genome blob).
+      uint64_t offset = 0;    ///< Bytes from the start of the data section.
+    };
+
+  private:
+    std::string file_data;    ///< Full contents of the snapshot file.
+    size_t data_start = 0;    ///< Position of the data section in file_data.
+    emp::String pop_name;
+    uint64_t pop_size = 0;
+    uint64_t num_orgs = 0;
+    emp::vector<emp::String> type_names;
+    emp::vector<Column> columns;
+
+    const char * ColumnData(const Column & column) const {
+      return file_data.data() + data_start + column.offset;
+    }
+
+  public:
+    /// Load a snapshot file; returns false if it is missing or not a valid snapshot.
+    bool Load(const emp::String & filename) {
+      using namespace internal;
+      std::ifstream file(filename.str(), std::ios::binary);
+      if (!file) return false;
+      std::ostringstream contents;
+      contents << file.rdbuf();
+      file_data = contents.str();
+      if (file_data.size() < 16 || file_data.compare(0, 8, SNAPSHOT_MAGIC) != 0) return false;
+
+      uint64_t meta_size = 0;
+      std::memcpy(&meta_size, file_data.data() + 8, sizeof(meta_size));
+      if (16 + meta_size > file_data.size()) return false;
+      std::istringstream meta_is(file_data.substr(16, meta_size), std::ios::binary);
+      CheckpointReader meta(meta_is);
+      if (meta.Read<uint32_t>() != SNAPSHOT_VERSION) return false;
+      meta.Read(pop_name);
+      meta.Read(pop_size);
+      meta.Read(num_orgs);
+      meta.Read(type_names);
+      columns.resize(meta.Read<uint64_t>());
+      for (Column & column : columns) {
+        meta.Read(column.name);
+        meta.Read(column.type);
+        meta.Read(column.count);
+        meta.Read(column.offset);
+      }
+      data_start = SnapshotAlign(16 + meta_size);
+      return meta.IsOK() && data_start <= file_data.size();
+    }
+
+    const emp::String & GetPopName() const { return pop_name; }
+    size_t GetPopSize() const { return pop_size; }
+    size_t GetNumOrgs() const { return num_orgs; }
+    const emp::vector<emp::String> & GetTypeNames() const { return type_names; }
+    const emp::vector<Column> & GetColumns() const { return columns; }
+
+    emp::Ptr<const Column> GetColumn(const emp::String & name) const {
+      for (const Column & column : columns) if (column.name == name) return &column;
+      return nullptr;
+    }
+
+    /// Get all values of a column (count per organism, in organism order); the type must
+    /// match the stored type, otherwise the result is empty.
+    template <typename T>
+    std::span<const T> GetValues(const emp::String & name) const {
+      emp::Ptr<const Column> column = GetColumn(name);
+      if (!column || column->type != internal::SnapshotTypeCode<T>()) return {};
+      const size_t count = column->count ? column->count * num_orgs : 0;
+      if (data_start + column->offset + count * sizeof(T) > file_data.size()) return {};  // Truncated.
+      return { reinterpret_cast<const T *>(ColumnData(*column)), count };
+    }
+
+    std::span<const uint64_t> GetPositions() const { return GetValues<uint64_t>("_position"); }
+    std::span<const uint32_t> GetTypeIDs() const { return GetValues<uint32_t>("_type"); }
+    const emp::String & GetTypeName(size_t org_id) const { return type_names[GetTypeIDs()[org_id]]; }
+
+    /// Are the genome columns present and consistent (offsets in order, within the file)?
+    bool HasGenomes() const {
+      std::span<const uint64_t> offsets = GetValues<uint64_t>("_genome_offsets");
+      emp::Ptr<const Column> blob = GetColumn("_genome_blob");
+      if (!blob || offsets.size() != num_orgs + 1 || offsets[0] != 0) return false;
+      for (size_t i = 0; i < num_orgs; ++i) if (offsets[i+1] < offsets[i]) return false;
+      return data_start + blob->offset + offsets[num_orgs] <= file_data.size();
+    }
+
+    /// Genome (as written by OrgType::SaveState) of an organism; check HasGenomes() first.
+    std::string_view GetGenome(size_t org_id) const {
+      std::span<const uint64_t> offsets = GetValues<uint64_t>("_genome_offsets");
+      emp::Ptr<const Column> blob = GetColumn("_genome_blob");
+      return { ColumnData(*blob) + offsets[org_id], offsets[org_id+1] - offsets[org_id] };
+    }
+
+    /// Copy the stored values of a trait into an organism's DataMap; false if the snapshot
+    /// does not have a matching column for this trait.
+    bool LoadTrait(size_t org_id, const TraitInfo & trait, emp::DataMap & dm) const {
+      bool found = false;
+      internal::ForSnapshotType(trait, [&]<typename T>(){
+        emp::Ptr<const Column> column = GetColumn(trait.GetName());
+        if (!column || column->type != internal::SnapshotTypeCode<T>()
+            || column->count != trait.GetValueCount()) return;
+        T * vals = &dm.template Get<T>(trait.GetName());
+        const size_t num_bytes = column->count * sizeof(T);
+        std::memcpy(vals, ColumnData(*column) + org_id * num_bytes, num_bytes);
+        found = true;
+      });
+      return found;
+    }
+  };
+
+}
+
+#endif
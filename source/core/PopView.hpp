@@ -0,0 +1,134 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  PopView.hpp
+ *  @brief An immutable, in-memory copy of a population's numeric traits (and optionally its
+ *         genomes) at one moment, for analysis on another thread.
+ *
+ *  A view is captured on the main thread between updates, with the same columns as a
+ *  snapshot file (see PopSnapshot.hpp) but with every value stored as a double.  After that
+ *  it never changes and never refers back to the population, so it can be shared (through
+ *  a std::shared_ptr) with background tasks while evolution continues.
+ */
+
+#ifndef MABE_POP_VIEW_H
+#define MABE_POP_VIEW_H
+
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "emp/base/vector.hpp"
+#include "emp/tools/String.hpp"
+
+#include "PopSnapshot.hpp"
+
+namespace mabe {
+
+  class PopView {
+  private:
+    struct Column {
+      size_t count;                        ///< Values per organism.
+      emp::vector<double> values;          ///< All values, in organism order.
+    };
+
+    size_t update = 0;
+    emp::String pop_name;
+    size_t pop_size = 0;
+    emp::vector<size_t> positions;         ///< Position of each organism in the population.
+    emp::vector<emp::String> trait_names;  ///< Traits captured, in order.
+    std::unordered_map<emp::String, Column> columns;
+    std::string genome_blob;               ///< Genomes (as written by SaveState), if captured.
+    emp::vector<size_t> genome_offsets;
+
+  public:
+    using view_ptr_t = std::shared_ptr<const PopView>;
+
+    /// Copy the numeric traits among 'traits' for every living organism in 'pop' (and their
+    /// genomes, if requested).
+    static view_ptr_t Capture(const Population & pop,
+                              const emp::vector<emp::Ptr<TraitInfo>> & traits,
+                              size_t update, bool with_genomes=false)
+    {
+      auto view = std::make_shared<PopView>();
+      view->update = update;
+      view->pop_name = pop.GetName();
+      view->pop_size = pop.GetSize();
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        if (!pop.IsEmpty(pos)) view->positions.push_back(pos);
+      }
+      const size_t num_orgs = view->positions.size();
+
+      for (emp::Ptr<TraitInfo> trait_ptr : traits) {
+        internal::ForSnapshotType(*trait_ptr, [&]<typename T>(){
+          const size_t count = trait_ptr->GetValueCount();
+          Column & column = view->columns[trait_ptr->GetName()];
+          column.count = count;
+          column.values.resize(num_orgs * count);
+          for (size_t i = 0; i < num_orgs; ++i) {
+            const emp::DataMap & dmap = pop[view->positions[i]].GetDataMap();
+            const T * vals = &dmap.template Get<T>(trait_ptr->GetName());
+            for (size_t j = 0; j < count; ++j) column.values[i * count + j] = (double) vals[j];
+          }
+          view->trait_names.push_back(trait_ptr->GetName());
+        });
+      }
+
+      if (with_genomes) {
+        std::ostringstream genome_os(std::ios::binary);
+        CheckpointWriter genome_out(genome_os);
+        view->genome_offsets.push_back(0);
+        for (size_t pos : view->positions) {
+          pop[pos].SaveState(genome_out);
+          view->genome_offsets.push_back((size_t) genome_os.tellp());
+        }
+        view->genome_blob = genome_os.str();
+      }
+      return view;
+    }
+
+    size_t GetUpdate() const { return update; }
+    const emp::String & GetPopName() const { return pop_name; }
+    size_t GetPopSize() const { return pop_size; }
+    size_t GetNumOrgs() const { return positions.size(); }
+    const emp::vector<size_t> & GetPositions() const { return positions; }
+    const emp::vector<emp::String> & GetTraitNames() const { return trait_names; }
+
+    bool HasTrait(const emp::String & name) const { return columns.contains(name); }
+    bool HasGenomes() const { return genome_offsets.size(); }
+
+    /// Values of a trait per organism (0 if the trait was not captured).
+    size_t GetValueCount(const emp::String & name) const {
+      auto it = columns.find(name);
+      return (it == columns.end()) ? 0 : it->second.count;
+    }
+
+    /// All values of a trait, GetValueCount() per organism in organism order.
+    std::span<const double> GetValues(const emp::String & name) const {
+      auto it = columns.find(name);
+      if (it == columns.end()) return {};
+      return it->second.values;
+    }
+
+    double GetValue(size_t org_id, const emp::String & name, size_t index=0) const {
+      emp_assert(org_id < GetNumOrgs() && index < GetValueCount(name), org_id, name, index);
+      const Column & column = columns.find(name)->second;
+      return column.values[org_id * column.count + index];
+    }
+
+    /// Genome (as written by OrgType::SaveState) of an organism; only if captured.
+    std::string_view GetGenome(size_t org_id) const {
+      emp_assert(HasGenomes() && org_id < GetNumOrgs(), org_id);
+      return std::string_view(genome_blob).substr(genome_offsets[org_id],
+                                                  genome_offsets[org_id+1] - genome_offsets[org_id]);
+    }
+  };
+
+}
+
+#endif
@@ -11,6 +11,16 @@
  * 
  *  Populations in MABE cannot be copied or moved as signals must be triggered; all such
  *  actions must be performed manually..
+ *
+ *  Numeric traits can optionally be tracked as contiguous columns (see TraitColumns.hpp) for
+ *  fast population-wide scans; call RefreshTraitColumns() after traits are updated.
+ *
+ *  GatherTrait() and ScatterTrait() copy one trait between every organism's DataMap and a flat
+ *  array in a single pass (prefetching upcoming organisms, and optionally split across a
+ *  ThreadPool), for modules that process a whole population's values at once.
+ *
+ *  Iterating a Population visits every cell; iterate pop.Living() to visit only living
+ *  organisms, skipping empty cells with a bitset of occupied positions.
  * 
  *  @todo Add a reverse iterator.
  *  @todo Fix operator-- which can go off of the beginning of the world.
@@ -19,14 +29,22 @@
 #ifndef MABE_POPULATION_H
 #define MABE_POPULATION_H
 
+#include <algorithm>
+#include <span>
+
 #include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
 #include "emp/tools/String.hpp"
 
 #include "../Emplode/EmplodeType.hpp"
 
+#include "../tools/ThreadPool.hpp"
+
 #include "Organism.hpp"
 #include "OrgIterator.hpp"
+#include "TraitColumns.hpp"
 
 namespace mabe {
 
@@ -35,12 +53,13 @@ namespace mabe {
   class PopIterator : public OrgIterator_Interface<PopIterator, Organism, Population> {
   protected:
     using base_t = OrgIterator_Interface<PopIterator, Organism, Population>;
+    friend base_t;
 
-    void IncPosition() override;
-    void DecPosition() override;
-    void ShiftPosition(int shift=1) override;
-    void ToBegin() override;
-    void ToEnd() override;
+    void IncPosition();
+    void DecPosition();
+    void ShiftPosition(int shift=1);
+    void ToBegin();
+    void ToEnd();
     void MakeValid();
 
   public:
@@ -61,12 +80,13 @@ namespace mabe {
   : public OrgIterator_Interface<ConstPopIterator, const Organism, const Population> {
   protected:
     using base_t = OrgIterator_Interface<ConstPopIterator, const Organism, const Population>;
+    friend base_t;
 
-    void IncPosition() override;
-    void DecPosition() override;
-    void ShiftPosition(int shift=1) override;
-    void ToBegin() override;
-    void ToEnd() override;
+    void IncPosition();
+    void DecPosition();
+    void ShiftPosition(int shift=1);
+    void ToBegin();
+    void ToEnd();
     void MakeValid();
 
   public:
@@ -83,6 +103,37 @@ namespace mabe {
     ConstPopIterator & operator=(const ConstPopIterator & in) = default;
   };
 
+  /// Iterator over only the living organisms in a population; it skips runs of empty cells
+  /// using the population's bitset of occupied positions.
+  template <typename ORG_T, typename POP_T>
+  class LivingPopIteratorT
+  : public OrgIterator_Interface<LivingPopIteratorT<ORG_T, POP_T>, ORG_T, POP_T> {
+  protected:
+    using base_t = OrgIterator_Interface<LivingPopIteratorT<ORG_T, POP_T>, ORG_T, POP_T>;
+    friend base_t;
+    using base_t::pop_ptr;
+    using base_t::pos;
+
+    void IncPosition();
+    void DecPosition();
+    void ShiftPosition(int shift=1);
+    void ToBegin();
+    void ToEnd();
+
+  public:
+    /// Constructor; if 'pos' is not a living organism, advance to the next one (or the end).
+    LivingPopIteratorT(emp::Ptr<POP_T> _pop=nullptr, size_t _pos=0);
+
+    /// Supply Population by reference instead of pointer.
+    LivingPopIteratorT(POP_T & pop, size_t _pos=0) : LivingPopIteratorT(&pop, _pos) {}
+
+    LivingPopIteratorT(const LivingPopIteratorT &) = default;
+    LivingPopIteratorT & operator=(const LivingPopIteratorT & in) = default;
+  };
+
+  using LivingPopIterator = LivingPopIteratorT<Organism, Population>;
+  using ConstLivingPopIterator = LivingPopIteratorT<const Organism, const Population>;
+
   /// A Population maintains a collection of organisms.  It is derived from EmplodeType so that it
   /// can be easily used in the MABE scripting language.
   class Population : public OrgContainer {
@@ -93,6 +144,12 @@ namespace mabe {
     emp::vector<emp::Ptr<Organism>> orgs;  ///< Info on all organisms in this population.
     size_t num_orgs = 0;                   ///< How many LIVING organisms are in this population?
 
+    /// Dense index of living positions (in arbitrary order) and, for each position, where it
+    /// is in that index (or npos if empty); kept in sync by SetOrg() and ExtractOrg().
+    emp::vector<size_t> living_pos;
+    emp::vector<size_t> living_id;
+    emp::BitVector occupied;               ///< Which positions hold living organisms?
+
     /// Pointer to layout used in data maps of orgs.
     emp::Ptr<emp::DataLayout> data_layout_ptr = nullptr; 
 
@@ -103,6 +160,9 @@ namespace mabe {
     std::function<OrgPosition(Organism &)> place_inject_fun;
     std::function<OrgPosition(OrgPosition)> find_neighbor_fun;
 
+    /// Optional contiguous, per-position copies of selected numeric traits.
+    TraitColumns trait_columns;
+
   public:
     using iterator_t = PopIterator;
     using const_iterator_t = ConstPopIterator;
@@ -115,6 +175,8 @@ namespace mabe {
       : name(in_name), pop_id(in_id), empty_org(in_empty)
     {
       orgs.resize(pop_size, empty_org);
+      living_id.resize(pop_size, npos);
+      occupied.Resize(pop_size);
     }
 
     // All organism moving/copying must be tracked and done through MABE object.
@@ -133,6 +195,32 @@ namespace mabe {
     size_t GetNumOrgs() const noexcept { return num_orgs; }
     bool IsEmpty() const noexcept override { return num_orgs == 0; }
 
+    /// Placeholder organism used in every empty position.
+    Organism & GetEmptyOrg() const { emp_assert(!empty_org.IsNull()); return *empty_org; }
+
+    /// Approximate bytes held by this population: its position tables, trait columns, and all
+    /// living organisms (with their DataMaps and genomes).  Walks the living organisms once.
+    size_t GetNumBytes() const {
+      size_t num_bytes = orgs.capacity() * sizeof(emp::Ptr<Organism>)
+                       + (living_pos.capacity() + living_id.capacity()) * sizeof(size_t)
+                       + occupied.GetNumBytes()
+                       + trait_columns.GetNumColumns() * trait_columns.GetNumRows() * sizeof(double);
+      for (size_t pos : living_pos) num_bytes += orgs[pos]->GetNumBytes();
+      return num_bytes;
+    }
+
+    /// Move each living organism's storage (its DataMap, and any genome it owns alone) into
+    /// fresh allocations in position order, so that scans walk memory in order rather than in
+    /// birth order.  The living index is also sorted by position.  Organisms keep their
+    /// addresses and positions, so no signals are needed.  Old storage is freed at the end, so
+    /// memory use briefly grows by the amount moved.
+    void Compact() {
+      std::sort(living_pos.begin(), living_pos.end());
+      for (size_t id = 0; id < living_pos.size(); ++id) living_id[living_pos[id]] = id;
+      RelocationBin old_storage;
+      for (size_t pos : living_pos) orgs[pos]->Relocate(old_storage);
+    }
+
     bool HasDataLayout() const { return data_layout_ptr; }
     emp::DataLayout & GetDataLayout() noexcept { 
       emp_assert(HasDataLayout());
@@ -144,16 +232,17 @@ namespace mabe {
     }
 
     bool IsValid(size_t pos) const { return pos < orgs.size(); }
-    bool IsEmpty(size_t pos) const { return IsValid(pos) && orgs[pos]->IsEmpty(); }
-    bool IsOccupied(size_t pos) const { return IsValid(pos) && !orgs[pos]->IsEmpty(); }
+    bool IsEmpty(size_t pos) const { return IsValid(pos) && !occupied.Has(pos); }
+    bool IsOccupied(size_t pos) const { return IsValid(pos) && occupied.Has(pos); }
 
     size_t FindEmptyPos(size_t start_pos=0) const {
-      for (size_t pos=start_pos; pos < orgs.size(); ++pos) if (orgs[pos]->IsEmpty()) return pos;
+      for (size_t pos=start_pos; pos < orgs.size(); ++pos) if (!occupied.Has(pos)) return pos;
       return npos;
     }
     size_t FindOccupiedPos(size_t start_pos=0) const {
-      for (size_t pos=start_pos; pos < orgs.size(); ++pos) if (!orgs[pos]->IsEmpty()) return pos;
-      return npos;
+      if (start_pos >= orgs.size()) return npos;
+      const int pos = occupied.FindOne(start_pos);
+      return (pos == -1) ? npos : (size_t) pos;
     }
 
     void SetName(const emp::String & in_name) { name = in_name; }
@@ -173,6 +262,13 @@ namespace mabe {
     iterator_t end() { return iterator_t(this, GetSize()); }
     const_iterator_t end() const { return const_iterator_t(this, GetSize()); }
 
+    /// Range over only the living organisms, e.g.: for (Organism & org : pop.Living()) { ... }
+    LivingPopIterator Living() { return LivingPopIterator(this, 0); }
+    ConstLivingPopIterator Living() const { return ConstLivingPopIterator(this, 0); }
+
+    /// Bitset of the positions that currently hold living organisms.
+    const emp::BitVector & GetOccupied() const { return occupied; }
+
     iterator_t IteratorAt(size_t pos) { return iterator_t(this, pos); }
     const_iterator_t ConstIteratorAt(size_t pos) const { return const_iterator_t(this, pos); }
 
@@ -180,6 +276,153 @@ namespace mabe {
     OrgPosition PlaceInject(Organism & org) { return place_inject_fun(org); }
     OrgPosition FindNeighbor(OrgPosition pos) { return find_neighbor_fun(pos); }
 
+    /// Positions of all living organisms, in arbitrary order (changes as orgs are removed).
+    std::span<const size_t> GetLivingPositions() const {
+      return std::span<const size_t>(living_pos.data(), living_pos.size());
+    }
+
+    /// Return a random position that holds a living organism (population must not be empty).
+    /// Dense populations use rejection sampling over all positions (one draw when full);
+    /// sparse populations draw directly from the index of living positions.
+    template <typename RANDOM_T=emp::Random>
+    size_t GetRandomLivingPos(RANDOM_T & random) const {
+      emp_assert(num_orgs > 0, "GetRandomLivingPos() requires a living organism.");
+      if (num_orgs * 2 >= orgs.size()) {
+        size_t pos = random.GetUInt(orgs.size());
+        while (!occupied.Has(pos)) pos = random.GetUInt(orgs.size());
+        return pos;
+      }
+      return living_pos[random.GetUInt(living_pos.size())];
+    }
+
+    // ------ Columnar trait access ------
+
+    /// Keep a contiguous column of a double-valued trait for this population; returns column ID.
+    size_t TrackTraitColumn(const emp::String & trait_name) {
+      if (!HasDataLayout()) {
+        emp::notify::Error("Population '", name, "' must have organisms before tracking trait '",
+                           trait_name, "' as a column.");
+        return 0;
+      }
+      if (!data_layout_ptr->HasName(trait_name)) {
+        emp::notify::Error("Population '", name, "' has no trait '", trait_name, "' to track.");
+        return 0;
+      }
+      const size_t trait_id = data_layout_ptr->GetID(trait_name);
+      if (!data_layout_ptr->IsType<double>(trait_id)) {
+        emp::notify::Error("Trait '", trait_name, "' must be a double to be tracked as a column.");
+        return 0;
+      }
+      trait_columns.Resize(orgs.size());
+      const size_t col_id = trait_columns.AddColumn(trait_name, trait_id);
+      RefreshTraitColumns();
+      return col_id;
+    }
+
+    /// Re-gather all tracked columns from organism DataMaps (e.g., after evaluation).
+    void RefreshTraitColumns() {
+      if (trait_columns.GetNumColumns() == 0) return;
+      for (size_t pos = 0; pos < orgs.size(); ++pos) {
+        if (!occupied.Has(pos)) trait_columns.ClearRow(pos);
+        else trait_columns.LoadRow(pos, orgs[pos]->GetDataMap());
+      }
+    }
+
+    const TraitColumns & GetTraitColumns() const { return trait_columns; }
+
+    /// Get the column for a tracked trait; values at empty positions are 0.0.
+    std::span<const double> GetTraitColumn(const emp::String & trait_name) const {
+      const int col_id = trait_columns.GetColumnID(trait_name);
+      emp_assert(col_id >= 0, "Trait must be tracked before its column can be used.", trait_name);
+      return trait_columns.GetColumn((size_t) col_id);
+    }
+
+    // ------ Bulk trait access ------
+
+    /// Copy trait 'trait_id' (of type T) from the organisms at 'positions' into 'out', one value
+    /// per position; empty positions give T{}.
+    template <typename T, typename POS_T>
+    void GatherTraitAt(size_t trait_id, std::span<const POS_T> positions, std::span<T> out,
+                       ThreadPool * pool=nullptr) const {
+      emp_assert(out.size() >= positions.size(), out.size(), positions.size());
+      emp_assert(!HasDataLayout() || data_layout_ptr->IsType<T>(trait_id), trait_id);
+      ForEachSlot<T>(trait_id, positions.size(), [positions](size_t id){ return (size_t) positions[id]; },
+        [this, trait_id, out](size_t id, size_t pos) {
+          out[id] = occupied.Has(pos) ? orgs[pos]->GetDataMap().Get<T>(trait_id) : T{};
+        }, pool);
+    }
+
+    /// Copy trait 'trait_id' of every position into 'out' (empty positions give T{}) or, if
+    /// 'living_only', of each living organism in the order of GetLivingPositions().
+    template <typename T>
+    void GatherTrait(size_t trait_id, std::span<T> out, bool living_only=false,
+                     ThreadPool * pool=nullptr) const {
+      if (living_only) { GatherTraitAt<T, size_t>(trait_id, GetLivingPositions(), out, pool); return; }
+      emp_assert(out.size() >= orgs.size(), out.size(), orgs.size());
+      emp_assert(!HasDataLayout() || data_layout_ptr->IsType<T>(trait_id), trait_id);
+      ForEachSlot<T>(trait_id, orgs.size(), [](size_t pos){ return pos; },
+        [this, trait_id, out](size_t pos, size_t) {
+          out[pos] = occupied.Has(pos) ? orgs[pos]->GetDataMap().Get<T>(trait_id) : T{};
+        }, pool);
+    }
+
+    /// Copy values from 'in' into trait 'trait_id' of the organisms at 'positions' (the reverse
+    /// of GatherTraitAt()); values for empty positions are ignored.
+    template <typename T, typename POS_T>
+    void ScatterTraitAt(size_t trait_id, std::span<const POS_T> positions, std::span<const T> in,
+                        ThreadPool * pool=nullptr) {
+      emp_assert(in.size() >= positions.size(), in.size(), positions.size());
+      emp_assert(!HasDataLayout() || data_layout_ptr->IsType<T>(trait_id), trait_id);
+      ForEachSlot<T>(trait_id, positions.size(), [positions](size_t id){ return (size_t) positions[id]; },
+        [this, trait_id, in](size_t id, size_t pos) {
+          if (occupied.Has(pos)) orgs[pos]->GetDataMap().Get<T>(trait_id) = in[id];
+        }, pool);
+    }
+
+    /// Reverse of GatherTrait(): 'in' holds one value per position or, if 'living_only', one per
+    /// living organism in the order of GetLivingPositions().
+    template <typename T>
+    void ScatterTrait(size_t trait_id, std::span<const T> in, bool living_only=false,
+                      ThreadPool * pool=nullptr) {
+      if (living_only) { ScatterTraitAt<T, size_t>(trait_id, GetLivingPositions(), in, pool); return; }
+      emp_assert(in.size() >= orgs.size(), in.size(), orgs.size());
+      emp_assert(!HasDataLayout() || data_layout_ptr->IsType<T>(trait_id), trait_id);
+      ForEachSlot<T>(trait_id, orgs.size(), [](size_t pos){ return pos; },
+        [this, trait_id, in](size_t pos, size_t) {
+          if (occupied.Has(pos)) orgs[pos]->GetDataMap().Get<T>(trait_id) = in[pos];
+        }, pool);
+    }
+
+  private:
+    /// How far ahead (in slots) bulk trait access starts fetching an organism; the trait value
+    /// itself is fetched half as far ahead, once the organism's DataMap pointer has arrived.
+    static constexpr size_t PREFETCH_DISTANCE = 16;
+
+    template <typename T>
+    void PrefetchTrait([[maybe_unused]] size_t trait_id, [[maybe_unused]] size_t pos,
+                       [[maybe_unused]] bool value) const {
+#if defined(__GNUC__) || defined(__clang__)
+      if (!occupied.Has(pos)) return;
+      if (value) __builtin_prefetch(&orgs[pos]->GetDataMap().Get<T>(trait_id));
+      else __builtin_prefetch(orgs[pos].Raw());
+#endif
+    }
+
+    /// Call fun(id, pos_fun(id)) for each id in [0, count), prefetching ahead of each chunk's
+    /// current slot; chunks are split across 'pool' if one is given.
+    template <typename T, typename POS_FUN, typename FUN_T>
+    void ForEachSlot(size_t trait_id, size_t count, POS_FUN pos_fun, FUN_T fun, ThreadPool * pool) const {
+      auto run = [&](size_t start, size_t end) {
+        for (size_t id = start; id < end; ++id) {
+          if (id + PREFETCH_DISTANCE < end) PrefetchTrait<T>(trait_id, pos_fun(id + PREFETCH_DISTANCE), false);
+          if (id + PREFETCH_DISTANCE/2 < end) PrefetchTrait<T>(trait_id, pos_fun(id + PREFETCH_DISTANCE/2), true);
+          fun(id, pos_fun(id));
+        }
+      };
+      if (pool) pool->ForEachChunk(count, [&run](size_t, size_t start, size_t end){ run(start, end); });
+      else run(0, count);
+    }
+
   private:  // ---== To be used by friend class MABEBase only! ==---
 
     void SetOrg(size_t pos, emp::Ptr<Organism> org_ptr) {
@@ -187,13 +430,17 @@ namespace mabe {
       emp_assert(IsEmpty(pos));         // Must be valid and should not overwrite a living cell.
       emp_assert(!org_ptr->IsEmpty());  // Use ExtractOrg if you want to make a cell empty.
       orgs[pos] = org_ptr;
-      org_ptr->SetPopulation(*this);
+      org_ptr->SetPopulation(*this, pos);
       if (!data_layout_ptr) data_layout_ptr = &org_ptr->GetDataMap().GetLayout();
 
       if ( data_layout_ptr != &org_ptr->GetDataMap().GetLayout() ) {
         emp::notify::Error("Trying to insert an organism into population '", name,
                            "' with the incorrect trait set.");
       }
+      if (trait_columns.GetNumColumns()) trait_columns.LoadRow(pos, org_ptr->GetDataMap());
+      living_id[pos] = living_pos.size();
+      living_pos.push_back(pos);
+      occupied.Set(pos);
       num_orgs++;
     }
 
@@ -206,6 +453,15 @@ namespace mabe {
       if (!out_org->IsEmpty()) {
         num_orgs--;
         out_org->ClearPopulation(); // Alert organism that it is no longer part of this population.
+        if (trait_columns.GetNumColumns()) trait_columns.ClearRow(pos);
+
+        // Swap-remove this position from the living index.
+        const size_t id = living_id[pos];
+        living_pos[id] = living_pos.back();
+        living_id[living_pos[id]] = id;
+        living_pos.pop_back();
+        living_id[pos] = npos;
+        occupied.Set(pos, false);
       }
       return out_org;
     }
@@ -219,16 +475,38 @@ namespace mabe {
 
       // Resize the population, adding in empty cells to any new spaces.
       orgs.resize(new_size, empty_org);
+      living_id.resize(new_size, npos);
+      occupied.Resize(new_size);
+      if (trait_columns.GetNumColumns()) trait_columns.Resize(new_size);
 
       return *this;
     }
 
+    /// Exchange all organisms (and associated indices) with another population.
+    void SwapOrgs(Population & other) {
+      std::swap(orgs, other.orgs);
+      std::swap(num_orgs, other.num_orgs);
+      std::swap(living_pos, other.living_pos);
+      std::swap(living_id, other.living_id);
+      std::swap(occupied, other.occupied);
+      std::swap(data_layout_ptr, other.data_layout_ptr);
+      std::swap(trait_columns, other.trait_columns);
+      for (size_t pos : living_pos) orgs[pos]->SetPopulation(*this, pos);
+      for (size_t pos : other.living_pos) other.orgs[pos]->SetPopulation(other, pos);
+    }
+
+    /// Make sure there is room for the population to grow to 'capacity' without reallocating.
+    void Reserve(size_t capacity) { orgs.reserve(capacity); }
+
     /// Add an empty position to the end of the population (and return an iterator to it)
     iterator_t PushEmpty() {
       emp_assert(!empty_org.IsNull(),
                  "Population can only PushEmpty() if empty_org is provided.");
       size_t pos = orgs.size();
       orgs.resize(orgs.size()+1, empty_org);
+      living_id.push_back(npos);
+      occupied.Resize(orgs.size());
+      if (trait_columns.GetNumColumns()) trait_columns.Resize(orgs.size());
       return iterator_t(this, pos);
     }
 
@@ -246,13 +524,16 @@ namespace mabe {
                              "Return the number of organisms in the population.");
       info.AddMemberFunction("SIZE", [](Population & target) { return target.GetSize(); },
                              "Return the capacity of the population.");
+      info.AddMemberFunction("NUM_BYTES", [](Population & target) { return target.GetNumBytes(); },
+                             "Return the approximate memory used by the population and its organisms.");
       info.AddMemberFunction("PTR", [](Population & target) { return (size_t) &target; },
                              "DEBUG: Give memory location of target.");
     }
 
 
     // ------ DEBUG FUNCTIONS ------
-    bool OK() const {
+    /// Constant-time sanity checks on the population's sizes and counts.
+    bool OKCounts() const {
       // We may have a handful of populations, but assume error if we have more than a million.
       if (pop_id > 1000000) {
         std::cerr << "WARNING: Invalid Population ID (pop_id = " << pop_id << ")" << std::endl;
@@ -266,22 +547,53 @@ namespace mabe {
         return false;
       }
 
+      if (living_pos.size() != num_orgs || living_id.size() != orgs.size() ||
+          occupied.GetSize() != orgs.size()) {
+        std::cerr << "ERROR: Population " << pop_id << " has " << orgs.size() << " positions and "
+                  << num_orgs << " orgs, but its indices have " << living_pos.size() << " living, "
+                  << living_id.size() << " id, and " << occupied.GetSize() << " occupied entries."
+                  << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    /// Constant-time sanity checks on a single position.
+    bool OKPosition(size_t pos) const {
+      emp_assert(pos < orgs.size(), pos, orgs.size());
+
+      // No vector positions should be NULL (use EmptyOrganism instead)
+      if (orgs[pos].IsNull()) {
+        std::cerr << "ERROR: Population " << pop_id << " as position " << pos
+                  << " has null pointer instead of an organism." << std::endl;
+        return false;
+      }
+
+      // Organisms should point back at this population.
+      if (orgs[pos]->GetPopPtr() != this) {
+        std::cerr << "ERROR: Population " << pop_id << " org# " << pos
+                  << " does not point back at the correct population." << std::endl;
+        return false;
+      }
+
+      // Living organisms (and only living organisms) should be in the living-position index.
+      const bool alive = !orgs[pos]->IsEmpty();
+      const bool indexed = living_id[pos] < living_pos.size() && living_pos[living_id[pos]] == pos;
+      if (alive != occupied.Has(pos) || (alive && !indexed)) {
+        std::cerr << "ERROR: Population " << pop_id << " org# " << pos << " is "
+                  << (alive ? "alive" : "empty") << " but its index entries disagree." << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    bool OK() const {
+      if (!OKCounts()) return false;
+
       // Scan through the population and make sure every position is valid.
       size_t org_count = 0;
       for (size_t pos = 0; pos < orgs.size(); pos++) {
-        // No vector positions should be NULL (use EmptyOrganism instead)
-        if (orgs[pos].IsNull()) {
-          std::cerr << "ERROR: Population " << pop_id << " as position " << pos
-                    << " has null pointer instead of an organism." << std::endl;
-          return false;
-        }
-
-        // Organisms should point back at this population.
-        if (orgs[pos]->GetPopPtr() != this) {
-          std::cerr << "ERROR: Population " << pop_id << " org# " << pos
-                    << " does not point back at the correct population." << std::endl;
-          return false;
-        }
+        if (!OKPosition(pos)) return false;
 
         // Count the number of living (non-empty) organisms as we go.
         if (!orgs[pos]->IsEmpty()) org_count++;
@@ -294,6 +606,22 @@ namespace mabe {
           return false;
       }
 
+      // The living-position index should exactly cover the living organisms.
+      for (size_t id = 0; id < living_pos.size(); ++id) {
+        const size_t pos = living_pos[id];
+        if (pos >= orgs.size() || orgs[pos]->IsEmpty() || living_id[pos] != id) {
+          std::cerr << "ERROR: Population " << pop_id << " living index entry " << id
+                    << " (position " << pos << ") is inconsistent." << std::endl;
+          return false;
+        }
+      }
+      if (occupied.GetSize() != orgs.size() || occupied.CountOnes() != num_orgs) {
+        std::cerr << "ERROR: Population " << pop_id << " occupied bitset has " << occupied.CountOnes()
+                  << " of " << occupied.GetSize() << " positions set, but num_orgs = " << num_orgs
+                  << std::endl;
+        return false;
+      }
+
       // @CAO: If we have a cap on the population size, make sure we haven't crossed it?
 
       return true;
@@ -359,6 +687,49 @@ namespace mabe {
     if (pos > pop_ptr->GetSize()) ToEnd();
   }
 
+
+  // --------------------------------------
+  // --  LivingPopIteratorT Definitions  --
+  // --------------------------------------
+
+  template <typename ORG_T, typename POP_T>
+  LivingPopIteratorT<ORG_T,POP_T>::LivingPopIteratorT(emp::Ptr<POP_T> _pop, size_t _pos)
+    : base_t(_pop, _pos)
+  {
+    if (pop_ptr && pos < pop_ptr->GetSize() && !pop_ptr->GetOccupied().Has(pos)) IncPosition();
+  }
+
+  template <typename ORG_T, typename POP_T>
+  void LivingPopIteratorT<ORG_T,POP_T>::IncPosition() {
+    emp_assert(pop_ptr);
+    emp_assert(pos < pop_ptr->GetSize(), pos, pop_ptr->GetSize());
+    const int next_pos = pop_ptr->GetOccupied().FindOne(pos+1);
+    pos = (next_pos == -1) ? pop_ptr->GetSize() : (size_t) next_pos;
+  }
+  template <typename ORG_T, typename POP_T>
+  void LivingPopIteratorT<ORG_T,POP_T>::DecPosition() {
+    emp_assert(pop_ptr);
+    const emp::BitVector & occupied = pop_ptr->GetOccupied();
+    size_t prev_pos = pos;
+    while (prev_pos > 0 && !occupied.Has(--prev_pos));
+    emp_assert(occupied.Has(prev_pos), "Cannot decrement before the first living organism.");
+    pos = prev_pos;
+  }
+  template <typename ORG_T, typename POP_T>
+  void LivingPopIteratorT<ORG_T,POP_T>::ShiftPosition(int shift) {
+    for (; shift > 0; --shift) IncPosition();
+    for (; shift < 0; ++shift) DecPosition();
+  }
+  template <typename ORG_T, typename POP_T>
+  void LivingPopIteratorT<ORG_T,POP_T>::ToBegin() {
+    const int first_pos = pop_ptr->GetOccupied().FindOne();
+    pos = (first_pos == -1) ? pop_ptr->GetSize() : (size_t) first_pos;
+  }
+  template <typename ORG_T, typename POP_T>
+  void LivingPopIteratorT<ORG_T,POP_T>::ToEnd() { pos = pop_ptr->GetSize(); }
+
+  OrgPosition Organism::GetPosition() const { return OrgPosition(pop_ptr, pop_pos); }
+
 }
 
 #endif
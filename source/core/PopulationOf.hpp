@@ -0,0 +1,106 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  PopulationOf.hpp
+ *  @brief A typed view of a Population whose organisms all share one organism type.
+ *
+ *  Nearly every population holds organisms of a single type, but a Population only knows them
+ *  as Organism pointers, so each Mutate(), GenerateOutput(), or ProcessStep() is a virtual call.
+ *  A PopulationOf<ORG_T> checks once (by comparing organism managers) that every living
+ *  organism is exactly an ORG_T, and then hands them out as ORG_T references.  Its helper
+ *  functions call ORG_T's member functions with qualified names, so the compiler can inline
+ *  them instead of dispatching through the vtable.
+ *
+ *  Usage (in a module that knows its organism type):
+ *    PopulationOf<VirtualCPUOrg> typed_pop(pop);
+ *    if (typed_pop.IsValid()) typed_pop.ForEach([](VirtualCPUOrg & org){ ... });
+ *
+ *  The view does not own or move any organisms; it must be rebuilt (or re-checked with
+ *  Refresh()) after organisms of another type could have been placed in the population.
+ */
+
+#ifndef MABE_POPULATION_OF_H
+#define MABE_POPULATION_OF_H
+
+#include "emp/base/assert.hpp"
+#include "emp/base/Ptr.hpp"
+
+#include "OrganismManager.hpp"
+#include "Population.hpp"
+
+namespace mabe {
+
+  template <typename ORG_T>
+  class PopulationOf {
+  private:
+    using manager_t = OrganismManager<ORG_T>;
+
+    emp::Ptr<Population> pop_ptr;
+    bool is_valid = false;     ///< Are all living organisms exactly ORG_T?
+
+  public:
+    PopulationOf(Population & pop) : pop_ptr(&pop) { Refresh(); }
+
+    /// Test if every living organism in a population is managed by a manager of ORG_T.
+    static bool Matches(const Population & pop) {
+      const Module * last_manager = nullptr;  // Most recent manager verified to be a manager_t.
+      for (const Organism & org : pop.Living()) {
+        const Module * manager = &org.GetManager();
+        if (manager == last_manager) continue;
+        if (!dynamic_cast<const manager_t *>(manager)) return false;
+        last_manager = manager;
+      }
+      return true;
+    }
+
+    /// Re-check the population (e.g., after injecting organisms of possibly another type).
+    bool Refresh() { return is_valid = Matches(*pop_ptr); }
+
+    bool IsValid() const { return is_valid; }
+    Population & GetPopulation() { return *pop_ptr; }
+    const Population & GetPopulation() const { return *pop_ptr; }
+    size_t GetSize() const { return pop_ptr->GetSize(); }
+    size_t GetNumOrgs() const { return pop_ptr->GetNumOrgs(); }
+    bool IsOccupied(size_t pos) const { return pop_ptr->IsOccupied(pos); }
+
+    /// Access the living organism at 'pos' as an ORG_T.
+    ORG_T & operator[](size_t pos) {
+      emp_assert(is_valid && pop_ptr->IsOccupied(pos), is_valid, pos);
+      return static_cast<ORG_T &>((*pop_ptr)[pos]);
+    }
+    const ORG_T & operator[](size_t pos) const {
+      emp_assert(is_valid && pop_ptr->IsOccupied(pos), is_valid, pos);
+      return static_cast<const ORG_T &>((*pop_ptr)[pos]);
+    }
+
+    /// Call fun(ORG_T &) on each living organism, in position order.
+    template <typename FUN_T>
+    void ForEach(FUN_T && fun) {
+      emp_assert(is_valid, "PopulationOf used on a population with other organism types.");
+      for (Organism & org : pop_ptr->Living()) fun(static_cast<ORG_T &>(org));
+    }
+
+    // --- Devirtualized versions of common per-organism operations ---
+
+    /// Run GenerateOutput() on every living organism.
+    void GenerateOutputs() {
+      ForEach([](ORG_T & org){ org.ORG_T::GenerateOutput(); });
+    }
+
+    /// Run one ProcessStep() on the organism at 'pos'; return whether it did anything.
+    bool ProcessStep(size_t pos) { return (*this)[pos].ORG_T::ProcessStep(); }
+
+    /// Run 'num_steps' ProcessStep() calls on the organism at 'pos'; return how many did anything.
+    size_t ProcessSteps(size_t pos, size_t num_steps) {
+      ORG_T & org = (*this)[pos];
+      size_t num_processed = 0;
+      for (size_t step = 0; step < num_steps; ++step) num_processed += org.ORG_T::ProcessStep();
+      return num_processed;
+    }
+  };
+
+}
+
+#endif
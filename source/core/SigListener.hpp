@@ -17,6 +17,8 @@
 #include "emp/base/Ptr.hpp"
 #include "emp/base/vector.hpp"
 
+#include "../tools/Profiler.hpp"
+
 #include "OrgIterator.hpp"
 
 namespace mabe {
@@ -30,12 +32,34 @@ namespace mabe {
     id_t id;   ///< ID of this signal
     mod_ptr_t cur_mod;         ///< Which module is currently running?
 
+    emp::Ptr<Profiler> profiler = nullptr;  ///< If set, time each module call.
+    emp::vector<size_t> prof_slots;         ///< Profiler slot for each module (by position).
+
     SigListenerBase(emp::String _name="", id_t _id=MODULE_T::SIG_UNKNOWN)
       : name(_name), id(_id) {;}
     SigListenerBase(const SigListenerBase &) = default;
     SigListenerBase(SigListenerBase &&) = default;
     SigListenerBase & operator=(const SigListenerBase &) = default;
     SigListenerBase & operator=(SigListenerBase &&) = default;
+
+    /// Start (or, with nullptr, stop) timing calls to this signal.
+    void SetProfiler(emp::Ptr<Profiler> in_profiler) {
+      profiler = in_profiler;
+      prof_slots.resize(0);
+    }
+
+    /// Profiler slot for the module at 'pos'; should be called only when profiling.
+    size_t GetProfileSlot(size_t pos) {
+      emp_assert(profiler);
+      // Modules are re-linked whenever signals are updated, so rebuild slots if needed.
+      if (prof_slots.size() != this->size()) {
+        prof_slots.resize(0);
+        for (mod_ptr_t mod_ptr : *this) {
+          prof_slots.push_back( profiler->GetSlot(mod_ptr->GetName() + ":" + name) );
+        }
+      }
+      return prof_slots[pos];
+    }
   };
 
   /// Each set of modules to be called when a specific signal is triggered should be identified
@@ -64,6 +88,18 @@ namespace mabe {
 
     template <typename... ARGS2>
     void Trigger(ARGS2 &&... args) {
+      if (base_t::profiler) {
+        for (size_t pos = 0; pos < this->size(); ++pos) {
+          mod_ptr_t mod_ptr = (*this)[pos];
+          base_t::cur_mod = mod_ptr;
+          const Profiler::Mark start = base_t::profiler->Begin();
+          (mod_ptr.Raw()->*fun)( std::forward<ARGS2>(args)... );
+          base_t::profiler->End(base_t::GetProfileSlot(pos), start);
+        }
+        base_t::cur_mod = nullptr;
+        return;
+      }
+
       for (mod_ptr_t mod_ptr : *this) {
         base_t::cur_mod = mod_ptr;
         emp_assert(!mod_ptr.IsNull());
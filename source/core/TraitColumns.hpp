@@ -0,0 +1,103 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TraitColumns.hpp
+ *  @brief Contiguous, position-indexed copies of numeric traits for a whole population.
+ *
+ *  Organism traits live in each organism's own DataMap, so a population-wide scan of a single
+ *  trait must visit every organism's memory.  TraitColumns keeps a structure-of-arrays copy of
+ *  selected double-valued traits, one contiguous column per trait, indexed by position.
+ *
+ *  Rows are maintained as organisms are placed, removed, or moved (an organism's values are
+ *  copied into its row when it is placed), but writes to an organism's DataMap are NOT
+ *  mirrored automatically.  Call RefreshTraitColumns() on the owning Population after evaluation to
+ *  re-gather all columns in a single pass over the population.
+ *
+ *  DEVELOPER NOTES:
+ *  - Ideally organism DataMaps would alias directly into these columns; emp::DataMap owns its
+ *    own memory image, so for now columns are a synchronized copy instead.
+ */
+
+#ifndef MABE_TRAIT_COLUMNS_H
+#define MABE_TRAIT_COLUMNS_H
+
+#include <span>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/data/DataMap.hpp"
+#include "emp/tools/String.hpp"
+
+namespace mabe {
+
+  class TraitColumns {
+  private:
+    struct Column {
+      emp::String name;            ///< Name of the trait being tracked.
+      size_t trait_id;             ///< ID of the trait in the organism DataLayout.
+      emp::vector<double> values;  ///< One value per population position.
+    };
+
+    emp::vector<Column> columns;
+    emp::BitVector occupied;       ///< Which rows currently hold values from a living org?
+
+  public:
+    size_t GetNumColumns() const { return columns.size(); }
+    size_t GetNumRows() const { return occupied.GetSize(); }
+    bool IsOccupied(size_t row) const { return occupied.Has(row); }
+
+    /// Return the column index associated with a trait name, or -1 if not tracked.
+    int GetColumnID(const emp::String & name) const {
+      for (size_t i = 0; i < columns.size(); ++i) if (columns[i].name == name) return (int) i;
+      return -1;
+    }
+    bool HasColumn(const emp::String & name) const { return GetColumnID(name) >= 0; }
+
+    /// Start tracking a trait; returns its column index.  Values start at 0.0 until loaded.
+    size_t AddColumn(const emp::String & name, size_t trait_id) {
+      if (int col_id = GetColumnID(name); col_id >= 0) return (size_t) col_id;
+      columns.push_back( Column{name, trait_id, emp::vector<double>(GetNumRows(), 0.0)} );
+      return columns.size() - 1;
+    }
+
+    std::span<const double> GetColumn(size_t col_id) const {
+      emp_assert(col_id < columns.size(), col_id, columns.size());
+      return std::span<const double>(columns[col_id].values.data(), columns[col_id].values.size());
+    }
+
+    const emp::String & GetColumnName(size_t col_id) const { return columns[col_id].name; }
+    size_t GetColumnTraitID(size_t col_id) const { return columns[col_id].trait_id; }
+
+    /// Change the number of rows; new rows are unoccupied.
+    void Resize(size_t num_rows) {
+      occupied.Resize(num_rows);
+      for (Column & col : columns) col.values.resize(num_rows, 0.0);
+    }
+
+    /// Copy the tracked trait values from a DataMap into a row.
+    void LoadRow(size_t row, const emp::DataMap & dmap) {
+      emp_assert(row < GetNumRows(), row, GetNumRows());
+      for (Column & col : columns) col.values[row] = dmap.Get<double>(col.trait_id);
+      occupied.Set(row);
+    }
+
+    /// Copy a row's values back out into a DataMap.
+    void StoreRow(size_t row, emp::DataMap & dmap) const {
+      emp_assert(row < GetNumRows(), row, GetNumRows());
+      for (const Column & col : columns) dmap.Get<double>(col.trait_id) = col.values[row];
+    }
+
+    /// Mark a row as no longer holding a living organism.
+    void ClearRow(size_t row) {
+      emp_assert(row < GetNumRows(), row, GetNumRows());
+      for (Column & col : columns) col.values[row] = 0.0;
+      occupied.Set(row, false);
+    }
+  };
+
+}
+
+#endif
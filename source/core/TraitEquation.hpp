@@ -0,0 +1,344 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TraitEquation.hpp
+ *  @brief Flat bytecode for simple arithmetic trait equations, evaluated over many orgs at once.
+ *
+ *  Equations built by emp::SimpleParser are trees of nested std::function calls that are run
+ *  one organism at a time.  A TraitEquation compiles the common subset of equations (numeric
+ *  literals, double-valued traits, $# pre-processed values, + - * /, unary minus, comparisons,
+ *  and parentheses) into a flat stack program.  The program is then run over blocks of
+ *  organisms, so each instruction is a tight loop across the whole block.
+ *
+ *  Elements of multi-value double traits can be read as name[i].  A trait with a history kept
+ *  by the TraitHistory module can be read as name[-k], the value k records ago (from the trait
+ *  name_history); the parser cannot read either form, so they are only supported here.
+ *
+ *  Names that are not traits can be bound to outside variables through a lookup function
+ *  given to Compile().  Bound variables are read each time the equation is evaluated, so an
+ *  equation such as "fitness < threshold" is compiled once and follows the current threshold.
+ *
+ *  Compile() returns false for anything outside of this subset (function calls, non-double
+ *  traits, etc.); callers should fall back to the SimpleParser version in that case.
+ */
+
+#ifndef MABE_TRAIT_EQUATION_H
+#define MABE_TRAIT_EQUATION_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <span>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/data/DataMap.hpp"
+#include "emp/tools/String.hpp"
+
+namespace mabe {
+
+  class TraitEquation {
+  public:
+    static constexpr size_t BLOCK_SIZE = 256;   ///< Number of orgs processed per pass.
+
+    using var_fun_t = std::function<double()>;                         ///< Reads a variable.
+    using var_lookup_t = std::function<var_fun_t(const emp::String &)>; ///< Finds a variable.
+
+  private:
+    enum class Op { CONST, TRAIT, VAR, NEG, ADD, SUB, MUL, DIV, LESS, GREATER, LESS_EQ,
+                    GREATER_EQ, EQU, NEQU };
+
+    struct Inst {
+      Op op;
+      double value = 0.0;    ///< Used by CONST
+      size_t trait_id = 0;   ///< Used by TRAIT
+      size_t index = 0;      ///< Used by TRAIT (element of a multi-value trait)
+      size_t var_id = 0;     ///< Used by VAR
+    };
+
+    emp::vector<Inst> code;
+    size_t max_depth = 0;
+    emp::vector<var_fun_t> vars;       ///< Bound variables, by var_id.
+    bool indexed = false;              ///< Are any traits read as name[i] or name[-k]?
+
+    // --- Compilation state ---
+    struct Compiler {
+      const emp::DataLayout & layout;
+      const emp::String & equ;
+      const emp::vector<double> & values;
+      const var_lookup_t & var_lookup;
+      emp::vector<Inst> & code;
+      emp::vector<var_fun_t> & vars;
+      emp::vector<emp::String> var_names;
+      bool indexed = false;
+      size_t pos = 0;
+      size_t depth = 0;
+      size_t max_depth = 0;
+      bool ok = true;
+
+      void SkipWS() { while (pos < equ.size() && std::isspace(equ[pos])) ++pos; }
+      bool Match(const char * token) {
+        SkipWS();
+        size_t len = 0;
+        while (token[len]) {
+          if (pos + len >= equ.size() || equ[pos+len] != token[len]) return false;
+          ++len;
+        }
+        pos += len;
+        return true;
+      }
+      void Push(Inst inst) {
+        code.push_back(inst);
+        if (IsLoad(inst.op)) max_depth = std::max(max_depth, ++depth);
+        else if (inst.op != Op::NEG) --depth;
+      }
+
+      void ParsePrimary() {
+        SkipWS();
+        if (pos >= equ.size()) { ok = false; return; }
+        const char c = equ[pos];
+        if (c == '(') {
+          ++pos;
+          ParseCompare();
+          if (!Match(")")) ok = false;
+        }
+        else if (c == '-') { ++pos; ParsePrimary(); Push({Op::NEG}); }
+        else if (c == '+') { ++pos; ParsePrimary(); }
+        else if (c == '$') {                // Pre-processed value, as $#
+          size_t end = ++pos;
+          while (end < equ.size() && std::isdigit(equ[end])) ++end;
+          if (end == pos) { ok = false; return; }
+          const size_t id = std::strtoul(equ.c_str() + pos, nullptr, 10);
+          if (id >= values.size()) { ok = false; return; }
+          Push({Op::CONST, values[id]});
+          pos = end;
+        }
+        else if (std::isdigit(c) || c == '.') {
+          char * end = nullptr;
+          const double value = std::strtod(equ.c_str() + pos, &end);
+          if (end == equ.c_str() + pos) { ok = false; return; }
+          pos = (size_t) (end - equ.c_str());
+          Push({Op::CONST, value});
+        }
+        else if (std::isalpha(c) || c == '_') {
+          size_t end = pos;
+          while (end < equ.size() && (std::isalnum(equ[end]) || equ[end] == '_')) ++end;
+          const emp::String name = equ.substr(pos, end-pos);
+          pos = end;
+          SkipWS();
+          if (pos < equ.size() && equ[pos] == '(') { ok = false; return; } // No function calls.
+          if (pos < equ.size() && equ[pos] == '[') { ParseIndex(name); return; }
+          if (!layout.HasName(name)) { ParseVar(name); return; }
+          const size_t trait_id = layout.GetID(name);
+          if (!layout.IsType<double>(trait_id)) { ok = false; return; }
+          Push({Op::TRAIT, 0.0, trait_id});
+        }
+        else ok = false;
+      }
+
+      /// Read one element of a trait: name[i] for element i, or name[-k] for the value recorded
+      /// k steps ago in name_history.
+      void ParseIndex(const emp::String & name) {
+        ++pos;                                            // Skip '['
+        SkipWS();
+        const bool history = (pos < equ.size() && equ[pos] == '-');
+        if (history) ++pos;
+        size_t end = pos;
+        while (end < equ.size() && std::isdigit(equ[end])) ++end;
+        if (end == pos) { ok = false; return; }
+        size_t index = std::strtoul(equ.c_str() + pos, nullptr, 10);
+        pos = end;
+        if (!Match("]")) { ok = false; return; }
+
+        emp::String trait_name = name;
+        if (history) {
+          if (index == 0) { ok = false; return; }         // name[-1] is the latest record.
+          trait_name += "_history";
+          --index;
+        }
+        if (!layout.HasName(trait_name)) { ok = false; return; }
+        const size_t trait_id = layout.GetID(trait_name);
+        if (!layout.IsType<double>(trait_id) || index >= layout.GetCount(trait_id)) { ok = false; return; }
+        Inst inst{Op::TRAIT, 0.0, trait_id};
+        inst.index = index;
+        indexed = true;
+        Push(inst);
+      }
+
+      /// Use a name that is not a trait as a bound variable, if the lookup can find it.
+      void ParseVar(const emp::String & name) {
+        for (size_t id = 0; id < var_names.size(); ++id) {
+          if (var_names[id] == name) { Inst inst{Op::VAR}; inst.var_id = id; Push(inst); return; }
+        }
+        var_fun_t var_fun = var_lookup ? var_lookup(name) : var_fun_t();
+        if (!var_fun) { ok = false; return; }
+        Inst inst{Op::VAR};
+        inst.var_id = vars.size();
+        var_names.push_back(name);
+        vars.push_back(var_fun);
+        Push(inst);
+      }
+
+      void ParseProduct() {
+        ParsePrimary();
+        while (ok) {
+          if (Match("*")) {
+            if (pos < equ.size() && equ[pos] == '*') { ok = false; return; } // No '**' support.
+            ParsePrimary(); Push({Op::MUL});
+          }
+          else if (Match("/")) { ParsePrimary(); Push({Op::DIV}); }
+          else return;
+        }
+      }
+
+      void ParseSum() {
+        ParseProduct();
+        while (ok) {
+          if (Match("+")) { ParseProduct(); Push({Op::ADD}); }
+          else if (Match("-")) { ParseProduct(); Push({Op::SUB}); }
+          else return;
+        }
+      }
+
+      void ParseCompare() {
+        ParseSum();
+        while (ok) {
+          if (Match("<=")) { ParseSum(); Push({Op::LESS_EQ}); }
+          else if (Match(">=")) { ParseSum(); Push({Op::GREATER_EQ}); }
+          else if (Match("==")) { ParseSum(); Push({Op::EQU}); }
+          else if (Match("!=")) { ParseSum(); Push({Op::NEQU}); }
+          else if (Match("<")) { ParseSum(); Push({Op::LESS}); }
+          else if (Match(">")) { ParseSum(); Push({Op::GREATER}); }
+          else return;
+        }
+      }
+    };
+
+    static bool IsLoad(Op op) { return op == Op::CONST || op == Op::TRAIT || op == Op::VAR; }
+
+    /// Per-thread buffers (0 for variables, 1 for the stack) for single-map evaluations too
+    /// large for the local arrays; each grows as needed and is reused by later calls.
+    static double * Scratch(size_t id, size_t size) {
+      thread_local emp::vector<double> buffers[2];
+      if (buffers[id].size() < size) buffers[id].resize(size);
+      return buffers[id].data();
+    }
+
+    // Run the program on up to 'stride' data maps; stack must hold max_depth blocks of 'stride'.
+    void RunBlock(std::span<const emp::DataMap * const> maps, double * stack, size_t stride,
+                  std::span<const double> var_values, double * out) const {
+      const size_t count = maps.size();
+      size_t depth = 0;
+      for (const Inst & inst : code) {
+        if (IsLoad(inst.op)) ++depth;
+        double * top = stack + (depth-1) * stride;       // Current top block
+        double * a = (depth > 1) ? top - stride : top;   // Second from top, for binary ops.
+        switch (inst.op) {
+        case Op::CONST: std::fill(top, top+count, inst.value); break;
+        case Op::TRAIT:
+          for (size_t i = 0; i < count; ++i) top[i] = (&maps[i]->Get<double>(inst.trait_id))[inst.index];
+          break;
+        case Op::VAR: std::fill(top, top+count, var_values[inst.var_id]); break;
+        case Op::NEG: for (size_t i = 0; i < count; ++i) top[i] = -top[i]; break;
+        case Op::ADD: for (size_t i = 0; i < count; ++i) a[i] += top[i]; break;
+        case Op::SUB: for (size_t i = 0; i < count; ++i) a[i] -= top[i]; break;
+        case Op::MUL: for (size_t i = 0; i < count; ++i) a[i] *= top[i]; break;
+        case Op::DIV: for (size_t i = 0; i < count; ++i) a[i] /= top[i]; break;
+        case Op::LESS: for (size_t i = 0; i < count; ++i) a[i] = a[i] < top[i]; break;
+        case Op::GREATER: for (size_t i = 0; i < count; ++i) a[i] = a[i] > top[i]; break;
+        case Op::LESS_EQ: for (size_t i = 0; i < count; ++i) a[i] = a[i] <= top[i]; break;
+        case Op::GREATER_EQ: for (size_t i = 0; i < count; ++i) a[i] = a[i] >= top[i]; break;
+        case Op::EQU: for (size_t i = 0; i < count; ++i) a[i] = a[i] == top[i]; break;
+        case Op::NEQU: for (size_t i = 0; i < count; ++i) a[i] = a[i] != top[i]; break;
+        }
+        if (!IsLoad(inst.op) && inst.op != Op::NEG) --depth;
+      }
+      emp_assert(depth == 1, depth);
+      std::copy(stack, stack+count, out);
+    }
+
+  public:
+    TraitEquation() = default;
+
+    /// Compile an equation for a given layout; returns false if it uses unsupported features.
+    /// 'values' provide the numbers for any $# placeholders left by MABEScript::Preprocess().
+    /// 'var_lookup' (if provided) binds names that are not traits to outside variables.
+    bool Compile(const emp::DataLayout & layout, const emp::String & equation,
+                 const emp::vector<double> & values = {},
+                 const var_lookup_t & var_lookup = var_lookup_t()) {
+      code.resize(0);
+      vars.resize(0);
+      Compiler compiler{layout, equation, values, var_lookup, code, vars};
+      compiler.ParseCompare();
+      compiler.SkipWS();
+      if (!compiler.ok || compiler.pos != equation.size() || compiler.depth != 1) {
+        code.resize(0);
+        vars.resize(0);
+        max_depth = 0;
+        indexed = false;
+        return false;
+      }
+      max_depth = compiler.max_depth;
+      indexed = compiler.indexed;
+      return true;
+    }
+
+    bool IsValid() const { return code.size() > 0; }
+    size_t GetNumInsts() const { return code.size(); }
+    size_t GetNumVars() const { return vars.size(); }
+    bool HasIndexedTraits() const { return indexed; }
+
+    /// Read the current value of every bound variable.
+    emp::vector<double> ReadVars() const {
+      emp::vector<double> var_values(vars.size());
+      for (size_t id = 0; id < vars.size(); ++id) var_values[id] = vars[id]();
+      return var_values;
+    }
+
+    /// Evaluate on a single data map.
+    double Eval(const emp::DataMap & dmap) const {
+      double local_vars[8];       // Enough for nearly any equation, without allocating.
+      double * var_values = (vars.size() <= 8) ? local_vars : Scratch(0, vars.size());
+      for (size_t id = 0; id < vars.size(); ++id) var_values[id] = vars[id]();
+      return Eval(dmap, std::span<const double>(var_values, vars.size()));
+    }
+
+    /// Evaluate on a single data map, using variable values already read with ReadVars().
+    double Eval(const emp::DataMap & dmap, std::span<const double> var_values) const {
+      emp_assert(IsValid());
+      emp_assert(var_values.size() == vars.size(), var_values.size(), vars.size());
+      const emp::DataMap * map_ptr = &dmap;
+      double result = 0.0;
+      double local_stack[16];    // Enough for nearly any equation, without allocating.
+      RunBlock(std::span<const emp::DataMap * const>(&map_ptr, 1),
+               max_depth > 16 ? Scratch(1, max_depth) : local_stack, 1, var_values, &result);
+      return result;
+    }
+
+    /// Evaluate on a set of data maps, writing one result per map into 'out'.
+    void Eval(std::span<const emp::DataMap * const> maps, std::span<double> out) const {
+      const emp::vector<double> var_values = ReadVars();
+      Eval(maps, out, std::span<const double>(var_values.data(), var_values.size()));
+    }
+
+    /// Evaluate on a set of data maps, using variable values already read with ReadVars().
+    /// Calls with separate outputs may run at the same time on different threads.
+    void Eval(std::span<const emp::DataMap * const> maps, std::span<double> out,
+              std::span<const double> var_values) const {
+      emp_assert(IsValid());
+      emp_assert(out.size() >= maps.size(), out.size(), maps.size());
+      emp_assert(var_values.size() == vars.size(), var_values.size(), vars.size());
+      emp::vector<double> stack(max_depth * BLOCK_SIZE);
+      for (size_t start = 0; start < maps.size(); start += BLOCK_SIZE) {
+        const size_t count = std::min(BLOCK_SIZE, maps.size() - start);
+        RunBlock(maps.subspan(start, count), stack.data(), BLOCK_SIZE, var_values, out.data() + start);
+      }
+    }
+  };
+
+}
+
+#endif
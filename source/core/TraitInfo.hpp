@@ -53,12 +53,15 @@
 #define MABE_TRAIT_INFO_H
 
 #include <set>
+#include <type_traits>
 
 #include "emp/base/vector.hpp"
 #include "emp/data/DataMap.hpp"
 #include "emp/meta/TypeID.hpp"
 #include "emp/tools/String.hpp"
 
+#include "../tools/Checkpoint.hpp"
+
 namespace mabe {
 
   class ModuleBase;
@@ -124,12 +127,23 @@ namespace mabe {
       FULL,       ///< Store ALL current/final values for organisms.
     };
 
+    /// How often is this trait expected to be touched?  Traits are placed in the organism
+    /// DataMap grouped by usage, so that frequently used traits share cache lines.
+    enum class Usage {
+      HOT=0,      ///< Touched every step (e.g., merit, inputs/outputs, task flags).
+      EVAL,       ///< Touched about once per evaluation or birth (default).
+      ARCHIVE     ///< Rarely touched; kept mostly for output.
+    };
+
     /// Special value count to represent ANY count is allowed.
     static constexpr const size_t ANY_COUNT = static_cast<size_t>(-1);
 
   protected:
     Init init = Init::DEFAULT;
     bool reset_parent = false;  ///< Should the parent ALSO be reset on birth?
+    bool per_lifetime = false;  ///< Should this trait be reset by a lifetime (partial) reset?
+    Usage usage = Usage::EVAL;  ///< How often this trait is expected to be touched.
+    bool usage_set = false;     ///< Has any module declared a usage?
     Archive archive = Archive::NONE;
     Summary summary = Summary::IGNORE;
 
@@ -187,6 +201,11 @@ namespace mabe {
       return access_info[id].access;
     }
 
+    /// Can a module with the given access write to this trait?
+    static bool CanWrite(Access access) {
+      return access == PRIVATE || access == OWNED || access == GENERATED || access == SHARED;
+    }
+
     /// Determine if a module has any knd of access to this trait.
     bool HasAccess(mod_ptr_t mod_ptr) const { return GetAccess(mod_ptr) != Access::UNKNOWN; }
 
@@ -238,6 +257,8 @@ namespace mabe {
     /// Was a default value set for this trait (can only be done in overload that knows type)
     virtual bool HasDefault() const { return false; }
     bool GetResetParent() const { return reset_parent; }
+    bool GetPerLifetime() const { return per_lifetime; }
+    Usage GetUsage() const { return usage; }
 
     Init GetInit() const { return init; }
     Archive GetArchive() const { return archive; }
@@ -254,13 +275,15 @@ namespace mabe {
       return *this;
     }
 
-    /// Add all of the accesses from a previous TraitInfo object.
+    /// Add all of the accesses (and declared usage) from a previous TraitInfo object.
     TraitInfo & AddAccess(const TraitInfo & in) {
       for (const auto & mod_info : in.access_info) access_info.push_back(mod_info);
       for (size_t i = 0; i < NUM_ACCESS; ++i) {
         access_counts[i] += in.access_counts[i];
         manager_access_counts[i] += in.manager_access_counts[i];
       }
+      if (in.usage_set) SetUsage(in.usage);
+      if (in.per_lifetime) per_lifetime = true;
       return *this;
     }
 
@@ -279,6 +302,17 @@ namespace mabe {
     /// Set the parent to ALSO reset to the same value as the offspring on divide.
     TraitInfo & SetParentReset() { reset_parent = true; return *this; }
 
+    /// Mark this trait as describing only the current lifetime, so that it is included in
+    /// partial resets (MABE::ResetLifetimeTraits) and not just full resets.
+    TraitInfo & SetPerLifetime() { per_lifetime = true; return *this; }
+
+    /// Declare how often this trait is touched; if modules disagree, the most frequent wins.
+    TraitInfo & SetUsage(Usage in_usage) {
+      if (!usage_set || in_usage < usage) usage = in_usage;
+      usage_set = true;
+      return *this;
+    }
+
     /// Set the previous value of this trait to be stored on birth or reset.
     TraitInfo & SetArchiveLast() { archive = Archive::LAST_REPRO; return *this; }
 
@@ -290,13 +324,37 @@ namespace mabe {
     
     /// Reset this trait back to its default value.
     virtual bool ResetToDefault(emp::DataMap &) { return false; }
+
+    /// Can this trait's values be reset with a raw memory copy?
+    virtual bool IsTriviallyCopyable() const { return false; }
+
+    /// Number of bytes taken by all of this trait's values in a DataMap.
+    virtual size_t GetByteSize() const { return 0; }
+
+    /// Alignment required by this trait's type.
+    virtual size_t GetAlignment() const { return 1; }
+
+    /// Address of this trait's first value in a DataMap ('id' is the trait's ID in its layout).
+    virtual const void * GetValuePtr(const emp::DataMap &, size_t /*id*/) const { return nullptr; }
+
+    /// Copy all of this trait's values between two DataMaps with the same layout.
+    virtual void CopyValue(const emp::DataMap & /*from*/, emp::DataMap & /*to*/, size_t /*id*/) const { }
+
+    /// Can this trait's values be saved in a checkpoint?
+    virtual bool CanCheckpoint() const { return false; }
+
+    /// Write this trait's value(s) from a DataMap into a checkpoint; false if not supported.
+    virtual bool SaveValue(const emp::DataMap &, CheckpointWriter &) const { return false; }
+
+    /// Read this trait's value(s) from a checkpoint into a DataMap; false if not supported.
+    virtual bool LoadValue(emp::DataMap &, CheckpointReader &) const { return false; }
   };
 
   // Information about this trait, including type information and alternate type options.
   template <typename T>
   class TypedTraitInfo : public TraitInfo {
   private:
-    T default_value;
+    T default_value{};
     bool has_default;
 
   public:
@@ -340,6 +398,40 @@ namespace mabe {
       return true;
     }
 
+    bool IsTriviallyCopyable() const override { return std::is_trivially_copyable_v<T>; }
+    size_t GetByteSize() const override { return sizeof(T) * val_count; }
+    size_t GetAlignment() const override { return alignof(T); }
+
+    const void * GetValuePtr(const emp::DataMap & dm, size_t id) const override {
+      return &dm.Get<T>(id);
+    }
+
+    void CopyValue(const emp::DataMap & from, emp::DataMap & to, size_t id) const override {
+      const T * from_vals = &from.Get<T>(id);
+      T * to_vals = &to.Get<T>(id);
+      for (size_t i = 0; i < val_count; ++i) to_vals[i] = from_vals[i];
+    }
+
+    bool CanCheckpoint() const override { return IsCheckpointType<T>(); }
+
+    bool SaveValue(const emp::DataMap & dm, CheckpointWriter & out) const override {
+      if constexpr (IsCheckpointType<T>()) {
+        const T * vals = &dm.Get<T>(name);
+        for (size_t i = 0; i < val_count; ++i) out.Write<T>(vals[i]);
+        return true;
+      }
+      else return false;
+    }
+
+    bool LoadValue(emp::DataMap & dm, CheckpointReader & in) const override {
+      if constexpr (IsCheckpointType<T>()) {
+        T * vals = &dm.Get<T>(name);
+        for (size_t i = 0; i < val_count; ++i) in.Read<T>(vals[i]);
+        return true;
+      }
+      else return false;
+    }
+
   };
 
   // Information about a trait that is currently only accessed as a string.
@@ -9,11 +9,25 @@
  *  A TraitManager facilitates the creation and destruction of TraitInfo object, which are
  *  stored in DataMaps and maintain access information about classes (modules) that use those
  *  traits.
+ *
+ *  Traits are registered in a DataMap grouped by their declared Usage (HOT, EVAL, ARCHIVE) so
+ *  that frequently touched values share cache lines; large or non-trivially-copyable traits
+ *  (strings, vectors, genomes) are placed after all of the small scalars.
+ *
+ *  Once the organism DataMap is locked, BuildResetImage() keeps a copy of it with every trait
+ *  at its default value.  ResetAll() then restores a DataMap from that image with one memcpy
+ *  per contiguous run of trivially copyable traits, plus a typed copy for each remaining
+ *  (e.g., string or vector) trait.  ResetLifetime() does the same for only the traits marked
+ *  with SetPerLifetime().
  */
 
 #ifndef MABE_TRAIT_MANAGER_HPP
 #define MABE_TRAIT_MANAGER_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
 #include <unordered_map>
 
 #include "emp/base/Ptr.hpp"
@@ -42,6 +56,70 @@ namespace mabe {
     /// Count the total number of errors encountered.
     int error_count = 0;
 
+    /// Traits bigger than this many bytes are placed after all smaller ones (if separate_large).
+    static constexpr size_t LARGE_TRAIT_BYTES = 64;
+    bool separate_large = true;
+
+    /// A precomputed way to restore a set of traits from the default image.
+    struct ResetPlan {
+      struct Run { size_t offset; size_t num_bytes; };    ///< Offsets are from the anchor trait.
+      struct Other { emp::Ptr<TraitInfo> trait_ptr; size_t id; };
+      emp::vector<Run> runs;        ///< Contiguous blocks of trivially copyable traits.
+      emp::vector<Other> others;    ///< Traits that must be copied with their own type.
+    };
+
+    emp::DataMap reset_image;           ///< DataMap with every trait at its default value.
+    bool has_image = false;             ///< Has BuildResetImage() been run?
+    emp::Ptr<TraitInfo> anchor_trait;   ///< Trait at the lowest address; runs are relative to it.
+    size_t anchor_id = 0;
+    ResetPlan reset_all;                ///< Plan for restoring every trait.
+    ResetPlan reset_lifetime;           ///< Plan for restoring only per-lifetime traits.
+
+    /// Build a reset plan for the traits that pass 'filter'.
+    template <typename FILTER_T>
+    ResetPlan BuildPlan(FILTER_T && filter) const {
+      const emp::DataLayout & layout = reset_image.GetLayout();
+      const std::byte * base = static_cast<const std::byte *>(anchor_trait->GetValuePtr(reset_image, anchor_id));
+
+      // Find where every trait lives, so runs are only merged across traits being reset.
+      struct Slot { emp::Ptr<TraitInfo> trait_ptr; size_t id; size_t offset; };
+      emp::vector<Slot> slots;
+      for (auto [name,trait_ptr] : trait_map) {
+        const size_t id = layout.GetID(name);
+        const std::byte * ptr = static_cast<const std::byte *>(trait_ptr->GetValuePtr(reset_image, id));
+        slots.push_back(Slot{trait_ptr, id, (size_t) (ptr - base)});
+      }
+      std::sort(slots.begin(), slots.end(), [](const Slot & a, const Slot & b){ return a.offset < b.offset; });
+
+      ResetPlan plan;
+      bool extend = false;          // Can the next trivial trait join the current run?
+      for (const Slot & slot : slots) {
+        if (!filter(*slot.trait_ptr) || !slot.trait_ptr->IsTriviallyCopyable()) {
+          if (filter(*slot.trait_ptr)) plan.others.push_back({slot.trait_ptr, slot.id});
+          extend = false;
+          continue;
+        }
+        const size_t end = slot.offset + slot.trait_ptr->GetByteSize();
+        if (extend) plan.runs.back().num_bytes = end - plan.runs.back().offset;  // Includes padding.
+        else plan.runs.push_back({slot.offset, end - slot.offset});
+        extend = true;
+      }
+      return plan;
+    }
+
+    void ApplyPlan(const ResetPlan & plan, emp::DataMap & data_map) const {
+      emp_assert(data_map.SameLayout(reset_image),
+                 "Resetting traits on a DataMap with a different layout.");
+      std::byte * to_base = static_cast<std::byte *>(
+        const_cast<void *>(anchor_trait->GetValuePtr(data_map, anchor_id)));
+      const std::byte * from_base = static_cast<const std::byte *>(
+        anchor_trait->GetValuePtr(reset_image, anchor_id));
+      for (const auto & run : plan.runs) {
+        std::memcpy(to_base + run.offset, from_base + run.offset, run.num_bytes);
+      }
+      for (const auto & other : plan.others) other.trait_ptr->CopyValue(reset_image, data_map, other.id);
+    }
+
   public:
     TraitManager() { }
     ~TraitManager() {
@@ -56,17 +134,94 @@ namespace mabe {
     void Lock() { locked = true; }
     void Unlock() { locked = false; }
 
-    /// Register all of the traits in the the provided DataMap.
-    void RegisterAll(emp::DataMap & data_map) {
+    /// Collect all traits whose values can be saved in a checkpoint, sorted by name so that
+    /// the order is the same for every run with the same configuration.
+    emp::vector<emp::Ptr<TraitInfo>> GetCheckpointTraits() const {
+      emp::vector<emp::Ptr<TraitInfo>> out;
       for (auto [name,trait_ptr] : trait_map) {
+        if (trait_ptr->CanCheckpoint()) out.push_back(trait_ptr);
+      }
+      std::sort(out.begin(), out.end(),
+        [](emp::Ptr<TraitInfo> a, emp::Ptr<TraitInfo> b){ return a->GetName() < b->GetName(); });
+      return out;
+    }
+
+    bool GetSeparateLarge() const { return separate_large; }
+    void SetSeparateLarge(bool in) { separate_large = in; }
+
+    /// Collect all traits in the order they should be placed in a DataMap: grouped by usage
+    /// (hot, then per-evaluation, then archival), with large or non-trivially-copyable traits
+    /// last (if separate_large), and by decreasing alignment within each group to avoid padding.
+    emp::vector<emp::Ptr<TraitInfo>> GetLayoutOrder() const {
+      auto group = [this](emp::Ptr<TraitInfo> trait_ptr) {
+        const bool is_large = !trait_ptr->IsTriviallyCopyable() ||
+                              trait_ptr->GetByteSize() > LARGE_TRAIT_BYTES;
+        if (separate_large && is_large) return (size_t) TraitInfo::Usage::ARCHIVE + 1;
+        return (size_t) trait_ptr->GetUsage();
+      };
+      emp::vector<emp::Ptr<TraitInfo>> out;
+      for (auto [name,trait_ptr] : trait_map) out.push_back(trait_ptr);
+      std::sort(out.begin(), out.end(),
+        [&group](emp::Ptr<TraitInfo> a, emp::Ptr<TraitInfo> b){
+          const size_t group_a = group(a), group_b = group(b);
+          if (group_a != group_b) return group_a < group_b;
+          if (a->GetAlignment() != b->GetAlignment()) return a->GetAlignment() > b->GetAlignment();
+          return a->GetName() < b->GetName();
+        });
+      return out;
+    }
+
+    /// Register all of the traits in the the provided DataMap, in layout order.
+    void RegisterAll(emp::DataMap & data_map) {
+      for (emp::Ptr<TraitInfo> trait_ptr : GetLayoutOrder()) {
         trait_ptr->Register(data_map);
       }
     }
 
+    /// Record the default state of all traits from a locked DataMap (after RegisterAll()).
+    void BuildResetImage(const emp::DataMap & data_map) {
+      reset_image = data_map;
+      for (auto [name,trait_ptr] : trait_map) trait_ptr->ResetToDefault(reset_image);
+      has_image = trait_map.size() > 0;
+      if (!has_image) return;
+
+      // Anchor all offsets on the trait stored first.
+      const emp::DataLayout & layout = reset_image.GetLayout();
+      const void * lowest = nullptr;
+      for (auto [name,trait_ptr] : trait_map) {
+        const size_t id = layout.GetID(name);
+        const void * ptr = trait_ptr->GetValuePtr(reset_image, id);
+        if (!lowest || std::less<const void *>()(ptr, lowest)) {
+          lowest = ptr;
+          anchor_trait = trait_ptr;
+          anchor_id = id;
+        }
+      }
+
+      reset_all = BuildPlan([](const TraitInfo &){ return true; });
+      reset_lifetime = BuildPlan([](const TraitInfo & trait){ return trait.GetPerLifetime(); });
+    }
+
+    /// Reset every trait in a DataMap to its default value.
     void ResetAll(emp::DataMap & data_map){
+      if (has_image && data_map.SameLayout(reset_image)) {
+        ApplyPlan(reset_all, data_map);
+        return;
+      }
       for (auto [name,trait_ptr] : trait_map) trait_ptr->ResetToDefault(data_map);
     }
 
+    /// Reset only the traits marked as per-lifetime to their default values.
+    void ResetLifetime(emp::DataMap & data_map){
+      if (has_image && data_map.SameLayout(reset_image)) {
+        ApplyPlan(reset_lifetime, data_map);
+        return;
+      }
+      for (auto [name,trait_ptr] : trait_map) {
+        if (trait_ptr->GetPerLifetime()) trait_ptr->ResetToDefault(data_map);
+      }
+    }
+
     /**
      *  Add a new organism trait.
      *  @param T The preferred type for this trait.
@@ -334,6 +489,18 @@ namespace mabe {
       return true;
     }
 
+    /// Would two modules interfere through their traits if run at the same time?  They do if
+    /// both use any trait that at least one of them can write to.
+    bool HasTraitConflict(emp::Ptr<MOD_T> mod1, emp::Ptr<MOD_T> mod2) const {
+      for (auto [name,trait_ptr] : trait_map) {
+        const TraitInfo::Access access1 = trait_ptr->GetAccess(mod1);
+        const TraitInfo::Access access2 = trait_ptr->GetAccess(mod2);
+        if (access1 == TraitInfo::UNKNOWN || access2 == TraitInfo::UNKNOWN) continue;
+        if (TraitInfo::CanWrite(access1) || TraitInfo::CanWrite(access2)) return true;
+      }
+      return false;
+    }
+
     /// Make sure modules are accessing traits correctly and consistently.
     bool Verify(bool verbose) {
       if (verbose) {
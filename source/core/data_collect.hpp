@@ -32,17 +32,30 @@
 #ifndef EMP_DATA_COLLECT_H
 #define EMP_DATA_COLLECT_H
 
+#include <algorithm>
 #include <functional>
 
 #include "emp/datastructs/vector_utils.hpp"
 #include "emp/tools/String.hpp"
 
 #include "../Emplode/Symbol.hpp"
+#include "../tools/Reductions.hpp"
 
 namespace mabe {
   namespace DataCollect {
     using Symbol_Var = emplode::Symbol_Var;
 
+    // Gather each value from the container in a single scan (in container order).
+    template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
+    emp::vector<DATA_T> CollectValues(const CONTAIN_T & container, FUN_T get_fun) {
+      emp::vector<DATA_T> values;
+      values.reserve(container.size());
+      for (const auto & entry : container) {
+        values.push_back( get_fun(entry) );
+      }
+      return values;
+    }
+
     // Return the value at a specified index.
     template <typename CONTAIN_T, typename FUN_T>
     Symbol_Var Index(const CONTAIN_T & container, FUN_T get_fun, const size_t index) {
@@ -148,44 +161,40 @@ namespace mabe {
     template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
     Symbol_Var Mean(const CONTAIN_T & container, FUN_T get_fun) {
       if constexpr (std::is_arithmetic_v<DATA_T>) {
-        double total = 0.0;
-        size_t count = 0;
-        for (const auto & entry : container) {
-          total += (double) get_fun(entry);
-          count++;
-        }
-        return total / count;
+        const emp::vector<DATA_T> values = CollectValues<DATA_T>(container, get_fun);
+        return Reduce::SumOf(values.size(), [&values](size_t id){ return (double) values[id]; })
+               / (double) values.size();
       }
       return emp::String{"nan"};
     }
 
     template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
     Symbol_Var Median(const CONTAIN_T & container, FUN_T get_fun) {
-      emp::vector<DATA_T> values(container.size());
-      size_t count = 0;
-      for (const auto & entry : container) {
-        values[count++] = get_fun(entry);
-      }
-      emp::Sort(values);
+      emp::vector<DATA_T> values = CollectValues<DATA_T>(container, get_fun);
+      const size_t count = values.size();
+      // Only the middle position needs to be correct; no need to sort everything.
+      std::nth_element(values.begin(), values.begin() + count/2, values.end());
       return values[count/2];
     }
 
+    // Sample variance (two passes over the values, but only one call to get_fun per entry).
+    // Sums use Reduce::SumOf() so results match however the values were computed.
+    template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
+    double CalcVariance(const CONTAIN_T & container, FUN_T get_fun) {
+      const emp::vector<DATA_T> values = CollectValues<DATA_T>(container, get_fun);
+      const double N = (double) values.size();
+      const double mean = Reduce::SumOf(values.size(), [&values](size_t id){ return (double) values[id]; }) / N;
+      const double var_total = Reduce::SumOf(values.size(), [&values, mean](size_t id){
+        const double cur_val = mean - (double) values[id];
+        return cur_val * cur_val;
+      });
+      return var_total / (N-1);
+    }
+
     template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
     Symbol_Var Variance(const CONTAIN_T & container, FUN_T get_fun) {
       if constexpr (std::is_arithmetic_v<DATA_T>) {
-        double total = 0.0;
-        const double N = (double) container.size();
-        for (const auto & entry : container) {
-          total += (double) get_fun(entry);
-        }
-        double mean = total / N;
-        double var_total = 0.0;
-        for (const auto & entry : container) {
-          double cur_val = mean - (double) get_fun(entry);
-          var_total += cur_val * cur_val;
-        }
-
-        return var_total / (N-1);
+        return CalcVariance<DATA_T>(container, get_fun);
       }
       return emp::String{"nan"};
     }
@@ -193,19 +202,7 @@ namespace mabe {
     template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
     Symbol_Var StandardDeviation(const CONTAIN_T & container, FUN_T get_fun) {
       if constexpr (std::is_arithmetic_v<DATA_T>) {
-        double total = 0.0;
-        const double N = (double) container.size();
-        for (const auto & entry : container) {
-          total += (double) get_fun(entry);
-        }
-        double mean = total / N;
-        double var_total = 0.0;
-        for (const auto & entry : container) {
-          double cur_val = mean - (double) get_fun(entry);
-          var_total += cur_val * cur_val;
-        }
-
-        return sqrt(var_total / (N-1));
+        return sqrt(CalcVariance<DATA_T>(container, get_fun));
       }
       return emp::String{"nan"};
     }
@@ -213,11 +210,8 @@ namespace mabe {
     template <typename DATA_T, typename CONTAIN_T, typename FUN_T>
     Symbol_Var Sum(const CONTAIN_T & container, FUN_T get_fun) {
       if constexpr (std::is_arithmetic_v<DATA_T>) {
-        double total = 0.0;
-        for (const auto & entry : container) {
-          total += (double) get_fun(entry);
-        }
-        return total;
+        const emp::vector<DATA_T> values = CollectValues<DATA_T>(container, get_fun);
+        return Reduce::SumOf(values.size(), [&values](size_t id){ return (double) values[id]; });
       }
       return emp::String{"nan"};
     }
@@ -0,0 +1,201 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EvalLogicTasks.hpp
+ *  @brief Organism-triggered evaluation of all nine basic logic tasks at once.
+ *
+ *  Equivalent to configuring EvalTaskNot, EvalTaskNand, EvalTaskAnd, EvalTaskOrnot,
+ *  EvalTaskOr, EvalTaskAndnot, EvalTaskNor, EvalTaskXor, and EvalTaskEqu (in that order)
+ *  with the same traits and reward type, but each IO instruction handles every task in one
+ *  pass: the latest output is compared against each input pair once, setting a bit for each
+ *  task it satisfies, and the rewards for all newly performed tasks are combined into a
+ *  single write of the fitness trait.
+ */
+
+#ifndef MABE_EVAL_LOGIC_TASKS_H
+#define MABE_EVAL_LOGIC_TASKS_H
+
+#include <cmath>
+
+#include "emp/base/array.hpp"
+
+#include "../../core/MABE.hpp"
+#include "../../core/Module.hpp"
+#include "../../orgs/VirtualCPUOrg.hpp"
+
+namespace mabe {
+
+  /// \brief Organism-triggered evaluation of the nine basic logic tasks in a single pass
+  class EvalLogicTasks : public Module {
+  public:
+    using org_t = VirtualCPUOrg;
+    using data_t = org_t::data_t;
+    using inst_func_t = org_t::inst_func_t;
+
+    enum RewardType{
+      ADD,   // Additive. New merit = old merit + reward
+      MULT,  // Multiplicative. New merit = old merit * reward
+      POW    // Power. New merit = old merit * (2 ^ reward)
+    };
+
+    // Tasks in the order their rewards are applied.
+    enum Task { NOT=0, NAND, AND, ORNOT, OR, ANDNOT, NOR, XOR, EQU, NUM_TASKS };
+    static constexpr uint32_t ALL_TASKS = (1u << NUM_TASKS) - 1;
+
+  private:
+    int pop_id = 0;                  ///< ID of the population to be evaluated
+    RewardType reward_type = ADD;    ///< How do we apply the reward to the organism's merit?
+    emp::array<double, NUM_TASKS> reward_values{1,1,1,1,1,1,1,1,1};
+
+    RequiredTrait<emp::vector<data_t>> inputs_trait{this, "input", "Organism's inputs"};
+    RequiredTrait<emp::vector<data_t>> outputs_trait{this, "output", "Organism's outputs"};
+    RequiredTrait<double> fitness_trait{this, "merit", "Organism's fitness"};
+
+    OwnedTrait<bool> not_trait{this, "not_performed", "Was NOT performed?"};
+    OwnedTrait<bool> nand_trait{this, "nand_performed", "Was NAND performed?"};
+    OwnedTrait<bool> and_trait{this, "and_performed", "Was AND performed?"};
+    OwnedTrait<bool> ornot_trait{this, "ornot_performed", "Was ORNOT performed?"};
+    OwnedTrait<bool> or_trait{this, "or_performed", "Was OR performed?"};
+    OwnedTrait<bool> andnot_trait{this, "andnot_performed", "Was ANDNOT performed?"};
+    OwnedTrait<bool> nor_trait{this, "nor_performed", "Was NOR performed?"};
+    OwnedTrait<bool> xor_trait{this, "xor_performed", "Was XOR performed?"};
+    OwnedTrait<bool> equ_trait{this, "equ_performed", "Was EQU performed?"};
+    emp::array<emp::Ptr<OwnedTrait<bool>>, NUM_TASKS> performed_traits{
+      &not_trait, &nand_trait, &and_trait, &ornot_trait, &or_trait,
+      &andnot_trait, &nor_trait, &xor_trait, &equ_trait
+    };
+
+  public:
+    EvalLogicTasks(mabe::MABE & control,
+                   emp::String name="EvalLogicTasks",
+                   emp::String desc="Evaluate organism on all nine basic logic tasks")
+      : Module(control, name, desc)
+    {
+      // Match the config names used by the individual EvalTask modules.
+      inputs_trait.SetConfigName("inputs_trait");
+      inputs_trait.SetConfigDesc("Which trait contains the organism's inputs?");
+      outputs_trait.SetConfigName("outputs_trait");
+      outputs_trait.SetConfigDesc("Which trait contains the organism's outputs?");
+      fitness_trait.SetConfigDesc("Which trait should we increase when a task is performed?");
+    }
+    ~EvalLogicTasks() { }
+
+    /// Bit mask of the tasks for which 'output' is a correct answer given 'inputs'.
+    static uint32_t CalcTaskMask(data_t output, const emp::vector<data_t> & inputs,
+                                 uint32_t tasks=ALL_TASKS) {
+      uint32_t mask = 0;
+      if (tasks & (1u << NOT)) {
+        for (data_t input : inputs) {
+          if (output == ~input) { mask |= 1u << NOT; break; }
+        }
+      }
+      tasks &= ~(1u << NOT);
+      if (!tasks) return mask;
+
+      for (size_t idx_a = 0; idx_a + 1 < inputs.size(); ++idx_a) {
+        const data_t a = inputs[idx_a];
+        for (size_t idx_b = idx_a + 1; idx_b < inputs.size(); ++idx_b) {
+          const data_t b = inputs[idx_b];
+          uint32_t found = 0;
+          found |= (uint32_t) (output == ~(a & b)) << NAND;
+          found |= (uint32_t) (output == (a & b)) << AND;
+          found |= (uint32_t) ((output == (a | ~b)) || (output == (b | ~a))) << ORNOT;
+          found |= (uint32_t) (output == (a | b)) << OR;
+          found |= (uint32_t) ((output == (a & ~b)) || (output == (b & ~a))) << ANDNOT;
+          found |= (uint32_t) (output == ~(a | b)) << NOR;
+          found |= (uint32_t) (output == (a ^ b)) << XOR;
+          found |= (uint32_t) (output == ((a & b) | ~(a | b))) << EQU;
+          mask |= found & tasks;
+          if ((mask & tasks) == tasks) return mask;   // Everything left has been found.
+        }
+      }
+      return mask;
+    }
+
+    /// Check the latest output of an organism and reward any newly performed tasks.
+    void Evaluate(Organism & org) {
+      uint32_t todo = 0;
+      for (size_t task_id = 0; task_id < NUM_TASKS; ++task_id) {
+        if (!(*performed_traits[task_id])(org)) todo |= 1u << task_id;
+      }
+      if (!todo) return;
+
+      const emp::vector<data_t> & inputs = inputs_trait(org);
+      const emp::vector<data_t> & outputs = outputs_trait(org);
+      if (inputs.size() == 0 || outputs.size() == 0) return;
+
+      const uint32_t mask = CalcTaskMask(outputs.back(), inputs, todo);
+      if (!mask) return;
+
+      // Apply rewards in task order, as the separate modules would, then write once.
+      double fitness = fitness_trait(org);
+      for (size_t task_id = 0; task_id < NUM_TASKS; ++task_id) {
+        if (!(mask & (1u << task_id))) continue;
+        const double reward = reward_values[task_id];
+        switch (reward_type) {
+          case ADD:  fitness = fitness + reward; break;
+          case MULT: fitness = fitness * reward; break;
+          case POW:  fitness = fitness * std::pow(2.0, reward); break;
+        }
+        (*performed_traits[task_id])(org) = true;
+      }
+      fitness_trait(org) = fitness;
+    }
+
+    /// Evaluate all organisms in the collection
+    double EvaluateCollection(const Collection & orgs) {
+      orgs.ForEachAlive([this](Organism & org){ Evaluate(org); });
+      return 0;
+    }
+
+    /// Set up configuration variables
+    void SetupConfig() override {
+      LinkPop(pop_id, "target_pop", "Population to evaluate.");
+      LinkVar(reward_values[NOT], "not_reward", "Reward for performing NOT.");
+      LinkVar(reward_values[NAND], "nand_reward", "Reward for performing NAND.");
+      LinkVar(reward_values[AND], "and_reward", "Reward for performing AND.");
+      LinkVar(reward_values[ORNOT], "ornot_reward", "Reward for performing ORNOT.");
+      LinkVar(reward_values[OR], "or_reward", "Reward for performing OR.");
+      LinkVar(reward_values[ANDNOT], "andnot_reward", "Reward for performing ANDNOT.");
+      LinkVar(reward_values[NOR], "nor_reward", "Reward for performing NOR.");
+      LinkVar(reward_values[XOR], "xor_reward", "Reward for performing XOR.");
+      LinkVar(reward_values[EQU], "equ_reward", "Reward for performing EQU.");
+      LinkMenu(reward_type, "reward_type", "How to apply the reward to the organism's merit?",
+               ADD,         "add",         "Additive. New merit = old merit + reward",
+               MULT,        "mult",        "Multiplicative. New merit = old merit * reward",
+               POW,         "pow",         "Power. New merit = old merit * (2 ^ reward)"
+      );
+    }
+
+    /// Registers the evaluation function in the ActionMap so it can be used by organisms
+    void SetupFunc() {
+      ActionMap & action_map = control.GetActionMap(pop_id);
+      inst_func_t func_task = [this](org_t & hw, const org_t::inst_t & /*inst*/){ Evaluate(hw); };
+      action_map.AddFunc<void, org_t&, const org_t::inst_t&>("IO", func_task);
+    }
+
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("EVAL",
+          [](EvalLogicTasks & mod, const Collection & list) { return mod.EvaluateCollection(list); },
+          "Evaluate all orgs in OrgList on all logic tasks");
+    }
+
+    void SetupModule() override {
+      SetupFunc();
+    }
+
+    /// When a new organism is placed, clear all of its "task performed" traits.
+    void OnPlacement(OrgPosition placement_pos) override {
+      Organism & org = placement_pos.Pop()[placement_pos.Pos()];
+      for (emp::Ptr<OwnedTrait<bool>> trait_ptr : performed_traits) (*trait_ptr)(org) = false;
+    }
+  };
+
+  MABE_REGISTER_MODULE(EvalLogicTasks, "Organism-triggered evaluation of all nine basic logic tasks");
+
+}
+
+#endif
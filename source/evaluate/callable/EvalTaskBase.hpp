@@ -157,12 +157,12 @@ namespace mabe {
     }
 
     /// Evaluate all organisms in the collection
-    double EvaluateCollection(Collection & orgs) {
+    double EvaluateCollection(const Collection & orgs) {
       if constexpr (NUM_ARGS == 1){
-        for (Organism & org : orgs) EvaluateOneArg(org);
+        orgs.ForEachAlive([this](Organism & org){ EvaluateOneArg(org); });
       }
       else if constexpr(NUM_ARGS == 2){
-        for (Organism & org : orgs) EvaluateTwoArg(org);
+        orgs.ForEachAlive([this](Organism & org){ EvaluateTwoArg(org); });
       }
       return 0;
     }
@@ -188,7 +188,7 @@ namespace mabe {
     // Setup member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction("EVAL",
-          [](derived_t& mod, Collection list) { 
+          [](derived_t& mod, const Collection & list) { 
             return mod.EvaluateCollection(list); 
           },
           "Evaluate all orgs in OrgList on a logic task");
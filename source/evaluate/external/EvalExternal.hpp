@@ -0,0 +1,348 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EvalExternal.hpp
+ *  @brief MABE Evaluation module that hands batches of organisms to an external process.
+ *
+ *  Genomes (the text of 'genome_trait') are written into a POSIX shared-memory region, and an
+ *  external simulator writes back 'num_results' doubles per organism, stored in the 'results'
+ *  trait (the first also in 'fitness').  Up to 'num_slots' batches can be in flight at once:
+ *  SUBMIT(orgs) returns as soon as the genomes are written, COLLECT() applies any finished
+ *  batches without waiting, and WAIT() blocks until all of them are done.  EVAL(orgs) does all
+ *  three and returns the maximum fitness.  Results for organisms that died while their batch
+ *  was in flight are dropped.
+ *
+ *  Shared-memory layout (native byte order; all offsets in bytes):
+ *
+ *    Region header (64 bytes, at offset 0):
+ *       0  char[8]   magic "MABE-EXT" (written last, once the region is ready)
+ *       8  uint32    version (1)
+ *      12  uint32    num_slots
+ *      16  uint32    max_orgs       (per slot)
+ *      20  uint32    num_results    (doubles per organism)
+ *      24  uint64    slot_bytes     (distance between slots; a multiple of 64)
+ *      32  uint64    genome_bytes   (genome text capacity per slot)
+ *      40  uint32    shutdown       (set to 1 when MABE exits)
+ *
+ *    Slot i, at offset 64 + i * slot_bytes:
+ *       0  uint32    state          (0 = free, 1 = submitted by MABE, 2 = done by external)
+ *       4  uint32    num_orgs
+ *       8  uint64    batch_id       (1, 2, 3, ...; batch b always uses slot (b-1) % num_slots)
+ *      16  uint64    genome_bytes_used
+ *      32  uint64[max_orgs + 1]                 genome offsets into the text area
+ *          double[max_orgs * num_results]       results, organism-major
+ *          char[genome_bytes]                   genome text (organism i is [off[i], off[i+1]))
+ *
+ *  The external process waits for state == 1 (acquire), evaluates the batch, writes results,
+ *  and then stores state = 2 (release).  MABE polls for state 2 and resets it to 0.
+ *
+ *  Only available on POSIX systems; elsewhere the module reports an error on use.
+ */
+
+#ifndef MABE_EVAL_EXTERNAL_H
+#define MABE_EVAL_EXTERNAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MABE_EVAL_EXTERNAL_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "../../core/MABE.hpp"
+#include "../../core/Module.hpp"
+
+namespace mabe {
+
+  class EvalExternal : public Module {
+  private:
+    struct RegionHeader {
+      char magic[8];
+      uint32_t version;
+      uint32_t num_slots;
+      uint32_t max_orgs;
+      uint32_t num_results;
+      uint64_t slot_bytes;
+      uint64_t genome_bytes;
+      uint32_t shutdown;
+      uint32_t reserved[5];
+    };
+    static_assert(sizeof(RegionHeader) == 64);
+
+    struct SlotHeader {
+      uint32_t state;
+      uint32_t num_orgs;
+      uint64_t batch_id;
+      uint64_t genome_bytes_used;
+      uint64_t reserved;
+    };
+    static_assert(sizeof(SlotHeader) == 32);
+
+    enum SlotState : uint32_t { SLOT_FREE=0, SLOT_SUBMITTED, SLOT_DONE };
+
+    /// A batch written to shared memory and not yet collected.
+    struct Batch {
+      uint64_t id;
+      size_t slot;
+      emp::vector<emp::Ptr<Organism>> orgs;
+    };
+
+    emp::String shm_name = "/mabe_external";  ///< Name of the shared-memory region.
+    size_t num_slots = 4;          ///< Batches that can be in flight at once.
+    size_t max_orgs = 1024;        ///< Organisms per batch.
+    size_t genome_bytes = 1 << 20; ///< Genome text capacity per batch.
+    size_t num_results = 1;        ///< Values returned for each organism.
+    double timeout = 60.0;         ///< Seconds to wait for a batch before giving up.
+
+    RequiredTraitAsString genome_trait{this, "genome", "Trait with the genome text to send"};
+    OwnedMultiTrait<double> results_trait{this, "results", "Values returned by the external evaluator",
+                                          AsConfig(num_results)};
+    OwnedTrait<double> fitness_trait{this, "fitness", "First value returned by the external evaluator"};
+
+    std::byte * region = nullptr;
+    size_t region_bytes = 0;
+    size_t slot_bytes = 0;
+    uint64_t next_batch_id = 1;
+    std::deque<Batch> batches;                          ///< In-flight batches, oldest first.
+    std::unordered_map<Organism *, uint64_t> pending;   ///< Latest batch for each live organism.
+
+    RegionHeader & GetHeader() { return *reinterpret_cast<RegionHeader *>(region); }
+    std::byte * GetSlot(size_t slot) { return region + sizeof(RegionHeader) + slot * slot_bytes; }
+    SlotHeader & GetSlotHeader(size_t slot) { return *reinterpret_cast<SlotHeader *>(GetSlot(slot)); }
+    uint64_t * GetOffsets(size_t slot) {
+      return reinterpret_cast<uint64_t *>(GetSlot(slot) + sizeof(SlotHeader));
+    }
+    double * GetResults(size_t slot) { return reinterpret_cast<double *>(GetOffsets(slot) + max_orgs + 1); }
+    char * GetText(size_t slot) { return reinterpret_cast<char *>(GetResults(slot) + max_orgs * num_results); }
+    std::atomic_ref<uint32_t> GetState(size_t slot) { return std::atomic_ref<uint32_t>(GetSlotHeader(slot).state); }
+
+#ifdef MABE_EVAL_EXTERNAL_POSIX
+    bool OpenRegion() {
+      const size_t slot_data = sizeof(SlotHeader) + sizeof(uint64_t) * (max_orgs + 1)
+                             + sizeof(double) * max_orgs * num_results + genome_bytes;
+      slot_bytes = (slot_data + 63) / 64 * 64;
+      region_bytes = sizeof(RegionHeader) + num_slots * slot_bytes;
+
+      shm_unlink(shm_name.c_str());     // Always start from a fresh region.
+      const int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd < 0) return false;
+      if (ftruncate(fd, (off_t) region_bytes) != 0) { close(fd); return false; }
+      void * ptr = mmap(nullptr, region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      if (ptr == MAP_FAILED) return false;
+      region = static_cast<std::byte *>(ptr);
+
+      RegionHeader & header = GetHeader();         // New shared memory is zero filled.
+      header.version = 1;
+      header.num_slots = (uint32_t) num_slots;
+      header.max_orgs = (uint32_t) max_orgs;
+      header.num_results = (uint32_t) num_results;
+      header.slot_bytes = slot_bytes;
+      header.genome_bytes = genome_bytes;
+      std::atomic_thread_fence(std::memory_order_release);
+      std::memcpy(header.magic, "MABE-EXT", 8);
+      return true;
+    }
+
+    void CloseRegion() {
+      if (!region) return;
+      std::atomic_ref<uint32_t>(GetHeader().shutdown).store(1, std::memory_order_release);
+      munmap(region, region_bytes);
+      shm_unlink(shm_name.c_str());
+      region = nullptr;
+    }
+#else
+    bool OpenRegion() { return false; }
+    void CloseRegion() { }
+#endif
+
+    /// Write the organisms in 'orgs' into the next slot and mark it submitted; returns false
+    /// (sending nothing) if no slot became free in time.
+    bool SendBatch(emp::vector<emp::Ptr<Organism>> & orgs, const emp::vector<emp::String> & genomes) {
+      if (batches.size() == num_slots) Collect(1);   // Make room by finishing the oldest batch.
+      if (batches.size() == num_slots) { orgs.resize(0); return false; }
+      const uint64_t batch_id = next_batch_id++;
+      const size_t slot = (batch_id - 1) % num_slots;
+      emp_assert(GetState(slot).load() == SLOT_FREE);
+
+      uint64_t * offsets = GetOffsets(slot);
+      char * text = GetText(slot);
+      size_t used = 0;
+      for (size_t i = 0; i < genomes.size(); ++i) {
+        offsets[i] = used;
+        std::memcpy(text + used, genomes[i].data(), genomes[i].size());
+        used += genomes[i].size();
+        pending[orgs[i].Raw()] = batch_id;
+      }
+      offsets[genomes.size()] = used;
+
+      SlotHeader & slot_header = GetSlotHeader(slot);
+      slot_header.num_orgs = (uint32_t) genomes.size();
+      slot_header.batch_id = batch_id;
+      slot_header.genome_bytes_used = used;
+      GetState(slot).store(SLOT_SUBMITTED, std::memory_order_release);
+      batches.push_back(Batch{batch_id, slot, std::move(orgs)});
+      orgs.resize(0);
+      return true;
+    }
+
+    /// Wait for the oldest batch to finish; returns false on timeout.
+    bool WaitOldest() {
+      auto state = GetState(batches.front().slot);
+      if (state.load(std::memory_order_acquire) == SLOT_DONE) return true;
+      const auto start = std::chrono::steady_clock::now();
+      auto delay = std::chrono::microseconds(10);
+      while (state.load(std::memory_order_acquire) != SLOT_DONE) {
+        if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout) {
+          emp::notify::Error("Module '", GetName(), "' timed out waiting for external batch ",
+                             batches.front().id, ".");
+          return false;
+        }
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, std::chrono::microseconds(1000));
+      }
+      return true;
+    }
+
+  public:
+    EvalExternal(mabe::MABE & control,
+                 emp::String name="EvalExternal",
+                 emp::String desc="Evaluate organisms in batches with an external process.")
+      : Module(control, name, desc)
+    {
+      SetEvaluateMod(true);
+    }
+    ~EvalExternal() { CloseRegion(); }
+
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("EVAL",
+        [](EvalExternal & mod, const Collection & orgs) { return mod.Evaluate(orgs); },
+        "Evaluate organisms externally, waiting for results; return the max fitness.");
+      info.AddMemberFunction("SUBMIT",
+        [](EvalExternal & mod, const Collection & orgs) { return (double) mod.Submit(orgs); },
+        "Send organisms for external evaluation without waiting; return number sent.");
+      info.AddMemberFunction("COLLECT",
+        [](EvalExternal & mod) { return (double) mod.Collect(0); },
+        "Apply results from finished external batches; return number of organisms updated.");
+      info.AddMemberFunction("WAIT",
+        [](EvalExternal & mod) { return (double) mod.Collect(emp::MAX_SIZE_T); },
+        "Wait for all external batches and apply results; return number of organisms updated.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(shm_name, "shm_name", "Name of the POSIX shared-memory region (e.g., \"/mabe_external\").");
+      LinkVar(num_slots, "num_slots", "Number of batches that can be in flight at once.");
+      LinkVar(max_orgs, "max_orgs", "Maximum organisms per batch.");
+      LinkVar(genome_bytes, "genome_bytes", "Genome text capacity (bytes) for each batch.");
+      LinkVar(num_results, "num_results", "Number of values the external process returns per organism.");
+      LinkVar(timeout, "timeout", "Seconds to wait for a batch before reporting an error.");
+    }
+
+    void SetupModule() override {
+      if (num_slots == 0) num_slots = 1;
+      if (max_orgs == 0) max_orgs = 1;
+      if (num_results == 0) {
+        emp::notify::Error("Module '", GetName(), "' needs num_results of at least 1.");
+        return;
+      }
+      if (!OpenRegion()) {
+        emp::notify::Error("Module '", GetName(), "' could not create shared memory '", shm_name, "'.");
+      }
+    }
+
+    /// Send all living organisms in 'orgs' for evaluation; returns how many were sent.
+    size_t Submit(const Collection & orgs) {
+      if (!region) {
+        emp::notify::Error("Module '", GetName(), "' has no shared memory to evaluate with.");
+        return 0;
+      }
+      emp::vector<emp::Ptr<Organism>> batch_orgs;
+      emp::vector<emp::String> genomes;
+      size_t text_bytes = 0;
+      size_t num_sent = 0;
+      orgs.ForEachAlive([&](Organism & org) {
+        org.GenerateOutput();
+        emp::String genome = genome_trait.Get(org);
+        if (genome.size() > genome_bytes) {
+          emp::notify::Error("Module '", GetName(), "' genome of ", genome.size(),
+                             " bytes is larger than genome_bytes (", genome_bytes, ").");
+          return;
+        }
+        if (genomes.size() == max_orgs || text_bytes + genome.size() > genome_bytes) {
+          if (SendBatch(batch_orgs, genomes)) num_sent += genomes.size();
+          genomes.resize(0);
+          text_bytes = 0;
+        }
+        text_bytes += genome.size();
+        genomes.push_back(std::move(genome));
+        batch_orgs.push_back(&org);
+      });
+      if (genomes.size() && SendBatch(batch_orgs, genomes)) num_sent += genomes.size();
+      return num_sent;
+    }
+
+    /// Apply finished batches in submission order, first waiting for up to 'min_batches' of
+    /// them; returns the number of organisms updated.
+    size_t Collect(size_t min_batches) {
+      size_t num_updated = 0;
+      while (batches.size()) {
+        Batch & batch = batches.front();
+        const bool done = GetState(batch.slot).load(std::memory_order_acquire) == SLOT_DONE;
+        if (!done && (min_batches == 0 || !WaitOldest())) break;
+
+        const double * results = GetResults(batch.slot);
+        for (size_t i = 0; i < batch.orgs.size(); ++i) {
+          auto it = pending.find(batch.orgs[i].Raw());
+          if (it == pending.end() || it->second != batch.id) continue;  // Died or resubmitted.
+          pending.erase(it);
+          std::span<double> org_results = results_trait(*batch.orgs[i]);
+          std::copy(results + i * num_results, results + (i+1) * num_results, org_results.begin());
+          fitness_trait(*batch.orgs[i]) = org_results[0];
+          ++num_updated;
+        }
+        GetState(batch.slot).store(SLOT_FREE, std::memory_order_release);
+        batches.pop_front();
+        if (min_batches) --min_batches;
+      }
+      return num_updated;
+    }
+
+    double Evaluate(const Collection & orgs) {
+      Submit(orgs);
+      Collect(emp::MAX_SIZE_T);
+      double max_fitness = 0.0;
+      bool first = true;
+      orgs.ForEachAlive([&](Organism & org) {
+        const double fitness = fitness_trait(org);
+        if (first || fitness > max_fitness) max_fitness = fitness;
+        first = false;
+      });
+      return max_fitness;
+    }
+
+    void BeforeDeath(OrgPosition pos) override {
+      if (pending.size()) pending.erase(pos.OrgPtr().Raw());
+    }
+
+    void BeforeExit() override {
+      Collect(emp::MAX_SIZE_T);
+      CloseRegion();
+    }
+  };
+
+  MABE_REGISTER_MODULE(EvalExternal, "Evaluate organisms in batches by an external process over shared memory.");
+}
+
+#endif
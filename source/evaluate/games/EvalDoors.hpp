@@ -49,24 +49,60 @@ namespace mabe {
     emp::vector<emp::String> doors_correct_trait_vec;     ///< Names of doors correct traits
   };
 
+  /// \brief DataMap IDs of all the traits used in EvalDoors, found once the DataMap is locked
+  struct EvalDoors_TraitIDs{
+    size_t score = emp::MAX_SIZE_T;
+    size_t accuracy = emp::MAX_SIZE_T;
+    size_t state = emp::MAX_SIZE_T;
+    size_t door_rooms = emp::MAX_SIZE_T;
+    size_t exit_rooms = emp::MAX_SIZE_T;
+    size_t correct_doors = emp::MAX_SIZE_T;
+    size_t incorrect_doors = emp::MAX_SIZE_T;
+    size_t correct_exits = emp::MAX_SIZE_T;
+    size_t incorrect_exits = emp::MAX_SIZE_T;
+    emp::vector<size_t> doors_taken_vec;
+    emp::vector<size_t> doors_correct_vec;
+
+    void Setup(const emp::DataMap& dmap, const EvalDoors_TraitNames& names){
+      score = dmap.GetID(names.score_trait);
+      accuracy = dmap.GetID(names.accuracy_trait);
+      state = dmap.GetID(names.state_trait);
+      door_rooms = dmap.GetID(names.door_rooms_trait);
+      exit_rooms = dmap.GetID(names.exit_rooms_trait);
+      correct_doors = dmap.GetID(names.correct_doors_trait);
+      incorrect_doors = dmap.GetID(names.incorrect_doors_trait);
+      correct_exits = dmap.GetID(names.correct_exits_trait);
+      incorrect_exits = dmap.GetID(names.incorrect_exits_trait);
+      doors_taken_vec.clear();
+      doors_correct_vec.clear();
+      for(const emp::String& name : names.doors_taken_trait_vec){
+        doors_taken_vec.push_back(dmap.GetID(name));
+      }
+      for(const emp::String& name : names.doors_correct_trait_vec){
+        doors_correct_vec.push_back(dmap.GetID(name));
+      }
+    }
+  };
+
   /// \brief State of a single organism's progress on the doors task
+  ///
+  /// Rooms are tracked by the index of their correct door (0 for an "exit room"), so moves
+  /// only compare indices.  Per-door cues and counts share one buffer, which is kept (and
+  /// just refilled) when the state is reset.
   struct DoorsState{
     using data_t = uint32_t;
 
     bool initialized = false;            ///< Has this state been initialized?
-    emp::vector<data_t> prev_room_vec;   ///< Cues from rooms previously visited
-    emp::vector<data_t> door_choice_vec; ///< Doors the org has chosen
     double score = 0;                    ///< Summarized score of the organism 
-    emp::vector<data_t> cue_vec;         ///< Values of each cue (random or not)
-    data_t current_cue;                  ///< Cue of the current room the organism is in
+    size_t current_door = 0;             ///< Correct door of the current room (0 = exit room)
+    size_t prev_door = 0;                ///< Correct door of the previously visited room
     size_t correct_doors_taken = 0;      ///< Num times the org entered the correct door
     size_t incorrect_doors_taken = 0;    ///< Num times the org entered the wrong door
     size_t correct_exits_taken = 0;      ///< Num times org took exit when it should have
     size_t incorrect_exits_taken = 0;    ///< Num times org took exit when it should NOT have
     size_t door_rooms_visited = 0;       ///< Num "door" rooms the organism has visited
     size_t exit_rooms_visited = 0;       ///< Num "exit" rooms the organism has visited
-    emp::vector<size_t> doors_taken_vec; ///< Num times each door was taken
-    emp::vector<size_t> doors_correct_vec; ///< Num times each door was taken correctly
+    emp::vector<data_t> door_data;       ///< Cue, times taken, and times correct of each door
 
     DoorsState() { }
     DoorsState(const DoorsState&) { } // Ignore copy, just reset
@@ -81,6 +117,14 @@ namespace mabe {
       score = 0;
       return *this;
     }
+
+    size_t GetNumDoors() const { return door_data.size() / 3; }
+    data_t& Cue(size_t door_idx) { return door_data[door_idx]; }
+    data_t Cue(size_t door_idx) const { return door_data[door_idx]; }
+    data_t& TimesTaken(size_t door_idx) { return door_data[GetNumDoors() + door_idx]; }
+    data_t TimesTaken(size_t door_idx) const { return door_data[GetNumDoors() + door_idx]; }
+    data_t& TimesCorrect(size_t door_idx) { return door_data[2*GetNumDoors() + door_idx]; }
+    data_t TimesCorrect(size_t door_idx) const { return door_data[2*GetNumDoors() + door_idx]; }
   };
 
   /// \brief Handles all evaluation of the doors task
@@ -91,23 +135,21 @@ namespace mabe {
   protected:
     emp::Random& rand;                 ///< Reference to main MABE random number generator
     emp::vector<int> starting_cue_vec; ///< Set cue values or random cue indicators (-1)
+    emp::vector<DoorsState::data_t> base_door_data; ///< Set cues with all counts zeroed
+    emp::vector<size_t> random_cue_ids;             ///< Doors whose cue is random each trial
     const size_t exit_cue_idx = 0;     ///< Index of the exit in the cue vector 
     
     /// Move the organism through the "exit" door, going back one room  
     double TakeExit(DoorsState& state) {
-      if(!state.initialized) InitializeState(state);
-      // Update bookkeeping
-      state.prev_room_vec.push_back(state.current_cue);
-      state.door_choice_vec.push_back(state.cue_vec[exit_cue_idx]);
-      // Update score vars and current cue
-      if (state.current_cue == state.cue_vec[exit_cue_idx]) {
+      if (state.current_door == exit_cue_idx) {
         state.correct_exits_taken++;
-        state.current_cue = *(state.prev_room_vec.rbegin() + 1); // Return to previous room
-        state.doors_correct_vec[exit_cue_idx]++;
+        state.TimesCorrect(exit_cue_idx)++;
+        std::swap(state.current_door, state.prev_door); // Return to previous room
       }
       else {
         state.incorrect_exits_taken++;
-        state.current_cue = state.cue_vec[exit_cue_idx];
+        state.prev_door = state.current_door;
+        state.current_door = exit_cue_idx;
       }
       return UpdateScore(state);
     }
@@ -134,19 +176,16 @@ namespace mabe {
 
     /// Updates the records in the organism's traits
     void UpdateRecords(const DoorsState& state, org_t& org, 
-        const EvalDoors_TraitNames& trait_names){
-      org.SetTrait<size_t>(trait_names.door_rooms_trait, state.door_rooms_visited);
-      org.SetTrait<size_t>(trait_names.exit_rooms_trait, state.exit_rooms_visited);
-      org.SetTrait<size_t>(trait_names.correct_doors_trait, state.correct_doors_taken);
-      org.SetTrait<size_t>(trait_names.incorrect_doors_trait, state.incorrect_doors_taken);
-      org.SetTrait<size_t>(trait_names.correct_exits_trait, state.correct_exits_taken);
-      org.SetTrait<size_t>(trait_names.incorrect_exits_trait, state.incorrect_exits_taken);
+        const EvalDoors_TraitIDs& trait_ids){
+      org.GetTrait<size_t>(trait_ids.door_rooms) = state.door_rooms_visited;
+      org.GetTrait<size_t>(trait_ids.exit_rooms) = state.exit_rooms_visited;
+      org.GetTrait<size_t>(trait_ids.correct_doors) = state.correct_doors_taken;
+      org.GetTrait<size_t>(trait_ids.incorrect_doors) = state.incorrect_doors_taken;
+      org.GetTrait<size_t>(trait_ids.correct_exits) = state.correct_exits_taken;
+      org.GetTrait<size_t>(trait_ids.incorrect_exits) = state.incorrect_exits_taken;
       for(size_t door_idx = 0; door_idx < GetNumDoors(); ++door_idx){
-        org.SetTrait<size_t>(trait_names.doors_taken_trait_vec[door_idx], 
-            state.doors_taken_vec[door_idx]);
-        org.SetTrait<size_t>(trait_names.doors_correct_trait_vec[door_idx], 
-            state.doors_correct_vec[door_idx]);
-
+        org.GetTrait<size_t>(trait_ids.doors_taken_vec[door_idx]) = state.TimesTaken(door_idx);
+        org.GetTrait<size_t>(trait_ids.doors_correct_vec[door_idx]) = state.TimesCorrect(door_idx);
       }
     }
 
@@ -175,12 +214,20 @@ namespace mabe {
         starting_cue_vec.push_back(cue);
       }
       std::cout << std::endl;
+
+      // Precompute the set cues (shared by every trial) and which cues must be drawn.
+      base_door_data.assign(3 * GetNumDoors(), 0);
+      random_cue_ids.clear();
+      for(size_t idx = 0; idx < GetNumDoors(); ++idx){
+        if(starting_cue_vec[idx] >= 0) base_door_data[idx] = starting_cue_vec[idx];
+        else random_cue_ids.push_back(idx);
+      }
     }
 
-    /// Fetch a random door cue from the set
-    DoorsState::data_t GetRandomCue(const DoorsState& state){
-      // Offset so we don't return the exit cue
-      return state.cue_vec[(rand.GetUInt() % (GetNumDoors() - 1)) + 1];
+    /// Fetch a random door (other than the exit) to be the correct door of the next room
+    size_t GetRandomDoor(){
+      // Offset so we don't return the exit
+      return (rand.GetUInt() % (GetNumDoors() - 1)) + 1;
     }
 
     /// Initialize all properties of a DoorsState to prepare it for the task
@@ -193,59 +240,46 @@ namespace mabe {
       state.incorrect_exits_taken = 0; 
       state.door_rooms_visited = 0; 
       state.exit_rooms_visited = 0; 
-      state.doors_taken_vec.resize(GetNumDoors(), 0);
-      state.doors_correct_vec.resize(GetNumDoors(), 0);
-      // Randomize the cue vector according to configuration
-      state.cue_vec.resize(GetNumDoors());
-      // First pass, add all set cues 
-      for(size_t idx = 0; idx < GetNumDoors(); ++idx){
-        if(starting_cue_vec[idx] >= 0){
-          state.cue_vec[idx] = starting_cue_vec[idx];
-        }
-      }
-      // Second pass, randomize other cues
-      for(size_t idx = 0; idx < GetNumDoors(); ++idx){
-        if(starting_cue_vec[idx] == -1){
-          bool pass = false;
-          while(!pass){
-            pass = true;
-            state.cue_vec[idx] = rand.GetUInt();
-            // Ensure we didn't choose an existing cue
-            for(size_t idx_2 = 0; idx_2 < GetNumDoors(); ++idx_2){
-              if(idx != idx_2 && state.cue_vec[idx] == state.cue_vec[idx_2]){
-                pass = false;
-                break;
-              }
+      // Start from the set cues with zeroed counts (reusing the state's buffer)
+      state.door_data.assign(base_door_data.begin(), base_door_data.end());
+      // Randomize other cues, ensuring we don't choose an existing cue
+      for(size_t idx : random_cue_ids){
+        bool pass = false;
+        while(!pass){
+          pass = true;
+          state.Cue(idx) = rand.GetUInt();
+          for(size_t idx_2 = 0; idx_2 < GetNumDoors(); ++idx_2){
+            if(idx != idx_2 && state.Cue(idx) == state.Cue(idx_2)){
+              pass = false;
+              break;
             }
           }
         }
       }
-      // Set the initial cue
-      state.current_cue = GetRandomCue(state);
+      // Set the initial room
+      state.current_door = GetRandomDoor();
+      state.prev_door = state.current_door;
     }
     
     /// Move the organism through its chosen door
-    double Move(DoorsState& state, DoorsState::data_t door_idx){
+    double Move(DoorsState& state, size_t door_idx){
       if(!state.initialized) InitializeState(state);
       // Increase bookkeeping variables
-      state.doors_taken_vec[door_idx]++;
-      if(state.current_cue == state.cue_vec[exit_cue_idx]) state.exit_rooms_visited++;
+      state.TimesTaken(door_idx)++;
+      if(state.current_door == exit_cue_idx) state.exit_rooms_visited++;
       else state.door_rooms_visited++;
       if(door_idx == exit_cue_idx) return TakeExit(state);
+      state.prev_door = state.current_door;
       // Correct door -> Reward and move on!
-      if(state.cue_vec[door_idx] == state.current_cue){
+      if(door_idx == state.current_door){
         state.correct_doors_taken++;
-        state.doors_correct_vec[door_idx]++;
-        state.prev_room_vec.push_back(state.current_cue);
-        state.door_choice_vec.push_back(state.cue_vec[door_idx]);
-        state.current_cue = GetRandomCue(state);
+        state.TimesCorrect(door_idx)++;
+        state.current_door = GetRandomDoor();
       }
       // Wrong door -> Penalize and move into "wrong" room
       else{
         state.incorrect_doors_taken++;
-        state.prev_room_vec.push_back(state.current_cue);
-        state.door_choice_vec.push_back(state.cue_vec[door_idx]);
-        state.current_cue = state.cue_vec[exit_cue_idx];
+        state.current_door = exit_cue_idx;
       }
       return UpdateScore(state);
     }
@@ -257,7 +291,7 @@ namespace mabe {
     //  organism's first action, so we may need to initialize it
     DoorsState::data_t Sense(DoorsState& state) { 
       if(!state.initialized) InitializeState(state);
-      return state.current_cue;
+      return state.Cue(state.current_door);
     }
   };
 
@@ -277,6 +311,7 @@ namespace mabe {
                                are used as is, while -1 gives a random value for each trial */
     EvalDoors_TraitNames trait_names;   /**<  Struct holding all of the trait names to keep 
                                               things tidy */
+    EvalDoors_TraitIDs trait_ids;       ///< DataMap IDs of the traits, for fast access
     
   public:
     EvalDoors(mabe::MABE & control,
@@ -346,6 +381,11 @@ namespace mabe {
       }
       SetupInstructions();
     }
+
+    /// Look up trait IDs once, so instructions never search for traits by name
+    void SetupDataMap(emp::DataMap & dmap) override {
+      trait_ids.Setup(dmap, trait_names);
+    }
     
     /// Package actions (e.g., sense, take door N) into instructions and provide them to the 
     /// organisms via ActionMap
@@ -354,11 +394,10 @@ namespace mabe {
       // Add the correct number of door instructions
       for(size_t door_idx = 0; door_idx < evaluator.GetNumDoors(); ++door_idx){
         inst_func_t func_move = [this, door_idx](org_t& hw, const org_t::inst_t& /*inst*/){
-          DoorsState& state = hw.GetTrait<DoorsState>(trait_names.state_trait);
-          double score = evaluator.Move(state, door_idx);
-          hw.SetTrait<double>(trait_names.score_trait, score);
-          hw.SetTrait<double>(trait_names.accuracy_trait, evaluator.GetDoorAccuracy(state));
-          evaluator.UpdateRecords(state, hw, trait_names);
+          DoorsState& state = hw.GetTrait<DoorsState>(trait_ids.state);
+          hw.GetTrait<double>(trait_ids.score) = evaluator.Move(state, door_idx);
+          hw.GetTrait<double>(trait_ids.accuracy) = evaluator.GetDoorAccuracy(state);
+          evaluator.UpdateRecords(state, hw, trait_ids);
         };
         std::stringstream sstr;
         sstr << "doors-move-" << door_idx;
@@ -367,7 +406,7 @@ namespace mabe {
       }
       { // Sense 
         inst_func_t func_sense = [this](org_t& hw, const org_t::inst_t& inst){
-          uint32_t val = evaluator.Sense(hw.GetTrait<DoorsState>(trait_names.state_trait));
+          uint32_t val = evaluator.Sense(hw.GetTrait<DoorsState>(trait_ids.state));
           size_t reg_idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
           hw.regs[reg_idx] = val;
         };
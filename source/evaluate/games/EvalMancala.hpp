@@ -5,15 +5,42 @@
  *
  *  @file  EvalMancala.hpp
  *  @brief MABE Evaluation module that has organisms play Mancala.
+ *
+ *  Organisms can play against random moves (optionally on the thread pool, using a random
+ *  stream per organism), or against each other in a round-robin or Swiss tournament.
+ *  Tournament rounds are sets of disjoint pairings, so each round's games run in parallel
+ *  without two threads ever driving the same organism.
+ *
+ *  Against random moves, 'bound_top' and 'bound_min' turn on bounded evaluation (see
+ *  tools/FitnessCutoff.hpp): an organism whose first game leaves it unable to reach the cutoff,
+ *  even with a perfect second game, skips that game and records the upper bound as fitness.
+ *  For elite selection, set bound_top to the selector's top_count.
+ *
+ *  Two optional caches skip repeated work when an organism's moves depend only on its genome
+ *  and the board (as for organisms without hidden state or randomness):
+ *  - 'game_cache' remembers up to that many tournament game results, keyed by both players'
+ *    genome fingerprints and who started, so rematches between unchanged genotypes (common
+ *    with elitism) cost a lookup.  A game and the same game seen from the other side share
+ *    an entry.  Games against random moves differ every time, so they are never cached.
+ *  - 'move_table' remembers, during one evaluation, each organism's move for each board it has
+ *    seen, so boards that recur across its games (openings in particular) are not re-run.
  */
 
 #ifndef MABE_EVAL_MANCALA_HPP
 #define MABE_EVAL_MANCALA_HPP
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
 #include "emp/games/Mancala.hpp"
 
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
+#include "../../tools/FitnessCutoff.hpp"
+#include "../../tools/GenomeHash.hpp"
+#include "../../tools/MemoCache.hpp"
 
 namespace mabe {
 
@@ -31,10 +58,26 @@ namespace mabe {
       RANDOM_MOVES,     // Opponent will always choose a random, legal move.
       AI,               // Opponent is a human-crafted AI.
       RANDOM_ORG,       // Opponent is a random organism from the population.
+      ROUND_ROBIN,      // Every organism plays every other organism.
+      SWISS,            // Organisms with similar records are paired for a set number of rounds.
       UNKNOWN
     };
 
+    static constexpr size_t GAME_SALT = 0x3a9c1;   ///< Random-stream key for per-org games.
+    static constexpr double MAX_GAME_FITNESS = 48.0; ///< All 48 stones and no illegal moves.
+
     Opponent opponent_type;
+    size_t swiss_rounds = 5;      ///< Number of rounds to play in a Swiss tournament.
+    bool game_streams = false;    ///< Give each organism its own random stream (and thread)?
+    size_t bound_top = 0;         ///< Only finish games for organisms that could be this high.
+    double bound_min = std::numeric_limits<double>::lowest();  ///< Only finish if this is possible.
+    FitnessCutoff cutoff;         ///< Current cutoff for bounded evaluation.
+    size_t game_cache = 0;        ///< Max tournament game results to remember (0 = off).
+    bool move_table = false;      ///< Remember each organism's move per board during an evaluation?
+
+    /// Moves an organism has chosen during the current evaluation, keyed by board hash.
+    using move_table_t = std::unordered_map<uint64_t, uint8_t>;
+    emp::vector<move_table_t> move_tables;  ///< One per organism being evaluated.
 
   public:
     EvalMancala(mabe::MABE & control,
@@ -49,7 +92,7 @@ namespace mabe {
     // Setup member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction("EVAL",
-                             [](EvalMancala & mod, Collection orgs) { return mod.Evaluate(orgs); },
+                             [](EvalMancala & mod, const Collection & orgs) { return mod.Evaluate(orgs); },
                              "Evaluate organism's ability to play the game Mancala.");
       info.AddMemberFunction("TRACE",
                              [](EvalMancala & mod, Collection orgs, const emp::String & filename) {
@@ -58,25 +101,52 @@ namespace mabe {
                                 return orgs.GetSize();
                               },
                              "Trace the Mancala game-play during evaluation.");
+      info.AddMemberFunction("CACHE_HIT_RATE",
+                             [](EvalMancala & mod) { return mod.results_cache.GetHitRate(); },
+                             "Return the fraction of tournament games found in the game cache.");
+      info.AddMemberFunction("NUM_BOUNDED",
+                             [](EvalMancala & mod) { return mod.cutoff.GetNumStopped(); },
+                             "Return the number of evaluations stopped early by bounded evaluation.");
     }
 
     void SetupConfig() override {
       LinkMenu(opponent_type, "opponent_type", "Which type of opponent should organisms face?",
                RANDOM_MOVES, "random", "Always choose a random, legal move.",
                AI, "ai", "Human supplied (but not very good) AI",
-               RANDOM_ORG, "random_org", "Pick another random organism from collection."
+               RANDOM_ORG, "random_org", "Pick another random organism from collection.",
+               ROUND_ROBIN, "round_robin", "Play every other organism in the collection.",
+               SWISS, "swiss", "Play swiss_rounds rounds against organisms with similar records."
       );
+      LinkVar(swiss_rounds, "swiss_rounds", "Number of rounds in a Swiss tournament.");
+      LinkVar(game_streams, "game_streams",
+              "Against random moves, use a separate random stream per organism so games can run in parallel across num_threads.");
+      LinkVar(bound_top, "bound_top",
+              "Against random moves, stop evaluating organisms that cannot reach the top bound_top (0 = off).");
+      LinkVar(bound_min, "bound_min",
+              "Against random moves, stop evaluating organisms that cannot reach this fitness.");
+      LinkVar(game_cache, "game_cache",
+              "Tournament game results to remember by both players' genomes (0 = off; only if moves depend only on genome and board).");
+      LinkVar(move_table, "move_table",
+              "Remember each organism's move for each board seen during an evaluation? (only if moves depend only on genome and board)");
     }
 
-    // Determine the next move of an organism.
-    size_t EvalMove(emp::Mancala & game, Organism & org) {
+    // Determine the next move of an organism; if a move table is given, reuse its move for
+    // any board it has already seen.
+    size_t EvalMove(emp::Mancala & game, Organism & org, emp::Ptr<move_table_t> moves=nullptr) {
       // Setup the hardware with proper inputs.
       input_trait(org) = game.AsVectorInput(game.GetCurPlayer());
 
+      uint64_t board_key = 0;
+      if (moves) {
+        board_key = GenomeHash::CalcValues<double>(input_trait(org));
+        auto it = moves->find(board_key);
+        if (it != moves->end()) return it->second;
+      }
+
       // Run the code.
       org.GenerateOutput();
 
-      emp::vector<double> results = output_trait(org);
+      const emp::vector<double> & results = output_trait(org);
 
       // Determine the chosen move.
       size_t best_move = 0;
@@ -85,6 +155,7 @@ namespace mabe {
         if (results[best_move] < results[i]) { best_move = i; }
       }
 
+      if (moves) (*moves)[board_key] = (uint8_t) best_move;
       return best_move;
     }
 
@@ -116,12 +187,21 @@ namespace mabe {
       size_t scoreA = 0;
       size_t scoreB = 0;
       size_t num_errors = 0;
+      size_t num_errorsB = 0;   ///< Illegal moves attempted by the opponent.
 
       double CalcFitness() const {
         return ((double) scoreA) - ((double) scoreB) - ((double) num_errors * 10.0);
       }
+
+      /// The same results from the opponent's point of view.
+      Results Flipped() const { return Results{ scoreB, scoreA, num_errorsB, num_errors }; }
     };
 
+  private:
+    MemoCache<Results> results_cache;   ///< Tournament results by genomes and first player.
+
+  public:
+
     /// Evaluate a game between two functions that each take the game state as input and return
     /// their next move as output.
     /// @param player0 The function to be evaluated
@@ -132,7 +212,7 @@ namespace mabe {
     Results EvalGame(const mancala_ai_t & player0, const mancala_ai_t & player1, bool cur_player=0,
                     bool verbose=false, std::ostream & os=std::cout) {
       emp::Mancala game(cur_player==0);
-      size_t round = 0, errors = 0;
+      size_t round = 0, errors = 0, errorsB = 0;
       while (game.IsDone() == false) {
         // Determine the current player and their move.
         auto & play_fun = (cur_player == 0) ? player0 : player1;
@@ -152,6 +232,7 @@ namespace mabe {
         // If the chosen move is illegal, shift through other options.
         while (game.GetCurSide()[best_move] == 0) {  // Cannot make a move into an empty pit!
           if (cur_player == 0) errors++;
+          else errorsB++;
           if (++best_move > 5) best_move = 0;
         }
 
@@ -166,12 +247,24 @@ namespace mabe {
                   << std::endl;
       }
 
-      return Results{ game.ScoreA(), game.ScoreB(), errors };
+      return Results{ game.ScoreA(), game.ScoreB(), errors, errorsB };
     }
 
     /// Convert an organism into a uniform function that can be plugged into Mancala.
-    mancala_ai_t ToOrgFun(mabe::Organism & org) {
-      return [this,&org](emp::Mancala & game){ return EvalMove(game, org); };
+    mancala_ai_t ToOrgFun(mabe::Organism & org, emp::Ptr<move_table_t> moves=nullptr) {
+      return [this,&org,moves](emp::Mancala & game){ return EvalMove(game, org, moves); };
+    }
+
+    /// Move table for the organism at 'id' in the current evaluation (or null if off).
+    emp::Ptr<move_table_t> GetMoveTable(size_t id) {
+      if (!move_table) return nullptr;
+      return &move_tables[id];
+    }
+
+    /// Start a new evaluation of 'num_orgs' organisms with empty move tables.
+    void ResetMoveTables(size_t num_orgs) {
+      move_tables.resize(0);
+      if (move_table) move_tables.resize(num_orgs);
     }
 
     /// Evaluate a game: Organism vs. Organism.
@@ -192,13 +285,14 @@ namespace mabe {
     /// @param verbose Should we print out extra output? (default=false)
     /// @param os Output stream for any extra ouput. (default=cout)
     Results EvalGame(mabe::Organism & org, emp::Random & random, bool start_player=0,
-                    bool verbose=false, std::ostream & os=std::cout) {
+                    bool verbose=false, std::ostream & os=std::cout,
+                    emp::Ptr<move_table_t> moves=nullptr) {
       mancala_ai_t rand_fun = [&random](emp::Mancala & game) {
         size_t move_id = random.GetUInt(6);
         while (!game.IsMoveValid(move_id)) move_id = random.GetUInt(6);
         return move_id;
       };
-      return EvalGame(ToOrgFun(org), rand_fun, start_player, verbose, os);
+      return EvalGame(ToOrgFun(org, moves), rand_fun, start_player, verbose, os);
     }
 
     /// Evaluate a game: Organism vs. human opponent.
@@ -223,35 +317,172 @@ namespace mabe {
       }
     }
 
-    double Evaluate(const Collection & orgs) {
-      // Determine the type of competitions to perform.
-      // ==> @CAO: For the moment, just doing a random opponent!!
+    /// Running totals for one organism across all of its games.
+    struct Standing {
+      double scoreA = 0.0;
+      double scoreB = 0.0;
+      double num_errors = 0.0;
+      double fitness = 0.0;
 
+      void Add(const Results & results) {
+        scoreA += results.scoreA;
+        scoreB += results.scoreB;
+        num_errors += results.num_errors;
+        fitness += results.CalcFitness();
+      }
+    };
+
+    /// Record an organism's standing in its traits.
+    void SetTraits(Organism & org, const Standing & standing) {
+      scoreA_trait(org) = standing.scoreA;
+      scoreB_trait(org) = standing.scoreB;
+      error_trait(org) = standing.num_errors;
+      fitness_trait(org) = standing.fitness;
+    }
+
+    /// Play an organism against random moves, once starting first and once second.  With
+    /// bounded evaluation, skip the second game if it could not lift the organism to the cutoff.
+    double EvalVsRandom(Organism & org, emp::Random & random, emp::Ptr<move_table_t> moves=nullptr) {
+      Standing standing;
+      standing.Add(EvalGame(org, random, 0, false, std::cout, moves));      // Start first.
+      if (cutoff.IsActive() && cutoff.CanStop(standing.fitness + MAX_GAME_FITNESS)) {
+        standing.fitness += MAX_GAME_FITNESS;   // Record the upper bound.
+      } else {
+        standing.Add(EvalGame(org, random, 1, false, std::cout, moves)); // Start second.
+        cutoff.Report(standing.fitness);
+      }
+      SetTraits(org, standing);
+      return standing.fitness;
+    }
+
+    /// Play the organisms at id0 and id1 (from the organism at id0's point of view), or look up
+    /// the result if these genomes have played this game before.  'genome_keys' holds each
+    /// organism's genome hash (only needed with the game cache).
+    Results PlayGame(const emp::vector<emp::Ptr<Organism>> & org_ptrs,
+                     const emp::vector<uint64_t> & genome_keys,
+                     size_t id0, size_t id1, bool start_player) {
+      auto play = [&](){
+        return EvalGame(ToOrgFun(*org_ptrs[id0], GetMoveTable(id0)),
+                        ToOrgFun(*org_ptrs[id1], GetMoveTable(id1)), start_player);
+      };
+      if (game_cache == 0) return play();
+
+      // Key each game by its players in a fixed order, so both sides of a game share an entry.
+      const bool flip = genome_keys[id0] > genome_keys[id1];
+      const uint64_t sites[3] = { genome_keys[flip ? id1 : id0], genome_keys[flip ? id0 : id1],
+                                  (uint64_t) (start_player != flip) };
+      const uint64_t key = GenomeHash::Calc(3, [&sites](size_t i){ return sites[i]; });
+      const Results results = results_cache.Get(key, [&](){
+        return flip ? play().Flipped() : play();
+      });
+      return flip ? results.Flipped() : results;
+    }
+
+    /// Play each pair of organisms twice (each starting once), crediting both players.  Pairs
+    /// must not share organisms, so that they can be played in parallel.
+    void PlayRound(const emp::vector<emp::Ptr<Organism>> & org_ptrs,
+                   const emp::vector<uint64_t> & genome_keys,
+                   const emp::vector<std::pair<size_t,size_t>> & pairs,
+                   emp::vector<Standing> & standings) {
+      control.GetThreadPool().ForEach(pairs.size(), [&](size_t pair_id) {
+        const auto [id0, id1] = pairs[pair_id];
+        for (bool start_player : {false, true}) {
+          const Results results = PlayGame(org_ptrs, genome_keys, id0, id1, start_player);
+          standings[id0].Add(results);
+          standings[id1].Add(results.Flipped());
+        }
+      });
+    }
+
+    /// Pairings for each round of a round-robin among 'num_orgs' players (circle method).
+    static emp::vector<emp::vector<std::pair<size_t,size_t>>> CalcRoundRobin(size_t num_orgs) {
+      emp::vector<emp::vector<std::pair<size_t,size_t>>> rounds;
+      if (num_orgs < 2) return rounds;
+      const size_t slots = num_orgs + (num_orgs % 2);   // Odd counts get a "bye" slot.
+      for (size_t round = 0; round + 1 < slots; ++round) {
+        auto player_at = [round, slots](size_t slot) {
+          return slot ? 1 + (slot - 1 + round) % (slots - 1) : 0;
+        };
+        emp::vector<std::pair<size_t,size_t>> & pairs = rounds.emplace_back();
+        for (size_t slot = 0; slot < slots / 2; ++slot) {
+          const size_t id0 = player_at(slot), id1 = player_at(slots - 1 - slot);
+          if (id0 < num_orgs && id1 < num_orgs) pairs.emplace_back(id0, id1);
+        }
+      }
+      return rounds;
+    }
+
+    /// Play a round-robin or Swiss tournament among the organisms; return the max fitness.
+    double EvaluateTournament(const emp::vector<emp::Ptr<Organism>> & org_ptrs) {
+      const size_t num_orgs = org_ptrs.size();
+      emp::vector<Standing> standings(num_orgs);
+
+      if (results_cache.GetCapacity() != game_cache) results_cache.SetCapacity(game_cache);
+      emp::vector<uint64_t> genome_keys;
+      if (game_cache) {
+        genome_keys.resize(num_orgs);
+        control.GetThreadPool().ForEach(num_orgs, [&](size_t id){
+          genome_keys[id] = org_ptrs[id]->GetGenomeHash();
+        });
+      }
+
+      if (opponent_type == ROUND_ROBIN) {
+        for (const auto & pairs : CalcRoundRobin(num_orgs)) {
+          PlayRound(org_ptrs, genome_keys, pairs, standings);
+        }
+      } else {
+        // Each round, rank by fitness so far (ties by collection order) and pair neighbors;
+        // with an odd count, the lowest-ranked organism sits out.  Rematches are allowed.
+        emp::vector<size_t> order(num_orgs);
+        emp::vector<std::pair<size_t,size_t>> pairs;
+        for (size_t round = 0; round < swiss_rounds; ++round) {
+          std::iota(order.begin(), order.end(), 0);
+          std::stable_sort(order.begin(), order.end(), [&standings](size_t a, size_t b){
+            return standings[a].fitness > standings[b].fitness;
+          });
+          pairs.resize(0);
+          for (size_t i = 0; i + 1 < num_orgs; i += 2) pairs.emplace_back(order[i], order[i+1]);
+          PlayRound(org_ptrs, genome_keys, pairs, standings);
+        }
+      }
+
+      double max_fitness = 0.0;
+      for (size_t id = 0; id < num_orgs; ++id) {
+        SetTraits(*org_ptrs[id], standings[id]);
+        if (standings[id].fitness > max_fitness) max_fitness = standings[id].fitness;
+      }
+      return max_fitness;
+    }
+
+    double Evaluate(const Collection & orgs) {
       // Loop through the living organisms in the target collection to evaluate each.
-      mabe::Collection alive_collect( orgs.GetAlive() );
+      emp::vector<emp::Ptr<Organism>> org_ptrs;
+      org_ptrs.reserve(orgs.CountAlive());
+      orgs.ForEachAlive([&org_ptrs](Organism & org){ org_ptrs.push_back(&org); });
 
-      control.Verbose(" - ", alive_collect.GetSize(), " organisms found.");
+      control.Verbose(" - ", org_ptrs.size(), " organisms found.");
+      ResetMoveTables(org_ptrs.size());
+
+      if (opponent_type == ROUND_ROBIN || opponent_type == SWISS) {
+        return EvaluateTournament(org_ptrs);
+      }
+
+      // Other opponent types currently all play against random moves.
+      cutoff.Setup(bound_min, bound_top);
+      if (game_streams) {
+        const RandomStreams streams = control.GetRandomStreams();
+        const size_t update = control.GetUpdate();
+        return std::max(0.0, control.GetThreadPool().MaxOf(org_ptrs.size(), [&](size_t id) {
+          emp::Random random = streams.Make(update, id, GAME_SALT);
+          return EvalVsRandom(*org_ptrs[id], random, GetMoveTable(id));
+        }));
+      }
 
       size_t org_count = 0;
       double max_fitness = 0.0;
-      for (Organism & org : alive_collect) {
+      for (size_t id = 0; id < org_ptrs.size(); ++id) {
         control.Verbose("...eval org #", org_count++);
-        double & scoreA = scoreA_trait(org);
-        double & scoreB = scoreB_trait(org);
-        double & num_errors = error_trait(org);
-        double & fitness = fitness_trait(org);
-        Results results = EvalGame(org, control.GetRandom());  // Start first.
-        scoreA = results.scoreA;
-        scoreB = results.scoreB;
-        num_errors = results.num_errors;
-        fitness = results.CalcFitness();
-
-        results = EvalGame(org, control.GetRandom(), 1);  // Start second.
-        scoreA += results.scoreA;
-        scoreB += results.scoreB;
-        num_errors += results.num_errors;
-        fitness += results.CalcFitness();
-
+        const double fitness = EvalVsRandom(*org_ptrs[id], control.GetRandom(), GetMoveTable(id));
         if (fitness > max_fitness) max_fitness = fitness;
       }
 
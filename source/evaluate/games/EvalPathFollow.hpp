@@ -20,6 +20,10 @@
 #ifndef MABE_EVAL_PATH_FOLLOW_HPP
 #define MABE_EVAL_PATH_FOLLOW_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
 #include "../../orgs/VirtualCPUOrg.hpp"
@@ -31,11 +35,87 @@
 
 namespace mabe {
 
+  /// \brief Fixed-size blocks of "visited" bits shared by all organisms' path follow states.
+  ///
+  /// Every block is large enough for the biggest map loaded, and blocks released by dead
+  /// organisms are handed to newborns, so once a population is full no allocation happens.
+  class VisitedTilePool {
+  private:
+    size_t block_words = 0;             ///< uint64_t words per block
+    emp::vector<uint64_t> words;        ///< All blocks, back to back
+    emp::vector<size_t> free_blocks;    ///< Released blocks available for reuse
+
+  public:
+    static constexpr size_t NO_BLOCK = (size_t) -1;
+
+    size_t GetNumBlocks() const { return block_words ? words.size() / block_words : 0; }
+    size_t GetNumFree() const { return free_blocks.size(); }
+
+    /// Make sure every block can hold 'num_tiles' bits (keeping the contents of any blocks).
+    void Reserve(size_t num_tiles) {
+      const size_t new_words = (num_tiles + 63) / 64;
+      if (new_words <= block_words) return;
+      const size_t num_blocks = GetNumBlocks();
+      words.resize(num_blocks * new_words, 0);
+      for (size_t block = num_blocks; block-- > 0; ) {   // Spread blocks out, last first.
+        for (size_t w = block_words; w-- > 0; ) {
+          words[block * new_words + w] = words[block * block_words + w];
+        }
+        for (size_t w = block_words; w < new_words; ++w) words[block * new_words + w] = 0;
+      }
+      block_words = new_words;
+    }
+
+    size_t Acquire() {
+      if (free_blocks.size()) {
+        const size_t block = free_blocks.back();
+        free_blocks.pop_back();
+        return block;
+      }
+      const size_t block = GetNumBlocks();
+      words.resize(words.size() + block_words, 0);
+      return block;
+    }
+    void Release(size_t block) { emp_assert(block != NO_BLOCK); free_blocks.push_back(block); }
+
+    void Clear(size_t block, size_t num_tiles) {
+      uint64_t * start = words.data() + block * block_words;
+      std::fill(start, start + (num_tiles + 63) / 64, 0);
+    }
+    bool Get(size_t block, size_t pos) const {
+      return (words[block * block_words + pos / 64] >> (pos % 64)) & 1;
+    }
+    void Set(size_t block, size_t pos) {
+      words[block * block_words + pos / 64] |= (uint64_t) 1 << (pos % 64);
+    }
+  };
+
+  /// \brief An organism's view of its block in a VisitedTilePool.
+  struct VisitedTiles {
+    emp::Ptr<VisitedTilePool> pool = nullptr;
+    size_t block = VisitedTilePool::NO_BLOCK;
+    size_t num_tiles = 0;
+
+    size_t GetSize() const { return num_tiles; }
+    bool operator[](size_t pos) const {
+      emp_assert(pos < num_tiles, pos, num_tiles);
+      return pool->Get(block, pos);
+    }
+    void Set(size_t pos) {
+      emp_assert(pos < num_tiles, pos, num_tiles);
+      pool->Set(block, pos);
+    }
+  };
+
   /// \brief State of a single organism's progress on the path following task
+  ///
+  /// Map data is shared through the evaluator (only its index is stored here), and the
+  /// visited mask lives in the evaluator's VisitedTilePool.  StateGridStatus only records
+  /// a move history if TrackMoves() is turned on, so none is kept during normal runs.
   struct PathFollowState{
     bool initialized;             ///< Flag indicating if this state has been initialized
     size_t cur_map_idx;           ///< Index of the map being traversed 
-    emp::BitVector visited_tiles; ///< A mask showing which tiles have been previously visited
+    VisitedTiles visited_tiles;   ///< A mask showing which tiles have been previously visited
     StateGridStatus status;  ///< Stores position, direction, and interfaces with grid 
     double raw_score;             /**< Number of unique valid tiles visited minus the number
                                        of steps taken off the path (not unique) */
@@ -51,14 +131,10 @@ namespace mabe {
     PathFollowState(): initialized(false), cur_map_idx(0), visited_tiles(), status(),
         raw_score(0), empty_cue(1), forward_cue(2), left_cue(3), right_cue(4) { ; }
     
-    PathFollowState(const PathFollowState&){ // Ignore copy, just prep to initialize
-      raw_score = 0;
-      initialized = false;
-    }
-    PathFollowState(PathFollowState&&){ // Ignore move, just prep to initialize
-      raw_score = 0;
-      initialized = false;
-    }
+    // Copies and moves start fresh (with no visited block of their own) and are
+    // initialized on first use.
+    PathFollowState(const PathFollowState&) : PathFollowState() { ; }
+    PathFollowState(PathFollowState&&) : PathFollowState() { ; }
     PathFollowState& operator=(PathFollowState&){ // Ignore copy, just prep to initialize
       raw_score = 0;
       initialized = false;
@@ -110,13 +186,15 @@ namespace mabe {
     };
 
     emp::vector<PathData> path_data_vec; ///< All the relevant data for each map loaded
+    std::shared_ptr<VisitedTilePool> visited_pool; ///< Visited masks for all states
     emp::Random& rand;          ///< Reference to the main random number generator of MABE
     bool randomize_cues; /**< If true, each org receives random values for each type for cue
                                   (consistent through lifetime). Otherwise, cues have same 
                                   values for all orgs */
     
     public: 
-    PathFollowEvaluator(emp::Random& _rand) : path_data_vec(), rand(_rand), 
+    PathFollowEvaluator(emp::Random& _rand) : path_data_vec(),
+        visited_pool(std::make_shared<VisitedTilePool>()), rand(_rand),
         randomize_cues(true) { ; } 
 
     /// Fetch the number of maps that are currently stored 
@@ -199,6 +277,8 @@ namespace mabe {
       if(!has_finish){
         emp_error("Error! Map does not have a finish tile! (character: X)");
       }
+      visited_pool->Reserve(path_data.grid.GetSize());
+      path_data.grid.BuildMoveTable();  // Single steps (sg-move, sg-move-back) become lookups
       std::cout << "Map #" << (path_data_vec.size() - 1) << " is " 
         << path_data.grid.GetWidth() << "x" << path_data.grid.GetHeight() << ", with " 
         << path_data.path_length << " path tiles!" << std::endl;
@@ -217,8 +297,13 @@ namespace mabe {
       state.initialized = true;
       if(reset_map) state.cur_map_idx = rand.GetUInt(path_data_vec.size());;
       emp_assert(path_data_vec.size() > state.cur_map_idx, "Cannot initialize state before loading the map!");
-      state.visited_tiles.Resize(path_data_vec[state.cur_map_idx].grid.GetSize()); 
-      state.visited_tiles.Clear();
+      VisitedTiles & visited = state.visited_tiles;
+      if (visited.block == VisitedTilePool::NO_BLOCK) {
+        visited.pool = visited_pool.get();
+        visited.block = visited_pool->Acquire();
+      }
+      visited.num_tiles = path_data_vec[state.cur_map_idx].grid.GetSize();
+      visited_pool->Clear(visited.block, visited.num_tiles);
       state.status.Set(
         path_data_vec[state.cur_map_idx].start_x,
         path_data_vec[state.cur_map_idx].start_y,
@@ -244,6 +329,14 @@ namespace mabe {
       }
     }
     
+    /// Return a state's visited block to the pool (when its organism dies)
+    void ReleaseState(PathFollowState& state){
+      if (state.visited_tiles.block == VisitedTilePool::NO_BLOCK) return;
+      visited_pool->Release(state.visited_tiles.block);
+      state.visited_tiles = VisitedTiles();
+      state.initialized = false;
+    }
+    
     /// Fetch the data of the state's current path
     PathData& GetCurPath(const PathFollowState& state){
       return path_data_vec[state.cur_map_idx];
@@ -256,7 +349,7 @@ namespace mabe {
 
     /// Record the organism's current position as visited
     void MarkVisited(PathFollowState& state){
-      state.visited_tiles.Set(state.status.GetIndex(GetCurPath(state).grid), true);
+      state.visited_tiles.Set(state.status.GetIndex(GetCurPath(state).grid));
     }
 
     /// Fetch the reward value for organism's current position
@@ -343,8 +436,8 @@ namespace mabe {
     using inst_func_t = VirtualCPUOrg::inst_func_t;
 
   private:
-    emp::String score_trait = "score"; ///< Name of trait for organism performance
-    emp::String state_trait ="state";  ///< Name of trait that stores the path follow state
+    SharedTrait<double> score_trait{this, "score", "Path following score"};
+    OwnedTrait<PathFollowState> state_trait{this, "state", "Organism's path follow state"};
     emp::String map_filenames="";      ///< ;-separated list map filenames to load.
     PathFollowEvaluator evaluator;     /**< The evaluator that does all of the actually 
                                             computing and bookkeeping for the path follow 
@@ -360,6 +453,8 @@ namespace mabe {
       , evaluator(control.GetRandom())
     {
       SetEvaluateMod(true);
+      score_trait.SetConfigDesc("Which trait stores path following performance?");
+      state_trait.SetConfigDesc("Which trait stores organisms' path follow state?");
     }
     ~EvalPathFollow() { }
 
@@ -367,24 +462,24 @@ namespace mabe {
     void SetupConfig() override {
       LinkPop(pop_id, "target_pop", 
           "Population to evaluate.");
-      LinkVar(score_trait, "score_trait", 
-          "Which trait stores path following performance?");
-      LinkVar(state_trait, "state_trait", 
-          "Which trait stores organisms' path follow state?");
       LinkVar(map_filenames, "map_filenames", 
           "List of map files to load, separated by semicolons(;)");
       LinkVar(evaluator.randomize_cues, "randomize_cues", 
           "If true, cues are assigned random values in for each new path");
     }
     
-    /// Set up organism traits, load maps, and provide instructions to organisms
+    /// Load maps and provide instructions to organisms (traits are added automatically)
     void SetupModule() override {
-      AddSharedTrait<double>(score_trait, "Path following score", 0.0);
-      AddOwnedTrait<PathFollowState>(state_trait, "Organism's path follow state", { }); 
       evaluator.LoadAllMaps(map_filenames);
       SetupInstructions();
     }
 
+    /// Recycle the visited mask of organisms that are removed
+    void BeforeDeath(OrgPosition pos) override {
+      if (pos.PopID() != pop_id || !pos.Pop().IsOccupied(pos.Pos())) return;
+      evaluator.ReleaseState(state_trait(pos.Pop()[pos.Pos()]));
+    }
+
     /// Package path following actions (e.g., move, turn) into instructions and provide 
     /// them to the organisms via ActionMap
     void SetupInstructions(){
@@ -392,8 +487,8 @@ namespace mabe {
       { // Move
         inst_func_t func_move = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            double score = evaluator.Move(hw.GetTrait<PathFollowState>(state_trait));
-            hw.SetTrait<double>(score_trait, score);
+            double score = evaluator.Move(state_trait(hw));
+            score_trait(hw) = score;
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-move", func_move);
@@ -401,8 +496,8 @@ namespace mabe {
       { // Move backward
         inst_func_t func_move_back = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            double score = evaluator.Move(hw.GetTrait<PathFollowState>(state_trait), -1);
-            hw.SetTrait<double>(score_trait, score);
+            double score = evaluator.Move(state_trait(hw), -1);
+            score_trait(hw) = score;
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-move-back", func_move_back);
@@ -410,7 +505,7 @@ namespace mabe {
       { // Rotate right 
         inst_func_t func_rotate_right = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            evaluator.RotateRight(hw.GetTrait<PathFollowState>(state_trait));
+            evaluator.RotateRight(state_trait(hw));
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-rotate-r", func_rotate_right);
@@ -418,7 +513,7 @@ namespace mabe {
       { // Rotate left 
         inst_func_t func_rotate_left = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            evaluator.RotateLeft(hw.GetTrait<PathFollowState>(state_trait));
+            evaluator.RotateLeft(state_trait(hw));
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-rotate-l", func_rotate_left);
@@ -426,7 +521,7 @@ namespace mabe {
       { // Sense 
         inst_func_t func_sense = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& inst){
-            uint32_t val = evaluator.Sense(hw.GetTrait<PathFollowState>(state_trait));
+            uint32_t val = evaluator.Sense(state_trait(hw));
             size_t reg_idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
             hw.regs[reg_idx] = val;
           };
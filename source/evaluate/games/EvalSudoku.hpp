@@ -14,16 +14,22 @@
  *    number of empty cells on starting grid
  *    count of each move type : how many times does the relevant move need to be used?
  *    ? is move type a bottleneck? : 0/1 Is there ever only one option for move?
+ *
+ *  Boards are analyzed in parallel when num_threads > 1 (each thread has its own analyzer),
+ *  and setting memo_size remembers results by board so repeated boards are not re-solved.
  */
 
 #ifndef MABE_EVAL_SUDOKU_H
 #define MABE_EVAL_SUDOKU_H
 
+#include <cstdint>
+
 #include "emp/games/SudokuAnalyzer.hpp"
 #include "emp/tools/String.hpp"
 
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
+#include "../../tools/MemoCache.hpp"
 
 namespace mabe {
 
@@ -45,6 +51,51 @@ namespace mabe {
 
     OwnedTrait<double> match_trait{this,      "puz_match",   "How well does this puzzle match a target?"};
 
+    /// Everything recorded about one starting board.
+    struct BoardResult {
+      bool loaded = false;            ///< Was this a legal starting board?
+      bool solved = false;
+      double length = 0.0;
+      double variety = 0.0;
+      double empty = 0.0;
+      double match = 0.0;
+      double score = 0.0;
+      emp::vector<double> move_counts;
+    };
+
+    size_t memo_size = 0;             ///< Max boards to remember results for (0 = off).
+    MemoCache<BoardResult> memo;      ///< Results keyed by a hash of the starting board.
+
+    static uint64_t HashBoard(std::span<size_t> genome) {
+      uint64_t hash = 14695981039346656037ull;         // 64-bit FNV-1a
+      for (size_t value : genome) {
+        hash ^= (uint64_t) value;
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    /// Analyze a starting board with the provided analyzer.
+    BoardResult CalcResult(emp::SudokuAnalyzer & board_analyzer, std::span<size_t> genome) {
+      BoardResult result;
+      result.move_counts.resize(emp::SudokuAnalyzer::GetNumMoveTypes(), 0.0);
+      if (!board_analyzer.Load(genome)) return result;
+
+      auto profile = board_analyzer.CalcProfile();
+      const bool solved = board_analyzer.IsSolved();
+      result.loaded = true;
+      result.solved = solved;
+      result.length = profile.size();
+      result.variety = profile.CountTypes();
+      result.empty = solved ? std::count(genome.begin(), genome.end(), 0) : 0.0;
+      result.match = static_cast<double>(TestTarget(board_analyzer.GetValues()));
+      for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
+        result.move_counts[move_id] = solved ? profile.CountMoves(move_id) : 0.0;
+      }
+      result.score = profile.CalcScore() + (solved ? 1000.0 : 0)
+                   + TestTarget(board_analyzer.GetValues())*75.0 - TestTarget(genome)*25;
+      return result;
+    }
 
   public:
     EvalSudoku(mabe::MABE & control,
@@ -59,15 +110,19 @@ namespace mabe {
     // Setup member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction("EVAL",
-                             [](EvalSudoku & mod, Collection list) { return mod.Evaluate(list); },
+                             [](EvalSudoku & mod, const Collection & list) { return mod.Evaluate(list); },
                              "Evaluate the scores for one or more Sudoku boards.");
+      info.AddMemberFunction("MEMO_HIT_RATE",
+                             [](EvalSudoku & mod) { return mod.memo.GetHitRate(); },
+                             "Return the fraction of board lookups that found a stored result.");
       info.AddMemberFunction("PRINT",
-                             [](EvalSudoku & mod, Collection list) { return mod.Print(list); },
+                             [](EvalSudoku & mod, const Collection & list) { return mod.Print(list); },
                              "Print one or more Sudoku boards.");
     }
 
     void SetupConfig() override {
       LinkVar(target_filename, "target_file", "File with info about any cell states to target at end.");
+      LinkVar(memo_size, "memo_size", "Number of board results to remember (0 = no memo).");
       // No other variables to link in to the configuration (e.g., N and K for NK)
     }
 
@@ -91,54 +146,57 @@ namespace mabe {
       return count;
     }
 
-    double Evaluate(Collection orgs) {
+    double Evaluate(const Collection & orgs) {
       emp_assert(control.GetNumPopulations() >= 1);
+      if (memo.GetCapacity() != memo_size) memo.SetCapacity(memo_size);
+
+      emp::vector<emp::Ptr<Organism>> org_ptrs;
+      org_ptrs.reserve(orgs.CountAlive());
+      orgs.ForEachAlive([&org_ptrs](Organism & org){ org_ptrs.push_back(&org); });
+
+      // Analyze every board (in parallel if num_threads > 1); analyzers hold per-board state,
+      // so each thread uses its own.
+      emp::vector<BoardResult> results(org_ptrs.size());
+      auto analyze_org = [this, &org_ptrs, &results](size_t id, emp::SudokuAnalyzer & board_analyzer) {
+        Organism & org = *org_ptrs[id];
+        org.GenerateOutput();   // Make sure this organism has its genome ready for us to access.
+        std::span<size_t> genome = states_trait(org);
+        if (memo_size == 0) results[id] = CalcResult(board_analyzer, genome);
+        else {
+          results[id] = memo.Get(HashBoard(genome),
+                                 [&](){ return CalcResult(board_analyzer, genome); });
+        }
+      };
+      ThreadPool & pool = control.GetThreadPool();
+      if (pool.IsParallel()) {
+        pool.ForEach(org_ptrs.size(), [&analyze_org](size_t id) {
+          thread_local emp::SudokuAnalyzer thread_analyzer;
+          analyze_org(id, thread_analyzer);
+        });
+      } else {
+        for (size_t id = 0; id < org_ptrs.size(); ++id) analyze_org(id, analyzer);
+      }
 
-      // Evaluate each organism.
+      // Record results in order; boards that failed to load (illegal starting positions) get
+      // all-zero traits and do not count toward the max score.
       double max_score = 0.0;
       emp::Ptr<Organism> max_org = nullptr;
-      mabe::Collection alive_collect( orgs.GetAlive() );
-      for (Organism & org : alive_collect) {        
-        // Make sure this organism has its genome ready for us to access.
-        org.GenerateOutput();
-
-        // Load the Sudoku board.
-        std::span<size_t> genome = states_trait(org); // GetTrait<size_t>(SharedData().genome_name, SharedData().genome_size);
-        if (analyzer.Load(genome)) {
-          auto profile = analyzer.CalcProfile();
-          bool solved = analyzer.IsSolved();
-
-          // Set stats for this organism.
-          solve_trait(org) = solved;
-          length_trait(org) = profile.size();
-          diverse_trait(org) = profile.CountTypes();
-          empty_trait(org) = solved ? std::count(genome.begin(), genome.end(), 0) : 0.0;
-          match_trait(org) = static_cast<double>(TestTarget(analyzer.GetValues()));
-
-          for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
-            count_trait(org)[move_id] = solved ? profile.CountMoves(move_id) : 0.0;
-          }
-
-          double score = profile.CalcScore() + (solved ? 1000.0 : 0) + TestTarget(analyzer.GetValues())*75.0 - TestTarget(genome)*25;
-          score_trait(org) = score;
-
-          if (score > max_score || !max_org) {
-            max_score = score;
-            max_org = &org;
-          }
+      for (size_t id = 0; id < org_ptrs.size(); ++id) {
+        Organism & org = *org_ptrs[id];
+        const BoardResult & result = results[id];
+        solve_trait(org) = result.solved;
+        length_trait(org) = result.length;
+        diverse_trait(org) = result.variety;
+        empty_trait(org) = result.empty;
+        match_trait(org) = result.match;
+        for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
+          count_trait(org)[move_id] = result.move_counts[move_id];
         }
+        score_trait(org) = result.score;
 
-        // Otherwise, if load failed, indicate so in traits (illegal starting position!)
-        else {
-          solve_trait(org) = false;
-          length_trait(org) = 0.0;
-          diverse_trait(org) = 0.0;
-          empty_trait(org) = 0.0;
-          match_trait(org) = 0.0;
-          for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
-            count_trait(org)[move_id] = 0.0;
-          }
-          score_trait(org) = 0.0;
+        if (result.loaded && (result.score > max_score || !max_org)) {
+          max_score = result.score;
+          max_org = &org;
         }
       }
 
@@ -146,7 +204,7 @@ namespace mabe {
       return max_score;
     }
 
-    double Print(Collection orgs) {
+    double Print(const Collection & orgs) {
       // Print each organism.
       mabe::Collection alive_collect( orgs.GetAlive() );
       for (Organism & org : alive_collect) {        
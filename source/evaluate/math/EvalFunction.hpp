@@ -5,17 +5,29 @@
  *
  *  @file  EvalFunction.hpp
  *  @brief MABE Evaluation module rates organism's ability to perform a specified math function.
- * 
+ *
  *  This module specifies a function that agents are then evaluated based on how well they perform
  *  the function.
+ *
+ *  Test cases are numbered by case_ids (a "start:stop" or "start:step:stop" range, stop
+ *  exclusive); the value of each input for a case comes from an equation of case_id.  Both
+ *  the inputs and the target function's result are computed once for every case during
+ *  setup, so evaluating an organism only runs the organism on each case and then reduces
+ *  its outputs against the cached targets in a single tight loop.
+ *
+ *  With down-sampled selection (e.g., SelectLexicase with sample_traits), set active_cases to
+ *  the same name as the selector's to run organisms only on the cases it will use this update.
+ *  Skipped cases get an error of 0, so fitness stays on the same scale (#tests - error sum),
+ *  but is only comparable among organisms evaluated in the same update.
  */
 
 #ifndef MABE_EVAL_FUNCTION_HPP
 #define MABE_EVAL_FUNCTION_HPP
 
-#include "emp/base/array.hpp"
+#include <cmath>
+
 #include "emp/base/notify.hpp"
-#include "emp/data/Datum.hpp"
+#include "emp/data/DataMap.hpp"
 #include "emp/math/constants.hpp"
 
 #include "../../core/MABE.hpp"
@@ -32,25 +44,43 @@ namespace mabe {
     emp::String errors_trait = "errors";        ///< Trait for each test's deviation from target.
     emp::String fitness_trait = "fitness";      ///< Trait for combined fitness (#tests - error sum)
 
-    // Track the DataMap ID for each trait or trait set.
-
-    emp::array<size_t, MAX_INPUTS> input_ids;
-    size_t output_id = emp::MAX_SIZE_T;
-    size_t errors_id = emp::MAX_SIZE_T;
-    size_t fitness_id = emp::MAX_SIZE_T;
-
     emp::String function = "input1 * 3 + 5*input2"; ///< Function to specify target output.
 
-    /// Test values of each input in order, separated by a ';'
-    //emp::String test_summary = "0:100; 100:-1:0"
-    emp::String case_ids = 0:100;
-    emp::String test_summary = "case_id; (case_id*7)%100";
-
-    emp::vector<emp::String> input_names;   ///< Names of individual input traits.
-    std::function<emp::Datum( const emp::DataMap & )> fit_fun;
-    emp::vector<emp::vector<double>> test_values;
-    emp::vector<double> target_results;
-    size_t num_tests = emp::MAX_SIZE_T;
+    emp::String case_ids = "0:100";                      ///< Range of test case IDs.
+    emp::String test_summary = "case_id; (case_id*7)%100"; ///< Equation for each input, ';'-separated
+    emp::String active_cases;                            ///< Shared case sample to use ("" = all)
+
+    emp::vector<emp::String> input_names;           ///< Names of individual input traits.
+    emp::vector<emp::vector<double>> test_values;   ///< [input][test] values, built at setup.
+    emp::vector<double> target_results;             ///< Target output for each test.
+    emp::vector<double> outputs;                    ///< Scratch space for one org's outputs.
+    size_t num_tests = 0;
+
+    // Maps used to compute test values and targets; kept for the whole run because compiled
+    // equations are cached by the address of their layout.
+    emp::DataMap case_map;                          ///< Holds case_id for input equations.
+    emp::DataMap test_map;                          ///< Holds inputs for the target function.
+
+    /// Expand a "start:stop" or "start:step:stop" range (stop exclusive) into its values.
+    static emp::vector<double> ExpandRange(emp::String range) {
+      emp::remove_whitespace(range);
+      emp::vector<emp::String> parts = emp::slice(range, ':');
+      if (parts.size() < 2 || parts.size() > 3) {
+        emp::notify::Error("EvalFunction case_ids must be \"start:stop\" or \"start:step:stop\"; found \"",
+                           range, "\".");
+        return {};
+      }
+      const double start = emp::from_string<double>(parts[0]);
+      const double step = (parts.size() == 3) ? emp::from_string<double>(parts[1]) : 1.0;
+      const double stop = emp::from_string<double>(parts.back());
+      if (step <= 0.0) {
+        emp::notify::Error("EvalFunction case_ids step must be positive; found ", step, ".");
+        return {};
+      }
+      emp::vector<double> values;
+      for (double value = start; value < stop; value += step) values.push_back(value);
+      return values;
+    }
 
   public:
     EvalFunction(mabe::MABE & control,
@@ -65,7 +95,7 @@ namespace mabe {
     // Setup member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction("EVAL",
-                             [](EvalFunction & mod, Collection orgs) { return mod.Evaluate(orgs); },
+                             [](EvalFunction & mod, const Collection & orgs) { return mod.Evaluate(orgs); },
                              "Evaluate organism's ability to solve a target function.");
     }
 
@@ -75,13 +105,16 @@ namespace mabe {
       LinkVar(errors_trait, "errors_trait", "Trait for each test's deviation from target.");
       LinkVar(fitness_trait, "fitness_trait", "Trait for combined fitness (#tests - error sum)");
       LinkVar(function, "function", "Function to specify target output.");
-      LinkVar(test_summary, "test_values", "Test values to use for evaluation.\nFormat: Range list for each variable; use ';' to separate variables");
-      );
+      LinkVar(case_ids, "case_ids", "Range of test case IDs.\nFormat: start:stop or start:step:stop (stop is exclusive)");
+      LinkVar(active_cases, "active_cases",
+              "Name of a selector's shared test-case sample; only those cases are run (\"\" = all)");
+      LinkVar(test_summary, "test_values", "Test values to use for evaluation.\nFormat: An equation of case_id for each input; use ';' to separate inputs");
     }
 
     void SetupModule() override {
+      emp::remove_whitespace(input_traits);
       input_names = emp::slice(input_traits, ',');
-      if (intput_names.size() > MAX_INPUTS) {
+      if (input_names.size() > MAX_INPUTS) {
         emp::notify::Error("EvalFunction does not allow more than ", MAX_INPUTS, " inputs. ",
                            input_names.size(), " inputs, requested.");
       }
@@ -89,7 +122,7 @@ namespace mabe {
         AddOwnedTrait<double>(name, "Input value", 0.0);
       }
       AddRequiredTrait<double>(output_trait); // Output values
-      AddOwnedTrait<emp::vector<double>>(errors_trait, "Error vector for tests.", emp::vector<double>();
+      AddOwnedTrait<emp::vector<double>>(errors_trait, "Error vector for tests.", emp::vector<double>());
       AddOwnedTrait<double>(fitness_trait, "Combined success rating", 0.0);
 
       // Prepare the test values to use.
@@ -98,71 +131,100 @@ namespace mabe {
 
       if (test_sets.size() != input_names.size()) {
         emp::notify::Error("EvalFunction requires one test set for each input.  Found ",
-                           input_names.size(), " inputs, but ", tests_sets.size(), " test sets.");
+                           input_names.size(), " inputs, but ", test_sets.size(), " test sets.");
+        return;
       }
 
-      // Put the test values in place, along with the expected results.
-      test_values.resize(test_sets.size());               // Create one array for each input variable.
-      for (size_t i = 0; i < test_sets.size(); ++i) {
-        test_values[i] = emp::ToSequence(test_sets[i]);   // Set all values for one input variable.
-        if (num_tests == emp::MAX_SIZE_T) num_tests = test_values[i].size();
-        else if (test_values[i].size() != num_tests) {
-          emp::notify::Error("EvalFunction requires all inputs to have the same count of values.  First input (0) has ",
-                            test_values[0].size(), " test values, but ", i, " has ", test_values[i].size(), ".");
+      // Calculate each input's value for every test case.
+      const emp::vector<double> case_values = ExpandRange(case_ids);
+      num_tests = case_values.size();
+      const size_t case_id = case_map.AddVar<double>("case_id", 0.0);
+      MABEScript & script = control.GetConfigScript();
+      test_values.resize(test_sets.size());
+      for (size_t input_id = 0; input_id < test_sets.size(); ++input_id) {
+        auto input_fun = script.BuildDataMapEquation(case_map.GetLayout(), test_sets[input_id]);
+        test_values[input_id].resize(num_tests);
+        for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+          case_map.Get<double>(case_id) = case_values[test_id];
+          test_values[input_id][test_id] = static_cast<double>(input_fun(case_map));
         }
       }
 
-      // Build a DataMap to determine expected results for each test case.
-      emp::DataMap test_map;
-      for (size_t i = 0; i < input_names.size(); ++i) {
-        test_map.AddVar<double>(input_names[0]);
+      // Calculate the target result for every test case, once.
+      emp::vector<size_t> test_ids;
+      for (const emp::String & name : input_names) test_ids.push_back(test_map.AddVar<double>(name, 0.0));
+      auto target_fun = script.BuildDataMapEquation(test_map.GetLayout(), function);
+      target_results.resize(num_tests);
+      for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+        for (size_t input_id = 0; input_id < test_ids.size(); ++input_id) {
+          test_map.Get<double>(test_ids[input_id]) = test_values[input_id][test_id];
+        }
+        target_results[test_id] = static_cast<double>(target_fun(test_map));
       }
-
+      outputs.resize(num_tests);
     }
 
+    /// Calculate the error for each test (stored in 'errors') and return the error sum.
+    static double CalcErrors(const emp::vector<double> & outputs,
+                             const emp::vector<double> & targets,
+                             emp::vector<double> & errors) {
+      const size_t num_tests = targets.size();
+      errors.resize(num_tests);
+      for (size_t i = 0; i < num_tests; ++i) errors[i] = std::abs(outputs[i] - targets[i]);
+      double error_sum = 0.0;
+      for (size_t i = 0; i < num_tests; ++i) error_sum += errors[i];
+      return error_sum;
+    }
 
     double Evaluate(const Collection & orgs) {
-      // If we haven't calculated the IDs, do so now.
-      if (output_trait == emp::MAX_SIZE_T) {
-        input_ids.resize(input_names.size());
-        for (size_t i = 0; i < input_names.size(); ++i) {
-          input_ids[i] = orgs.GetDataLayout().GetID(input_names[i]);
-        }
-        output_id = orgs.GetDataLayout().GetID(output_trait);
-        errors_id = orgs.GetDataLayout().GetID(errors_trait);
-        fitness_id = orgs.GetDataLayout().GetID(fitness_trait);
-      }
-
       // Loop through the living organisms in the target collection to evaluate each.
-      mabe::Collection alive_collect( orgs.GetAlive() );
-
-      control.Verbose(" - ", alive_collect.GetSize(), " organisms found.");
+      const size_t num_alive = orgs.CountAlive();
+
+      control.Verbose(" - ", num_alive, " organisms found.");
+      if (num_alive == 0) return 0.0;
+
+      // Look up trait IDs once for this evaluation.
+      const emp::DataLayout & layout = orgs.GetDataLayout();
+      emp::vector<size_t> input_ids;
+      for (const emp::String & name : input_names) input_ids.push_back(layout.GetID(name));
+      const size_t output_id = layout.GetID(output_trait);
+      const size_t errors_id = layout.GetID(errors_trait);
+      const size_t fitness_id = layout.GetID(fitness_trait);
+
+      // Determine which test cases to run; skipped cases output their target (error 0).
+      emp::vector<size_t> test_ids;
+      if (active_cases.size()) {
+        test_ids = control.GetActiveCases(active_cases)
+          .GetSample(control.GetRandomStreams(), control.GetUpdate(), num_tests);
+      } else {
+        test_ids = ActiveCases::CalcSample(0, num_tests, num_tests);
+      }
+      if (test_ids.size() < num_tests) outputs = target_results;
 
       size_t org_count = 0;
       double max_fitness = 0.0;
-      for (Organism & org : alive_collect) {
+      orgs.ForEachAlive([&](Organism & org) {
         control.Verbose("...eval org #", org_count++);
 
-        double & ouput = org.GetTrait<double>(output_id);
-        double & errors = org.GetTrait<emp::vector<double>>(errors_id);
-        double & fitness = org.GetTrait<double>(fitness_trait);
-
-        /// Loop through test cases to evaluate each.
-        for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+        /// Run the organism on each active test case, collecting its outputs.
+        for (size_t test_id : test_ids) {
           // Setup inputs for the current test.
           for (size_t input_pos = 0; input_pos < input_ids.size(); ++input_pos) {
-            org.SetTrait(input_ids[input_pos], test_values[input_pos][test_id]);
+            org.GetTrait<double>(input_ids[input_pos]) = test_values[input_pos][test_id];
           }
 
           // Run the organism.
           org.GenerateOutput();
-
-          // Evaluate the results.
-
+          outputs[test_id] = org.GetTrait<double>(output_id);
         }
 
+        // Compare all outputs against the cached targets at once.
+        emp::vector<double> & errors = org.GetTrait<emp::vector<double>>(errors_id);
+        double & fitness = org.GetTrait<double>(fitness_id);
+        fitness = ((double) num_tests) - CalcErrors(outputs, target_results, errors);
+
         if (fitness > max_fitness) max_fitness = fitness;
-      }
+      });
 
       return max_fitness;
     }
@@ -10,15 +10,14 @@
 #ifndef MABE_EVAL_COUNT_BITS_H
 #define MABE_EVAL_COUNT_BITS_H
 
-#include "../../core/MABE.hpp"
-#include "../../core/Module.hpp"
+#include "../../core/EvalModule.hpp"
 
 #include "emp/datastructs/reference_vector.hpp"
 #include "emp/tools/String.hpp"
 
 namespace mabe {
 
-  class EvalCountBits : public Module {
+  class EvalCountBits : public EvalModule<EvalCountBits> {
   private:
     RequiredTrait<emp::BitVector> bits_trait{this, "bits", "Bit-sequence to evaluate."};
     OwnedTrait<double> score_trait{this, "score", "Count of the number of specified bits"};
@@ -29,19 +28,9 @@ namespace mabe {
     EvalCountBits(mabe::MABE & control,
                   emp::String name="EvalCountBits",
                   emp::String desc="Evaluate bitstrings by counting ones (or zeros).")
-      : Module(control, name, desc)
-    {
-      SetEvaluateMod(true);
-    }
+      : EvalModule(control, name, desc) { }
     ~EvalCountBits() { }
 
-    // Setup member functions associated with this class.
-    static void InitType(emplode::TypeInfo & info) {
-      info.AddMemberFunction("EVAL",
-                             [](EvalCountBits & mod, Collection list) { return mod.Evaluate(list); },
-                             "Count the ones in all orgs in an OrgList.");
-    }
-
     void SetupConfig() override {
       LinkVar(count_type, "count_type", "Which type of bit should we count? (0 or 1)");
     }
@@ -50,36 +39,33 @@ namespace mabe {
       // Nothing needed for now.
     }
 
-    double Evaluate(Collection orgs) {
+    double EvaluateCollection(const Collection & orgs) override {
       emp_assert(control.GetNumPopulations() >= 1);
 
-      // Loop through the population and evaluate each organism.
-      double max_score = 0.0;
-      emp::Ptr<Organism> max_org = nullptr;
-      mabe::Collection alive_collect( orgs.GetAlive() );
-      for (Organism & org : alive_collect) {        
-        // Make sure this organism has its bit sequence ready for us to access.
-        org.GenerateOutput();
+      // Evaluate each organism (in parallel if num_threads > 1) and find the max score.
+      const double max_score = EvaluateOrgs(orgs,
+        CacheEval([this](Organism & org) { return CalcScore(org); },
+                  [this](const Organism & org) { return score_trait(org); }));
 
-        // Count the number of ones in the bit sequence.
-        const emp::BitVector & bits = bits_trait.Get(org);
-        double score = (double) bits.CountOnes();
-
-        // If we were supposed to count zeros, subtract ones count from total number of bits.
-        if (count_type == 0) score = bits.size() - score;
+      std::cout << "Max " << score_trait.GetName() << " = " << max_score << std::endl;
+      return max_score;
+    }
 
-        // Store the count on the organism in the score trait.
-        score_trait(org) = score;
+    /// Calculate and store the score of one organism.
+    double CalcScore(Organism & org) {
+      // Count the number of ones in the bit sequence (by popcount on each word).
+      const emp::BitVector & bits = bits_trait.View(org);
+      double score = (double) bits.CountOnes();
 
-        if (score > max_score || !max_org) {
-          max_score = score;
-          max_org = &org;
-        }
-      }
+      // If we were supposed to count zeros, subtract ones count from total number of bits.
+      if (count_type == 0) score = bits.size() - score;
 
-      std::cout << "Max " << score_trait.GetName() << " = " << max_score << std::endl;
-      return max_score;
+      // Store the count on the organism in the score trait.
+      score_trait(org) = score;
+      return score;
     }
+
+    bool EvaluateOrganism(Organism & org) override { CalcScore(org); return true; }
   };
 
   MABE_REGISTER_MODULE(EvalCountBits, "Evaluate bitstrings by counting ones (or zeros).");
@@ -47,6 +47,7 @@ namespace mabe {
     double valley_start = 1.0;   // If we have valleys in the diagnostic, where should the first one start?
     double valley_end = 99.0;    // If we have valleys, where should it return to normal?
     double valley_slope = -1.0;  // If we have valleys, how much bigger should each be than the previous?
+    bool eval_offspring = false; // Score offspring as soon as they are made (so EVAL can skip them)?
     // double valley_growth = 0.0;  // If we have valleys, how much bigger should each be than the previous?
 
   public:
@@ -60,17 +61,17 @@ namespace mabe {
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction(
         "EVAL",
-        [](EvalDiagnostic & mod, Collection orgs) { return mod.Evaluate(orgs); },
+        [](EvalDiagnostic & mod, const Collection & orgs) { return mod.Evaluate(orgs); },
         "Evaluate organisms using the specified diagnostic."
       );
       info.AddMemberFunction(
         "COLLECTIVE_SCORE",
-        [](EvalDiagnostic & mod, Collection orgs) { return mod.CalcCollectiveScore(orgs); },
+        [](EvalDiagnostic & mod, const Collection & orgs) { return mod.CalcCollectiveScore(orgs); },
         "Sum the best scores in the whole population, trait-by-trait."
       );
       info.AddMemberFunction(
         "LOWEST_ACTIVE",
-        [](EvalDiagnostic & mod, Collection orgs) { return mod.FindLowestActive(orgs); },
+        [](EvalDiagnostic & mod, const Collection & orgs) { return mod.FindLowestActive(orgs); },
         "Determine the earliest active position."
       );
     }
@@ -89,12 +90,30 @@ namespace mabe {
       LinkVar(valley_end,    "valley_end",    "Value for linear growth to resume.");
       LinkVar(valley_slope,  "valley_slope",  "How quickly doe the valleys descend?");
       // LinkVar(valley_growth, "valley_growth", "How much wider is each valley then the last.");
+      LinkVar(eval_offspring, "eval_offspring", "Score each offspring right after it is mutated"
+              " (while its values are in cache), so EVAL can skip it?");
     }
 
     void SetupModule() override {
       // Nothing needed here yet...
     }
 
+    /// @brief Find where a run of non-increasing values that begins at 'start' ends.
+    /// Values are compared a block at a time without branches (so the comparisons can be
+    /// vectorized); only the block containing the first increase is rescanned one by one.
+    static size_t FindRunEnd(std::span<const double> vals, size_t start) {
+      constexpr size_t BLOCK = 8;
+      size_t pos = start + 1;
+      while (pos + BLOCK <= vals.size()) {
+        bool stop = false;
+        for (size_t i = 0; i < BLOCK; ++i) stop |= !(vals[pos+i] <= vals[pos+i-1]);
+        if (stop) break;
+        pos += BLOCK;
+      }
+      while (pos < vals.size() && vals[pos] <= vals[pos-1]) ++pos;
+      return pos;
+    }
+
     /// @brief Take a set of initial scores, clean them up, apply valleys, and return the sum.
     double FinalizeScores(std::span<double> scores, size_t start, size_t end) const {
       emp_assert(start <= end);
@@ -104,15 +123,16 @@ namespace mabe {
       if (start > 0) std::fill(scores.begin(), scores.begin()+start, 0.0);
       if (end < scores.size()) std::fill(scores.begin()+end, scores.end(), 0.0);
 
-      // If we have valleys, apply them.
+      // If we have valleys, apply them.  Every score is transformed and then selected, rather
+      // than branching, so that the loop can be vectorized.
       if (valley_width > 0.0) {
         for (size_t pos = start; pos < end; ++pos) {
-          double & score = scores[pos];
-          if (score <= valley_start || score >= valley_end) continue; // Not near valleys.
-          double valley_offset = score - valley_start;
-          double peak = std::floor(valley_offset / valley_width) * valley_width + valley_start;
-          double decline = (score - peak) * valley_slope;
-          score = peak + decline;
+          const double score = scores[pos];
+          const double valley_offset = score - valley_start;
+          const double peak = std::floor(valley_offset / valley_width) * valley_width + valley_start;
+          const double decline = (score - peak) * valley_slope;
+          const bool near_valleys = score > valley_start && score < valley_end;
+          scores[pos] = near_valleys ? peak + decline : score;
         }
       }
 
@@ -120,127 +140,127 @@ namespace mabe {
       return std::accumulate(scores.begin()+start, scores.begin()+end, 0.0);
     }
 
-    double Evaluate(Collection orgs) {
-      // Track the organism with the highest total score.
-      double max_total = 0.0;
-      emp::Ptr<Organism> max_org = nullptr;
+    double Evaluate(const Collection & orgs) {
+      // Evaluate each living organism (in parallel if num_threads > 1); return the max total.
+      return control.EvaluateOrgs(orgs, [this](Organism & org) {
+        if (eval_offspring) {               // Skip offspring already scored at birth.
+          if (org.HasEvalRecord(this, 1)) return total_trait(org);
+          org.SetEvalRecord(this, 1);
+        }
+        return ScoreOrg(org);
+      });
+    }
 
-      // Loop through the living organisms in the target collection to evaluate each.
-      mabe::Collection alive_orgs( orgs.GetAlive() );
-      for (Organism & org : alive_orgs) {        
-        // Make sure this organism has its values ready for us to access.
-        org.GenerateOutput();
+    void OnOffspringReady(Organism & offspring, OrgPosition ppos, Population & target_pop) override {
+      if (!eval_offspring) { Module::OnOffspringReady(offspring, ppos, target_pop); return; }
+      if (offspring.HasEvalRecord(this, 1)) return;    // Unmutated clone; still valid.
+      ScoreOrg(offspring);
+      offspring.SetEvalRecord(this, 1);
+    }
 
-        // Get access to the data_map elements that we need.
-        std::span<double> vals = vals_trait(org);
-        std::span<double> scores = scores_trait(org);
-        emp_assert(vals.size() == scores.size());
-
-        double & total_score = total_trait(org);
-        size_t & first_active = first_trait(org);
-        size_t & active_count = active_count_trait(org);
-
-        // Initialize output values.
-        total_score = 0.0;
-        size_t pos = 0;
-
-        // Determine the scores based on the diagnostic type that we're using.
-        switch (diagnostic_id) {
-        case EXPLOIT:
-          std::copy(vals.begin(), vals.end(), scores.begin());
-          total_score = FinalizeScores(scores, 0, scores.size());
-          first_active = 0;
-          active_count = vals.size();
-          break;
-        case STRUCT_EXPLOIT:
-          scores[0] = vals[0];
-          first_active = 0;
-
-          // Use values as long as they are monotonically decreasing.
-          for (pos = 1; pos < vals.size() && vals[pos] <= vals[pos-1]; ++pos) {
-            scores[pos] = vals[pos];
-          }
-          active_count = pos;
-
-          total_score = FinalizeScores(scores, 0, pos);
-          break;
-        case EXPLORE:
-          // Start at highest value (clearing everything before it)
-          pos = emp::FindMaxIndex(vals);  // Find the position to start.
-
-          scores[pos] = vals[pos];
-          first_active = pos;
-          pos++;
-
-          // Use values as long as they are monotonically non-increasing.
-          while (pos < vals.size() && vals[pos] <= vals[pos-1]) {
-            scores[pos] = vals[pos];
-            pos++;
-          }
-          active_count = pos - first_active;
-
-          total_score = FinalizeScores(scores, first_active, pos);
-          break;
-        case DIVERSITY:
-          // Only count highest value
-          pos = emp::FindMaxIndex(vals);  // Find the sole active position.
-          scores[pos] = vals[pos];
-          first_active = pos;
-          active_count = 1;
-
-          // All others are subtracted from max and divided by two, creating a
-          // pressure to minimize.
-          for (size_t i = 0; i < vals.size(); i++) {
-            if (i != pos) total_score += (scores[i] = (vals[pos] - vals[i]) / 2.0);
-          }
-
-          total_score = FinalizeScores(scores, 0, scores.size());
-
-          break;
-        case WEAK_DIVERSITY:
-          // Only count highest value
-          pos = emp::FindMaxIndex(vals);  // Find the position to start.
-          scores[pos] = vals[pos];
-          first_active = pos;
-          active_count = 1;
-
-          total_score = FinalizeScores(scores, first_active, first_active+1);
-
-          break;
-        default:
-          emp_error("Unknown Diagnostic.");
+    /// Calculate and store all of the scores for one organism; return its total.
+    double ScoreOrg(Organism & org) {
+      // Make sure this organism has its values ready for us to access.
+      org.GenerateOutput();
+
+      // Get access to the data_map elements that we need.
+      std::span<double> vals = vals_trait(org);
+      std::span<double> scores = scores_trait(org);
+      emp_assert(vals.size() == scores.size());
+
+      double & total_score = total_trait(org);
+      size_t & first_active = first_trait(org);
+      size_t & active_count = active_count_trait(org);
+
+      // Initialize output values.
+      total_score = 0.0;
+      size_t pos = 0;
+
+      // Determine the scores based on the diagnostic type that we're using.
+      switch (diagnostic_id) {
+      case EXPLOIT:
+        std::copy(vals.begin(), vals.end(), scores.begin());
+        total_score = FinalizeScores(scores, 0, scores.size());
+        first_active = 0;
+        active_count = vals.size();
+        break;
+      case STRUCT_EXPLOIT:
+        first_active = 0;
+
+        // Use values as long as they are monotonically decreasing.
+        pos = FindRunEnd(vals, 0);
+        std::copy(vals.begin(), vals.begin()+pos, scores.begin());
+        active_count = pos;
+
+        total_score = FinalizeScores(scores, 0, pos);
+        break;
+      case EXPLORE:
+        // Start at highest value (clearing everything before it)
+        pos = emp::FindMaxIndex(vals);  // Find the position to start.
+
+        first_active = pos;
+
+        // Use values as long as they are monotonically non-increasing.
+        pos = FindRunEnd(vals, first_active);
+        std::copy(vals.begin()+first_active, vals.begin()+pos, scores.begin()+first_active);
+        active_count = pos - first_active;
+
+        total_score = FinalizeScores(scores, first_active, pos);
+        break;
+      case DIVERSITY:
+        // Only count highest value
+        pos = emp::FindMaxIndex(vals);  // Find the sole active position.
+        first_active = pos;
+        active_count = 1;
+
+        // All others are subtracted from max and divided by two, creating a
+        // pressure to minimize.  (Fill all without branching, then restore the max.)
+        {
+          const double max_val = vals[pos];
+          for (size_t i = 0; i < vals.size(); i++) scores[i] = (max_val - vals[i]) / 2.0;
+          scores[pos] = max_val;
         }
 
-        if (total_score > max_total || !max_org) {
-          max_total = total_score;
-          max_org = &org;
-        }
+        total_score = FinalizeScores(scores, 0, scores.size());
+
+        break;
+      case WEAK_DIVERSITY:
+        // Only count highest value
+        pos = emp::FindMaxIndex(vals);  // Find the position to start.
+        scores[pos] = vals[pos];
+        first_active = pos;
+        active_count = 1;
+
+        total_score = FinalizeScores(scores, first_active, first_active+1);
+
+        break;
+      default:
+        emp_error("Unknown Diagnostic.");
       }
-      return max_total;
+
+      return total_score;
     }
 
-    double CalcCollectiveScore(Collection orgs) const {
-      mabe::Collection alive_orgs( orgs.GetAlive() );
+    double CalcCollectiveScore(const Collection & orgs) const {
       emp::vector<double> best_scores(num_vals, 0.0);
-      for (Organism & org : alive_orgs) {
+      orgs.ForEachAlive([this, &best_scores](Organism & org) {
         std::span<double> scores = scores_trait(org);
         for (size_t i = 0; i < scores.size(); ++i) {
           if (scores[i] > best_scores[i]) best_scores[i] = scores[i];
         }
-      }
+      });
       double total_score = std::accumulate(best_scores.begin(), best_scores.end(), 0.0);
       return total_score;
     }
 
-    double FindLowestActive(Collection orgs) const {
-      mabe::Collection alive_orgs( orgs.GetAlive() );
+    double FindLowestActive(const Collection & orgs) const {
       size_t lowest_active = num_vals;
-      for (Organism & org : alive_orgs) {
+      orgs.ForEachAlive([this, &lowest_active](Organism & org) {
         // Get access to the data_map elements that we need.
         std::span<double> vals = vals_trait(org);
         size_t pos = emp::FindMaxIndex(vals);  // Find the first active position
         if (pos < lowest_active) lowest_active = pos;
-      }
+      });
 
       return lowest_active;
     }
@@ -16,6 +16,7 @@
 
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
+#include "../../tools/BitKernels.hpp"
 
 #include "emp/datastructs/reference_vector.hpp"
 #include "emp/tools/String.hpp"
@@ -30,8 +31,8 @@ namespace mabe {
       UNKNOWN
     };
 
-    emp::String bits_trait = "bits";
-    emp::String score_trait = "bit_matches";
+    RequiredTrait<emp::BitVector> bits_trait{this, "bits", "Bit sequence to evaluate."};
+    OwnedTrait<double> score_trait{this, "bit_matches", "Match score value"};
     Type match_type = Type::MATCH_COUNT;
     bool record_both = false;             // Save result on both organisms? (vs. first only)
     double empty_score = 0.0;             // Score to give orgs matched with empty positions.
@@ -43,6 +44,8 @@ namespace mabe {
       : Module(control, name, desc)
     {
       SetEvaluateMod(true);
+      score_trait.SetConfigName("score_trait");
+      score_trait.SetConfigDesc("Trait to store match score result.");
     }
     ~EvalMatchBits() { }
 
@@ -56,8 +59,6 @@ namespace mabe {
     }
 
     void SetupConfig() override {
-      LinkVar(bits_trait, "bits_trait", "Trait storing bit sequence to evaluate.");
-      LinkVar(score_trait, "score_trait", "Trait to store match score result.");
       LinkMenu(match_type, "match_type", "How should the bit sequences be compared?",
         Type::MATCH_COUNT, "match_count", "Count bit positions with the same value.",
         Type::MISMATCH_COUNT, "mismatch_count", "Count bit positions with the different values.");
@@ -65,31 +66,21 @@ namespace mabe {
       LinkVar(empty_score, "empty_score", "Score to give orgs matched again an empty position?");
     }
 
-    void SetupModule() override {
-      AddRequiredTrait<emp::BitVector>(bits_trait);
-      AddOwnedTrait<double>(score_trait, "Match score value", 0.0);
-    }
-
     double EvaluateMatch(Organism & org1, Organism & org2) {      
       double match_score = empty_score;
 
       // Only calculate a real score if both organisms are non-empty.
       if (!org1.IsEmpty() && !org2.IsEmpty()) {
-        // Make sure both organisms have bit sequences ready for us to access.
-        org1.GenerateOutput();
-        org2.GenerateOutput();
-
-        const emp::BitVector & bits1 = org1.GetTrait<emp::BitVector>(bits_trait);
-        const emp::BitVector & bits2 = org2.GetTrait<emp::BitVector>(bits_trait);
-        org1.SetTrait<double>(score_trait, match_score);
+        const emp::BitVector & bits1 = bits_trait.View(org1);
+        const emp::BitVector & bits2 = bits_trait.View(org2);
 
-        // Count the number of matches in the bit sequences.
+        // Count the number of matches in the bit sequences (one XOR + popcount per word).
         switch (match_type) {
           case Type::MATCH_COUNT:
-            match_score = (double) (bits1 ^ bits2).CountZeros();
+            match_score = (double) CountMatches(bits1, bits2);
             break;
-          case Type::MISMATCH_COUNT:          
-            match_score = (double) (bits1 ^ bits2).CountOnes();
+          case Type::MISMATCH_COUNT:
+            match_score = (double) CountMismatches(bits1, bits2);
             break;
           default:
             emp_error("Unknown match type for EvalMatchBits!");
@@ -98,10 +89,10 @@ namespace mabe {
       }
 
       if (!org1.IsEmpty()) {
-        org1.SetTrait<double>(score_trait, match_score);
+        score_trait(org1) = match_score;
       }
       if (record_both && !org2.IsEmpty()) {
-        org2.SetTrait<double>(score_trait, match_score);
+        score_trait(org2) = match_score;
       }
 
       return match_score;
@@ -118,6 +109,21 @@ namespace mabe {
       emp_assert (orgs1.GetSize() == orgs2.GetSize(),
                   "EvalMatchBits::Evaluate requires two OrgLists of the same size.");
 
+      // Pairs can only be evaluated in parallel if no organism is in both lists.
+      ThreadPool & pool = control.GetThreadPool();
+      if (pool.IsParallel() && (Collection(orgs1) &= orgs2).GetSize() == 0) {
+        emp::vector<emp::Ptr<Organism>> org_ptrs1, org_ptrs2;
+        org_ptrs1.reserve(orgs1.GetSize());
+        org_ptrs2.reserve(orgs2.GetSize());
+        for (Organism & org : orgs1) org_ptrs1.push_back(&org);
+        for (Organism & org : orgs2) org_ptrs2.push_back(&org);
+
+        const double max_match = pool.MaxOf(org_ptrs1.size(), [this, &org_ptrs1, &org_ptrs2](size_t id){
+          return EvaluateMatch(*org_ptrs1[id], *org_ptrs2[id]);
+        });
+        return std::max(best_match, max_match);
+      }
+
       auto it1 = orgs1.begin();
       auto it2 = orgs2.begin();
       while (it1 != orgs1.end()) {
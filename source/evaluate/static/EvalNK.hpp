@@ -5,6 +5,21 @@
  *
  *  @file  EvalNK.hpp
  *  @brief MABE Evaluation module for NK Landscapes
+ *
+ *  With delta_eval on, each organism keeps its per-gene fitnesses and the bits they were
+ *  computed from; offspring start with copies of their parent's, so re-evaluating one only
+ *  recomputes the genes that overlap bits that changed since.
+ *
+ *  Otherwise, common (N, K) combinations are evaluated with a compile-time sized landscape
+ *  (see NK-const.hpp); other sizes use the runtime NKLandscape.  Both draw the same random
+ *  values, so results do not depend on which one is used.
+ *
+ *  By default the landscape is drawn from the main random number generator.  Setting
+ *  landscape_seed draws it from its own seed instead, so replicates with different random
+ *  seeds evolve on the same landscape; replicates in one process then share a single copy
+ *  (see SharedResources.hpp), and Reset() keeps it.  Setting shared_cache as well (e.g., to
+ *  /dev/shm) lets separate processes map one copy of the runtime table from that directory
+ *  (see SharedMemoryCache.hpp) instead of each building its own.
  */
 
 #ifndef MABE_EVAL_NK_H
@@ -12,6 +27,9 @@
 
 #include "../../core/EvalModule.hpp"
 #include "../../tools/NK.hpp"
+#include "../../tools/NK-const.hpp"
+#include "../../tools/SharedMemoryCache.hpp"
+#include "../../tools/SharedResources.hpp"
 
 #include "emp/datastructs/reference_vector.hpp"
 
@@ -23,11 +41,40 @@ namespace mabe {
     RequiredTrait<emp::BitVector> bits_trait{this, "bits", "Bit-sequence to evaluate."};
     OwnedTrait<double> fitness_trait{this, "fitness", "NK fitness value"};
     // OwnedTrait<emp::vector<double>> gene_fitness{this, "gene_fitness", "Individual gene fitnesses"};
+    OwnedTrait<emp::vector<double>> delta_genes_trait{this, "nk_delta_genes",
+      "Gene fitnesses from the last NK evaluation (for delta_eval)"};
+    OwnedTrait<emp::BitVector> delta_bits_trait{this, "nk_delta_bits",
+      "Bits used in the last NK evaluation (for delta_eval)"};
 
     // ConfigVar<size_t> N {this, "N", 100, "Total number of bits required in sequence"};
     size_t N = 100;
     size_t K = 2;    
-    NKLandscape landscape;
+    int landscape_seed = 0;  ///< Seed for the landscape (0 = use the main random generator).
+    emp::String shared_cache = "";  ///< Directory to share seeded tables across processes.
+    bool delta_eval = false;
+
+    /// Everything drawn from the landscape's random values.
+    struct Landscape {
+      NKLandscape table;
+      std::function<double(const emp::BitVector &)> const_fun;  ///< Used if set.
+    };
+    std::shared_ptr<const Landscape> landscape;
+
+    /// Build a landscape from 'random'; if 'cache_dir' is set, map the runtime table from the
+    /// file cached there under 'key' (filling it from 'random' if it does not exist yet).
+    static Landscape BuildLandscape(size_t N, size_t K, bool delta_eval, emp::Random & random,
+                                    const std::string & cache_dir="", const std::string & key="") {
+      Landscape out;
+      if (!delta_eval) out.const_fun = MakeNKConstFitnessFun(N, K, random);
+      if (out.const_fun) return out;
+      if (cache_dir.empty()) out.table.Config(N, K, random);
+      else {
+        const size_t num_values = N * emp::IntPow<size_t>(2, K+1);
+        out.table.Config(N, K, SharedMemoryCache::GetArray<double>(key, num_values,
+          [&random](std::span<double> values){ NKLandscape::FillTable(values, random); }, cache_dir));
+      }
+      return out;
+    }
     // bool track_gene_fitness = false;
 
   public:
@@ -40,46 +87,97 @@ namespace mabe {
     void SetupConfig() override {
       LinkVar(N, "N", "Total number of bits required in sequence");
       LinkVar(K, "K", "Number of bits used in each gene");
+      LinkVar(landscape_seed, "landscape_seed", "Seed for the landscape; 0 uses the main random"
+              " seed (a fixed seed gives every replicate the same landscape)");
+      LinkVar(shared_cache, "shared_cache", "Directory (e.g., /dev/shm) where processes share"
+              " the table for a fixed landscape_seed; empty builds it in each process");
+      LinkVar(delta_eval, "delta_eval", "Only recompute genes affected by bits that changed since"
+              " the organism (or its parent) was last evaluated?");
       // LinkVar(track_gene_fitness, "track_gene_fitness", "Should we track the fitness contribution of each gene?");
     }
 
     void SetupModule() override {
-      // Setup the fitness landscape.
-      landscape.Config(N, K, control.GetRandom());  // Setup the fitness landscape.
+      ConfigLandscape();
     }
 
-    double EvaluateCollection(const Collection & orgs) override {
-      // Loop through the population and evaluate each organism.
-      double max_fitness = 0.0;
-      emp::Ptr<Organism> max_org = nullptr;
-      mabe::Collection alive_orgs( orgs.GetAlive() );
-      for (Organism & org : alive_orgs) {
-        org.GenerateOutput();
-        const auto & bits = bits_trait(org);
-        if (bits.size() != N) {
-          emp::notify::Error("Org returns ", bits.size(), " bits, but ",
-                             N, " bits needed for NK landscape.",
-                             "\nOrg: ", org.ToString());
-        }
+    /// Build the fitness landscape, using a compile-time sized one when available.
+    void ConfigLandscape() {
+      if (landscape_seed == 0) {
+        landscape =
+          std::make_shared<const Landscape>(BuildLandscape(N, K, delta_eval, control.GetRandom()));
+        return;
+      }
+      const std::string key = "EvalNK:" + std::to_string(N) + "," + std::to_string(K) + ","
+                            + std::to_string(delta_eval) + "," + std::to_string(landscape_seed);
+      landscape = SharedResources::Global().Get<Landscape>(key, [this](){
+        emp::Random random(landscape_seed);
+        return BuildLandscape(N, K, delta_eval, random, shared_cache.str(), key);
+      });
+    }
 
-        // if (track_gene_fitness) {
-        //   gene_fitness(org) = landscape.GetGeneFitnesses(bits);
-        // }
-        const double fitness = landscape.GetFitness(bits);
-        fitness_trait(org) = fitness;
+    /// Calculate and store the fitness of one organism.
+    double CalcFitness(Organism & org) {
+      const auto & bits = bits_trait.View(org);
+      if (bits.size() != N) {
+        emp::notify::Error("Org returns ", bits.size(), " bits, but ",
+                           N, " bits needed for NK landscape.",
+                           "\nOrg: ", org.ToString());
+      }
 
-        if (fitness > max_fitness || !max_org) {
-          max_fitness = fitness;
-          max_org = &org;
-        }
+      // if (track_gene_fitness) {
+      //   gene_fitness(org) = landscape.GetGeneFitnesses(bits);
+      // }
+      const double fitness = Memoize(std::hash<emp::BitVector>()(bits), [this, &bits, &org](){
+        if (delta_eval) return CalcDeltaFitness(org, bits);
+        return landscape->const_fun ? landscape->const_fun(bits) : landscape->table.GetFitness(bits);
+      });
+      fitness_trait(org) = fitness;
+      return fitness;
+    }
+
+    double EvaluateCollection(const Collection & orgs) override {
+      // Evaluate each organism (in parallel if num_threads > 1) and return the max fitness.
+      return EvaluateOrgs(orgs, CacheEval([this](Organism & org) { return CalcFitness(org); },
+                                                  [this](const Organism & org) { return fitness_trait(org); }));
+    }
+
+    /// With eval_offspring, delta_eval compares the fresh offspring against its parent's bits,
+    /// so only genes touched by this birth's mutations are recomputed.
+    bool EvaluateOrganism(Organism & org) override { CalcFitness(org); return true; }
+
+    /// Update the gene fitnesses stored on an organism to match its bits; return total fitness.
+    double CalcDeltaFitness(Organism & org, const emp::BitVector & bits) {
+      emp::vector<double> & genes = delta_genes_trait(org);
+      emp::BitVector & last_bits = delta_bits_trait(org);
+      double fitness = 0.0;
+
+      // Recompute everything when there is no valid record or too many bits have changed.
+      if (genes.size() != N || last_bits.GetSize() != N
+          || (bits ^ last_bits).CountOnes() * (K+1) >= N) {
+        genes = landscape->table.GetGeneFitnesses(bits);
+        for (double gene_fit : genes) fitness += gene_fit;
       }
+      else fitness = landscape->table.UpdateGeneFitnesses(last_bits, bits, genes);
 
-      return max_fitness;
+      last_bits = bits;
+      return fitness;
     }
 
-    /// Re-randomize all of the entries.
+    /// Re-randomize all of the entries (unless landscape_seed fixes them).
     double Reset() override {
-      landscape.Config(N, K, control.GetRandom());
+      if (landscape_seed != 0) return 0.0;
+      ConfigLandscape();
+      InvalidateEvalCache();
+
+      // Stored gene fitnesses came from the old landscape.
+      if (delta_eval) {
+        for (size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id) {
+          Population & pop = control.GetPopulation(pop_id);
+          for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+            if (!pop.IsEmpty(pos)) delta_genes_trait(pop[pos]).clear();
+          }
+        }
+      }
       return 0.0;
     }
   };
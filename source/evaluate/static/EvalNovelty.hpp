@@ -0,0 +1,168 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EvalNovelty.hpp
+ *  @brief MABE Evaluation module that scores organisms by how novel their behavior is.
+ *
+ *  Each organism's novelty is its mean Euclidean distance to the 'num_neighbors' nearest
+ *  behaviors among the rest of the collection and a behavior archive.  Organisms whose novelty
+ *  is above archive_threshold (and any others with probability archive_prob) are then added to
+ *  the archive, which keeps at most archive_size behaviors by replacing the oldest.
+ *
+ *  Nearest neighbors are found approximately with locality-sensitive hashing (LSHIndex), so a
+ *  generation costs roughly the population size times the bucket sizes instead of the
+ *  population size times the archive size.  Set bucket_width near typical neighbor distances;
+ *  lookups run across the thread pool.
+ */
+
+#ifndef MABE_EVAL_NOVELTY_H
+#define MABE_EVAL_NOVELTY_H
+
+#include <algorithm>
+
+#include "emp/tools/String.hpp"
+
+#include "../../core/MABE.hpp"
+#include "../../core/Module.hpp"
+#include "../../tools/LSHIndex.hpp"
+
+namespace mabe {
+
+  class EvalNovelty : public Module {
+  private:
+    RequiredTrait<emp::vector<double>> behavior_trait{this, "behavior", "Behavior values to compare."};
+    OwnedTrait<double> novelty_trait{this, "novelty", "Mean distance to the nearest behaviors."};
+
+    size_t num_neighbors = 15;        ///< Nearest behaviors averaged for novelty.
+    size_t archive_size = 1000;       ///< Maximum behaviors kept in the archive.
+    double archive_threshold = 0.0;   ///< Novelty needed to join the archive (0 = none).
+    double archive_prob = 0.0;        ///< Chance of any organism joining the archive.
+    size_t lsh_tables = 8;            ///< Hash tables in each index.
+    size_t lsh_hashes = 4;            ///< Projections combined in each table's key.
+    double bucket_width = 1.0;        ///< Width of each projection's buckets.
+
+    LSHIndex archive;                 ///< Behaviors of past novel organisms.
+    LSHIndex pop_index;               ///< Behaviors of the collection being evaluated.
+    emp::vector<double> behaviors;    ///< [org][dim] behaviors of the current collection.
+    emp::vector<double> novelty;      ///< Novelty of each organism in the current collection.
+
+    void SetupIndex(LSHIndex & index, size_t num_dims, size_t capacity) {
+      index.Setup(num_dims, capacity, lsh_tables, lsh_hashes, bucket_width, control.GetRandomSeed());
+    }
+
+  public:
+    EvalNovelty(mabe::MABE & control,
+                emp::String name="EvalNovelty",
+                emp::String desc="Evaluate organisms by the novelty of their behavior.")
+      : Module(control, name, desc) { SetEvaluateMod(true); }
+    ~EvalNovelty() { }
+
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("EVAL",
+        [](EvalNovelty & mod, const Collection & orgs) { return mod.Evaluate(orgs); },
+        "Score organisms by novelty and update the behavior archive.");
+      info.AddMemberFunction("ARCHIVE_SIZE",
+        [](EvalNovelty & mod) { return mod.archive.GetSize(); },
+        "Number of behaviors currently in the archive.");
+      info.AddMemberFunction("CLEAR_ARCHIVE",
+        [](EvalNovelty & mod) { mod.archive.Clear(); return 0; },
+        "Remove all behaviors from the archive.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(num_neighbors, "num_neighbors", "Number of nearest behaviors to average for novelty.");
+      LinkVar(archive_size, "archive_size", "Maximum behaviors in the archive (oldest are replaced).");
+      LinkVar(archive_threshold, "archive_threshold", "Novelty needed to join the archive (0 = never).");
+      LinkVar(archive_prob, "archive_prob", "Probability that any organism joins the archive.");
+      LinkVar(lsh_tables, "lsh_tables", "Hash tables for neighbor lookup (more finds more true neighbors).");
+      LinkVar(lsh_hashes, "lsh_hashes", "Projections per hash table (more makes buckets smaller).");
+      LinkVar(bucket_width, "bucket_width", "Bucket width for neighbor lookup; near typical neighbor distances.");
+    }
+
+    void SetupModule() override {
+      if (lsh_tables == 0 || lsh_hashes == 0 || bucket_width <= 0.0) {
+        emp::notify::Error("EvalNovelty requires positive lsh_tables, lsh_hashes, and bucket_width.");
+        lsh_tables = std::max<size_t>(lsh_tables, 1);
+        lsh_hashes = std::max<size_t>(lsh_hashes, 1);
+        if (bucket_width <= 0.0) bucket_width = 1.0;
+      }
+    }
+
+    double Evaluate(const Collection & orgs) {
+      // Collect the behavior of each living organism into one matrix.
+      emp::vector<Organism *> org_list;
+      orgs.ForEachAlive([&org_list](Organism & org) { org_list.push_back(&org); });
+      const size_t num_orgs = org_list.size();
+      if (num_orgs == 0) return 0.0;
+
+      for (Organism * org : org_list) org->GenerateOutput();
+      const size_t num_dims = behavior_trait(*org_list[0]).size();
+      behaviors.resize(num_orgs * num_dims);
+      for (size_t i = 0; i < num_orgs; ++i) {
+        const emp::vector<double> & org_behavior = behavior_trait(*org_list[i]);
+        if (org_behavior.size() != num_dims) {
+          emp::notify::Error("All organisms must have the same number of values in behavior trait '",
+                             behavior_trait.GetName(), "'.");
+          return 0.0;
+        }
+        std::copy(org_behavior.begin(), org_behavior.end(), behaviors.begin() + i * num_dims);
+      }
+
+      // (Re)build the indices if needed; the archive starts over if behaviors change size.
+      if (archive.GetNumDims() != num_dims || archive.GetCapacity() != archive_size) {
+        SetupIndex(archive, num_dims, archive_size);
+      }
+      if (pop_index.GetNumDims() != num_dims || pop_index.GetCapacity() < num_orgs) {
+        SetupIndex(pop_index, num_dims, num_orgs);
+      } else pop_index.Clear();
+      auto get_behavior = [this, num_dims](size_t i) {
+        return std::span<const double>(behaviors.data() + i * num_dims, num_dims);
+      };
+      for (size_t i = 0; i < num_orgs; ++i) pop_index.Add(get_behavior(i));
+
+      // Average the distances to the nearest neighbors in the population and archive.
+      novelty.resize(num_orgs);
+      control.GetThreadPool().ForEachChunk(num_orgs, [&](size_t, size_t start, size_t end) {
+        emp::vector<double> pop_dists, archive_dists, dists;
+        emp::vector<uint32_t> scratch;
+        for (size_t i = start; i < end; ++i) {
+          pop_index.FindNearest(get_behavior(i), num_neighbors, pop_dists, scratch, i);
+          if (archive.GetSize()) archive.FindNearest(get_behavior(i), num_neighbors, archive_dists, scratch);
+          else archive_dists.resize(0);
+          dists.resize(pop_dists.size() + archive_dists.size());
+          std::merge(pop_dists.begin(), pop_dists.end(), archive_dists.begin(), archive_dists.end(),
+                     dists.begin());
+          const size_t count = std::min(num_neighbors, dists.size());
+          double total = 0.0;
+          for (size_t n = 0; n < count; ++n) total += dists[n];
+          novelty[i] = count ? total / (double) count : 0.0;
+        }
+      });
+
+      // Record scores and grow the archive, in organism order.
+      emp::Random & random = control.GetRandom();
+      double max_novelty = 0.0;
+      for (size_t i = 0; i < num_orgs; ++i) {
+        novelty_trait(*org_list[i]) = novelty[i];
+        max_novelty = std::max(max_novelty, novelty[i]);
+        const bool add = (archive_threshold > 0.0 && novelty[i] > archive_threshold)
+                      || (archive_prob > 0.0 && random.P(archive_prob));
+        if (add && archive_size > 0) archive.Add(get_behavior(i));
+      }
+      return max_novelty;
+    }
+
+    // If a population is provided to Evaluate, first convert it to a Collection.
+    double Evaluate(Population & pop) { return Evaluate( Collection(pop) ); }
+
+    // If a string is provided to Evaluate, convert it to a Collection.
+    double Evaluate(const emp::String & in) { return Evaluate( control.ToCollection(in) ); }
+  };
+
+  MABE_REGISTER_MODULE(EvalNovelty, "Evaluate organisms by behavioral novelty against an archive.");
+}
+
+#endif
@@ -34,7 +34,7 @@ namespace mabe {
     /// Set up the EVAL method to be used in the config file
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction("EVAL",
-          [](EvalRandom & mod, Collection list) { return mod.Evaluate(list); },
+          [](EvalRandom & mod, const Collection & list) { return mod.Evaluate(list); },
           "Use EvalRandom to evaluate all orgs in an OrgList.");
     }
 
@@ -54,8 +54,7 @@ namespace mabe {
       // Loop through the population and evaluate each organism.
       double max_fitness = 0.0;
       emp::Ptr<Organism> max_org = nullptr;
-      mabe::Collection alive_orgs( orgs.GetAlive() );
-      for (Organism & org : alive_orgs) {
+      orgs.ForEachAlive([&](Organism & org) {
         double fitness = control.GetRandom().GetDouble() * max_score;
         org.SetTrait<double>(output_trait, fitness);
 
@@ -63,7 +62,7 @@ namespace mabe {
           max_fitness = fitness;
           max_org = &org;
         }
-      }
+      });
 
       return max_fitness;
     }
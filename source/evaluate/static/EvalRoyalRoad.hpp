@@ -13,17 +13,17 @@
 #ifndef MABE_EVAL_ROYAL_ROAD_H
 #define MABE_EVAL_ROYAL_ROAD_H
 
-#include "../../core/MABE.hpp"
-#include "../../core/Module.hpp"
+#include "../../core/EvalModule.hpp"
+#include "../../tools/BitKernels.hpp"
 
 #include "emp/datastructs/reference_vector.hpp"
 
 namespace mabe {
 
-  class EvalRoyalRoad : public Module {
+  class EvalRoyalRoad : public EvalModule<EvalRoyalRoad> {
   private:
-    emp::String bits_trait;
-    emp::String fitness_trait;
+    RequiredTrait<emp::BitVector> bits_trait{this, "bits", "Bit-sequence to evaluate."};
+    OwnedTrait<double> fitness_trait{this, "fitness", "Royal Road fitness value"};
 
     size_t brick_size = 8;
     double extra_bit_cost = 0.5;
@@ -32,62 +32,37 @@ namespace mabe {
     EvalRoyalRoad(mabe::MABE & control,
                   emp::String name="EvalRoyalRoad",
                   emp::String desc="Evaluate bitstrings by counting ones (or zeros).")
-      : Module(control, name, desc)
-      , bits_trait("bits")
-      , fitness_trait("fitness")
+      : EvalModule(control, name, desc)
     {
-      SetEvaluateMod(true);
+      bits_trait.SetConfigDesc("Which trait stores the bit sequence to evaluate?");
+      fitness_trait.SetConfigDesc("Which trait should we store Royal Road fitness in?");
+      SetConcurrentCalls(true);  // EVAL only reads bits and writes this module's fitness trait.
     }
     ~EvalRoyalRoad() { }
 
-    // Setup member functions associated with this class.
-    static void InitType(emplode::TypeInfo & info) {
-      info.AddMemberFunction("EVAL",
-                             [](EvalRoyalRoad & mod, Collection list) { return mod.Evaluate(list); },
-                             "Evaluate RoyalRoad on all orgs in an OrgList.");
-    }
-
     void SetupConfig() override {
-      LinkVar(bits_trait, "bits_trait", "Which trait stores the bit sequence to evaluate?");
-      LinkVar(fitness_trait, "fitness_trait", 
-          "Which trait should we store Royal Road fitness in?");
       LinkVar(brick_size, "brick_size", "Number of ones to have a whole brick in the road.");
       LinkVar(extra_bit_cost, "extra_bit_cost", "Penalty per-bit for extra-long roads.");
     }
 
-    void SetupModule() override {
-      AddRequiredTrait<emp::BitVector>(bits_trait);
-      AddOwnedTrait<double>(fitness_trait, "Royal Road fitness value", 0.0);
+    /// Royal Road fitness of a bit sequence: the leading ones, less a penalty for partial bricks.
+    double CalcFitness(const emp::BitVector & bits) const {
+      const size_t road_length = CountLeadingOnes(bits);
+      const size_t overage = road_length % brick_size;
+      return (double) road_length - (double) overage * (extra_bit_cost + 1.0);
     }
 
-    double Evaluate(Collection orgs) {
-      // Loop through the population and evaluate each organism.
-      double max_fitness = 0.0;
-      mabe::Collection alive_collect = orgs.GetAlive();
-      for (Organism & org : alive_collect) {        
-        // Make sure this organism has its bit sequence ready for us to access.
-        org.GenerateOutput();
-
-        // Count the number of contiguous ones at the start of the bit sequence.
-        const emp::BitVector & bits = org.GetTrait<emp::BitVector>(bits_trait);
-        int road_length = 0.0;
-        for (size_t i = 0; i < bits.size(); i++) {
-          if (bits[i] == 0) break;
-          road_length++;
-        }
-
-        const int overage = road_length % brick_size;
-
-        // Store the count on the organism in the fitness trait.
-        double fitness = road_length - overage * (extra_bit_cost + 1.0);
-        org.SetTrait<double>(fitness_trait, fitness);
-
-        if (fitness > max_fitness) {
-          max_fitness = fitness;
-        }
-      }
-
-      return max_fitness;
+    double EvaluateCollection(const Collection & orgs) override {
+      // Evaluate each organism (in parallel if num_threads > 1).
+      const double max_fitness = EvaluateOrgs(orgs, CacheEval([this](Organism & org) {
+        // Store the fitness on the organism.
+        const double fitness = CalcFitness(bits_trait.View(org));
+        fitness_trait(org) = fitness;
+        return fitness;
+      }, [this](const Organism & org) { return fitness_trait(org); }));
+
+      // Reported max is never below zero (even if all roads have penalties).
+      return std::max(max_fitness, 0.0);
     }
   };
 
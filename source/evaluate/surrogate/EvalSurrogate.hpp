@@ -0,0 +1,324 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EvalSurrogate.hpp
+ *  @brief MABE module to pre-screen organisms with a cheap model of an expensive evaluator.
+ *
+ *  The surrogate learns to predict the true fitness (from any other evaluator) from a set of
+ *  cheap feature traits, and is used from a script in three steps:
+ *
+ *    OrgList to_eval = surrogate.SCREEN(main_pop);   // Predict everyone; pick who to evaluate.
+ *    eval_paths.EVAL(to_eval);                        // Run the expensive evaluation on those.
+ *    surrogate.TRAIN(to_eval);                        // Learn from the true results.
+ *
+ *  SCREEN stores a prediction for every organism in surrogate_fitness and returns the
+ *  eval_fraction of them with the highest (prediction + explore * uncertainty), so promising
+ *  and uncertain organisms get the true evaluation; TRAIN then replaces their predictions with
+ *  true values.  Select on surrogate_fitness.  Until min_samples results have been seen, every
+ *  organism is evaluated.
+ *
+ *  Models:
+ *    knn    : mean true fitness of the k nearest stored samples (uncertainty = their spread).
+ *    linear : least-squares fit of fitness to the features (uncertainty = residual spread).
+ *
+ *  TRAIN compares each organism's prediction with its true value; mean absolute error and
+ *  correlation are available to scripts and, if output_file is set, logged for each TRAIN.
+ */
+
+#ifndef MABE_EVAL_SURROGATE_H
+#define MABE_EVAL_SURROGATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "../../core/MABE.hpp"
+#include "../../core/Module.hpp"
+#include "../../core/TraitSet.hpp"
+
+namespace mabe {
+
+  class EvalSurrogate : public Module {
+  private:
+    enum Model { KNN = 0, LINEAR };
+
+    emp::String feature_inputs;           ///< Which traits hold the model's features?
+    TraitSet<double> feature_set;         ///< Processed version of feature_inputs.
+    int model = KNN;                      ///< Which model should predict fitness?
+    size_t num_neighbors = 5;             ///< Neighbors averaged by the knn model.
+    double eval_fraction = 0.25;          ///< Fraction of screened organisms to truly evaluate.
+    double explore = 1.0;                 ///< Weight of uncertainty when choosing whom to evaluate.
+    size_t min_samples = 50;              ///< Samples needed before screening skips anyone.
+    size_t max_samples = 2000;            ///< Most samples kept (oldest are replaced).
+    emp::String filename = "";            ///< File to log accuracy at each TRAIN ("" = none).
+
+    RequiredTrait<double> true_trait{this, "fitness", "True fitness from the expensive evaluator"};
+    OwnedTrait<double> surrogate_trait{this, "surrogate_fitness", "True fitness if evaluated, else predicted"};
+    OwnedTrait<double> predicted_trait{this, "surrogate_prediction", "Surrogate's prediction of fitness"};
+
+    // Training samples: features (row-major) and true fitness, kept as a ring buffer.
+    size_t num_features = 0;
+    emp::vector<double> sample_features;
+    emp::vector<double> sample_values;
+    size_t next_sample = 0;
+
+    // Linear model: weights (bias last) and residual spread, refit at each TRAIN.
+    emp::vector<double> weights;
+    double residual_sd = 0.0;
+
+    // Accuracy of the most recent TRAIN and running totals.
+    double last_error = 0.0;
+    double last_correlation = 0.0;
+    size_t num_screened = 0;
+    size_t num_skipped = 0;
+    std::ofstream file;
+
+    size_t GetNumSamples() const { return sample_values.size(); }
+
+    const double * SampleFeatures(size_t id) const { return sample_features.data() + id * num_features; }
+
+    void AddSample(const emp::vector<double> & features, double value) {
+      if (GetNumSamples() < max_samples) {
+        sample_features.insert(sample_features.end(), features.begin(), features.end());
+        sample_values.push_back(value);
+        return;
+      }
+      std::copy(features.begin(), features.end(), sample_features.begin() + next_sample * num_features);
+      sample_values[next_sample] = value;
+      next_sample = (next_sample + 1) % max_samples;
+    }
+
+    /// Predict fitness (and its uncertainty) for one feature vector with the knn model.
+    std::pair<double,double> PredictKNN(const emp::vector<double> & features) const {
+      const size_t k = std::min(std::max<size_t>(num_neighbors, 1), GetNumSamples());
+      emp::vector<std::pair<double,size_t>> dists(GetNumSamples());
+      for (size_t id = 0; id < GetNumSamples(); ++id) {
+        const double * sample = SampleFeatures(id);
+        double dist = 0.0;
+        for (size_t f = 0; f < num_features; ++f) dist += (features[f] - sample[f]) * (features[f] - sample[f]);
+        dists[id] = {dist, id};
+      }
+      std::partial_sort(dists.begin(), dists.begin() + k, dists.end());
+      double sum = 0.0, sum_sq = 0.0;
+      for (size_t i = 0; i < k; ++i) {
+        const double value = sample_values[dists[i].second];
+        sum += value;
+        sum_sq += value * value;
+      }
+      const double mean = sum / k;
+      return { mean, std::sqrt(std::max(0.0, sum_sq / k - mean * mean)) };
+    }
+
+    /// Predict fitness (and its uncertainty) for one feature vector with the linear model.
+    std::pair<double,double> PredictLinear(const emp::vector<double> & features) const {
+      if (weights.size() != num_features + 1) return { 0.0, 0.0 };
+      double result = weights[num_features];
+      for (size_t f = 0; f < num_features; ++f) result += weights[f] * features[f];
+      return { result, residual_sd };
+    }
+
+    /// Refit linear weights by solving the (lightly regularized) normal equations.
+    void FitLinear() {
+      const size_t dim = num_features + 1;
+      emp::vector<double> mat(dim * (dim + 1), 0.0);   // Augmented [X'X | X'y]
+      auto row = [this](size_t id, size_t f) { return f < num_features ? SampleFeatures(id)[f] : 1.0; };
+      for (size_t id = 0; id < GetNumSamples(); ++id) {
+        for (size_t i = 0; i < dim; ++i) {
+          const double xi = row(id, i);
+          for (size_t j = 0; j < dim; ++j) mat[i * (dim+1) + j] += xi * row(id, j);
+          mat[i * (dim+1) + dim] += xi * sample_values[id];
+        }
+      }
+      for (size_t i = 0; i < dim; ++i) mat[i * (dim+1) + i] += 1e-6;
+
+      // Gaussian elimination with partial pivoting.
+      for (size_t col = 0; col < dim; ++col) {
+        size_t pivot = col;
+        for (size_t r = col+1; r < dim; ++r) {
+          if (std::abs(mat[r * (dim+1) + col]) > std::abs(mat[pivot * (dim+1) + col])) pivot = r;
+        }
+        for (size_t c = 0; c <= dim; ++c) std::swap(mat[col * (dim+1) + c], mat[pivot * (dim+1) + c]);
+        const double diag = mat[col * (dim+1) + col];
+        if (diag == 0.0) continue;
+        for (size_t r = 0; r < dim; ++r) {
+          if (r == col) continue;
+          const double scale = mat[r * (dim+1) + col] / diag;
+          for (size_t c = col; c <= dim; ++c) mat[r * (dim+1) + c] -= scale * mat[col * (dim+1) + c];
+        }
+      }
+      weights.resize(dim);
+      for (size_t i = 0; i < dim; ++i) {
+        const double diag = mat[i * (dim+1) + i];
+        weights[i] = diag == 0.0 ? 0.0 : mat[i * (dim+1) + dim] / diag;
+      }
+
+      double sum_sq = 0.0;
+      for (size_t id = 0; id < GetNumSamples(); ++id) {
+        double result = weights[num_features];
+        for (size_t f = 0; f < num_features; ++f) result += weights[f] * SampleFeatures(id)[f];
+        sum_sq += (result - sample_values[id]) * (result - sample_values[id]);
+      }
+      residual_sd = GetNumSamples() ? std::sqrt(sum_sq / GetNumSamples()) : 0.0;
+    }
+
+    emp::vector<emp::Ptr<Organism>> GetOrgPtrs(const Collection & orgs) const {
+      emp::vector<emp::Ptr<Organism>> org_ptrs;
+      org_ptrs.reserve(orgs.CountAlive());
+      orgs.ForEachAlive([&org_ptrs](Organism & org){ org_ptrs.push_back(&org); });
+      return org_ptrs;
+    }
+
+    void GetFeatures(Organism & org, emp::vector<double> & features) {
+      feature_set.GetValues(org.GetDataMap(), features);
+      emp_assert(num_features == 0 || features.size() == num_features, features.size(), num_features);
+    }
+
+    Collection Screen(const Collection & orgs) {
+      emp::vector<emp::Ptr<Organism>> org_ptrs = GetOrgPtrs(orgs);
+      if (org_ptrs.empty()) return Collection();
+      num_screened += org_ptrs.size();
+      if (GetNumSamples() < std::max<size_t>(min_samples, 1)) {   // Not trained yet: evaluate all.
+        for (emp::Ptr<Organism> org_ptr : org_ptrs) predicted_trait(*org_ptr) = std::nan("");
+        return orgs.GetAlive();
+      }
+
+      // Predict every organism (in parallel, since knn scans all samples).
+      emp::vector<double> scores(org_ptrs.size());
+      control.GetThreadPool().ForEach(org_ptrs.size(), [&](size_t i) {
+        emp::vector<double> features;
+        GetFeatures(*org_ptrs[i], features);
+        const auto [prediction, uncertainty] =
+          (model == KNN) ? PredictKNN(features) : PredictLinear(features);
+        predicted_trait(*org_ptrs[i]) = prediction;
+        surrogate_trait(*org_ptrs[i]) = prediction;
+        scores[i] = prediction + explore * uncertainty;
+      });
+
+      // Truly evaluate those with the highest optimistic scores.
+      const size_t num_eval = std::min(org_ptrs.size(),
+        (size_t) std::ceil(std::clamp(eval_fraction, 0.0, 1.0) * org_ptrs.size()));
+      emp::vector<size_t> ids(org_ptrs.size());
+      for (size_t i = 0; i < ids.size(); ++i) ids[i] = i;
+      std::nth_element(ids.begin(), ids.begin() + num_eval, ids.end(),
+                       [&scores](size_t a, size_t b){ return scores[a] > scores[b]; });
+      num_skipped += org_ptrs.size() - num_eval;
+
+      Collection out;
+      for (size_t i = 0; i < num_eval; ++i) out.Insert(org_ptrs[ids[i]]->GetPosition());
+      return out;
+    }
+
+    double Train(const Collection & orgs) {
+      emp::vector<emp::Ptr<Organism>> org_ptrs = GetOrgPtrs(orgs);
+      emp::vector<double> features;
+      double sum_error = 0.0, sum_p = 0.0, sum_t = 0.0, sum_pp = 0.0, sum_tt = 0.0, sum_pt = 0.0;
+      size_t num_predicted = 0;
+      for (emp::Ptr<Organism> org_ptr : org_ptrs) {
+        Organism & org = *org_ptr;
+        const double value = true_trait(org);
+        surrogate_trait(org) = value;
+        const double prediction = predicted_trait(org);
+        if (!std::isnan(prediction)) {
+          sum_error += std::abs(prediction - value);
+          sum_p += prediction;  sum_pp += prediction * prediction;
+          sum_t += value;       sum_tt += value * value;
+          sum_pt += prediction * value;
+          ++num_predicted;
+        }
+        GetFeatures(org, features);
+        if (num_features == 0) num_features = features.size();
+        AddSample(features, value);
+      }
+      if (model == LINEAR) FitLinear();
+
+      if (num_predicted) {
+        const double n = (double) num_predicted;
+        const double cov = sum_pt - sum_p * sum_t / n;
+        const double var_p = sum_pp - sum_p * sum_p / n;
+        const double var_t = sum_tt - sum_t * sum_t / n;
+        last_error = sum_error / n;
+        last_correlation = (var_p > 0.0 && var_t > 0.0) ? cov / std::sqrt(var_p * var_t) : 0.0;
+        if (file.is_open()) {
+          file << control.GetUpdate() << ',' << GetNumSamples() << ',' << num_predicted << ','
+               << last_error << ',' << last_correlation << '\n';
+        }
+      }
+      return last_error;
+    }
+
+  public:
+    EvalSurrogate(mabe::MABE & control,
+                  const emp::String & name="EvalSurrogate",
+                  const emp::String & desc="Pre-screen organisms with a cheap model of an expensive evaluator.")
+      : Module(control, name, desc)
+    {
+      SetEvaluateMod(true);
+      true_trait.SetConfigDesc("Which trait holds the true fitness from the expensive evaluator?");
+      surrogate_trait.SetConfigDesc("Which trait should hold true or predicted fitness (to select on)?");
+      predicted_trait.SetConfigDesc("Which trait should hold the surrogate's prediction?");
+    }
+    ~EvalSurrogate() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("SCREEN",
+        [](EvalSurrogate & mod, const Collection & orgs) { return mod.Screen(orgs); },
+        "Predict fitness for all orgs; return the OrgList that should be truly evaluated.");
+      info.AddMemberFunction("TRAIN",
+        [](EvalSurrogate & mod, const Collection & orgs) { return mod.Train(orgs); },
+        "Learn from truly-evaluated orgs; returns mean absolute error of their predictions.");
+      info.AddMemberFunction("ERROR",
+        [](EvalSurrogate & mod) { return mod.last_error; },
+        "Mean absolute prediction error at the most recent TRAIN.");
+      info.AddMemberFunction("CORRELATION",
+        [](EvalSurrogate & mod) { return mod.last_correlation; },
+        "Correlation of predicted and true fitness at the most recent TRAIN.");
+      info.AddMemberFunction("NUM_SAMPLES",
+        [](EvalSurrogate & mod) { return mod.GetNumSamples(); },
+        "Number of training samples currently stored.");
+      info.AddMemberFunction("SKIP_RATE",
+        [](EvalSurrogate & mod) {
+          return mod.num_screened ? (double) mod.num_skipped / (double) mod.num_screened : 0.0;
+        },
+        "Fraction of screened organisms that were not truly evaluated.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(feature_inputs, "feature_traits", "Which cheap traits should the model learn from?");
+      LinkMenu(model, "model", "Which model should predict fitness?",
+               KNN, "knn", "Mean fitness of the nearest stored samples",
+               LINEAR, "linear", "Least-squares linear fit to the features");
+      LinkVar(num_neighbors, "neighbors", "Number of nearest samples averaged by the knn model");
+      LinkVar(eval_fraction, "eval_fraction", "Fraction of screened organisms to truly evaluate");
+      LinkVar(explore, "explore", "Weight on prediction uncertainty when choosing whom to evaluate");
+      LinkVar(min_samples, "min_samples", "Training samples needed before any evaluations are skipped");
+      LinkVar(max_samples, "max_samples", "Most training samples to keep (oldest replaced first)");
+      LinkVar(filename, "output_file", "File to log prediction accuracy at each TRAIN (\"\" = none)");
+      predicted_trait.SetDefault(std::nan(""));   // No prediction yet.
+    }
+
+    void SetupModule() override {
+      for (const emp::String & name : feature_inputs.Slice(",")) {
+        AddRequiredTrait<double, emp::vector<double>>(name, TraitInfo::ANY_COUNT);
+      }
+      if (filename.size()) {
+        file.open(filename.str());
+        if (!file) {
+          emp::notify::Error("Module '", GetName(), "' could not open output file '", filename, "'.");
+          return;
+        }
+        file << "update,num_samples,num_predicted,mean_abs_error,correlation\n";
+      }
+    }
+
+    void SetupDataMap(emp::DataMap & dmap) override {
+      feature_set.SetLayout(dmap.GetLayout());
+      feature_set.SetTraits(feature_inputs);
+    }
+  };
+
+  MABE_REGISTER_MODULE(EvalSurrogate, "Pre-screen organisms with a cheap model of an expensive evaluator.");
+}
+
+#endif
@@ -5,11 +5,19 @@
  *
  *  @file  CommandLine.hpp
  *  @brief Module to output errors and warnings to the command line.
+ *
+ *  A status line with population sizes and the summaries in 'format' is printed every
+ *  'interval' updates (and no more often than every 'min_seconds').  Lines are buffered and
+ *  flushed at most every 'flush_seconds'; errors and warnings are always written immediately.
  */
 
 #ifndef MABE_COMMAND_LINE_H
 #define MABE_COMMAND_LINE_H
 
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 
@@ -17,31 +25,54 @@ namespace mabe {
 
   class CommandLine : public Module {
   private:
+    using clock_t = std::chrono::steady_clock;
+
     emp::String format;
     Collection target_collect;
+    size_t interval = 1;             ///< Updates between status lines.
+    double min_seconds = 0.0;        ///< Minimum seconds between status lines (0 = no limit).
+    double flush_seconds = 1.0;      ///< Seconds between flushes of buffered output.
 
     // Calculated values from the inputs.
-    using trait_fun_t = std::function<emp::String(const Collection &)>;
-    emp::vector<emp::String> cols;  ///< Names of the columns to use.
-    emp::vector<trait_fun_t> funs;  ///< Functions to call each update.
+    using trait_fun_t = std::function<emplode::Symbol_Var(Collection &, const emp::String &)>;
+    emp::vector<emp::String> cols;   ///< Names of the columns to use.
+    emp::vector<emp::String> traits; ///< Trait (or equation) summarized in each column.
+    emp::vector<trait_fun_t> funs;   ///< Summary function for each column.
     bool init = false;
 
+    clock_t::time_point last_report;
+    clock_t::time_point last_flush;
+
+    static double Seconds(clock_t::duration duration) {
+      return std::chrono::duration<double>(duration).count();
+    }
+
     void Initialize() {
       // Identify the contents of each column.
       emp::remove_whitespace(format);
       format.Slice(cols, ",");
 
       // Setup a function to collect data associated with each column.
+      traits.resize(cols.size());
       funs.resize(cols.size());
       for (size_t i = 0; i < cols.size(); i++) {
         emp::String trait_filter = cols[i];
-        emp::String trait_name = emp::string_pop(trait_filter,':');
-        funs[i] = control.BuildTraitSummary(trait_name, trait_filter);
+        traits[i] = emp::string_pop(trait_filter,':');
+        funs[i] = control.GetConfigScript().BuildTraitFunction<Collection>(trait_filter);
       }
 
       init = true;
     }
 
+    /// Write a status line, flushing only if flush_seconds have passed since the last flush.
+    void Write(const std::string & line, clock_t::time_point now) {
+      std::cout << line << '\n';
+      if (Seconds(now - last_flush) >= flush_seconds) {
+        std::cout.flush();
+        last_flush = now;
+      }
+    }
+
   public:
     CommandLine(mabe::MABE & control,
                 const emp::String & name="CommandLine",
@@ -58,16 +89,27 @@ namespace mabe {
     void SetupConfig() override {
       LinkVar(format, "format", "Column format to use in the file.");
       LinkCollection(target_collect, "target", "Which population(s) should we print from?");
+      LinkVar(interval, "interval", "Print status every this many updates.");
+      LinkVar(min_seconds, "min_seconds", "Minimum seconds between status lines (0 = no limit).");
+      LinkVar(flush_seconds, "flush_seconds", "Seconds between flushes of status output (0 = every line).");
     }
 
     void SetupModule() override {
+      if (interval == 0) interval = 1;
+      last_report = last_flush = clock_t::now();
     }
 
     void BeforeUpdate(size_t ud) override {
-      std::cout << "Update:" << ud;
+      if (ud % interval) return;
+      const clock_t::time_point now = clock_t::now();
+      if (ud && min_seconds > 0.0 && Seconds(now - last_report) < min_seconds) return;
+      last_report = now;
+
+      std::stringstream ss;
+      ss << "Update:" << ud;
 
       if (ud == 0) {               // At the very beginning, no stats available.
-        std::cout << std::endl;
+        Write(ss.str(), now);
         return;
       }
 
@@ -75,19 +117,21 @@ namespace mabe {
 
       for (size_t pop_id = 0; pop_id < control.GetNumPopulations(); pop_id++) {
         const Population & pop = control.GetPopulation(pop_id);
-        std::cout << "  " << pop.GetName() << ":" << pop.GetNumOrgs();
+        ss << "  " << pop.GetName() << ":" << pop.GetNumOrgs();
       }
 
+      // Summaries are computed as one row, so columns on the same trait share one scan.
       mabe::Collection cur_collect = target_collect.GetAlive();
+      emplode::DataFile::RowScope row_scope;
       for (size_t i = 0; i < funs.size(); ++i) {
-        std::cout << ", " << cols[i] << "=" << funs[i](cur_collect);
+        ss << ", " << cols[i] << "=" << funs[i](cur_collect, traits[i]).AsString();
       }
 
-      std::cout << std::endl;
+      Write(ss.str(), now);
     }
 
     void BeforeExit() override {
-      std::cout << "==> Exiting." << std::endl;
+      std::cout << "==> Exiting." << std::endl;   // Also flushes any buffered status lines.
     }
 
     void OnError(const emp::String & msg) override {
@@ -8,7 +8,16 @@
  */
 
 // Analyze Modules
+#include "analyze/AnalyzeInBackground.hpp"
+#include "analyze/ArchiveGenomes.hpp"
+#include "analyze/CompactPopulation.hpp"
+#include "analyze/InternGenotypes.hpp"
+#include "analyze/LogEvents.hpp"
+#include "analyze/PopulationDump.hpp"
+#include "analyze/ReportProgress.hpp"
+#include "analyze/ServeMetrics.hpp"
 #include "analyze/SystematicsModule.hpp"
+#include "analyze/TraitHistory.hpp"
 #include "analyze/TrackAncestor.hpp"
 
 // Evaluation Modules
@@ -20,6 +29,7 @@
 #include "evaluate/static/EvalDiagnostic.hpp"
 #include "evaluate/static/EvalMatchBits.hpp"
 #include "evaluate/static/EvalNK.hpp"
+#include "evaluate/static/EvalNovelty.hpp"
 #include "evaluate/static/EvalRoyalRoad.hpp"
 #include "evaluate/callable/EvalTaskNot.hpp"
 #include "evaluate/callable/EvalTaskNand.hpp"
@@ -30,27 +40,38 @@
 #include "evaluate/callable/EvalTaskNor.hpp"
 #include "evaluate/callable/EvalTaskXor.hpp"
 #include "evaluate/callable/EvalTaskEqu.hpp"
+#include "evaluate/callable/EvalLogicTasks.hpp"
 #include "evaluate/static/EvalPacking.hpp"
 #include "evaluate/static/EvalRandom.hpp"
+#include "evaluate/external/EvalExternal.hpp"
+#include "evaluate/surrogate/EvalSurrogate.hpp"
 
 // Placement Modules
 #include "placement/AnnotatePlacement_Position.hpp"
 #include "placement/RandomReplacement.hpp"
 #include "placement/MaxSizePlacement.hpp"
+#include "placement/GridPlacement.hpp"
+#include "placement/MigrateIslands.hpp"
 
 // Selection Modules
 #include "select/SelectElite.hpp"
 #include "select/SelectFitnessSharing.hpp"
 #include "select/SelectLexicase.hpp"
+#include "select/SelectNSGA2.hpp"
 #include "select/SchedulerProbabilistic.hpp"
+#include "select/SelectResource.hpp"
 #include "select/SelectRoulette.hpp"
+#include "select/SelectSharded.hpp"
+#include "select/SelectSteadyState.hpp"
 #include "select/SelectTournament.hpp"
 
 // Organism Types
 #include "orgs/BitsOrg.hpp"
 #include "orgs/BitSummaryOrg.hpp"
 #include "orgs/StatesOrg.hpp"
+#include "orgs/StateSummaryOrg.hpp"
 #include "orgs/ValsOrg.hpp"
+#include "orgs/ValsSummaryOrg.hpp"
 #include "orgs/AvidaGPOrg.hpp"
 #include "orgs/VirtualCPUOrg.hpp"
 #include "orgs/instructions/VirtualCPU_Inst_Nop.hpp"
@@ -14,6 +14,7 @@
 #include "../core/MABE.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
+#include "../tools/MutationSites.hpp"
 
 #include "emp/datastructs/vector_utils.hpp"
 #include "emp/hardware/AvidaGP.hpp"
@@ -31,6 +32,7 @@ namespace mabe {
       : OrganismTemplate<AvidaGPOrg>(_manager) { }
     AvidaGPOrg(const AvidaGPOrg &) = default;
     AvidaGPOrg(AvidaGPOrg &&) = default;
+    AvidaGPOrg & operator=(const AvidaGPOrg &) = default;
     ~AvidaGPOrg() { ; }
 
     struct ManagerData : public Organism::ManagerData {
@@ -41,36 +43,50 @@ namespace mabe {
       size_t eval_time = 500;              ///< How long should the CPU be given on each evaluate?
       emp::String input_name = "input";    ///< Name of trait that should be used load input values
       emp::String output_name = "output";  ///< Name of trait that should be used store output values
+      bool geometric_muts = false;         ///< Pick sites by sampling the gaps between them?
 
       // Internal use
-      emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;            ///< A pre-allocated vector for mutation sites. 
+      emp::Binomial mut_dist;              ///< Distribution of number of mutations to occur.
+      MutationSampler mut_sampler;         ///< Picks distinct sites to mutate (geometric_muts).
     };
 
     emp::String ToString() const override { return hardware.ToString(); }
 
-    size_t Mutate(emp::Random & random) override {
-      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
+    /// Each instruction (ID and up to three arguments) is one site.
+    uint64_t GetGenomeHash() const override {
+      return GenomeHash::Calc(hardware.GetSize(), [this](size_t pos){
+        const auto & inst = hardware.GetInst(pos);
+        return (uint64_t) inst.id ^ ((uint64_t) inst.args[0] << 16) ^
+               ((uint64_t) inst.args[1] << 32) ^ ((uint64_t) inst.args[2] << 48);
+      });
+    }
 
-      if (num_muts == 0) return 0;
-      if (num_muts == 1) {
-        const size_t pos = random.GetUInt(hardware.GetSize());
-        hardware.RandomizeInst(pos, random);
-        return 1;
+    size_t GetObjectBytes() const override {
+      return sizeof(AvidaGPOrg) + hardware.GetSize() * sizeof(emp::AvidaGP::inst_t);
+    }
+
+    /// By default, keep the random stream of earlier versions: draw a count of mutations, then
+    /// each site in turn (a site may be drawn more than once).  With geometric_muts, the sites
+    /// drawn are always distinct.
+    size_t Mutate(emp::Random & random) override {
+      if (SharedData().geometric_muts) {
+        return SharedData().mut_sampler.ForEachSite(hardware.GetSize(), random,
+          [this, &random](size_t pos){ hardware.RandomizeInst(pos, random); });
       }
 
-      // Only remaining option is num_muts > 1.
-      auto & mut_sites = SharedData().mut_sites;
-      mut_sites.Clear();
+      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
       for (size_t i = 0; i < num_muts; i++) {
-        const size_t pos = random.GetUInt(hardware.GetSize());
-        if (mut_sites[pos]) { --i; continue; }  // Duplicate position; try again.
-        hardware.RandomizeInst(pos, random);
+        hardware.RandomizeInst(random.GetUInt(hardware.GetSize()), random);
       }
-
       return num_muts;
     }
 
+    /// Geometric site sampling uses no shared scratch space, so those mutations can run in parallel.
+    bool IsMutateThreadSafe() const override { return SharedData().mut_sampler.IsThreadSafe(); }
+
+    /// Initialize() only rewrites this organism's own program, so it can run in parallel.
+    bool IsInitializeThreadSafe() const override { return true; }
+
     void Randomize(emp::Random & random) override {
       for (size_t pos = 0; pos < hardware.GetSize(); pos++) {
         hardware.RandomizeInst(pos, random);
@@ -110,15 +126,16 @@ namespace mabe {
                       "Name of variable to load inputs from.");
       GetManager().LinkVar(SharedData().output_name, "output_name",
                       "Name of variable to output results.");
+      GetManager().LinkVar(SharedData().geometric_muts, "geometric_muts",
+                      "Pick distinct mutated sites by sampling the gaps between them? (faster for long genomes)");
     }
 
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
-      // Setup the mutation distribution.
+      // Setup the mutation distributions.
       SharedData().mut_dist.Setup(SharedData().mut_prob, hardware.GetSize());
-
-      // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(hardware.GetSize());
+      SharedData().mut_sampler.Setup(SharedData().mut_prob, hardware.GetSize(),
+                                     SharedData().geometric_muts);
 
       // Setup the input and output traits.
       GetManager().AddRequiredTrait<emp::vector<double>>(SharedData().input_name);
@@ -33,6 +33,7 @@ namespace mabe {
       : OrganismTemplate<BitSummaryOrg>(_manager) { }
     BitSummaryOrg(const BitSummaryOrg &) = default;
     BitSummaryOrg(BitSummaryOrg &&) = default;
+    BitSummaryOrg & operator=(const BitSummaryOrg &) = default;
     BitSummaryOrg(const emp::BitVector & in, OrganismManager<BitSummaryOrg> & _manager)
       : OrganismTemplate<BitSummaryOrg>(_manager)
       { GetTrait<size_t>(SharedData().output_name) = in.CountOnes(); }
@@ -14,6 +14,9 @@
 #include "../core/MABE.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
+#include "../tools/CopyOnWrite.hpp"
+#include "../tools/Crossover.hpp"
+#include "../tools/MutationSites.hpp"
 
 #include "emp/bits/BitVector.hpp"
 #include "emp/math/Distribution.hpp"
@@ -23,13 +26,26 @@ namespace mabe {
 
   class BitsOrg : public OrganismTemplate<BitsOrg> {
   protected:
-    emp::BitVector bits;
+    CopyOnWrite<emp::BitVector> bits;  ///< Shared with clones until mutated.
+    mutable uint64_t genome_hash = 0;  ///< Cached GetGenomeHash(), kept current by Mutate().
+    mutable bool hash_ready = false;   ///< Is genome_hash valid?
+
+    /// Toggle one bit, keeping the cached hash up to date.
+    void ToggleBit(emp::BitVector & mod_bits, size_t pos) {
+      const size_t word_id = pos / 64;
+      const uint64_t old_word = mod_bits.GetUInt64(word_id);
+      mod_bits.Toggle(pos);
+      if (hash_ready) {
+        genome_hash = GenomeHash::Update(genome_hash, word_id, old_word, mod_bits.GetUInt64(word_id));
+      }
+    }
 
   public:
     BitsOrg(OrganismManager<BitsOrg> & _manager)
       : OrganismTemplate<BitsOrg>(_manager), bits(100) { }
     BitsOrg(const BitsOrg &) = default;
     BitsOrg(BitsOrg &&) = default;
+    BitsOrg & operator=(const BitsOrg &) = default;
     BitsOrg(const emp::BitVector & in, OrganismManager<BitsOrg> & _manager)
       : OrganismTemplate<BitsOrg>(_manager), bits(in) { }
     BitsOrg(size_t N, OrganismManager<BitsOrg> & _manager)
@@ -42,17 +58,57 @@ namespace mabe {
       emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
       emp::BitVector mut_sites;          ///< A pre-allocated vector for mutation sites. 
       bool init_random = true;           ///< Should we randomize ancestor?  (false = all zeros)
+      bool geometric_muts = false;       ///< Pick sites by sampling the gaps between them?
+      GeometricSites mut_gaps;           ///< Gap sampler used when geometric_muts is on.
+      size_t output_id = emp::MAX_SIZE_T;   ///< DataMap ID of output_name.
+      Crossover::Type crossover = Crossover::UNIFORM;  ///< How RecombineInPlace() mixes parents.
     };
 
-    emp::String ToString() const override { return emp::MakeString(bits); }
+    emp::String ToString() const override { return emp::MakeString(*bits); }
+
+    uint64_t GetGenomeHash() const override {
+      if (!hash_ready) { genome_hash = GenomeHash::CalcBits(*bits); hash_ready = true; }
+      return genome_hash;
+    }
+
+    /// Shared bits are divided among the organisms sharing them.
+    size_t GetObjectBytes() const override {
+      return sizeof(BitsOrg) + bits->GetNumBytes() / bits.GetShareCount();
+    }
+
+    bool ShareGenome(const Organism & other) override {
+      const BitsOrg * other_bits = dynamic_cast<const BitsOrg *>(&other);
+      if (!other_bits) return false;
+      if (bits.IsSharedWith(other_bits->bits)) return true;
+      if (*bits != *other_bits->bits) return false;
+      bits = other_bits->bits;
+      return true;
+    }
+
+    void Relocate(RelocationBin & bin) override {
+      Organism::Relocate(bin);
+      if (bits.IsShared()) return;             // Moving shared bits would unshare them.
+      CopyOnWrite<emp::BitVector> fresh(*bits);
+      bin.Keep(std::move(bits));
+      bits = std::move(fresh);
+    }
 
     size_t Mutate(emp::Random & random) override {
+      if (SharedData().geometric_muts) {
+        emp::BitVector * mod_bits = nullptr;  // Only copy shared bits if something changes.
+        return SharedData().mut_gaps.ForEachSite(bits->size(), random, [this, &mod_bits](size_t pos){
+          if (!mod_bits) { mod_bits = &bits.Modify(); MarkOutputStale(); }
+          ToggleBit(*mod_bits, pos);
+        });
+      }
+
       const size_t num_muts = SharedData().mut_dist.PickRandom(random);
 
       if (num_muts == 0) return 0;
+      MarkOutputStale();
       if (num_muts == 1) {
-        const size_t pos = random.GetUInt(bits.size());
-        bits.Toggle(pos);
+        const size_t pos = random.GetUInt(bits->size());
+        ToggleBit(bits.Modify(), pos);
         return 1;
       }
 
@@ -60,32 +116,82 @@ namespace mabe {
       auto & mut_sites = SharedData().mut_sites;
       mut_sites.Clear();
       for (size_t i = 0; i < num_muts; i++) {
-        const size_t pos = random.GetUInt(bits.size());
+        const size_t pos = random.GetUInt(bits->size());
         if (mut_sites[pos]) { --i; continue; }  // Duplicate position; try again.
         mut_sites.Set(pos);
       }
-      bits ^= mut_sites;
+      emp::BitVector & mod_bits = bits.Modify();
+      if (hash_ready) {
+        for (size_t word_id = 0; word_id < (mod_bits.size() + 63) / 64; ++word_id) {
+          const uint64_t mask = mut_sites.GetUInt64(word_id);
+          if (!mask) continue;
+          const uint64_t old_word = mod_bits.GetUInt64(word_id);
+          genome_hash = GenomeHash::Update(genome_hash, word_id, old_word, old_word ^ mask);
+        }
+      }
+      mod_bits ^= mut_sites;
 
       return num_muts;
     }
 
+    /// Take part of the bits from another BitsOrg, a word at a time.
+    bool RecombineInPlace(const OrgType & parent2, emp::Random & random) override {
+      const BitsOrg * other = dynamic_cast<const BitsOrg *>(&parent2);
+      if (!other) return false;
+      Crossover::CrossBits(bits.Modify(), *other->bits, SharedData().crossover, random);
+      hash_ready = false;
+      MarkOutputStale();
+      return true;
+    }
+
+    /// Initialize() only writes this organism's own genome, so injects can be built in parallel.
+    bool IsInitializeThreadSafe() const override { return true; }
+
     void Randomize(emp::Random & random) override {
-      emp::RandomizeBitVector(bits, random, 0.5);
+      emp::RandomizeBitVector(bits.Modify(), random, 0.5);
+      hash_ready = false;
+      MarkOutputStale();
     }
 
     void Initialize(emp::Random & random) override {
-      if (SharedData().init_random) emp::RandomizeBitVector(bits, random, 0.5);
+      if (SharedData().init_random) emp::RandomizeBitVector(bits.Modify(), random, 0.5);
+      hash_ready = false;
+      MarkOutputStale();
+    }
+
+    bool SaveState(CheckpointWriter & out) const override {
+      out.Write(*bits);
+      return true;
     }
 
-    /// Put the bits in the correct output position.
+    bool LoadState(CheckpointReader & in) override {
+      bits.Set(in.Read<emp::BitVector>());
+      hash_ready = false;
+      MarkOutputStale();
+      return true;
+    }
+
+    /// Readers using a trait's View() get the bits directly, without GenerateOutput(); the
+    /// DataMap copy (for readers of the trait itself) is only made by GenerateOutput().
+    const void * GetTraitView(size_t trait_id) const override {
+      return (trait_id == SharedData().output_id) ? &*bits : nullptr;
+    }
+
+    /// Put the bits in the correct output position (unless they are already there).
     void GenerateOutput() override {
-      SetTrait<emp::BitVector>(SharedData().output_name, bits);
+      if (IsOutputReady()) return;
+      SetTrait<emp::BitVector>(SharedData().output_name, *bits);
+      MarkOutputReady();
     }
 
     /// Setup this organism type to be able to load from config.
     void SetupConfig() override {
-      GetManager().LinkFuns<size_t>([this](){ return bits.size(); },
-                       [this](const size_t & N){ return bits.Resize(N); },
+      GetManager().LinkFuns<size_t>([this](){ return bits->size(); },
+                       [this](const size_t & N){
+                         hash_ready = false;
+                         MarkOutputStale();
+                         return bits.Modify().Resize(N);
+                       },
                        "N", "Number of bits in organism");
       GetManager().LinkVar(SharedData().mut_prob, "mut_prob",
                       "Probability of each bit mutating on reproduction.");
@@ -93,21 +199,33 @@ namespace mabe {
                       "Name of variable to contain bit sequence.");
       GetManager().LinkVar(SharedData().init_random, "init_random",
                       "Should we randomize ancestor?  (0 = all zeros)");
+      GetManager().LinkVar(SharedData().geometric_muts, "geometric_muts",
+                      "Pick mutated bits by sampling the gaps between them? (faster for long genomes)");
+      GetManager().LinkMenu(
+        SharedData().crossover, "crossover", "How should recombination mix two parents' bits?",
+        Crossover::UNIFORM, "uniform", "Take each bit from either parent with equal probability.",
+        Crossover::ONE_POINT, "one_point", "Take all bits after a random point from the second parent.",
+        Crossover::TWO_POINT, "two_point", "Take the bits between two random points from the second parent.");
     }
 
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
       // Setup the mutation distribution.
-      SharedData().mut_dist.Setup(SharedData().mut_prob, bits.size());
+      SharedData().mut_dist.Setup(SharedData().mut_prob, bits->size());
+      SharedData().mut_gaps.Setup(SharedData().mut_prob);
 
       // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(bits.size());
+      SharedData().mut_sites.Resize(bits->size());
 
       // Setup the output trait.
       GetManager().AddSharedTrait(SharedData().output_name,
                                   "Bitset output from organism.",
                                   emp::BitVector(0));
     }
+
+    void SetupDataMap(const emp::DataMap & dm) override {
+      SharedData().output_id = dm.GetID(SharedData().output_name);
+    }
   };
 
   MABE_REGISTER_ORG_TYPE(BitsOrg, "Organism consisting of a series of N bits.");
@@ -88,6 +88,8 @@ namespace mabe {
     genome_t genome;          // Series of instructions.
     jump_map_t inst_target;  // Pre-processed jump points for CONTINUE, BREAK, or scope ends
     size_t inst_ptr;          // Position in genome to execute next.
+    emp::vector<size_t> scope_starts;  // Genome positions of the scopes we are currently in.
+    bool scopes_ready = false;         // Is inst_target up to date with the genome?
     memory_t mem;             // Memory for program to manipulate
 
     // Find the instruction with the provided name.
@@ -157,35 +159,30 @@ namespace mabe {
     }
 
 
-    // Analyze this program to figure out scope information for each position.
+    // Analyze this program to find where each scope ends, so skips are a single jump.
+    // For each IF, WHILE, or COUNTDOWN, inst_target holds the position just past its matching
+    // END_SCOPE (or the end of the genome if there is none).
     void PreprocessScopes() {
-      unsigned char cur_scope = 0;
-      emp::vector<size_t> scope_starts;
-      scope_starts.reserve(16);
+      emp::array<size_t, GENOME_SIZE> open_scopes;  // Instruction IDs of unclosed scopes.
+      size_t num_open = 0;
       for (size_t i = 0; i < GENOME_SIZE; i++) {
-        const size_t genome_pos = i*4;
-        switch (genome[genome_pos]) {          
+        inst_target[i] = genome.size();
+        switch (genome[i*4]) {
         case (size_t) Inst::IF:
-          unsigned char new_scope = genome[genome_pos+1] % 16;
-          break;
         case (size_t) Inst::WHILE:
         case (size_t) Inst::COUNTDOWN:
-          unsigned char new_scope = genome[genome_pos+1] % 16;
-          break;
-        case (size_t) Inst::SET_SCOPE:
-          unsigned char new_scope = genome[genome_pos+1] % 16;
-          break;
-        case (size_t) Inst::BREAK:
+          open_scopes[num_open++] = i;
           break;
-        case (size_t) Inst::CONTINUE:
+        case (size_t) Inst::END_SCOPE:
+          if (num_open) inst_target[open_scopes[--num_open]] = (i+1) * 4;
           break;
         default:
-      
+          break;
         };
       }
+      scopes_ready = true;
     }
 
-
     // What kind of scope are we in?
     Inst GetScopeType() {
       if (scope_starts.size() == 0) return Inst::NONE;
@@ -198,24 +195,17 @@ namespace mabe {
       };
     }
 
-    // Jump past the current scope.
+    // Jump past the current scope (and leave it).
     void SkipScope() {
-      int scope_level = 1;
-      while (scope_level > 0 && inst_ptr < genome.size()) {
-        switch (genome[inst_ptr]) {
-          case (size_t) Inst::IF:
-          case (size_t) Inst::WHILE:
-          case (size_t) Inst::COUNTDOWN:
-            scope_level++;
-            break;
-          case (size_t) Inst::END_SCOPE:
-            scope_level--;
-        }
-      }
+      if (scope_starts.size() == 0) { inst_ptr = genome.size(); return; }
+      inst_ptr = inst_target[scope_starts.back() / 4];
+      scope_starts.pop_back();
     }
 
     // Execute the next instruction.
     void RunInst() {
+      if (!scopes_ready) PreprocessScopes();
+
       // Loop around to zero if we're off the end.
       if (inst_ptr >= genome.size()) { inst_ptr = 0; }
 
@@ -355,6 +345,7 @@ namespace mabe {
       : OrganismTemplate<SimpleProgramOrg>(_manager) { }
     SimpleProgramOrg(const SimpleProgramOrg &) = default;
     SimpleProgramOrg(SimpleProgramOrg &&) = default;
+    SimpleProgramOrg & operator=(const SimpleProgramOrg &) = default;
     SimpleProgramOrg(const genome_t & in, OrganismManager<SimpleProgramOrg> & _manager)
       : OrganismTemplate<SimpleProgramOrg>(_manager)
     {
@@ -366,11 +357,19 @@ namespace mabe {
 
     emp::String ToString() const override { } // return emp::MakeString(vals, ":(TOTAL=", total, ")"); }
 
+    uint64_t GetGenomeHash() const override {
+      return GenomeHash::CalcBytes(std::string_view((const char *) genome.data(), genome.size()));
+    }
+
+    /// The genome is a fixed-size array inside the organism itself.
+    size_t GetObjectBytes() const override { return sizeof(SimpleProgramOrg); }
+
     size_t Mutate(emp::Random & random) override {
       // Identify number of and positions for mutations.
       const size_t num_muts = SharedData().mut_dist.PickRandom(random);
       emp::BitVector & mut_sites = SharedData().mut_sites;
       mut_sites.ChooseRandom(random, num_muts);
+      if (num_muts) scopes_ready = false;
 
       // SetVar<double>(SharedData().total_name, total);  // Store total in data map.
       return num_muts;
@@ -378,6 +377,7 @@ namespace mabe {
 
     void Randomize(emp::Random & random) override {
       for (unsigned char & x : genome) { x = random.GetUInt(0, 256); }
+      scopes_ready = false;
     }
 
     /// Put the values in the correct output positions.
@@ -0,0 +1,182 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  StateSummaryOrg.hpp
+ *  @brief An organism consisting of counts of each state, but not their orderings.
+ *  @note Status: ALPHA
+ *
+ *  This organism type represents a StatesOrg where only the number of sites in each state
+ *  matters, so the whole genome does not need to be recorded.  Mutations are sampled in closed
+ *  form: the number of mutated sites leaving each state is binomial, and those sites are then
+ *  redistributed with the same rules StatesOrg uses (uniformly for "uniform" changes, or one
+ *  step up or down for "ring" changes).  Memory and mutation time depend only on the number
+ *  of states, not on the genome size.
+ */
+
+#ifndef MABE_STATE_SUMMARY_ORGANISM_HPP
+#define MABE_STATE_SUMMARY_ORGANISM_HPP
+
+#include <algorithm>
+
+#include "../core/MABE.hpp"
+#include "../core/Organism.hpp"
+#include "../core/OrganismManager.hpp"
+
+#include "emp/math/DistributionSet.hpp"
+#include "emp/math/random_utils.hpp"
+#include "emp/polyfill/span.hpp"
+
+namespace mabe {
+
+  class StateSummaryOrg : public OrganismTemplate<StateSummaryOrg> {
+  protected:
+    // How can a state change?  (Matches StatesOrg)
+    enum ChangeType {
+      CHANGE_NONE=0,  // No changes are a allow.
+      CHANGE_UNIFORM, // States can change to any other state with uniform probability.
+      CHANGE_RING,    // States can change + or - one, looping at ends.
+    };
+
+  public:
+    StateSummaryOrg(OrganismManager<StateSummaryOrg> & _manager)
+      : OrganismTemplate<StateSummaryOrg>(_manager) { }
+    StateSummaryOrg(const StateSummaryOrg &) = default;
+    StateSummaryOrg(StateSummaryOrg &&) = default;
+    StateSummaryOrg & operator=(const StateSummaryOrg &) = default;
+    ~StateSummaryOrg() { ; }
+
+    struct ManagerData : public Organism::ManagerData {
+      emp::String counts_name = "state_counts"; ///< Name of trait with the count of each state.
+      size_t num_states = 4;                 ///< Number of unique states in an organism.
+      size_t genome_size = 100;              ///< Number of positions in the simulated genome.
+      double mut_prob = 0.01;                ///< Probability of position mutating on reproduction.
+      ChangeType change_type = CHANGE_UNIFORM;
+      bool init_random = true;               ///< Should we randomize ancestor? (false = all state 0)
+
+      emp::BinomialSet binomials;            ///< Store pre-calculated binomials.
+      emp::vector<size_t> mut_counts;        ///< Scratch space: mutated sites leaving each state.
+    };
+
+    std::span<size_t> GetCounts() {
+      return GetTrait<size_t>(SharedData().counts_name, SharedData().num_states);
+    }
+    std::span<const size_t> GetCounts() const {
+      return GetTrait<size_t>(SharedData().counts_name, SharedData().num_states);
+    }
+
+    emp::String ToString() const override {
+      std::span<const size_t> counts = GetCounts();
+      emp::String out("[");
+      for (size_t state = 0; state < counts.size(); ++state) {
+        if (state) out += ",";
+        out += emp::MakeString(state, ":", counts[state]);
+      }
+      return out + "]";
+    }
+
+    /// Place 'num_sites' sites uniformly at random among all states.
+    static void DistributeUniform(emp::Random & random, emp::BinomialSet & binomials,
+                                  size_t num_sites, std::span<size_t> counts) {
+      const size_t num_states = counts.size();
+      for (size_t state = 0; state + 1 < num_states && num_sites; ++state) {
+        const size_t placed = binomials.PickRandom(random, 1.0 / (double) (num_states - state), num_sites);
+        counts[state] += placed;
+        num_sites -= placed;
+      }
+      counts[num_states - 1] += num_sites;
+    }
+
+    size_t Mutate(emp::Random & random) override {
+      if (SharedData().change_type == CHANGE_NONE) {
+        emp::notify::Warning("Trying to mutate StateSummaryOrg, but no changes allowed.");
+        return 0;
+      }
+
+      std::span<size_t> counts = GetCounts();
+      emp::BinomialSet & binomials = SharedData().binomials;
+      emp::vector<size_t> & mut_counts = SharedData().mut_counts;
+      const size_t num_states = counts.size();
+
+      // Pull the mutated sites out of each state.
+      size_t num_muts = 0;
+      for (size_t state = 0; state < num_states; ++state) {
+        mut_counts[state] = binomials.PickRandom(random, SharedData().mut_prob, counts[state]);
+        counts[state] -= mut_counts[state];
+        num_muts += mut_counts[state];
+      }
+      if (num_muts == 0) return 0;
+
+      // Put them back according to the change type.
+      if (SharedData().change_type == CHANGE_UNIFORM) {
+        DistributeUniform(random, binomials, num_muts, counts);
+      }
+      else {
+        for (size_t state = 0; state < num_states; ++state) {
+          const size_t num_up = binomials.PickRandom(random, 0.5, mut_counts[state]);
+          counts[(state + 1) % num_states] += num_up;
+          counts[(state + num_states - 1) % num_states] += mut_counts[state] - num_up;
+        }
+      }
+
+      return num_muts;
+    }
+
+    void Randomize(emp::Random & random) override {
+      std::span<size_t> counts = GetCounts();
+      std::fill(counts.begin(), counts.end(), 0);
+      DistributeUniform(random, SharedData().binomials, SharedData().genome_size, counts);
+    }
+
+    void Initialize(emp::Random & random) override {
+      if (SharedData().init_random) Randomize(random);
+      else {
+        std::span<size_t> counts = GetCounts();
+        std::fill(counts.begin(), counts.end(), 0);
+        counts[0] = SharedData().genome_size;
+      }
+    }
+
+    /// Put the values in the correct output positions.
+    void GenerateOutput() override {
+      // Nothing to do here - output already stored in DataMap.
+    }
+
+    /// Setup this organism type to be able to load from config.
+    void SetupConfig() override {
+      GetManager().LinkVar(SharedData().genome_size, "N", "Number of sites in the simulated genome.");
+      GetManager().LinkVar(SharedData().num_states, "D", "How many states are possible per site?");
+      GetManager().LinkVar(SharedData().mut_prob, "mut_prob",
+        "Probability of each site mutating on reproduction.");
+      GetManager().LinkMenu(
+        SharedData().change_type, "change_type", "What should a point mutation do?",
+        CHANGE_NONE, "null", "Do not allow mutations; issue warning if attempted.",
+        CHANGE_RING, "ring", "State changes add or subtract one, looping",
+        CHANGE_UNIFORM, "uniform", "Change to another state with equal probability.");
+      GetManager().LinkVar(SharedData().counts_name, "counts_name",
+        "Name of variable to contain the number of sites in each state.");
+      GetManager().LinkVar(SharedData().init_random, "init_random",
+        "Should we randomize ancestor?  (0 = all sites in state 0)");
+    }
+
+    /// Setup this organism type with the traits it need to track.
+    void SetupModule() override {
+      if (SharedData().num_states == 0) {
+        emp::notify::Error("StateSummaryOrg requires at least one state (D > 0).");
+        SharedData().num_states = 1;
+      }
+      SharedData().mut_counts.resize(SharedData().num_states);
+
+      // Setup the output trait.
+      GetManager().AddSharedTrait(SharedData().counts_name,
+                                  "Number of sites in each state.",
+                                  static_cast<size_t>(0),
+                                  SharedData().num_states);
+    }
+  };
+
+  MABE_REGISTER_ORG_TYPE(StateSummaryOrg, "Organism consisting of the count of each of D states across N sites.");
+}
+
+#endif
@@ -6,23 +6,38 @@
  *  @file StatesOrg.hpp
  *  @brief An organism consisting of a fixed-size series of states.
  *  @note Status: ALPHA
+ *
+ *  StatesOrg stores each state as a size_t; ByteStatesOrg stores one byte per site (for up to
+ *  256 states), using an eighth of the memory.  Evaluators must read the genome trait with the
+ *  matching type.
  */
 
 #ifndef MABE_STATES_ORGANISM_H
 #define MABE_STATES_ORGANISM_H
 
+#include <algorithm>
+#include <limits>
 #include <span>
+#include <type_traits>
 
 #include "../core/MABE.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
+#include "../tools/Crossover.hpp"
+#include "../tools/MutationSites.hpp"
 
 #include "emp/datastructs/span_utils.hpp"
 #include "emp/math/Distribution.hpp"
 
 namespace mabe {
 
-  class StatesOrg : public OrganismTemplate<StatesOrg> {
+  template <typename STATE_T>
+  class StatesOrgT : public OrganismTemplate<StatesOrgT<STATE_T>> {
+  public:
+    using this_t = StatesOrgT<STATE_T>;
+    using base_t = OrganismTemplate<this_t>;
+    using state_t = STATE_T;
+
   protected:
     // How can a state change?
     enum ChangeType {
@@ -33,79 +48,105 @@ namespace mabe {
 
   public:
     struct ManagerData : public Organism::ManagerData {
-      emp::String genome_name = "states";  ///< Name of trait that should be used to access values.
-      size_t num_states;                   ///< Number of unique states in an organism.
+      size_t num_states = 4;               ///< Number of unique states in an organism.
       size_t genome_size = 100;            ///< Number of positions in this genome.
       double mut_prob = 0.01;              ///< Probability of position mutating on reproduction.
       ChangeType change_type = CHANGE_UNIFORM;
       bool init_random = true;             ///< Should we randomize ancestor?  (false = all 0.0)
 
+      // Organism traits
+      SharedMultiTrait<STATE_T> genome_trait{this, "states", "Value array output from organism.",
+                                              AsConfig(genome_size)};
+
       // Helper member variables.
-      emp::Binomial mut_dist;              ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;            ///< A pre-allocated vector for mutation sites. 
+      MutationSampler mut_sampler;         ///< Picks the sites to mutate on reproduction.
+      Crossover::Type crossover = Crossover::UNIFORM;  ///< How RecombineInPlace() mixes parents.
+      bool geometric_muts = false;         ///< Pick sites by sampling the gaps between them?
+
+      ManagerData() {
+        genome_trait.SetConfigName("genome_name");
+        genome_trait.SetConfigDesc("Name of variable to contain set of values.");
+      }
     };
 
-    StatesOrg(OrganismManager<StatesOrg> & _manager)
-      : OrganismTemplate<StatesOrg>(_manager) { }
-    StatesOrg(const StatesOrg &) = default;
-    StatesOrg(StatesOrg &&) = default;
-    ~StatesOrg() { ; }
+    StatesOrgT(OrganismManager<this_t> & _manager)
+      : base_t(_manager) { }
+    StatesOrgT(const StatesOrgT &) = default;
+    StatesOrgT(StatesOrgT &&) = default;
+    StatesOrgT & operator=(const StatesOrgT &) = default;
+    ~StatesOrgT() { ; }
+
+    using base_t::SharedData;
+    using base_t::GetManager;
 
     emp::String ToString() const override {
-      std::span<const size_t> vals = GetTrait<size_t>(SharedData().genome_name, SharedData().genome_size);
-      return emp::MakeString(vals);
+      std::span<const STATE_T> vals = SharedData().genome_trait(*this);
+      if constexpr (std::is_same_v<STATE_T, size_t>) return emp::MakeString(vals);
+      else return emp::MakeString(emp::vector<size_t>(vals.begin(), vals.end()));  // Not as chars.
+    }
+
+    uint64_t GetGenomeHash() const override {
+      return GenomeHash::CalcValues<STATE_T>(SharedData().genome_trait(*this));
     }
 
     size_t Mutate(emp::Random & random) override {
-      if (SharedData().change_type == CHANGE_NONE) {
+      const size_t num_states = SharedData().num_states;
+      std::span<STATE_T> genome = SharedData().genome_trait(*this);
+      MutationSampler & sampler = SharedData().mut_sampler;
+
+      switch (SharedData().change_type) {
+      case CHANGE_RING:
+        return sampler.ForEachSite(genome.size(), random, [&genome, &random, num_states](size_t pos){
+          const size_t locus = genome[pos];
+          if (random.P(0.5)) genome[pos] = (STATE_T) ((locus + 1 == num_states) ? 0 : locus + 1);
+          else genome[pos] = (STATE_T) ((locus == 0) ? num_states - 1 : locus - 1);
+        });
+      case CHANGE_UNIFORM:
+        return sampler.ForEachSite(genome.size(), random, [&genome, &random, num_states](size_t pos){
+          genome[pos] = (STATE_T) random.GetUInt(num_states);
+        });
+      default:
         emp::notify::Warning("Trying to mutate StatesOrg, but no changes allowed.");
         return 0;
       }
+    }
 
-      // Identify number of and positions for mutations.
-      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
-      if (num_muts == 0) return 0;
-
-      emp::BitVector & mut_sites = SharedData().mut_sites;
-      mut_sites.ChooseRandom(random, num_muts);
-      std::span<size_t> genome = GetTrait<size_t>(SharedData().genome_name, SharedData().genome_size);
-
-      // Trigger the correct type of mutations at the identified positions.
-      for (size_t mut_pos = mut_sites.FindOne();
-           mut_pos < mut_sites.GetSize();
-           mut_pos = mut_sites.FindOne(mut_pos+1))
-      {
-        size_t & locus = genome[mut_pos];      // Identify the next site to mutate.
-        switch (SharedData().change_type) {
-        case CHANGE_RING:
-          if (random.P(0.5)) {
-            ++locus;
-            if (locus == SharedData().num_states) locus = 0;
-          } else {
-            if (locus == 0) locus = SharedData().num_states;
-            --locus;
-          }
-          break;
-        case CHANGE_UNIFORM:
-          locus = random.GetUInt(SharedData().num_states);
-          break;
-        default: break;
-        }
-      }
+    /// Geometric site sampling uses no shared scratch space, so those mutations can run in parallel.
+    bool IsMutateThreadSafe() const override {
+      return SharedData().mut_sampler.IsThreadSafe() && SharedData().change_type != CHANGE_NONE;
+    }
 
-      return num_muts;
+    /// Take part of the values from another organism of this type.
+    bool RecombineInPlace(const OrgType & parent2, emp::Random & random) override {
+      const this_t * other = dynamic_cast<const this_t *>(&parent2);
+      if (!other) return false;
+      std::span<STATE_T> genome = SharedData().genome_trait(*this);
+      Crossover::CrossSpan<STATE_T>(genome, SharedData().genome_trait(*other), SharedData().crossover, random);
+      return true;
     }
 
+    /// Initialize() only writes this organism's own genome, so injects can be built in parallel.
+    bool IsInitializeThreadSafe() const override { return true; }
+
+    /// Fill the genome two sites per 64-bit random draw, scaling each 32-bit half into
+    /// [0, num_states) by multiply-shift.
     void Randomize(emp::Random & random) override {
-      std::span<size_t> genome = GetTrait<size_t>(SharedData().genome_name, SharedData().genome_size);
-      for (size_t & x : genome) x = random.GetUInt(SharedData().num_states);
+      std::span<STATE_T> genome = SharedData().genome_trait(*this);
+      const uint64_t num_states = SharedData().num_states;
+      size_t pos = 0;
+      for (; pos + 1 < genome.size(); pos += 2) {
+        const uint64_t bits = random.GetUInt64();
+        genome[pos] = (STATE_T) (((bits & 0xffffffff) * num_states) >> 32);
+        genome[pos+1] = (STATE_T) (((bits >> 32) * num_states) >> 32);
+      }
+      if (pos < genome.size()) genome[pos] = (STATE_T) random.GetUInt(num_states);
     }
 
     void Initialize(emp::Random & random) override {
       if (SharedData().init_random) Randomize(random);
       else { 
-        std::span<size_t> genome = GetTrait<size_t>(SharedData().genome_name, SharedData().genome_size);
-        for (size_t & x : genome) x = 0;
+        std::span<STATE_T> genome = SharedData().genome_trait(*this);
+        std::fill(genome.begin(), genome.end(), STATE_T{0});
       }
     }
 
@@ -126,31 +167,39 @@ namespace mabe {
         CHANGE_NONE, "null", "Do not allow mutations; issue warning if attempted.",
         CHANGE_RING, "ring", "State changes add or subtract one, looping",
         CHANGE_UNIFORM, "uniform", "Change to another state with equal probability.");
-      GetManager().LinkVar(SharedData().genome_name, "genome_name",
-        "Name of variable to contain set of values.");
       GetManager().LinkVar(SharedData().init_random, "init_random",
         "Should we randomize ancestor?  (0 = all 0.0)");
+      GetManager().LinkVar(SharedData().geometric_muts, "geometric_muts",
+        "Pick mutated sites by sampling the gaps between them? (faster for long genomes)");
+      GetManager().LinkMenu(
+        SharedData().crossover, "crossover", "How should recombination mix two parents' values?",
+        Crossover::UNIFORM, "uniform", "Take each value from either parent with equal probability.",
+        Crossover::ONE_POINT, "one_point", "Take all values after a random point from the second parent.",
+        Crossover::TWO_POINT, "two_point", "Take the values between two random points from the second parent.");
     }
 
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
-      // Setup the mutation distribution.
-      SharedData().mut_dist.Setup(SharedData().mut_prob, SharedData().genome_size);
-
-      // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(SharedData().genome_size);
+      constexpr size_t MAX_STATE = std::numeric_limits<STATE_T>::max();
+      if (SharedData().num_states == 0) {
+        emp::notify::Error("StatesOrg requires at least one state (D > 0).");
+      }
+      else if (SharedData().num_states - 1 > MAX_STATE) {
+        emp::notify::Error("ByteStatesOrg can store at most ", MAX_STATE + 1, " states (D=",
+                           SharedData().num_states, "); use StatesOrg instead.");
+      }
 
-      // Setup the output trait.
-      GetManager().AddSharedTrait(SharedData().genome_name,
-                                  "Value array output from organism.",
-                                  static_cast<size_t>(0),
-                                  SharedData().genome_size);
+      // Setup the mutation sampler.
+      SharedData().mut_sampler.Setup(SharedData().mut_prob, SharedData().genome_size,
+                                     SharedData().geometric_muts);
     }
   };
 
-
+  using StatesOrg = StatesOrgT<size_t>;
+  using ByteStatesOrg = StatesOrgT<uint8_t>;
 
   MABE_REGISTER_ORG_TYPE(StatesOrg, "Organism consisting of a series of N state values.");
+  MABE_REGISTER_ORG_TYPE(ByteStatesOrg, "Organism consisting of a series of N one-byte state values (D <= 256).");
 }
 
 #endif
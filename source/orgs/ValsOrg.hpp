@@ -4,16 +4,28 @@
  *  @date 2021-2024.
  *
  *  @file ValsOrg.hpp
- *  @brief An organism consisting of a fixed-size series of values of type double.
+ *  @brief An organism consisting of a fixed-size series of floating-point values.
  *  @note Status: ALPHA
+ *
+ *  ValsOrg stores doubles; FloatValsOrg stores floats, halving the memory each genome uses
+ *  (its total is still accumulated as a double).  Evaluators must read the genome trait with
+ *  the matching type.
+ *
+ *  The lower and upper bound policies are template parameters of the mutation kernel; the
+ *  configured pair is looked up once during setup, so mutating a value does not switch on
+ *  the bound types.
  */
 
 #ifndef MABE_VALS_ORGANISM_H
 #define MABE_VALS_ORGANISM_H
 
+#include <algorithm>
+
 #include "../core/MABE.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
+#include "../tools/Crossover.hpp"
+#include "../tools/MutationSites.hpp"
 
 #include "emp/datastructs/span_utils.hpp"
 #include "emp/math/Distribution.hpp"
@@ -22,8 +34,8 @@
 
 namespace mabe {
 
-  class ValsOrg : public OrganismTemplate<ValsOrg> {
-  protected:
+  /// Bound policies shared by all ValsOrg variants.
+  struct ValsBounds {
     // How do we enforce limits on values?
     enum BoundType {
       LIMIT_NONE=0,  // No boundary limit.  (e.g., in a 0 to 100 range, 103 would stay 103)
@@ -33,16 +45,54 @@ namespace mabe {
       LIMIT_ERROR    // Invalid limit type.
     };
 
-    void CalculateTotal(const std::span<double> & vals) {
-      double total = 0.0;
-      for (double x : vals) total += x;
-      SetTrait<double>(SharedData().total_name, total);
+    /// Put a single value back in the range [min_value, max_value] using the given policies.
+    template <BoundType LOWER, BoundType UPPER, typename VAL_T>
+    static VAL_T Apply(VAL_T value, VAL_T min_value, VAL_T max_value) {
+      if (value > max_value) {
+        if constexpr (UPPER == LIMIT_CLAMP) value = max_value;
+        else if constexpr (UPPER == LIMIT_WRAP) value -= (max_value - min_value);
+        else if constexpr (UPPER == LIMIT_REBOUND) value = 2 * max_value - value;
+      }
+      else if (value < min_value) {
+        if constexpr (LOWER == LIMIT_CLAMP) value = min_value;
+        else if constexpr (LOWER == LIMIT_WRAP) value += (max_value - min_value);
+        else if constexpr (LOWER == LIMIT_REBOUND) value = 2 * min_value - value;
+      }
+      return value;
+    }
+
+    /// Call fun.template operator()<LOWER,UPPER>() with the provided runtime bound types.
+    /// (LIMIT_ERROR is treated as LIMIT_NONE.)
+    template <BoundType LOWER, typename FUN_T>
+    static auto SelectUpper(BoundType upper, FUN_T && fun) {
+      switch (upper) {
+        case LIMIT_CLAMP:   return fun.template operator()<LOWER, LIMIT_CLAMP>();
+        case LIMIT_WRAP:    return fun.template operator()<LOWER, LIMIT_WRAP>();
+        case LIMIT_REBOUND: return fun.template operator()<LOWER, LIMIT_REBOUND>();
+        default:            return fun.template operator()<LOWER, LIMIT_NONE>();
+      }
+    }
+
+    template <typename FUN_T>
+    static auto Select(BoundType lower, BoundType upper, FUN_T && fun) {
+      switch (lower) {
+        case LIMIT_CLAMP:   return SelectUpper<LIMIT_CLAMP>(upper, fun);
+        case LIMIT_WRAP:    return SelectUpper<LIMIT_WRAP>(upper, fun);
+        case LIMIT_REBOUND: return SelectUpper<LIMIT_REBOUND>(upper, fun);
+        default:            return SelectUpper<LIMIT_NONE>(upper, fun);
+      }
     }
+  };
 
+  template <typename VAL_T>
+  class ValsOrgT : public OrganismTemplate<ValsOrgT<VAL_T>>, public ValsBounds {
   public:
+    using this_t = ValsOrgT<VAL_T>;
+    using base_t = OrganismTemplate<this_t>;
+    using val_t = VAL_T;
+    using mutate_fun_t = size_t (this_t::*)(emp::Random &);
+
     struct ManagerData : public Organism::ManagerData {
-      emp::String genome_name = "vals";  ///< Name of trait that should be used to access values.
-      emp::String total_name = "total";  ///< Name of trait that indicate total of all values.
       size_t num_vals = 100;             ///< Number of values in this genome.
       double mut_prob = 0.01;            ///< Probability of position mutating on reproduction.
       double mut_size = 1.0;             ///< Standard deviation of mutations.
@@ -51,72 +101,116 @@ namespace mabe {
       BoundType upper_bound = LIMIT_REBOUND;
       BoundType lower_bound = LIMIT_REBOUND;
 
+      // Organism traits
+      SharedMultiTrait<VAL_T> genome_trait{this, "vals", "Value array output from organism.",
+                                            AsConfig(num_vals)};
+      SharedTrait<double> total_trait{this, "total", "Total of all organism outputs."};
+
       // Helper member variables.
-      emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;          ///< A pre-allocated vector for mutation sites. 
+      MutationSampler mut_sampler;       ///< Picks the sites to mutate on reproduction.
       bool init_random = true;           ///< Should we randomize ancestor?  (false = all 0.0)
+      Crossover::Type crossover = Crossover::UNIFORM;  ///< How RecombineInPlace() mixes parents.
+      bool geometric_muts = false;       ///< Pick sites by sampling the gaps between them?
+      mutate_fun_t mutate_fun = &this_t::template MutateBounded<LIMIT_REBOUND, LIMIT_REBOUND>;
+
+      ManagerData() {
+        genome_trait.SetConfigName("genome_name");
+        genome_trait.SetConfigDesc("Name of variable to contain set of values.");
+        total_trait.SetConfigName("total_name");
+        total_trait.SetConfigDesc("Name of variable to contain total of all values.");
+      }
 
       // Helper functions.
-      inline void ApplyBounds(double & value);              ///< Put a single value back in range.
-      inline void ApplyBounds(std::span<double> & vals);  ///< Put all values back in range.
+      void ApplyBounds(VAL_T & value) const;           ///< Put a single value back in range.
+      void ApplyBounds(std::span<VAL_T> vals) const;   ///< Put all values back in range.
     };
 
-    ValsOrg(OrganismManager<ValsOrg> & _manager)
-      : OrganismTemplate<ValsOrg>(_manager) { }
-    ValsOrg(const ValsOrg &) = default;
-    ValsOrg(ValsOrg &&) = default;
-    ~ValsOrg() { ; }
+    ValsOrgT(OrganismManager<this_t> & _manager)
+      : base_t(_manager) { }
+    ValsOrgT(const ValsOrgT &) = default;
+    ValsOrgT(ValsOrgT &&) = default;
+    ~ValsOrgT() { ; }
+
+    using base_t::SharedData;
+    using base_t::GetManager;
 
     emp::String ToString() const override {
-      std::span<const double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
-      const double total = GetTrait<double>(SharedData().total_name);
+      std::span<const VAL_T> vals = SharedData().genome_trait(*this);
+      const double total = SharedData().total_trait(*this);
       return emp::MakeString(vals, ":(TOTAL=", total, ")");
     }
 
-    size_t Mutate(emp::Random & random) override {
-      // Identify number of and positions for mutations.
-      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
-      emp::BitVector & mut_sites = SharedData().mut_sites;
-      mut_sites.ChooseRandom(random, num_muts);
-      std::span<double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
-      double & total = GetTrait<double>(SharedData().total_name);
-
-      // Trigger mutations at the identified positions.
-      int mut_pos = mut_sites.FindOne();
-      while (mut_pos != -1) {
-        double & cur_val = vals[mut_pos];        // Identify the next site to mutate.
+    uint64_t GetGenomeHash() const override {
+      return GenomeHash::CalcValues<VAL_T>(SharedData().genome_trait(*this));
+    }
+
+    /// Mutate using the bound policies LOWER and UPPER (selected from config at setup).
+    template <BoundType LOWER, BoundType UPPER>
+    size_t MutateBounded(emp::Random & random) {
+      std::span<VAL_T> vals = SharedData().genome_trait(*this);
+      double total = SharedData().total_trait(*this);
+      const VAL_T min_value = (VAL_T) SharedData().min_value;
+      const VAL_T max_value = (VAL_T) SharedData().max_value;
+      auto mutate_site = [&vals, &total, &random, min_value, max_value](size_t mut_pos) {
+        VAL_T & cur_val = vals[mut_pos];         // Identify the next site to mutate.
         total -= cur_val;                        // Remove old value from the total.
         cur_val += random.GetNormal();           // Mutate the value at the site.
-        SharedData().ApplyBounds(cur_val);       // Make sure the value stays in the allowed range.
+        cur_val = Apply<LOWER, UPPER>(cur_val, min_value, max_value); // Keep value in range.
         total += cur_val;                        // Add the update value back into the total.
-        mut_pos = mut_sites.FindOne(mut_pos+1);  // Move on to the next site to mutate.
-      }
+      };
 
-      SetTrait<double>(SharedData().total_name, total);  // Store total in data map.
+      const size_t num_muts = SharedData().mut_sampler.ForEachSite(vals.size(), random, mutate_site);
+
+      SharedData().total_trait(*this) = total;  // Store total in data map.
       return num_muts;
     }
 
+    size_t Mutate(emp::Random & random) override {
+      return (this->*SharedData().mutate_fun)(random);
+    }
+
+    /// Geometric site sampling uses no shared scratch space, so those mutations can run in parallel.
+    bool IsMutateThreadSafe() const override { return SharedData().mut_sampler.IsThreadSafe(); }
+
+    /// Take part of the values from another organism of this type.
+    bool RecombineInPlace(const OrgType & parent2, emp::Random & random) override {
+      const this_t * other = dynamic_cast<const this_t *>(&parent2);
+      if (!other) return false;
+      std::span<VAL_T> vals = SharedData().genome_trait(*this);
+      Crossover::CrossSpan<VAL_T>(vals, SharedData().genome_trait(*other), SharedData().crossover, random);
+      double total = 0.0;
+      for (VAL_T x : vals) total += x;
+      SharedData().total_trait(*this) = total;  // Store total in data map.
+      return true;
+    }
+
+    /// Initialize() only writes this organism's own genome, so injects can be built in parallel.
+    bool IsInitializeThreadSafe() const override { return true; }
+
     void Randomize(emp::Random & random) override {
-      std::span<double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
+      std::span<VAL_T> vals = SharedData().genome_trait(*this);
       double total = 0.0;
-      for (double & x : vals) {
-        x = random.GetDouble(SharedData().min_value, SharedData().max_value);
+      for (VAL_T & x : vals) {
+        x = (VAL_T) random.GetDouble(SharedData().min_value, SharedData().max_value);
         total += x;
       }
-      SetTrait<double>(SharedData().total_name, total);  // Store total in data map.
+      SharedData().total_trait(*this) = total;  // Store total in data map.
     }
 
     void Initialize(emp::Random & random) override {
       if (SharedData().init_random) Randomize(random);
       else { 
-        std::span<double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
-        double total = 0.0;
-        for (double & x : vals) x = 0.0;
-        SetTrait<double>(SharedData().total_name, total);  // Store total in data map.
+        std::span<VAL_T> vals = SharedData().genome_trait(*this);
+        std::fill(vals.begin(), vals.end(), VAL_T{0});
+        SharedData().total_trait(*this) = 0.0;  // Store total in data map.
       }
     }
 
 
+    /// Values are stored in traits, so there is no additional state to checkpoint.
+    bool SaveState(CheckpointWriter &) const override { return true; }
+    bool LoadState(CheckpointReader &) override { return true; }
+
     /// Put the values in the correct output positions.
     void GenerateOutput() override {
       /// Output is already stored in the DataMap.
@@ -145,88 +239,55 @@ namespace mabe {
         LIMIT_CLAMP, "clamp", "Reduce too-high values to max_value.",
         LIMIT_WRAP, "wrap", "Make high values loop around to minimum.",
         LIMIT_REBOUND, "rebound", "Make high values 'bounce' back down." );
-      GetManager().LinkVar(SharedData().genome_name, "genome_name",
-                      "Name of variable to contain set of values.");
-      GetManager().LinkVar(SharedData().total_name, "total_name",
-                      "Name of variable to contain total of all values.");
       GetManager().LinkVar(SharedData().init_random, "init_random",
                       "Should we randomize ancestor?  (0 = all 0.0)");
+      GetManager().LinkVar(SharedData().geometric_muts, "geometric_muts",
+                      "Pick mutated sites by sampling the gaps between them? (faster for long genomes)");
+      GetManager().LinkMenu(
+        SharedData().crossover, "crossover", "How should recombination mix two parents' values?",
+        Crossover::UNIFORM, "uniform", "Take each value from either parent with equal probability.",
+        Crossover::ONE_POINT, "one_point", "Take all values after a random point from the second parent.",
+        Crossover::TWO_POINT, "two_point", "Take the values between two random points from the second parent.");
     }
 
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
-      // Setup the mutation distribution.
-      SharedData().mut_dist.Setup(SharedData().mut_prob, SharedData().num_vals);
-
-      // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(SharedData().num_vals);
-
-      // Setup the output trait.
-      GetManager().AddSharedTrait(SharedData().genome_name,
-                                  "Value array output from organism.",
-                                  0.0,
-                                  SharedData().num_vals);
-      // Setup the output trait.
-      GetManager().AddSharedTrait(SharedData().total_name,
-                                  "Total of all organism outputs.",
-                                  0.0);
+      // Setup the mutation sampler.
+      SharedData().mut_sampler.Setup(SharedData().mut_prob, SharedData().num_vals,
+                                     SharedData().geometric_muts);
+
+      // Pick the mutation kernel for the configured bounds.
+      SharedData().mutate_fun = Select(SharedData().lower_bound, SharedData().upper_bound,
+        []<BoundType LOWER, BoundType UPPER>() -> mutate_fun_t {
+          return &this_t::template MutateBounded<LOWER, UPPER>;
+        });
     }
   };
 
   ///////////////////////////////////////////////////////////////////////////////////////////
   //  Helper functions....
 
-  void ValsOrg::ManagerData::ApplyBounds(double & value) {
-    if (value > max_value) {
-      switch (upper_bound) {
-        case LIMIT_NONE:    break;
-        case LIMIT_CLAMP:   value = max_value; break;
-        case LIMIT_WRAP:    value -= (max_value - min_value); break;
-        case LIMIT_REBOUND: value = 2 * max_value - value; break;
-        case LIMIT_ERROR:   break;  // For now; perhaps do something with error?
-      }
-    }
-    else if (value < min_value) {
-      switch (lower_bound) {
-        case LIMIT_NONE:    break;
-        case LIMIT_CLAMP:   value = min_value; break;
-        case LIMIT_WRAP:    value += (max_value - min_value); break;
-        case LIMIT_REBOUND: value = 2 * min_value - value; break;
-        case LIMIT_ERROR:   break;  // For now; perhaps do something with error?
-      }
-    }
+  template <typename VAL_T>
+  void ValsOrgT<VAL_T>::ManagerData::ApplyBounds(VAL_T & value) const {
+    const VAL_T min = (VAL_T) min_value, max = (VAL_T) max_value;
+    value = Select(lower_bound, upper_bound, [value, min, max]<BoundType LOWER, BoundType UPPER>() {
+      return Apply<LOWER, UPPER>(value, min, max);
+    });
   }
 
-  void ValsOrg::ManagerData::ApplyBounds(std::span<double> & vals) {
-    const size_t range_size = max_value - min_value;
-
-    switch (upper_bound) {
-    case LIMIT_NONE: break;
-    case LIMIT_CLAMP:
-      for (double & value : vals) {
-        if (value > max_value) value = max_value;
-        else if (value < min_value) value = min_value;        
-      }
-      break;
-    case LIMIT_WRAP:
-      for (double & value : vals) {
-        if (value > max_value) value -= range_size;
-        else if (value < min_value) value += range_size;        
-      }
-      break;
-    case LIMIT_REBOUND:
-      for (double & value : vals) {
-        if (value > max_value) value = 2 * max_value - value;
-        else if (value < min_value) value = 2 * min_value - value;
-      }
-      break;
-    default:
-      break; // Should probably throw error.
-    }
+  template <typename VAL_T>
+  void ValsOrgT<VAL_T>::ManagerData::ApplyBounds(std::span<VAL_T> vals) const {
+    const VAL_T min = (VAL_T) min_value, max = (VAL_T) max_value;
+    Select(lower_bound, upper_bound, [vals, min, max]<BoundType LOWER, BoundType UPPER>() {
+      for (VAL_T & value : vals) value = Apply<LOWER, UPPER>(value, min, max);
+    });
   }
 
+  using ValsOrg = ValsOrgT<double>;
+  using FloatValsOrg = ValsOrgT<float>;
 
   MABE_REGISTER_ORG_TYPE(ValsOrg, "Organism consisting of a series of N floating-point values.");
+  MABE_REGISTER_ORG_TYPE(FloatValsOrg, "Organism consisting of a series of N single-precision values.");
 }
 
 #endif
@@ -0,0 +1,178 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ValsSummaryOrg.hpp
+ *  @brief An organism summarizing a series of N floating-point values by their mean and variance.
+ *  @note Status: ALPHA
+ *
+ *  This organism type represents a ValsOrg where only the total (and so the mean) and the
+ *  variance of the values matter, so the values themselves are never stored.  On reproduction
+ *  the number of mutated values is binomial and each mutation adds a normal deviate with
+ *  standard deviation mut_size.  The change in the total is sampled exactly; the change in
+ *  the variance treats the mutated values as a representative sample of the genome (their
+ *  deviations from the mean have the current variance), which is exact in expectation.
+ *
+ *  Since individual values are unknown, no bounds are enforced after mutations.
+ */
+
+#ifndef MABE_VALS_SUMMARY_ORGANISM_HPP
+#define MABE_VALS_SUMMARY_ORGANISM_HPP
+
+#include <algorithm>
+#include <cmath>
+
+#include "../core/MABE.hpp"
+#include "../core/Organism.hpp"
+#include "../core/OrganismManager.hpp"
+
+#include "emp/math/Distribution.hpp"
+#include "emp/math/random_utils.hpp"
+
+namespace mabe {
+
+  class ValsSummaryOrg : public OrganismTemplate<ValsSummaryOrg> {
+  public:
+    struct ManagerData : public Organism::ManagerData {
+      size_t num_vals = 100;             ///< Number of values in the simulated genome.
+      double mut_prob = 0.01;            ///< Probability of position mutating on reproduction.
+      double mut_size = 1.0;             ///< Standard deviation of mutations.
+      double min_value = 0.0;            ///< Lower end of the range for random values.
+      double max_value = 100.0;          ///< Upper end of the range for random values.
+      bool init_random = true;           ///< Should we randomize ancestor?  (false = all 0.0)
+
+      // Organism traits
+      SharedTrait<double> total_trait{this, "total", "Total of all organism values."};
+      SharedTrait<double> mean_trait{this, "mean", "Mean of all organism values."};
+      SharedTrait<double> variance_trait{this, "variance", "Variance of all organism values."};
+
+      // Helper member variables.
+      emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
+
+      ManagerData() {
+        total_trait.SetConfigName("total_name");
+        total_trait.SetConfigDesc("Name of variable to contain total of all values.");
+        mean_trait.SetConfigName("mean_name");
+        mean_trait.SetConfigDesc("Name of variable to contain mean of all values.");
+        variance_trait.SetConfigName("variance_name");
+        variance_trait.SetConfigDesc("Name of variable to contain variance of all values.");
+      }
+    };
+
+    ValsSummaryOrg(OrganismManager<ValsSummaryOrg> & _manager)
+      : OrganismTemplate<ValsSummaryOrg>(_manager) { }
+    ValsSummaryOrg(const ValsSummaryOrg &) = default;
+    ValsSummaryOrg(ValsSummaryOrg &&) = default;
+    ValsSummaryOrg & operator=(const ValsSummaryOrg &) = default;
+    ~ValsSummaryOrg() { ; }
+
+    emp::String ToString() const override {
+      return emp::MakeString("[MEAN=", SharedData().mean_trait(*this),
+                             ",VAR=", SharedData().variance_trait(*this),
+                             "]:(TOTAL=", SharedData().total_trait(*this), ")");
+    }
+
+    /// Draw from a chi-squared distribution with 'dof' degrees of freedom.
+    static double RandomChiSquared(emp::Random & random, size_t dof) {
+      if (dof <= 64) {
+        double result = 0.0;
+        for (size_t i = 0; i < dof; ++i) { const double z = random.GetNormal(); result += z*z; }
+        return result;
+      }
+      // Large samples are very close to normal.
+      return std::max(0.0, (double) dof + std::sqrt(2.0 * (double) dof) * random.GetNormal());
+    }
+
+    /// Store a new total and sum of squared deviations (from the mean) in the traits.
+    void SetSummary(double total, double sum_sq_dev) {
+      const double num_vals = (double) SharedData().num_vals;
+      SharedData().total_trait(*this) = total;
+      SharedData().mean_trait(*this) = total / num_vals;
+      SharedData().variance_trait(*this) = std::max(0.0, sum_sq_dev) / num_vals;
+    }
+
+    size_t Mutate(emp::Random & random) override {
+      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
+      if (num_muts == 0) return 0;
+
+      const double num_vals = (double) SharedData().num_vals;
+      const double mut_size = SharedData().mut_size;
+      const double total = SharedData().total_trait(*this);
+      const double variance = SharedData().variance_trait(*this);
+      const double k = (double) num_muts;
+
+      // Sum of all mutation deviates, and the (sampled) sum of their products with the
+      // mutated values' deviations from the mean.
+      const double mut_sum = std::sqrt(k) * mut_size * random.GetNormal();
+      const double cross_sum = std::sqrt(k * variance) * mut_size * random.GetNormal();
+
+      // Sum of squared mutation deviates, given their sum.
+      const double mut_sq_sum = mut_sum * mut_sum / k
+                              + mut_size * mut_size * RandomChiSquared(random, num_muts - 1);
+
+      const double sum_sq_dev = variance * num_vals + 2.0 * cross_sum + mut_sq_sum
+                              - mut_sum * mut_sum / num_vals;
+      SetSummary(total + mut_sum, sum_sq_dev);
+      return num_muts;
+    }
+
+    /// Mutations only read shared settings, so offspring can be mutated in parallel.
+    bool IsMutateThreadSafe() const override { return true; }
+
+    /// Initialize() only sets this organism's own summary values, so it can run in parallel.
+    bool IsInitializeThreadSafe() const override { return true; }
+
+    void Randomize(emp::Random & random) override {
+      // Values are uniform in [min_value, max_value]; sample the total, use expected variance.
+      const double num_vals = (double) SharedData().num_vals;
+      const double range = SharedData().max_value - SharedData().min_value;
+      const double range_var = range * range / 12.0;
+      const double total = num_vals * (SharedData().min_value + range / 2.0)
+                         + std::sqrt(num_vals * range_var) * random.GetNormal();
+      SetSummary(total, (num_vals - 1.0) * range_var);
+    }
+
+    void Initialize(emp::Random & random) override {
+      if (SharedData().init_random) Randomize(random);
+      else SetSummary(0.0, 0.0);
+    }
+
+    /// Values are stored in traits, so there is no additional state to checkpoint.
+    bool SaveState(CheckpointWriter &) const override { return true; }
+    bool LoadState(CheckpointReader &) override { return true; }
+
+    /// Put the values in the correct output positions.
+    void GenerateOutput() override {
+      /// Output is already stored in the DataMap.
+    }
+
+    /// Setup this organism type to be able to load from config.
+    void SetupConfig() override {
+      GetManager().LinkVar(SharedData().num_vals, "N", "Number of values in organism");
+      GetManager().LinkVar(SharedData().mut_prob, "mut_prob",
+                      "Probability of each value mutating on reproduction.");
+      GetManager().LinkVar(SharedData().mut_size, "mut_size",
+                      "Standard deviation on size of mutations.");
+      GetManager().LinkVar(SharedData().min_value, "min_value",
+                      "Lower limit for randomized values.");
+      GetManager().LinkVar(SharedData().max_value, "max_value",
+                      "Upper limit for randomized values.");
+      GetManager().LinkVar(SharedData().init_random, "init_random",
+                      "Should we randomize ancestor?  (0 = all 0.0)");
+    }
+
+    /// Setup this organism type with the traits it need to track.
+    void SetupModule() override {
+      if (SharedData().num_vals == 0) {
+        emp::notify::Error("ValsSummaryOrg requires at least one value (N > 0).");
+        SharedData().num_vals = 1;
+      }
+      SharedData().mut_dist.Setup(SharedData().mut_prob, SharedData().num_vals);
+    }
+  };
+
+  MABE_REGISTER_ORG_TYPE(ValsSummaryOrg, "Organism summarizing N floating-point values by mean and variance.");
+}
+
+#endif
@@ -25,11 +25,18 @@
 #ifndef MABE_VIRTUAL_CPU_ORGANISM_H
 #define MABE_VIRTUAL_CPU_ORGANISM_H
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 
 #include "../core/MABE.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
+#include "../tools/InstCounts.hpp"
+#include "../tools/MemoCache.hpp"
+#include "../tools/MutationSites.hpp"
+#include "../tools/RandomStreams.hpp"
+#include "../tools/TraceBuffer.hpp"
 
 #include "emp/datastructs/vector_utils.hpp"
 #include "emp/hardware/VirtualCPU.hpp"
@@ -57,9 +64,17 @@ namespace mabe {
     using data_vec_t = emp::vector<data_t>;
     using inst_func_t = std::function<void(this_t&, const this_t::inst_t&)>;
 
+    /// IDs of the searches that instruction modules run through CachedSearch().
+    enum SearchID : uint64_t {
+      SEARCH_LABEL_S = 1, SEARCH_LABEL_F, SEARCH_LABEL_B,
+      SEARCH_SEQ_S, SEARCH_SEQ_F, SEARCH_SEQ_B,
+      SEARCH_H
+    };
+
   protected: 
     size_t insts_speculatively_executed = 0;
-    emp::BitVector non_speculative_inst_vec;
+    uint64_t search_key = 0;        ///< Fingerprint of the working genome for search lookups (0 = not yet computed).
+    bool search_cacheable = false;  ///< Is the working genome in a state whose searches can be cached?
 
     /// Perform a single point mutation at the given position
     void Mutate_Point(size_t pos, emp::Random& random){
@@ -79,9 +94,11 @@ namespace mabe {
     }
 
     /// Apply mutations according to the passed parameters, and then call the given function 
-    /// for each mutation
+    /// for each mutation.  The mutation function is a template parameter so that it can be
+    /// inlined; unique positions are tracked in the shared mut_sites vector.
+    template <typename MUT_FUNC_T>
     size_t Mutate_Generic(
-        std::function<void(size_t, emp::Random&)> mut_func,
+        MUT_FUNC_T && mut_func,
         emp::CombinedBinomialDistribution& dist, 
         emp::Random& random, 
         bool ensure_unique_pos = true){
@@ -97,14 +114,16 @@ namespace mabe {
       }
       // Only remaining option is num_muts > 1.
       if(ensure_unique_pos){ // Ensure no two mutations hit the same site
-        emp::BitVector mut_sites(genome.size());
+        emp::BitVector & mut_sites = SharedData().mut_sites;
+        mut_sites.Resize(GetGenomeSize());
+        mut_sites.Clear();
         for (size_t i = 0; i < num_muts; i++) {
           const size_t pos = random.GetUInt(GetGenomeSize());
           if(mut_sites[pos]){ --i; continue; } // Duplicate position; try again.
-          mut_sites[pos] = true;
+          mut_sites.Set(pos);
           mut_func(pos, random);
           if(mut_sites.size() != GetGenomeSize()){
-            mut_sites.resize(GetGenomeSize());
+            mut_sites.Resize(GetGenomeSize());
           }
         }
       }
@@ -117,6 +136,52 @@ namespace mabe {
       return num_muts;
     }
 
+    /// Apply insertions and deletions in a single pass over the genome: each site is deleted
+    /// with deletion_mut_prob and has a random instruction inserted before it with
+    /// insertion_mut_prob (the end of the genome is also an insertion point).  Returns the
+    /// number of mutations.
+    size_t Mutate_Indels(emp::Random& random){
+      const size_t old_size = GetGenomeSize();
+      const GeometricSites & ins_gaps = SharedData().insertion_mut_gaps;
+      const GeometricSites & del_gaps = SharedData().deletion_mut_gaps;
+      size_t next_ins = ins_gaps.NextGap(random, old_size + 1);
+      size_t next_del = del_gaps.NextGap(random, old_size);
+      if(next_ins > old_size && next_del >= old_size) return 0;
+
+      emp::vector<inst_t> & new_genome = SharedData().mut_genome;
+      emp::vector<size_t> & inserted = SharedData().mut_inserted;
+      new_genome.resize(0);
+      inserted.resize(0);
+      size_t num_muts = 0;
+      for(size_t pos = 0; pos <= old_size; ++pos){
+        if(pos == next_ins){ // Leave a slot to randomize once it is in the genome.
+          inserted.push_back(new_genome.size());
+          new_genome.push_back(GetDefaultInst());
+          next_ins += 1 + ins_gaps.NextGap(random, old_size - next_ins);
+          ++num_muts;
+        }
+        if(pos == old_size) break;
+        if(pos == next_del){
+          next_del += 1 + del_gaps.NextGap(random, old_size - next_del - 1);
+          ++num_muts;
+        }
+        else new_genome.push_back(genome[pos]);
+      }
+
+      genome.resize(new_genome.size(), GetDefaultInst());
+      std::copy(new_genome.begin(), new_genome.end(), genome.begin());
+      for(size_t pos : inserted) RandomizeInst(pos, random);
+      return num_muts;
+    }
+
+    /// Free genome storage a newborn does not need until it replicates: its offspring genome
+    /// (which holds the buffer swapped out of its genome) and any working genome capacity
+    /// beyond its current length (inherited from a parent that allocated room to copy into).
+    void ReleaseSpareGenomes() {
+      SharedData().offspring_genome_trait(*this) = genome_t(GetInstLib());
+      genome_working = decltype(genome_working)(genome_working);
+    }
+
   public:
     VirtualCPUOrg(OrganismManager<VirtualCPUOrg> & _manager)
       : OrganismTemplate<VirtualCPUOrg>(_manager), VirtualCPU(genome_t(GetInstLib()) ){ }
@@ -136,10 +201,10 @@ namespace mabe {
       SharedTrait<double> offspring_merit_trait{this, "offspring_merit", "Fitness passed on to offspring"};
       OwnedTrait<emp::String> genome_trait{this, "genome", "Organism's genome"};
       SharedTrait<genome_t> offspring_genome_trait{this, "offspring_genome", "Latest genome copied"};
-      OwnedTrait<genome_t> original_genome_trait{this, "original_genome", "Genome as passed from parent"};
       SharedTrait<OrgPosition> position_trait{this, "position", "Organism's position"};
       OwnedTrait<size_t> generation_trait{this, "generation", "Organism's generation"};
       OwnedTrait<size_t> length_trait{this, "genome_length", "Num instructions in organism's genome"};
+      OwnedTrait<size_t> insts_trait{this, "insts_executed", "Instructions run this lifetime (if count_insts)"};
 
       // Configuration variables
       double point_mut_prob = 0.01;      ///< Per-site point mutation rate.
@@ -167,28 +232,83 @@ namespace mabe {
                                                    execute instruction.*/
       int max_speculative_insts = -1;         /**< Maximum number of insts. to speculatively 
                                                   execute. -1 for genome length. */
+      bool geometric_muts = false;  ///< Pick point mutation sites by sampling the gaps between them?
+      bool one_pass_indels = false; ///< Apply insertions and deletions in one pass over the genome?
+      size_t exec_cache_size = 0;   ///< Max (genome, inputs) runs to remember; 0 = off.
+      size_t search_cache_size = 0; ///< Max label and nop-sequence search results to remember; 0 = off.
+      bool compact_state = false;   ///< Release spare genome buffers in newborn organisms?
+      size_t trace_size = 0;        ///< Most recent instructions to keep in the trace; 0 = off.
+      emp::String trace_positions = "";        ///< Positions to trace (empty = all).
+      emp::String trace_file = "trace.mtr";    ///< File the trace is written to at the end of the run.
+      bool count_insts = false;     ///< Count every instruction executed, by population?
       // Internal use
       emp::CombinedBinomialDistribution point_mut_dist; ///< Distribution of number of point mutations to occur.
       emp::CombinedBinomialDistribution insertion_mut_dist; ///< Distribution of number of insertion mutations to occur.
       emp::CombinedBinomialDistribution deletion_mut_dist; ///< Distribution of number of deletion mutations to occur.
       emp::BitVector mut_sites; ///< A pre-allocated vector for mutation sites. 
+      GeometricSites point_mut_gaps; ///< Point mutation gap sampler (for geometric_muts).
+      GeometricSites insertion_mut_gaps; ///< Insertion gap sampler (for one_pass_indels).
+      GeometricSites deletion_mut_gaps;  ///< Deletion gap sampler (for one_pass_indels).
+      emp::vector<inst_t> mut_genome;    ///< Reused buffer for building a mutated genome.
+      emp::vector<size_t> mut_inserted;  ///< Reused buffer of inserted positions.
+
+      /// Outputs and merit recorded from running a genome on a set of inputs.
+      struct ExecResult {
+        data_vec_t outputs;
+        double merit = 0.0;
+      };
+      MemoCache<ExecResult> exec_cache;  ///< Results keyed by genome and inputs.
+      RandomStreams exec_hasher;         ///< Used to mix genome and inputs into a key.
+      MemoCache<size_t> search_cache;    ///< Search results keyed by working genome, search, and position.
+
+      /// Per-instruction flags, built once by SetupInstLib() and only read afterward; kept here
+      /// (rather than in each organism) so every organism reads the same small table.
+      emp::BitVector non_speculative_insts;  ///< Instructions that end a speculative run.
+      emp::BitVector barrier_insts;          ///< Instructions that must not run in parallel.
+
+      /// Set by SetupModule() if verbose or trace_size; steps are then run one at a time.
+      bool tracing = false;
+      /// Tracing or counting: the only flag checked per step.
+      bool watch_steps = false;
+      InstCounts inst_counts;                ///< Instructions executed (if count_insts).
+      emp::BitVector traced_positions;       ///< Positions to trace (empty = all).
+      TraceBuffer trace;                     ///< Most recent traced instructions.
+      emp::vector<std::string> trace_op_names;  ///< Instruction names, by index, for the trace file.
+
+      bool IsTracedPos(size_t pos) const {
+        return traced_positions.GetSize() == 0
+          || (pos < traced_positions.GetSize() && traced_positions[pos]);
+      }
+
+      ~ManagerData() {
+        if (trace.GetSize() == 0 || trace_file.empty()) return;
+        std::ofstream file(trace_file, std::ios::binary);
+        trace.Write(file, trace_op_names);
+      }
     };
 
     /// Mutate (in place) the current organism.
     size_t Mutate(emp::Random & random) override {
       size_t mut_count = 0;
-      mut_count += Mutate_Generic(
+      if (SharedData().geometric_muts) {
+        mut_count += SharedData().point_mut_gaps.ForEachSite(GetGenomeSize(), random,
+          [this, &random](size_t pos){ Mutate_Point(pos, random); });
+      }
+      else mut_count += Mutate_Generic(
         [this](size_t pos, emp::Random& random){ Mutate_Point(pos, random); },
         SharedData().point_mut_dist, random, true
       );
-      mut_count += Mutate_Generic(
-        [this](size_t pos, emp::Random& random){ Mutate_Insertion(pos, random); },
-        SharedData().insertion_mut_dist, random, false 
-      );
-      mut_count += Mutate_Generic(
-        [this](size_t pos, emp::Random& random){ Mutate_Deletion(pos, random); },
-        SharedData().deletion_mut_dist, random, false
-      );
+      if (SharedData().one_pass_indels) mut_count += Mutate_Indels(random);
+      else {
+        mut_count += Mutate_Generic(
+          [this](size_t pos, emp::Random& random){ Mutate_Insertion(pos, random); },
+          SharedData().insertion_mut_dist, random, false 
+        );
+        mut_count += Mutate_Generic(
+          [this](size_t pos, emp::Random& random){ Mutate_Deletion(pos, random); },
+          SharedData().deletion_mut_dist, random, false
+        );
+      }
       // Update hardware and traits accordingly
       ResetWorkingGenome();
       SharedData().genome_trait(*this) = GetGenomeString();
@@ -265,6 +385,57 @@ namespace mabe {
       ResetTraits();
     }
 
+    /// Save the genome as instruction IDs; hardware state is not saved, so a restored
+    /// organism restarts execution from the top of its genome.
+    bool SaveState(CheckpointWriter & out) const override {
+      emp::vector<uint32_t> inst_ids(GetGenomeSize());
+      for (size_t pos = 0; pos < inst_ids.size(); ++pos) inst_ids[pos] = (uint32_t) genome[pos].idx;
+      out.Write(inst_ids);
+      return true;
+    }
+
+    bool LoadState(CheckpointReader & in) override {
+      const emp::vector<uint32_t> inst_ids = in.Read<emp::vector<uint32_t>>();
+      genome.resize(0, GetDefaultInst());
+      for (uint32_t id : inst_ids) PushInst(id);
+      ResetHardware();
+      return true;
+    }
+
+    /// Reset the working genome to a copy of the genome; searches in it can be cached again.
+    void ResetWorkingGenome(){
+      base_t::ResetWorkingGenome();
+      search_key = 0;
+      search_cacheable = true;
+    }
+
+    /// Note that the working genome has grown or shrunk (its contents still follow from the
+    /// genome), so its search fingerprint must be recomputed.
+    void MarkWorkingGenomeResized(){ search_key = 0; }
+
+    /// Note that instructions in the working genome have been overwritten (e.g., by a copy);
+    /// searches are not cached again until the working genome is reset.
+    void MarkWorkingGenomeEdited(){ search_cacheable = false; }
+
+    /// Run a label or nop-sequence search, or reuse the result of the same search ('search_id'
+    /// from the same instruction pointer) in an identical working genome, whether in this
+    /// organism or another of the same genotype.  The search must depend only on the working
+    /// genome and the instruction pointer.
+    template <typename FUN_T>
+    size_t CachedSearch(uint64_t search_id, FUN_T && search){
+      MemoCache<size_t> & cache = SharedData().search_cache;
+      if(!cache.IsActive() || !search_cacheable) return search();
+      const RandomStreams & hasher = SharedData().exec_hasher;
+      if(search_key == 0){
+        uint64_t key = hasher.CalcKey(genome_working.size());
+        for(size_t pos = 0; pos < genome_working.size(); ++pos){
+          key = hasher.CalcKey(key, genome_working[pos].idx);
+        }
+        search_key = key | 1;   // Never 0, which marks a key that needs computing.
+      }
+      return cache.Get(hasher.CalcKey(search_key, search_id, inst_ptr), search);
+    }
+
     /// Reset the organism back to starting conditions
     void Reset(){
       ResetHardware();
@@ -273,16 +444,15 @@ namespace mabe {
     
     /// Create an offspring organism using the configuration file's mutation rate.
     emp::Ptr<Organism> MakeOffspringOrganism(emp::Random & random) const override {
-      // Create and mutate
-      auto offspring_ptr = OrgType::Clone().DynamicCast<VirtualCPUOrg>();
+      // Create and mutate.  The clone already holds a copy of this organism's offspring genome
+      // (in its own offspring genome trait), so swap that buffer in as its genome rather than
+      // copying again; its old genome buffer is then reused when it builds its own offspring.
+      emp::Ptr<VirtualCPUOrg> offspring_ptr = CloneProduct();
       VirtualCPUOrg & offspring = *offspring_ptr;
-      const genome_t offspring_genome = SharedData().offspring_genome_trait(*this);
-      offspring.genome.resize(offspring_genome.size(), GetDefaultInst());
-      std::copy( offspring_genome.begin(),
-                 offspring_genome.end(),
-                 offspring.genome.begin() );
+      std::swap(offspring.genome, SharedData().offspring_genome_trait(offspring));
       offspring.ResetWorkingGenome();
       offspring.Mutate(random);
+      offspring.MarkGenomeChanged();
       offspring.Reset();
       double bonus = 0;
       if (SharedData().copy_influences_merit){
@@ -302,13 +472,14 @@ namespace mabe {
       SharedData().output_trait(offspring).clear();
       offspring.ResetHardware();
       offspring.insts_speculatively_executed = 0;
+      if (SharedData().compact_state) offspring.ReleaseSpareGenomes();
 
       return offspring_ptr;
     }
     
     /// Create an identical organism with no mutations and with the same merit
     virtual emp::Ptr<Organism> CloneOrganism() const override {
-      auto offspring_ptr = OrgType::Clone().DynamicCast<VirtualCPUOrg>();
+      emp::Ptr<VirtualCPUOrg> offspring_ptr = CloneProduct();
       VirtualCPUOrg & offspring = *offspring_ptr;
 
       offspring.ResetWorkingGenome();
@@ -317,9 +488,11 @@ namespace mabe {
       SharedData().offspring_merit_trait(offspring) = SharedData().initial_merit; 
       SharedData().genome_trait(offspring) = offspring.GetGenomeString();
       SharedData().length_trait(offspring) = offspring.GetGenomeSize();
+      SharedData().insts_trait(offspring) = 0;
       SharedData().output_trait(offspring).clear();
       offspring.expanded_nop_args = SharedData().expanded_nop_args;
       offspring.insts_speculatively_executed = 0;
+      if (SharedData().compact_state) offspring.ReleaseSpareGenomes();
 
       return offspring_ptr;
     }
@@ -334,6 +507,63 @@ namespace mabe {
 
       // Run the code.
       //Process(SharedData().eval_time, SharedData().verbose);
+      if(SharedData().exec_cache.IsActive()) Process_Cached();
+    }
+
+    emp::String ToString() const override { return SharedData().genome_trait(*this); }
+
+    /// Hash of each instruction in the (original) genome.
+    uint64_t GetGenomeHash() const override {
+      return GenomeHash::Calc(GetGenomeSize(), [this](size_t pos){ return (uint64_t) genome[pos].idx; });
+    }
+
+    size_t GetObjectBytes() const override {
+      return sizeof(VirtualCPUOrg) + (GetGenomeSize() + genome_working.size()) * sizeof(inst_t);
+    }
+
+    /// Fingerprint of the current genome together with the inputs it will be given.
+    uint64_t CalcExecKey() const {
+      const RandomStreams & hasher = SharedData().exec_hasher;
+      uint64_t key = hasher.CalcKey(GetGenomeSize());
+      for(size_t pos = 0; pos < GetGenomeSize(); ++pos) key = hasher.CalcKey(key, genome[pos].idx);
+      for(const data_t & input : SharedData().input_trait(*this)) key = hasher.CalcKey(key, input);
+      return key;
+    }
+
+    /// Run the genome for eval_time instructions, unless the same genome has already been run
+    /// on the same inputs; then copy the outputs and merit it produced instead.  Only valid
+    /// when execution is deterministic given the genome and inputs.
+    void Process_Cached(){
+      const uint64_t key = CalcExecKey();
+      typename ManagerData::ExecResult result;
+      if(SharedData().exec_cache.Lookup(key, result)){
+        SharedData().output_trait(*this) = result.outputs;
+        SharedData().merit_trait(*this) = result.merit;
+        return;
+      }
+      Process(SharedData().eval_time, SharedData().verbose);
+      result.outputs = SharedData().output_trait(*this);
+      result.merit = SharedData().merit_trait(*this);
+      SharedData().exec_cache.Store(key, result);
+    }
+
+    /// An instruction set compiled ahead of time (see build/gen_inst_set.py): one function
+    /// runs any of its instructions, switching on the instruction ID.
+    struct CompiledInstSet {
+      emp::vector<emp::String> names;                 ///< Instruction names, in ID order.
+      std::function<bool(MABE&)> bind;                ///< Find instruction modules (false if missing)
+      void (*dispatch)(VirtualCPUOrg&, const inst_t&) = nullptr;
+    };
+
+    static CompiledInstSet& GetCompiledInstSet(){
+      static CompiledInstSet compiled_inst_set;
+      return compiled_inst_set;
+    }
+
+    /// Register a compiled instruction set; returns true so it can initialize a static.
+    static bool SetCompiledInstSet(CompiledInstSet in_set){
+      GetCompiledInstSet() = std::move(in_set);
+      return true;
     }
 
     /// Return a reference to the instruction library of the organism
@@ -344,6 +574,12 @@ namespace mabe {
 
     /// Set up configuration options for this organism type
     void SetupConfig() override {
+      // Group traits touched during execution apart from those kept mostly for output.
+      SharedData().merit_trait.SetUsage(TraitInfo::Usage::HOT);
+      SharedData().offspring_merit_trait.SetUsage(TraitInfo::Usage::HOT);
+      SharedData().generation_trait.SetUsage(TraitInfo::Usage::ARCHIVE);
+      SharedData().length_trait.SetUsage(TraitInfo::Usage::ARCHIVE);
+
       GetManager().LinkVar(SharedData().point_mut_prob, "point_mut_prob",
                       "Per-site probability of a point mutation");
       GetManager().LinkVar(SharedData().insertion_mut_prob, "insertion_mut_prob",
@@ -360,7 +596,7 @@ namespace mabe {
       GetManager().LinkVar(SharedData().initial_merit, "initial_merit",
                       "Initial value for merit (task performance)");
       GetManager().LinkVar(SharedData().verbose, "verbose",
-                      "If true, print execution info of organisms");
+                      "If true, print execution info of organisms (at trace_positions, if set)");
       GetManager().LinkVar(SharedData().inst_set_input_filename, "inst_set_input_filename",
                       "File that contains the instruction set to use."
                       " One instruction name per line. Order is maintained.");
@@ -384,6 +620,39 @@ namespace mabe {
                       "copy_influences_merit",
                       "If 1, the number of instructions copied (e.g., via HCopy instruction)"
                       "factor into offspring merit");
+      GetManager().LinkVar(SharedData().geometric_muts, "geometric_muts",
+                      "If true, point mutation sites are picked by sampling the gaps between "
+                      "them (faster for long genomes)");
+      GetManager().LinkVar(SharedData().one_pass_indels, "one_pass_indels",
+                      "If true, insertions and deletions are applied per site in a single pass "
+                      "over the genome rather than shifting the genome for each one");
+      GetManager().LinkVar(SharedData().exec_cache_size, "exec_cache_size",
+                      "If > 0, GenerateOutput runs each genome for eval_time instructions and "
+                      "remembers the outputs and merit of up to this many (genome, input) "
+                      "pairs, reusing them for identical programs; only use with programs "
+                      "that are deterministic given their inputs");
+      GetManager().LinkVar(SharedData().search_cache_size, "search_cache_size",
+                      "If > 0, results of label and nop-sequence searches (e.g., by "
+                      "SearchLabelDirectF or HSearch) are remembered for up to this many "
+                      "(working genome, search, position) combinations and shared among "
+                      "organisms of the same genotype, until the working genome is copied into");
+      GetManager().LinkVar(SharedData().trace_size, "trace_size",
+                      "If > 0, record each instruction executed (at trace_positions, if set) "
+                      "and keep the most recent this many; written to trace_file when the "
+                      "run ends (see build/read_trace.py)");
+      GetManager().LinkVar(SharedData().trace_positions, "trace_positions",
+                      "Comma-separated positions of organisms to trace or print (blank for all)");
+      GetManager().LinkVar(SharedData().trace_file, "trace_file",
+                      "File to write the instruction trace to");
+      GetManager().LinkVar(SharedData().count_insts, "count_insts",
+                      "If true, count every instruction executed (by population; see "
+                      "INST_COUNT() and HOT_INSTS()) and each organism's total in its "
+                      "insts_executed trait; runs with exec_cache_size > 0 are not counted");
+      GetManager().LinkVar(SharedData().compact_state, "compact_state",
+                      "If true, newborn organisms drop their spare genome buffers (the copy "
+                      "swapped out of the offspring genome and any excess working genome "
+                      "capacity), saving memory in large populations at some cost in "
+                      "reallocation when they replicate");
     }
 
     /// Set up this organism type with the traits it need to track and initialize 
@@ -391,11 +660,83 @@ namespace mabe {
     void SetupModule() override {
       SetupMutationDistribution();
       SetupInstLib();
+      SharedData().exec_cache.SetCapacity(SharedData().exec_cache_size);
+      SharedData().search_cache.SetCapacity(SharedData().search_cache_size);
+      SetupTrace();
+      if(SharedData().count_insts) SetupInstStats();
       if(!SharedData().inst_set_output_filename.empty()){
         WriteInstructionSetFile(SharedData().inst_set_output_filename);
       }
     }
 
+    /// Add STATS entries for the instruction counts of this organism type.
+    void SetupInstStats(){
+      const emp::String & name = GetManager().GetName();
+      const InstCounts & counts = SharedData().inst_counts;
+      MABEScript & script = GetManager().GetControl().GetConfigScript();
+      script.AddStat(name + "_insts", [&counts](){ return (double) counts.GetTotal(); },
+                     "Instructions executed by '" + name + "' organisms.");
+      script.AddStat(name + "_hot_inst", [&counts](){
+          const emp::vector<size_t> hottest = counts.GetHottest(1);
+          return hottest.size() ? (double) hottest[0] : -1.0;
+        }, "Index of the instruction executed most by '" + name + "' organisms (-1 if none).");
+    }
+
+    /// Index of the named instruction, or the size of the instruction set if unknown.
+    static size_t FindInstIndex(const ManagerData & data, const emp::String & inst_name){
+      const auto & names = data.trace_op_names;
+      return (size_t) (std::find(names.begin(), names.end(), inst_name.str()) - names.begin());
+    }
+
+    /// Script functions on the manager for reading instruction counts.
+    template <typename MANAGER_T>
+    static void InitManagerType(emplode::TypeInfo & info){
+      info.AddMemberFunction("INST_COUNT",
+        [](MANAGER_T & mod, const emp::String & inst_name){
+          const ManagerData & data = mod.GetManagedData();
+          return data.inst_counts.GetCount(FindInstIndex(data, inst_name));
+        }, "Times the named instruction has been executed (requires count_insts).");
+      info.AddMemberFunction("POP_INST_COUNT",
+        [](MANAGER_T & mod, Population & pop, const emp::String & inst_name){
+          const ManagerData & data = mod.GetManagedData();
+          return data.inst_counts.GetCount(FindInstIndex(data, inst_name), (size_t) pop.GetID());
+        }, "Times the named instruction has been executed in a population (requires count_insts).");
+      info.AddMemberFunction("HOT_INSTS",
+        [](MANAGER_T & mod, size_t num_insts){
+          const ManagerData & data = mod.GetManagedData();
+          emp::String out;
+          for (size_t idx : data.inst_counts.GetHottest(num_insts)) {
+            if (out.size()) out += ',';
+            out += emp::MakeString(data.trace_op_names[idx], ':', data.inst_counts.GetCount(idx));
+          }
+          return out;
+        }, "The most executed instructions as 'name:count' pairs, most executed first.");
+      info.AddMemberFunction("CLEAR_INST_COUNTS",
+        [](MANAGER_T & mod){ mod.GetManagedData().inst_counts.Clear(); return 0; },
+        "Reset all instruction counts to zero.");
+    }
+
+    /// Prepare tracing from the verbose and trace_* settings.
+    void SetupTrace(){
+      ManagerData & data = SharedData();
+      data.tracing = data.verbose || data.trace_size > 0;
+      data.watch_steps = IsTracing() || data.count_insts;
+      data.trace.SetCapacity(data.trace_size);
+      data.traced_positions.Resize(0);
+      emp::String positions = data.trace_positions;
+      emp::remove_whitespace(positions);
+      for(const emp::String & pos_str : positions.Slice(",")){
+        if(pos_str.empty()) continue;
+        const size_t pos = emp::from_string<size_t>(pos_str);
+        if(pos >= data.traced_positions.GetSize()) data.traced_positions.Resize(pos + 1);
+        data.traced_positions.Set(pos);
+      }
+      data.trace_op_names.resize(0);
+      for(size_t idx = 0; idx < GetInstLib().GetSize(); ++idx){
+        data.trace_op_names.push_back(GetInstLib().GetName(idx));
+      }
+    }
+
     /// Write the instructions in the instruction set (in order) to the specified file
     void WriteInstructionSetFile(const emp::String& filename){
       std::cout << "Writing instruction set to file: " << filename << std::endl;
@@ -434,29 +775,67 @@ namespace mabe {
       return file.GetAllLines();
     }
 
+    using inst_table_t = ActionTable<void, VirtualCPUOrg&, const inst_t&>;
+
+    /// Resolve an action into a single function to run for its instruction.  The table holds
+    /// typed functions, so executing the instruction skips the AnyFunction dispatch; a lone
+    /// function is called directly.
+    static inst_func_t ResolveInstFunc(const inst_table_t& table, size_t action_id){
+      std::span<const inst_func_t> funcs = table.GetFuncs(action_id);
+      if(funcs.size() == 1) return funcs[0];
+      return [funcs=emp::vector<inst_func_t>(funcs.begin(), funcs.end())]
+        (VirtualCPUOrg& org, const inst_t& inst){
+          for(const inst_func_t& func : funcs) func(org, inst);
+        };
+    }
+
+    /// Can the compiled instruction set stand in for the instructions named in 'name_vec'?
+    /// Every instruction must come from a single module function, as the generator assumes.
+    bool UseCompiledInstSet(const inst_table_t& table, const emp::vector<emp::String>& name_vec){
+      const CompiledInstSet& compiled = GetCompiledInstSet();
+      if(!compiled.dispatch) return false;
+      bool usable = compiled.names == name_vec;
+      for(size_t inst_idx = 0; usable && inst_idx < name_vec.size(); ++inst_idx){
+        const size_t action_id = table.GetID(name_vec[inst_idx]);
+        usable = action_id != emp::MAX_SIZE_T && table.GetFuncs(action_id).size() == 1;
+      }
+      usable = usable && compiled.bind(GetManager().GetControl());
+      if(!usable){
+        emp::notify::Warning("Compiled instruction set does not match '",
+                             SharedData().inst_set_input_filename,
+                             "' or its modules; using the standard instruction functions.");
+      }
+      return usable;
+    }
+
     /// Load external instructions that were added via the configuration file
     void SetupInstLib(){
       inst_lib_t& inst_lib = GetInstLib();
+      emp::BitVector& non_speculative_inst_vec = SharedData().non_speculative_insts;
+      emp::BitVector& barrier_inst_vec = SharedData().barrier_insts;
       if(SharedData().use_speculative_execution) non_speculative_inst_vec.Clear();
+      barrier_inst_vec.Clear();
       // All instructions are stored in the populations ActionMap
       ActionMap& action_map = GetManager().GetControl().GetActionMap(0);
-      std::unordered_map<emp::String, mabe::Action>& typed_action_map =
-        action_map.GetFuncs<void, VirtualCPUOrg&, const inst_t&>();
+      const inst_table_t action_table(action_map);
       // Print the number of instructions found and each of their names
-      std::cout << "Found " << typed_action_map.size() << " external functions!";
-      for(auto it = typed_action_map.begin(); it != typed_action_map.end(); it++){
-        std::cout << " " << it->first;
+      std::cout << "Found " << action_table.GetSize() << " external functions!";
+      for(size_t action_id = 0; action_id < action_table.GetSize(); ++action_id){
+        std::cout << " " << action_table.GetName(action_id);
       }
       std::cout << std::endl;
 
       const emp::vector<emp::String> name_vec = LoadInstSetFromFile();
+      const bool use_compiled = UseCompiledInstSet(action_table, name_vec);
       for(size_t inst_idx = 0; inst_idx < name_vec.size(); ++inst_idx){
         const emp::String& name = name_vec[inst_idx];
-        if(typed_action_map.find(name) == typed_action_map.end()){
+        const size_t action_id = action_table.GetID(name);
+        if(action_id == emp::MAX_SIZE_T){
           emp_error("Instruction '" + name + "' not found. Make sure the VirtualCPUOrg"
              " module comes after all instruction modules in the config file"); 
+          continue;
         }
-        mabe::Action& action = typed_action_map[name];
+        mabe::Action& action = action_table.GetAction(action_id);
         unsigned char c = 'a' + inst_idx;
         if(inst_idx > 25){
           c = 'A' + inst_idx - 26;
@@ -481,6 +860,16 @@ namespace mabe {
             non_speculative_inst_vec[inst_idx] = false;
           }
         }
+        // Instructions that affect the population or draw shared random numbers must wait for
+        // the serial part of a parallel update, unless they defer those effects to a sync point
+        // (is_parallel_safe; e.g., queued births).
+        if(barrier_inst_vec.GetSize() < static_cast<size_t>(inst_idx + 1)){
+          barrier_inst_vec.Resize(inst_idx + 1);
+        }
+        barrier_inst_vec[inst_idx] =
+          ((action.data.HasName("is_non_speculative") && action.data.Get<bool>("is_non_speculative"))
+           || (action.data.HasName("is_non_parallel") && action.data.Get<bool>("is_non_parallel")))
+          && !(action.data.HasName("is_parallel_safe") && action.data.Get<bool>("is_parallel_safe"));
         // Grab description
         const emp::String desc = 
           (action.data.HasName("description") ? 
@@ -489,11 +878,8 @@ namespace mabe {
           (action.data.HasName("num_args") ?  action.data.Get<size_t>("num_args") : 0);
         inst_lib.AddInst(
             action.name,                       // Instruction name
-            [&action](VirtualCPUOrg& org, const inst_t& inst){
-              for(size_t func_idx = 0; func_idx < action.function_vec.size(); ++func_idx){
-                action.function_vec[func_idx].Call<void, VirtualCPUOrg&, const inst_t&>(org, inst);
-              }
-            },                                 // Function that will be executed
+            use_compiled ? inst_func_t(GetCompiledInstSet().dispatch)  // Function that will
+              : ResolveInstFunc(action_table, action_id),             // be executed
             num_args,                          // Number of arguments
             desc,                              // Description 
             emp::ScopeType::NONE,              // No scope type, but must provide
@@ -503,6 +889,22 @@ namespace mabe {
       }
     }
 
+    /// Run up to 'budget' instructions in a tight loop (no tracing), stopping before
+    /// the second instruction that is not safe to speculate; one such instruction may run
+    /// first, standing in for the current step.  Returns the number of speculative
+    /// instructions executed, to be counted off by later steps.
+    size_t ProcessUntilSideEffect(size_t budget){
+      size_t num_banked = 0;
+      for(size_t offset = 0; offset < budget; ++offset){
+        if(SharedData().non_speculative_insts[genome_working[inst_ptr].id]){
+          if(num_banked > 0) break;
+        }
+        else ++num_banked;
+        Process(1, false);
+      }
+      return num_banked;
+    }
+
     /// Speculatively execute instructions up until an instruction modifies the outside world
     /// If instructions have already been speculatively executed, simply reduce their counter
     void Process_Speculative() {
@@ -512,50 +914,118 @@ namespace mabe {
       else{
         const size_t max_insts = (SharedData().max_speculative_insts == -1)
             ? GetGenomeSize() : SharedData().max_speculative_insts;
-        for(size_t offset = 0; offset < max_insts; ++offset){
-          const size_t inst_id = genome_working[inst_ptr].id;
-          if(!non_speculative_inst_vec[inst_id]){
-            if(SharedData().verbose){
-              std::cout << "[" << SharedData().position_trait(*this).Pos() 
-                << "]" << std::endl;
-            }
-            Process(1, SharedData().verbose);
-            ++insts_speculatively_executed; 
-          }
-          else{
-            if(insts_speculatively_executed == 0){
-              if(SharedData().verbose){
-                std::cout << "[" << SharedData().position_trait(*this).Pos() 
-                  << "]" << std::endl;
-              }
-              Process(1, SharedData().verbose);
-            }
-            else break;
-            
-          }
+        insts_speculatively_executed = ProcessUntilSideEffect(max_insts);
+      }
+    }
+
+    /// Is tracing on for this organism type?  Compiled out entirely with MABE_NO_TRACE.
+    bool IsTracing() const {
+#ifdef MABE_NO_TRACE
+      return false;
+#else
+      return SharedData().tracing;
+#endif
+    }
+
+    /// Trace (print and/or record) the instruction about to be executed.
+    void TraceInst(){
+      ManagerData & data = SharedData();
+      const size_t pos = GetPopPos();
+      if(!data.IsTracedPos(pos)) return;
+      if(data.verbose) std::cout << "[" << pos << "]" << std::endl;
+      if(data.trace.IsActive()){
+        data.trace.Add(TraceRecord{GetManager().GetControl().GetUpdate(), (uint32_t) pos,
+          (uint32_t) inst_ptr, (uint32_t) genome_working[inst_ptr].idx,
+          (uint32_t) num_insts_executed});
+      }
+    }
+
+    /// Count the instruction about to be executed, by population and in this organism's total.
+    void CountInst(){
+      ManagerData & data = SharedData();
+      const size_t pop_id = GetPopPtr() ? (size_t) GetPopPtr()->GetID() : 0;
+      data.inst_counts.Add(pop_id, genome_working[inst_ptr].idx);
+      ++data.insts_trait(*this);
+    }
+
+    /// Count and/or trace the instruction about to be executed.
+    void WatchInst(){
+      if(SharedData().count_insts) CountInst();
+      if(IsTracing()) TraceInst();
+    }
+
+    /// Same as ProcessStep(), but one instruction at a time so each can be counted or traced.
+    void ProcessStep_Traced() {
+      const bool verbose = SharedData().verbose;
+      if(!SharedData().use_speculative_execution){
+        WatchInst();
+        Process(1, verbose);
+        return;
+      }
+      if(insts_speculatively_executed > 0){
+        --insts_speculatively_executed;
+        return;
+      }
+      const size_t max_insts = (SharedData().max_speculative_insts == -1)
+          ? GetGenomeSize() : SharedData().max_speculative_insts;
+      for(size_t offset = 0; offset < max_insts; ++offset){
+        if(!SharedData().non_speculative_insts[genome_working[inst_ptr].id]){
+          WatchInst();
+          Process(1, verbose);
+          ++insts_speculatively_executed;
         }
+        else if(insts_speculatively_executed == 0){
+          WatchInst();
+          Process(1, verbose);
+        }
+        else break;
       }
     }
 
     /// Process the next instruction, or use speculative execution if possible
     bool ProcessStep() override { 
       if(GetWorkingGenomeSize() == 0) return false;
-      if(SharedData().use_speculative_execution){
-        Process_Speculative();
+      if(SharedData().watch_steps) ProcessStep_Traced();
+      else if(SharedData().use_speculative_execution) Process_Speculative();
+      else Process(1, false);
+      return true;
+    }
+
+    /// The next step is local if it only runs (or counts off) instructions that touch this
+    /// organism alone.  Speculative runs may execute many instructions at once, so only the
+    /// already-executed ones are treated as local.
+    bool IsNextStepLocal() const override {
+      if(GetWorkingGenomeSize() == 0) return true;
+      if(IsTracing()) return false;
+      if(SharedData().use_speculative_execution) return insts_speculatively_executed > 0;
+      const size_t inst_id = genome_working[inst_ptr].id;
+      const emp::BitVector& barrier_insts = SharedData().barrier_insts;
+      return inst_id < barrier_insts.GetSize() && !barrier_insts[inst_id];
+    }
+
+    /// Run a batch of local steps, calling this type's step functions directly.
+    size_t ProcessLocalSteps(size_t max_steps, size_t & num_processed) override {
+      // Already-executed speculative instructions can all be counted off at once.
+      if(SharedData().use_speculative_execution && GetWorkingGenomeSize() > 0
+         && !IsTracing()){
+        const size_t num_used = std::min(max_steps, insts_speculatively_executed);
+        insts_speculatively_executed -= num_used;
+        num_processed += num_used;
+        return num_used;
       }
-      else{
-        if(SharedData().verbose){
-          std::cout << "[" << SharedData().position_trait(*this).Pos()
-            << "]" << std::endl;;
-        }
-        Process(1, SharedData().verbose);
+      size_t num_used = 0;
+      for (; num_used < max_steps && VirtualCPUOrg::IsNextStepLocal(); ++num_used) {
+        if (VirtualCPUOrg::ProcessStep()) ++num_processed;
       }
-      return true;
+      return num_used;
     }
 
     /// Initialize the mutational distribution variables to match the genome size (either 
     /// current size or projected sizes)
     void SetupMutationDistribution() {
+      SharedData().point_mut_gaps.Setup(SharedData().point_mut_prob);
+      SharedData().insertion_mut_gaps.Setup(SharedData().insertion_mut_prob);
+      SharedData().deletion_mut_gaps.Setup(SharedData().deletion_mut_prob);
       if (GetGenomeSize() != 0) { // If we have a genome size, use it!
         SharedData().point_mut_dist.Setup(SharedData().point_mut_prob, GetGenomeSize());
         SharedData().insertion_mut_dist.Setup(SharedData().insertion_mut_prob, 
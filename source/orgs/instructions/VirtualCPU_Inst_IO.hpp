@@ -28,9 +28,9 @@ namespace mabe {
     using this_t = VirtualCPU_Inst_IO;
   private:
     int pop_id = 0; ///< ID of the population which will receive these instructions
-    std::string input_name = "input";         ///< Name of trait that stores inputs
-    std::string output_name = "output";       ///< Name of trait that stores outputs
-    std::string input_idx_name = "input_idx"; ///< Number of trait that stores the index of the current input
+    OwnedTrait<emp::vector<data_t>> input_trait{this, "input", "VirtualCPUOrg inputs"};
+    SharedTrait<emp::vector<data_t>> output_trait{this, "output", "VirtualCPUOrg outputs"};
+    OwnedTrait<size_t> input_idx_trait{this, "input_idx", "Index of next input"};
     size_t num_inputs = 3; ///< Number of random inputs generated for each organism (they are reused if more inputs are requested)
     emp::vector<data_t> stamp_vec; /**< Vector of "stamps" that ensure that logic tasks on 
                                           inputs give unique outputs */
@@ -39,14 +39,23 @@ namespace mabe {
     VirtualCPU_Inst_IO(mabe::MABE & control,
                     const std::string & name="VirtualCPU_Inst_IO",
                     const std::string & desc="IO instructions for VirtualCPUOrg population")
-      : Module(control, name, desc){ ; }
+      : Module(control, name, desc)
+    {
+      // Keep the original config names for the trait names.
+      input_trait.SetConfigName("input_name");
+      input_trait.SetConfigDesc("Name of variable to store inputs");
+      output_trait.SetConfigName("output_name");
+      output_trait.SetConfigDesc("Name of variable to store outputs");
+      input_idx_trait.SetConfigName("input_idx_name");
+      input_idx_trait.SetConfigDesc("Index of next input to be loaded");
+    }
 
     ~VirtualCPU_Inst_IO() {;}
 
     void Inst_IO(org_t& hw, const org_t::inst_t& inst){
-        emp::vector<data_t>& input_vec = hw.GetTrait<emp::vector<data_t>>(input_name);
-        emp::vector<data_t>& output_vec = hw.GetTrait<emp::vector<data_t>>(output_name);
-        size_t& input_idx = hw.GetTrait<size_t>(input_idx_name);
+        emp::vector<data_t>& input_vec = input_trait(hw);
+        emp::vector<data_t>& output_vec = output_trait(hw);
+        size_t& input_idx = input_idx_trait(hw);
         // Ensure inputs have been generated
         if(input_vec.size() < num_inputs){
           for(size_t idx = input_vec.size(); idx < num_inputs; idx++){
@@ -68,16 +77,10 @@ namespace mabe {
     /// Set up variables for configuration file 
     void SetupConfig() override {
        LinkPop(pop_id, "target_pop", "Population(s) to manage.");
-       LinkVar(input_name, "input_name", "Name of variable to store inputs");
-       LinkVar(output_name, "output_name", "Name of variable to store outputs");
-       LinkVar(input_idx_name, "input_idx_name", "Index of next input to be loaded");
     }
 
-    /// Create organism traits and create IO instruction 
+    /// Create IO instruction (traits are added automatically)
     void SetupModule() override {
-      AddOwnedTrait<emp::vector<data_t>>(input_name, "VirtualCPUOrg inputs", {} );
-      AddOwnedTrait<size_t>(input_idx_name, "Index of next input", 0 );
-      AddSharedTrait<emp::vector<data_t>>(output_name, "VirtualCPUOrg outputs", {} );
       SetupStamps();
       SetupFuncs();
     }
@@ -94,8 +97,10 @@ namespace mabe {
       ActionMap& action_map = control.GetActionMap(pop_id);
       const inst_func_t func_input = 
           [this](org_t& hw, const org_t::inst_t& inst){ Inst_IO(hw, inst); };
-      action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
+      Action& action = action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
           "IO", func_input);
+      // Inputs are drawn from the main random number generator, so IO runs serially.
+      action.data.AddVar<bool>("is_non_parallel", true);
     }
 
   };
@@ -6,6 +6,8 @@
  *  @file  VirtualCPU_Inst_Label.hpp
  *  @brief Provides label declaration and search instructions to a population of VirtualCPUOrgs.
  * 
+ *  Searches go through VirtualCPUOrg::CachedSearch(), so with the organism type's
+ *  search_cache_size set, repeated searches in the same genotype are looked up.
  */
 
 #ifndef MABE_VIRTUAL_CPU_INST_LABEL_H
@@ -36,22 +38,28 @@ namespace mabe {
 
     void Inst_Label(org_t& /*hw*/, const org_t::inst_t& /*inst*/){ ; }
     void Inst_SearchLabelDirectS(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindLabel(false, false); 
+      hw.flow_head = hw.CachedSearch(org_t::SEARCH_LABEL_S,
+          [&hw](){ return hw.FindLabel(false, false); });
     }
     void Inst_SearchLabelDirectF(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindLabel(true, false); 
+      hw.flow_head = hw.CachedSearch(org_t::SEARCH_LABEL_F,
+          [&hw](){ return hw.FindLabel(true, false); });
     }
     void Inst_SearchLabelDirectB(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindLabel(true, true); 
+      hw.flow_head = hw.CachedSearch(org_t::SEARCH_LABEL_B,
+          [&hw](){ return hw.FindLabel(true, true); });
     }
     void Inst_SearchSeqDirectS(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindNopSequence(false, false); 
+      hw.flow_head = hw.CachedSearch(org_t::SEARCH_SEQ_S,
+          [&hw](){ return hw.FindNopSequence(false, false); });
     }
     void Inst_SearchSeqDirectF(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindNopSequence(true, false); 
+      hw.flow_head = hw.CachedSearch(org_t::SEARCH_SEQ_F,
+          [&hw](){ return hw.FindNopSequence(true, false); });
     }
     void Inst_SearchSeqDirectB(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindNopSequence(true, true); 
+      hw.flow_head = hw.CachedSearch(org_t::SEARCH_SEQ_B,
+          [&hw](){ return hw.FindNopSequence(true, true); });
     }
 
     /// Set up variables for configuration file
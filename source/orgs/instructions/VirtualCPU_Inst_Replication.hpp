@@ -1,11 +1,19 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021-2022.
+ *  @date 2021-2024.
  *
  *  @file  VirtualCPU_Inst_Replication.hpp
  *  @brief Provides replication instructions to a population of VirtualCPUOrgs.
  *
+ *  With queue_births on, HDivide and Repro do not give birth directly.  Instead they push the
+ *  parent's position and offspring genome onto a lock-free BirthQueue, so they can run on
+ *  worker threads (e.g., with SchedulerProbabilistic's parallel_steps).  The queue is drained
+ *  at each MABE sync point (after a parallel pass, and at the end of every update), or when
+ *  DRAIN_BIRTHS() is called.  Births are placed in order of parent position, and repeated
+ *  births from one parent stay in the order they were queued, so results do not depend on
+ *  the number of threads.  A queued birth whose parent died before the drain is dropped.
+ *
  *  TODO: 
  *      - HCopy (and other instructions) should be able to add mutations to this genome
  * 
@@ -17,6 +25,7 @@
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
 #include "../VirtualCPUOrg.hpp"
+#include "../../tools/BirthQueue.hpp"
 
 namespace mabe {
 
@@ -28,9 +37,10 @@ namespace mabe {
     using this_t = VirtualCPU_Inst_Replication;
   private:
     int pop_id = 0; ///< ID of the population which will receive these instructions
-    std::string org_pos_trait = "org_pos"; ///< Name of the trait storing organism's position
-    std::string offspring_genome_trait = "offspring_genome"; ///< Name of the trait storing the genome of the offspring organism 
-    std::string reset_self_trait = "reset_self"; ///< Name of the trait storing if org needs reset 
+    PositionTrait org_pos_trait{this, "org_pos", "Organism's position"};
+    RequiredTrait<org_t::genome_t> offspring_genome_trait{this, "offspring_genome",
+      "Genome of the offspring organism"};
+    RequiredTrait<bool> reset_self_trait{this, "reset_self", "Does the organism need a reset?"};
     double req_frac_inst_executed = 0.5;  /**< Config option indicating the fraction of 
                                             an organism's genome that must have been executed 
                                             for org to reproduce **/
@@ -40,18 +50,46 @@ namespace mabe {
     double req_frac_inst_copied = 0.5;  /**< Config option indicating the fraction of 
                                              an organism's genome that must have been copied 
                                              for org to reproduce **/
+    bool queue_births = false;  ///< Queue births for the next sync point instead of placing them?
+
+    struct QueuedBirth {
+      OrgPosition parent_pos;
+      const Organism * parent;        ///< To detect parents that died before the drain.
+      org_t::genome_t genome;
+    };
+    BirthQueue<QueuedBirth> birth_queue;
+    size_t num_dropped = 0;           ///< Queued births whose parent died before placement.
+
+    /// Give birth to an offspring of hw, whose genome is in its offspring genome trait.
+    void Reproduce(org_t & hw) {
+      const OrgPosition org_pos = org_pos_trait(hw);
+      if (!queue_births) {
+        control.Replicate(org_pos, *org_pos.PopPtr());
+        return;
+      }
+      const uint64_t order = ((uint64_t) org_pos.PopID() << 40) | org_pos.Pos();
+      birth_queue.Push(order, QueuedBirth{org_pos, &hw, offspring_genome_trait(hw)});
+    }
 
   public:
     VirtualCPU_Inst_Replication(mabe::MABE & control,
                     const std::string & name="VirtualCPU_Inst_Replication",
                     const std::string & desc="Replication instructions for VirtualCPUOrg population")
-      : Module(control, name, desc) {;}
+      : Module(control, name, desc)
+    {
+      // Keep the original config names for the trait names.
+      org_pos_trait.SetConfigName("pos_trait");
+      org_pos_trait.SetConfigDesc("Unused; organism positions are now computed when needed");
+      offspring_genome_trait.SetConfigDesc("Name of trait that holds the offspring organism's genome");
+      reset_self_trait.SetConfigDesc("Name of trait that determines if the organism needs reset");
+    }
     ~VirtualCPU_Inst_Replication() { }
 
     void Inst_HAlloc(org_t& hw, const org_t::inst_t& /*inst*/){
       // Only expand once
       if(hw.genome_working.size() == hw.genome.size()){
         hw.genome_working.resize(hw.genome.size() * 2, hw.GetDefaultInst());
+        hw.MarkWorkingGenomeResized();
         hw.regs[0] = hw.genome.size();
       }
     }
@@ -72,10 +110,8 @@ namespace mabe {
         if(hw.GetGenomeSize() == hw.GetWorkingGenomeSize()){
           return;
         }
-        OrgPosition& org_pos = hw.GetTrait<OrgPosition>(org_pos_trait);
         // Store the soon-to-be offspring's genome
-        org_t::genome_t& offspring_genome = hw.GetTrait<org_t::genome_t>(
-            offspring_genome_trait);
+        org_t::genome_t& offspring_genome = offspring_genome_trait(hw);
         offspring_genome.resize(hw.genome_working.size() - hw.read_head,
             hw.GetDefaultInst());
         std::copy(
@@ -83,8 +119,9 @@ namespace mabe {
             hw.genome_working.end(),
             offspring_genome.begin());
         hw.genome_working.resize(hw.read_head, hw.GetDefaultInst());
+        hw.MarkWorkingGenomeResized();
         // Replicate
-        control.Replicate(org_pos, *org_pos.PopPtr());
+        Reproduce(hw);
         // Reset the parent
         hw.Reset();
         // Set to end so completion of this inst moves it 0 
@@ -93,6 +130,7 @@ namespace mabe {
     }
     void Inst_HCopy(org_t& hw, const org_t::inst_t& /*inst*/){
       hw.genome_working[hw.write_head] = hw.genome_working[hw.read_head];
+      hw.MarkWorkingGenomeEdited();
       hw.copied_inst_id_vec.push_back(hw.genome_working[hw.write_head].id);
       hw.genome_working[hw.read_head].has_been_copied = true;
       hw.AdvanceRH();
@@ -100,7 +138,9 @@ namespace mabe {
       // TODO: Mutation
     }
     void Inst_HSearch(org_t& hw, const org_t::inst_t& inst){
-      size_t res = hw.FindNopSequence(hw.GetComplementNopSequence(inst.nop_vec), hw.inst_ptr);
+      size_t res = hw.CachedSearch(org_t::SEARCH_H, [&hw, &inst](){
+        return hw.FindNopSequence(hw.GetComplementNopSequence(inst.nop_vec), hw.inst_ptr);
+      });
       if(inst.nop_vec.size() == 0 || res == hw.inst_ptr){
         hw.regs[1] = 0;
         hw.regs[2] = 0;
@@ -120,17 +160,15 @@ namespace mabe {
             && hw.num_insts_executed >= (size_t)req_count_inst_executed)
           || (req_count_inst_executed < 0 
             && hw.num_insts_executed >= req_frac_inst_executed * hw.genome.size())){
-        OrgPosition& org_pos = hw.GetTrait<OrgPosition>(org_pos_trait);
         // Store the soon-to-be offspring's genome
-        org_t::genome_t& offspring_genome = hw.GetTrait<org_t::genome_t>(
-            offspring_genome_trait);
+        org_t::genome_t& offspring_genome = offspring_genome_trait(hw);
         offspring_genome.resize(hw.genome.size(), hw.GetDefaultInst());
         std::copy(
             hw.genome.begin(),
             hw.genome.end(),
             offspring_genome.begin());
         // Replicate 
-        control.Replicate(org_pos, *org_pos.PopPtr());
+        Reproduce(hw);
         // Reset the parent
         hw.Reset();
         // Set to end so completion of this inst moves it 0 
@@ -138,6 +176,43 @@ namespace mabe {
       }
     }
 
+    /// Place all queued births, grouped by population and in order of parent position;
+    /// returns the number placed.
+    size_t DrainBirths() {
+      emp::vector<QueuedBirth> births;
+      birth_queue.Drain([this, &births](QueuedBirth & birth){
+        if (!birth.parent_pos.IsOccupied() || birth.parent_pos.OrgPtr().Raw() != birth.parent) {
+          ++num_dropped;
+          return;
+        }
+        births.push_back(std::move(birth));
+      });
+
+      emp::vector<OrgPosition> parents;
+      for (size_t start = 0, end = 0; start < births.size(); start = end) {
+        const size_t pop_id = births[start].parent_pos.PopID();
+        parents.resize(0);
+        for (end = start; end < births.size() && births[end].parent_pos.PopID() == pop_id; ++end) {
+          parents.push_back(births[end].parent_pos);
+        }
+        control.DoBirthsBuildFirst(parents, [this, &births, start](size_t i){
+          QueuedBirth & birth = births[start + i];
+          offspring_genome_trait(*birth.parent_pos) = std::move(birth.genome);
+        }, control.GetPopulation(pop_id));
+      }
+      return births.size();
+    }
+
+    /// Set up member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("DRAIN_BIRTHS",
+        [](VirtualCPU_Inst_Replication & mod) { return mod.DrainBirths(); },
+        "Place all queued births now; return the number placed.");
+      info.AddMemberFunction("NUM_DROPPED_BIRTHS",
+        [](VirtualCPU_Inst_Replication & mod) { return mod.num_dropped; },
+        "Number of queued births dropped because their parent died first.");
+    }
+
     /// Set up variables for configuration file
     void SetupConfig() override {
       LinkPop(pop_id, "target_pop", "Population(s) to manage.");
@@ -152,19 +227,15 @@ namespace mabe {
       LinkVar(req_frac_inst_copied, "req_frac_inst_copied", 
               "The organism must have copied at least this fraction of their genome to"
                 " reproduce via HDivide. Otherwise HDivide does nothing.");
-      LinkVar(org_pos_trait, "pos_trait", "Name of trait that holds organism's position");
-      LinkVar(offspring_genome_trait, "offspring_genome_trait", 
-          "Name of trait that holds the offspring organism's genome");
-      LinkVar(reset_self_trait, "reset_self_trait", 
-          "Name of trait that determines if the organism needs reset");
+      LinkVar(queue_births, "queue_births",
+              "Queue births and place them at the next sync point, so replication instructions"
+                " can run on worker threads? (changes timing of births)");
     }
 
-    /// When config is loaded, create traits and set up functions
+    /// When config is loaded, set up functions (traits are added automatically)
     void SetupModule() override {
-      AddRequiredTrait<OrgPosition>(org_pos_trait);
-      AddRequiredTrait<org_t::genome_t>(offspring_genome_trait);
-      AddRequiredTrait<bool>(reset_self_trait);
       SetupFuncs();
+      if (queue_births) control.AddSyncFun([this](){ DrainBirths(); });
     }
 
     /// Add the instruction specified by the config file
@@ -182,6 +253,7 @@ namespace mabe {
         Action& action = action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
             "HDivide", func_h_divide);
         action.data.AddVar<bool>("is_non_speculative", true);
+        action.data.AddVar<bool>("is_parallel_safe", queue_births);
       }
       { // Head copy 
         const inst_func_t func_h_copy = 
@@ -201,6 +273,7 @@ namespace mabe {
         Action& action = action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
             "Repro", func_repro);
         action.data.AddVar<bool>("is_non_speculative", true);
+        action.data.AddVar<bool>("is_parallel_safe", queue_births);
       }
     }
 
@@ -5,6 +5,10 @@
  *
  *  @file  AnnotatePlacement_Position.hpp
  *  @brief Stores organism's position as a trait on birth/inject
+ *
+ *  Modules that only need an organism's current position should read it with a PositionTrait
+ *  (or Organism::GetPosition()), which is computed on demand and never goes stale; this module
+ *  is for configurations that want the position stored as an ordinary trait.
  */
 
 #ifndef MABE_ANNOTATE_PLACEMENT_H
@@ -42,9 +46,14 @@ namespace mabe {
       AddSharedTrait<OrgPosition>(pos_trait, "Organism's position in the population", {});
     }
 
-    /// When an organism is placed (via birth or inject), store its position as a trait
-    void OnPlacement(OrgPosition pos) override {
-      if(target_collect.HasPopulation(*pos.PopPtr())){
+    /// When organisms are placed (via birth or inject), store their positions as a trait
+    void OnPlacementBatch(std::span<const OrgPosition> positions) override {
+      emp::Ptr<Population> last_pop = nullptr;   // Most recent population found in target.
+      for (OrgPosition pos : positions) {
+        if (pos.PopPtr() != last_pop) {
+          if (!target_collect.HasPopulation(*pos.PopPtr())) continue;
+          last_pop = pos.PopPtr();
+        }
         Organism& org = pos.PopPtr()->At(pos.Pos());
         org.SetTrait<OrgPosition>(pos_trait, pos);
       }
@@ -0,0 +1,192 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GridPlacement.hpp
+ *  @brief Gives populations a spatial structure: a grid, a torus, or an arbitrary graph.
+ *
+ *  Each managed population is resized to one cell per grid position (or graph node).  Births
+ *  are local: offspring replace a random neighbor of their parent (or, with birth_mode
+ *  "empty_neighbor", fill an empty neighboring cell when there is one).  Injected organisms
+ *  fill empty cells in order, and replace random organisms once the population is full.
+ *  FindNeighbor also returns a random neighbor, so other modules see the same structure.
+ *
+ *  Neighbors are looked up in a table built once during setup (see tools/Neighborhood.hpp);
+ *  graphs are loaded from a file with one "from to" edge per line ('#' starts a comment).
+ *
+ *  Setting tile_width and tile_height partitions a grid into colored tiles whose cells have
+ *  contiguous positions; tiles of the same color share no neighborhoods, so an update that
+ *  only touches cells and their neighbors can process all tiles of one color in parallel.
+ */
+
+#ifndef MABE_GRID_PLACEMENT_H
+#define MABE_GRID_PLACEMENT_H
+
+#include <sstream>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../tools/Neighborhood.hpp"
+
+#include "emp/io/File.hpp"
+
+namespace mabe {
+
+  /// Place births next to their parents on a grid, torus, or graph
+  class GridPlacement : public Module {
+  private:
+    enum Topology { GRID=0, TORUS, GRAPH };
+    enum BirthMode { REPLACE_NEIGHBOR=0, EMPTY_NEIGHBOR };
+
+    Collection target_collect;     ///< Collection of populations to manage
+    int topology = TORUS;          ///< How are cells connected?
+    int neighborhood = Neighborhood::MOORE;  ///< Which cells are adjacent on a grid?
+    size_t width = 60;             ///< Grid columns.
+    size_t height = 60;            ///< Grid rows.
+    emp::String graph_file = "";   ///< Edge list for the graph topology.
+    int birth_mode = REPLACE_NEIGHBOR;
+    size_t tile_width = 0;         ///< Columns in each tile (0 = no tiles).
+    size_t tile_height = 0;        ///< Rows in each tile (0 = no tiles).
+
+    Neighborhood hood;             ///< Neighbor table shared by all managed populations.
+
+    /// Load a "from to" edge list and build the graph neighborhood from it.
+    bool LoadGraph() {
+      emp::File file(graph_file);
+      file.RemoveComments("#");
+      file.RemoveEmpty();
+      emp::vector<std::pair<size_t,size_t>> edges;
+      size_t num_nodes = 0;
+      for (size_t line_id = 0; line_id < file.GetNumLines(); ++line_id) {
+        std::stringstream ss(file[line_id]);
+        size_t from, to;
+        if (!(ss >> from >> to)) {
+          emp::notify::Error("Module '", GetName(), "' could not read edge on line ", line_id+1,
+                             " of graph file '", graph_file, "': '", file[line_id], "'.");
+          return false;
+        }
+        edges.emplace_back(from, to);
+        num_nodes = std::max(num_nodes, std::max(from, to) + 1);
+      }
+      if (num_nodes == 0) {
+        emp::notify::Error("Module '", GetName(), "' found no edges in graph file '", graph_file, "'.");
+        return false;
+      }
+      return hood.SetupGraph(num_nodes, edges);
+    }
+
+    /// Position for an offspring of the organism at ppos, in the managed population 'pop'.
+    OrgPosition PlaceLocalBirth(OrgPosition ppos, Population & pop) {
+      emp::Random & random = control.GetRandom();
+
+      // Offspring from outside of this population go to a random cell.
+      if (!ppos.IsInPop(pop)) return OrgPosition(pop, random.GetUInt(pop.GetSize()));
+
+      if (birth_mode == EMPTY_NEIGHBOR) {
+        std::span<const uint32_t> neighbors = hood.GetNeighbors(ppos.Pos());
+        size_t num_empty = 0;
+        for (uint32_t pos : neighbors) num_empty += pop.IsEmpty(pos);
+        if (num_empty) {
+          size_t choice = random.GetUInt(num_empty);
+          for (uint32_t pos : neighbors) {
+            if (pop.IsEmpty(pos) && choice-- == 0) return OrgPosition(pop, pos);
+          }
+        }
+      }
+
+      const size_t pos = hood.GetRandomNeighbor(ppos.Pos(), random);
+      if (pos == Neighborhood::NO_POS) return OrgPosition();  // Isolated cells cannot reproduce.
+      return OrgPosition(pop, pos);
+    }
+
+  public:
+    GridPlacement(mabe::MABE & control,
+                  const std::string & name="GridPlacement",
+                  const std::string & desc="Module to place offspring next to their parents on a grid or graph.")
+      : Module(control, name, desc), target_collect(control.GetPopulation(0))
+    {
+      SetPlacementMod(true);
+    }
+    ~GridPlacement() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("NUM_TILES",
+                             [](GridPlacement & mod) { return mod.hood.GetNumTiles(); },
+                             "Return the number of tiles the grid is divided into.");
+      info.AddMemberFunction("NUM_TILE_COLORS",
+                             [](GridPlacement & mod) { return mod.hood.GetNumTileColors(); },
+                             "Return the number of tile colors; same-colored tiles are never adjacent.");
+    }
+
+    const Neighborhood & GetNeighborhood() const { return hood; }
+
+    /// Set up variables for configuration file
+    void SetupConfig() override {
+      LinkCollection(target_collect, "target", "Population(s) to manage.");
+      LinkMenu(topology, "topology", "How are cells connected?",
+               GRID,  "grid",  "A width x height grid; edge cells have fewer neighbors.",
+               TORUS, "torus", "A width x height grid whose edges wrap around.",
+               GRAPH, "graph", "An arbitrary graph loaded from graph_file.");
+      LinkMenu(neighborhood, "neighborhood", "Which grid cells are neighbors?",
+               Neighborhood::MOORE,       "moore",       "The eight surrounding cells.",
+               Neighborhood::VON_NEUMANN, "von_neumann", "The four orthogonally adjacent cells.");
+      LinkVar(width, "width", "Number of columns in the grid.");
+      LinkVar(height, "height", "Number of rows in the grid.");
+      LinkVar(graph_file, "graph_file", "File with one 'from to' edge per line (graph topology).");
+      LinkMenu(birth_mode, "birth_mode", "Where do offspring go?",
+               REPLACE_NEIGHBOR, "neighbor",       "Replace a random neighbor of the parent.",
+               EMPTY_NEIGHBOR,   "empty_neighbor", "Use an empty neighbor if any; otherwise replace one.");
+      LinkVar(tile_width, "tile_width", "Grid columns per tile (0 = no tiles).");
+      LinkVar(tile_height, "tile_height", "Grid rows per tile (0 = no tiles).");
+    }
+
+    /// Build the neighbor table, then size and set placement functions for each population.
+    void SetupModule() override {
+      if (topology == GRAPH) {
+        if (tile_width || tile_height) {
+          emp::notify::Warning("Module '", GetName(), "' ignores tiles for graph topologies.");
+        }
+        if (!LoadGraph()) return;
+      }
+      else if (!hood.SetupGrid(width, height, topology == TORUS,
+                               (Neighborhood::Type) neighborhood, tile_width, tile_height)) {
+        return;
+      }
+      if (hood.GetNumCells() == 0) {
+        emp::notify::Error("Module '", GetName(), "' needs at least one cell.");
+        return;
+      }
+
+      for(size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id){
+        Population& pop = control.GetPopulation(pop_id);
+        if(!target_collect.HasPopulation(pop)) continue;
+
+        control.EmptyPop(pop, hood.GetNumCells());
+        pop.SetPlaceBirthFun(
+          [this, &pop](Organism & /*org*/, OrgPosition ppos) { return PlaceLocalBirth(ppos, pop); }
+        );
+        pop.SetPlaceInjectFun(
+          [this, &pop, next_pos=size_t(0)](Organism & /*org*/) mutable {
+            // Fill empty cells in order; once full, replace random organisms.
+            while (next_pos < pop.GetSize() && !pop.IsEmpty(next_pos)) ++next_pos;
+            if (next_pos < pop.GetSize()) return OrgPosition(pop, next_pos);
+            return OrgPosition(pop, control.GetRandom().GetUInt(pop.GetSize()));
+          }
+        );
+        pop.SetFindNeighborFun(
+          [this, &pop](OrgPosition pos) {
+            if (!pos.IsInPop(pop)) return OrgPosition();  // Wrong pop!  No neighbor.
+            const size_t neighbor = hood.GetRandomNeighbor(pos.Pos(), control.GetRandom());
+            if (neighbor == Neighborhood::NO_POS) return OrgPosition();
+            return OrgPosition(pop, neighbor);
+          }
+        );
+      }
+    }
+  };
+
+  MABE_REGISTER_MODULE(GridPlacement, "Place offspring next to their parents on a grid, torus, or graph.");
+}
+
+#endif
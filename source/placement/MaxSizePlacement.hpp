@@ -1,7 +1,7 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021-2022.
+ *  @date 2021-2024.
  *
  *  @file  MaxSizePlacement.h
  *  @brief Population grows up to a given size, then new births randomly replace existing orgs
@@ -12,6 +12,11 @@
  * 
  *  When a neighbor position is requested, a random position from the entire population is
  *  returned.
+ *
+ *  The placement functions installed on each population are bound to it during setup, and the
+ *  managed populations are recorded then, so a birth does not search the target collection.
+ *  With single_draw on, the replaced position is picked with one random draw that skips the
+ *  parent's position (this changes the random number sequence).
  */
 
 #ifndef MABE_MAX_SIZE_PLACEMENT_H
@@ -27,6 +32,15 @@ namespace mabe {
   private:
     Collection target_collect; ///< Collection of populations to manage
     size_t max_pop_size;       ///< Maximum population size, at which additional births replace existing organisms
+    bool single_draw = false;  ///< Skip the parent with one draw instead of redrawing?
+    emp::vector<emp::Ptr<Population>> target_pops; ///< Populations in target_collect.
+
+    /// Total number of positions in all managed populations.
+    size_t GetTargetSize() const {
+      size_t total = 0;
+      for (emp::Ptr<Population> pop_ptr : target_pops) total += pop_ptr->GetSize();
+      return total;
+    }
 
   public:
     MaxSizePlacement(mabe::MABE & control,
@@ -42,41 +56,67 @@ namespace mabe {
     void SetupConfig() override {
       LinkCollection(target_collect, "target", "Population(s) to manage.");
       LinkVar(max_pop_size, "max_pop_size", "Maximum size of the population.");
+      LinkVar(single_draw, "single_draw",
+              "Pick replaced orgs with a single draw that skips the parent? (changes random sequence)");
     }
 
     /// Set birth and inject functions for the specified populations
     void SetupModule() override {
+      target_pops.resize(0);
       for(size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id){
         Population& pop = control.GetPopulation(pop_id);
         if(target_collect.HasPopulation(pop)){
+          target_pops.push_back(&pop);
           pop.SetPlaceBirthFun( 
             [this, &pop](Organism & /*org*/, OrgPosition ppos) {
-              return PlaceBirth(ppos, pop);
+              return PlaceMonitoredBirth(ppos, pop);
             }
           );
           pop.SetPlaceInjectFun( 
             [this, &pop](Organism & /*org*/){
-              return PlaceInject(pop);
+              return PlaceMonitoredInject(pop);
             }
           );
         }
       }
     }
 
+    /// Place a birth in a monitored population. Method depends on current population size
+    OrgPosition PlaceMonitoredBirth(OrgPosition ppos, Population & target_pop) {
+      // If population not full, add new position
+      if(GetTargetSize() < max_pop_size) return control.PushEmpty(target_pop);
+
+      // If population full, return a random org's position (other than the parent's)
+      emp::Random & random = control.GetRandom();
+      const size_t pop_size = target_pop.GetSize();
+      const bool parent_here = ppos.IsInPop(target_pop);
+      if (pop_size <= (size_t) parent_here) return OrgPosition();  // No org to replace.
+
+      if (single_draw && parent_here) {
+        size_t new_pos = random.GetUInt(pop_size - 1);
+        if (new_pos >= ppos.Pos()) ++new_pos;  // Skip over the parent.
+        return OrgPosition(target_pop, new_pos);
+      }
+
+      OrgPosition new_pos = OrgPosition(target_pop, random.GetUInt(pop_size));
+      while(new_pos == ppos){ // Ensure we don't overwrite parent's position
+        new_pos = OrgPosition(target_pop, random.GetUInt(pop_size));
+      }
+      return new_pos;
+    }
+
+    /// Inject into a monitored population. Method depends on current population size
+    OrgPosition PlaceMonitoredInject(Population & target_pop) {
+      // If population not full, add new position
+      if(GetTargetSize() < max_pop_size) return control.PushEmpty(target_pop);
+      // If population full, return a random org's position
+      return OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
+    }
+
     /// Place a birth. Method depends on current population size
     OrgPosition PlaceBirth(OrgPosition ppos, Population & target_pop) {
-      if (target_collect.HasPopulation(target_pop)) { // If population is monitored...
-        // If population not full, add new position
-        if(target_collect.GetSize() < max_pop_size) return control.PushEmpty(target_pop);
-        else{ // If population full, return a random org's position
-          OrgPosition new_pos = 
-              OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-          while(new_pos == ppos){ // Ensure we don't overwrite parent's position
-            new_pos = OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-          }
-          return new_pos;
-        }
-      }
+      // If population is monitored...
+      if (target_collect.HasPopulation(target_pop)) return PlaceMonitoredBirth(ppos, target_pop);
 
       // Otherwise, don't find a legal place!
       return OrgPosition();      
@@ -84,13 +124,9 @@ namespace mabe {
 
     /// Manually inject an organism. Method depends on current population size
     OrgPosition PlaceInject(Population & target_pop) {
-      if (target_collect.HasPopulation(target_pop)) { // If population is monitored...
-        // If population not full, add new position
-        if(target_collect.GetSize() < max_pop_size) return control.PushEmpty(target_pop);
-        else{ // If population full, return a random org's position
-          return OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-        }
-      }
+      // If population is monitored...
+      if (target_collect.HasPopulation(target_pop)) return PlaceMonitoredInject(target_pop);
+
       // Otherwise, don't find a legal place!
       return OrgPosition();      
     }
@@ -0,0 +1,372 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  MigrateIslands.hpp
+ *  @brief Periodically moves organisms between a set of island populations.
+ *
+ *  Each island is a population with its own eval/select pipeline; this module links them by
+ *  migration.  Every 'interval' updates (or whenever MIGRATE is called from the script), 'count'
+ *  living organisms are chosen from each island and moved to the next island in a cycle.  With
+ *  the "ring" topology the cycle follows population order (pop ids); with "random"
+ *  a new cycle is drawn at each migration.  Migrants are rotated with SwapOrgs(), so island
+ *  sizes never change and no organisms are cloned or killed.
+ *
+ *  With "torus", islands are laid out in rows of 'torus_width'; migrations alternate between
+ *  moving migrants one island along each row and one island down each column.
+ *
+ *  Migrants are drawn with a random stream keyed on the update and the island's population id,
+ *  so the choice for one island does not depend on how many random values other modules used.
+ *
+ *  Islands in separate MABE processes (e.g., the array tasks of a batch) can exchange migrants
+ *  through a shared directory: EXPORT writes copies of 'count' random organisms (their genomes
+ *  plus the traits listed in 'migrant_traits') to a compact binary file, and IMPORT loads such a
+ *  file over random residents of a population.  The file is written under a temporary name and
+ *  renamed when complete; IMPORT returns immediately if no file is waiting, so a process never
+ *  blocks on a slow neighbor.  A file that IMPORT cannot use is reported once and moved aside
+ *  (with ".bad" appended to its name).
+ *
+ *  DEVELOPER NOTES:
+ *  - Islands still advance on the main thread (signals, run stats, and the main random number
+ *    generator are shared by all populations); evaluation within an island can already be
+ *    spread across threads via the thread pool.
+ *  - Migrant files use the same encoding as checkpoints, so they are host-endian.
+ */
+
+#ifndef MABE_MIGRATE_ISLANDS_H
+#define MABE_MIGRATE_ISLANDS_H
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../tools/Checkpoint.hpp"
+
+#include "emp/math/random_utils.hpp"
+
+namespace mabe {
+
+  class MigrateIslands : public Module {
+  private:
+    static constexpr size_t MIGRATE_SALT = 0x15a4d;  ///< Random-stream key for picking migrants.
+    static constexpr size_t IMPORT_SALT = 0x1a907;   ///< Random-stream key for picking residents.
+    static constexpr const char * MIGRANT_MAGIC = "MABE-MIGRANTS-1";
+
+    enum Topology { RING=0, RANDOM, TORUS };
+
+    Collection islands;       ///< Populations that exchange migrants.
+    size_t interval = 0;      ///< Updates between migrations (0 = only when MIGRATE is called).
+    size_t count = 1;         ///< Number of organisms to move out of each island per migration.
+    int topology = RING;      ///< How are islands connected?
+    size_t torus_width = 0;   ///< Islands per row for the torus topology.
+    emp::String migrant_traits = "";  ///< Traits to send along with exported migrants.
+
+    size_t num_migrations = 0;        ///< Migrations so far (torus alternates directions).
+
+  public:
+    MigrateIslands(mabe::MABE & control,
+                   const std::string & name="MigrateIslands",
+                   const std::string & desc="Module to move organisms between island populations.")
+      : Module(control, name, desc)
+    {
+    }
+    ~MigrateIslands() { }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction(
+        "MIGRATE",
+        [](MigrateIslands & mod) { return mod.Migrate(); },
+        "Move organisms between islands now; returns the number of organisms moved."
+      );
+      info.AddMemberFunction(
+        "EXPORT",
+        [](MigrateIslands & mod, Population & pop, const emp::String & filename) {
+          return mod.ExportMigrants(pop, filename);
+        },
+        "Write copies of 'count' random organisms from a population to a migrant file."
+      );
+      info.AddMemberFunction(
+        "IMPORT",
+        [](MigrateIslands & mod, Population & pop, const emp::String & filename) {
+          return mod.ImportMigrants(pop, filename);
+        },
+        "Load a waiting migrant file over random residents; returns the number imported."
+      );
+    }
+
+    void SetupConfig() override {
+      LinkCollection(islands, "islands", "Populations to treat as islands.");
+      LinkVar(interval, "interval", "Updates between migrations (0 = only on MIGRATE).");
+      LinkVar(count, "count", "Number of organisms to move out of each island per migration.");
+      LinkMenu(topology, "topology", "How are islands connected?",
+               RING,   "ring",   "Each island sends migrants to the next one (by population id).",
+               RANDOM, "random", "Draw a new random cycle of islands at each migration.",
+               TORUS,  "torus",  "Islands form a grid; alternate moving along rows and columns."
+      );
+      LinkVar(torus_width, "torus_width", "Islands per row for the torus topology.");
+      LinkVar(migrant_traits, "migrant_traits",
+              "Comma-separated traits to send with exported migrants (empty = all savable traits).");
+    }
+
+    void SetupModule() override {
+      if (topology == TORUS && (torus_width == 0 || GetIslands().size() % torus_width != 0)) {
+        emp::notify::Error("Module '", GetName(), "' needs a torus_width that evenly divides the ",
+                           GetIslands().size(), " islands.");
+      }
+    }
+
+    void OnUpdate(size_t update) override {
+      if (interval && update % interval == 0) Migrate();
+    }
+
+    /// Collect the populations in 'islands', in population order.
+    emp::vector<emp::Ptr<Population>> GetIslands() {
+      emp::vector<emp::Ptr<Population>> out;
+      for (size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id) {
+        Population & pop = control.GetPopulation(pop_id);
+        if (islands.HasPopulation(pop)) out.push_back(&pop);
+      }
+      return out;
+    }
+
+    /// Determine the island that each island sends its migrants to during this migration.
+    emp::vector<size_t> CalcDestinations(size_t num_islands) {
+      emp::vector<size_t> dest(num_islands);
+      if (topology == TORUS && torus_width && num_islands % torus_width == 0) {
+        const size_t num_rows = num_islands / torus_width;
+        const bool along_row = (num_migrations % 2 == 0);
+        for (size_t i = 0; i < num_islands; ++i) {
+          const size_t row = i / torus_width, col = i % torus_width;
+          dest[i] = along_row ? row * torus_width + (col + 1) % torus_width
+                              : ((row + 1) % num_rows) * torus_width + col;
+        }
+        return dest;
+      }
+
+      // Ring and random both use a single cycle over the islands (random shuffles its order).
+      emp::vector<size_t> order(num_islands);
+      for (size_t i = 0; i < num_islands; ++i) order[i] = i;
+      if (topology == RANDOM) {
+        emp::Random cycle_random = control.GetRandomStreams().Make(control.GetUpdate(), MIGRATE_SALT);
+        emp::Shuffle(cycle_random, order);
+      }
+      for (size_t i = 0; i < num_islands; ++i) dest[order[i]] = order[(i+1) % num_islands];
+      return dest;
+    }
+
+    /// Collect the living positions of a population in a random order.
+    emp::vector<size_t> ShuffledLiving(Population & pop, size_t salt) {
+      emp::vector<size_t> living;
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        if (!pop.IsEmpty(pos)) living.push_back(pos);
+      }
+      emp::Random pop_random = control.GetRandomStreams().Make(control.GetUpdate(), pop.GetID(), salt);
+      emp::Shuffle(pop_random, living);
+      return living;
+    }
+
+    /// Move 'count' organisms from each island to its destination island (limited by the
+    /// smallest number of living organisms on any island).  Returns the number of organisms moved.
+    size_t Migrate() {
+      emp::vector<emp::Ptr<Population>> pops = GetIslands();
+      if (pops.size() < 2 || count == 0) return 0;
+
+      const emp::vector<size_t> dest = CalcDestinations(pops.size());
+      ++num_migrations;
+
+      // Pick migrants on each island.
+      size_t num_migrants = count;
+      emp::vector<emp::vector<size_t>> migrants(pops.size());
+      for (size_t i = 0; i < pops.size(); ++i) {
+        migrants[i] = ShuffledLiving(*pops[i], MIGRATE_SALT);
+        num_migrants = std::min(num_migrants, migrants[i].size());
+      }
+
+      // Rotate migrants around each cycle of destinations.  Swapping each island in a cycle with
+      // the cycle's first island passes the first island's migrant down the line.
+      emp::vector<bool> done(pops.size(), false);
+      for (size_t start = 0; start < pops.size(); ++start) {
+        if (done[start]) continue;
+        for (size_t m = 0; m < num_migrants; ++m) {
+          const OrgPosition first_pos(*pops[start], migrants[start][m]);
+          for (size_t i = dest[start]; i != start; i = dest[i]) {
+            control.SwapOrgs(first_pos, OrgPosition(*pops[i], migrants[i][m]));
+          }
+        }
+        for (size_t i = dest[start]; !done[i]; i = dest[i]) done[i] = true;
+      }
+
+      return num_migrants * pops.size();
+    }
+
+    /// Traits to include in migrant files, in a fixed order.
+    emp::vector<emp::Ptr<TraitInfo>> GetMigrantTraits() {
+      emp::vector<emp::Ptr<TraitInfo>> traits = control.GetTraitManager().GetCheckpointTraits();
+      if (migrant_traits.size() == 0) return traits;
+      emp::String trait_list = migrant_traits;
+      trait_list.RemoveWhitespace();
+      const emp::vector<emp::String> names = trait_list.Slice(",");
+      emp::vector<emp::Ptr<TraitInfo>> out;
+      for (emp::Ptr<TraitInfo> trait_ptr : traits) {
+        if (std::find(names.begin(), names.end(), trait_ptr->GetName()) != names.end()) {
+          out.push_back(trait_ptr);
+        }
+      }
+      return out;
+    }
+
+    /// Migrant file layout: magic, trait table (name, type, count), organism type names, then
+    /// per organism: type ID, organism state block, and trait values in trait table order.
+    /// Returns the number of organisms written.
+    size_t ExportMigrants(Population & pop, const emp::String & filename) {
+      emp::vector<size_t> living = ShuffledLiving(pop, MIGRATE_SALT);
+      if (living.size() > count) living.resize(count);
+      const emp::vector<emp::Ptr<TraitInfo>> traits = GetMigrantTraits();
+
+      const std::string tmp_filename = filename.str() + ".tmp";
+      {
+        std::ofstream file(tmp_filename, std::ios::binary);
+        CheckpointWriter out(file);
+        out.Write<std::string>(MIGRANT_MAGIC);
+        out.Write<uint64_t>(traits.size());
+        for (emp::Ptr<TraitInfo> trait_ptr : traits) {
+          out.Write(trait_ptr->GetName());
+          out.Write(emp::String(trait_ptr->GetType().GetName()));
+          out.Write<uint64_t>(trait_ptr->GetValueCount());
+        }
+
+        emp::vector<emp::String> type_names;
+        std::unordered_map<emp::String, uint32_t> type_ids;
+        for (size_t pos : living) {
+          const emp::String & type_name = pop[pos].GetManagerName();
+          if (type_ids.find(type_name) == type_ids.end()) {
+            type_ids[type_name] = (uint32_t) type_names.size();
+            type_names.push_back(type_name);
+          }
+        }
+        out.Write(type_names);
+
+        out.Write<uint64_t>(living.size());
+        for (size_t pos : living) {
+          const Organism & org = pop[pos];
+          bool saved = true;
+          out.Write(type_ids[org.GetManagerName()]);
+          out.WriteBlock([&org,&saved](CheckpointWriter & block){ saved = org.SaveState(block); });
+          if (!saved) {
+            emp::notify::Error("Organism type '", org.GetManagerName(), "' cannot be exported.");
+            std::remove(tmp_filename.c_str());
+            return 0;
+          }
+          for (emp::Ptr<TraitInfo> trait_ptr : traits) trait_ptr->SaveValue(org.GetDataMap(), out);
+        }
+
+        file.close();
+        if (!out.IsOK() || !file) {
+          emp::notify::Error("Unable to write migrant file '", filename, "'.");
+          std::remove(tmp_filename.c_str());
+          return 0;
+        }
+      }
+      std::error_code error;
+      std::filesystem::rename(tmp_filename, filename.str(), error);
+      if (error) {
+        emp::notify::Error("Unable to move migrant file into place as '", filename, "': ", error.message());
+        std::remove(tmp_filename.c_str());
+        return 0;
+      }
+      return living.size();
+    }
+
+    /// Move a migrant file that cannot be imported aside (as filename.bad), so that it is
+    /// reported only once rather than on every later import.
+    void RejectMigrants(std::ifstream & file, const emp::String & filename) {
+      file.close();
+      const std::string bad_filename = filename.str() + ".bad";
+      std::error_code error;
+      std::filesystem::rename(filename.str(), bad_filename, error);
+      if (error) std::filesystem::remove(filename.str(), error);
+      else emp::notify::Warning("Rejected migrant file moved to '", bad_filename, "'.");
+    }
+
+    /// Load a migrant file (if one is waiting) over random residents of 'pop', then remove the
+    /// file.  Returns the number of organisms imported.
+    size_t ImportMigrants(Population & pop, const emp::String & filename) {
+      std::ifstream file(filename.str(), std::ios::binary);
+      if (!file) return 0;   // Nothing has arrived yet.
+      CheckpointReader in(file);
+
+      if (in.Read<std::string>() != MIGRANT_MAGIC) {
+        emp::notify::Error("File '", filename, "' is not a MABE migrant file.");
+        RejectMigrants(file, filename);
+        return 0;
+      }
+
+      // Each trait in the file must exist here with the same type and size.
+      std::unordered_map<emp::String, emp::Ptr<TraitInfo>> local_traits;
+      for (emp::Ptr<TraitInfo> trait_ptr : control.GetTraitManager().GetCheckpointTraits()) {
+        local_traits[trait_ptr->GetName()] = trait_ptr;
+      }
+      emp::vector<emp::Ptr<TraitInfo>> traits(in.Read<uint64_t>());
+      for (auto & trait_ptr : traits) {
+        const emp::String name = in.Read<emp::String>();
+        const emp::String type_name = in.Read<emp::String>();
+        const uint64_t value_count = in.Read<uint64_t>();
+        auto it = local_traits.find(name);
+        if (it == local_traits.end() || type_name != emp::String(it->second->GetType().GetName())
+            || value_count != it->second->GetValueCount()) {
+          emp::notify::Error("Migrant file '", filename, "' has trait '", name,
+                             "' which does not match the current configuration.");
+          RejectMigrants(file, filename);
+          return 0;
+        }
+        trait_ptr = it->second;
+      }
+
+      emp::vector<int> type_mods;
+      for (const emp::String & type_name : in.Read<emp::vector<emp::String>>()) {
+        type_mods.push_back(control.GetModuleID(type_name));
+        if (type_mods.back() < 0) {
+          emp::notify::Error("Migrant file '", filename, "' uses unknown organism type '", type_name, "'.");
+          RejectMigrants(file, filename);
+          return 0;
+        }
+      }
+
+      const uint64_t num_orgs = in.Read<uint64_t>();
+      emp::vector<emp::Ptr<Organism>> arrivals;
+      for (size_t i = 0; i < num_orgs && in.IsOK(); ++i) {
+        const uint32_t type_id = in.Read<uint32_t>();
+        if (type_id >= type_mods.size()) break;
+        emp::Ptr<Organism> org_ptr = control.GetModule(type_mods[type_id]).Make<Organism>();
+        in.ReadBlock([org_ptr](CheckpointReader & block){ org_ptr->LoadState(block); });
+        for (emp::Ptr<TraitInfo> trait_ptr : traits) trait_ptr->LoadValue(org_ptr->GetDataMap(), in);
+        arrivals.push_back(org_ptr);
+      }
+      if (!in.IsOK() || arrivals.size() != num_orgs) {
+        emp::notify::Error("Migrant file '", filename, "' ended unexpectedly.");
+        for (emp::Ptr<Organism> org_ptr : arrivals) org_ptr.Delete();
+        RejectMigrants(file, filename);   // Files are renamed into place whole, so it is corrupt.
+        return 0;
+      }
+      file.close();
+      std::filesystem::remove(filename.str());
+
+      // Arrivals replace random residents; any beyond the number of residents are added at
+      // the population's inject positions.
+      const emp::vector<size_t> residents = ShuffledLiving(pop, IMPORT_SALT);
+      for (size_t i = 0; i < arrivals.size(); ++i) {
+        if (i < residents.size()) control.AddOrgAt(arrivals[i], pop.IteratorAt(residents[i]));
+        else control.InjectInstance(pop, arrivals[i]);
+      }
+      return arrivals.size();
+    }
+  };
+
+  MABE_REGISTER_MODULE(MigrateIslands, "Move organisms between island populations.");
+}
+
+#endif
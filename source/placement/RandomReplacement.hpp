@@ -1,7 +1,7 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021-2022.
+ *  @date 2021-2024.
  *
  *  @file  RandomReplacement.h
  *  @brief Each birth replaces a random organism in the population, keeping it at a constant size
@@ -12,6 +12,14 @@
  * 
  *  When a neighbor position is requested, a random position from the entire population is
  *  returned.
+ *
+ *  The placement functions installed on each population are bound to it during setup, so a
+ *  birth does not look its population up in the target collection.  With single_draw on, the
+ *  replaced position is picked with one random draw that skips the parent's position, rather
+ *  than redrawing until the parent is missed (this changes the random number sequence).
+ *
+ *  With buffered_random on, positions are drawn from a RandomBuffer that is reseeded from the
+ *  main generator at the start of each update (this also changes the random number sequence).
  */
 
 #ifndef MABE_RANDOM_REPLACEMENT_H
@@ -19,6 +27,7 @@
 
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
+#include "../tools/RandomBuffer.hpp"
 
 namespace mabe {
 
@@ -26,6 +35,9 @@ namespace mabe {
   class RandomReplacement : public Module {
   private:
     Collection target_collect; ///< Collection of populations to manage
+    bool single_draw = false;  ///< Skip the parent with one draw instead of redrawing?
+    bool buffered_random = false;  ///< Draw positions from random_buffer?
+    RandomBuffer random_buffer;    ///< Block-generated draws, reseeded each update.
 
   public:
     RandomReplacement(mabe::MABE & control,
@@ -40,38 +52,66 @@ namespace mabe {
     /// Set up variables for configuration file
     void SetupConfig() override {
       LinkCollection(target_collect, "target", "Population(s) to manage.");
+      LinkVar(single_draw, "single_draw",
+              "Pick replaced orgs with a single draw that skips the parent? (changes random sequence)");
+      LinkVar(buffered_random, "buffered_random",
+              "Draw replaced orgs from a block-generated random buffer? (faster; changes random sequence)");
     }
 
     /// Set birth and inject functions for the specified populations
     void SetupModule() override {
+      if (buffered_random) random_buffer.Reseed(control.GetRandom());
       for(size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id){
         Population& pop = control.GetPopulation(pop_id);
         if(target_collect.HasPopulation(pop)){
           pop.SetPlaceBirthFun( 
             [this, &pop](Organism & /*org*/, OrgPosition ppos) {
-              return PlaceBirth(ppos, pop);
+              return ChooseReplacement(ppos, pop);
             }
           );
           pop.SetPlaceInjectFun( 
             [this, &pop](Organism & /*org*/){
-              return PlaceInject(pop);
+              return control.PushEmpty(pop);
             }
           );
         }
       }
     }
 
+    /// Reseed the buffer each update so results do not depend on how many draws it has left.
+    void BeforeUpdate(size_t) override {
+      if (buffered_random) random_buffer.Reseed(control.GetRandom());
+    }
+
+    /// Choose a random position in a monitored population, other than the parent's.
+    OrgPosition ChooseReplacement(OrgPosition ppos, Population & target_pop) {
+      if (buffered_random) return ChooseReplacement(ppos, target_pop, random_buffer);
+      return ChooseReplacement(ppos, target_pop, control.GetRandom());
+    }
+
+    template <typename RANDOM_T>
+    OrgPosition ChooseReplacement(OrgPosition ppos, Population & target_pop, RANDOM_T & random) {
+      const size_t pop_size = target_pop.GetSize();
+      const bool parent_here = ppos.IsInPop(target_pop);
+      if (pop_size <= (size_t) parent_here) return OrgPosition();  // No org to replace.
+
+      if (single_draw && parent_here) {
+        size_t new_pos = random.GetUInt(pop_size - 1);
+        if (new_pos >= ppos.Pos()) ++new_pos;  // Skip over the parent.
+        return OrgPosition(target_pop, new_pos);
+      }
+
+      OrgPosition new_pos = OrgPosition(target_pop, random.GetUInt(pop_size));
+      while(new_pos == ppos){ // Do not allow parent to be replaced
+        new_pos = OrgPosition(target_pop, random.GetUInt(pop_size));
+      }
+      return new_pos;
+    }
+
     /// Choose random position in population for organism to replace
     OrgPosition PlaceBirth(OrgPosition ppos, Population & target_pop) {
       // If the current position is monitored, return a random place in the population.
-      if (target_collect.HasPopulation(target_pop)) {
-        OrgPosition new_pos = 
-            OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-        while(new_pos == ppos){ // Do not allow parent to be replaced
-          new_pos =OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-        }
-        return new_pos;
-      }
+      if (target_collect.HasPopulation(target_pop)) return ChooseReplacement(ppos, target_pop);
 
       // Otherwise, don't find a legal place!
       return OrgPosition();      
@@ -5,6 +5,14 @@
  *
  *  @file  SchedulerProbabilistic.h
  *  @brief Rations out updates to organisms based on a specified attribute, using a method akin to roulette selection. 
+ *
+ *  Each organism's weight is base_value + merit_scale_factor * trait, set when it is placed.
+ *  With 'live_weights', the weight is also refreshed whenever an organism's trait changes
+ *  after one of its steps (an O(log N) adjustment of the weight map), so merit gained
+ *  mid-life affects scheduling right away rather than at the next birth.  With 'max_steps',
+ *  no organism gets more than that many steps in one update: a capped organism's weight is
+ *  set aside until the update ends (in batch mode, its surplus steps are redrawn among the
+ *  others), so a single high-merit organism cannot absorb most of an update.
  **/
 
 #ifndef MABE_SCHEDULER_PROB_H
@@ -12,6 +20,8 @@
 
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
+#include "../tools/AliasTable.hpp"
+#include "../tools/RandomBuffer.hpp"
 #include "emp/datastructs/UnorderedIndexMap.hpp"
 
 namespace mabe {
@@ -26,6 +36,48 @@ namespace mabe {
     emp::UnorderedIndexMap weight_map; ///< Data structure storing all organism fitnesses
     double base_value = 1; ///< Fitness value that all organisms start with 
     double merit_scale_factor = 1; ///< Fitness = base_value + (merit * this value)
+    int batch_steps = 0; ///< Draw all of an update's steps first, then run each org's in a burst?
+    int parallel_steps = 0; ///< In batch mode, run organisms' local steps across threads?
+    int buffered_random = 0; ///< Draw steps from a RandomBuffer rather than emp::Random?
+    int live_weights = 0; ///< Refresh an organism's weight when its trait changes during a step?
+    size_t max_steps = 0; ///< Most steps any one organism may get in an update (0 = no cap).
+    emp::vector<size_t> step_counts; ///< Steps allotted to (or taken by) each position this update.
+    emp::vector<std::pair<size_t,double>> capped; ///< Capped positions and their set-aside weights.
+    size_t trait_id = emp::MAX_SIZE_T; ///< DataMap ID of 'trait' (during an update).
+    bool counting_steps = false; ///< Is step_counts tracking steps taken (rather than allotted)?
+
+    double CalcWeight(const Organism & org) const {
+      return base_value + merit_scale_factor * org.GetTrait<double>(trait_id);
+    }
+
+    /// Bring a position's weight up to date with its organism's trait (if it has changed).
+    void RefreshWeight(const Population & pop, size_t pos) {
+      if (pos >= weight_map.GetSize() || pop.IsEmpty(pos)) return;
+      const double weight = CalcWeight(pop[pos]);
+      if (weight != weight_map.GetWeight(pos)) weight_map.Adjust(pos, weight);
+    }
+
+    /// Count a step for a position, setting its weight aside if it has reached max_steps.
+    void CountStep(size_t pos) {
+      if (!max_steps) return;
+      if (pos >= step_counts.size()) step_counts.resize(pos+1, 0);   // Population grew.
+      if (++step_counts[pos] < max_steps) return;
+      const double weight = weight_map.GetWeight(pos);
+      if (weight <= 0.0) return;
+      capped.emplace_back(pos, weight);
+      weight_map.Adjust(pos, 0.0);
+    }
+
+    /// At the end of an update, give capped organisms back their weights (unless they were
+    /// replaced during the update, in which case the new organism's weight stands).
+    void RestoreCapped(const Population & pop) {
+      for (auto [pos, weight] : capped) {
+        if (step_counts[pos] < max_steps) continue;   // Replaced by a newly placed organism.
+        weight_map.Adjust(pos, weight);
+        if (live_weights) RefreshWeight(pop, pos);
+      }
+      capped.resize(0);
+    }
   public:
     SchedulerProbabilistic(mabe::MABE & control,
                      const emp::String & name="SchedulerProbabilistic",
@@ -39,6 +91,11 @@ namespace mabe {
     }
     ~SchedulerProbabilistic() { }
 
+    /// Approximate bytes held by the weight map (a tree of partial sums) and step counts.
+    size_t GetNumBytes() const override {
+      return 2 * weight_map.GetSize() * sizeof(double) + step_counts.capacity() * sizeof(size_t);
+    }
+
     /// Set up variables for configuration file
     void SetupConfig() override {
       LinkPop(pop_id, "pop", "Which population should we select parents from?");
@@ -49,6 +106,16 @@ namespace mabe {
       LinkVar(base_value, "base_value", "What value should the scheduler use for organisms"
           " that have performed no tasks?");
       LinkVar(merit_scale_factor, "merit_scale_factor", "How should the scheduler scale merit?");
+      LinkVar(batch_steps, "batch_steps", "Allot all of an update's steps using the weights at its"
+          " start, then run each organism's steps together? (0=off; 1=on)");
+      LinkVar(parallel_steps, "parallel_steps", "With batch_steps, run steps that only affect"
+          " their own organism in parallel before the rest run serially? (0=off; 1=on)");
+      LinkVar(buffered_random, "buffered_random", "Draw scheduled organisms from a block-generated"
+          " random buffer? (faster; changes random sequence) (0=off; 1=on)");
+      LinkVar(live_weights, "live_weights", "Update an organism's weight as soon as its trait"
+          " changes during a step, rather than only when it is placed? (0=off; 1=on)");
+      LinkVar(max_steps, "max_steps", "Most steps any one organism can receive in an update;"
+          " the rest go to other organisms (0 = no cap).");
     }
 
     /// Register traits
@@ -57,6 +124,19 @@ namespace mabe {
       AddOwnedTrait<bool>(reset_self_trait, "Does org need reset?", false); ///< Allow organisms to reset themselves 
     }
 
+    /// Save organism weights so a restored run schedules exactly as the original would have.
+    void SaveState(CheckpointWriter & out) const override {
+      emp::vector<double> weights(weight_map.GetSize());
+      for (size_t i = 0; i < weights.size(); ++i) weights[i] = weight_map.GetWeight(i);
+      out.Write(weights);
+    }
+
+    void LoadState(CheckpointReader & in) override {
+      const emp::vector<double> weights = in.Read<emp::vector<double>>();
+      weight_map.Resize(weights.size(), 0.0);
+      for (size_t i = 0; i < weights.size(); ++i) weight_map.Adjust(i, weights[i]);
+    }
+
     /// Set up member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
       info.AddMemberFunction(
@@ -69,8 +149,15 @@ namespace mabe {
 
     /// Ration out updates to members of the population
     double Schedule() {
+      if (!buffered_random) return Schedule(control.GetRandom());
+      RandomBuffer random(control.GetRandom());
+      return Schedule(random);
+    }
+
+    /// Ration out updates, drawing from 'random' (emp::Random or RandomBuffer).
+    template <typename RANDOM_T>
+    double Schedule(RANDOM_T & random) {
       // Grab the variables we'll use repeatedly 
-      emp::Random & random = control.GetRandom();
       Population & pop = control.GetPopulation(pop_id);
       const size_t N = pop.GetSize();
       // Make sure the population isn't empty
@@ -80,30 +167,138 @@ namespace mabe {
       }
 
       if(weight_map.GetSize() == 0) weight_map.Resize(N, base_value);
+      trait_id = pop.GetDataLayout().GetID(trait);
+      if (batch_steps) return ScheduleBatch(pop, random);
+      if (max_steps) step_counts.assign(N, 0);
+      counting_steps = (max_steps > 0);
       size_t selected_idx;
+      size_t num_steps = 0;
       // Dole out updates
       for(size_t i = 0; i < N * avg_updates; ++i){
         const double total_weight = weight_map.GetWeight();
-        if(total_weight > 0.0){ // TODO: cap to max weight
+        if(total_weight > 0.0){
           selected_idx = weight_map.Index(random.GetDouble() * total_weight);
         }
+        else if (capped.size()) break;   // Every organism with weight has used its steps.
         else selected_idx = random.GetUInt(pop.GetSize()); // No weights -> pick randomly 
-        pop[selected_idx].ProcessStep();
+        if (max_steps && selected_idx < step_counts.size()
+            && step_counts[selected_idx] >= max_steps) continue;  // Unweighted repeat of a capped org.
+        if (pop[selected_idx].ProcessStep()) ++num_steps;
+        if (live_weights) RefreshWeight(pop, selected_idx);
+        CountStep(selected_idx);
       }
+      if (max_steps) RestoreCapped(pop);
+      counting_steps = false;
+      control.GetRunStats().insts_executed += num_steps;
       return weight_map.GetWeight();
     }
 
-    /// When an organism is placed in a population, add its weight to the weight map
-    void OnPlacement(OrgPosition placement_pos) override {
-      Population & pop = placement_pos.Pop();
+    /// Limit batch allotments to max_steps, redrawing the surplus among organisms still under
+    /// the cap until none is left (or no organism with weight can take more).
+    template <typename RANDOM_T>
+    void CapAllotments(emp::vector<double> & weights, RANDOM_T & random) {
+      size_t surplus = 0;
+      for (size_t pos = 0; pos < weights.size(); ++pos) {
+        if (step_counts[pos] < max_steps) continue;
+        surplus += step_counts[pos] - max_steps;
+        step_counts[pos] = max_steps;
+        weights[pos] = 0.0;
+      }
+      while (surplus) {
+        AliasTable table(weights);
+        if (table.GetWeight() <= 0.0) return;      // Everyone with weight is at the cap.
+        const size_t num_draws = surplus;
+        surplus = 0;
+        for (size_t i = 0; i < num_draws; ++i) {
+          const size_t pos = table.Draw(random);
+          if (step_counts[pos] < max_steps) ++step_counts[pos];
+          else ++surplus;   // Reached the cap during this round; redraw next round.
+        }
+        for (size_t pos = 0; pos < weights.size(); ++pos) {
+          if (step_counts[pos] >= max_steps) weights[pos] = 0.0;
+        }
+      }
+    }
+
+    /// Ration out updates in one pass: allot every step of the update based on the current
+    /// weights (drawn in constant time from an alias table), then give each organism all of
+    /// its steps in a row for better cache locality.  Weight changes from births during the
+    /// update take effect at the next update.
+    template <typename RANDOM_T>
+    double ScheduleBatch(Population & pop, RANDOM_T & random) {
       const size_t N = pop.GetSize();
-      if(weight_map.GetSize() < N){
-        weight_map.Resize(N, 1);
+      const size_t num_draws = (size_t) (N * avg_updates);
+
+      step_counts.assign(N, 0);
+      const size_t num_weights = std::min(N, weight_map.GetSize());
+      emp::vector<double> weights(num_weights);
+      for (size_t i = 0; i < num_weights; ++i) weights[i] = weight_map.GetWeight(i);
+      AliasTable table(weights);
+      if (table.GetWeight() > 0.0) {
+        for (size_t i = 0; i < num_draws; ++i) step_counts[table.Draw(random)]++;
+        if (max_steps) CapAllotments(weights, random);
+      }
+      else {  // No weights -> pick randomly
+        for (size_t i = 0; i < num_draws; ++i) step_counts[random.GetUInt(N)]++;
+        if (max_steps) {
+          for (size_t & count : step_counts) count = std::min(count, max_steps);
+        }
+      }
+
+      size_t num_steps = 0;
+      if (parallel_steps) {
+        num_steps += RunLocalSteps(pop);
+        control.Sync();  // Finish work deferred by the parallel steps (e.g., queued births).
+      }
+
+      // Run all remaining steps serially, in position order.
+      for (size_t pos = 0; pos < N && pos < pop.GetSize(); ++pos) {
+        for (size_t step = 0; step < step_counts[pos]; ++step) {
+          if (pop[pos].ProcessStep()) ++num_steps;
+        }
+      }
+
+      // Steps all ran with the weights from the start of the update; catch up on any changes.
+      if (live_weights) {
+        for (size_t pos = 0; pos < num_weights && pos < pop.GetSize(); ++pos) RefreshWeight(pop, pos);
+      }
+      control.GetRunStats().insts_executed += num_steps;
+      return weight_map.GetWeight();
+    }
+
+    /// Run each organism's allotted steps across the thread pool for as long as its next step
+    /// is local (see OrgType::IsNextStepLocal()), removing them from step_counts.  Steps that
+    /// could affect other organisms are left for the serial pass, so results are the same for
+    /// any number of threads.  Returns the number of steps executed.
+    size_t RunLocalSteps(Population & pop) {
+      ThreadPool & pool = control.GetThreadPool();
+      emp::vector<size_t> executed(pool.CalcNumChunks(step_counts.size()), 0);
+      pool.ForEachChunk(step_counts.size(), [&](size_t chunk_id, size_t start, size_t end) {
+        size_t chunk_steps = 0;
+        for (size_t pos = start; pos < end; ++pos) {
+          if (step_counts[pos] == 0 || pop.IsEmpty(pos)) continue;
+          step_counts[pos] -= pop[pos].ProcessLocalSteps(step_counts[pos], chunk_steps);
+        }
+        executed[chunk_id] = chunk_steps;
+      });
+      size_t num_steps = 0;
+      for (size_t chunk_steps : executed) num_steps += chunk_steps;
+      return num_steps;
+    }
+
+    /// When organisms are placed in a population, add their weights to the weight map
+    void OnPlacementBatch(std::span<const OrgPosition> placement_positions) override {
+      for (OrgPosition placement_pos : placement_positions) {
+        Population & pop = placement_pos.Pop();
+        const size_t N = pop.GetSize();
+        if(weight_map.GetSize() < N){
+          weight_map.Resize(N, 1);
+        }
+        size_t org_idx = placement_pos.Pos();
+        weight_map.Adjust(org_idx, base_value + merit_scale_factor * pop[org_idx].GetTrait<double>(trait));
+        if (counting_steps && org_idx < step_counts.size()) step_counts[org_idx] = 0;  // New org; new cap.
+        pop[org_idx].SetTrait<bool>(reset_self_trait, false);
       }
-      size_t org_idx = placement_pos.Pos();
-      weight_map.Adjust(org_idx, 
-          base_value + merit_scale_factor * placement_pos.Pop()[org_idx].GetTrait<double>(trait));
-      placement_pos.Pop()[org_idx].SetTrait<bool>(reset_self_trait, false);
     }
   };
 
@@ -13,7 +13,7 @@
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 
-#include "emp/datastructs/valsort_map.hpp"
+#include <algorithm>
 
 namespace mabe {
 
@@ -26,20 +26,29 @@ namespace mabe {
     Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
       auto fit_fun = control.BuildTraitEquation(select_pop, fit_equation);
 
-      // Construct a map of all IDs to their associated fitness values.
-      emp::valsort_map<OrgPosition, double> id_fit_map;  // @CAO: Better to use a heap?
+      // Collect the fitness of each organism; only the top_count best need to be put in order.
+      // Ties are broken in favor of later positions.
+      emp::vector<std::pair<double, OrgPosition>> org_fits;
       for (auto it = select_pop.begin(); it != select_pop.end(); it++) {
-        id_fit_map.Set(it.AsPosition(), fit_fun(*it));
+        org_fits.emplace_back(fit_fun(*it), it.AsPosition());
       }
+      const size_t num_top = std::min(top_count, org_fits.size());
+      std::partial_sort(org_fits.begin(), org_fits.begin() + num_top, org_fits.end(),
+        [](const auto & a, const auto & b) {
+          if (a.first != b.first) return a.first > b.first;
+          return a.second.Pos() > b.second.Pos();
+        });
 
-      // Loop through the IDs in fitness order (from highest), replicating each
-      Collection placement_list;
-      for (auto it = id_fit_map.crvbegin(); it != id_fit_map.crvend() && top_count; it++) {
-        size_t copy_count = std::ceil(((double)num_births) / (double) top_count--);
+      // Loop through the IDs in fitness order (from highest), collecting parents for each birth.
+      emp::vector<OrgPosition> parents;
+      parents.reserve(num_births);
+      size_t remaining_top = top_count;
+      for (size_t i = 0; i < num_top; ++i) {
+        size_t copy_count = std::ceil(((double)num_births) / (double) remaining_top--);
         num_births -= copy_count;
-        placement_list += control.Replicate(it->first, birth_pop, copy_count);
+        parents.insert(parents.end(), copy_count, org_fits[i].second);
       }
-      return placement_list;
+      return control.DoBirths(std::span<const OrgPosition>(parents.data(), parents.size()), birth_pop);
     }
 
   public:
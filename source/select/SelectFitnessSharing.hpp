@@ -5,6 +5,11 @@
  *
  *  @file  SelectFitnessSharing.hpp
  *  @brief MABE module to enable tournament selection (choose T random orgs and return "best")
+ *
+ *  With fast_niche turned on, niche counts are computed after generating output for every
+ *  organism, from a packed matrix of sharing-trait values.  Organisms are bucketed on a grid
+ *  (with cells the size of sharing_threshold) over the first few trait dimensions, so only
+ *  organisms in neighboring cells are compared, and the work is split across the thread pool.
  */
 
 #ifndef MABE_SELECT_FITNESS_SHARING_H
@@ -13,6 +18,9 @@
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 
+#include <array>
+#include <map>
+
 #include "emp/math/distances.hpp"
 
 namespace mabe {
@@ -25,6 +33,9 @@ namespace mabe {
     size_t tourny_size = 7;             ///< How big should each tournament be?
     double sharing_threshold;           ///< How similar to organisms need to be for fitness sharing?
     double alpha = 1;                   ///< Fitness sharing shape parameter
+    int fast_niche = 0;                 ///< Use the grid-based niche counter?
+
+    static constexpr size_t GRID_DIMS = 3;  ///< Max trait dimensions used to bucket organisms.
 
   public:
     SelectFitnessSharing(mabe::MABE & control,
@@ -42,6 +53,8 @@ namespace mabe {
       LinkVar(sharing_trait, "sharing_trait", "Which trait should we do fitness sharing based on?");
       LinkVar(alpha, "alpha", "Sharing function exponent");
       LinkVar(sharing_threshold, "sharing_threshold", "How similar things need to be to share fitness");
+      LinkVar(fast_niche, "fast_niche", "Generate all outputs first, then count niches using a"
+              " spatial grid and multiple threads? (0=off; 1=on)");
     }
 
     void SetupModule() override {
@@ -72,7 +85,8 @@ namespace mabe {
         return placement_list;
       }
 
-      for (size_t i = 0; i < select_pop.size(); i++) {
+      if (fast_niche) CalcSharedFitness(select_pop);
+      else for (size_t i = 0; i < select_pop.size(); i++) {
         if (select_pop.IsEmpty(i)) {
           continue;
         }
@@ -93,17 +107,17 @@ namespace mabe {
 
       // @CAO if we have a sparse Population, we probably want to take that into account.
 
-      // Loop through each round of tournament selection.
-      for (size_t round = 0; round < num_births; round++) {
+      // Run each round of tournament selection, replicating the winner.
+      return control.DoBirths(num_births, [&](size_t /*round*/) {
         // Find a random organism in the population and call it "best"
         size_t best_id = random.GetUInt(N);
-        while (select_pop[best_id].IsEmpty()) best_id = random.GetUInt(N);
+        while (select_pop.IsEmpty(best_id)) best_id = random.GetUInt(N);
         double best_fit = select_pop[best_id].GetTrait<double>(sharing_trait);
 
         // Loop through other organisms for the rest of the tournament size, and pick best.
         for (size_t test=1; test < tourny_size; test++) {
           size_t test_id = random.GetUInt(N);
-          while (select_pop[test_id].IsEmpty()) test_id = random.GetUInt(N);
+          while (select_pop.IsEmpty(test_id)) test_id = random.GetUInt(N);
           double test_fit = select_pop[test_id].GetTrait<double>(sharing_trait);          
           if (test_fit > best_fit) {
             best_id = test_id;
@@ -112,10 +126,86 @@ namespace mabe {
         }
 
         // Replicate the organism that did best in this tournament.
-        placement_list += control.Replicate(select_pop.IteratorAt(best_id), birth_pop, 1);
+        return select_pop.IteratorAt(best_id).AsPosition();
+      }, birth_pop);
+    }
+
+    /// Calculate shared fitness for all living organisms, only comparing organisms that are in
+    /// neighboring grid cells (a necessary condition for being within sharing_threshold).
+    void CalcSharedFitness(Population & pop) {
+      // Generate outputs and pack the sharing traits into one contiguous matrix.
+      emp::vector<size_t> positions;
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        if (pop.IsEmpty(pos)) continue;
+        pop[pos].GenerateOutput();
+        positions.push_back(pos);
+      }
+      const size_t num_orgs = positions.size();
+      const size_t num_dims = pop[positions[0]].GetTrait<emp::vector<double>>(sharing_trait).size();
+      emp::vector<double> values(num_orgs * num_dims);
+      for (size_t i = 0; i < num_orgs; ++i) {
+        const emp::vector<double> & org_vals = pop[positions[i]].GetTrait<emp::vector<double>>(sharing_trait);
+        if (org_vals.size() != num_dims) {
+          emp::notify::Error("All organisms must have the same number of values in sharing trait '",
+                             sharing_trait, "'.");
+          return;
+        }
+        std::copy(org_vals.begin(), org_vals.end(), values.begin() + i * num_dims);
+      }
+
+      // Anything too far apart does not share; a non-positive threshold means no sharing at all.
+      emp::vector<double> niche_counts(num_orgs, 0.1);
+      if (sharing_threshold > 0.0) {
+        // Bucket organisms by grid cell.
+        using cell_t = std::array<int64_t, GRID_DIMS>;
+        const size_t grid_dims = std::min(num_dims, GRID_DIMS);
+        auto calc_cell = [&](size_t org_id) {
+          cell_t cell{};
+          for (size_t d = 0; d < grid_dims; ++d) {
+            cell[d] = (int64_t) std::floor(values[org_id * num_dims + d] / sharing_threshold);
+          }
+          return cell;
+        };
+        std::map<cell_t, emp::vector<size_t>> grid;
+        for (size_t i = 0; i < num_orgs; ++i) grid[calc_cell(i)].push_back(i);
+
+        const double max_dist2 = sharing_threshold * sharing_threshold;
+        control.GetThreadPool().ForEach(num_orgs, [&](size_t i) {
+          const cell_t cell = calc_cell(i);
+          const double * vals1 = values.data() + i * num_dims;
+          double niche_count = 0.1;
+
+          // Visit all 3^grid_dims neighboring cells, including this one.
+          size_t num_neighbors = 1;
+          for (size_t d = 0; d < grid_dims; ++d) num_neighbors *= 3;
+          for (size_t offset_id = 0; offset_id < num_neighbors; ++offset_id) {
+            cell_t neighbor = cell;
+            for (size_t d = 0, id = offset_id; d < grid_dims; ++d, id /= 3) {
+              neighbor[d] += (int64_t) (id % 3) - 1;
+            }
+            auto it = grid.find(neighbor);
+            if (it == grid.end()) continue;
+            for (size_t j : it->second) {
+              if (j == i) continue;
+              const double * vals2 = values.data() + j * num_dims;
+              double dist2 = 0.0;
+              for (size_t d = 0; d < num_dims; ++d) {
+                const double diff = vals1[d] - vals2[d];
+                dist2 += diff * diff;
+              }
+              if (dist2 >= max_dist2) continue;
+              niche_count += 1.0 - std::pow(std::sqrt(dist2)/sharing_threshold, alpha);
+            }
+          }
+          niche_counts[i] = niche_count;
+        });
       }
 
-      return placement_list;
+      const emp::DataLayout & layout = pop.GetDataLayout();
+      emp::vector<double> fitness(num_orgs);
+      pop.GatherTraitAt<double, size_t>(layout.GetID(trait), positions, fitness);
+      for (size_t i = 0; i < num_orgs; ++i) fitness[i] /= niche_counts[i];
+      pop.ScatterTraitAt<double, size_t>(layout.GetID("shared_fitness"), positions, fitness);
     }
 
   };
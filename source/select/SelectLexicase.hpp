@@ -10,11 +10,14 @@
 #ifndef MABE_SELECT_LEXICASE_H
 #define MABE_SELECT_LEXICASE_H
 
+#include <algorithm>
+#include <cmath>
+
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 #include "../core/TraitSet.hpp"
+#include "../tools/LexicaseFilter.hpp"
 
-#include "emp/bits/BitVector.hpp"
 #include "emp/datastructs/valsort_map.hpp"
 #include "emp/datastructs/vector_utils.hpp"
 #include "emp/math/random_utils.hpp"
@@ -30,11 +33,18 @@ namespace mabe {
     TraitSet<double> trait_set; ///< Processed version of trait_inputs.
     double epsilon = 0.0;       ///< Range from max value to be preserved? (fraction of max)
     size_t sample_traits = 0;   ///< Number of test cases to use each generation (0=off)
+    emp::String active_cases;   ///< Name of shared test-case sample for evaluators ("" = none)
 
     emp::String major_trait;    ///< Is there a trait we want to emphasize in importance?
     size_t major_range=10;      ///< Major trait guaranteed to be in first X tests.
 
     int require_first=0;        ///< Do we require each test to be picked first at least once?
+    int birth_streams=0;        ///< Give each birth its own random stream (allows threading)?
+    int elite_buckets=0;        ///< Filter with precomputed per-trait bitsets of top organisms?
+    int auto_epsilon=0;         ///< Set each trait's epsilon to its median absolute deviation?
+
+    static constexpr size_t BIRTH_SALT = 0x1e71ca5e;  ///< Random-stream key for per-birth streams.
+    size_t module_id = 0;      ///< ID of this module, so its birth streams are its own.
 
     Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
       if (num_births > 1 && select_pop.GetID() == birth_pop.GetID()) {
@@ -50,97 +60,111 @@ namespace mabe {
 
       // If we're not using all of the traits, determine which ones to select on.
       emp::vector<size_t> traits_used;
-      if (sample_traits) {
+      if (sample_traits && active_cases.size()) {
+        // Use the shared sample, so evaluators can skip the cases we will not look at.
+        traits_used = control.GetActiveCases(active_cases)
+          .GetSample(control.GetRandomStreams(), control.GetUpdate(), num_traits-major_count);
+      }
+      else if (sample_traits) {
         emp::Choose(random, num_traits-major_count, sample_traits, traits_used);
       }
 
-      // Build a trait vector to hold the scores for each organism.
-      emp::vector< emp::vector<double> > trait_scores(select_pop.GetSize());
-
-      // Loop through each organism to collect its trait information.
-      emp::vector<size_t> start_orgs;
+      // Collect the trait values into a trait-major matrix (see tools/LexicaseFilter.hpp).
+      emp::vector<size_t> start_orgs;   // Positions in select_pop of each matrix column entry.
       for (size_t org_id = live_id; org_id < select_pop.GetSize(); ++org_id) {
-        if (select_pop.IsEmpty(org_id)) continue;  // Skip empty positions in the population.
-        start_orgs.push_back(org_id);  // Add cell ID to the set of starting organisms.
-
-        // Collect all of the trait values for the current organism.
-        // If we are using a subset of traits, take that into account.
-        if (traits_used.size() > 0) {
-          trait_set.GetValues(select_pop[org_id].GetDataMap(), trait_scores[org_id], traits_used);
-        } else {
-          trait_set.GetValues(select_pop[org_id].GetDataMap(), trait_scores[org_id]);
-
-          // @CAO: This should be a user error, not a program error:
-          emp_assert(num_traits == trait_scores[org_id].size(),
-                    org_id, num_traits, trait_scores[org_id].size(),
-                    "All organisms must have the same number of traits!");
+        if (!select_pop.IsEmpty(org_id)) start_orgs.push_back(org_id);
+      }
+      const size_t num_orgs = start_orgs.size();
+      LexicaseFilter filter(num_traits, num_orgs, epsilon);
+      emp::vector<double> org_scores;
+      for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+        // Collect all of the trait values for the current organism; if we are using a subset
+        // of traits, only the columns in traits_used are filtered on below.
+        const emp::DataMap & dmap = select_pop[start_orgs[org_idx]].GetDataMap();
+        trait_set.GetValues(dmap, org_scores);
+
+        // @CAO: This should be a user error, not a program error:
+        emp_assert(num_traits == org_scores.size(), start_orgs[org_idx], num_traits, org_scores.size(),
+                   "All organisms must have the same number of traits!");
+        for (size_t trait_id = 0; trait_id < num_traits; ++trait_id) {
+          filter.Score(trait_id, org_idx) = org_scores[trait_id];
         }
       }
 
+      // Find the epsilon for each trait.  Automatic epsilons are each trait's median absolute
+      // deviation (at least 'epsilon'), found once here with O(N) selection and shared by all
+      // births from this call.
+      if (auto_epsilon && num_orgs > 0) {
+        control.GetThreadPool().ForEachChunk(num_traits, [&](size_t, size_t start, size_t end) {
+          emp::vector<double> scratch(num_orgs);
+          for (size_t trait_id = start; trait_id < end; ++trait_id) {
+            const double * column = filter.GetColumn(trait_id);
+            auto mid = scratch.begin() + num_orgs / 2;
+            std::copy(column, column + num_orgs, scratch.begin());
+            std::nth_element(scratch.begin(), mid, scratch.end());
+            const double median = *mid;
+            for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+              scratch[org_idx] = std::abs(column[org_idx] - median);
+            }
+            std::nth_element(scratch.begin(), mid, scratch.end());
+            filter.SetEpsilon(trait_id, std::max(*mid, epsilon));
+          }
+        });
+      }
+
       // Setup a vector with each trait index to be shuffled as needed for selection.
       if (traits_used.size() == 0) traits_used = emp::NRange<size_t>(0, num_traits);
-      emp::vector<size_t> cur_orgs, next_orgs;
 
-      // Create the correct number of offspring.
-      Collection placement_list;
-      emp::vector<size_t> traits_order;
-      for (size_t birth_id = 0; birth_id < num_births; ++birth_id) {
+      // Elite buckets replace filtering steps with bitset intersections where that gives the
+      // same survivors.
+      if (elite_buckets) filter.BuildBuckets();
+
+      // Choose the matrix index of one parent, using the provided random number generator and
+      // scratch vectors (so that separate threads can each choose parents).
+      auto choose_parent = [&](emp::Random & rng, size_t birth_id, emp::vector<size_t> & traits_order,
+                               emp::vector<size_t> & cur_orgs, emp::vector<size_t> & next_orgs) {
         traits_order = traits_used;
-        emp::Shuffle(random, traits_order);  // Shuffle traits into a random order.
+        emp::Shuffle(rng, traits_order);     // Shuffle traits into a random order.
         if (major_trait.size()) {            // Insert the major trait if we are using one.
-          size_t major_pos = random.GetUInt(major_range);
+          size_t major_pos = rng.GetUInt(major_range);
           traits_order.insert(traits_order.begin()+major_pos, num_traits-1);
         }
         if (require_first && birth_id < num_traits) {  // Give each or a turn first, if needed.
           traits_order.insert(traits_order.begin(), birth_id);
         }
 
-        // Step through traits and filter based on each trait.
-        cur_orgs = start_orgs;                              // Start with full population
-        for (size_t i = 0; i < traits_order.size(); ++i) {
-          size_t trait_id = traits_order[i];
-          double min_value = std::numeric_limits<double>::max();
-          double max_value = std::numeric_limits<double>::lowest();
-          for (size_t org_id : cur_orgs) {
-            const double cur_value = trait_scores[org_id][trait_id];
-            if (cur_value < min_value) min_value = cur_value;
-            if (cur_value > max_value) max_value = cur_value;
-          }
-
-          // If there's not enough variation in this trait, move on to the next trait.
-          if (min_value + epsilon >= max_value) continue;
-
-          // Eliminate all organisms with a lower score than the threshold.
-          double threshold = max_value - epsilon;
-          for (size_t org_id : cur_orgs) {
-            if (trait_scores[org_id][trait_id] >= threshold) next_orgs.push_back(org_id);
-          }
-
-          // Cleanup for the next trait.
-          cur_orgs.resize(0);
-          std::swap(cur_orgs, next_orgs);
-
-          // If we are down to just one organism, stop early!
-          if (cur_orgs.size() == 1) break;
-          emp_assert(cur_orgs.size() > 0);
-        }
-
+        filter.Filter(traits_order, cur_orgs, next_orgs);
         emp_assert(cur_orgs.size() > 0);
 
-        // If there's only one organism left, mark it for replication.
-        if (cur_orgs.size() == 1) {
-          placement_list += control.Replicate(select_pop.IteratorAt(cur_orgs[0]), birth_pop);
-        }
-
-        // Otherwise pick a random organism from the ones remaining.
-        else {
-          int org_id = cur_orgs[ random.GetUInt(cur_orgs.size()) ];
-          placement_list += control.Replicate(select_pop.IteratorAt(org_id), birth_pop);
-        }
-
+        // If there's only one organism left, it is the parent; otherwise pick one at random.
+        if (cur_orgs.size() == 1) return cur_orgs[0];
+        return cur_orgs[ rng.GetUInt(cur_orgs.size()) ];
+      };
+
+      // With per-birth random streams, all parents can be chosen up front (in parallel if
+      // num_threads > 1); births then happen in order.
+      if (birth_streams) {
+        emp::vector<OrgPosition> parents(num_births);
+        const RandomStreams streams = control.GetRandomStreams();
+        const size_t update = control.GetUpdate();
+        const size_t call_id = control.NextStreamCall();
+        control.GetThreadPool().ForEachChunk(num_births, [&](size_t, size_t start, size_t end) {
+          emp::vector<size_t> traits_order, cur_orgs, next_orgs;
+          for (size_t birth_id = start; birth_id < end; ++birth_id) {
+            emp::Random birth_random = streams.Make(update, module_id, call_id, select_pop.GetID(), birth_id, BIRTH_SALT);
+            const size_t org_idx = choose_parent(birth_random, birth_id, traits_order, cur_orgs, next_orgs);
+            parents[birth_id] = OrgPosition(select_pop, start_orgs[org_idx]);
+          }
+        });
+        return control.DoBirths(parents, birth_pop);
       }
 
-      return placement_list;
+      // Create the correct number of offspring, choosing each parent just before its birth.
+      emp::vector<size_t> traits_order, cur_orgs, next_orgs;
+      return control.DoBirths(num_births, [&](size_t birth_id) {
+        const size_t org_idx = choose_parent(random, birth_id, traits_order, cur_orgs, next_orgs);
+        return select_pop.IteratorAt(start_orgs[org_idx]).AsPosition();
+      }, birth_pop);
     }
 
   public:
@@ -167,12 +191,22 @@ namespace mabe {
       LinkVar(trait_inputs, "fitness_traits", "Which traits provide the fitness values to use?");
       LinkVar(epsilon, "epsilon", "Range from max value to be preserved? (fraction of max)");
       LinkVar(sample_traits, "sample_traits", "Number of test cases to use each generation (0=all)" );
+      LinkVar(active_cases, "active_cases",
+              "Name to share the sampled test cases under, so evaluators with a matching\n"
+              "active_cases setting only compute those cases (\"\" = don't share)");
       LinkVar(major_trait, "major_trait", "Is there a particular trait we want to emphasize?");
       LinkVar(major_range, "major_range", "Major trait guaranteed to be in first X tests");
       LinkVar(require_first, "require_first", "Require each test to be first at least once? (0=off; 1=on)");
+      LinkVar(birth_streams, "birth_streams",
+              "Use a separate random stream per birth so parents can be chosen in parallel? (0=off; 1=on)");
+      LinkVar(elite_buckets, "elite_buckets",
+              "Filter with precomputed bitsets of each trait's top organisms? (0=off; 1=on)");
+      LinkVar(auto_epsilon, "auto_epsilon",
+              "Use each trait's median absolute deviation as its epsilon (with epsilon as a minimum)? (0=off; 1=on)");
     }
 
     void SetupModule() override {
+      module_id = (size_t) control.GetModuleID(GetName());
       // We should always have a minimal epsilon to handle mathematical imprecision of doubles.
       if (epsilon <= 0.0) epsilon = 0.000000001; // One billionth.
 
@@ -182,6 +216,9 @@ namespace mabe {
         AddRequiredTrait<double, emp::vector<double>>(name, TraitInfo::ANY_COUNT);
       }
 
+      // Let evaluators know how many test cases we will use each update.
+      if (active_cases.size()) control.GetActiveCases(active_cases).SetSampleSize(sample_traits);
+
       // Check for the the major trait, if we have one.
       if (major_trait.size()) {
         AddRequiredTrait<double>(major_trait, 1);
@@ -0,0 +1,158 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SelectNSGA2.hpp
+ *  @brief MABE module for NSGA-II style multi-objective selection.
+ *
+ *  Living organisms are ranked into Pareto fronts on fitness_traits (all maximized) and given
+ *  a crowding distance within their front (see tools/ParetoFronts.hpp).  Each parent is the
+ *  winner of a tournament using the crowded comparison: a lower front wins, and within a
+ *  front the less crowded organism wins.
+ *
+ *  The fronts are kept until the selected population changes or the update ends, so several
+ *  SELECT calls from one population in an update sort it only once.  (Re-evaluating that
+ *  population later in the same update is not detected; select from it before doing so.)
+ */
+
+#ifndef MABE_SELECT_NSGA2_H
+#define MABE_SELECT_NSGA2_H
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../core/TraitSet.hpp"
+#include "../tools/ParetoFronts.hpp"
+
+namespace mabe {
+
+  /// Add NSGA-II selection (non-dominated sorting with crowded tournaments).
+  class SelectNSGA2 : public Module {
+  private:
+    emp::String trait_inputs;   ///< Which set of trait values should we select on?
+    TraitSet<double> trait_set; ///< Processed version of trait_inputs.
+    size_t tourny_size = 2;     ///< Number of organisms in each crowded tournament.
+
+    ParetoFronts fronts;        ///< Fronts of the most recently sorted population.
+    emp::vector<size_t> org_ids;  ///< Position in the sorted population of each point.
+    int cache_pop_id = -1;      ///< Population that 'fronts' describes (-1 = none).
+    size_t cache_update = 0;    ///< Update in which 'fronts' was calculated.
+    size_t num_sorts = 0;       ///< Number of times a population was sorted.
+
+    /// Make sure 'fronts' describes the current contents of select_pop.
+    void UpdateFronts(Population & select_pop) {
+      if (cache_pop_id == select_pop.GetID() && cache_update == control.GetUpdate()) return;
+
+      org_ids.resize(0);
+      for (size_t org_id = 0; org_id < select_pop.GetSize(); ++org_id) {
+        if (!select_pop.IsEmpty(org_id)) org_ids.push_back(org_id);
+      }
+      const size_t num_orgs = org_ids.size();
+      const size_t num_traits = trait_set.CountValues(select_pop[org_ids[0]].GetDataMap());
+
+      // Collect the trait values into an objective-major matrix.
+      emp::vector<double> trait_matrix(num_traits * num_orgs);
+      emp::vector<double> org_scores;
+      for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+        trait_set.GetValues(select_pop[org_ids[org_idx]].GetDataMap(), org_scores);
+        emp_assert(num_traits == org_scores.size(), org_ids[org_idx], num_traits, org_scores.size(),
+                   "All organisms must have the same number of traits!");
+        for (size_t trait_id = 0; trait_id < num_traits; ++trait_id) {
+          trait_matrix[trait_id * num_orgs + org_idx] = org_scores[trait_id];
+        }
+      }
+
+      fronts.Calc(trait_matrix, num_orgs);
+      cache_pop_id = select_pop.GetID();
+      cache_update = control.GetUpdate();
+      ++num_sorts;
+    }
+
+    /// Drop the cached fronts if they describe the population at 'pos'.
+    void CheckChange(OrgPosition pos) { if (pos.PopID() == cache_pop_id) cache_pop_id = -1; }
+
+    Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
+      if (select_pop.IsEmpty()) return Collection();  // No living orgs!!
+      UpdateFronts(select_pop);
+
+      // Choose all parents before any births, since births may change select_pop.
+      emp::Random & random = control.GetRandom();
+      const size_t num_orgs = org_ids.size();
+      emp::vector<OrgPosition> parents(num_births);
+      for (OrgPosition & parent : parents) {
+        size_t best_idx = random.GetUInt(num_orgs);
+        for (size_t test = 1; test < tourny_size; ++test) {
+          const size_t test_idx = random.GetUInt(num_orgs);
+          if (fronts.IsPreferred(test_idx, best_idx)) best_idx = test_idx;
+        }
+        parent = OrgPosition(select_pop, org_ids[best_idx]);
+      }
+      return control.DoBirths(parents, birth_pop);
+    }
+
+  public:
+    SelectNSGA2(mabe::MABE & control,
+                const emp::String & name="SelectNSGA2",
+                const emp::String & desc="Module to choose organisms by Pareto front and crowding.")
+      : Module(control, name, desc)
+    {
+      SetSelectMod(true);    ///< Mark this module as a selection module.
+    }
+    ~SelectNSGA2() { }
+
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction(
+        "SELECT",
+        [](SelectNSGA2 & mod, Population & from, Population & to, double count) {
+          return mod.Select(from,to,count);
+        },
+        "Perform NSGA-II selection on the identified population.");
+      info.AddMemberFunction(
+        "NUM_FRONTS",
+        [](SelectNSGA2 & mod, Population & pop) {
+          if (pop.IsEmpty()) return (size_t) 0;
+          mod.UpdateFronts(pop);
+          return mod.fronts.GetNumFronts();
+        },
+        "Number of Pareto fronts in the identified population.");
+      info.AddMemberFunction("NUM_SORTS", [](SelectNSGA2 & mod) { return mod.num_sorts; },
+        "Number of times a population has had to be sorted into fronts.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(trait_inputs, "fitness_traits", "Which traits provide the objectives to maximize?");
+      LinkVar(tourny_size, "tournament_size", "Number of orgs in each crowded tournament");
+    }
+
+    void SetupModule() override {
+      if (tourny_size == 0) {
+        emp::notify::Error("SelectNSGA2 tournament_size must be at least 1.");
+        tourny_size = 1;
+      }
+
+      // All of the traits used are required to be generated by another module.
+      emp::vector<emp::String> trait_names = trait_inputs.Slice(",");
+      for (const emp::String & name : trait_names) {
+        AddRequiredTrait<double, emp::vector<double>>(name, TraitInfo::ANY_COUNT);
+      }
+    }
+
+    void SetupDataMap(emp::DataMap & dmap) override {
+      trait_set.SetLayout(dmap.GetLayout()); ///< Give this trait set a layout to optimize.
+      trait_set.SetTraits(trait_inputs);     ///< Parse set of trait inputs passed in.
+    }
+
+    // Any change to the sorted population invalidates its fronts.
+    void OnPlacement(OrgPosition pos) override { CheckChange(pos); }
+    void BeforeDeath(OrgPosition pos) override { CheckChange(pos); }
+    void OnSwap(OrgPosition pos1, OrgPosition pos2) override { CheckChange(pos1); CheckChange(pos2); }
+    void OnPopSwap(Population & pop1, Population & pop2) override {
+      if (pop1.GetID() == cache_pop_id || pop2.GetID() == cache_pop_id) cache_pop_id = -1;
+    }
+  };
+
+  MABE_REGISTER_MODULE(SelectNSGA2, "Choose parents by Pareto front rank, then crowding distance.");
+}
+
+#endif
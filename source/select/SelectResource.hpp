@@ -0,0 +1,156 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SelectResource.hpp
+ *  @brief MABE module for resource-limited (Eco-EA style) tournament selection.
+ *
+ *  Each task value in task_traits has its own resource pool.  Every selection, the living
+ *  organisms feed on each pool in turn: an organism's bonus grows with the square of its task
+ *  score and the pool's remaining amount, and depletes the pool by that bonus.  Fitness is
+ *  the base fitness times 2^(total bonus), and parents are then chosen by tournament.
+ *
+ *  Task scores are gathered into a task-major matrix, so each pool walks one contiguous
+ *  column; pools do not interact, so they are consumed across the thread pool.
+ */
+
+#ifndef MABE_SELECT_RESOURCE_H
+#define MABE_SELECT_RESOURCE_H
+
+#include <cmath>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../core/TraitSet.hpp"
+#include "../tools/Resource.hpp"
+
+namespace mabe {
+
+  class SelectResource : public Module {
+  private:
+    emp::String fit_equation = "1";   ///< Trait equation for base fitness.
+    emp::String task_inputs;          ///< Which traits hold task scores (one pool per value)?
+    TraitSet<double> task_set;        ///< Processed version of task_inputs.
+    size_t tourny_size = 7;           ///< Number of organisms in each tournament.
+    double init_amount = 0.0;         ///< Starting amount of each pool.
+    double inflow = 100.0;            ///< Amount added to each pool per selection.
+    double outflow = 0.01;            ///< Fraction of each pool lost per selection.
+    ResourcePools::Params params;     ///< How much organisms take from pools.
+
+    OwnedTrait<double> fitness_trait{this, "resource_fitness", "Fitness including resource bonuses."};
+
+    ResourcePools pools;
+    emp::vector<double> scores;       ///< [task][org] task scores of living organisms.
+    emp::vector<double> bonuses;      ///< [task][org] bonus from each pool.
+
+    Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
+      if (select_pop.GetNumOrgs() == 0) {
+        emp::notify::Error("Trying to run Resource Selection on an Empty Population.");
+        return Collection();
+      }
+
+      // Gather the task scores of living organisms into a task-major matrix.
+      emp::vector<size_t> org_ids;
+      for (size_t org_id = 0; org_id < select_pop.GetSize(); ++org_id) {
+        if (!select_pop.IsEmpty(org_id)) org_ids.push_back(org_id);
+      }
+      const size_t num_orgs = org_ids.size();
+      const size_t num_tasks = task_set.CountValues(select_pop[org_ids[0]].GetDataMap());
+      if (pools.GetSize() != num_tasks) pools.Setup(num_tasks, init_amount, inflow, outflow);
+      scores.resize(num_tasks * num_orgs);
+      bonuses.resize(num_tasks * num_orgs);
+      emp::vector<double> org_scores;
+      for (size_t i = 0; i < num_orgs; ++i) {
+        task_set.GetValues(select_pop[org_ids[i]].GetDataMap(), org_scores);
+        emp_assert(org_scores.size() == num_tasks, org_scores.size(), num_tasks);
+        for (size_t task = 0; task < num_tasks; ++task) scores[task * num_orgs + i] = org_scores[task];
+      }
+
+      // Each pool is fed on independently.
+      control.GetThreadPool().ForEach(num_tasks, [&](size_t task) {
+        pools.Consume(task, std::span<const double>(scores.data() + task * num_orgs, num_orgs),
+                      std::span<double>(bonuses.data() + task * num_orgs, num_orgs), params);
+      });
+
+      // Sum the bonuses column by column, then scale base fitness.
+      emp::vector<double> total_bonus(num_orgs, 0.0);
+      for (size_t task = 0; task < num_tasks; ++task) {
+        const double * task_bonus = bonuses.data() + task * num_orgs;
+        for (size_t i = 0; i < num_orgs; ++i) total_bonus[i] += task_bonus[i];
+      }
+      auto fit_fun = control.BuildTraitEquation(select_pop, fit_equation);
+      emp::vector<double> fitness(select_pop.GetSize(), 0.0);
+      for (size_t i = 0; i < num_orgs; ++i) {
+        Organism & org = select_pop[org_ids[i]];
+        fitness[org_ids[i]] = fit_fun(org) * std::exp2(total_bonus[i]);
+        fitness_trait(org) = fitness[org_ids[i]];
+      }
+
+      // Run all tournaments before any births, since offspring may replace later parents.
+      emp::Random & random = control.GetRandom();
+      emp::vector<OrgPosition> parents(num_births);
+      for (OrgPosition & ppos : parents) {
+        size_t best_id = select_pop.GetRandomLivingPos(random);
+        for (size_t test = 1; test < tourny_size; ++test) {
+          const size_t test_id = select_pop.GetRandomLivingPos(random);
+          if (fitness[test_id] > fitness[best_id]) best_id = test_id;
+        }
+        ppos = OrgPosition(select_pop, best_id);
+      }
+      return control.DoBirthsBuildFirst(parents, [](size_t){}, birth_pop);
+    }
+
+  public:
+    SelectResource(mabe::MABE & control,
+                   const emp::String & name="SelectResource",
+                   const emp::String & desc="Tournament selection with fitness bonuses from limited resources.")
+      : Module(control, name, desc)
+    {
+      SetSelectMod(true);              ///< Mark this module as a selection module.
+    }
+    ~SelectResource() { }
+
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction(
+        "SELECT",
+        [](SelectResource & mod, Population & from, Population & to, double count) {
+          return mod.Select(from,to,count);
+        },
+        "Perform resource-limited tournament selection on the provided organisms.");
+      info.AddMemberFunction(
+        "RESET_RESOURCES",
+        [](SelectResource & mod) { mod.pools.Setup(0, 0.0, 0.0, 0.0); return 0; },
+        "Refill all resource pools to their initial amount before the next selection.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(fit_equation, "fitness_fun", "Trait equation that produces the base fitness to use");
+      LinkVar(task_inputs, "task_traits", "Which traits provide task scores? (one resource per value)");
+      LinkVar(tourny_size, "tournament_size", "Number of orgs in each tournament");
+      LinkVar(init_amount, "init_amount", "Starting amount of each resource");
+      LinkVar(inflow, "inflow", "Amount of each resource added per selection");
+      LinkVar(outflow, "outflow", "Fraction of each resource lost per selection");
+      LinkVar(params.frac, "frac", "Fraction of a resource taken per squared task score");
+      LinkVar(params.max_bonus, "max_bonus", "Largest bonus from one resource (in doublings of fitness)");
+      LinkVar(params.cost, "cost", "Cost of using a resource, removed from each bonus");
+    }
+
+    void SetupModule() override {
+      AddRequiredEquation(fit_equation); ///< The fitness traits must be set by another module.
+      for (const emp::String & name : task_inputs.Slice(",")) {
+        AddRequiredTrait<double, emp::vector<double>>(name, TraitInfo::ANY_COUNT);
+      }
+    }
+
+    void SetupDataMap(emp::DataMap & dmap) override {
+      task_set.SetLayout(dmap.GetLayout()); ///< Give this trait set a layout to optimize.
+      task_set.SetTraits(task_inputs);      ///< Parse set of trait inputs passed in.
+    }
+  };
+
+  MABE_REGISTER_MODULE(SelectResource, "Tournament selection with fitness bonuses from limited resources.");
+}
+
+#endif
@@ -12,6 +12,7 @@
 
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
+#include "../tools/AliasTable.hpp"
 
 #include "emp/datastructs/IndexMap.hpp"
 
@@ -21,6 +22,13 @@ namespace mabe {
   class SelectRoulette : public Module {
   private:
     emp::String fit_equation;    ///< Which equation should we select on?
+    int use_alias = 0;           ///< Draw parents from an alias table rather than an IndexMap?
+
+    /// Is 'name' a double-valued trait of the organisms in 'pop' (rather than an equation)?
+    static bool IsDoubleTrait(const Population & pop, const emp::String & name) {
+      if (!pop.HasDataLayout() || !pop.GetDataLayout().HasName(name)) return false;
+      return pop.GetDataLayout().IsType<double>(pop.GetDataLayout().GetID(name));
+    }
 
     /// Select num_births organisms from select_pop and replicate them into birth_pop
     Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
@@ -29,23 +37,40 @@ namespace mabe {
         return Collection{};
       }
 
-      // Build fitness map using the fitness equation
-      auto fit_fun = control.BuildTraitEquation(select_pop, fit_equation);
+      // Find each position's weight; a plain double trait is gathered directly, skipping the
+      // equation.  Empty positions get a weight of zero.
+      emp::vector<double> weights(select_pop.GetSize(), 0.0);
+      if (IsDoubleTrait(select_pop, fit_equation)) {
+        select_pop.GatherTrait<double>(select_pop.GetDataLayout().GetID(fit_equation), weights);
+      }
+      else {
+        auto fit_fun = control.BuildTraitEquation(select_pop, fit_equation);
+        for (size_t org_pos = 0; org_pos < select_pop.GetSize(); org_pos++) {
+          if (select_pop.IsEmpty(org_pos)) continue;
+          weights[org_pos] = fit_fun(select_pop[org_pos]);
+        }
+      }
+      emp::Random & random = control.GetRandom();
+
+      // Weights are fixed for the whole call, so an alias table gives constant-time draws.
+      if (use_alias) {
+        AliasTable table(weights);
+        if (table.GetWeight() <= 0.0) return Collection{};  // Nothing can be selected.
+        return control.DoBirths(num_births, [&](size_t /*birth_id*/) {
+          return select_pop.IteratorAt(table.Draw(random)).AsPosition();
+        }, birth_pop);
+      }
+
       emp::IndexMap fit_map(select_pop.GetSize(), 0.0);
-      for (size_t org_pos = 0; org_pos < select_pop.GetSize(); org_pos++) {
-        if (select_pop.IsEmpty(org_pos)) continue;
-        fit_map[org_pos] = fit_fun(select_pop[org_pos]);
+      for (size_t org_pos = 0; org_pos < weights.size(); org_pos++) {
+        fit_map[org_pos] = weights[org_pos];
       }
 
       // Loop through picking IDs proportional to fitness_trait, replicating each
-      emp::Random & random = control.GetRandom();
-      Collection placement_list;
-      for (size_t birth_id = 0; birth_id < num_births; birth_id++) {
+      return control.DoBirths(num_births, [&](size_t /*birth_id*/) {
         size_t org_id = fit_map.Index( random.GetDouble(fit_map.GetWeight()) );
-        placement_list += control.Replicate(select_pop.IteratorAt(org_id), birth_pop);
-      }
-
-      return placement_list;
+        return select_pop.IteratorAt(org_id).AsPosition();
+      }, birth_pop);
     }
 
   public:
@@ -72,6 +97,7 @@ namespace mabe {
     // Set up variables for configuration file
     void SetupConfig() override {
       LinkVar(fit_equation, "fitness_fun", "Function used as fitness for selection?");
+      LinkVar(use_alias, "alias", "Use an alias table for constant-time draws? (0=off; 1=on)");
     }
 
     /// Validate fitness equation from configuration file
@@ -0,0 +1,209 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SelectSharded.hpp
+ *  @brief MABE module for tournament or roulette selection over a population split across ranks.
+ *
+ *  In a sharded run, several MABE processes (ranks) run the same configuration, and the
+ *  select_pop on each rank holds one shard of a single logical population.  Each rank evaluates
+ *  only its own organisms, as usual; SELECT then chooses parents from ALL shards for the births
+ *  into this rank's birth_pop, so the run behaves like one population rather than islands.
+ *  Only fitness values and parent genomes cross between ranks (see tools/ShardSelect.hpp):
+ *  tournaments exchange one fitness per contestant, roulette one total weight per rank, and
+ *  each distinct remote parent's genome (its SaveState) is sent once to each rank that chose it.
+ *
+ *  Ranks are connected by MPI when MABE is compiled with MABE_USE_MPI (the driver must call
+ *  MPI_Init and give each rank its own random_seed); otherwise this module runs a single shard,
+ *  and behaves like SelectTournament or SelectRoulette.  Drivers can also connect ranks in other
+ *  ways (e.g., a ThreadShardGroup) with SetComm().
+ *
+ *  SELECT is a collective: every rank must call it the same number of times, in the same
+ *  order.  GLOBAL_SIZE gives the number of living organisms over all shards, so scripts can
+ *  still reason about the logical population as a whole.
+ *
+ *  DEVELOPER NOTES:
+ *  - Offspring of remote parents are born from a temporary copy of the parent, which has no
+ *    position (BeforeRepro and OnOffspringReady receive an invalid OrgPosition), so birth_pop
+ *    should use a placement that does not depend on the parent's position.
+ *  - Only genomes are sent; parent traits are not, so offspring start from default traits.
+ */
+
+#ifndef MABE_SELECT_SHARDED_H
+#define MABE_SELECT_SHARDED_H
+
+#include <sstream>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+#include "../tools/Checkpoint.hpp"
+#include "../tools/ShardSelect.hpp"
+
+namespace mabe {
+
+  class SelectSharded : public Module {
+  private:
+    enum Method { TOURNAMENT=0, ROULETTE };
+
+    emp::String fit_equation;         ///< Trait function that we should select on.
+    int method = TOURNAMENT;          ///< How are parents chosen?
+    size_t tourny_size = 7;           ///< Number of organisms in each tournament.
+
+    emp::Ptr<ShardComm> comm = nullptr;   ///< Link to the other ranks.
+    bool own_comm = false;                ///< Did this module build comm (and must delete it)?
+
+    /// Append the type and genome of an organism to 'out'.
+    bool SaveParent(const Organism & org, std::string & out) {
+      std::ostringstream os;
+      CheckpointWriter writer(os);
+      bool saved = true;
+      writer.Write(org.GetManagerName());
+      writer.WriteBlock([&org,&saved](CheckpointWriter & block){ saved = org.SaveState(block); });
+      if (!saved) {
+        emp::notify::Error("Organism type '", org.GetManagerName(), "' cannot be sent between shards.");
+        return false;
+      }
+      out += os.str();
+      return true;
+    }
+
+    /// Rebuild a parent sent by SaveParent(); nullptr if its type is not known here.
+    emp::Ptr<Organism> LoadParent(const std::string & state) {
+      std::istringstream is(state);
+      CheckpointReader reader(is);
+      const emp::String type_name = reader.Read<emp::String>();
+      const int type_mod = control.GetModuleID(type_name);
+      if (type_mod < 0) {
+        emp::notify::Error("Remote parent has unknown organism type '", type_name, "'.");
+        return nullptr;
+      }
+      emp::Ptr<Organism> org_ptr = control.GetModule(type_mod).Make<Organism>();
+      reader.ReadBlock([org_ptr](CheckpointReader & block){ org_ptr->LoadState(block); });
+      return org_ptr;
+    }
+
+  public:
+    SelectSharded(mabe::MABE & control,
+                  const emp::String & name="SelectSharded",
+                  const emp::String & desc="Module to select parents from a population split across ranks.")
+      : Module(control, name, desc)
+    {
+      SetSelectMod(true);
+    }
+    ~SelectSharded() { if (own_comm) comm.Delete(); }
+
+    /// Use a caller-provided link between ranks (it must outlive this module).
+    void SetComm(ShardComm & in_comm) {
+      if (own_comm) comm.Delete();
+      comm = &in_comm;
+      own_comm = false;
+    }
+
+    ShardComm & GetComm() {
+      if (!comm) {
+#ifdef MABE_USE_MPI
+        comm = emp::NewPtr<MPIShardComm>();
+#else
+        comm = emp::NewPtr<LocalShardComm>();
+#endif
+        own_comm = true;
+      }
+      return *comm;
+    }
+
+    /// Living organisms over all shards (a collective).
+    size_t GetGlobalSize(const Population & pop) {
+      return (size_t) ShardLayout(GetComm(), pop.GetNumOrgs()).GetTotal();
+    }
+
+    Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
+      if (select_pop.GetID() == birth_pop.GetID()) {
+        emp::notify::Error("SelectSharded requires birth_pop and select_pop to be different.");
+        return Collection{};
+      }
+      ShardComm & shard_comm = GetComm();
+
+      // Candidates are this shard's living organisms.
+      const std::span<const size_t> living_span = select_pop.GetLivingPositions();
+      const emp::vector<size_t> living(living_span.begin(), living_span.end());
+      auto fit_fun = control.BuildTraitEquation(select_pop, fit_equation);
+      emp::vector<double> fitness(living.size());
+      for (size_t i = 0; i < living.size(); ++i) fitness[i] = fit_fun(select_pop[living[i]]);
+
+      emp::Random & random = control.GetRandom();
+      const emp::vector<ShardPos> parents = (method == ROULETTE)
+        ? ShardSelect::PickRoulette(shard_comm, fitness, num_births, random)
+        : ShardSelect::PickTournament(shard_comm, fitness, num_births, tourny_size, random);
+
+      bool sent_all = true;
+      const ShardParents fetched = ShardSelect::FetchParents(shard_comm, parents,
+        [&](size_t index, std::string & out){
+          sent_all &= SaveParent(select_pop[living[index]], out);
+        });
+
+      if (parents.size() < num_births) {
+        emp::notify::Error("SelectSharded has no organisms with fitness to select from on any shard.");
+        return Collection{};
+      }
+
+      // Births happen in the order chosen; each distinct remote parent is rebuilt once.
+      emp::vector<emp::Ptr<Organism>> remote(fetched.payloads.size(), nullptr);
+      Collection placed;
+      for (size_t i = 0; i < parents.size(); ++i) {
+        const size_t payload_id = fetched.payload_ids[i];
+        if (payload_id == ShardParents::LOCAL) {
+          const OrgPosition ppos(select_pop, living[parents[i].index]);
+          placed.Insert(control.DoBirth(*ppos, ppos, birth_pop));
+          continue;
+        }
+        if (!remote[payload_id]) remote[payload_id] = LoadParent(fetched.payloads[payload_id]);
+        if (remote[payload_id]) placed.Insert(control.DoBirth(*remote[payload_id], OrgPosition(), birth_pop));
+      }
+      for (emp::Ptr<Organism> org_ptr : remote) if (org_ptr) org_ptr.Delete();
+      if (!sent_all) emp::notify::Warning("Some parents could not be sent to other shards.");
+
+      return placed;
+    }
+
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction(
+        "SELECT",
+        [](SelectSharded & mod, Population & from, Population & to, double count) {
+          return mod.Select(from, to, (size_t) count);
+        },
+        "Choose 'count' parents from all shards of 'from' and give birth to their offspring in 'to'.");
+      info.AddMemberFunction(
+        "GLOBAL_SIZE",
+        [](SelectSharded & mod, Population & pop) { return mod.GetGlobalSize(pop); },
+        "Number of living organisms in a population, summed over all shards.");
+      info.AddMemberFunction(
+        "RANK",
+        [](SelectSharded & mod) { return mod.GetComm().GetRank(); },
+        "Which shard is this process (0 to NUM_RANKS-1)?");
+      info.AddMemberFunction(
+        "NUM_RANKS",
+        [](SelectSharded & mod) { return mod.GetComm().GetNumRanks(); },
+        "Number of shards the population is split across.");
+    }
+
+    void SetupConfig() override {
+      LinkVar(fit_equation, "fitness_fun", "Function used as fitness for selection?");
+      LinkMenu(method, "method", "How should parents be chosen from all shards?",
+               TOURNAMENT, "tournament", "Best of 'tournament_size' random organisms from any shard.",
+               ROULETTE,   "roulette",   "Random organisms with odds proportional to fitness.");
+      LinkVar(tourny_size, "tournament_size", "Number of organisms in each tournament.");
+    }
+
+    void SetupModule() override {
+      AddRequiredEquation(fit_equation);   // The fitness traits must be set by another module
+      if (method == TOURNAMENT && tourny_size == 0) {
+        emp::notify::Error("Module '", GetName(), "' needs a tournament_size of at least one.");
+      }
+    }
+  };
+
+  MABE_REGISTER_MODULE(SelectSharded, "Tournament or roulette selection over a population split across ranks.");
+}
+
+#endif
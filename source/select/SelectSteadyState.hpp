@@ -0,0 +1,290 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SelectSteadyState.hpp
+ *  @brief MABE module for steady-state evolution with incrementally maintained statistics.
+ *
+ *  Rather than replacing a whole generation per update, STEP(pop, count) runs 'count'
+ *  individual births: each parent wins a tournament in the population, and its offspring is
+ *  placed by the population's own placement module (e.g., RandomReplacement), so each birth
+ *  replaces one individual.  STEP returns only the organisms born since the previous STEP,
+ *  so the config only needs to evaluate those.  For example:
+ *
+ *    @UPDATE(Var ud) {
+ *      OrgList new_orgs = steady.STEP(main_pop, 100);
+ *      eval_nk.EVAL(new_orgs);
+ *      PRINT("mean=", steady.MEAN("fitness"), " max=", steady.MAX("fitness"));
+ *    }
+ *
+ *  Statistics (MEAN, MIN, MAX, and MODE) are kept for each configured trait equation as
+ *  organisms arrive (OnPlacement) and leave (BeforeDeath), rather than by scanning the whole
+ *  population.  A newborn's value is read the first time a statistic is requested after its
+ *  birth (i.e., after it has been evaluated), and that same value is removed when it dies, so
+ *  values are assumed not to change after an organism's first evaluation.  Each event costs
+ *  O(log D) for D distinct values; MODE rescans distinct values only after the mode shrinks.
+ */
+
+#ifndef MABE_SELECT_STEADY_STATE_H
+#define MABE_SELECT_STEADY_STATE_H
+
+#include <functional>
+#include <map>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+#include "emp/bits/BitVector.hpp"
+
+namespace mabe {
+
+  class SelectSteadyState : public Module {
+  private:
+    /// Incrementally maintained statistics for one trait equation.
+    struct TraitStats {
+      emp::String equation;                  ///< Trait equation being summarized.
+      std::function<double(const Organism &)> fun;  ///< Compiled equation (built on first use).
+      emp::vector<double> recorded;          ///< Value counted for each position.
+      std::map<double, size_t> counts;       ///< Number of organisms with each value.
+      double total = 0.0;
+      double mode_value = 0.0;
+      size_t mode_count = 0;
+      bool mode_dirty = false;               ///< Did the mode's count drop since last computed?
+
+      void Add(size_t pos, double value) {
+        recorded[pos] = value;
+        total += value;
+        const size_t count = ++counts[value];
+        if (count > mode_count && !mode_dirty) { mode_value = value; mode_count = count; }
+      }
+
+      void Remove(size_t pos) {
+        const double value = recorded[pos];
+        total -= value;
+        auto it = counts.find(value);
+        emp_assert(it != counts.end(), value);
+        if (--it->second == 0) counts.erase(it);
+        if (value == mode_value) mode_dirty = true;
+      }
+
+      void Clear() { counts.clear(); total = 0.0; mode_count = 0; mode_dirty = false; }
+
+      double GetMode() {
+        if (mode_dirty) {
+          mode_count = 0;
+          for (auto [value, count] : counts) {
+            if (count > mode_count) { mode_value = value; mode_count = count; }
+          }
+          mode_dirty = false;
+        }
+        return mode_count ? mode_value : 0.0;
+      }
+    };
+
+    int target_pop_id = 0;            ///< Population whose statistics we track.
+    emp::String fit_equation = "fitness";  ///< Trait equation used for tournaments.
+    size_t tourny_size = 2;           ///< Number of organisms in each tournament.
+    emp::String stats_traits = "fitness";  ///< Comma-separated trait equations to summarize.
+
+    emp::vector<TraitStats> stats;
+    emp::BitVector counted;           ///< Which positions have values in the statistics?
+    emp::BitVector pending;           ///< Which positions hold organisms without values yet?
+    emp::BitVector listed;            ///< Which positions are already in pending_list?
+    emp::vector<size_t> pending_list; ///< Pending positions, in order of arrival.
+    size_t num_counted = 0;
+
+    Population & GetTargetPop() { return control.GetPopulation(target_pop_id); }
+
+    void Resize(size_t pop_size) {
+      if (counted.GetSize() >= pop_size) return;
+      counted.Resize(pop_size);
+      pending.Resize(pop_size);
+      listed.Resize(pop_size);
+      for (TraitStats & trait : stats) trait.recorded.resize(pop_size, 0.0);
+    }
+
+    /// Record the values of all organisms that arrived since the last request.
+    void Flush() {
+      if (pending_list.size() == 0) return;
+      Population & pop = GetTargetPop();
+      for (TraitStats & trait : stats) {
+        if (!trait.fun) trait.fun = control.BuildTraitEquation(pop, trait.equation);
+      }
+      for (size_t pos : pending_list) {
+        listed.Clear(pos);
+        if (!pending.Has(pos)) continue;   // Died before it was counted.
+        pending.Clear(pos);
+        if (pop.IsEmpty(pos)) continue;
+        for (TraitStats & trait : stats) trait.Add(pos, trait.fun(pop[pos]));
+        counted.Set(pos);
+        ++num_counted;
+      }
+      pending_list.resize(0);
+    }
+
+    void Forget(size_t pos) {
+      if (pos >= counted.GetSize()) return;
+      pending.Clear(pos);
+      if (!counted.Has(pos)) return;
+      for (TraitStats & trait : stats) trait.Remove(pos);
+      counted.Clear(pos);
+      --num_counted;
+    }
+
+    void MarkPending(size_t pos) {
+      Resize(pos + 1);
+      Forget(pos);
+      pending.Set(pos);
+      if (!listed.Has(pos)) { listed.Set(pos); pending_list.push_back(pos); }
+    }
+
+    /// Drop all statistics and treat every living organism in the target as new.
+    void Reset() {
+      for (TraitStats & trait : stats) trait.Clear();
+      counted.Clear();
+      pending.Clear();
+      listed.Clear();
+      pending_list.resize(0);
+      num_counted = 0;
+      Population & pop = GetTargetPop();
+      Resize(pop.GetSize());
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        if (pop.IsOccupied(pos)) MarkPending(pos);
+      }
+    }
+
+    TraitStats & GetStats(emp::String equation) {
+      emp::remove_whitespace(equation);
+      for (TraitStats & trait : stats) if (trait.equation == equation) return trait;
+      emp::notify::Error("Module '", GetName(), "' does not track '", equation,
+                         "'; add it to stats_traits.");
+      return stats[0];
+    }
+
+  public:
+    SelectSteadyState(mabe::MABE & control,
+                      const emp::String & name="SelectSteadyState",
+                      const emp::String & desc="Steady-state births with incrementally tracked statistics.")
+      : Module(control, name, desc)
+    {
+      SetSelectMod(true);              ///< Mark this module as a selection module.
+    }
+    ~SelectSteadyState() { }
+
+    // Setup member functions associated with this class.
+    static void InitType(emplode::TypeInfo & info) {
+      info.AddMemberFunction("STEP",
+        [](SelectSteadyState & mod, Population & pop, double count) { return mod.Step(pop, (size_t) count); },
+        "Run 'count' individual births; return the organisms born since the previous STEP.");
+      info.AddMemberFunction("MEAN",
+        [](SelectSteadyState & mod, const emp::String & trait) { return mod.GetMean(trait); },
+        "Mean value of a tracked trait equation.");
+      info.AddMemberFunction("MIN",
+        [](SelectSteadyState & mod, const emp::String & trait) { return mod.GetMin(trait); },
+        "Minimum value of a tracked trait equation.");
+      info.AddMemberFunction("MAX",
+        [](SelectSteadyState & mod, const emp::String & trait) { return mod.GetMax(trait); },
+        "Maximum value of a tracked trait equation.");
+      info.AddMemberFunction("MODE",
+        [](SelectSteadyState & mod, const emp::String & trait) { return mod.GetMode(trait); },
+        "Most common value of a tracked trait equation.");
+    }
+
+    void SetupConfig() override {
+      LinkPop(target_pop_id, "target_pop", "Population to track statistics for.");
+      LinkVar(fit_equation, "fitness_fun", "Trait equation that produces fitness value to use");
+      LinkVar(tourny_size, "tournament_size", "Number of orgs in each tournament");
+      LinkVar(stats_traits, "stats_traits", "Comma-separated trait equations to keep statistics for.");
+    }
+
+    void SetupModule() override {
+      emp::remove_whitespace(stats_traits);
+      for (const emp::String & equation : emp::slice(stats_traits, ',')) {
+        if (equation.size()) stats.push_back(TraitStats{equation});
+      }
+      if (stats.size() == 0) {
+        emp::notify::Error("Module '", GetName(), "' needs at least one trait in stats_traits.");
+        stats.push_back(TraitStats{fit_equation});
+      }
+      if (tourny_size == 0) tourny_size = 1;
+      Reset();
+    }
+
+    /// Run 'num_births' tournament births within 'pop'; return all organisms born since the
+    /// previous call that are still alive.
+    Collection Step(Population & pop, size_t num_births) {
+      if (pop.GetNumOrgs() == 0) {
+        emp::notify::Error("Trying to run steady-state births on an empty population.");
+        return Collection();
+      }
+
+      Flush();                         // Previous newborns have been evaluated by now.
+      emp::Random & random = control.GetRandom();
+      auto fit_fun = control.BuildTraitEquation(pop, fit_equation);
+      for (size_t birth = 0; birth < num_births; ++birth) {
+        size_t best_id = pop.GetRandomLivingPos(random);
+        double best_fit = fit_fun(pop[best_id]);
+        for (size_t test = 1; test < tourny_size; ++test) {
+          const size_t test_id = pop.GetRandomLivingPos(random);
+          const double test_fit = fit_fun(pop[test_id]);
+          if (test_fit > best_fit) { best_id = test_id; best_fit = test_fit; }
+        }
+        control.DoBirth(pop[best_id], pop.IteratorAt(best_id), pop);
+      }
+
+      // Newborns (in the target population) are exactly those pending a first reading.
+      Collection newborns;
+      if (pop.GetID() != target_pop_id) return newborns;
+      for (size_t pos : pending_list) {
+        if (pending.Has(pos) && pop.IsOccupied(pos)) newborns.Insert(pop.IteratorAt(pos));
+      }
+      return newborns;
+    }
+
+    double GetMean(const emp::String & trait) {
+      Flush();
+      return num_counted ? GetStats(trait).total / (double) num_counted : 0.0;
+    }
+    double GetMin(const emp::String & trait) {
+      Flush();
+      TraitStats & trait_stats = GetStats(trait);
+      return trait_stats.counts.size() ? trait_stats.counts.begin()->first : 0.0;
+    }
+    double GetMax(const emp::String & trait) {
+      Flush();
+      TraitStats & trait_stats = GetStats(trait);
+      return trait_stats.counts.size() ? trait_stats.counts.rbegin()->first : 0.0;
+    }
+    double GetMode(const emp::String & trait) {
+      Flush();
+      return GetStats(trait).GetMode();
+    }
+
+    void OnPlacement(OrgPosition pos) override {
+      if (pos.PopID() == target_pop_id) MarkPending(pos.Pos());
+    }
+
+    void BeforeDeath(OrgPosition pos) override {
+      if (pos.PopID() == target_pop_id) Forget(pos.Pos());
+    }
+
+    void OnSwap(OrgPosition pos1, OrgPosition pos2) override {
+      // Organisms that moved are re-read at their new positions.
+      if (pos1.PopID() == target_pop_id) MarkPending(pos1.Pos());
+      if (pos2.PopID() == target_pop_id) MarkPending(pos2.Pos());
+    }
+
+    void OnPopResize(Population & pop, size_t /*old_size*/) override {
+      if (pop.GetID() == target_pop_id) Resize(pop.GetSize());
+    }
+
+    void OnPopSwap(Population & pop1, Population & pop2) override {
+      if (pop1.GetID() == target_pop_id || pop2.GetID() == target_pop_id) Reset();
+    }
+  };
+
+  MABE_REGISTER_MODULE(SelectSteadyState, "Steady-state births with incrementally maintained trait statistics.");
+}
+
+#endif
@@ -12,6 +12,7 @@
 
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
+#include "../tools/RandomBuffer.hpp"
 
 namespace mabe {
 
@@ -20,11 +21,23 @@ namespace mabe {
   private:
     emp::String fit_equation;  ///< Trait function that we should select on
     size_t tourny_size;        ///< Number of organisms in each tournament
+    int birth_streams = 0;     ///< Give each birth its own random stream (allows threading)?
+    int buffered_random = 0;   ///< Draw contestants from a RandomBuffer rather than emp::Random?
+    int recombine = 0;         ///< Build each offspring from two tournament winners?
+
+    static constexpr size_t BIRTH_SALT = 0x7012a;  ///< Random-stream key for per-birth streams.
+    size_t module_id = 0;      ///< ID of this module, so its birth streams are its own.
 
     Collection Select(Population & select_pop, Population & birth_pop, size_t num_births) {
-      emp::Random & random = control.GetRandom();
-      const size_t N = select_pop.GetSize();
+      if (!buffered_random) return Select(select_pop, birth_pop, num_births, control.GetRandom());
+      RandomBuffer random(control.GetRandom());
+      return Select(select_pop, birth_pop, num_births, random);
+    }
 
+    /// Run all tournaments, drawing contestants from 'random' (emp::Random or RandomBuffer).
+    template <typename RANDOM_T>
+    Collection Select(Population & select_pop, Population & birth_pop, size_t num_births,
+                      RANDOM_T & random) {
       if (select_pop.GetNumOrgs() == 0) {
         emp::notify::Error("Trying to run Tournament Selection on an Empty Population.");
         return Collection();
@@ -33,32 +46,70 @@ namespace mabe {
       // Setup the fitness function - redo this each time in case it changes.
       auto fit_fun = control.BuildTraitEquation(select_pop, fit_equation);
 
-      // Track where all organisms are placed.
-      Collection placement_list;
-
-      // Loop through each round of tournament selection.
-      for (size_t round = 0; round < num_births; round++) {
-        // Find a random organism in the population and call it "best"
-        size_t best_id = random.GetUInt(N);
-        while (select_pop[best_id].IsEmpty()) best_id = random.GetUInt(N); // @CAO: better way for sparse pop?
-        double best_fit = fit_fun(select_pop[best_id]);
-
-        // Loop through other organisms for the rest of the tournament size, and pick best.
-        for (size_t test=1; test < tourny_size; test++) {
-          size_t test_id = random.GetUInt(N);
-          while (select_pop[test_id].IsEmpty()) test_id = random.GetUInt(N);
-          double test_fit = fit_fun(select_pop[test_id]);          
-          if (test_fit > best_fit) {
-            best_id = test_id;
-            best_fit = test_fit;
-          }
+      // With recombination, run two tournaments per offspring; no offspring is placed until
+      // all parents are chosen, so the fitness equation can be applied as contestants are drawn.
+      if (recombine) {
+        emp::vector<OrgPosition> parents(2 * num_births);
+        for (OrgPosition & ppos : parents) {
+          ppos = OrgPosition(select_pop, RunTournament(select_pop, random,
+                               [&](size_t org_id){ return fit_fun(select_pop[org_id]); }));
         }
+        return control.DoPairedBirths(parents, birth_pop);
+      }
+
+      // If births go into the population being selected from, fitnesses can change as we go;
+      // evaluate each contestant when it is drawn.
+      if (select_pop.GetID() == birth_pop.GetID()) {
+        return control.DoBirths(num_births, [&](size_t /*round*/) {
+          return RunTournament(select_pop, random,
+                               [&](size_t org_id){ return fit_fun(select_pop[org_id]); });
+        }, birth_pop);
+      }
 
-        // Replicate the organism that did best in this tournament.
-        placement_list += control.Replicate(select_pop.IteratorAt(best_id), birth_pop, 1);
+      // Otherwise evaluate the fitness equation once per living organism up front.
+      emp::vector<double> fitness(select_pop.GetSize(), 0.0);
+      for (size_t org_id = 0; org_id < select_pop.GetSize(); ++org_id) {
+        if (!select_pop.IsEmpty(org_id)) fitness[org_id] = fit_fun(select_pop[org_id]);
       }
+      auto get_fit = [&fitness](size_t org_id){ return fitness[org_id]; };
+
+      // With per-birth random streams, all tournaments can be run up front (in parallel if
+      // num_threads > 1); births then happen in order.
+      if (birth_streams) {
+        emp::vector<OrgPosition> parents(num_births);
+        const RandomStreams streams = control.GetRandomStreams();
+        const size_t update = control.GetUpdate();
+        const size_t call_id = control.NextStreamCall();
+        control.GetThreadPool().ForEach(num_births, [&](size_t birth_id) {
+          emp::Random birth_random = streams.Make(update, module_id, call_id, select_pop.GetID(), birth_id, BIRTH_SALT);
+          parents[birth_id] = OrgPosition(select_pop, RunTournament(select_pop, birth_random, get_fit));
+        });
+        return control.DoBirths(parents, birth_pop);
+      }
+
+      // Run each round of tournament selection, replicating the winner; track all placements.
+      return control.DoBirths(num_births, [&](size_t /*round*/) {
+        return select_pop.IteratorAt(RunTournament(select_pop, random, get_fit)).AsPosition();
+      }, birth_pop);
+    }
 
-      return placement_list;
+    /// Run one tournament and return the position of the winner; get_fit(pos) gives fitness.
+    template <typename RANDOM_T, typename FIT_T>
+    size_t RunTournament(const Population & select_pop, RANDOM_T & random, FIT_T && get_fit) const {
+      // Find a random organism in the population and call it "best"
+      size_t best_id = select_pop.GetRandomLivingPos(random);
+      double best_fit = get_fit(best_id);
+
+      // Loop through other organisms for the rest of the tournament size, and pick best.
+      for (size_t test=1; test < tourny_size; test++) {
+        size_t test_id = select_pop.GetRandomLivingPos(random);
+        double test_fit = get_fit(test_id);
+        if (test_fit > best_fit) {
+          best_id = test_id;
+          best_fit = test_fit;
+        }
+      }
+      return best_id;
     }
 
   public:
@@ -87,9 +138,16 @@ namespace mabe {
     void SetupConfig() override {
       LinkVar(tourny_size, "tournament_size", "Number of orgs in each tournament");
       LinkVar(fit_equation, "fitness_fun", "Trait equation that produces fitness value to use");
+      LinkVar(birth_streams, "birth_streams",
+              "Use a separate random stream per birth so tournaments can run in parallel? (0=off; 1=on)");
+      LinkVar(buffered_random, "buffered_random",
+              "Draw contestants from a block-generated random buffer? (faster; changes random sequence)");
+      LinkVar(recombine, "recombine",
+              "Build each offspring by recombining two tournament winners? (0=off; 1=on)");
     }
 
     void SetupModule() override {
+      module_id = (size_t) control.GetModuleID(GetName());
       AddRequiredEquation(fit_equation); ///< The fitness traits must be set by another module.
     }
 
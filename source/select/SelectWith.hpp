@@ -10,13 +10,20 @@
  *  module and whenever it triggers a reproduction event, this module will select the
  *  corresponding organism position in a population that it is managing to replicate
  *  as well.
- * 
- *  STATUS: Under development.
+ *
+ *  Births from tracked_select_pop into tracked_birth_pop are logged as they are placed (as
+ *  pairs of positions in a buffer reserved up front).  At the start of the next update the
+ *  log is replayed: each logged parent position in select_pop reproduces into birth_pop.  By
+ *  default all offspring are placed with one bulk DoBirths() call, using birth_pop's own
+ *  placement; with keep_positions set, each offspring instead goes to the same position its
+ *  counterpart did.  Either way, the paired population costs no selection of its own.
  */
 
 #ifndef MABE_SELECT_WITH_H
 #define MABE_SELECT_WITH_H
 
+#include <cstdint>
+
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 
@@ -27,15 +34,20 @@ namespace mabe {
   private:
     /// A record of a replication event by the monitored module.
     struct ReproRecord {
-      size_t parent_pos;     // Population position of parent organism.
-      size_t offspring_pos;  // Population position where offspring placed.
+      uint32_t parent_pos;     // Population position of parent organism.
+      uint32_t offspring_pos;  // Population position where offspring placed.
     };
 
     emp::vector<ReproRecord> record;    ///< Set of reproduce events to replicate in this module.
+    emp::vector<OrgPosition> parents;   ///< Scratch space for replaying the record in bulk.
+    bool replaying = false;             ///< Are we placing our own offspring right now?
 
     int tracked_module_id = -1;         ///< Module that we are linked to.
+    int tracked_select_pop_id = 0;      ///< Population the tracked module selects parents from.
+    int tracked_birth_pop_id = 1;       ///< Population the tracked module places births into.
     int parent_pop_id = 0;              ///< Which population are we taking parents from?
     int offspring_pop_id = 1;           ///< Which population should births go into?
+    int keep_positions = 0;             ///< Place offspring at the same positions as tracked ones?
 
   public:
     SelectWith(mabe::MABE & control,
@@ -49,35 +61,65 @@ namespace mabe {
 
     void SetupConfig() override {
       LinkModule(tracked_module_id, "tracked_module", "Which module should we parallel?");
+      LinkPop(tracked_select_pop_id, "tracked_select_pop", "Population the tracked module selects from.");
+      LinkPop(tracked_birth_pop_id, "tracked_birth_pop", "Population the tracked module places births in.");
       LinkPop(parent_pop_id, "select_pop", "Which population should we select parents from?");
       LinkPop(offspring_pop_id, "birth_pop", "Which population should births go into?");
+      LinkVar(keep_positions, "keep_positions",
+              "Place each offspring at the position used by the tracked birth? (0=off; 1=on)");
     }
 
     void SetupModule() override {
-      // No traits are required for this module.
+      // No traits are required for this module; reserve room for a full generation of births.
+      const size_t capacity = std::max(control.GetPopulation(tracked_select_pop_id).GetSize(),
+                                       control.GetPopulation(tracked_birth_pop_id).GetSize());
+      record.reserve(capacity);
+      parents.reserve(capacity);
     }
 
-    void OnUpdate(size_t update) override {
+    void OnUpdate(size_t /*update*/) override {
+      if (record.size() == 0) return;
       Population & parent_pop = control.GetPopulation(parent_pop_id);
       Population & offspring_pop = control.GetPopulation(offspring_pop_id);
 
-      // Loop through all replication events and trigger the corresponding event.
-      for (auto repro_event : record) {
-        control.DoBirth(
-          parent_pop[repro_event.parent_pos],
-          parent_pop.IteratorAt(repro_event.parent_pos),
-          offspring_pop.IteratorAt(repro_event.offspring_pos)
-        );
+      replaying = true;
+      if (keep_positions) {
+        // Replay each birth into the same position its counterpart went.
+        for (const ReproRecord & repro_event : record) {
+          if (repro_event.parent_pos >= parent_pop.GetSize() ||
+              parent_pop.IsEmpty(repro_event.parent_pos) ||
+              repro_event.offspring_pos >= offspring_pop.GetSize()) continue;
+          control.DoBirth(
+            parent_pop[repro_event.parent_pos],
+            parent_pop.IteratorAt(repro_event.parent_pos),
+            offspring_pop.IteratorAt(repro_event.offspring_pos)
+          );
+        }
+      }
+      else {
+        // Replay all births as one bulk operation, letting birth_pop decide placement.
+        parents.resize(0);
+        for (const ReproRecord & repro_event : record) {
+          if (repro_event.parent_pos >= parent_pop.GetSize() ||
+              parent_pop.IsEmpty(repro_event.parent_pos)) continue;
+          parents.push_back(parent_pop.IteratorAt(repro_event.parent_pos));
+        }
+        control.DoBirths(std::span<const OrgPosition>(parents.data(), parents.size()), offspring_pop);
       }
+      replaying = false;
+      record.resize(0);                  // Keep the capacity for the next update.
     }
 
+    /// Log births by the tracked module (parent in its select pop, offspring in its birth pop).
     void BeforePlacement(Organism &, OrgPosition to_pos, OrgPosition from_pos) override {
-      // @CAO need to record events to duplicate the replications later in the up date.
+      if (replaying || !from_pos.IsValid()) return;
+      if (from_pos.PopID() != tracked_select_pop_id || to_pos.PopID() != tracked_birth_pop_id) return;
+      record.push_back({ (uint32_t) from_pos.Pos(), (uint32_t) to_pos.Pos() });
     }
 
   };
 
-  MABE_REGISTER_MODULE(SelectWith, "Choose the top fitness organisms for replication.");
+  MABE_REGISTER_MODULE(SelectWith, "Mirror the births of another selection module in a paired population.");
 }
 
 #endif
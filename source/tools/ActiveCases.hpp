@@ -0,0 +1,86 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ActiveCases.hpp
+ *  @brief A named set of test cases in use this update, shared by selectors and evaluators.
+ *
+ *  Down-sampled selection (e.g., SelectLexicase with sample_traits) only looks at some test
+ *  cases each update.  An ActiveCases object lets an evaluator know which ones, so it can
+ *  skip the others: the selector publishes its sample size, and both modules then call
+ *  GetSample() with the same update to get the same sorted list of case IDs.
+ *
+ *  The sample depends only on the run's base seed, the update, and the name of the case set,
+ *  so it needs no communication between modules and is identical across threads and restarts.
+ *  With no sample size set (or one at least as large as the number of cases), all cases are
+ *  active.
+ */
+
+#ifndef MABE_TOOLS_ACTIVE_CASES_H
+#define MABE_TOOLS_ACTIVE_CASES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "emp/base/vector.hpp"
+
+#include "RandomStreams.hpp"
+
+namespace mabe {
+
+  class ActiveCases {
+  private:
+    static constexpr uint64_t SAMPLE_SALT = 0xac7ca5e5;
+
+    uint64_t name_key = 0;      ///< Key derived from this case set's name.
+    size_t sample_size = 0;     ///< Number of cases active each update (0 = all).
+
+  public:
+    /// FNV-1a hash, so a case set's key does not depend on the standard library in use.
+    static constexpr uint64_t CalcNameKey(std::string_view name) {
+      uint64_t key = 0xcbf29ce484222325ULL;
+      for (char c : name) key = (key ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+      return key;
+    }
+
+    /// Sorted IDs of 'sample_size' distinct cases in [0, num_cases), chosen by 'seed_key'.
+    static emp::vector<size_t> CalcSample(uint64_t seed_key, size_t num_cases, size_t sample_size) {
+      emp::vector<size_t> ids(num_cases);
+      for (size_t i = 0; i < num_cases; ++i) ids[i] = i;
+      if (sample_size >= num_cases) return ids;
+
+      // Partial Fisher-Yates shuffle: only the first sample_size positions are needed.
+      uint64_t state = seed_key;
+      for (size_t i = 0; i < sample_size; ++i) {
+        state = RandomStreams::Mix(state);
+        const size_t pick = i + static_cast<size_t>(state % (num_cases - i));
+        std::swap(ids[i], ids[pick]);
+      }
+      ids.resize(sample_size);
+      std::sort(ids.begin(), ids.end());
+      return ids;
+    }
+
+    ActiveCases(const std::string & name="") : name_key(CalcNameKey(name)) { }
+
+    size_t GetSampleSize() const { return sample_size; }
+    void SetSampleSize(size_t in_size) { sample_size = in_size; }
+
+    /// Are only some of 'num_cases' cases active?
+    bool IsSampling(size_t num_cases) const {
+      return sample_size > 0 && sample_size < num_cases;
+    }
+
+    /// Sorted IDs of the cases active during 'update' (all of them, if not sampling).
+    emp::vector<size_t> GetSample(const RandomStreams & streams, size_t update, size_t num_cases) const {
+      if (!IsSampling(num_cases)) return CalcSample(0, num_cases, num_cases);
+      return CalcSample(streams.CalcKey(update, name_key, SAMPLE_SALT), num_cases, sample_size);
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  AliasTable.hpp
+ *  @brief Constant-time weighted sampling from a fixed set of weights (Vose's alias method).
+ *
+ *  Building the table from N weights takes O(N); each draw then costs one random index and
+ *  one random double, regardless of N.  Use it when many draws are made from the same weights
+ *  (e.g., a whole generation of roulette selection); when weights change between draws, an
+ *  emp::IndexMap is a better fit.
+ *
+ *  Zero (or negative) weights are never drawn.  If all weights are zero, Draw() is not valid.
+ */
+
+#ifndef MABE_TOOLS_ALIAS_TABLE_H
+#define MABE_TOOLS_ALIAS_TABLE_H
+
+#include <cstdint>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+namespace mabe {
+
+  class AliasTable {
+  private:
+    emp::vector<double> prob;   ///< Chance of keeping bucket i (rather than moving to its alias).
+    emp::vector<size_t> alias;  ///< Where a draw from bucket i goes if not kept.
+    double total_weight = 0.0;
+
+  public:
+    AliasTable() = default;
+    AliasTable(const emp::vector<double> & weights) { Build(weights); }
+
+    size_t GetSize() const { return prob.size(); }
+    double GetWeight() const { return total_weight; }
+
+    /// Rebuild the table for a new set of weights.
+    void Build(const emp::vector<double> & weights) {
+      const size_t N = weights.size();
+      prob.resize(N);
+      alias.resize(N);
+      total_weight = 0.0;
+      for (double w : weights) if (w > 0.0) total_weight += w;
+      if (total_weight <= 0.0) return;
+
+      // Scale weights so that the average bucket is 1.0, then split buckets into those that
+      // are under-full (small) and over-full (large).
+      emp::vector<size_t> small, large;
+      small.reserve(N);
+      large.reserve(N);
+      const double scale = (double) N / total_weight;
+      for (size_t i = 0; i < N; ++i) {
+        prob[i] = (weights[i] > 0.0) ? weights[i] * scale : 0.0;
+        alias[i] = i;
+        if (prob[i] < 1.0) small.push_back(i);
+        else large.push_back(i);
+      }
+
+      // Top off each small bucket from a large one.
+      while (small.size() && large.size()) {
+        const size_t s = small.back(); small.pop_back();
+        const size_t l = large.back();
+        alias[s] = l;
+        prob[l] -= 1.0 - prob[s];
+        if (prob[l] < 1.0) { large.pop_back(); small.push_back(l); }
+      }
+
+      // Anything left is full (up to rounding error).  Small buckets can only remain due to
+      // rounding, so keep them only if they have weight of their own.
+      for (size_t i : large) prob[i] = 1.0;
+      for (size_t i : small) {
+        if (prob[i] > 0.0) prob[i] = 1.0;
+        else {
+          // A zero-weight bucket with no partner; send it to any bucket with weight.
+          prob[i] = 0.0;
+          for (size_t j = 0; j < N; ++j) if (weights[j] > 0.0) { alias[i] = j; break; }
+        }
+      }
+    }
+
+    /// Draw an index with probability proportional to its weight.  RANDOM_T may be
+    /// emp::Random or RandomBuffer.
+    template <typename RANDOM_T=emp::Random>
+    size_t Draw(RANDOM_T & random) const {
+      emp_assert(total_weight > 0.0, "Cannot draw from an AliasTable without positive weights.");
+      const size_t bucket = random.GetUInt(prob.size());
+      return (random.GetDouble() < prob[bucket]) ? bucket : alias[bucket];
+    }
+  };
+
+}
+
+#endif
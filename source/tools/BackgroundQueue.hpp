@@ -0,0 +1,129 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BackgroundQueue.hpp
+ *  @brief Run jobs one at a time, in the order given, on a background thread.
+ *
+ *  The worker thread is started with the first job and stays alive until Stop() is called
+ *  or the queue is destroyed, either of which waits for all jobs to finish.  Because jobs run in order on a single
+ *  thread, each one can append to the same output file without locking.
+ *
+ *  DEVELOPER NOTES:
+ *  - If a job throws, later jobs still run; the first exception is rethrown by Wait().
+ *  - When EMP_TRACK_MEM is defined, emp::Ptr tracking is not thread safe, so jobs are run
+ *    immediately on the submitting thread.
+ */
+
+#ifndef MABE_TOOLS_BACKGROUND_QUEUE_H
+#define MABE_TOOLS_BACKGROUND_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace mabe {
+
+  class BackgroundQueue {
+  public:
+    using job_t = std::function<void()>;
+
+  private:
+    std::thread worker;
+    std::mutex queue_mutex;
+    std::condition_variable job_cv;      ///< Wakes the worker when a job arrives.
+    std::condition_variable done_cv;     ///< Wakes Wait() when a job finishes.
+    std::deque<job_t> jobs;
+    size_t num_running = 0;              ///< 1 while the worker is inside a job.
+    size_t num_done = 0;
+    bool stopping = false;
+    std::exception_ptr job_error = nullptr;
+
+    void RunJob(const job_t & job) {
+      try { job(); }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!job_error) job_error = std::current_exception();
+      }
+    }
+
+    void WorkerLoop() {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      while (true) {
+        job_cv.wait(lock, [this](){ return stopping || jobs.size(); });
+        if (jobs.empty()) return;               // Stopping, and nothing left to do.
+        job_t job = std::move(jobs.front());
+        jobs.pop_front();
+        num_running = 1;
+        lock.unlock();
+        RunJob(job);
+        lock.lock();
+        num_running = 0;
+        ++num_done;
+        done_cv.notify_all();
+      }
+    }
+
+  public:
+    BackgroundQueue() = default;
+    BackgroundQueue(const BackgroundQueue &) = delete;
+    BackgroundQueue & operator=(const BackgroundQueue &) = delete;
+    ~BackgroundQueue() { Stop(); }
+
+    /// Finish all jobs and end the worker thread (e.g., before forking); the next Submit()
+    /// starts a new one.
+    void Stop() {
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+      }
+      job_cv.notify_all();
+      if (worker.joinable()) worker.join();
+      stopping = false;
+    }
+
+    /// Add a job to run after all of those already submitted.
+    void Submit(job_t job) {
+#ifdef EMP_TRACK_MEM
+      RunJob(job);
+      ++num_done;
+#else
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        jobs.push_back(std::move(job));
+        if (!worker.joinable()) worker = std::thread([this](){ WorkerLoop(); });
+      }
+      job_cv.notify_one();
+#endif
+    }
+
+    /// Number of jobs submitted but not yet finished.
+    size_t GetNumPending() {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+      return jobs.size() + num_running;
+    }
+
+    size_t GetNumDone() {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+      return num_done;
+    }
+
+    /// Wait until no more than 'max_pending' jobs are left (by default, until all are done).
+    void Wait(size_t max_pending=0) {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      done_cv.wait(lock, [this, max_pending](){ return jobs.size() + num_running <= max_pending; });
+      if (job_error) {
+        std::exception_ptr error = job_error;
+        job_error = nullptr;
+        std::rethrow_exception(error);
+      }
+    }
+  };
+
+}
+
+#endif
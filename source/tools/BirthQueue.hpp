@@ -0,0 +1,79 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BirthQueue.hpp
+ *  @brief A lock-free queue that many threads can add births to, drained in a fixed order.
+ *
+ *  Worker threads Push() records, each with an order key (such as the parent's position);
+ *  a single controller thread later calls Drain(), which hands back every record sorted by
+ *  key.  Records with equal keys keep the order in which their (single) producer pushed
+ *  them, so if each key is only pushed from one thread at a time, the drained order does not
+ *  depend on the number of threads or how they were scheduled.
+ *
+ *  Push() is a single compare-and-swap onto a linked stack, so producers never block each
+ *  other.  Drain() may run while other threads push; records pushed after it starts are
+ *  left for the next Drain().
+ */
+
+#ifndef MABE_TOOLS_BIRTH_QUEUE_H
+#define MABE_TOOLS_BIRTH_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  template <typename T>
+  class BirthQueue {
+  private:
+    struct Node {
+      uint64_t order;
+      T value;
+      Node * next;
+    };
+
+    // Raw pointers, since nodes are linked through a std::atomic.
+    std::atomic<Node *> head{nullptr};
+
+  public:
+    BirthQueue() = default;
+    BirthQueue(const BirthQueue &) = delete;
+    BirthQueue & operator=(const BirthQueue &) = delete;
+    ~BirthQueue() { Drain([](T &){ }); }
+
+    bool IsEmpty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+    /// Add a record; safe to call from any number of threads at once.
+    void Push(uint64_t order, T value) {
+      Node * node = new Node{order, std::move(value), head.load(std::memory_order_relaxed)};
+      while (!head.compare_exchange_weak(node->next, node,
+                                         std::memory_order_release, std::memory_order_relaxed)) { }
+    }
+
+    /// Remove all records, calling fun(value) on each in order of key; return the count.
+    /// Only one thread may drain at a time.
+    template <typename FUN_T>
+    size_t Drain(FUN_T && fun) {
+      emp::vector<Node *> nodes;
+      for (Node * node = head.exchange(nullptr, std::memory_order_acquire); node; node = node->next) {
+        nodes.push_back(node);
+      }
+      std::reverse(nodes.begin(), nodes.end());   // The stack is newest-first.
+      std::stable_sort(nodes.begin(), nodes.end(),
+                       [](Node * a, Node * b){ return a->order < b->order; });
+      for (Node * node : nodes) {
+        fun(node->value);
+        delete node;
+      }
+      return nodes.size();
+    }
+  };
+
+}
+
+#endif
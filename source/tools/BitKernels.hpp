@@ -0,0 +1,148 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BitKernels.hpp
+ *  @brief Word-at-a-time scans over bit sequences used by the bitstring evaluators.
+ *
+ *  Each function reads its BitVector arguments 64 bits at a time, so a full word of ones is
+ *  accepted with a single compare and differences are counted with one popcount per word.
+ *  None of them allocate; in particular, the Hamming distance does not build the XOR of its
+ *  inputs as a temporary BitVector.
+ *
+ *  ForEachRun() steps over runs of equal bits rather than single bits, finding the end of
+ *  each run with countr_zero / countr_one; CountPackages() uses it to count packed runs of
+ *  ones (see EvalPacking) with work proportional to the number of runs.
+ */
+
+#ifndef MABE_TOOLS_BIT_KERNELS_H
+#define MABE_TOOLS_BIT_KERNELS_H
+
+#include <bit>
+#include <cstdint>
+
+#include "emp/base/assert.hpp"
+#include "emp/bits/BitVector.hpp"
+
+namespace mabe {
+
+  namespace bit_kernels {
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr uint64_t ALL_ONES = ~uint64_t{0};
+
+    inline size_t NumWords(const emp::BitVector & bits) {
+      return (bits.size() + WORD_BITS - 1) / WORD_BITS;
+    }
+  }
+
+  /// Count the number of consecutive ones at the start of 'bits'.
+  inline size_t CountLeadingOnes(const emp::BitVector & bits) {
+    const size_t num_words = bit_kernels::NumWords(bits);
+    for (size_t word_id = 0; word_id < num_words; ++word_id) {
+      const uint64_t word = bits.GetUInt64(word_id);
+      if (word != bit_kernels::ALL_ONES) {
+        const size_t count = word_id * bit_kernels::WORD_BITS + std::countr_one(word);
+        return (count < bits.size()) ? count : bits.size();
+      }
+    }
+    return bits.size();
+  }
+
+  /// Count the positions at which 'bits1' and 'bits2' differ; both must be the same size.
+  inline size_t CountMismatches(const emp::BitVector & bits1, const emp::BitVector & bits2) {
+    emp_assert(bits1.size() == bits2.size(), bits1.size(), bits2.size());
+    const size_t num_words = bit_kernels::NumWords(bits1);
+    size_t count = 0;
+    for (size_t word_id = 0; word_id < num_words; ++word_id) {
+      count += std::popcount(bits1.GetUInt64(word_id) ^ bits2.GetUInt64(word_id));
+    }
+    return count;
+  }
+
+  /// Count the positions at which 'bits1' and 'bits2' hold the same value.
+  inline size_t CountMatches(const emp::BitVector & bits1, const emp::BitVector & bits2) {
+    return bits1.size() - CountMismatches(bits1, bits2);
+  }
+
+  /// Call fun(bit, start, length) for each maximal run of equal bits, in order.
+  template <typename FUN_T>
+  void ForEachRun(const emp::BitVector & bits, FUN_T && fun) {
+    const size_t size = bits.size();
+    size_t start = 0;
+    while (start < size) {
+      const bool bit = bits.Get(start);
+      size_t end = start;
+      while (end < size) {
+        const size_t offset = end % bit_kernels::WORD_BITS;
+        uint64_t word = bits.GetUInt64(end / bit_kernels::WORD_BITS) >> offset;
+        if (bit) word = ~word;      // Bits that continue the run are now zeros.
+        const size_t count = (size_t) std::countr_zero(word);
+        const size_t remaining = bit_kernels::WORD_BITS - offset;
+        if (count < remaining) { end += count; break; }
+        end += remaining;           // The run continues into the next word.
+      }
+      if (end > size) end = size;
+      fun(bit, start, end - start);
+      start = end;
+    }
+  }
+
+  /// Count packages of exactly 'num_ones' ones, each with at least 'num_zeros' zeros on both
+  /// sides (or the end of the sequence); neighboring packages may share padding.  Gives the
+  /// same result as EvalPacking's bit-by-bit scan, but steps through whole runs of bits.
+  inline size_t CountPackages(const emp::BitVector & bits, size_t num_zeros, size_t num_ones) {
+    if (bits.size() == 0 || num_ones == 0) return 0;   // Empty packages never complete.
+
+    // Status: 0 = in front padding, 1 = in a package (or waiting for one), 2 = back padding.
+    size_t status = bits.Get(0) ? 1 : 0;
+    size_t zeros = 0;   // Padding zeros so far (status 0 or 2).
+    size_t ones = 0;    // Package ones so far (status 1).
+    size_t count = 0;
+    ForEachRun(bits, [&](bool bit, size_t start, size_t length) {
+      if (num_zeros == 0) {             // No padding: packages are any num_ones ones in a row.
+        if (status == 0) status = bit ? 0 : 1;
+        else if (bit) {
+          count += (ones + length) / num_ones;
+          ones = (ones + length) % num_ones;
+        }
+        else if (ones) {                // Partial package; a second zero starts a new one.
+          ones = 0;
+          status = (length > 1) ? 1 : 0;
+        }
+        return;
+      }
+
+      if (status == 1) {
+        if (bit) {
+          if (ones + length < num_ones) { ones += length; return; }
+          const bool exact = (ones + length == num_ones);
+          ones = 0;
+          zeros = 0;
+          if (!exact) status = 0;                               // Too many ones.
+          else if (start + length == bits.size()) ++count;      // Ends at the end of the bits.
+          else status = 2;
+        }
+        else if (ones) {                // Partial package; the rest of the zeros are padding.
+          ones = 0;
+          status = 0;
+          zeros = 0;
+          if (length - 1 >= num_zeros) status = 1;
+          else zeros = length - 1;
+        }
+        return;
+      }
+
+      // Padding (status 0 or 2).
+      if (bit) { status = 0; zeros = 0; return; }
+      if (zeros + length < num_zeros) { zeros += length; return; }
+      if (status == 2) ++count;         // Back padding complete; it also pads the next package.
+      status = 1;
+      zeros = 0;
+    });
+    return count;
+  }
+
+}
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Checkpoint.hpp
+ *  @brief Compact binary streams for saving and restoring run state.
+ *
+ *  CheckpointWriter and CheckpointReader move values to and from a binary stream with no
+ *  per-value framing.  Supported types are arithmetic types and enums (stored as their raw
+ *  bytes), strings, emp::BitVector (packed into bytes), and emp::vector of any supported type
+ *  (length-prefixed).  Use IsCheckpointType<T>() to test support at compile time.
+ *
+ *  Values must be read back in exactly the order they were written; a block written by one
+ *  component can be wrapped with WriteBlock() / ReadBlock() so that readers that do not know
+ *  how to interpret it can skip it.
+ *
+ *  DEVELOPER NOTES:
+ *  - Raw bytes are host-endian; checkpoints are meant to be restored on the same platform.
+ */
+
+#ifndef MABE_TOOLS_CHECKPOINT_H
+#define MABE_TOOLS_CHECKPOINT_H
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/tools/String.hpp"
+
+namespace mabe {
+
+  template <typename T> struct is_checkpoint_vector : std::false_type { };
+  template <typename T> struct is_checkpoint_vector<emp::vector<T>> : std::true_type { };
+
+  /// Can values of type T be written to (and read from) a checkpoint?
+  template <typename T>
+  constexpr bool IsCheckpointType() {
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) return true;
+    else if constexpr (std::is_same_v<T, emp::String> || std::is_same_v<T, std::string>) return true;
+    else if constexpr (std::is_same_v<T, emp::BitVector>) return true;
+    else if constexpr (is_checkpoint_vector<T>::value) {
+      return IsCheckpointType<typename T::value_type>();
+    }
+    else return false;
+  }
+
+  class CheckpointWriter {
+  private:
+    std::ostream & os;
+
+  public:
+    CheckpointWriter(std::ostream & in_os) : os(in_os) { }
+
+    bool IsOK() const { return (bool) os; }
+
+    void WriteBytes(const void * data, size_t num_bytes) {
+      os.write(static_cast<const char *>(data), (std::streamsize) num_bytes);
+    }
+
+    template <typename T>
+    void Write(const T & value) {
+      static_assert(IsCheckpointType<T>(), "Type cannot be written to a checkpoint.");
+      if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) WriteBytes(&value, sizeof(T));
+      else if constexpr (std::is_same_v<T, emp::String> || std::is_same_v<T, std::string>) {
+        Write<uint64_t>(value.size());
+        WriteBytes(value.data(), value.size());
+      }
+      else if constexpr (std::is_same_v<T, emp::BitVector>) {
+        const size_t num_bits = value.GetSize();
+        Write<uint64_t>(num_bits);
+        for (size_t start = 0; start < num_bits; start += 8) {
+          uint8_t byte = 0;
+          for (size_t i = 0; i < 8 && start + i < num_bits; ++i) {
+            if (value.Get(start + i)) byte |= (uint8_t) (1 << i);
+          }
+          Write(byte);
+        }
+      }
+      else {  // emp::vector
+        Write<uint64_t>(value.size());
+        using elem_t = typename T::value_type;
+        if constexpr (std::is_arithmetic_v<elem_t> && !std::is_same_v<elem_t, bool>) {
+          WriteBytes(value.data(), value.size() * sizeof(elem_t));
+        }
+        else for (const auto & x : value) Write<elem_t>(x);
+      }
+    }
+
+    /// Write a set of values produced by 'fun' (which is given a writer for the block) as a
+    /// single length-prefixed block.
+    template <typename FUN_T>
+    void WriteBlock(FUN_T && fun) {
+      std::ostringstream block_os(std::ios::binary);
+      CheckpointWriter block(block_os);
+      fun(block);
+      Write<std::string>(block_os.str());
+    }
+  };
+
+  class CheckpointReader {
+  private:
+    std::istream & is;
+
+  public:
+    CheckpointReader(std::istream & in_is) : is(in_is) { }
+
+    bool IsOK() const { return (bool) is; }
+
+    void ReadBytes(void * data, size_t num_bytes) {
+      is.read(static_cast<char *>(data), (std::streamsize) num_bytes);
+    }
+
+    template <typename T>
+    void Read(T & value) {
+      static_assert(IsCheckpointType<T>(), "Type cannot be read from a checkpoint.");
+      if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) ReadBytes(&value, sizeof(T));
+      else if constexpr (std::is_same_v<T, emp::String> || std::is_same_v<T, std::string>) {
+        const uint64_t size = Read<uint64_t>();
+        if (!is) return;
+        std::string buffer(size, '\0');
+        ReadBytes(buffer.data(), size);
+        value = buffer;
+      }
+      else if constexpr (std::is_same_v<T, emp::BitVector>) {
+        const uint64_t num_bits = Read<uint64_t>();
+        if (!is) return;
+        value.Resize(num_bits);
+        for (size_t start = 0; start < num_bits; start += 8) {
+          const uint8_t byte = Read<uint8_t>();
+          for (size_t i = 0; i < 8 && start + i < num_bits; ++i) {
+            value.Set(start + i, (byte >> i) & 1);
+          }
+        }
+      }
+      else {  // emp::vector
+        const uint64_t size = Read<uint64_t>();
+        if (!is) return;
+        value.resize(size);
+        using elem_t = typename T::value_type;
+        if constexpr (std::is_arithmetic_v<elem_t> && !std::is_same_v<elem_t, bool>) {
+          ReadBytes(value.data(), size * sizeof(elem_t));
+        }
+        else for (size_t i = 0; i < size; ++i) {
+          elem_t x;
+          Read<elem_t>(x);
+          value[i] = x;
+        }
+      }
+    }
+
+    template <typename T>
+    T Read() { T value{}; Read(value); return value; }
+
+    /// Read a block written by WriteBlock() and process it with 'fun' (given a reader).
+    template <typename FUN_T>
+    void ReadBlock(FUN_T && fun) {
+      std::istringstream block_is(Read<std::string>(), std::ios::binary);
+      CheckpointReader block(block_is);
+      fun(block);
+    }
+
+    /// Skip over a block written by WriteBlock().
+    void SkipBlock() {
+      const uint64_t size = Read<uint64_t>();
+      is.ignore((std::streamsize) size);
+    }
+  };
+
+}
+
+#endif
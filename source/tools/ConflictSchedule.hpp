@@ -0,0 +1,82 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ConflictSchedule.hpp
+ *  @brief Group an ordered list of tasks into stages whose members can run concurrently.
+ *
+ *  Tasks are given in their serial order, along with a function that reports whether two
+ *  tasks conflict (e.g., one writes data that the other uses).  Each task is placed in the
+ *  earliest stage that comes after every earlier task it conflicts with, so running the
+ *  stages in order (with all tasks in a stage at once) gives the same result as running the
+ *  tasks serially, as long as non-conflicting tasks really are independent.
+ *
+ *  BuildOptIn() also takes a function reporting whether a task may share a stage at all;
+ *  tasks that have not opted in conflict with everything and always run on their own.
+ */
+
+#ifndef MABE_TOOLS_CONFLICT_SCHEDULE_H
+#define MABE_TOOLS_CONFLICT_SCHEDULE_H
+
+#include <algorithm>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  class ConflictSchedule {
+  private:
+    emp::vector<emp::vector<size_t>> stages;   ///< Task IDs in each stage, in serial order.
+    size_t num_tasks = 0;
+
+  public:
+    ConflictSchedule() = default;
+
+    /// Schedule tasks [0, in_tasks); conflict(a, b) is called with a < b.
+    template <typename CONFLICT_T>
+    void Build(size_t in_tasks, CONFLICT_T && conflict) {
+      num_tasks = in_tasks;
+      stages.resize(0);
+      emp::vector<size_t> stage_of(num_tasks, 0);
+      for (size_t task = 0; task < num_tasks; ++task) {
+        size_t stage = 0;
+        for (size_t prev = 0; prev < task; ++prev) {
+          if (stage_of[prev] >= stage && conflict(prev, task)) stage = stage_of[prev] + 1;
+        }
+        stage_of[task] = stage;
+        if (stage >= stages.size()) stages.resize(stage + 1);
+        stages[stage].push_back(task);
+      }
+    }
+
+    /// As Build(), but only tasks for which can_share(id) is true may run alongside others.
+    template <typename SHARE_T, typename CONFLICT_T>
+    void BuildOptIn(size_t in_tasks, SHARE_T && can_share, CONFLICT_T && conflict) {
+      Build(in_tasks, [&can_share, &conflict](size_t id1, size_t id2) {
+        return !can_share(id1) || !can_share(id2) || conflict(id1, id2);
+      });
+    }
+
+    size_t GetNumTasks() const { return num_tasks; }
+    size_t GetNumStages() const { return stages.size(); }
+    const emp::vector<size_t> & GetStage(size_t id) const {
+      emp_assert(id < stages.size(), id, stages.size());
+      return stages[id];
+    }
+
+    /// Largest number of tasks that will run at once.
+    size_t GetMaxWidth() const {
+      size_t width = 0;
+      for (const auto & stage : stages) width = std::max(width, stage.size());
+      return width;
+    }
+
+    /// Does every task need to run on its own?
+    bool IsSerial() const { return GetMaxWidth() <= 1; }
+  };
+
+}
+
+#endif
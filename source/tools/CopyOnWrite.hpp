@@ -0,0 +1,69 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  CopyOnWrite.hpp
+ *  @brief A value that is shared between copies until one of them needs to change it.
+ *
+ *  Copying a CopyOnWrite object only copies a reference-counted pointer, so clones and
+ *  unmutated offspring share a single genome in memory.  Read access is through Get() (or
+ *  operator* / operator->, which are const); the first call to Modify() on a shared value
+ *  makes a private copy before returning a mutable reference.
+ *
+ *  Reference counts are atomic, so copies may be read and modified from different threads,
+ *  but a single CopyOnWrite object should not be modified by two threads at once.
+ */
+
+#ifndef MABE_TOOLS_COPY_ON_WRITE_H
+#define MABE_TOOLS_COPY_ON_WRITE_H
+
+#include <memory>
+#include <utility>
+
+namespace mabe {
+
+  template <typename T>
+  class CopyOnWrite {
+  private:
+    std::shared_ptr<T> value_ptr;
+
+  public:
+    template <typename... ARGS>
+    CopyOnWrite(ARGS &&... args) : value_ptr(std::make_shared<T>(std::forward<ARGS>(args)...)) { }
+    CopyOnWrite(const CopyOnWrite &) = default;
+    CopyOnWrite(CopyOnWrite &) = default;   // Prevent the variadic constructor from matching.
+    CopyOnWrite(CopyOnWrite &&) = default;
+    CopyOnWrite & operator=(const CopyOnWrite &) = default;
+    CopyOnWrite & operator=(CopyOnWrite &&) = default;
+
+    const T & Get() const { return *value_ptr; }
+    const T & operator*() const { return *value_ptr; }
+    const T * operator->() const { return value_ptr.get(); }
+
+    /// Is this value currently being shared with another copy?
+    bool IsShared() const { return value_ptr.use_count() > 1; }
+
+    /// How many copies share this value (including this one)?
+    size_t GetShareCount() const { return (size_t) value_ptr.use_count(); }
+
+    /// Is this value the same stored copy as in 'other'?
+    bool IsSharedWith(const CopyOnWrite & other) const { return value_ptr == other.value_ptr; }
+
+    /// Get a mutable reference, first making a private copy if the value is shared.
+    T & Modify() {
+      if (IsShared()) value_ptr = std::make_shared<T>(*value_ptr);
+      return *value_ptr;
+    }
+
+    /// Replace the value entirely (never copies the old one).
+    CopyOnWrite & Set(T in_value) {
+      if (IsShared()) value_ptr = std::make_shared<T>(std::move(in_value));
+      else *value_ptr = std::move(in_value);
+      return *this;
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Crossover.hpp
+ *  @brief In-place crossover kernels for recombining two parent genomes.
+ *
+ *  Each kernel overwrites part of 'child' (normally a fresh clone of the first parent) with the
+ *  matching positions of 'other' (the second parent), so an offspring is built without any
+ *  intermediate genome.  Uniform crossover takes each position from either parent with equal
+ *  probability; one-point crossover takes every position from a random point onward from
+ *  'other'; two-point crossover takes the positions between two random points.
+ *
+ *  Bit sequences are combined a 64-bit word at a time as (child & ~mask) | (other & mask),
+ *  with one random word per mask for uniform crossover.  Other genomes are spans of values:
+ *  point crossovers copy a single range, and uniform crossover draws one random word per 64
+ *  values.  If the genomes differ in size, only their common prefix is recombined.
+ */
+
+#ifndef MABE_TOOLS_CROSSOVER_H
+#define MABE_TOOLS_CROSSOVER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "emp/base/assert.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
+
+namespace mabe {
+
+  struct Crossover {
+    enum Type {
+      UNIFORM=0,   // Each position comes from either parent.
+      ONE_POINT,   // Positions from a random point onward come from the second parent.
+      TWO_POINT    // Positions between two random points come from the second parent.
+    };
+
+    /// Choose the range [start, end) of positions that a point crossover takes from 'other'.
+    static std::pair<size_t, size_t> CalcRange(Type type, size_t size, emp::Random & random) {
+      emp_assert(type != UNIFORM);
+      size_t start = random.GetUInt(size + 1);
+      if (type == ONE_POINT) return {start, size};
+      size_t end = random.GetUInt(size + 1);
+      if (end < start) std::swap(start, end);
+      return {start, end};
+    }
+
+    /// Mask of the bits of word 'word_id' that fall in [start, end).
+    static uint64_t CalcRangeMask(size_t word_id, size_t start, size_t end) {
+      const size_t word_start = word_id * 64;
+      if (end <= word_start || start >= word_start + 64) return 0;
+      uint64_t mask = ~uint64_t{0};
+      if (start > word_start) mask &= ~uint64_t{0} << (start - word_start);
+      if (end < word_start + 64) mask &= ~(~uint64_t{0} << (end - word_start));
+      return mask;
+    }
+
+    /// Recombine 'child' with 'other' in place.
+    static void CrossBits(emp::BitVector & child, const emp::BitVector & other, Type type,
+                          emp::Random & random) {
+      const size_t size = std::min(child.size(), other.size());
+      const size_t num_words = (size + 63) / 64;
+      auto cross_word = [&child, &other](size_t word_id, uint64_t mask) {
+        if (!mask) return;
+        const uint64_t word = child.GetUInt64(word_id);
+        child.SetUInt64(word_id, (word & ~mask) | (other.GetUInt64(word_id) & mask));
+      };
+
+      if (type == UNIFORM) {
+        for (size_t word_id = 0; word_id < num_words; ++word_id) {
+          uint64_t mask = random.GetUInt64();
+          if (word_id == num_words - 1) mask &= CalcRangeMask(word_id, 0, size);
+          cross_word(word_id, mask);
+        }
+        return;
+      }
+
+      const auto [start, end] = CalcRange(type, size, random);
+      for (size_t word_id = start / 64; word_id < num_words && word_id * 64 < end; ++word_id) {
+        cross_word(word_id, CalcRangeMask(word_id, start, end));
+      }
+    }
+
+    /// Recombine the values in 'child' with those in 'other' in place.
+    template <typename T>
+    static void CrossSpan(std::span<T> child, std::span<const T> other, Type type,
+                          emp::Random & random) {
+      const size_t size = std::min(child.size(), other.size());
+      if (type == UNIFORM) {
+        for (size_t base = 0; base < size; base += 64) {
+          uint64_t mask = random.GetUInt64();
+          const size_t count = std::min<size_t>(64, size - base);
+          for (size_t i = 0; i < count; ++i, mask >>= 1) {
+            if (mask & 1) child[base + i] = other[base + i];
+          }
+        }
+        return;
+      }
+
+      const auto [start, end] = CalcRange(type, size, random);
+      std::copy(other.begin() + start, other.begin() + end, child.begin() + start);
+    }
+  };
+
+}
+
+#endif
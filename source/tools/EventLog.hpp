@@ -0,0 +1,376 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EventLog.hpp
+ *  @brief A compact binary log of births, deaths, and moves, for replay after a run.
+ *
+ *  Each EventRecord notes the update, the kind of event, the position it happened at, a
+ *  second position (the parent of a birth, or the other side of a swap), and the genome ID of
+ *  a new organism (see tools/GenomeArchive.hpp).  EventLogWriter collects records into blocks
+ *  of a fixed size; full blocks are encoded and written by a background thread, so logging
+ *  an event costs only a copy into the current block.
+ *
+ *  A log file starts with the 8 bytes "MABEEVT1".  Each block is then a varint record count
+ *  and a varint byte count, followed by the records, each as varints: the update (as a change
+ *  from the previous record), the kind, the population and position, the second population
+ *  and position plus one (0 = none), and the genome ID plus one (0 = none).  Since records
+ *  rarely change update and positions are small, most records take five to eight bytes.
+ *
+ *  EventReplay rebuilds the phylogeny of every organism in a log, which can be written in the
+ *  ALife standard phylogeny format or walked back along a lineage (in order to re-evaluate
+ *  its genomes from an archive) without running the simulation again.
+ */
+
+#ifndef MABE_TOOLS_EVENT_LOG_H
+#define MABE_TOOLS_EVENT_LOG_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  struct EventRecord {
+    static constexpr uint32_t NONE = (uint32_t) -1;     ///< No second position.
+    static constexpr uint64_t NO_GENOME = (uint64_t) -1;
+    enum Kind : uint8_t {
+      INJECT=0,   // An organism was placed without a parent.
+      BIRTH,      // An organism was placed with a parent at 'other'.
+      DEATH,      // The organism at 'pos' was removed.
+      SWAP,       // The organisms at 'pos' and 'other' traded places.
+      POP_SWAP    // All organisms in populations 'pop' and 'other_pop' traded places.
+    };
+
+    uint64_t update = 0;
+    uint64_t genome_id = NO_GENOME;   ///< Genome of a new organism, if known.
+    uint32_t pos = 0;
+    uint32_t other_pos = NONE;
+    uint16_t pop = 0;
+    uint16_t other_pop = 0;
+    Kind kind = INJECT;
+
+    bool operator==(const EventRecord &) const = default;
+  };
+
+  struct EventLog {
+    static constexpr const char * MAGIC = "MABEEVT1";
+
+    static void PutVarint(std::string & out, uint64_t value) {
+      while (value >= 0x80) {
+        out += (char) ((value & 0x7F) | 0x80);
+        value >>= 7;
+      }
+      out += (char) value;
+    }
+
+    static bool GetVarint(const std::string & in, size_t & pos, uint64_t & value) {
+      value = 0;
+      for (size_t shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        const uint8_t byte = (uint8_t) in[pos++];
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+      }
+      return false;
+    }
+
+    static bool GetVarint(std::istream & is, uint64_t & value) {
+      value = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        const int byte = is.get();
+        if (byte == EOF) return false;
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+      }
+      return false;
+    }
+
+    /// Encode one block of records (including its header).
+    static std::string EncodeBlock(const emp::vector<EventRecord> & records) {
+      std::string body;
+      uint64_t prev_update = 0;
+      for (const EventRecord & record : records) {
+        PutVarint(body, record.update - prev_update);
+        prev_update = record.update;
+        body += (char) record.kind;
+        PutVarint(body, record.pop);
+        PutVarint(body, record.pos);
+        const bool has_other = (record.other_pos != EventRecord::NONE);
+        PutVarint(body, has_other ? record.other_pop : 0);
+        PutVarint(body, has_other ? (uint64_t) record.other_pos + 1 : 0);
+        PutVarint(body, record.genome_id + 1);   // NO_GENOME wraps to 0.
+      }
+      std::string block;
+      PutVarint(block, records.size());
+      PutVarint(block, body.size());
+      return block + body;
+    }
+  };
+
+  class EventLogWriter {
+  private:
+    std::ofstream file;
+    size_t block_size = 4096;                  ///< Records per block.
+    emp::vector<EventRecord> block;            ///< Records not yet handed to the writer.
+    std::deque<emp::vector<EventRecord>> queue;   ///< Full blocks waiting to be written.
+    size_t num_events = 0;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;          ///< Signals new blocks, or that the queue emptied.
+    bool busy = false;                         ///< Is the background thread writing a block?
+    bool done = false;
+    std::thread writer_thread;
+
+    void WriteLoop() {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      while (true) {
+        queue_cv.wait(lock, [this](){ return done || queue.size(); });
+        if (queue.empty()) return;             // Done, and nothing left to write.
+        emp::vector<EventRecord> records = std::move(queue.front());
+        queue.pop_front();
+        busy = true;
+        lock.unlock();
+        const std::string encoded = EventLog::EncodeBlock(records);
+        file.write(encoded.data(), (std::streamsize) encoded.size());
+        lock.lock();
+        busy = false;
+        queue_cv.notify_all();
+      }
+    }
+
+    void QueueBlock() {
+      if (block.empty()) return;
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back(std::move(block));
+        if (!writer_thread.joinable()) writer_thread = std::thread([this](){ WriteLoop(); });
+      }
+      queue_cv.notify_all();
+      block = emp::vector<EventRecord>();
+      block.reserve(block_size);
+    }
+
+  public:
+    EventLogWriter() = default;
+    EventLogWriter(const EventLogWriter &) = delete;
+    ~EventLogWriter() { Close(); }
+
+    /// Start a new log; returns false if the file cannot be opened.
+    bool Open(const std::string & filename, size_t in_block_size=4096) {
+      Close();
+      file.open(filename, std::ios::binary);
+      if (!file) return false;
+      file.write(EventLog::MAGIC, 8);
+      block_size = std::max<size_t>(in_block_size, 1);
+      block.reserve(block_size);
+      num_events = 0;
+      done = false;
+      writer_thread = std::thread([this](){ WriteLoop(); });
+      return true;
+    }
+
+    bool IsOpen() const { return file.is_open(); }
+    size_t GetNumEvents() const { return num_events; }
+
+    void Add(const EventRecord & record) {
+      emp_assert(IsOpen());
+      block.push_back(record);
+      ++num_events;
+      if (block.size() >= block_size) QueueBlock();
+    }
+
+    /// Write out every event so far (waiting for the background thread).
+    void Flush() {
+      if (!IsOpen()) return;
+      QueueBlock();
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      queue_cv.wait(lock, [this](){ return queue.empty() && !busy; });
+      file.flush();
+    }
+
+    /// Write out every event so far and end the background thread (e.g., before forking);
+    /// the next full block starts a new one.
+    void Pause() {
+      if (!IsOpen()) return;
+      QueueBlock();
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        done = true;
+      }
+      queue_cv.notify_all();
+      if (writer_thread.joinable()) writer_thread.join();
+      done = false;
+      file.flush();
+    }
+
+    void Close() {
+      if (!IsOpen()) return;
+      Pause();
+      file.close();
+    }
+  };
+
+  class EventLogReader {
+  private:
+    emp::vector<EventRecord> records;
+
+  public:
+    /// Load every record in a log; returns false if it is not a complete event log.
+    bool Load(std::istream & is) {
+      records.resize(0);
+      char magic[8];
+      if (!is.read(magic, 8) || std::string(magic, 8) != EventLog::MAGIC) return false;
+      uint64_t count = 0, num_bytes = 0;
+      while (EventLog::GetVarint(is, count)) {
+        if (!EventLog::GetVarint(is, num_bytes)) return false;
+        std::string body(num_bytes, '\0');
+        if (!is.read(body.data(), (std::streamsize) num_bytes)) return false;
+        size_t pos = 0;
+        uint64_t update = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+          uint64_t fields[6];
+          if (!EventLog::GetVarint(body, pos, fields[0]) || pos >= body.size()) return false;
+          const uint8_t kind = (uint8_t) body[pos++];
+          for (size_t f = 1; f < 6; ++f) {
+            if (!EventLog::GetVarint(body, pos, fields[f])) return false;
+          }
+          EventRecord & record = records.emplace_back();
+          update += fields[0];
+          record.update = update;
+          record.kind = (EventRecord::Kind) kind;
+          record.pop = (uint16_t) fields[1];
+          record.pos = (uint32_t) fields[2];
+          record.other_pop = (uint16_t) fields[3];
+          record.other_pos = fields[4] ? (uint32_t) (fields[4] - 1) : EventRecord::NONE;
+          record.genome_id = fields[5] - 1;
+        }
+      }
+      return true;
+    }
+
+    bool Load(const std::string & filename) {
+      std::ifstream file(filename, std::ios::binary);
+      return file && Load(file);
+    }
+
+    size_t GetSize() const { return records.size(); }
+    const EventRecord & Get(size_t id) const { return records[id]; }
+    const emp::vector<EventRecord> & GetRecords() const { return records; }
+  };
+
+  /// Rebuild organism histories by replaying a log's events in order.
+  class EventReplay {
+  public:
+    static constexpr size_t NO_ORG = (size_t) -1;
+    static constexpr uint64_t ALIVE = (uint64_t) -1;
+
+    struct OrgInfo {
+      size_t parent = NO_ORG;            ///< Replay ID of the parent (NO_ORG if injected).
+      uint64_t genome_id = EventRecord::NO_GENOME;
+      uint64_t birth_update = 0;
+      uint64_t death_update = ALIVE;
+    };
+
+  private:
+    emp::vector<OrgInfo> orgs;                              ///< Indexed by replay ID.
+    std::map<std::pair<uint16_t, uint32_t>, size_t> occupant;   ///< Replay ID at each position.
+
+    size_t Find(uint16_t pop, uint32_t pos) const {
+      auto it = occupant.find({pop, pos});
+      return (it == occupant.end()) ? NO_ORG : it->second;
+    }
+
+    void SetOccupant(uint16_t pop, uint32_t pos, size_t org_id) {
+      if (org_id == NO_ORG) occupant.erase({pop, pos});
+      else occupant[{pop, pos}] = org_id;
+    }
+
+  public:
+    /// Replay one event; organisms get replay IDs in the order they were placed.
+    void Apply(const EventRecord & record) {
+      switch (record.kind) {
+      case EventRecord::INJECT:
+      case EventRecord::BIRTH: {
+        OrgInfo & info = orgs.emplace_back();
+        if (record.kind == EventRecord::BIRTH) info.parent = Find(record.other_pop, record.other_pos);
+        info.genome_id = record.genome_id;
+        info.birth_update = record.update;
+        SetOccupant(record.pop, record.pos, orgs.size() - 1);
+        break;
+      }
+      case EventRecord::DEATH: {
+        const size_t org_id = Find(record.pop, record.pos);
+        if (org_id != NO_ORG) orgs[org_id].death_update = record.update;
+        SetOccupant(record.pop, record.pos, NO_ORG);
+        break;
+      }
+      case EventRecord::SWAP: {
+        const size_t org1 = Find(record.pop, record.pos);
+        const size_t org2 = Find(record.other_pop, record.other_pos);
+        SetOccupant(record.pop, record.pos, org2);
+        SetOccupant(record.other_pop, record.other_pos, org1);
+        break;
+      }
+      case EventRecord::POP_SWAP: {
+        std::map<std::pair<uint16_t, uint32_t>, size_t> swapped;
+        for (const auto & [key, org_id] : occupant) {
+          uint16_t pop = key.first;
+          if (pop == record.pop) pop = record.other_pop;
+          else if (pop == record.other_pop) pop = record.pop;
+          swapped[{pop, key.second}] = org_id;
+        }
+        occupant = std::move(swapped);
+        break;
+      }
+      }
+    }
+
+    void Apply(const EventLogReader & log) {
+      for (const EventRecord & record : log.GetRecords()) Apply(record);
+    }
+
+    size_t GetNumOrgs() const { return orgs.size(); }
+    const OrgInfo & GetOrg(size_t org_id) const { return orgs[org_id]; }
+
+    /// Replay ID of the organism now at a position (NO_ORG if empty).
+    size_t GetOccupant(uint16_t pop, uint32_t pos) const { return Find(pop, pos); }
+
+    /// Replay IDs from 'org_id' back to its injected ancestor.
+    emp::vector<size_t> GetLineage(size_t org_id) const {
+      emp::vector<size_t> lineage;
+      for (; org_id != NO_ORG; org_id = orgs[org_id].parent) lineage.push_back(org_id);
+      return lineage;
+    }
+
+    /// Write every organism in the ALife standard phylogeny format (CSV).
+    void WritePhylogeny(std::ostream & os) const {
+      os << "id,ancestor_list,origin_time,destruction_time,genome_id\n";
+      for (size_t org_id = 0; org_id < orgs.size(); ++org_id) {
+        const OrgInfo & info = orgs[org_id];
+        os << org_id << ",[";
+        if (info.parent == NO_ORG) os << "none";
+        else os << info.parent;
+        os << "]," << info.birth_update << ",";
+        if (info.death_update == ALIVE) os << "inf";
+        else os << info.death_update;
+        os << ",";
+        if (info.genome_id != EventRecord::NO_GENOME) os << info.genome_id;
+        os << "\n";
+      }
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  FitnessCutoff.hpp
+ *  @brief A fitness level below which an organism's exact score no longer matters.
+ *
+ *  Bounded evaluation lets an evaluator stop early on organisms that cannot be selected.  As
+ *  it progresses, the evaluator calls CanStop() with an upper bound on the organism's final
+ *  fitness; if that bound is below the cutoff, the rest of the evaluation can be skipped.
+ *  Completed fitnesses are passed to Report().
+ *
+ *  The cutoff is the larger of two values:
+ *  - 'min_fitness', a fixed level (such as a selection threshold); and
+ *  - with 'keep_top' > 0, the worst of the keep_top best fitnesses reported since Reset().
+ *    Set keep_top to an elite selector's top_count and organisms that could not make the
+ *    elite are not finished.
+ *
+ *  Report() and CanStop() may be called from several threads at once.
+ *
+ *  DEVELOPER NOTES:
+ *  - Which organisms stop early depends on the order results are reported, so with threads
+ *    it can vary between runs; the organisms at or above the final cutoff never stop early.
+ */
+
+#ifndef MABE_TOOLS_FITNESS_CUTOFF_H
+#define MABE_TOOLS_FITNESS_CUTOFF_H
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace mabe {
+
+  class FitnessCutoff {
+  private:
+    static constexpr double NONE = std::numeric_limits<double>::lowest();
+
+    double min_fitness = NONE;             ///< Fixed cutoff.
+    size_t keep_top = 0;                   ///< Number of best results to keep exact (0 = none).
+    std::priority_queue<double, std::vector<double>, std::greater<double>> top;  ///< Best so far.
+    std::atomic<double> cutoff{NONE};      ///< Current cutoff, for lock-free reads.
+    std::atomic<size_t> num_stopped{0};    ///< Evaluations allowed to stop early.
+    std::mutex top_mutex;
+
+  public:
+    FitnessCutoff() = default;
+    FitnessCutoff(double in_min, size_t in_top=0) { Setup(in_min, in_top); }
+
+    /// Change the cutoff rules; this also clears any reported results.
+    void Setup(double in_min, size_t in_top=0) {
+      min_fitness = in_min;
+      keep_top = in_top;
+      Reset();
+    }
+
+    /// Forget all reported results (e.g., at the start of evaluating a new collection).
+    void Reset() {
+      std::lock_guard<std::mutex> lock(top_mutex);
+      top = {};
+      cutoff = min_fitness;
+    }
+
+    bool IsActive() const { return keep_top > 0 || min_fitness != NONE; }
+    double GetCutoff() const { return cutoff.load(std::memory_order_relaxed); }
+    size_t GetNumStopped() const { return num_stopped; }
+
+    /// Can an evaluation stop now, given that its final fitness will be at most 'upper_bound'?
+    bool CanStop(double upper_bound) {
+      if (upper_bound >= GetCutoff()) return false;
+      ++num_stopped;
+      return true;
+    }
+
+    /// Record the fitness of a completed evaluation.
+    void Report(double fitness) {
+      if (keep_top == 0) return;
+      std::lock_guard<std::mutex> lock(top_mutex);
+      if (top.size() < keep_top) top.push(fitness);
+      else if (fitness > top.top()) { top.pop(); top.push(fitness); }
+      else return;
+      if (top.size() == keep_top) cutoff = std::max(min_fitness, top.top());
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GenomeArchive.hpp
+ *  @brief A compact binary file of genomes, each stored as a delta from its parent genome.
+ *
+ *  GenomeArchiveWriter assigns genomes consecutive IDs (starting at 0) in the order they are
+ *  added and appends one record per genome.  A record is the parent's ID plus one (0 = no
+ *  parent) as a varint, then one of three encodings of the genome text, whichever is smallest:
+ *
+ *    FULL   : varint length, then the genome bytes.
+ *    EDITS  : (same length as parent) varint count, then per edit a varint gap from the end
+ *             of the previous edit and the replacement byte.  Covers point mutations.
+ *    SPLICE : varint lengths of the prefix and suffix shared with the parent, then a varint
+ *             length and bytes for the middle.  Covers an insertion or deletion.
+ *
+ *  The file starts with the 8 bytes "MABEGARC" and a varint format version.  All integers are
+ *  unsigned LEB128 varints, so files are portable across platforms.
+ *
+ *  A parent always has a smaller ID than its offspring, so GenomeArchiveReader can rebuild
+ *  every genome in a single pass.
+ */
+
+#ifndef MABE_TOOLS_GENOME_ARCHIVE_H
+#define MABE_TOOLS_GENOME_ARCHIVE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  struct GenomeArchive {
+    static constexpr const char * MAGIC = "MABEGARC";
+    static constexpr uint64_t VERSION = 1;
+    static constexpr size_t NO_PARENT = (size_t) -1;
+    enum Encoding : uint8_t { FULL=0, EDITS, SPLICE };
+
+    static void PutVarint(std::string & out, uint64_t value) {
+      while (value >= 0x80) {
+        out += (char) ((value & 0x7f) | 0x80);
+        value >>= 7;
+      }
+      out += (char) value;
+    }
+
+    static bool GetVarint(std::istream & is, uint64_t & value) {
+      value = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        const int byte = is.get();
+        if (byte == EOF) return false;
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+      }
+      return false;
+    }
+
+    /// Encode 'genome' (kind byte plus payload) as compactly as possible relative to 'parent'.
+    static std::string Encode(const std::string & genome, const std::string * parent) {
+      std::string best;
+      best += (char) FULL;
+      PutVarint(best, genome.size());
+      best += genome;
+      if (!parent) return best;
+
+      // Same length: list the changed positions.  Stop once the list is no smaller than the
+      // best so far; the (then incomplete) candidate is never chosen.
+      if (parent->size() == genome.size()) {
+        std::string edits;
+        size_t count = 0, next_pos = 0;
+        for (size_t pos = 0; pos < genome.size() && edits.size() < best.size(); ++pos) {
+          if (genome[pos] == (*parent)[pos]) continue;
+          PutVarint(edits, pos - next_pos);
+          edits += genome[pos];
+          next_pos = pos + 1;
+          ++count;
+        }
+        std::string candidate;
+        candidate += (char) EDITS;
+        PutVarint(candidate, count);
+        candidate += edits;
+        if (candidate.size() < best.size()) best = std::move(candidate);
+      }
+
+      // Any lengths: keep the shared prefix and suffix, replace the middle.
+      const size_t max_shared = std::min(genome.size(), parent->size());
+      size_t prefix = 0;
+      while (prefix < max_shared && genome[prefix] == (*parent)[prefix]) ++prefix;
+      size_t suffix = 0;
+      while (suffix < max_shared - prefix &&
+             genome[genome.size() - 1 - suffix] == (*parent)[parent->size() - 1 - suffix]) ++suffix;
+      std::string candidate;
+      candidate += (char) SPLICE;
+      PutVarint(candidate, prefix);
+      PutVarint(candidate, suffix);
+      PutVarint(candidate, genome.size() - prefix - suffix);
+      candidate.append(genome, prefix, genome.size() - prefix - suffix);
+      if (candidate.size() < best.size()) best = std::move(candidate);
+
+      return best;
+    }
+  };
+
+  class GenomeArchiveWriter {
+  private:
+    std::ostream & os;
+    size_t num_genomes = 0;
+    size_t num_bytes = 0;          ///< Bytes written, including the header.
+
+  public:
+    GenomeArchiveWriter(std::ostream & in_os) : os(in_os) {
+      std::string header(GenomeArchive::MAGIC);
+      GenomeArchive::PutVarint(header, GenomeArchive::VERSION);
+      os.write(header.data(), (std::streamsize) header.size());
+      num_bytes = header.size();
+    }
+
+    bool IsOK() const { return (bool) os; }
+    size_t GetNumGenomes() const { return num_genomes; }
+    size_t GetNumBytes() const { return num_bytes; }
+
+    /// Append a genome and return its new ID.  If 'parent_id' is not NO_PARENT, 'parent' must
+    /// be the genome that was added with that ID.
+    size_t Add(const std::string & genome,
+               size_t parent_id=GenomeArchive::NO_PARENT, const std::string * parent=nullptr) {
+      emp_assert(parent_id == GenomeArchive::NO_PARENT || parent_id < num_genomes, parent_id);
+      if (parent_id == GenomeArchive::NO_PARENT) parent = nullptr;
+      std::string record;
+      GenomeArchive::PutVarint(record, (parent_id == GenomeArchive::NO_PARENT) ? 0 : parent_id + 1);
+      record += GenomeArchive::Encode(genome, parent);
+      os.write(record.data(), (std::streamsize) record.size());
+      num_bytes += record.size();
+      return num_genomes++;
+    }
+
+    void Flush() { os.flush(); }
+  };
+
+  class GenomeArchiveReader {
+  private:
+    emp::vector<std::string> genomes;
+    emp::vector<size_t> parents;
+
+    static bool ReadBytes(std::istream & is, std::string & out, uint64_t count) {
+      const size_t start = out.size();
+      out.resize(start + count);
+      return (bool) is.read(out.data() + start, (std::streamsize) count);
+    }
+
+  public:
+    size_t GetSize() const { return genomes.size(); }
+    const std::string & GetGenome(size_t id) const { return genomes[id]; }
+    size_t GetParent(size_t id) const { return parents[id]; }
+
+    /// Load a whole archive; returns false if the stream is not a valid archive.
+    bool Load(std::istream & is) {
+      genomes.resize(0);
+      parents.resize(0);
+      char magic[8];
+      uint64_t version = 0;
+      if (!is.read(magic, 8) || std::string(magic, 8) != GenomeArchive::MAGIC) return false;
+      if (!GenomeArchive::GetVarint(is, version) || version != GenomeArchive::VERSION) return false;
+
+      uint64_t parent_code = 0;
+      while (GenomeArchive::GetVarint(is, parent_code)) {
+        if (parent_code > genomes.size()) return false;
+        const size_t parent_id = parent_code ? parent_code - 1 : GenomeArchive::NO_PARENT;
+        const int kind = is.get();
+        if (kind == EOF || (kind != GenomeArchive::FULL && parent_code == 0)) return false;
+
+        std::string genome;
+        uint64_t a = 0, b = 0, c = 0;
+        if (kind == GenomeArchive::FULL) {
+          if (!GenomeArchive::GetVarint(is, a) || !ReadBytes(is, genome, a)) return false;
+        } else if (kind == GenomeArchive::EDITS) {
+          genome = genomes[parent_id];
+          if (!GenomeArchive::GetVarint(is, a)) return false;
+          size_t pos = 0;
+          for (uint64_t i = 0; i < a; ++i) {
+            const int byte = GenomeArchive::GetVarint(is, b) ? is.get() : EOF;
+            pos += b;
+            if (byte == EOF || pos >= genome.size()) return false;
+            genome[pos++] = (char) byte;
+          }
+        } else if (kind == GenomeArchive::SPLICE) {
+          const std::string & parent = genomes[parent_id];
+          if (!GenomeArchive::GetVarint(is, a) || !GenomeArchive::GetVarint(is, b) ||
+              !GenomeArchive::GetVarint(is, c) || a + b > parent.size()) return false;
+          genome.assign(parent, 0, a);
+          if (!ReadBytes(is, genome, c)) return false;
+          genome.append(parent, parent.size() - b, b);
+        } else return false;
+
+        genomes.push_back(std::move(genome));
+        parents.push_back(parent_id);
+      }
+      return true;
+    }
+  };
+
+}
+
+#endif
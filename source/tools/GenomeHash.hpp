@@ -0,0 +1,106 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GenomeHash.hpp
+ *  @brief A fast 64-bit genome fingerprint that can be updated as individual sites change.
+ *
+ *  A genome is viewed as a series of 64-bit site values (one per element, or one per 64-bit
+ *  word of a bit string).  Its hash is the sum of a wyhash-style multiply-fold of each
+ *  (position, value) pair, plus a term for the number of sites.  Since terms are independent,
+ *  the loop has no carried dependency beyond the sum (so it pipelines and vectorizes), and
+ *  changing one site only requires Update() rather than rehashing the whole genome.
+ *
+ *  DEVELOPER NOTES:
+ *  - Hashes are fingerprints, not cryptographic; they are only meant to be used within one
+ *    build (values may differ between platforms).
+ */
+
+#ifndef MABE_TOOLS_GENOME_HASH_H
+#define MABE_TOOLS_GENOME_HASH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "emp/bits/BitVector.hpp"
+
+namespace mabe {
+
+  struct GenomeHash {
+    static constexpr uint64_t SITE_KEY = 0xa0761d6478bd642full;   // wyhash secrets
+    static constexpr uint64_t VALUE_KEY = 0xe7037ed1a0b428dbull;
+    static constexpr uint64_t SIZE_SITE = ~0ull;                  ///< Site used for the length.
+    static constexpr uint64_t UNIT_SIZE_SITE = ~0ull - 1;         ///< Site used for bit/byte length.
+
+    /// Multiply and fold the high bits into the low bits.
+    static constexpr uint64_t MulFold(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+      const __uint128_t product = (__uint128_t) a * b;
+      return (uint64_t) product ^ (uint64_t) (product >> 64);
+#else
+      uint64_t x = a * b + (a ^ (b >> 29));     // SplitMix64-style fallback.
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      return x ^ (x >> 31);
+#endif
+    }
+
+    /// Contribution of a single site to the hash.
+    static constexpr uint64_t Site(uint64_t site, uint64_t value) {
+      return MulFold(site ^ SITE_KEY, value ^ VALUE_KEY);
+    }
+
+    /// Adjust 'hash' for the site at 'site' changing from 'old_value' to 'new_value'.
+    static constexpr uint64_t Update(uint64_t hash, uint64_t site, uint64_t old_value, uint64_t new_value) {
+      return hash - Site(site, old_value) + Site(site, new_value);
+    }
+
+    /// Raw bits of a value of up to 64 bits, as a site value.
+    template <typename T>
+    static uint64_t ToSite(const T & value) {
+      static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t));
+      uint64_t out = 0;
+      std::memcpy(&out, &value, sizeof(T));
+      return out;
+    }
+
+    /// Hash 'count' sites, where get_site(i) returns the value of site i.
+    template <typename FUN_T>
+    static uint64_t Calc(size_t count, FUN_T && get_site) {
+      uint64_t hash = Site(SIZE_SITE, count);
+      for (size_t i = 0; i < count; ++i) hash += Site(i, get_site(i));
+      return hash;
+    }
+
+    /// Hash a span of values; each value is one site.
+    template <typename T>
+    static uint64_t CalcValues(std::span<const T> values) {
+      return Calc(values.size(), [values](size_t i){ return ToSite(values[i]); });
+    }
+
+    /// Hash a bit string; each 64-bit word is one site.
+    static uint64_t CalcBits(const emp::BitVector & bits) {
+      return Site(UNIT_SIZE_SITE, bits.size()) +
+        Calc((bits.size() + 63) / 64, [&bits](size_t i){ return bits.GetUInt64(i); });
+    }
+
+    /// Hash raw bytes; each (zero-padded) group of eight bytes is one site.
+    static uint64_t CalcBytes(std::string_view bytes) {
+      return Site(UNIT_SIZE_SITE, bytes.size()) +
+        Calc((bytes.size() + 7) / 8, [bytes](size_t i){
+          uint64_t value = 0;
+          const size_t start = i * 8;
+          std::memcpy(&value, bytes.data() + start, std::min<size_t>(8, bytes.size() - start));
+          return value;
+        });
+    }
+  };
+
+}
+
+#endif
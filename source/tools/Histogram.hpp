@@ -0,0 +1,101 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Histogram.hpp
+ *  @brief Counts of values in fixed bins over a range, evenly or logarithmically spaced.
+ *
+ *  Adding a value is constant time and memory is fixed by the number of bins.  Values below
+ *  or above the range are counted separately; a value equal to the maximum goes in the last
+ *  bin.  Histograms with the same bins (e.g., one per thread) can be merged.
+ */
+
+#ifndef MABE_TOOLS_HISTOGRAM_H
+#define MABE_TOOLS_HISTOGRAM_H
+
+#include <cmath>
+#include <sstream>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/tools/String.hpp"
+
+namespace mabe {
+
+  class Histogram {
+  private:
+    double min_val = 0.0;
+    double max_val = 1.0;
+    bool log_bins = false;         ///< Space bins evenly in log(value)?
+    double scale = 1.0;            ///< Bins per unit (of value or log value).
+    emp::vector<size_t> counts;
+    size_t num_below = 0;
+    size_t num_above = 0;
+
+    double Transform(double value) const { return log_bins ? std::log(value) : value; }
+
+  public:
+    Histogram(size_t num_bins=10, double in_min=0.0, double in_max=1.0, bool in_log=false)
+      : min_val(in_min), max_val(in_max), log_bins(in_log), counts(std::max<size_t>(num_bins, 1), 0)
+    {
+      emp_assert(!log_bins || min_val > 0.0, "Log bins need a positive minimum.", min_val);
+      const double width = Transform(max_val) - Transform(min_val);
+      scale = (width > 0.0) ? (double) counts.size() / width : 0.0;
+    }
+
+    size_t GetNumBins() const { return counts.size(); }
+    double GetMin() const { return min_val; }
+    double GetMax() const { return max_val; }
+    bool IsLog() const { return log_bins; }
+    size_t GetCount(size_t bin) const { emp_assert(bin < counts.size()); return counts[bin]; }
+    const emp::vector<size_t> & GetCounts() const { return counts; }
+    size_t GetNumBelow() const { return num_below; }
+    size_t GetNumAbove() const { return num_above; }
+
+    /// Number of values added (including those outside of the range).
+    size_t GetTotal() const {
+      size_t total = num_below + num_above;
+      for (size_t count : counts) total += count;
+      return total;
+    }
+
+    /// Lowest value that falls in a bin.
+    double GetBinMin(size_t bin) const {
+      const double pos = Transform(min_val) + (scale > 0.0 ? (double) bin / scale : 0.0);
+      return log_bins ? std::exp(pos) : pos;
+    }
+
+    void Add(double value) {
+      if (std::isnan(value)) return;
+      if (value < min_val) { ++num_below; return; }
+      if (value > max_val) { ++num_above; return; }
+      const size_t bin = (size_t) ((Transform(value) - Transform(min_val)) * scale);
+      ++counts[std::min(bin, counts.size() - 1)];
+    }
+
+    /// Fold another histogram (with the same bins) into this one.
+    void Merge(const Histogram & other) {
+      emp_assert(other.counts.size() == counts.size() && other.min_val == min_val &&
+                 other.max_val == max_val && other.log_bins == log_bins, "Histogram bins must match.");
+      for (size_t bin = 0; bin < counts.size(); ++bin) counts[bin] += other.counts[bin];
+      num_below += other.num_below;
+      num_above += other.num_above;
+    }
+
+    /// Bin counts as a list, e.g. "[3,10,4]".
+    emp::String ToString() const {
+      std::stringstream ss;
+      ss << '[';
+      for (size_t bin = 0; bin < counts.size(); ++bin) {
+        if (bin) ss << ',';
+        ss << counts[bin];
+      }
+      ss << ']';
+      return ss.str();
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  InstCounts.hpp
+ *  @brief Cheap counts of instructions executed, by population and instruction ID.
+ *
+ *  Organisms may be run on several threads at once, so each thread counts into its own table
+ *  (found through a thread-local cache, so a count is normally just an increment); tables are
+ *  only combined when counts are read.
+ *
+ *  DEVELOPER NOTES:
+ *  - Reads (and Clear()) must not overlap with counting, e.g. call them between updates.
+ */
+
+#ifndef MABE_TOOLS_INST_COUNTS_H
+#define MABE_TOOLS_INST_COUNTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  class InstCounts {
+  public:
+    static constexpr size_t ALL_POPS = (size_t) -1;
+
+  private:
+    using table_t = emp::vector<emp::vector<uint64_t>>;   ///< Counts by [pop_id][inst_id].
+
+    /// Each thread remembers the last table it counted into (and which InstCounts owns it).
+    struct LocalCache {
+      uint64_t owner_id;
+      table_t * table;
+    };
+    static inline thread_local LocalCache cache{0, nullptr};
+    static inline std::atomic<uint64_t> next_id{1};
+
+    const uint64_t id = next_id++;  ///< Unique across all InstCounts ever made.
+    mutable std::mutex table_mutex;
+    std::unordered_map<std::thread::id, table_t> tables;   ///< Nodes, so tables never move.
+
+    table_t & GetLocalTable() {
+      if (cache.owner_id != id) {
+        std::lock_guard<std::mutex> lock(table_mutex);
+        cache.table = &tables[std::this_thread::get_id()];
+        cache.owner_id = id;
+      }
+      return *cache.table;
+    }
+
+    template <typename FUN_T>
+    void ForEachTable(FUN_T && fun) const {
+      std::lock_guard<std::mutex> lock(table_mutex);
+      for (const auto & [thread_id, table] : tables) fun(table);
+    }
+
+  public:
+    InstCounts() = default;
+    InstCounts(const InstCounts &) = delete;
+    InstCounts & operator=(const InstCounts &) = delete;
+
+    /// Count 'count' executions of an instruction by an organism in population 'pop_id'.
+    void Add(size_t pop_id, size_t inst_id, uint64_t count=1) {
+      table_t & table = GetLocalTable();
+      if (pop_id >= table.size()) table.resize(pop_id + 1);
+      emp::vector<uint64_t> & counts = table[pop_id];
+      if (inst_id >= counts.size()) counts.resize(inst_id + 1, 0);
+      counts[inst_id] += count;
+    }
+
+    /// Counts for each instruction ID, in one population or (by default) all of them.
+    emp::vector<uint64_t> GetCounts(size_t pop_id=ALL_POPS) const {
+      emp::vector<uint64_t> out;
+      ForEachTable([&out, pop_id](const table_t & table) {
+        for (size_t cur_pop = 0; cur_pop < table.size(); ++cur_pop) {
+          if (pop_id != ALL_POPS && cur_pop != pop_id) continue;
+          const emp::vector<uint64_t> & counts = table[cur_pop];
+          if (counts.size() > out.size()) out.resize(counts.size(), 0);
+          for (size_t inst_id = 0; inst_id < counts.size(); ++inst_id) out[inst_id] += counts[inst_id];
+        }
+      });
+      return out;
+    }
+
+    uint64_t GetCount(size_t inst_id, size_t pop_id=ALL_POPS) const {
+      const emp::vector<uint64_t> counts = GetCounts(pop_id);
+      return inst_id < counts.size() ? counts[inst_id] : 0;
+    }
+
+    uint64_t GetTotal(size_t pop_id=ALL_POPS) const {
+      const emp::vector<uint64_t> counts = GetCounts(pop_id);
+      return std::accumulate(counts.begin(), counts.end(), (uint64_t) 0);
+    }
+
+    /// IDs of the (up to) 'num_insts' most executed instructions, most executed first; ties
+    /// go to the lower ID.  Instructions never executed are left out.
+    emp::vector<size_t> GetHottest(size_t num_insts, size_t pop_id=ALL_POPS) const {
+      const emp::vector<uint64_t> counts = GetCounts(pop_id);
+      emp::vector<size_t> ids;
+      for (size_t inst_id = 0; inst_id < counts.size(); ++inst_id) {
+        if (counts[inst_id]) ids.push_back(inst_id);
+      }
+      std::stable_sort(ids.begin(), ids.end(),
+                       [&counts](size_t a, size_t b){ return counts[a] > counts[b]; });
+      if (ids.size() > num_insts) ids.resize(num_insts);
+      return ids;
+    }
+
+    /// Reset all counts to zero.
+    void Clear() {
+      std::lock_guard<std::mutex> lock(table_mutex);
+      for (auto & [thread_id, table] : tables) {
+        for (auto & counts : table) std::fill(counts.begin(), counts.end(), 0);
+      }
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  LSHIndex.hpp
+ *  @brief A bounded set of points with approximate nearest-neighbor lookups.
+ *
+ *  Points are indexed with random-projection locality-sensitive hashing for Euclidean
+ *  distance (E2LSH): each of 'num_tables' hash tables keys a point by 'num_hashes' values of
+ *  floor((a . p + b) / bucket_width), with a drawn from a normal distribution and b uniformly
+ *  from [0, bucket_width).  Nearby points usually share a bucket in at least one table, so a
+ *  query only measures exact distances to the points in its own buckets.  If those hold fewer
+ *  than the k points requested, the query falls back to scanning every point.
+ *
+ *  More tables find more true neighbors at a higher cost; more hashes per table (or narrower
+ *  buckets) make buckets smaller.  A good bucket_width is near typical neighbor distances.
+ *
+ *  Once 'capacity' points are stored, each new point replaces the oldest one.  Queries are
+ *  const and may run in parallel, each with its own scratch vector.
+ */
+
+#ifndef MABE_TOOLS_LSH_INDEX_H
+#define MABE_TOOLS_LSH_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+#include "RandomStreams.hpp"
+
+namespace mabe {
+
+  class LSHIndex {
+  private:
+    using bucket_t = emp::vector<uint32_t>;
+
+    size_t num_dims = 0;
+    size_t capacity = 0;
+    size_t num_tables = 0;
+    size_t num_hashes = 0;
+    double bucket_width = 1.0;
+
+    emp::vector<double> projections;   ///< [table][hash][dim] projection vectors.
+    emp::vector<double> offsets;       ///< [table][hash] offsets in [0, bucket_width).
+    emp::vector<std::unordered_map<uint64_t, bucket_t>> tables;
+
+    emp::vector<double> points;        ///< [slot][dim] stored points.
+    emp::vector<uint64_t> slot_keys;   ///< [slot][table] bucket key of each stored point.
+    size_t num_points = 0;             ///< Slots in use.
+    size_t next_slot = 0;              ///< Slot for the next point (the oldest, once full).
+
+    /// Uniform value in (0, 1) from a stream key.
+    static double ToUnit(uint64_t key) { return ((key >> 11) + 0.5) / 9007199254740992.0; }
+
+    uint64_t CalcBucket(size_t table_id, std::span<const double> point) const {
+      uint64_t key = table_id;
+      for (size_t hash_id = 0; hash_id < num_hashes; ++hash_id) {
+        const size_t row = table_id * num_hashes + hash_id;
+        const double * proj = projections.data() + row * num_dims;
+        double dot = offsets[row];
+        for (size_t d = 0; d < num_dims; ++d) dot += proj[d] * point[d];
+        key = RandomStreams::Mix(key ^ static_cast<uint64_t>(std::floor(dot / bucket_width)));
+      }
+      return key;
+    }
+
+    double CalcDist2(const double * a, std::span<const double> b) const {
+      double dist2 = 0.0;
+      for (size_t d = 0; d < num_dims; ++d) {
+        const double diff = a[d] - b[d];
+        dist2 += diff * diff;
+      }
+      return dist2;
+    }
+
+    void RemoveSlot(size_t slot) {
+      for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+        auto it = tables[table_id].find(slot_keys[slot * num_tables + table_id]);
+        emp_assert(it != tables[table_id].end());
+        bucket_t & bucket = it->second;
+        auto pos = std::find(bucket.begin(), bucket.end(), (uint32_t) slot);
+        emp_assert(pos != bucket.end());
+        *pos = bucket.back();
+        bucket.pop_back();
+        if (bucket.empty()) tables[table_id].erase(it);
+      }
+    }
+
+  public:
+    LSHIndex() = default;
+    LSHIndex(size_t in_dims, size_t in_capacity, size_t in_tables=8, size_t in_hashes=4,
+             double in_width=1.0, uint64_t seed=1) {
+      Setup(in_dims, in_capacity, in_tables, in_hashes, in_width, seed);
+    }
+
+    /// Choose the index shape and draw its projections from 'seed'; this removes all points.
+    void Setup(size_t in_dims, size_t in_capacity, size_t in_tables=8, size_t in_hashes=4,
+               double in_width=1.0, uint64_t seed=1) {
+      emp_assert(in_tables > 0 && in_hashes > 0 && in_width > 0.0, in_tables, in_hashes, in_width);
+      num_dims = in_dims;
+      capacity = in_capacity;
+      num_tables = in_tables;
+      num_hashes = in_hashes;
+      bucket_width = in_width;
+
+      // Normal values by the Box-Muller transform, from independent streams.
+      const RandomStreams streams(seed);
+      projections.resize(num_tables * num_hashes * num_dims);
+      for (size_t i = 0; i < projections.size(); ++i) {
+        const double u1 = ToUnit(streams.CalcKey(i, 1)), u2 = ToUnit(streams.CalcKey(i, 2));
+        projections[i] = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+      }
+      offsets.resize(num_tables * num_hashes);
+      for (size_t i = 0; i < offsets.size(); ++i) {
+        offsets[i] = ToUnit(streams.CalcKey(i, 3)) * bucket_width;
+      }
+
+      points.resize(capacity * num_dims);
+      slot_keys.resize(capacity * num_tables);
+      Clear();
+    }
+
+    void Clear() {
+      tables.assign(num_tables, {});
+      num_points = 0;
+      next_slot = 0;
+    }
+
+    size_t GetSize() const { return num_points; }
+    size_t GetCapacity() const { return capacity; }
+    size_t GetNumDims() const { return num_dims; }
+    std::span<const double> GetPoint(size_t slot) const {
+      emp_assert(slot < num_points, slot, num_points);
+      return std::span<const double>(points.data() + slot * num_dims, num_dims);
+    }
+
+    /// Store a point, replacing the oldest one if full; returns the slot used.
+    size_t Add(std::span<const double> point) {
+      emp_assert(point.size() == num_dims, point.size(), num_dims);
+      emp_assert(capacity > 0);
+      const size_t slot = next_slot;
+      if (num_points == capacity) RemoveSlot(slot);
+      else ++num_points;
+      if (++next_slot == capacity) next_slot = 0;
+
+      std::copy(point.begin(), point.end(), points.begin() + slot * num_dims);
+      for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+        const uint64_t key = CalcBucket(table_id, point);
+        slot_keys[slot * num_tables + table_id] = key;
+        tables[table_id][key].push_back((uint32_t) slot);
+      }
+      return slot;
+    }
+
+    /// Put the distances from 'query' to (approximately) its k nearest points into 'dists', in
+    /// increasing order; fewer are returned only if fewer are stored.  Slot 'skip' (e.g., the
+    /// query's own entry) is ignored.  'scratch' holds candidates between calls.
+    void FindNearest(std::span<const double> query, size_t k, emp::vector<double> & dists,
+                     emp::vector<uint32_t> & scratch, size_t skip=(size_t)-1) const {
+      emp_assert(query.size() == num_dims, query.size(), num_dims);
+      scratch.resize(0);
+      for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+        auto it = tables[table_id].find(CalcBucket(table_id, query));
+        if (it != tables[table_id].end()) {
+          scratch.insert(scratch.end(), it->second.begin(), it->second.end());
+        }
+      }
+      std::sort(scratch.begin(), scratch.end());
+      scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+      const size_t num_found = scratch.size() - std::binary_search(scratch.begin(), scratch.end(), (uint32_t) skip);
+
+      dists.resize(0);
+      auto add_dist = [&](size_t slot) {
+        if (slot != skip) dists.push_back(CalcDist2(points.data() + slot * num_dims, query));
+      };
+      if (num_found < k) {
+        for (size_t slot = 0; slot < num_points; ++slot) add_dist(slot);
+      } else {
+        for (uint32_t slot : scratch) add_dist(slot);
+      }
+
+      const size_t num_keep = std::min(k, dists.size());
+      std::partial_sort(dists.begin(), dists.begin() + num_keep, dists.end());
+      dists.resize(num_keep);
+      for (double & dist : dists) dist = std::sqrt(dist);
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  LexicaseFilter.hpp
+ *  @brief The filtering steps of (epsilon) lexicase selection over a fixed set of candidates.
+ *
+ *  Scores are held in a trait-major matrix: each trait's scores for all candidates are
+ *  contiguous, so each filtering step walks a single column.  Filter() steps through traits in
+ *  the order given, keeping only the candidates within that trait's epsilon of the best
+ *  remaining score, and returns the survivors.  Filter() is const, so several threads can
+ *  filter at once, each with its own scratch vectors.
+ *
+ *  BuildBuckets() precomputes, for each trait, bitsets of the candidates with the best score
+ *  overall and of those within epsilon of it.  While the remaining candidates still include one
+ *  with the best score overall, the best remaining score IS that score, so a filtering step is
+ *  exactly an intersection with the trait's bucket.  Once none do (possible only with a
+ *  positive epsilon, or when no survivor is in the bucket at all), Filter() falls back to
+ *  scanning scores, so buckets never change which candidates survive.
+ */
+
+#ifndef MABE_TOOLS_LEXICASE_FILTER_H
+#define MABE_TOOLS_LEXICASE_FILTER_H
+
+#include <algorithm>
+#include <limits>
+#include <span>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
+
+namespace mabe {
+
+  class LexicaseFilter {
+  private:
+    size_t num_traits = 0;
+    size_t num_orgs = 0;
+    emp::vector<double> matrix;                ///< Score of candidate c on trait t at t*num_orgs+c.
+    emp::vector<double> trait_epsilon;         ///< Range below the best score that survives.
+    emp::vector<emp::BitVector> trait_elite;   ///< Candidates within epsilon of each trait's best.
+    emp::vector<emp::BitVector> trait_best;    ///< Candidates with each trait's best (if eps > 0).
+
+  public:
+    LexicaseFilter(size_t _traits, size_t _orgs, double epsilon=0.0)
+      : num_traits(_traits), num_orgs(_orgs), matrix(_traits * _orgs), trait_epsilon(_traits, epsilon) { }
+
+    size_t GetNumTraits() const { return num_traits; }
+    size_t GetNumOrgs() const { return num_orgs; }
+    bool HasBuckets() const { return trait_elite.size() > 0; }
+
+    double & Score(size_t trait_id, size_t org_idx) { return matrix[trait_id * num_orgs + org_idx]; }
+    const double * GetColumn(size_t trait_id) const { return matrix.data() + trait_id * num_orgs; }
+
+    double GetEpsilon(size_t trait_id) const { return trait_epsilon[trait_id]; }
+    void SetEpsilon(size_t trait_id, double eps) {
+      emp_assert(!HasBuckets(), "Epsilons must be set before buckets are built.");
+      trait_epsilon[trait_id] = eps;
+    }
+
+    /// Precompute each trait's buckets; call after all scores and epsilons are set.
+    void BuildBuckets() {
+      trait_elite.assign(num_traits, emp::BitVector(num_orgs));
+      trait_best.assign(num_traits, emp::BitVector());
+      for (size_t trait_id = 0; trait_id < num_traits; ++trait_id) {
+        const double * column = GetColumn(trait_id);
+        double max_value = std::numeric_limits<double>::lowest();
+        for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+          max_value = std::max(max_value, column[org_idx]);
+        }
+        const double threshold = max_value - trait_epsilon[trait_id];
+        for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+          if (column[org_idx] >= threshold) trait_elite[trait_id].Set(org_idx);
+        }
+        if (trait_epsilon[trait_id] <= 0.0) continue;   // The elite ARE the best.
+        trait_best[trait_id] = emp::BitVector(num_orgs);
+        for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+          if (column[org_idx] == max_value) trait_best[trait_id].Set(org_idx);
+        }
+      }
+    }
+
+    /// Filter all candidates by each trait in 'order'; returns the survivors in 'cur_orgs' (never
+    /// empty if there are candidates).  'next_orgs' is scratch space.
+    void Filter(std::span<const size_t> order, emp::vector<size_t> & cur_orgs,
+                emp::vector<size_t> & next_orgs) const {
+      // With buckets, intersect bitsets for as long as possible; otherwise, while no candidate
+      // has been removed yet, scan whole columns directly (simple loops the compiler can
+      // vectorize).
+      bool use_buckets = HasBuckets();
+      bool all_orgs = !use_buckets;
+      emp::BitVector cur_bits, next_bits;
+      if (use_buckets) cur_bits = emp::BitVector(num_orgs, true);
+      cur_orgs.resize(0);
+      next_orgs.resize(0);
+      for (size_t trait_id : order) {
+        if (use_buckets) {
+          next_bits = cur_bits;
+          next_bits &= trait_epsilon[trait_id] > 0.0 ? trait_best[trait_id] : trait_elite[trait_id];
+          if (next_bits.Any()) {            // A survivor has the best score; use the bucket.
+            if (trait_epsilon[trait_id] > 0.0) {
+              next_bits = cur_bits;
+              next_bits &= trait_elite[trait_id];
+            }
+            std::swap(cur_bits, next_bits);
+            if (cur_bits.CountOnes() == 1) break;
+            continue;
+          }
+          // No remaining candidate has this trait's best score; filter a list from here on.
+          cur_orgs = cur_bits.GetOnes();
+          use_buckets = false;
+        }
+
+        const double * column = GetColumn(trait_id);
+        const double trait_eps = trait_epsilon[trait_id];
+        double min_value = std::numeric_limits<double>::max();
+        double max_value = std::numeric_limits<double>::lowest();
+        if (all_orgs) {
+          for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+            min_value = std::min(min_value, column[org_idx]);
+            max_value = std::max(max_value, column[org_idx]);
+          }
+        } else {
+          for (size_t org_idx : cur_orgs) {
+            min_value = std::min(min_value, column[org_idx]);
+            max_value = std::max(max_value, column[org_idx]);
+          }
+        }
+
+        // If there's not enough variation in this trait, move on to the next trait.
+        if (min_value + trait_eps >= max_value) continue;
+
+        // Eliminate all candidates with a lower score than the threshold.
+        const double threshold = max_value - trait_eps;
+        if (all_orgs) {
+          for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) {
+            if (column[org_idx] >= threshold) next_orgs.push_back(org_idx);
+          }
+          all_orgs = false;
+        } else {
+          for (size_t org_idx : cur_orgs) {
+            if (column[org_idx] >= threshold) next_orgs.push_back(org_idx);
+          }
+        }
+
+        // Cleanup for the next trait.
+        cur_orgs.resize(0);
+        std::swap(cur_orgs, next_orgs);
+
+        // If we are down to just one candidate, stop early!
+        if (cur_orgs.size() == 1) break;
+        emp_assert(cur_orgs.size() > 0);
+      }
+      if (use_buckets) cur_orgs = cur_bits.GetOnes();
+      else if (all_orgs) {                  // No trait removed anyone.
+        cur_orgs.resize(num_orgs);
+        for (size_t org_idx = 0; org_idx < num_orgs; ++org_idx) cur_orgs[org_idx] = org_idx;
+      }
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  MemoCache.hpp
+ *  @brief A bounded, thread-safe, least-recently-used cache from 64-bit keys to values.
+ *
+ *  MemoCache is intended for remembering the results of expensive calculations (such as
+ *  fitness) keyed by a genome fingerprint.  When full, the least-recently used entry is
+ *  dropped.  Hit and miss counts, along with an estimate of memory use, are tracked so that
+ *  cache effectiveness can be reported.
+ *
+ *  DEVELOPER NOTES:
+ *  - Keys are assumed to be well-mixed hashes; two genomes with the same key share a result.
+ */
+
+#ifndef MABE_TOOLS_MEMO_CACHE_H
+#define MABE_TOOLS_MEMO_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace mabe {
+
+  template <typename VALUE_T>
+  class MemoCache {
+  private:
+    using entry_t = std::pair<uint64_t, VALUE_T>;
+    using list_t = std::list<entry_t>;
+
+    size_t capacity = 0;                  ///< Maximum entries (0 = cache disabled).
+    list_t entries;                       ///< Most recently used at front.
+    std::unordered_map<uint64_t, typename list_t::iterator> entry_map;
+    size_t num_hits = 0;
+    size_t num_misses = 0;
+    mutable std::mutex cache_mutex;
+
+  public:
+    MemoCache(size_t in_capacity=0) : capacity(in_capacity) { }
+
+    size_t GetCapacity() const { return capacity; }
+    size_t GetSize() const { std::lock_guard<std::mutex> lock(cache_mutex); return entries.size(); }
+    size_t GetNumHits() const { std::lock_guard<std::mutex> lock(cache_mutex); return num_hits; }
+    size_t GetNumMisses() const { std::lock_guard<std::mutex> lock(cache_mutex); return num_misses; }
+    bool IsActive() const { return capacity > 0; }
+
+    /// Fraction of lookups that were found in the cache (0.0 if no lookups yet).
+    double GetHitRate() const {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      const size_t total = num_hits + num_misses;
+      return total ? ((double) num_hits) / (double) total : 0.0;
+    }
+
+    /// Approximate memory used by entries (node and bucket overhead included).
+    size_t GetNumBytes() const {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      return entries.size() * (sizeof(entry_t) + 2 * sizeof(void *))   // List nodes
+           + entry_map.size() * (sizeof(uint64_t) + 3 * sizeof(void *)) // Map nodes
+           + entry_map.bucket_count() * sizeof(void *);                // Map buckets
+    }
+
+    /// Change the maximum number of entries, dropping the oldest if shrinking.
+    void SetCapacity(size_t in_capacity) {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      capacity = in_capacity;
+      while (entries.size() > capacity) {
+        entry_map.erase(entries.back().first);
+        entries.pop_back();
+      }
+    }
+
+    void Clear() {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      entries.clear();
+      entry_map.clear();
+    }
+
+    /// If key is present, copy its value into 'out', mark it as recently used, and return true.
+    bool Lookup(uint64_t key, VALUE_T & out) {
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      auto it = entry_map.find(key);
+      if (it == entry_map.end()) { ++num_misses; return false; }
+      ++num_hits;
+      entries.splice(entries.begin(), entries, it->second);
+      out = it->second->second;
+      return true;
+    }
+
+    /// Store a value for a key (replacing any current one), evicting the oldest entry if full.
+    void Store(uint64_t key, const VALUE_T & value) {
+      if (capacity == 0) return;
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      auto it = entry_map.find(key);
+      if (it != entry_map.end()) {
+        it->second->second = value;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+      }
+      if (entries.size() >= capacity) {
+        entry_map.erase(entries.back().first);
+        entries.pop_back();
+      }
+      entries.emplace_front(key, value);
+      entry_map[key] = entries.begin();
+    }
+
+    /// Return the cached value for key, or calculate it with fun() and cache the result.
+    template <typename FUN_T>
+    VALUE_T Get(uint64_t key, FUN_T && fun) {
+      VALUE_T value;
+      if (Lookup(key, value)) return value;
+      value = fun();
+      Store(key, value);
+      return value;
+    }
+  };
+
+}
+
+#endif
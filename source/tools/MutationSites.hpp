@@ -0,0 +1,112 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  MutationSites.hpp
+ *  @brief Pick independently mutated sites by sampling the gaps between them.
+ *
+ *  If each of N sites mutates with probability p, the number of unmutated sites before the
+ *  next mutation is geometrically distributed.  Sampling those gaps directly visits only the
+ *  mutated sites, in increasing order and without duplicates, so no N-bit scratch vector is
+ *  needed and the cost is proportional to the number of mutations rather than to N.
+ *
+ *  Usage:
+ *    GeometricSites sites(0.001);
+ *    size_t num_muts = sites.ForEachSite(genome.size(), random, [&](size_t pos){ ... });
+ *
+ *  MutationSampler is the shared point-mutation engine for fixed-length organisms: it either
+ *  samples gaps (as above) or draws a binomial count of distinct sites into a preallocated bit
+ *  vector, so mutate loops need no allocations and never visit a site twice.
+ */
+
+#ifndef MABE_TOOLS_MUTATION_SITES_H
+#define MABE_TOOLS_MUTATION_SITES_H
+
+#include <cmath>
+#include <limits>
+
+#include "emp/base/assert.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Distribution.hpp"
+#include "emp/math/Random.hpp"
+
+namespace mabe {
+
+  class GeometricSites {
+  private:
+    double mut_prob = 0.0;
+    double log_keep = 0.0;  ///< log(1 - mut_prob), cached for gap sampling.
+
+  public:
+    GeometricSites() = default;
+    GeometricSites(double p) { Setup(p); }
+
+    double GetProb() const { return mut_prob; }
+
+    void Setup(double p) {
+      emp_assert(p >= 0.0 && p <= 1.0, p);
+      mut_prob = p;
+      log_keep = std::log1p(-p);
+    }
+
+    /// Number of unmutated sites before the next mutated one (capped at 'limit').
+    template <typename RANDOM_T=emp::Random>
+    size_t NextGap(RANDOM_T & random, size_t limit=std::numeric_limits<size_t>::max()) const {
+      if (mut_prob <= 0.0) return limit;
+      if (mut_prob >= 1.0) return 0;
+      const double u = 1.0 - random.GetDouble();  // In (0, 1], so log(u) is finite.
+      const double gap = std::floor(std::log(u) / log_keep);
+      return (gap >= (double) limit) ? limit : (size_t) gap;
+    }
+
+    /// Call fun(pos) on each mutated site in [0, num_sites), in order; return the count.
+    template <typename RANDOM_T, typename FUN_T>
+    size_t ForEachSite(size_t num_sites, RANDOM_T & random, FUN_T && fun) const {
+      size_t count = 0;
+      for (size_t pos = NextGap(random, num_sites); pos < num_sites;
+           pos += 1 + NextGap(random, num_sites - pos)) {
+        fun(pos);
+        ++count;
+      }
+      return count;
+    }
+  };
+
+  class MutationSampler {
+  private:
+    bool geometric = false;     ///< Sample gaps rather than a count of sites?
+    GeometricSites gaps;        ///< Gap sampler (geometric mode).
+    emp::Binomial count_dist;   ///< Number of mutated sites (binomial mode).
+    emp::BitVector sites;       ///< Scratch space for the chosen sites (binomial mode).
+
+  public:
+    /// Configure for 'num_sites' sites, each mutating with probability 'prob'.
+    void Setup(double prob, size_t num_sites, bool use_gaps) {
+      geometric = use_gaps;
+      gaps.Setup(prob);
+      count_dist.Setup(prob, num_sites);
+      sites.Resize(num_sites);
+    }
+
+    /// Gap sampling uses no shared scratch space, so it can run from several threads at once.
+    bool IsThreadSafe() const { return geometric; }
+
+    /// Call fun(pos) once on each distinct mutated site in [0, num_sites), in increasing
+    /// order; return the number of sites mutated.
+    template <typename FUN_T>
+    size_t ForEachSite(size_t num_sites, emp::Random & random, FUN_T && fun) {
+      if (geometric) return gaps.ForEachSite(num_sites, random, fun);
+
+      emp_assert(num_sites == sites.GetSize(), num_sites, sites.GetSize());
+      const size_t num_muts = count_dist.PickRandom(random);
+      if (num_muts == 0) return 0;
+      sites.ChooseRandom(random, num_muts);
+      for (size_t pos = sites.FindOne(); pos < num_sites; pos = sites.FindOne(pos+1)) fun(pos);
+      return num_muts;
+    }
+  };
+
+}
+
+#endif
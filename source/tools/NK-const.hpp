@@ -8,6 +8,11 @@
  *
  *  Knowing the size of N and K at compile time allow for slightly more optimized code, at the
  *  expense of flexibility.
+ *
+ *  MakeNKConstFitnessFun() bridges the two: for common (N, K) pairs it builds an
+ *  NKLandscapeConst and returns a function that evaluates emp::BitVector genomes on it.  The
+ *  table is filled with the same random draws, in the same order, as NKLandscape, so the
+ *  resulting fitnesses are identical to the runtime version.
  **/
 
 
@@ -15,9 +20,13 @@
 #define MABE_TOOLS_NK_CONST_HPP
 
 #include <array>
+#include <functional>
+#include <memory>
+#include <utility>
 
 #include "emp/base/assert.hpp"
 #include "emp/bits/BitSet.hpp"
+#include "emp/bits/BitVector.hpp"
 #include "emp/math/math.hpp"
 #include "emp/math/Random.hpp"
 
@@ -89,9 +98,9 @@ namespace mabe {
     }
 
     /// Get the fitness of a whole  bitstring
-    double GetFitness(const BitSet<N> & genome) const {
+    double GetFitness(const emp::BitSet<N> & genome) const {
       // Create a double-length genome to easily handle wrap-around.
-      BitSet<N*2> genome2( genome.template Export<N*2>() );
+      emp::BitSet<N*2> genome2( genome.template Export<N*2>() );
       genome2 |= (genome2 << N);
 
       double total = 0.0;
@@ -103,8 +112,63 @@ namespace mabe {
       }
       return total;
     }
+
+    /// Get the fitness of a whole bitstring stored in a BitVector (zero-padded or truncated to
+    /// N bits); each gene's state is slid over from the previous one.
+    double GetFitness(const emp::BitVector & genome) const {
+      if (genome.GetSize() != N) {
+        emp::BitVector resized(genome);
+        resized.Resize(N);
+        return GetFitness(resized);
+      }
+      size_t state = 0;
+      for (size_t k = 0; k <= K; ++k) if (genome.Get(k % N)) state |= ((size_t) 1) << k;
+      double total = GetFitness(0, state);
+      for (size_t i = 1; i < N; i++) {
+        state >>= 1;
+        if (genome.Get((i + K) % N)) state |= ((size_t) 1) << K;
+        total += GetFitness(i, state);
+      }
+      return total;
+    }
   };
 
+  namespace internal {
+    using nk_fun_t = std::function<double(const emp::BitVector &)>;
+
+    template <size_t N, size_t K>
+    nk_fun_t MakeNKConstFun(emp::Random & random) {
+      auto landscape = std::make_shared<NKLandscapeConst<N,K>>(random);
+      return [landscape](const emp::BitVector & genome){ return landscape->GetFitness(genome); };
+    }
+
+    template <size_t N, size_t... Ks>
+    nk_fun_t MakeNKConstFun_K(size_t K, emp::Random & random, std::index_sequence<Ks...>) {
+      nk_fun_t out;
+      ((K == Ks+1 && (out = MakeNKConstFun<N, Ks+1>(random), true)) || ...);
+      return out;
+    }
+  }
+
+  /// Values of N and K that MakeNKConstFitnessFun() has compiled versions for.
+  constexpr std::array<size_t, 4> NK_CONST_N_VALUES{20, 50, 100, 200};
+  constexpr size_t NK_CONST_MAX_K = 8;
+
+  /// If (N, K) is one of the compiled combinations (N in NK_CONST_N_VALUES, 1 <= K <= 8), build
+  /// a compile-time landscape from 'random' and return a function that evaluates genomes on it.
+  /// Otherwise return an empty function and leave 'random' untouched.
+  inline std::function<double(const emp::BitVector &)>
+  MakeNKConstFitnessFun(size_t N, size_t K, emp::Random & random) {
+    using ks_t = std::make_index_sequence<NK_CONST_MAX_K>;
+    switch (N) {
+      case 20:  return internal::MakeNKConstFun_K<20>(K, random, ks_t{});
+      case 50:  return internal::MakeNKConstFun_K<50>(K, random, ks_t{});
+      case 100: return internal::MakeNKConstFun_K<100>(K, random, ks_t{});
+      case 200: return internal::MakeNKConstFun_K<200>(K, random, ks_t{});
+    }
+    return nullptr;
+  }
+
 }
 
 #endif
@@ -8,7 +8,7 @@
  *  @note This file was originally Evolve/NK.h in Empirical.
  *
  *  Two version of landscapes are provided.  NKLandscape pre-calculates the entire landscape, for
- *  easy lookup.  NKLandscapeMemo does lazy evaluation, memorizing values when they're first used.
+ *  easy lookup.  NKLandscapeMemo computes each value from a hash when it is used.
  *  NKLandscape is faster, but goes up in memory size exponentially with K.  NKLandscapeMemo is
  *  slightly slower, but can handle arbitrarily large landscapes.
  *
@@ -19,12 +19,16 @@
 #ifndef MABE_TOOLS_NK_HPP
 #define MABE_TOOLS_NK_HPP
 
+#include <memory>
+#include <span>
+
 #include "emp/base/vector.hpp"
 #include "emp/bits/BitVector.hpp"
-#include "emp/functional/memo_function.hpp"
 #include "emp/math/math.hpp"
 #include "emp/math/Random.hpp"
 
+#include "RandomStreams.hpp"
+
 namespace mabe {
 
   /// An NK Landscape is a popular tool for studying theoretical questions about evolutionary
@@ -51,7 +55,10 @@ namespace mabe {
     size_t K;             ///< The number of OTHER bits with which each bit is epistatic.
     size_t state_count;   ///< The total number of states associated with each bit table.
     size_t total_count;   ///< The total number of states in the entire landscape space.
-    emp::vector< emp::vector<double> > landscape;  ///< The actual values in the landscape.
+    emp::vector<double> landscape;  ///< Values, gene-major: [gene_id * state_count + state].
+    std::shared_ptr<const double> shared_values;  ///< Table held elsewhere, used if set.
+
+    const double * Values() const { return shared_values ? shared_values.get() : landscape.data(); }
 
   public:
     NKLandscape() : N(0), K(0), state_count(0), total_count(0), landscape() { ; }
@@ -65,7 +72,7 @@ namespace mabe {
      : N(_N), K(_K)
      , state_count(emp::IntPow<size_t>(2,K+1))
      , total_count(N * state_count)
-     , landscape(N)
+     , landscape()
     {
       Reset(random);
     }
@@ -73,18 +80,20 @@ namespace mabe {
     NKLandscape & operator=(const NKLandscape &) = delete;
     NKLandscape & operator=(NKLandscape &&) = default;
 
+    /// Fill a gene-major table of N * 2^(K+1) values with the draws of a new landscape.
+    static void FillTable(std::span<double> values, emp::Random & random) {
+      for (double & value : values) value = random.GetDouble();
+    }
+
     /// Randomize the landscape without changing the landscape size.
     void Reset(emp::Random & random) {
       emp_assert(K < 32, K);
       emp_assert(K < N, K, N);
 
       // Build new landscape.
-      for ( auto & ltable : landscape) {
-        ltable.resize(state_count);
-        for (double & pos : ltable) {
-          pos = random.GetDouble();
-        }
-      }
+      shared_values.reset();
+      landscape.resize(total_count);
+      FillTable(landscape, random);
     }
 
     /// Configure for new values of N and K.
@@ -93,10 +102,22 @@ namespace mabe {
       N = _N;  K = _K;
       state_count = emp::IntPow<size_t>(2,K+1);
       total_count = N * state_count;
-      landscape.resize(N);
       Reset(random);
     }
 
+    /// Configure for new values of N and K, using a table built by FillTable() that is held
+    /// elsewhere (e.g., mapped from shared memory) instead of building one.
+    void Config(size_t _N, size_t _K, std::shared_ptr<const double> values) {
+      N = _N;  K = _K;
+      state_count = emp::IntPow<size_t>(2,K+1);
+      total_count = N * state_count;
+      landscape.clear();
+      shared_values = values;
+    }
+
+    /// Is this landscape using a table held elsewhere?
+    bool IsShared() const { return (bool) shared_values; }
+
     /// Returns N
     size_t GetN() const { return N; }
     /// Returns K
@@ -111,53 +132,103 @@ namespace mabe {
     /// value [state]
     double GetFitness(size_t gene_id, size_t state) const {
       emp_assert(state < state_count, state, state_count);
-      return landscape[gene_id][state];
+      return Values()[gene_id * state_count + state];
+    }
+
+    /// Get the state of gene [gene_id] in a genome: bit k of the state is genome bit gene_id+k,
+    /// wrapping around the end of the genome.
+    size_t GetGeneState(const emp::BitVector & genome, size_t gene_id) const {
+      emp_assert(genome.GetSize() == N, genome.GetSize(), N);
+      size_t state = 0;
+      for (size_t k = 0; k <= K; ++k) {
+        if (genome.Get((gene_id + k) % N)) state |= ((size_t) 1) << k;
+      }
+      return state;
+    }
+
+    /// Get the fitness contribution of a single gene in a genome.
+    double GetGeneFitness(const emp::BitVector & genome, size_t gene_id) const {
+      return GetFitness(gene_id, GetGeneState(genome, gene_id));
+    }
+
+    /// Update gene fitnesses (as produced by GetGeneFitnesses() for old_genome) to match
+    /// new_genome, recomputing only the genes that overlap changed bits.  Returns the new
+    /// total fitness, summed in the same order as GetFitness() so results match exactly.
+    double UpdateGeneFitnesses(const emp::BitVector & old_genome, const emp::BitVector & new_genome,
+                               emp::vector<double> & gene_fitnesses) const {
+      emp_assert(gene_fitnesses.size() == N, gene_fitnesses.size(), N);
+      const emp::BitVector changed = old_genome ^ new_genome;
+      for (int pos = changed.FindOne(); pos >= 0; pos = changed.FindOne((size_t) pos + 1)) {
+        for (size_t k = 0; k <= K; ++k) {
+          const size_t gene_id = ((size_t) pos + N - k) % N;
+          gene_fitnesses[gene_id] = GetGeneFitness(new_genome, gene_id);
+        }
+      }
+      double total = 0.0;
+      for (double fit : gene_fitnesses) total += fit;
+      return total;
     }
 
     /// Get the fitness of a whole  bitstring
     double GetFitness( std::vector<size_t> states ) const {
       emp_assert(states.size() == N);
-      double total = landscape[0][states[0]];
+      double total = GetFitness(0, states[0]);
       for (size_t i = 1; i < N; i++) total += GetFitness(i,states[i]);
       return total;
     }
 
-    /// Get the fitness of a whole bitstring (pass by value so can be modified.)
-    double GetFitness(emp::BitVector genome) const {
-      // Use a double-length genome to easily handle wrap-around.
-      genome.Resize(N*2);
-      genome |= (genome << N);
+    /// Call fun(gene_id, state) for each gene of a genome, in order.  Each gene's state is
+    /// slid over from the previous one, so no copies or shifts of the genome are needed.
+    template <typename FUN_T>
+    void ForEachGeneState(const emp::BitVector & genome, FUN_T && fun) const {
+      if (N == 0) return;
+      if (genome.GetSize() != N) {   // Zero-pad (or truncate) genomes of the wrong size.
+        emp::BitVector resized(genome);
+        resized.Resize(N);
+        ForEachGeneState(resized, fun);
+        return;
+      }
+      size_t state = GetGeneState(genome, 0);
+      fun(0, state);
+      for (size_t i = 1; i < N; i++) {
+        state >>= 1;
+        if (genome.Get((i + K) % N)) state |= ((size_t) 1) << K;
+        fun(i, state);
+      }
+    }
 
+    /// Get the fitness of a whole bitstring.
+    double GetFitness(const emp::BitVector & genome) const {
       double total = 0.0;
-      const size_t mask = emp::MaskLow<size_t>(K+1);
-      for (size_t i = 0; i < N; i++) {
-        const size_t cur_val = (genome >> i).GetUInt(0) & mask;
-	      const double cur_fit = GetFitness(i, cur_val);
-        total += cur_fit;
-      }
+      ForEachGeneState(genome, [this, &total](size_t i, size_t state){
+        total += GetFitness(i, state);
+      });
       return total;
     }
 
-    /// Get the fitness of each gene in a bitstring (pass by value so can be modified.)
-    emp::vector<double> GetGeneFitnesses(emp::BitVector genome) const {
-      emp::vector<double> gene_fitnesses;
-      gene_fitnesses.resize(N);
-
-      // Use a double-length genome to easily handle wrap-around.
-      genome.Resize(N*2);
-      genome |= (genome << N);
-
-      const size_t mask = emp::MaskLow<size_t>(K+1);
-      for (size_t i = 0; i < N; i++) {
-        const size_t cur_val = (genome >> i).GetUInt(0) & mask;
-	      gene_fitnesses[i] = GetFitness(i, cur_val);
-      }
+    /// Get the fitness of many bitstrings at once; the landscape table stays hot in cache.
+    void GetFitnesses(std::span<const emp::BitVector> genomes, std::span<double> fitnesses) const {
+      emp_assert(genomes.size() == fitnesses.size(), genomes.size(), fitnesses.size());
+      for (size_t i = 0; i < genomes.size(); ++i) fitnesses[i] = GetFitness(genomes[i]);
+    }
 
+    /// Get the fitness of each gene in a bitstring.
+    emp::vector<double> GetGeneFitnesses(const emp::BitVector & genome) const {
+      emp::vector<double> gene_fitnesses(N);
+      ForEachGeneState(genome, [this, &gene_fitnesses](size_t i, size_t state){
+        gene_fitnesses[i] = GetFitness(i, state);
+      });
       return gene_fitnesses;
     }
 
 
-    void SetState(size_t n, size_t state, double in_fit) { landscape[n][state] = in_fit; }
+    void SetState(size_t n, size_t state, double in_fit) {
+      if (shared_values) {     // Copy a shared table before changing it.
+        landscape.assign(shared_values.get(), shared_values.get() + total_count);
+        shared_values.reset();
+      }
+      landscape[n * state_count + state] = in_fit;
+    }
 
     void RandomizeStates(emp::Random & random, size_t num_states=1) {
       for (size_t i = 0; i < num_states; i++) {
@@ -168,28 +239,40 @@ namespace mabe {
   };
 
   /// The NKLandscapeMemo class is simialar to NKLandscape, but it does not pre-calculate all
-  /// of the landscape states.  Instead it determines the value of each gene combination on first
-  /// use and memorizes it.
+  /// of the landscape states.  Instead, the value of each gene combination is derived from a
+  /// hash of (seed, gene, state), so no table is stored at all: values do not depend on the
+  /// order of lookups, lookups are safe from multiple threads, and memory use does not grow.
 
   class NKLandscapeMemo {
   private:
     const size_t N;
     const size_t K;
-    mutable emp::vector< emp::memo_function<double(const emp::BitVector &)> > landscape;
+    RandomStreams hasher;      ///< Hashes (gene, state) keys using the landscape seed.
     emp::vector<emp::BitVector> masks;
 
+    /// Convert a hash key into a value in [0.0, 1.0).
+    static double KeyToDouble(uint64_t key) { return (double) (key >> 11) * 0x1.0p-53; }
+
+    /// Value of gene n given the K bits of 'bits' that it depends on.
+    double CalcGeneValue(size_t n, const emp::BitVector & bits) const {
+      uint64_t key = hasher.CalcKey(n);
+      uint64_t window = 0;
+      for (size_t k = 0; k < K; k++) {
+        if (bits.Get((n+k)%N)) window |= ((uint64_t) 1) << (k % 64);
+        if (k % 64 == 63) { key = hasher.CalcKey(key, window); window = 0; }
+      }
+      return KeyToDouble(hasher.CalcKey(key, window));
+    }
+
   public:
     NKLandscapeMemo() = delete;
     NKLandscapeMemo(const NKLandscapeMemo &) = delete;
     NKLandscapeMemo(NKLandscapeMemo &&) = default;
     NKLandscapeMemo(size_t _N, size_t _K, emp::Random & random)
-      : N(_N), K(_K), landscape(N), masks(N)
+      : N(_N), K(_K), hasher(random.GetUInt()), masks(N)
     {
-      // Each position in the landscape...
+      // Each position in the landscape should have its own mask.
       for (size_t n = 0; n < N; n++) {
-        // ...should have its own memo_function
-        landscape[n] = [&random](const emp::BitVector &){ return random.GetDouble(); };
-        // ...and its own mask.
         masks[n].Resize(N);
         for (size_t k = 0; k < K; k++) masks[n][(n+k)%N] = 1;
       }
@@ -203,16 +286,12 @@ namespace mabe {
 
     double GetFitness(size_t n, const emp::BitVector & state) const {
       emp_assert(state == (state & masks[n]));
-      return landscape[n](state);
+      return CalcGeneValue(n, state);
     }
     double GetFitness(const emp::BitVector & genome) const {
       emp_assert(genome.GetSize() == N);
-
-      // Otherwise calculate it.
       double total = 0.0;
-      for (size_t n = 0; n < N; n++) {
-        total += landscape[n](genome & masks[n]);
-      }
+      for (size_t n = 0; n < N; n++) total += CalcGeneValue(n, genome);
       return total;
     }
   };
@@ -0,0 +1,255 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Neighborhood.hpp
+ *  @brief Precomputed neighbor tables for grid, torus, and graph population structures.
+ *
+ *  A Neighborhood lists the neighbors of every cell once, in a compressed table (an offset per
+ *  cell into one shared array), so finding a neighbor during a birth is a single lookup.
+ *
+ *  Grids can optionally be partitioned into tiles.  Cells are then numbered tile by tile, so
+ *  each tile covers a contiguous range of positions, and every tile is given a color such
+ *  that two tiles of the same color never share a neighborhood: code that only touches a
+ *  cell and its neighbors can process all tiles of one color at the same time without locks.
+ *
+ *  Usage:
+ *    Neighborhood hood;
+ *    hood.SetupGrid(60, 60, true, Neighborhood::MOORE);
+ *    size_t neighbor_pos = hood.GetRandomNeighbor(pos, random);
+ */
+
+#ifndef MABE_TOOLS_NEIGHBORHOOD_H
+#define MABE_TOOLS_NEIGHBORHOOD_H
+
+#include <cstdint>
+#include <utility>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/notify.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "emp/polyfill/span.hpp"
+
+namespace mabe {
+
+  class Neighborhood {
+  public:
+    enum Type { MOORE=0, VON_NEUMANN, GRAPH };
+    static constexpr size_t NO_POS = (size_t) -1;
+
+  private:
+    Type type = MOORE;
+    size_t width = 0;               ///< Grid columns (0 for graphs).
+    size_t height = 0;              ///< Grid rows (0 for graphs).
+    bool toroidal = false;          ///< Do grid edges wrap around?
+    size_t num_cells = 0;
+
+    emp::vector<uint32_t> offsets;   ///< Start of each cell's neighbors (num_cells + 1 entries).
+    emp::vector<uint32_t> neighbors; ///< Neighbor positions for all cells, cell by cell.
+
+    // Positions of grid cells; without tiles these are simply y * width + x.
+    emp::vector<uint32_t> pos_x;     ///< Column of each position.
+    emp::vector<uint32_t> pos_y;     ///< Row of each position.
+    emp::vector<uint32_t> cell_pos;  ///< Position of each (y * width + x) cell.
+
+    // Tile layout (a single tile covering everything when tiles are not used).
+    size_t tile_width = 0;
+    size_t tile_height = 0;
+    size_t tiles_x = 1;
+    size_t tiles_y = 1;
+    emp::vector<uint32_t> tile_color; ///< Color of each tile.
+    size_t num_colors = 1;
+
+    /// Color of tile 'id' along one dimension with 'count' tiles, so that equal colors are
+    /// always separated by at least one tile (including across a wrapped edge).
+    static size_t DimColor(size_t id, size_t count, bool wrap) {
+      if (wrap && count % 2 == 1 && count > 1 && id == count-1) return 2;
+      return id % 2;
+    }
+
+    void Clear() {
+      width = height = num_cells = 0;
+      toroidal = false;
+      offsets.resize(0);
+      neighbors.resize(0);
+      pos_x.resize(0);
+      pos_y.resize(0);
+      cell_pos.resize(0);
+      tile_width = tile_height = 0;
+      tiles_x = tiles_y = 1;
+      tile_color.assign(1, 0);
+      num_colors = 1;
+    }
+
+  public:
+    Neighborhood() { Clear(); }
+
+    Type GetType() const { return type; }
+    size_t GetWidth() const { return width; }
+    size_t GetHeight() const { return height; }
+    bool IsToroidal() const { return toroidal; }
+    size_t GetNumCells() const { return num_cells; }
+    bool IsGrid() const { return type != GRAPH; }
+
+    /// All neighbors of the cell at 'pos'.
+    std::span<const uint32_t> GetNeighbors(size_t pos) const {
+      emp_assert(pos < num_cells, pos, num_cells);
+      return std::span<const uint32_t>(neighbors.data() + offsets[pos], offsets[pos+1] - offsets[pos]);
+    }
+    size_t GetNumNeighbors(size_t pos) const { return offsets[pos+1] - offsets[pos]; }
+
+    /// A random neighbor of the cell at 'pos' (or NO_POS if it has none).
+    size_t GetRandomNeighbor(size_t pos, emp::Random & random) const {
+      const size_t count = GetNumNeighbors(pos);
+      if (count == 0) return NO_POS;
+      return neighbors[offsets[pos] + random.GetUInt(count)];
+    }
+
+    /// Grid coordinates of a position, and the position at a coordinate.
+    size_t GetX(size_t pos) const { emp_assert(IsGrid()); return pos_x[pos]; }
+    size_t GetY(size_t pos) const { emp_assert(IsGrid()); return pos_y[pos]; }
+    size_t GetPos(size_t x, size_t y) const {
+      emp_assert(IsGrid() && x < width && y < height, x, y, width, height);
+      return cell_pos[y * width + x];
+    }
+
+    // -- Tiles --
+    size_t GetNumTiles() const { return tiles_x * tiles_y; }
+    size_t GetNumTileColors() const { return num_colors; }
+    size_t GetTileColor(size_t tile_id) const { return tile_color[tile_id]; }
+    size_t GetTileSize() const { return num_cells / GetNumTiles(); }
+
+    /// Tile containing a position; tiles are contiguous, equal-sized ranges of positions.
+    size_t GetTile(size_t pos) const { return pos / GetTileSize(); }
+
+    /// Range of positions [first, last) covered by a tile.
+    std::pair<size_t, size_t> GetTileRange(size_t tile_id) const {
+      const size_t tile_size = GetTileSize();
+      return { tile_id * tile_size, (tile_id + 1) * tile_size };
+    }
+
+    /// Build a width x height grid.  With tile dimensions given (both at least two, and
+    /// dividing the grid evenly), cells are numbered tile by tile and tiles are colored.
+    bool SetupGrid(size_t _width, size_t _height, bool _toroidal, Type _type,
+                   size_t _tile_width=0, size_t _tile_height=0) {
+      emp_assert(_type != GRAPH);
+      Clear();
+      if (_tile_width || _tile_height) {
+        if (_tile_width < 2 || _tile_height < 2 ||
+            _width % _tile_width != 0 || _height % _tile_height != 0) {
+          emp::notify::Error("Neighborhood tiles must be at least 2x2 and evenly divide the ",
+                             _width, "x", _height, " grid; found ", _tile_width, "x", _tile_height, ".");
+          return false;
+        }
+      }
+      type = _type;
+      width = _width;
+      height = _height;
+      toroidal = _toroidal;
+      num_cells = width * height;
+
+      // Lay out positions tile by tile.
+      tile_width = _tile_width ? _tile_width : width;
+      tile_height = _tile_height ? _tile_height : height;
+      tiles_x = tile_width ? width / tile_width : 1;
+      tiles_y = tile_height ? height / tile_height : 1;
+      if (num_cells == 0) tiles_x = tiles_y = 1;
+      pos_x.resize(num_cells);
+      pos_y.resize(num_cells);
+      cell_pos.resize(num_cells);
+      size_t next_id = 0;
+      for (size_t ty = 0; ty < tiles_y; ++ty) {
+        for (size_t tx = 0; tx < tiles_x; ++tx) {
+          for (size_t y = ty * tile_height; y < (ty+1) * tile_height && y < height; ++y) {
+            for (size_t x = tx * tile_width; x < (tx+1) * tile_width && x < width; ++x) {
+              pos_x[next_id] = (uint32_t) x;
+              pos_y[next_id] = (uint32_t) y;
+              cell_pos[y * width + x] = (uint32_t) next_id;
+              ++next_id;
+            }
+          }
+        }
+      }
+      emp_assert(next_id == num_cells);
+
+      // Color tiles so that same-colored tiles are never adjacent.
+      const bool tiled = (GetNumTiles() > 1);
+      const size_t colors_x = (tiles_x == 1) ? 1 : ((toroidal && tiles_x % 2) ? 3 : 2);
+      const size_t colors_y = (tiles_y == 1) ? 1 : ((toroidal && tiles_y % 2) ? 3 : 2);
+      num_colors = tiled ? colors_x * colors_y : 1;
+      tile_color.resize(GetNumTiles());
+      for (size_t ty = 0; ty < tiles_y; ++ty) {
+        for (size_t tx = 0; tx < tiles_x; ++tx) {
+          tile_color[ty * tiles_x + tx] = (uint32_t)
+            (DimColor(ty, tiles_y, toroidal) * colors_x + DimColor(tx, tiles_x, toroidal));
+        }
+      }
+
+      // Build the neighbor table.
+      constexpr int moore_dx[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+      constexpr int moore_dy[] = {-1, -1, -1, 0, 0, 1, 1, 1};
+      constexpr int vn_dx[] = {0, -1, 1, 0};
+      constexpr int vn_dy[] = {-1, 0, 0, 1};
+      const int * dx = (type == MOORE) ? moore_dx : vn_dx;
+      const int * dy = (type == MOORE) ? moore_dy : vn_dy;
+      const size_t num_dirs = (type == MOORE) ? 8 : 4;
+
+      offsets.resize(num_cells + 1);
+      neighbors.reserve(num_cells * num_dirs);
+      for (size_t pos = 0; pos < num_cells; ++pos) {
+        offsets[pos] = (uint32_t) neighbors.size();
+        for (size_t dir = 0; dir < num_dirs; ++dir) {
+          long long x = (long long) pos_x[pos] + dx[dir];
+          long long y = (long long) pos_y[pos] + dy[dir];
+          if (toroidal) {
+            x = (x + (long long) width) % (long long) width;
+            y = (y + (long long) height) % (long long) height;
+          }
+          else if (x < 0 || y < 0 || x >= (long long) width || y >= (long long) height) continue;
+          const uint32_t next_pos = cell_pos[(size_t) y * width + (size_t) x];
+          if (next_pos == pos) continue;   // Tiny tori can wrap onto themselves...
+          bool dup = false;                // ...or reach the same cell twice.
+          for (size_t i = offsets[pos]; i < neighbors.size(); ++i) dup |= (neighbors[i] == next_pos);
+          if (!dup) neighbors.push_back(next_pos);
+        }
+      }
+      offsets[num_cells] = (uint32_t) neighbors.size();
+      return true;
+    }
+
+    /// Build an undirected graph with 'count' nodes from a list of edges between them.
+    bool SetupGraph(size_t count, const emp::vector<std::pair<size_t,size_t>> & edges) {
+      Clear();
+      type = GRAPH;
+      num_cells = count;
+      emp::vector<uint32_t> degree(count, 0);
+      for (auto [from, to] : edges) {
+        if (from >= count || to >= count) {
+          emp::notify::Error("Neighborhood edge (", from, ",", to, ") uses a node outside of 0 to ",
+                             count - 1, ".");
+          Clear();
+          return false;
+        }
+        if (from == to) continue;
+        ++degree[from];
+        ++degree[to];
+      }
+      offsets.resize(count + 1);
+      offsets[0] = 0;
+      for (size_t pos = 0; pos < count; ++pos) offsets[pos+1] = offsets[pos] + degree[pos];
+      neighbors.resize(offsets[count]);
+      emp::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+      for (auto [from, to] : edges) {
+        if (from == to) continue;
+        neighbors[next[from]++] = (uint32_t) to;
+        neighbors[next[to]++] = (uint32_t) from;
+      }
+      return true;
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ParetoFronts.hpp
+ *  @brief Non-dominated sorting and crowding distance for multi-objective selection.
+ *
+ *  Calc() takes the scores of N points on M objectives (all maximized), stored objective-major
+ *  so each objective's N scores are contiguous, and splits the points into Pareto fronts:
+ *  front 0 holds the points no other point dominates, front 1 those dominated only by front 0,
+ *  and so on.  Each point also gets the NSGA-II crowding distance within its front.
+ *
+ *  Sorting uses Efficient Non-dominated Sort with binary search (ENS-BS; Zhang et al. 2015):
+ *  points are visited in lexicographic order, so a point can only be dominated by points
+ *  already placed, and a binary search over the fronts finds the first one with no member
+ *  dominating it.  With two objectives only the last member of each front needs checking,
+ *  giving O(N log N); otherwise members are checked newest first, O(M N sqrt(N)) on typical
+ *  populations (O(M N^2) at worst).
+ *
+ *  Points with identical scores do not dominate each other, so they share a front.
+ */
+
+#ifndef MABE_TOOLS_PARETO_FRONTS_H
+#define MABE_TOOLS_PARETO_FRONTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  class ParetoFronts {
+  private:
+    size_t num_points = 0;
+    size_t num_objs = 0;
+    emp::vector<emp::vector<size_t>> fronts;  ///< Point IDs in each front, in sorted order.
+    emp::vector<size_t> rank;                 ///< Front of each point.
+    emp::vector<double> crowding;             ///< Crowding distance of each point.
+    emp::vector<size_t> order;                ///< Scratch: points in lexicographic order.
+
+    /// Does point a dominate point b?  (objective-major values, maximizing)
+    bool Dominates(std::span<const double> values, size_t a, size_t b) const {
+      bool better = false;
+      for (size_t obj = 0; obj < num_objs; ++obj) {
+        const double * column = values.data() + obj * num_points;
+        if (column[a] < column[b]) return false;
+        if (column[a] > column[b]) better = true;
+      }
+      return better;
+    }
+
+    /// Is point 'id' dominated by any member of front 'front_id'?
+    bool FrontDominates(std::span<const double> values, size_t front_id, size_t id) const {
+      const emp::vector<size_t> & front = fronts[front_id];
+      // With two objectives, the newest member has the highest second score in its front.
+      if (num_objs == 2) return Dominates(values, front.back(), id);
+      for (size_t i = front.size(); i-- > 0; ) {
+        if (Dominates(values, front[i], id)) return true;
+      }
+      return false;
+    }
+
+    void CalcCrowding(std::span<const double> values) {
+      crowding.assign(num_points, 0.0);
+      emp::vector<size_t> sorted;
+      for (const emp::vector<size_t> & front : fronts) {
+        if (front.size() <= 2) {
+          for (size_t id : front) crowding[id] = std::numeric_limits<double>::infinity();
+          continue;
+        }
+        sorted = front;
+        for (size_t obj = 0; obj < num_objs; ++obj) {
+          const double * column = values.data() + obj * num_points;
+          std::sort(sorted.begin(), sorted.end(),
+                    [column](size_t a, size_t b){ return column[a] < column[b]; });
+          const double range = column[sorted.back()] - column[sorted[0]];
+          crowding[sorted[0]] = crowding[sorted.back()] = std::numeric_limits<double>::infinity();
+          if (range <= 0.0) continue;
+          for (size_t i = 1; i + 1 < sorted.size(); ++i) {
+            crowding[sorted[i]] += (column[sorted[i+1]] - column[sorted[i-1]]) / range;
+          }
+        }
+      }
+    }
+
+  public:
+    /// Sort 'in_points' points by 'values', which holds values.size()/in_points objectives.
+    void Calc(std::span<const double> values, size_t in_points) {
+      num_points = in_points;
+      num_objs = num_points ? values.size() / num_points : 0;
+      emp_assert(num_objs * num_points == values.size(), values.size(), num_points);
+      fronts.resize(0);
+      rank.assign(num_points, 0);
+      if (num_points == 0) { crowding.resize(0); return; }
+
+      // Order points from best to worst lexicographically.
+      order.resize(num_points);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [this, values](size_t a, size_t b) {
+        for (size_t obj = 0; obj < num_objs; ++obj) {
+          const double * column = values.data() + obj * num_points;
+          if (column[a] != column[b]) return column[a] > column[b];
+        }
+        return a < b;
+      });
+
+      // Place each point in the first front that does not dominate it.  If front k
+      // dominates a point, so does every front before it, allowing a binary search.
+      for (size_t id : order) {
+        size_t low = 0, high = fronts.size();
+        while (low < high) {
+          const size_t mid = (low + high) / 2;
+          if (FrontDominates(values, mid, id)) low = mid + 1;
+          else high = mid;
+        }
+        if (low == fronts.size()) fronts.emplace_back();
+        fronts[low].push_back(id);
+        rank[id] = low;
+      }
+
+      CalcCrowding(values);
+    }
+
+    size_t GetNumPoints() const { return num_points; }
+    size_t GetNumObjectives() const { return num_objs; }
+    size_t GetNumFronts() const { return fronts.size(); }
+    const emp::vector<size_t> & GetFront(size_t front_id) const { return fronts[front_id]; }
+    size_t GetRank(size_t id) const { return rank[id]; }
+    double GetCrowding(size_t id) const { return crowding[id]; }
+
+    /// NSGA-II crowded comparison: is point a preferred to point b?
+    bool IsPreferred(size_t a, size_t b) const {
+      if (rank[a] != rank[b]) return rank[a] < rank[b];
+      return crowding[a] > crowding[b];
+    }
+  };
+
+}
+
+#endif
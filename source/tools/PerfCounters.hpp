@@ -0,0 +1,110 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  PerfCounters.hpp
+ *  @brief A group of hardware performance counters for the calling thread (Linux only).
+ *
+ *  PerfCounters opens cycles, instructions, last-level-cache misses, and branch misses as a
+ *  single perf_event group, so one read() returns all four consistently.  Counters are
+ *  user-space only, which works under the default perf_event_paranoid setting.  Where the
+ *  counters are unavailable (non-Linux systems, containers without perf access, or virtual
+ *  machines without a PMU) Open() returns false and Read() returns zeros.
+ *
+ *  DEVELOPER NOTES:
+ *  - Counters follow the thread that opened them; work done by ThreadPool workers is not
+ *    counted.
+ */
+
+#ifndef MABE_TOOLS_PERF_COUNTERS_H
+#define MABE_TOOLS_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#if defined(__linux__)
+#define MABE_PERF_COUNTERS_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mabe {
+
+  class PerfCounters {
+  public:
+    enum Counter : size_t { CYCLES=0, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, NUM_COUNTERS };
+    using values_t = std::array<uint64_t, NUM_COUNTERS>;
+
+    static const char * GetName(size_t id) {
+      static const char * names[NUM_COUNTERS] = { "cycles", "instructions", "llc_misses", "branch_misses" };
+      return names[id];
+    }
+
+  private:
+    std::array<int, NUM_COUNTERS> fds{-1, -1, -1, -1};
+
+  public:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters & operator=(const PerfCounters &) = delete;
+    ~PerfCounters() { Close(); }
+
+    bool IsOpen() const { return fds[0] >= 0; }
+
+#ifdef MABE_PERF_COUNTERS_LINUX
+    /// Open and start all counters; returns false (leaving none open) if any is unavailable.
+    bool Open() {
+      if (IsOpen()) return true;
+      static constexpr std::array<std::pair<uint32_t, uint64_t>, NUM_COUNTERS> events{{
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+      }};
+      for (size_t id = 0; id < NUM_COUNTERS; ++id) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = events[id].first;
+        attr.config = events[id].second;
+        attr.disabled = (id == 0);         // Leader starts disabled; the group is enabled at once.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        fds[id] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, id ? fds[0] : -1, 0);
+        if (fds[id] < 0) { Close(); return false; }
+      }
+      ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      return true;
+    }
+
+    void Close() {
+      for (int & fd : fds) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+      }
+    }
+
+    /// Current running totals of all counters (zeros if not open).
+    values_t Read() const {
+      values_t out{};
+      if (!IsOpen()) return out;
+      struct { uint64_t num; uint64_t values[NUM_COUNTERS]; } buffer;
+      if (read(fds[0], &buffer, sizeof(buffer)) != (ssize_t) sizeof(buffer)) return out;
+      for (size_t id = 0; id < NUM_COUNTERS; ++id) out[id] = buffer.values[id];
+      return out;
+    }
+#else
+    bool Open() { return false; }
+    void Close() { }
+    values_t Read() const { return values_t{}; }
+#endif
+  };
+
+}
+
+#endif
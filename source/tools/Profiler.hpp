@@ -0,0 +1,191 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Profiler.hpp
+ *  @brief Accumulates call counts and wall-clock time for named sections of a run.
+ *
+ *  Each named entry tracks how many times it was recorded, the total time spent, and the
+ *  single longest call.  Entries are looked up by name once with GetSlot(); the returned
+ *  slot ID can then be used with Record() so that timing a call does not require a string
+ *  lookup.  Results can be written as a table (sorted by total time) or as a CSV file.
+ *
+ *  If hardware counters are enabled (SetHardwareCounters), Begin()/End() pairs also record
+ *  cycles, instructions, LLC misses, and branch misses for each entry (see PerfCounters.hpp),
+ *  which are added as extra columns to the table and CSV output.
+ *
+ *  DEVELOPER NOTES:
+ *  - Recording is not thread safe; it is intended for the (serial) update loop.
+ */
+
+#ifndef MABE_TOOLS_PROFILER_H
+#define MABE_TOOLS_PROFILER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/tools/String.hpp"
+
+#include "PerfCounters.hpp"
+
+namespace mabe {
+
+  class Profiler {
+  public:
+    struct Entry {
+      emp::String name;
+      size_t count = 0;         ///< Number of calls recorded.
+      uint64_t total_ns = 0;    ///< Total time across all calls.
+      uint64_t max_ns = 0;      ///< Longest single call.
+      PerfCounters::values_t hw{};  ///< Hardware counter totals (if counters are enabled).
+
+      double GetMeanNS() const { return count ? ((double) total_ns) / (double) count : 0.0; }
+    };
+
+    /// Starting point of a timed section, from Begin().
+    struct Mark {
+      uint64_t ns = 0;
+      PerfCounters::values_t hw{};
+    };
+
+  private:
+    emp::vector<Entry> entries;
+    std::unordered_map<emp::String, size_t> slot_map;
+    PerfCounters counters;
+    bool use_counters = false;  ///< Are hardware counters open and being recorded?
+
+  public:
+    /// Current time in nanoseconds, for use as a start time.
+    static uint64_t Now() {
+      using namespace std::chrono;
+      return (uint64_t) duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool GetHardwareCounters() const { return use_counters; }
+
+    /// Turn hardware counters on or off; returns false if they were requested but unavailable.
+    bool SetHardwareCounters(bool on) {
+      if (on) use_counters = counters.Open();
+      else { counters.Close(); use_counters = false; }
+      return use_counters == on;
+    }
+
+    size_t GetSize() const { return entries.size(); }
+    const Entry & GetEntry(size_t slot) const { return entries[slot]; }
+
+    /// Find (or create) the slot for a named entry.
+    size_t GetSlot(const emp::String & name) {
+      auto it = slot_map.find(name);
+      if (it != slot_map.end()) return it->second;
+      slot_map[name] = entries.size();
+      entries.push_back(Entry{name});
+      return entries.size() - 1;
+    }
+
+    void Record(size_t slot, uint64_t ns) {
+      emp_assert(slot < entries.size(), slot, entries.size());
+      Entry & entry = entries[slot];
+      ++entry.count;
+      entry.total_ns += ns;
+      if (ns > entry.max_ns) entry.max_ns = ns;
+    }
+    void Record(const emp::String & name, uint64_t ns) { Record(GetSlot(name), ns); }
+
+    /// Start a section that will be recorded with End().
+    Mark Begin() const {
+      Mark mark;
+      if (use_counters) mark.hw = counters.Read();
+      mark.ns = Now();           // Read the clock last, so counter reads are not timed.
+      return mark;
+    }
+
+    /// Record a section started with Begin(), including hardware counts if enabled.
+    void End(size_t slot, const Mark & start) {
+      const uint64_t end_ns = Now();
+      Record(slot, end_ns - start.ns);
+      if (use_counters) {
+        const PerfCounters::values_t end_hw = counters.Read();
+        for (size_t id = 0; id < PerfCounters::NUM_COUNTERS; ++id) {
+          entries[slot].hw[id] += end_hw[id] - start.hw[id];
+        }
+      }
+    }
+
+    /// Reset all timings, but keep slots (so existing slot IDs remain valid).
+    void Clear() {
+      for (Entry & entry : entries) { entry.count = 0; entry.total_ns = 0; entry.max_ns = 0; entry.hw = {}; }
+    }
+
+    /// Return entries with at least one call, sorted by total time (largest first).
+    emp::vector<Entry> GetSorted() const {
+      emp::vector<Entry> out;
+      for (const Entry & entry : entries) if (entry.count) out.push_back(entry);
+      std::stable_sort(out.begin(), out.end(),
+        [](const Entry & a, const Entry & b){ return a.total_ns > b.total_ns; });
+      return out;
+    }
+
+    void WriteTable(std::ostream & os=std::cout) const {
+      os << std::left << std::setw(48) << "Section" << std::right
+         << std::setw(12) << "Calls" << std::setw(14) << "Total(ms)"
+         << std::setw(14) << "Mean(us)" << std::setw(14) << "Max(us)";
+      if (use_counters) {
+        os << std::setw(14) << "Mcycles" << std::setw(8) << "IPC"
+           << std::setw(14) << "LLC-miss/call" << std::setw(14) << "BrMiss/call";
+      }
+      os << '\n';
+      for (const Entry & entry : GetSorted()) {
+        os << std::left << std::setw(48) << entry.name << std::right
+           << std::setw(12) << entry.count
+           << std::fixed << std::setprecision(3)
+           << std::setw(14) << (entry.total_ns / 1.0e6)
+           << std::setw(14) << (entry.GetMeanNS() / 1.0e3)
+           << std::setw(14) << (entry.max_ns / 1.0e3);
+        if (use_counters) {
+          const double cycles = (double) entry.hw[PerfCounters::CYCLES];
+          os << std::setw(14) << (cycles / 1.0e6) << std::setprecision(2)
+             << std::setw(8) << (cycles ? entry.hw[PerfCounters::INSTRUCTIONS] / cycles : 0.0)
+             << std::setprecision(1)
+             << std::setw(14) << ((double) entry.hw[PerfCounters::LLC_MISSES] / entry.count)
+             << std::setw(14) << ((double) entry.hw[PerfCounters::BRANCH_MISSES] / entry.count);
+        }
+        os << '\n';
+      }
+      os.unsetf(std::ios_base::floatfield);
+      os << std::flush;
+    }
+
+    void WriteCSV(std::ostream & os) const {
+      os << "section,calls,total_ns,mean_ns,max_ns";
+      if (use_counters) {
+        for (size_t id = 0; id < PerfCounters::NUM_COUNTERS; ++id) os << ',' << PerfCounters::GetName(id);
+      }
+      os << '\n';
+      for (const Entry & entry : GetSorted()) {
+        os << '"' << entry.name << "\"," << entry.count << ',' << entry.total_ns << ','
+           << entry.GetMeanNS() << ',' << entry.max_ns;
+        if (use_counters) for (uint64_t value : entry.hw) os << ',' << value;
+        os << '\n';
+      }
+    }
+
+    /// Write a CSV file (overwriting any previous version); returns false if it can't be opened.
+    bool WriteCSV(const emp::String & filename) const {
+      std::ofstream os(filename);
+      if (!os) return false;
+      WriteCSV(os);
+      return true;
+    }
+  };
+
+}
+
+#endif
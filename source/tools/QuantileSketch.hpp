@@ -0,0 +1,140 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  QuantileSketch.hpp
+ *  @brief Approximate quantiles of a stream of values in bounded memory (a KLL sketch).
+ *
+ *  Values are added to level 0.  When a level fills, it is sorted and every other value
+ *  (starting at a coin-flip offset) moves up a level, where each one stands for twice as many
+ *  of the original values.  Lower levels get smaller capacities, so a sketch holds about
+ *  3k values no matter how many are added, and any quantile is within about 1.7/k of the right
+ *  rank (e.g., within 1% of the population for the default k of 200).  Sketches built from
+ *  separate parts of a stream (e.g., one per thread) can be merged.
+ *
+ *  The minimum and maximum are tracked exactly, so quantiles 0 and 1 are always exact.
+ *
+ *  DEVELOPER NOTES:
+ *  - Coin flips come from a small internal generator with a fixed seed, so the same values
+ *    added in the same order always give the same result.
+ */
+
+#ifndef MABE_TOOLS_QUANTILE_SKETCH_H
+#define MABE_TOOLS_QUANTILE_SKETCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  class QuantileSketch {
+  private:
+    size_t k = 200;                          ///< Capacity of the top level.
+    emp::vector<emp::vector<double>> levels; ///< Values at level h each stand for 2^h values.
+    size_t count = 0;                        ///< Number of values added.
+    double min_val = std::numeric_limits<double>::infinity();
+    double max_val = -std::numeric_limits<double>::infinity();
+    uint64_t coin_state = 0x9E3779B97F4A7C15ull;
+
+    size_t GetCapacity(size_t level) const {
+      const size_t depth = levels.size() - 1 - level;       // Levels below the top.
+      return std::max<size_t>(2, (size_t) std::ceil((double) k * std::pow(2.0 / 3.0, (double) depth)));
+    }
+
+    bool FlipCoin() {
+      coin_state ^= coin_state << 13;
+      coin_state ^= coin_state >> 7;
+      coin_state ^= coin_state << 17;
+      return coin_state & 1;
+    }
+
+    /// Compact every level that is over capacity.
+    void Compress() {
+      for (size_t level = 0; level < levels.size(); ++level) {
+        if (levels[level].size() < GetCapacity(level)) continue;
+        if (level + 1 == levels.size()) levels.emplace_back();
+        emp::vector<double> & cur = levels[level];
+        std::sort(cur.begin(), cur.end());
+        // With an odd count, the largest value stays behind so weights are preserved.
+        const size_t num_pairs = cur.size() / 2;
+        const size_t offset = FlipCoin() ? 1 : 0;
+        emp::vector<double> & next = levels[level + 1];
+        for (size_t i = 0; i < num_pairs; ++i) next.push_back(cur[2 * i + offset]);
+        const bool keep_last = cur.size() % 2;
+        const double last = cur.back();
+        cur.clear();
+        if (keep_last) cur.push_back(last);
+      }
+    }
+
+  public:
+    QuantileSketch(size_t in_k=200) : k(std::max<size_t>(in_k, 8)) { levels.emplace_back(); }
+
+    size_t GetK() const { return k; }
+    size_t GetCount() const { return count; }
+    double GetMin() const { return min_val; }
+    double GetMax() const { return max_val; }
+
+    /// Number of values currently held (bounded by about 3k).
+    size_t GetNumRetained() const {
+      size_t total = 0;
+      for (const auto & level : levels) total += level.size();
+      return total;
+    }
+
+    void Add(double value) {
+      if (std::isnan(value)) return;
+      ++count;
+      min_val = std::min(min_val, value);
+      max_val = std::max(max_val, value);
+      levels[0].push_back(value);
+      if (levels[0].size() >= GetCapacity(0)) Compress();
+    }
+
+    /// Fold another sketch (of other values) into this one.
+    void Merge(const QuantileSketch & other) {
+      if (!other.count) return;
+      while (levels.size() < other.levels.size()) levels.emplace_back();
+      for (size_t level = 0; level < other.levels.size(); ++level) {
+        levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+      }
+      count += other.count;
+      min_val = std::min(min_val, other.min_val);
+      max_val = std::max(max_val, other.max_val);
+      Compress();
+    }
+
+    /// Approximate value at quantile q (0.0 to 1.0); NaN if nothing has been added.
+    double GetQuantile(double q) const {
+      if (!count) return std::numeric_limits<double>::quiet_NaN();
+      if (q <= 0.0) return min_val;
+      if (q >= 1.0) return max_val;
+
+      emp::vector<std::pair<double, uint64_t>> weighted;
+      weighted.reserve(GetNumRetained());
+      uint64_t total_weight = 0;
+      for (size_t level = 0; level < levels.size(); ++level) {
+        for (double value : levels[level]) weighted.emplace_back(value, uint64_t{1} << level);
+        total_weight += levels[level].size() << level;
+      }
+      std::sort(weighted.begin(), weighted.end());
+      const double target = q * (double) total_weight;
+      uint64_t cum_weight = 0;
+      for (const auto & [value, weight] : weighted) {
+        cum_weight += weight;
+        if ((double) cum_weight >= target) return value;
+      }
+      return max_val;
+    }
+  };
+
+}
+
+#endif
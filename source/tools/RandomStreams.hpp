@@ -0,0 +1,71 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  RandomStreams.hpp
+ *  @brief Derive independent, reproducible random number streams from a single base seed.
+ *
+ *  A RandomStreams object maps a base seed plus any set of integer keys (such as update,
+ *  population ID, and position) to a distinct seed for an emp::Random object.  Since the
+ *  derived seed depends only on the keys, work done in parallel can give each task its own
+ *  generator and still produce identical results for any number of threads or task order.
+ *
+ *  Keys are combined with the SplitMix64 finalizer, which is cheap and thoroughly mixes bits,
+ *  so nearby keys (e.g., adjacent positions) produce unrelated seeds.
+ */
+
+#ifndef MABE_TOOLS_RANDOM_STREAMS_H
+#define MABE_TOOLS_RANDOM_STREAMS_H
+
+#include <cstdint>
+
+#include "emp/math/Random.hpp"
+
+namespace mabe {
+
+  class RandomStreams {
+  private:
+    uint64_t base_seed = 1;
+
+  public:
+    /// SplitMix64 step and finalizer; a bijective scramble of all 64 bits.
+    static constexpr uint64_t Mix(uint64_t x) {
+      x += 0x9e3779b97f4a7c15ULL;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      return x ^ (x >> 31);
+    }
+
+    RandomStreams(uint64_t in_seed=1) : base_seed(in_seed) { }
+
+    uint64_t GetBaseSeed() const { return base_seed; }
+    void SetBaseSeed(uint64_t in_seed) { base_seed = in_seed; }
+
+    /// Combine the base seed with all provided keys into a single 64-bit stream key.
+    template <typename... Ts>
+    uint64_t CalcKey(Ts... keys) const {
+      uint64_t key = Mix(base_seed);
+      ((key = Mix(key ^ static_cast<uint64_t>(keys))), ...);
+      return key;
+    }
+
+    /// Convert a stream key into a seed that emp::Random will accept.  Seeds must be
+    /// positive (zero or negative seeds are replaced with a time-based seed).
+    template <typename... Ts>
+    int CalcSeed(Ts... keys) const {
+      return static_cast<int>(CalcKey(keys...) % 2147483646ULL) + 1;
+    }
+
+    /// Reset an existing generator to the start of the stream for the provided keys.
+    template <typename... Ts>
+    void Reseed(emp::Random & rng, Ts... keys) const { rng.ResetSeed(CalcSeed(keys...)); }
+
+    /// Build a new generator positioned at the start of the stream for the provided keys.
+    template <typename... Ts>
+    emp::Random Make(Ts... keys) const { return emp::Random(CalcSeed(keys...)); }
+  };
+
+}
+
+#endif
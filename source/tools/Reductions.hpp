@@ -0,0 +1,97 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Reductions.hpp
+ *  @brief Floating-point sums and maxima whose results do not depend on how work is split.
+ *
+ *  Floating-point addition is not associative, so summing per-thread partial totals gives a
+ *  result that changes with the number of threads.  Reduce::SumOf() instead fixes the shape
+ *  of the sum by the number of values alone: values are summed in order within consecutive
+ *  blocks of BLOCK_SIZE, and the block sums are then added pairwise, level by level.  Block
+ *  sums can be computed in any order or on any thread (see ThreadPool::SumOf()) and the total
+ *  is bit-identical.  Pairwise combination also keeps the rounding error growing only with
+ *  the log of the number of blocks.
+ *
+ *  Maxima are exact, but ties and NaNs still need fixed rules: Reduce::IsNewMax() skips NaN
+ *  values (the max is NaN only if every value is) and keeps the first of tied values, so an
+ *  argmax is always the lowest position holding the maximum.
+ */
+
+#ifndef MABE_TOOLS_REDUCTIONS_H
+#define MABE_TOOLS_REDUCTIONS_H
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+namespace Reduce {
+
+  static constexpr size_t BLOCK_SIZE = 64;   ///< Values summed in order before pairing.
+
+  /// Number of blocks that 'count' values are summed in.
+  inline size_t CalcNumBlocks(size_t count) { return (count + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+
+  /// In-order sum of fun(id) over block 'block_id' of [0, count).
+  template <typename FUN_T>
+  double SumBlock(size_t block_id, size_t count, FUN_T && fun) {
+    const size_t start = block_id * BLOCK_SIZE;
+    const size_t end = std::min(start + BLOCK_SIZE, count);
+    double total = 0.0;
+    for (size_t id = start; id < end; ++id) total += (double) fun(id);
+    return total;
+  }
+
+  /// Combine block sums pairwise, level by level (an odd sum out moves up unchanged).
+  /// 'sums' is used as scratch space.
+  inline double CombineBlocks(emp::vector<double> & sums) {
+    if (sums.empty()) return 0.0;
+    for (size_t width = sums.size(); width > 1; width = (width + 1) / 2) {
+      for (size_t i = 0; i < width / 2; ++i) sums[i] = sums[2*i] + sums[2*i + 1];
+      if (width % 2) sums[width / 2] = sums[width - 1];
+    }
+    return sums[0];
+  }
+
+  /// Sum of fun(id) over [0, count), in the fixed shape described above.
+  template <typename FUN_T>
+  double SumOf(size_t count, FUN_T && fun) {
+    if (count <= BLOCK_SIZE) return SumBlock(0, count, fun);
+    emp::vector<double> sums(CalcNumBlocks(count));
+    for (size_t block_id = 0; block_id < sums.size(); ++block_id) {
+      sums[block_id] = SumBlock(block_id, count, fun);
+    }
+    return CombineBlocks(sums);
+  }
+
+  inline double Sum(std::span<const double> values) {
+    return SumOf(values.size(), [values](size_t id){ return values[id]; });
+  }
+
+  /// Should 'value' replace 'best' as the running maximum?  NaNs never win, and ties keep the
+  /// earlier value, so the result does not depend on how values are grouped.
+  inline bool IsNewMax(double value, double best) {
+    return value > best || (std::isnan(best) && !std::isnan(value));
+  }
+
+  /// Position of the maximum of fun(id) over [0, count), using IsNewMax(); 0 if count is 0.
+  template <typename FUN_T>
+  size_t ArgMaxOf(size_t count, FUN_T && fun) {
+    if (count == 0) return 0;
+    size_t best_id = 0;
+    double best = (double) fun(0);
+    for (size_t id = 1; id < count; ++id) {
+      const double value = (double) fun(id);
+      if (IsNewMax(value, best)) { best = value; best_id = id; }
+    }
+    return best_id;
+  }
+
+}
+}
+
+#endif
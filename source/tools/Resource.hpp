@@ -4,8 +4,10 @@
  *  @date 2018-2024.
  *
  *  @file
- *  @brief Implement resource-based selection.
+ *  @brief Resource pools for resource-based selection (see select/SelectResource.hpp).
  *
+ *  Organisms feed on each pool in turn, gaining a fitness bonus that grows with their task
+ *  score and the pool's remaining amount, and depleting the pool as they do (as in Eco-EA).
  *
  *  @todo Ultimately, we probably want a much more full-featured resource system.
  *        This one works for Eco-EA and could be the basis for something Avida-like
@@ -16,7 +18,12 @@
 #ifndef MABE_TOOLS_RESOURCE_HPP
 #define MABE_TOOLS_RESOURCE_HPP
 
-#include "emp/Evolve/World.hpp"
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
 
 namespace mabe {
 
@@ -59,112 +66,56 @@ namespace mabe {
         }
     };
 
-    template <typename ORG>
-    void ResourceSelect(World<ORG> & world, const emp::vector< std::function<double(const ORG &)> > & extra_funs,
-                   emp::vector<emp::Resource> & pools, size_t t_size, size_t tourny_count=1, double frac = .0025, double max_bonus = 5, double cost = 0, bool use_base = true) {
-
-       emp_assert(world.GetFitFun(), "Must define a base fitness function");
-       emp_assert(world.GetSize() > 0);
-       emp_assert(t_size > 0, t_size);
-    //    emp_assert(world.IsCacheOn() == false, "Ecologies mean constantly changing fitness!");
-
-       // Setup info to track fitnesses.
-       emp::vector<double> base_fitness(world.GetSize());
-       emp::vector< emp::vector<double> > extra_fitnesses(extra_funs.size());
-       for (size_t i=0; i < extra_funs.size(); i++) {
-         extra_fitnesses[i].resize(world.GetSize());
-       }
-
-       // Collect all fitness info.
-    //    std::cout << extra_funs.size() << std::endl;
-
-       for (size_t org_id = 0; org_id < world.GetSize(); org_id++) {
-        //    std::cout << org_id << std::endl;
-         if (!world.IsOccupied(org_id)) {
-             continue;
-         }
-        //  std::cout << "still going" << std::endl;
-         if (use_base) {
-            base_fitness[org_id] = world.CalcFitnessID(org_id);
-         } else {
-            base_fitness[org_id] = 0;
-         }
-
-         for (size_t ex_id = 0; ex_id < extra_funs.size(); ex_id++) {
-            //  std::cout << "Test " << ex_id << std::endl;
-
-           pools[ex_id].Inc(pools[ex_id].GetInflow()/world.GetNumOrgs());
-           double cur_fit = extra_funs[ex_id](world.GetOrg(org_id));
-           cur_fit = emp::Pow(cur_fit, 2.0);
-            //    if (org_id==0) {std::cout << "Allele: " << world[org_id][ex_id] <<" Curr fit: " << extra_funs[ex_id](world[org_id]) << " Curr fit squared: " << cur_fit << " Amount: " << pools[ex_id].GetAmount() << " Frac: " << frac;}
-            cur_fit *= frac*(pools[ex_id].GetAmount()-cost);
-            if (cur_fit > 0) {
-                cur_fit -= cost;
-            } else {
-                cur_fit = 0;
+    /// A set of resource pools, stored contiguously so a whole population can feed on each
+    /// pool in one pass.  Pools are independent, so different pools may be consumed at once.
+    class ResourcePools {
+    private:
+        emp::vector<double> amounts;
+        emp::vector<double> inflows;
+        emp::vector<double> outflows;
+
+    public:
+        /// How much each organism takes from a pool, given its task score.
+        struct Params {
+            double frac = 0.0025;    ///< Fraction of (amount - cost) taken per squared task score.
+            double max_bonus = 5.0;  ///< Largest bonus (in doublings of fitness) from one pool.
+            double cost = 0.0;       ///< Cost of using a pool, removed from each bonus.
+        };
+
+        void Setup(size_t num_pools, double amount, double inflow, double outflow) {
+            amounts.assign(num_pools, amount);
+            inflows.assign(num_pools, inflow);
+            outflows.assign(num_pools, outflow);
+        }
+
+        size_t GetSize() const { return amounts.size(); }
+        double GetAmount(size_t pool_id) const { return amounts[pool_id]; }
+        std::span<const double> GetAmounts() const { return amounts; }
+        void SetAmount(size_t pool_id, double amt) { amounts[pool_id] = amt; }
+        void SetInflow(size_t pool_id, double in) { inflows[pool_id] = in; }
+        void SetOutflow(size_t pool_id, double out) { outflows[pool_id] = out; }
+
+        /// Let organisms feed on one pool in order.  'scores' holds each organism's task score
+        /// for this pool, and each bonus (in doublings of fitness) is written to 'bonuses'.
+        /// The pool's inflow arrives spread across the organisms, and its outflow is removed
+        /// once all have fed.
+        void Consume(size_t pool_id, std::span<const double> scores, std::span<double> bonuses,
+                     const Params & params) {
+            emp_assert(pool_id < amounts.size(), pool_id, amounts.size());
+            emp_assert(bonuses.size() == scores.size(), bonuses.size(), scores.size());
+            if (scores.empty()) return;
+            const double inflow = inflows[pool_id] / (double) scores.size();
+            double amount = amounts[pool_id];
+            for (size_t i = 0; i < scores.size(); ++i) {
+                amount += inflow;
+                double bonus = scores[i] * scores[i] * params.frac * (amount - params.cost);
+                bonus = (bonus > 0.0) ? std::min(bonus - params.cost, params.max_bonus) : 0.0;
+                bonuses[i] = bonus;
+                amount = std::max(amount - std::abs(bonus), 0.0);
             }
-        //    if (org_id==0) {std::cout << " Multiplied out: " << cur_fit;}
-           cur_fit = std::min(cur_fit, max_bonus);
-        //    if (org_id==0) {std::cout << " Final: " << cur_fit << std::endl;}
-           extra_fitnesses[ex_id][org_id] = emp::Pow2(cur_fit);
-        //    std::cout << "Fit before:  = " << base_fitness[org_id] << "   Res: " << pools[ex_id].GetAmount();
-           base_fitness[org_id] *= emp::Pow2(cur_fit);
-           pools[ex_id].Dec(std::abs(cur_fit));
-        //    std::cout << "   Bonus " << ex_id << " = " << extra_funs[ex_id](world[org_id]) << " "<< emp::Pow(2.0,cur_fit) << " " << emp::MakeString(world[org_id])
-        // //              << "   fitnes = " << base_fitness[org_id]
-        //              << std::endl;
-
-         }
-       }
-
-    //    std::cout << "Resource allocations" << std::endl;
-    //    std::cout << emp::MakeString(base_fitness) << std::endl;
-    //    std::cout << emp::MakeString(world[0]) << std::endl;
-    //    std::cout << world.CalcFitnessID(0);
-
-    //    for (size_t ex_id = 0; ex_id < extra_funs.size(); ex_id++) {
-    //        std::cout << extra_fitnesses[ex_id][0] << " ";
-    //    }
-    //    std::cout << std::endl;
-
-       emp::vector<size_t> entries;
-       for (size_t T = 0; T < tourny_count; T++) {
-         entries.resize(0);
-        //  std::cout << T << std::endl;
-         for (size_t i=0; i<t_size; i++) entries.push_back( world.GetRandomOrgID() ); // Allows replacement!
-
-         double best_fit = base_fitness[entries[0]];
-         size_t best_id = entries[0];
-
-         // Search for a higher fit org in the tournament.
-         for (size_t i = 1; i < t_size; i++) {
-           const double cur_fit = base_fitness[entries[i]];
-           if (cur_fit > best_fit) {
-             best_fit = cur_fit;
-             best_id = entries[i];
-           }
-         }
-
-         // Place the highest fitness into the next generation!
-         world.DoBirth( world.GetGenomeAt(best_id), best_id, 1 );
-       }
-
-        // IndexMap fitness_index(world.GetSize());
-        // for (size_t id = 0; id < world.GetSize(); id++) {
-        //   fitness_index.Adjust(id, base_fitness[id]);
-        // }
-        //
-        // for (size_t n = 0; n < tourny_count; n++) {
-        //   const double fit_pos = world.GetRandom().GetDouble(std::min(fitness_index.GetWeight(), 99999.9));
-        //   const size_t parent_id = fitness_index.Index(fit_pos);
-        //   const size_t offspring_id = world.DoBirth( world.GetGenomeAt(parent_id), parent_id ).index;
-        //   if (world.IsSynchronous() == false) {
-        //     fitness_index.Adjust(offspring_id, world.CalcFitnessID(offspring_id));
-        //   }
-        // }
-
-
-    }
+            amounts[pool_id] = amount - amount * outflows[pool_id];
+        }
+    };
 
 }
 
@@ -0,0 +1,245 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ShardComm.hpp
+ *  @brief Collective exchanges between the ranks that each hold one shard of a population.
+ *
+ *  A sharded population is one logical population whose positions are split across several
+ *  ranks (processes or threads); each rank holds and evaluates its own shard.  A ShardComm is
+ *  the only link between ranks, and offers just two collectives, both of which every rank must
+ *  call in the same order:
+ *
+ *    AllGather(value)  - Returns the value given by each rank, in rank order.
+ *    AllToAll(send)    - send[r] is a byte string for rank r; returns the string each rank
+ *                        sent to this one.
+ *
+ *  Three implementations are provided:
+ *
+ *    LocalShardComm   - A single rank (no exchange); an unsharded run.
+ *    ThreadShardGroup - Ranks as threads of one process, synchronized with a barrier.  GetComm(r)
+ *                       gives rank r its ShardComm.  Used for tests and for trying out sharded
+ *                       configurations without MPI.
+ *    MPIShardComm     - Ranks as MPI processes (MPI_Allgather and MPI_Alltoallv over a
+ *                       communicator).  Only available when compiled with MABE_USE_MPI (and
+ *                       linked against an MPI library); MPI_Init must be called by the driver.
+ *
+ *  ShardLayout maps between global ids (0 to total-1 over all shards, in rank order) and
+ *  ShardPos (a rank plus an index within that rank's shard).  PackValues() and UnpackValues()
+ *  turn vectors of plain values into the byte strings sent by AllToAll().
+ */
+
+#ifndef MABE_TOOLS_SHARD_COMM_H
+#define MABE_TOOLS_SHARD_COMM_H
+
+#include <algorithm>
+#include <barrier>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+#ifdef MABE_USE_MPI
+#include <mpi.h>
+#endif
+
+namespace mabe {
+
+  /// An entry in a shard: the rank holding it and its index within that rank's shard.
+  struct ShardPos {
+    uint32_t rank = 0;
+    uint64_t index = 0;
+
+    bool operator==(const ShardPos &) const = default;
+  };
+
+  class ShardComm {
+  public:
+    virtual ~ShardComm() { }
+
+    virtual size_t GetRank() const = 0;
+    virtual size_t GetNumRanks() const = 0;
+
+    /// Collect one value from every rank, in rank order.
+    virtual emp::vector<double> AllGather(double value) = 0;
+
+    /// Send send[r] to rank r (send must have one entry per rank); return the strings received,
+    /// indexed by the rank that sent them.
+    virtual emp::vector<std::string> AllToAll(emp::vector<std::string> send) = 0;
+  };
+
+  /// An unsharded run: the only rank exchanges with itself.
+  class LocalShardComm : public ShardComm {
+  public:
+    size_t GetRank() const override { return 0; }
+    size_t GetNumRanks() const override { return 1; }
+    emp::vector<double> AllGather(double value) override { return emp::vector<double>{value}; }
+    emp::vector<std::string> AllToAll(emp::vector<std::string> send) override {
+      emp_assert(send.size() == 1);
+      return send;
+    }
+  };
+
+  /// All ranks are threads in this process; each thread calls collectives on its own GetComm().
+  class ThreadShardGroup {
+  private:
+    class Comm : public ShardComm {
+    private:
+      ThreadShardGroup & group;
+      size_t rank;
+
+    public:
+      Comm(ThreadShardGroup & _group, size_t _rank) : group(_group), rank(_rank) { }
+
+      size_t GetRank() const override { return rank; }
+      size_t GetNumRanks() const override { return group.num_ranks; }
+
+      emp::vector<double> AllGather(double value) override {
+        group.values[rank] = value;
+        group.sync.arrive_and_wait();
+        emp::vector<double> out(group.values.begin(), group.values.end());
+        group.sync.arrive_and_wait();   // No rank may write the next value before all read.
+        return out;
+      }
+
+      emp::vector<std::string> AllToAll(emp::vector<std::string> send) override {
+        emp_assert(send.size() == group.num_ranks);
+        const size_t N = group.num_ranks;
+        for (size_t to = 0; to < N; ++to) group.mail[rank * N + to] = std::move(send[to]);
+        group.sync.arrive_and_wait();
+        emp::vector<std::string> out(N);
+        for (size_t from = 0; from < N; ++from) out[from] = std::move(group.mail[from * N + rank]);
+        group.sync.arrive_and_wait();
+        return out;
+      }
+    };
+
+    size_t num_ranks;
+    std::barrier<> sync;
+    emp::vector<double> values;      ///< AllGather slot for each rank.
+    emp::vector<std::string> mail;   ///< AllToAll slot for each (sender, receiver) pair.
+    emp::vector<Comm> comms;
+
+  public:
+    ThreadShardGroup(size_t _num_ranks)
+      : num_ranks(_num_ranks), sync((std::ptrdiff_t) _num_ranks)
+      , values(_num_ranks), mail(_num_ranks * _num_ranks)
+    {
+      emp_assert(num_ranks > 0);
+      comms.reserve(num_ranks);
+      for (size_t rank = 0; rank < num_ranks; ++rank) comms.emplace_back(*this, rank);
+    }
+    ThreadShardGroup(const ThreadShardGroup &) = delete;
+
+    size_t GetNumRanks() const { return num_ranks; }
+    ShardComm & GetComm(size_t rank) { return comms[rank]; }
+  };
+
+#ifdef MABE_USE_MPI
+  /// Ranks are the processes of an MPI communicator (MPI_COMM_WORLD by default).
+  class MPIShardComm : public ShardComm {
+  private:
+    MPI_Comm comm;
+    int rank = 0;
+    int num_ranks = 1;
+
+  public:
+    MPIShardComm(MPI_Comm _comm=MPI_COMM_WORLD) : comm(_comm) {
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &num_ranks);
+    }
+
+    size_t GetRank() const override { return (size_t) rank; }
+    size_t GetNumRanks() const override { return (size_t) num_ranks; }
+
+    emp::vector<double> AllGather(double value) override {
+      emp::vector<double> out((size_t) num_ranks);
+      MPI_Allgather(&value, 1, MPI_DOUBLE, out.data(), 1, MPI_DOUBLE, comm);
+      return out;
+    }
+
+    /// Sizes are exchanged first, then all strings in a single MPI_Alltoallv.
+    emp::vector<std::string> AllToAll(emp::vector<std::string> send) override {
+      emp_assert(send.size() == (size_t) num_ranks);
+      const size_t N = (size_t) num_ranks;
+      emp::vector<int> send_counts(N), recv_counts(N), send_offsets(N), recv_offsets(N);
+      for (size_t r = 0; r < N; ++r) send_counts[r] = (int) send[r].size();
+      MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+
+      std::string send_buf, recv_buf;
+      for (size_t r = 0; r < N; ++r) {
+        send_offsets[r] = (int) send_buf.size();
+        send_buf += send[r];
+      }
+      size_t recv_total = 0;
+      for (size_t r = 0; r < N; ++r) {
+        recv_offsets[r] = (int) recv_total;
+        recv_total += (size_t) recv_counts[r];
+      }
+      recv_buf.resize(recv_total);
+      MPI_Alltoallv(send_buf.data(), send_counts.data(), send_offsets.data(), MPI_BYTE,
+                    recv_buf.data(), recv_counts.data(), recv_offsets.data(), MPI_BYTE, comm);
+
+      emp::vector<std::string> out(N);
+      for (size_t r = 0; r < N; ++r) out[r] = recv_buf.substr(recv_offsets[r], recv_counts[r]);
+      return out;
+    }
+  };
+#endif
+
+  /// Where the entries of each shard fall in the global order.  Built collectively: every rank
+  /// gives its own shard size.
+  class ShardLayout {
+  private:
+    emp::vector<uint64_t> offsets;   ///< Global id of the first entry of each rank (plus total).
+
+  public:
+    ShardLayout() : offsets{0} { }
+    ShardLayout(ShardComm & comm, size_t local_size) {
+      const emp::vector<double> sizes = comm.AllGather((double) local_size);
+      offsets.resize(sizes.size() + 1);
+      offsets[0] = 0;
+      for (size_t r = 0; r < sizes.size(); ++r) offsets[r+1] = offsets[r] + (uint64_t) sizes[r];
+    }
+
+    size_t GetNumRanks() const { return offsets.size() - 1; }
+    uint64_t GetTotal() const { return offsets.back(); }
+    uint64_t GetOffset(size_t rank) const { return offsets[rank]; }
+    uint64_t GetSize(size_t rank) const { return offsets[rank+1] - offsets[rank]; }
+
+    uint64_t ToGlobal(ShardPos pos) const { return offsets[pos.rank] + pos.index; }
+
+    /// Find the shard holding a global id (empty shards are skipped).
+    ShardPos ToShard(uint64_t global_id) const {
+      emp_assert(global_id < GetTotal(), global_id, GetTotal());
+      const size_t rank = (size_t) (std::upper_bound(offsets.begin(), offsets.end(), global_id)
+                                    - offsets.begin()) - 1;
+      return ShardPos{ (uint32_t) rank, global_id - offsets[rank] };
+    }
+  };
+
+  /// Append the raw bytes of 'values' to 'out'.
+  template <typename T>
+  inline void PackValues(std::string & out, std::span<const T> values) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be packed.");
+    out.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+  }
+
+  /// Read back values written by PackValues(); 'in' must hold a whole number of values.
+  template <typename T>
+  inline emp::vector<T> UnpackValues(const std::string & in) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be unpacked.");
+    emp_assert(in.size() % sizeof(T) == 0, in.size(), sizeof(T));
+    emp::vector<T> out(in.size() / sizeof(T));
+    if (out.size()) std::memcpy(out.data(), in.data(), out.size() * sizeof(T));
+    return out;
+  }
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ShardSelect.hpp
+ *  @brief Selection over a population whose shards are held by different ranks.
+ *
+ *  Each rank selects the parents for its own births, but may pick parents from any shard.
+ *  Every function here is a collective (see ShardComm.hpp): all ranks must call it, in the
+ *  same order, even those with no births this round.  Entries are identified by ShardPos, with
+ *  the index into each rank's own list of candidates (e.g., its living organisms).
+ *
+ *  PickRoulette() - Each rank shares only its total weight; owners are drawn by total weight,
+ *                   then each owner draws the requested number of entries from its own weights
+ *                   (with an AliasTable).  Two exchanges, each sending one value per parent.
+ *  PickTournament() - Contestants are drawn uniformly over all shards; owners return the
+ *                   fitness of each contestant requested from them, and the requester keeps the
+ *                   best (ties go to the first drawn; see Reduce::IsNewMax).  Two exchanges.
+ *  FetchParents() - Gathers the serialized state of every remote parent in one exchange per
+ *                   direction.  Each distinct parent is sent once to each rank that chose it;
+ *                   parents on the calling rank are not sent at all.
+ */
+
+#ifndef MABE_TOOLS_SHARD_SELECT_H
+#define MABE_TOOLS_SHARD_SELECT_H
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "AliasTable.hpp"
+#include "Reductions.hpp"
+#include "ShardComm.hpp"
+
+namespace mabe {
+
+  /// Result of FetchParents(): payloads[payload_ids[i]] holds parent i, or payload_ids[i]
+  /// is LOCAL if parent i is on the calling rank.
+  struct ShardParents {
+    static constexpr size_t LOCAL = (size_t) -1;
+    emp::vector<std::string> payloads;
+    emp::vector<size_t> payload_ids;
+  };
+
+namespace ShardSelect {
+
+  /// Draw 'count' parents for this rank with probability proportional to weight over all
+  /// shards.  If every weight on every rank is zero, no parents are returned.
+  inline emp::vector<ShardPos> PickRoulette(ShardComm & comm, std::span<const double> weights,
+                                            size_t count, emp::Random & random) {
+    const size_t num_ranks = comm.GetNumRanks();
+    const AliasTable local_table(emp::vector<double>(weights.begin(), weights.end()));
+    const emp::vector<double> totals = comm.AllGather(local_table.GetWeight());
+    const bool any_weight = std::any_of(totals.begin(), totals.end(), [](double w){ return w > 0.0; });
+
+    // Choose the owner of each parent, and ask each owner for its share.
+    emp::vector<uint32_t> owners(any_weight ? count : 0);
+    emp::vector<uint64_t> requests(num_ranks, 0);
+    if (any_weight) {
+      const AliasTable rank_table(totals);
+      for (uint32_t & owner : owners) {
+        owner = (uint32_t) rank_table.Draw(random);
+        ++requests[owner];
+      }
+    }
+    emp::vector<std::string> send(num_ranks);
+    for (size_t r = 0; r < num_ranks; ++r) PackValues<uint64_t>(send[r], std::span(&requests[r], 1));
+    const emp::vector<std::string> asked = comm.AllToAll(std::move(send));
+
+    // Draw the entries each rank asked this one for.
+    send.assign(num_ranks, std::string());
+    for (size_t r = 0; r < num_ranks; ++r) {
+      const emp::vector<uint64_t> num = UnpackValues<uint64_t>(asked[r]);
+      emp_assert(num.size() == 1);
+      emp::vector<uint64_t> picks(num[0]);
+      for (uint64_t & pick : picks) pick = local_table.Draw(random);
+      PackValues<uint64_t>(send[r], picks);
+    }
+    const emp::vector<std::string> replies = comm.AllToAll(std::move(send));
+
+    emp::vector<emp::vector<uint64_t>> picks(num_ranks);
+    for (size_t r = 0; r < num_ranks; ++r) picks[r] = UnpackValues<uint64_t>(replies[r]);
+    emp::vector<size_t> next(num_ranks, 0);
+    emp::vector<ShardPos> parents(owners.size());
+    for (size_t i = 0; i < parents.size(); ++i) {
+      const uint32_t owner = owners[i];
+      parents[i] = ShardPos{ owner, picks[owner][next[owner]++] };
+    }
+    return parents;
+  }
+
+  /// Run 'count' tournaments of 'tourny_size' contestants drawn uniformly from all shards;
+  /// 'fitness' has one value per local candidate.  No parents if all shards are empty.
+  inline emp::vector<ShardPos> PickTournament(ShardComm & comm, std::span<const double> fitness,
+                                              size_t count, size_t tourny_size,
+                                              emp::Random & random) {
+    emp_assert(tourny_size > 0);
+    const size_t num_ranks = comm.GetNumRanks();
+    const ShardLayout layout(comm, fitness.size());
+    if (layout.GetTotal() == 0) count = 0;
+
+    // Draw all contestants up front and request each one's fitness from its owner.
+    emp::vector<ShardPos> contestants(count * tourny_size);
+    emp::vector<emp::vector<uint64_t>> requests(num_ranks);
+    for (ShardPos & pos : contestants) {
+      pos = layout.ToShard(random.GetUInt((size_t) layout.GetTotal()));
+      requests[pos.rank].push_back(pos.index);
+    }
+    emp::vector<std::string> send(num_ranks);
+    for (size_t r = 0; r < num_ranks; ++r) PackValues<uint64_t>(send[r], requests[r]);
+    const emp::vector<std::string> asked = comm.AllToAll(std::move(send));
+
+    send.assign(num_ranks, std::string());
+    for (size_t r = 0; r < num_ranks; ++r) {
+      const emp::vector<uint64_t> ids = UnpackValues<uint64_t>(asked[r]);
+      emp::vector<double> values(ids.size());
+      for (size_t i = 0; i < ids.size(); ++i) values[i] = fitness[ids[i]];
+      PackValues<double>(send[r], values);
+    }
+    const emp::vector<std::string> replies = comm.AllToAll(std::move(send));
+
+    // Replies come back in request order, so walk the contestants in the order drawn.
+    emp::vector<emp::vector<double>> values(num_ranks);
+    for (size_t r = 0; r < num_ranks; ++r) values[r] = UnpackValues<double>(replies[r]);
+    emp::vector<size_t> next(num_ranks, 0);
+    emp::vector<ShardPos> winners(count);
+    for (size_t t = 0; t < count; ++t) {
+      double best = 0.0;
+      for (size_t c = 0; c < tourny_size; ++c) {
+        const ShardPos pos = contestants[t * tourny_size + c];
+        const double value = values[pos.rank][next[pos.rank]++];
+        if (c == 0 || Reduce::IsNewMax(value, best)) { best = value; winners[t] = pos; }
+      }
+    }
+    return winners;
+  }
+
+  /// Collect the state of each remote parent; save(index, out) must append the state of the
+  /// local candidate 'index' to 'out'.
+  template <typename SAVE_T>
+  ShardParents FetchParents(ShardComm & comm, std::span<const ShardPos> parents, SAVE_T && save) {
+    const size_t num_ranks = comm.GetNumRanks();
+    const size_t my_rank = comm.GetRank();
+
+    // Ask each owner once for each distinct parent it holds.
+    emp::vector<emp::vector<uint64_t>> wanted(num_ranks);
+    for (const ShardPos & pos : parents) {
+      if (pos.rank != my_rank) wanted[pos.rank].push_back(pos.index);
+    }
+    for (auto & ids : wanted) {
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    emp::vector<std::string> send(num_ranks);
+    for (size_t r = 0; r < num_ranks; ++r) PackValues<uint64_t>(send[r], wanted[r]);
+    const emp::vector<std::string> asked = comm.AllToAll(std::move(send));
+
+    // Each state is sent as its length followed by its bytes.
+    send.assign(num_ranks, std::string());
+    std::string state;
+    for (size_t r = 0; r < num_ranks; ++r) {
+      for (uint64_t index : UnpackValues<uint64_t>(asked[r])) {
+        state.clear();
+        save((size_t) index, state);
+        const uint64_t length = state.size();
+        PackValues<uint64_t>(send[r], std::span(&length, 1));
+        send[r] += state;
+      }
+    }
+    const emp::vector<std::string> replies = comm.AllToAll(std::move(send));
+
+    ShardParents out;
+    emp::vector<size_t> first_payload(num_ranks, 0);
+    for (size_t r = 0; r < num_ranks; ++r) {
+      first_payload[r] = out.payloads.size();
+      const std::string & reply = replies[r];
+      size_t offset = 0;
+      while (offset < reply.size()) {
+        uint64_t length = 0;
+        emp_assert(offset + sizeof(length) <= reply.size());
+        std::memcpy(&length, reply.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        out.payloads.push_back(reply.substr(offset, length));
+        offset += length;
+      }
+      emp_assert(out.payloads.size() - first_payload[r] == wanted[r].size());
+    }
+
+    out.payload_ids.resize(parents.size());
+    for (size_t i = 0; i < parents.size(); ++i) {
+      const ShardPos & pos = parents[i];
+      if (pos.rank == my_rank) { out.payload_ids[i] = ShardParents::LOCAL; continue; }
+      const auto & ids = wanted[pos.rank];
+      out.payload_ids[i] = first_payload[pos.rank]
+        + (size_t) (std::lower_bound(ids.begin(), ids.end(), pos.index) - ids.begin());
+    }
+    return out;
+  }
+
+}
+}
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SharedMemoryCache.hpp
+ *  @brief Immutable arrays shared between processes through memory-mapped files.
+ *
+ *  Separate MABE processes on one machine (such as a cluster job array) often build the same
+ *  large read-only table.  SharedMemoryCache::GetArray() looks for the table in a cache
+ *  directory (by default /dev/shm, which is kept in memory) under a name derived from a key
+ *  that fully describes it.  If found, the file is mapped read-only, so every process shares
+ *  the same physical pages.  Otherwise the table is filled into a new file, which is then
+ *  published under its final name and mapped the same way.
+ *
+ *  Only trivially copyable element types may be cached.  Each file starts with a header
+ *  recording the key's hash, element size, and count, and a file that does not match is
+ *  rebuilt.  If files cannot be used (or on systems without mmap), the table is built in this
+ *  process's memory instead.
+ *
+ *  DEVELOPER NOTES:
+ *  - A new table is written to a file private to this process and renamed into place, so
+ *    other processes never see a partial table.  Processes that race to build the same key
+ *    produce identical files, and the last rename wins.
+ *  - Cached files persist until removed (or the machine reboots, for /dev/shm).
+ */
+
+#ifndef MABE_TOOLS_SHARED_MEMORY_CACHE_H
+#define MABE_TOOLS_SHARED_MEMORY_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MABE_SHARED_MEMORY_CACHE_MMAP 1
+#endif
+
+#include "emp/base/notify.hpp"
+
+namespace mabe {
+
+  class SharedMemoryCache {
+  private:
+    static constexpr uint64_t MAGIC = 0x4D414245534D4331ULL;  // "MABESMC1"
+
+    struct Header {
+      uint64_t magic;
+      uint64_t key_hash;
+      uint64_t elem_size;
+      uint64_t count;
+    };
+    static constexpr size_t DATA_OFFSET = 64;  // Keep the data aligned past the header.
+    static_assert(sizeof(Header) <= DATA_OFFSET);
+
+    /// FNV-1a hash, so file names do not depend on the standard library in use.
+    static uint64_t CalcKeyHash(std::string_view key) {
+      uint64_t hash = 0xcbf29ce484222325ULL;
+      for (char c : key) hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+      return hash;
+    }
+
+    static std::string CalcPath(const std::string & key, const std::string & dir) {
+      char hash_str[17];
+      std::snprintf(hash_str, sizeof(hash_str), "%016llx", (unsigned long long) CalcKeyHash(key));
+      return dir + "/mabe_" + hash_str;
+    }
+
+    template <typename T, typename FUN_T>
+    static std::shared_ptr<const T> BuildLocal(size_t count, FUN_T && fill) {
+      T * values = new T[count]();
+      fill(std::span<T>(values, count));
+      return std::shared_ptr<const T>(values, [](const T * ptr){ delete [] ptr; });
+    }
+
+#ifdef MABE_SHARED_MEMORY_CACHE_MMAP
+    /// Map 'path' read-only if it holds a table matching 'header'; otherwise return null.
+    template <typename T>
+    static std::shared_ptr<const T> MapFile(const std::string & path, const Header & header) {
+      const int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0) return nullptr;
+      const size_t num_bytes = DATA_OFFSET + header.count * sizeof(T);
+      struct stat info;
+      void * addr = MAP_FAILED;
+      if (fstat(fd, &info) == 0 && (size_t) info.st_size == num_bytes) {
+        addr = mmap(nullptr, num_bytes, PROT_READ, MAP_SHARED, fd, 0);
+      }
+      close(fd);  // The mapping stays valid without the descriptor.
+      if (addr == MAP_FAILED) return nullptr;
+
+      const Header & found = *static_cast<const Header *>(addr);
+      if (found.magic != header.magic || found.key_hash != header.key_hash ||
+          found.elem_size != header.elem_size || found.count != header.count) {
+        munmap(addr, num_bytes);
+        return nullptr;
+      }
+      const T * data = reinterpret_cast<const T *>(static_cast<const char *>(addr) + DATA_OFFSET);
+      return std::shared_ptr<const T>(data, [addr, num_bytes](const T *){ munmap(addr, num_bytes); });
+    }
+
+    /// Fill a new table in a private file, then publish it at 'path'.  Returns success.
+    template <typename T, typename FUN_T>
+    static bool WriteFile(const std::string & path, const Header & header, FUN_T && fill) {
+      static std::atomic<size_t> num_writes = 0;   // Keeps threads' files apart, too.
+      const std::string tmp_path = path + ".tmp" + std::to_string((long long) getpid())
+                                 + "_" + std::to_string(num_writes++);
+      const int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) return false;
+      const size_t num_bytes = DATA_OFFSET + header.count * sizeof(T);
+      void * addr = MAP_FAILED;
+      if (ftruncate(fd, (off_t) num_bytes) == 0) {
+        addr = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+      close(fd);
+      if (addr == MAP_FAILED) { unlink(tmp_path.c_str()); return false; }
+
+      T * data = reinterpret_cast<T *>(static_cast<char *>(addr) + DATA_OFFSET);
+      for (size_t i = 0; i < header.count; ++i) new (data + i) T();
+      fill(std::span<T>(data, header.count));
+      *static_cast<Header *>(addr) = header;  // Only a filled table gets a valid header.
+      munmap(addr, num_bytes);
+      if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        return false;
+      }
+      return true;
+    }
+#endif
+
+  public:
+    /// Get a read-only array of 'count' values for 'key', calling fill(std::span<T>) to build
+    /// it if no process has cached it in 'dir' yet.
+    template <typename T, typename FUN_T>
+    static std::shared_ptr<const T> GetArray(const std::string & key, size_t count, FUN_T && fill,
+                                             const std::string & dir="/dev/shm") {
+      static_assert(std::is_trivially_copyable<T>(), "Only trivially copyable values can be cached.");
+#ifdef MABE_SHARED_MEMORY_CACHE_MMAP
+      const Header header{MAGIC, CalcKeyHash(key), sizeof(T), count};
+      const std::string path = CalcPath(key, dir);
+
+      if (auto found = MapFile<T>(path, header)) return found;
+      if (WriteFile<T>(path, header, fill)) {
+        if (auto found = MapFile<T>(path, header)) return found;
+      }
+      emp::notify::Warning("Unable to use shared memory cache '", path, "'; building '", key,
+                           "' in this process.");
+#endif
+      return BuildLocal<T>(count, fill);
+    }
+
+    /// Remove the cached file for 'key' (if any); processes that mapped it keep their copy.
+    static bool Remove(const std::string & key, const std::string & dir="/dev/shm") {
+      return std::remove(CalcPath(key, dir).c_str()) == 0;
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SharedResources.hpp
+ *  @brief A process-wide registry of immutable, reference-counted resources.
+ *
+ *  When several MABE controllers run in one process (see the --replicates option), each
+ *  would otherwise build its own copy of large read-only tables, such as an NK landscape
+ *  drawn from a fixed seed.  A module instead asks for the resource by a key that fully
+ *  describes it; the first request builds it, and later requests with the same key share it
+ *  for as long as any of them holds it.  Once the last holder releases it, a new request
+ *  builds it again.
+ *
+ *  Resources are handed out as std::shared_ptr<const T>, so they must not be changed after
+ *  being built.  Requesting a key with a different type than the one it was built with is an
+ *  error.
+ *
+ *  DEVELOPER NOTES:
+ *  - Builders run while the registry is locked, so replicates that need the same resource wait
+ *    for the first one to finish it instead of building their own copy.  Builders must not
+ *    request other shared resources.
+ */
+
+#ifndef MABE_TOOLS_SHARED_RESOURCES_H
+#define MABE_TOOLS_SHARED_RESOURCES_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+
+#include "emp/base/notify.hpp"
+
+namespace mabe {
+
+  class SharedResources {
+  private:
+    struct Entry {
+      std::type_index type = typeid(void);
+      std::weak_ptr<const void> resource;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    size_t num_builds = 0;
+    mutable std::mutex registry_mutex;
+
+  public:
+    /// The registry shared by every controller in this process.
+    static SharedResources & Global() {
+      static SharedResources registry;
+      return registry;
+    }
+
+    /// Get the resource for 'key', building it with 'build()' (which returns a T) if no one
+    /// holds it now.
+    template <typename T, typename FUN_T>
+    std::shared_ptr<const T> Get(const std::string & key, FUN_T && build) {
+      std::lock_guard<std::mutex> lock(registry_mutex);
+      Entry & entry = entries[key];
+      if (std::shared_ptr<const void> found = entry.resource.lock()) {
+        if (entry.type != std::type_index(typeid(T))) {
+          emp::notify::Error("Shared resource '", key, "' was requested with the wrong type.");
+          return nullptr;
+        }
+        return std::static_pointer_cast<const T>(found);
+      }
+      auto resource = std::make_shared<const T>(build());
+      entry.type = typeid(T);
+      entry.resource = resource;
+      ++num_builds;
+      return resource;
+    }
+
+    /// Number of resources currently held by at least one user.
+    size_t GetNumActive() const {
+      std::lock_guard<std::mutex> lock(registry_mutex);
+      size_t count = 0;
+      for (const auto & [key, entry] : entries) count += !entry.resource.expired();
+      return count;
+    }
+
+    /// Number of times any resource has been built.
+    size_t GetNumBuilds() const {
+      std::lock_guard<std::mutex> lock(registry_mutex);
+      return num_builds;
+    }
+
+    /// Forget keys whose resources are no longer held.
+    void Prune() {
+      std::lock_guard<std::mutex> lock(registry_mutex);
+      std::erase_if(entries, [](const auto & key_entry){ return key_entry.second.resource.expired(); });
+    }
+  };
+
+}
+
+#endif
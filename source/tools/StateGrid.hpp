@@ -9,6 +9,11 @@
  *  State grids are a matrix of values, representing states of a 2D environment that an organism
  *  can traverse.
  *
+ *  After a grid is loaded, BuildMoveTable() precomputes where a single step forward or back
+ *  leads from every position and facing, so agents moving one tile at a time do a table
+ *  lookup instead of recomputing wrapped or clamped coordinates.  GetStateMask() caches the
+ *  positions holding each state until the grid is next modified.
+ *
  *  @todo Functions such as Load() should throw exceptions (or equilv.), not use asserts.
  *  @todo Need to figure out a default mapping for how outputs translate to moves around a
  *    state grid.  -1 = Back up ; 0 = Turn left ; 1 = Move fast-forwards ; 2 = Turn right
@@ -20,6 +25,7 @@
 #ifndef MABE_TOOLS_STATE_GRID_HPP
 #define MABE_TOOLS_STATE_GRID_HPP
 
+#include <cstdint>
 #include <map>
 
 #include "emp/base/assert.hpp"
@@ -114,6 +120,13 @@ namespace mabe {
                                       one side wrap to the opposite side.
                                    If false, agents are clamped to the grid. */
 
+    /// Position reached by one step from [(pos*8 + facing)*2 + (backward ? 1 : 0)]; empty
+    /// until BuildMoveTable() is called, and cleared if the grid's shape changes.
+    emp::vector<uint32_t> move_table;
+    mutable std::map<int, emp::BitVector> state_masks;  ///< Cached results of GetStateMask()
+
+    void ClearStateMasks() { if (state_masks.size()) state_masks.clear(); }
+
   public:
     StateGrid() : width(0), height(0), states(0), info(), is_toroidal(false) { ; }
     StateGrid(StateGridInfo & _i, size_t _w=1, size_t _h=1, 
@@ -138,6 +151,7 @@ namespace mabe {
     int & operator()(size_t x, size_t y) {
       emp_assert(x < width, x, width);
       emp_assert(y < height, y, height);
+      ClearStateMasks();
       return states[y*width+x];
     }
     int operator()(size_t x, size_t y) const {
@@ -155,6 +169,7 @@ namespace mabe {
       emp_assert(x < width, x, width);
       emp_assert(y < height, y, height);
       states[y*width+x] = in;
+      ClearStateMasks();
       return *this;
     }
     char GetSymbol(size_t x, size_t y) const {
@@ -173,11 +188,57 @@ namespace mabe {
       return info.GetName(GetState(x,y));
     }
     bool GetIsToroidal() const { return is_toroidal; }
-    void SetIsToroidal(bool b){ is_toroidal = b; }
+    void SetIsToroidal(bool b){
+      if (b != is_toroidal) move_table.resize(0);
+      is_toroidal = b;
+    }
+
+    /// Move a single coordinate 'steps' along an axis of length 'size', wrapping or clamping.
+    static size_t StepCoord(size_t coord, int steps, size_t size, bool toroidal) {
+      const int target = (int) coord + steps;
+      if (toroidal) return (size_t) emp::Mod(target, (int) size);
+      if (target < 0) return 0;
+      return (target >= (int) size) ? size - 1 : (size_t) target;
+    }
+
+    /// Precompute the destination of a single step forward or backward from every position
+    /// and facing (0=UL, 1=Up, ... 7=Left, as in StateGridStatus).
+    void BuildMoveTable() {
+      static constexpr int dx[8] = {-1, 0, 1, 1, 1, 0, -1, -1};
+      static constexpr int dy[8] = {-1, -1, -1, 0, 1, 1, 1, 0};
+      move_table.resize(states.size() * 16);
+      for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+          const size_t base = (y * width + x) * 16;
+          for (size_t facing = 0; facing < 8; ++facing) {
+            for (int dir = 0; dir < 2; ++dir) {
+              const int steps = dir ? -1 : 1;
+              const size_t new_x = StepCoord(x, dx[facing] * steps, width, is_toroidal);
+              const size_t new_y = StepCoord(y, dy[facing] * steps, height, is_toroidal);
+              move_table[base + facing * 2 + dir] = (uint32_t) (new_y * width + new_x);
+            }
+          }
+        }
+      }
+    }
+    bool HasMoveTable() const { return move_table.size(); }
+
+    /// Position one step from 'pos' with the given facing (BuildMoveTable() must be called).
+    size_t GetNextPos(size_t pos, size_t facing, bool backward=false) const {
+      emp_assert(HasMoveTable());
+      emp_assert(pos < states.size() && facing < 8, pos, facing);
+      return move_table[(pos * 8 + facing) * 2 + (backward ? 1 : 0)];
+    }
 
     /// Return a BitVector indicating which positions in the state grid have a particular state.
-    emp::BitVector IsState(int target_state) {
-      emp::BitVector sites(states.size());
+    emp::BitVector IsState(int target_state) const { return GetStateMask(target_state); }
+
+    /// As IsState(), but returns a reference to a mask cached until the grid next changes.
+    const emp::BitVector & GetStateMask(int target_state) const {
+      auto it = state_masks.find(target_state);
+      if (it != state_masks.end()) return it->second;
+      emp::BitVector & sites = state_masks[target_state];
+      sites.Resize(states.size());
       for (size_t i = 0; i < states.size(); i++) sites[i] = (states[i] == target_state);
       return sites;
     }
@@ -208,6 +269,8 @@ namespace mabe {
       // Now that we have the new size, resize the state grid.
       size_t size = width * height;
       states.resize(size);
+      move_table.resize(0);
+      ClearStateMasks();
 
       // Load in the specific states.
       for (size_t row = 0; row < height; row++) {
@@ -374,6 +437,13 @@ namespace mabe {
 
     /// Move in the direction currently faced.
     void Move(const StateGrid & grid, int steps=1) {
+      if ((steps == 1 || steps == -1) && grid.HasMoveTable()) {
+        const size_t next = grid.GetNextPos(GetIndex(grid), GetFacing(), steps < 0);
+        cur_state.x = next % grid.GetWidth();
+        cur_state.y = next / grid.GetWidth();
+        UpdateHistory();
+        return;
+      }
        //std::cout << "steps = " << steps
        //          << "  facing = " << cur_state.facing
        //          << "  start = (" << cur_state.x << "," << cur_state.y << ")";
@@ -0,0 +1,418 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ThreadPool.hpp
+ *  @brief A small, persistent pool of worker threads for splitting a range into chunks.
+ *
+ *  The pool keeps its workers alive between jobs so that evaluating a population every update
+ *  does not pay for thread creation.  A job is a function that is called once per chunk with
+ *  the chunk ID and the [start, end) range it covers; chunk boundaries depend only on the
+ *  range size and the number of chunks, so results stored per-chunk can be reduced in order
+ *  to produce the same answer as a serial loop.  The calling thread also processes chunks.
+ *
+ *  With SetPinThreads(true), each thread is pinned to the CPUs of one NUMA node (threads are
+ *  spread over nodes in contiguous blocks) and chunks are assigned statically: thread t always
+ *  processes the same contiguous block of chunks.  Repeated jobs over the same population then
+ *  touch each organism from the same node every update, trading dynamic load balancing for
+ *  memory locality.  Pinning is only available on Linux; elsewhere it has no effect.
+ *
+ *  When items take very different times (e.g., organisms with genomes of different lengths),
+ *  ForEachByCost() takes an estimated cost per item, starts the most costly items first, and
+ *  groups the rest into small chunks of about equal total cost.  Idle threads take the next
+ *  chunk as they finish, even when threads are pinned, so no thread sits waiting on a slow one.
+ *
+ *  DEVELOPER NOTES:
+ *  - When EMP_TRACK_MEM is defined, emp::Ptr tracking is not thread safe, so all jobs are run
+ *    serially on the calling thread.
+ *  - A job started from inside another job's chunk (e.g., a module run by ForEachTask() that
+ *    evaluates a population) runs all of its chunks serially on that thread.
+ */
+
+#ifndef MABE_TOOLS_THREAD_POOL_H
+#define MABE_TOOLS_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#define MABE_THREAD_POOL_AFFINITY
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+#include "Reductions.hpp"
+
+namespace mabe {
+
+  class ThreadPool {
+  public:
+    /// Job functions take a chunk ID and the [start, end) range that chunk covers.
+    using chunk_fun_t = std::function<void(size_t chunk_id, size_t start, size_t end)>;
+
+  private:
+    emp::vector<std::thread> workers;   ///< Extra threads (calling thread is not included).
+    size_t num_threads = 1;             ///< Total threads, including the calling thread.
+    size_t chunks_per_thread = 4;       ///< Divide work finer than threads to balance load.
+    static constexpr size_t COST_CHUNKS_PER_THREAD = 16;  ///< Finer still for ForEachByCost().
+    size_t min_chunk_size = 1;          ///< Never make chunks smaller than this.
+    bool pin_threads = false;           ///< Pin threads to NUMA nodes and assign chunks statically?
+
+    // Shared state for the current job, protected by job_mutex.
+    std::mutex job_mutex;
+    std::condition_variable start_cv;   ///< Wakes workers when a new job arrives.
+    std::condition_variable done_cv;    ///< Wakes the caller when all workers are done.
+    chunk_fun_t job_fun;
+    size_t job_id = 0;                  ///< Incremented for each new job.
+    size_t job_count = 0;               ///< Size of the range being processed.
+    size_t job_chunks = 0;              ///< Number of chunks in the current job.
+    size_t busy_workers = 0;            ///< Workers that have not finished the current job.
+    bool job_dynamic = false;           ///< Hand out chunks on demand even if threads are pinned?
+    bool stopping = false;              ///< Set when the pool is being torn down.
+    std::exception_ptr job_error = nullptr;
+    std::atomic<size_t> next_chunk{0};
+
+    /// Is this thread currently running a chunk (of any pool's job)?
+    static inline thread_local bool in_job = false;
+
+    size_t ChunkStart(size_t chunk_id) const { return job_count * chunk_id / job_chunks; }
+
+    void RunChunk(size_t id) {
+      in_job = true;
+      try { job_fun(id, ChunkStart(id), ChunkStart(id+1)); }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        if (!job_error) job_error = std::current_exception();
+      }
+      in_job = false;
+    }
+
+    /// Run 'fun' on 'num_chunks' equal chunks of [0, count), split across the threads; if
+    /// 'dynamic', threads take chunks as they finish, even when pinned.
+    void RunJob(size_t count, size_t num_chunks, const chunk_fun_t & fun, bool dynamic=false) {
+      // Nested jobs (or tiny ones) use the same chunks, but all on the calling thread.
+      if (num_chunks <= 1 || in_job) {
+        for (size_t id = 0; id < num_chunks; ++id) {
+          fun(id, count * id / num_chunks, count * (id+1) / num_chunks);
+        }
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        job_fun = fun;
+        job_count = count;
+        job_chunks = num_chunks;
+        job_error = nullptr;
+        job_dynamic = dynamic;
+        next_chunk = 0;
+        busy_workers = workers.size();
+        ++job_id;
+      }
+      start_cv.notify_all();
+
+      RunChunks(0);  // The calling thread helps out.
+
+      std::unique_lock<std::mutex> lock(job_mutex);
+      done_cv.wait(lock, [this](){ return busy_workers == 0; });
+      job_fun = nullptr;
+      if (job_error) std::rethrow_exception(job_error);
+    }
+
+    // Grab chunks until none are left (or, if pinned, run this thread's own block of chunks).
+    void RunChunks(size_t thread_id) {
+      if (pin_threads && !job_dynamic) {
+        const size_t end = job_chunks * (thread_id + 1) / num_threads;
+        for (size_t id = job_chunks * thread_id / num_threads; id < end; ++id) RunChunk(id);
+        return;
+      }
+      for (size_t id = next_chunk++; id < job_chunks; id = next_chunk++) RunChunk(id);
+    }
+
+    /// Parse a Linux CPU list (e.g., "0-7,16-23") into CPU IDs.
+    static emp::vector<size_t> ParseCPUList(const std::string & list) {
+      emp::vector<size_t> cpus;
+      size_t pos = 0;
+      while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        const std::string range = list.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        if (range.size()) {
+          const size_t first = std::stoul(range.substr(0, dash));
+          const size_t last = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+          for (size_t cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        pos = end + 1;
+      }
+      return cpus;
+    }
+
+    /// Pin the calling thread to the CPUs of the node assigned to 'thread_id' (or, if
+    /// 'all_nodes', allow it to run on the CPUs of every node again).
+    void PinThread([[maybe_unused]] size_t thread_id, [[maybe_unused]] bool all_nodes=false) const {
+#ifdef MABE_THREAD_POOL_AFFINITY
+      const emp::vector<emp::vector<size_t>> nodes = GetNumaNodes();
+      if (nodes.size() == 0) return;
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      for (size_t node_id = 0; node_id < nodes.size(); ++node_id) {
+        if (!all_nodes && node_id != thread_id * nodes.size() / num_threads) continue;
+        for (size_t cpu : nodes[node_id]) if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpu_set);
+      }
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+    }
+
+    void StartWorkers() {
+      if (!IsParallel()) return;
+      if (pin_threads) PinThread(0);
+      // New workers must wait for the NEXT job, not wake for one that has already finished.
+      size_t cur_job = 0;
+      {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        cur_job = job_id;
+      }
+      for (size_t i = 1; i < num_threads; ++i) {
+        workers.emplace_back([this, i, cur_job](){
+          if (pin_threads) PinThread(i);
+          WorkerLoop(i, cur_job);
+        });
+      }
+    }
+
+    void WorkerLoop(size_t thread_id, size_t last_job) {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(job_mutex);
+          start_cv.wait(lock, [this, last_job](){ return stopping || job_id != last_job; });
+          if (stopping) return;
+          last_job = job_id;
+        }
+        RunChunks(thread_id);
+        {
+          std::lock_guard<std::mutex> lock(job_mutex);
+          if (--busy_workers == 0) done_cv.notify_one();
+        }
+      }
+    }
+
+    void StopWorkers() {
+      {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        stopping = true;
+      }
+      start_cv.notify_all();
+      for (auto & worker : workers) worker.join();
+      workers.resize(0);
+      stopping = false;
+    }
+
+  public:
+    ThreadPool(size_t in_threads=1) { SetNumThreads(in_threads); }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+    ~ThreadPool() { StopWorkers(); }
+
+    /// How many threads (including the caller) will work on each job?
+    size_t GetNumThreads() const { return num_threads; }
+
+    /// Will jobs actually be split across threads?
+    bool IsParallel() const {
+#ifdef EMP_TRACK_MEM
+      return false;
+#else
+      return num_threads > 1;
+#endif
+    }
+
+    /// Set the number of threads to use; 0 means use all available hardware threads.
+    void SetNumThreads(size_t in_threads) {
+      if (in_threads == 0) in_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+      if (in_threads == num_threads && workers.size() + 1 == num_threads) return;
+      StopWorkers();
+      num_threads = in_threads;
+      StartWorkers();
+    }
+
+    /// CPUs in each NUMA node (from /sys on Linux); empty if the layout is unknown.
+    static emp::vector<emp::vector<size_t>> GetNumaNodes() {
+      emp::vector<emp::vector<size_t>> nodes;
+#ifdef MABE_THREAD_POOL_AFFINITY
+      for (size_t node = 0; ; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (!(file >> list)) break;
+        emp::vector<size_t> cpus = ParseCPUList(list);
+        if (cpus.size()) nodes.push_back(cpus);
+      }
+#endif
+      return nodes;
+    }
+
+    bool GetPinThreads() const { return pin_threads; }
+
+    /// Pin each thread (including the caller) to a NUMA node and assign chunks statically.
+    void SetPinThreads(bool in_pin) {
+      if (in_pin == pin_threads) return;
+      StopWorkers();
+      pin_threads = in_pin;
+      if (!pin_threads) PinThread(0, true);   // Release the calling thread.
+      StartWorkers();
+    }
+
+    /// Split work more finely than one chunk per thread for better load balance.
+    void SetChunksPerThread(size_t in_chunks) { chunks_per_thread = std::max<size_t>(1, in_chunks); }
+
+    /// Don't create chunks smaller than this (to avoid overhead on tiny jobs).
+    void SetMinChunkSize(size_t in_size) { min_chunk_size = std::max<size_t>(1, in_size); }
+
+    /// How many chunks will a job over 'count' items be split into?
+    size_t CalcNumChunks(size_t count) const {
+      if (!IsParallel() || count <= min_chunk_size) return count ? 1 : 0;
+      return std::min(num_threads * chunks_per_thread, count / min_chunk_size);
+    }
+
+    /// Call fun(chunk_id, start, end) for each chunk covering [0, count); returns the number
+    /// of chunks used.  Any exception thrown by a chunk is re-thrown here after all chunks finish.
+    size_t ForEachChunk(size_t count, const chunk_fun_t & fun) {
+      const size_t num_chunks = CalcNumChunks(count);
+      RunJob(count, num_chunks, fun);
+      return num_chunks;
+    }
+
+    /// Call fun(id) for each id in [0, count), each as its own chunk regardless of chunk
+    /// settings; meant for a few large, independent tasks rather than a range of small items.
+    template <typename FUN_T>
+    void ForEachTask(size_t count, FUN_T && fun) {
+      const size_t num_chunks = IsParallel() ? count : std::min<size_t>(count, 1);
+      RunJob(count, num_chunks, [&fun](size_t, size_t start, size_t end){
+        for (size_t id = start; id < end; ++id) fun(id);
+      });
+    }
+
+    /// Call fun(id) for each id in [0, count).
+    template <typename FUN_T>
+    void ForEach(size_t count, FUN_T && fun) {
+      ForEachChunk(count, [&fun](size_t, size_t start, size_t end){
+        for (size_t id = start; id < end; ++id) fun(id);
+      });
+    }
+
+    /// Call fun(id) for each id in [0, costs.size()), where costs[id] estimates how long that call
+    /// takes (in any unit); unknown costs (zero, negative, or NaN) are taken to be the mean of
+    /// the known ones.  Ids are started most costly first, in chunks of about equal total cost.
+    template <typename FUN_T>
+    void ForEachByCost(std::span<const double> costs, FUN_T && fun) {
+      const size_t count = costs.size();
+      if (!IsParallel() || count <= 1) {
+        for (size_t id = 0; id < count; ++id) fun(id);
+        return;
+      }
+
+      // Fill in unknown costs; if none are known, every item costs the same.
+      double known_total = 0.0;
+      size_t num_known = 0;
+      for (double cost : costs) if (cost > 0.0) { known_total += cost; ++num_known; }
+      const double default_cost = num_known ? known_total / (double) num_known : 1.0;
+      auto cost_of = [costs, default_cost](size_t id) { return costs[id] > 0.0 ? costs[id] : default_cost; };
+
+      // Longest-processing-time order (ties keep id order, so the order does not vary by run).
+      emp::vector<size_t> order(count);
+      for (size_t id = 0; id < count; ++id) order[id] = id;
+      std::stable_sort(order.begin(), order.end(),
+                       [&cost_of](size_t a, size_t b){ return cost_of(a) > cost_of(b); });
+
+      // Cut the order into chunks of about equal cost; a costly item may get a chunk to itself.
+      double total = 0.0;
+      for (size_t id = 0; id < count; ++id) total += cost_of(id);
+      const size_t target_chunks = std::min(count, num_threads * COST_CHUNKS_PER_THREAD);
+      const double chunk_cost = total / (double) target_chunks;
+      emp::vector<size_t> bounds{0};
+      double cur_cost = 0.0;
+      for (size_t i = 0; i + 1 < count; ++i) {
+        cur_cost += cost_of(order[i]);
+        if (cur_cost >= chunk_cost) { bounds.push_back(i + 1); cur_cost = 0.0; }
+      }
+      bounds.push_back(count);
+
+      const size_t num_chunks = bounds.size() - 1;
+      RunJob(num_chunks, num_chunks, [&fun, &order, &bounds](size_t chunk_id, size_t, size_t) {
+        for (size_t i = bounds[chunk_id]; i < bounds[chunk_id + 1]; ++i) fun(order[i]);
+      }, true);
+    }
+
+    /// Return the position of the maximum of fun(id) over [0, count) (0 if count is zero).
+    /// NaNs are skipped and ties go to the lowest position (see Reduce::IsNewMax()), and chunk
+    /// results are combined in order, so the result does not depend on the number of threads.
+    template <typename FUN_T>
+    size_t ArgMaxOf(size_t count, FUN_T && fun) {
+      if (count == 0) return 0;
+      emp::vector<size_t> chunk_best(CalcNumChunks(count), 0);
+      emp::vector<double> chunk_max(chunk_best.size(), 0.0);
+      ForEachChunk(count, [&fun, &chunk_best, &chunk_max](size_t chunk_id, size_t start, size_t end) {
+        size_t best_id = start;
+        double max_val = fun(start);
+        for (size_t id = start+1; id < end; ++id) {
+          const double val = fun(id);
+          if (Reduce::IsNewMax(val, max_val)) { max_val = val; best_id = id; }
+        }
+        chunk_best[chunk_id] = best_id;
+        chunk_max[chunk_id] = max_val;
+      });
+      size_t best = 0;
+      for (size_t i = 1; i < chunk_best.size(); ++i) {
+        if (Reduce::IsNewMax(chunk_max[i], chunk_max[best])) best = i;
+      }
+      return chunk_best[best];
+    }
+
+    /// Return the maximum of fun(id) over [0, count), or 0.0 if count is zero.  NaNs are
+    /// skipped (the result is NaN only if every value is).
+    template <typename FUN_T>
+    double MaxOf(size_t count, FUN_T && fun) {
+      if (count == 0) return 0.0;
+      emp::vector<double> chunk_max(CalcNumChunks(count), 0.0);
+      ForEachChunk(count, [&fun, &chunk_max](size_t chunk_id, size_t start, size_t end) {
+        double max_val = fun(start);
+        for (size_t id = start+1; id < end; ++id) {
+          const double val = fun(id);
+          if (Reduce::IsNewMax(val, max_val)) max_val = val;
+        }
+        chunk_max[chunk_id] = max_val;
+      });
+      double max_val = chunk_max[0];
+      for (double val : chunk_max) if (Reduce::IsNewMax(val, max_val)) max_val = val;
+      return max_val;
+    }
+
+    /// Return the sum of fun(id) over [0, count).  Blocks are fixed by Reduce::BLOCK_SIZE
+    /// rather than by chunks, so the result is bit-identical to Reduce::SumOf() for any
+    /// number of threads.
+    template <typename FUN_T>
+    double SumOf(size_t count, FUN_T && fun) {
+      emp::vector<double> sums(Reduce::CalcNumBlocks(count), 0.0);
+      ForEachChunk(sums.size(), [&fun, &sums, count](size_t, size_t start, size_t end) {
+        for (size_t block_id = start; block_id < end; ++block_id) {
+          sums[block_id] = Reduce::SumBlock(block_id, count, fun);
+        }
+      });
+      return Reduce::CombineBlocks(sums);
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TraceBuffer.hpp
+ *  @brief A fixed-size ring buffer of binary execution trace records, with a file format.
+ *
+ *  Each TraceRecord is 24 bytes: when an event happened (e.g., the update), who produced it
+ *  (e.g., an organism's position), where (e.g., the instruction pointer), what happened (an
+ *  operation ID, such as an instruction index), and one extra value.  Once the buffer is
+ *  full, each new record replaces the oldest, so a long run keeps its most recent history
+ *  at a fixed memory cost.
+ *
+ *  A trace file starts with the 8 bytes "MABETRC1", then a uint32 count of operation names,
+ *  each as a uint32 length and its bytes, then a uint64 record count and the records (oldest
+ *  first) as five little-endian fields (uint64, then four uint32s).  TraceReader loads a file
+ *  and Print() writes one readable line per record.
+ */
+
+#ifndef MABE_TOOLS_TRACE_BUFFER_H
+#define MABE_TOOLS_TRACE_BUFFER_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  struct TraceRecord {
+    uint64_t time = 0;     ///< When the event happened (e.g., the update).
+    uint32_t source = 0;   ///< Who produced it (e.g., an organism's position).
+    uint32_t site = 0;     ///< Where it happened (e.g., the instruction pointer).
+    uint32_t op = 0;       ///< What happened; an index into the trace's operation names.
+    uint32_t value = 0;    ///< Extra detail (e.g., instructions executed so far).
+
+    bool operator==(const TraceRecord &) const = default;
+  };
+
+  struct TraceFormat {
+    static constexpr const char * MAGIC = "MABETRC1";
+
+    static void PutUInt(std::ostream & os, uint64_t value, size_t num_bytes) {
+      for (size_t i = 0; i < num_bytes; ++i) os.put((char) ((value >> (8 * i)) & 0xff));
+    }
+
+    static bool GetUInt(std::istream & is, uint64_t & value, size_t num_bytes) {
+      value = 0;
+      for (size_t i = 0; i < num_bytes; ++i) {
+        const int byte = is.get();
+        if (byte == EOF) return false;
+        value |= (uint64_t) byte << (8 * i);
+      }
+      return true;
+    }
+
+    /// Write one record as a readable line, naming its operation if possible.
+    static void Print(std::ostream & os, const TraceRecord & record,
+                      const emp::vector<std::string> & op_names) {
+      os << record.time << " [" << record.source << "] " << record.site << ": ";
+      if (record.op < op_names.size()) os << op_names[record.op];
+      else os << "op" << record.op;
+      os << " (" << record.value << ")\n";
+    }
+  };
+
+  class TraceBuffer {
+  private:
+    emp::vector<TraceRecord> records;   ///< Ring buffer; its size is the capacity.
+    size_t next = 0;                    ///< Slot the next record goes into.
+    uint64_t num_added = 0;             ///< Records added since the last Clear().
+
+  public:
+    TraceBuffer(size_t capacity=0) : records(capacity) { }
+
+    size_t GetCapacity() const { return records.size(); }
+    size_t GetSize() const { return (num_added < records.size()) ? num_added : records.size(); }
+    uint64_t GetNumAdded() const { return num_added; }
+    uint64_t GetNumDropped() const { return num_added - GetSize(); }
+    bool IsActive() const { return records.size() > 0; }
+
+    /// Change the capacity; this discards all records.
+    void SetCapacity(size_t capacity) {
+      records.resize(0);
+      records.resize(capacity);
+      Clear();
+    }
+
+    void Clear() { next = 0; num_added = 0; }
+
+    void Add(const TraceRecord & record) {
+      emp_assert(IsActive());
+      records[next] = record;
+      if (++next == records.size()) next = 0;
+      ++num_added;
+    }
+
+    /// Get a record by age: 0 is the oldest one still held.
+    const TraceRecord & Get(size_t id) const {
+      emp_assert(id < GetSize(), id, GetSize());
+      const size_t start = (num_added < records.size()) ? 0 : next;
+      const size_t pos = start + id;
+      return records[pos < records.size() ? pos : pos - records.size()];
+    }
+
+    /// Call fun(record) on each record held, oldest first.
+    template <typename FUN_T>
+    void ForEach(FUN_T && fun) const {
+      for (size_t id = 0; id < GetSize(); ++id) fun(Get(id));
+    }
+
+    /// Write the held records, with the names of their operations, in the trace file format.
+    void Write(std::ostream & os, const emp::vector<std::string> & op_names) const {
+      os.write(TraceFormat::MAGIC, 8);
+      TraceFormat::PutUInt(os, op_names.size(), 4);
+      for (const std::string & name : op_names) {
+        TraceFormat::PutUInt(os, name.size(), 4);
+        os.write(name.data(), (std::streamsize) name.size());
+      }
+      TraceFormat::PutUInt(os, GetSize(), 8);
+      ForEach([&os](const TraceRecord & record){
+        TraceFormat::PutUInt(os, record.time, 8);
+        TraceFormat::PutUInt(os, record.source, 4);
+        TraceFormat::PutUInt(os, record.site, 4);
+        TraceFormat::PutUInt(os, record.op, 4);
+        TraceFormat::PutUInt(os, record.value, 4);
+      });
+    }
+
+    /// Write one readable line per held record, oldest first.
+    void Print(std::ostream & os, const emp::vector<std::string> & op_names) const {
+      ForEach([&os, &op_names](const TraceRecord & record){
+        TraceFormat::Print(os, record, op_names);
+      });
+    }
+  };
+
+  class TraceReader {
+  private:
+    emp::vector<std::string> op_names;
+    emp::vector<TraceRecord> records;
+
+  public:
+    const emp::vector<std::string> & GetOpNames() const { return op_names; }
+    const emp::vector<TraceRecord> & GetRecords() const { return records; }
+    size_t GetSize() const { return records.size(); }
+
+    /// Load a whole trace file; returns false if the stream is not a valid trace.
+    bool Load(std::istream & is) {
+      op_names.resize(0);
+      records.resize(0);
+      char magic[8];
+      if (!is.read(magic, 8) || std::string(magic, 8) != TraceFormat::MAGIC) return false;
+
+      uint64_t count = 0, length = 0;
+      if (!TraceFormat::GetUInt(is, count, 4)) return false;
+      for (uint64_t i = 0; i < count; ++i) {
+        if (!TraceFormat::GetUInt(is, length, 4)) return false;
+        std::string name(length, '\0');
+        if (!is.read(name.data(), (std::streamsize) length)) return false;
+        op_names.push_back(std::move(name));
+      }
+
+      if (!TraceFormat::GetUInt(is, count, 8)) return false;
+      uint64_t fields[5];
+      for (uint64_t i = 0; i < count; ++i) {
+        if (!TraceFormat::GetUInt(is, fields[0], 8)) return false;
+        for (size_t f = 1; f < 5; ++f) {
+          if (!TraceFormat::GetUInt(is, fields[f], 4)) return false;
+        }
+        records.push_back(TraceRecord{fields[0], (uint32_t) fields[1], (uint32_t) fields[2],
+                                      (uint32_t) fields[3], (uint32_t) fields[4]});
+      }
+      return true;
+    }
+
+    /// Write one readable line per record.
+    void Print(std::ostream & os) const {
+      for (const TraceRecord & record : records) TraceFormat::Print(os, record, op_names);
+    }
+  };
+
+}
+
+#endif
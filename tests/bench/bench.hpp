@@ -0,0 +1,114 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  bench.hpp
+ *  @brief Minimal timing harness for MABE benchmarks, with JSON output.
+ *
+ *  A benchmark is a function that does one repetition of work and returns how many items
+ *  (organisms, lookups, instructions, ...) it processed.  Each benchmark is run once untimed
+ *  to warm up, then for the requested number of repetitions; results record the time per
+ *  item so that numbers are comparable across population sizes and releases.
+ *
+ *  Non-timing measurements (e.g., memory per organism) are kept with Record() and written
+ *  under "metrics"; HeapBytesInUse() reports allocated heap bytes where the C library can.
+ */
+
+#ifndef MABE_BENCH_H
+#define MABE_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "emp/base/vector.hpp"
+#include "emp/tools/String.hpp"
+
+namespace mabe::bench {
+
+  struct Result {
+    emp::String name;
+    size_t reps = 0;         ///< Number of timed repetitions.
+    uint64_t items = 0;      ///< Total items processed across all timed repetitions.
+    double total_ns = 0.0;   ///< Total time across all timed repetitions.
+
+    double GetNSPerItem() const { return items ? total_ns / (double) items : 0.0; }
+    double GetItemsPerSec() const { return total_ns > 0.0 ? items * 1.0e9 / total_ns : 0.0; }
+  };
+
+  struct Metric {
+    emp::String name;
+    double value = 0.0;
+    emp::String unit;
+  };
+
+  /// Bytes currently allocated on the heap, or 0 if it cannot be determined on this platform.
+  inline size_t HeapBytesInUse() {
+#ifdef __GLIBC__
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+  }
+
+  class Suite {
+  private:
+    emp::String name;
+    emp::vector<Result> results;
+    emp::vector<Metric> metrics;
+
+  public:
+    Suite(const emp::String & in_name) : name(in_name) { }
+
+    const emp::vector<Result> & GetResults() const { return results; }
+    const emp::vector<Metric> & GetMetrics() const { return metrics; }
+
+    /// Keep a measurement that is not a timing.
+    void Record(const emp::String & metric_name, double value, const emp::String & unit) {
+      metrics.push_back(Metric{metric_name, value, unit});
+      std::cerr << metric_name << ": " << value << " " << unit << std::endl;
+    }
+
+    /// Time 'reps' calls of fun(), which must return the number of items it processed.
+    template <typename FUN_T>
+    const Result & Run(const emp::String & bench_name, size_t reps, FUN_T && fun) {
+      using clock_t = std::chrono::steady_clock;
+      fun();                                  // Warm-up (caches, lazy setup, allocations).
+      Result result{bench_name, reps};
+      const auto start = clock_t::now();
+      for (size_t i = 0; i < reps; ++i) result.items += (uint64_t) fun();
+      result.total_ns = std::chrono::duration<double, std::nano>(clock_t::now() - start).count();
+      results.push_back(result);
+      std::cerr << bench_name << ": " << result.GetNSPerItem() << " ns/item" << std::endl;
+      return results.back();
+    }
+
+    void WriteJSON(std::ostream & os) const {
+      os << "{\n  \"suite\": \"" << name << "\",\n  \"benchmarks\": [\n";
+      for (size_t i = 0; i < results.size(); ++i) {
+        const Result & r = results[i];
+        os << "    { \"name\": \"" << r.name << "\", \"reps\": " << r.reps
+           << ", \"items\": " << r.items << ", \"total_ns\": " << r.total_ns
+           << ", \"ns_per_item\": " << r.GetNSPerItem()
+           << ", \"items_per_sec\": " << r.GetItemsPerSec() << " }"
+           << (i+1 < results.size() ? ",\n" : "\n");
+      }
+      os << "  ],\n  \"metrics\": [\n";
+      for (size_t i = 0; i < metrics.size(); ++i) {
+        const Metric & m = metrics[i];
+        os << "    { \"name\": \"" << m.name << "\", \"value\": " << m.value
+           << ", \"unit\": \"" << m.unit << "\" }"
+           << (i+1 < metrics.size() ? ",\n" : "\n");
+      }
+      os << "  ]\n}\n";
+    }
+  };
+
+}
+
+#endif
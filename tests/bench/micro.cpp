@@ -0,0 +1,234 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  micro.cpp
+ *  @brief Microbenchmarks for MABE hot paths; writes results as JSON.
+ *
+ *  Usage: micro.out [mabe_root_dir] [output.json]
+ *
+ *  Each benchmark uses a fixed random seed so that repeated runs do the same work.
+ */
+
+#include <fstream>
+#include <sstream>
+
+// Empirical
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "core/MABE.hpp"
+#include "core/EmptyOrganism.hpp"
+#include "modules.hpp"
+#include "tools/NK.hpp"
+// Benchmark harness
+#include "bench.hpp"
+
+// Configuration for selection, birth, collection, and trait equation benchmarks.
+constexpr const char * select_config = R"(
+  random_seed = 1;
+  Population main_pop;
+  Population next_pop;
+  ValsOrg vals_org { N = 100; mut_prob = 0.007; min_value = 0; max_value = 100;
+                     genome_name = "vals"; total_name = "total"; };
+  EvalDiagnostic diagnostics { vals_trait = "vals"; scores_trait = "scores"; N = 100;
+                               total_trait = "fitness"; diagnostic = "explore"; };
+  SelectTournament select_t { tournament_size = 7; fitness_fun = "fitness"; };
+  SelectTournament select_tb { tournament_size = 7; fitness_fun = "fitness"; buffered_random = 1; };
+  SelectRoulette select_r { fitness_fun = "fitness"; };
+  SelectLexicase select_l { fitness_traits = "scores"; epsilon = 0.0; };
+)";
+
+// Configuration for mutation benchmarks: one organism type per mutation engine, ~1000 sites each.
+constexpr const char * mutate_config = R"(
+  random_seed = 1;
+  Population main_pop;
+  BitsOrg bits_org { N = 1024; mut_prob = 0.01; };
+  ValsOrg vals_org { N = 1000; mut_prob = 0.01; };
+  StatesOrg states_org { N = 1000; D = 4; mut_prob = 0.01; };
+  ByteStatesOrg byte_states_org { N = 1000; D = 4; mut_prob = 0.01; genome_name = "byte_states"; };
+  AvidaGPOrg avida_gp_org { N = 1000; mut_prob = 0.01; };
+)";
+
+constexpr size_t POP_SIZE = 1000;
+
+template <typename MODULE_T>
+MODULE_T & GetModule(mabe::MABE & control, const emp::String & name) {
+  return dynamic_cast<MODULE_T &>(control.GetModule(name));
+}
+
+void BenchNK(mabe::bench::Suite & suite) {
+  emp::Random random(1);
+  mabe::NKLandscape landscape(100, 3, random);
+  emp::vector<emp::BitVector> genomes;
+  for (size_t i = 0; i < POP_SIZE; ++i) genomes.emplace_back(100, random);
+
+  double total = 0.0;
+  suite.Run("NKLandscape::GetFitness", 100, [&](){
+    for (const auto & genome : genomes) total += landscape.GetFitness(genome);
+    return genomes.size();
+  });
+  if (total < 0.0) std::cerr << total;  // Keep the work from being optimized away.
+}
+
+void BenchSelection(mabe::bench::Suite & suite) {
+  mabe::MABE control;
+  control.SetupEmpty<mabe::EmptyOrganismManager>();
+  std::stringstream config(select_config);
+  control.Load(config, "select_config");
+  if (!control.Setup()) return;
+
+  mabe::Population & main_pop = control.GetPopulation("main_pop");
+  mabe::Population & next_pop = control.GetPopulation("next_pop");
+  control.Inject(main_pop, "vals_org", POP_SIZE);
+  control.Execute("diagnostics.EVAL(main_pop)");
+
+  auto & select_t = GetModule<mabe::SelectTournament>(control, "select_t");
+  auto & select_tb = GetModule<mabe::SelectTournament>(control, "select_tb");
+  auto & select_r = GetModule<mabe::SelectRoulette>(control, "select_r");
+  auto & select_l = GetModule<mabe::SelectLexicase>(control, "select_l");
+
+  suite.Run("SelectTournament::Select", 20, [&](){
+    control.EmptyPop(next_pop, 0);
+    return select_t.Select(main_pop, next_pop, POP_SIZE).GetSize();
+  });
+  suite.Run("SelectTournament::Select (buffered_random)", 20, [&](){
+    control.EmptyPop(next_pop, 0);
+    return select_tb.Select(main_pop, next_pop, POP_SIZE).GetSize();
+  });
+  suite.Run("SelectRoulette::Select", 20, [&](){
+    control.EmptyPop(next_pop, 0);
+    return select_r.Select(main_pop, next_pop, POP_SIZE).GetSize();
+  });
+  suite.Run("SelectLexicase::Select", 5, [&](){
+    control.EmptyPop(next_pop, 0);
+    return select_l.Select(main_pop, next_pop, POP_SIZE).GetSize();
+  });
+
+  suite.Run("MABE::DoBirth", 20, [&](){
+    control.EmptyPop(next_pop, 0);
+    for (size_t pos = 0; pos < main_pop.GetSize(); ++pos) {
+      control.DoBirth(main_pop[pos], main_pop.IteratorAt(pos), next_pop);
+    }
+    return main_pop.GetSize();
+  });
+
+  suite.Run("Collection::Insert+Iterate", 100, [&](){
+    mabe::Collection collect;
+    for (size_t pos = 0; pos < main_pop.GetSize(); pos += 2) collect.Insert(main_pop.IteratorAt(pos));
+    size_t count = 0;
+    for ([[maybe_unused]] mabe::Organism & org : collect) ++count;
+    return count;
+  });
+
+  mabe::MABEScript & script = control.GetConfigScript();
+  suite.Run("TraitEquation (compiled)", 100, [&](){
+    return script.EvalTraitEquation(main_pop, "fitness * 2 + total / 3 - 1").size();
+  });
+  suite.Run("TraitEquation (CALC_MEAN via script)", 100, [&](){
+    control.Execute("main_pop.CALC_MEAN('fitness * 2 + total / 3 - 1')");
+    return main_pop.GetSize();
+  });
+}
+
+void BenchMutation(mabe::bench::Suite & suite) {
+  mabe::MABE control;
+  control.SetupEmpty<mabe::EmptyOrganismManager>();
+  std::stringstream config(mutate_config);
+  control.Load(config, "mutate_config");
+  if (!control.Setup()) return;
+
+  mabe::Population & main_pop = control.GetPopulation("main_pop");
+  const emp::vector<emp::String> org_types = { "bits_org", "vals_org", "states_org", "byte_states_org",
+                                              "avida_gp_org" };
+  for (const auto & type : org_types) control.Inject(main_pop, type, 1);
+
+  // Items are the number of sites mutated, so results read as mutations per second.
+  emp::Random & random = control.GetRandom();
+  for (size_t pos = 0; pos < org_types.size(); ++pos) {
+    mabe::Organism & org = main_pop[pos];
+    suite.Run("Mutate (" + org_types[pos] + ")", 10000, [&](){ return org.Mutate(random); });
+  }
+
+  // Items are the number of sites randomized.
+  for (size_t pos : { 2, 3 }) {
+    mabe::Organism & org = main_pop[pos];
+    suite.Run("Randomize (" + org_types[pos] + ")", 1000, [&](){ org.Randomize(random); return 1000; });
+  }
+}
+
+// Command-line arguments for the logic-9 configuration, with file paths relative to the MABE
+// root directory and any extra settings appended.
+emp::vector<emp::String> Logic9Args(const emp::String & mabe_root, const emp::String & extra="") {
+  const emp::String settings_dir = mabe_root + "/settings";
+  return {
+    "micro", "-f", settings_dir + "/logic_9.mabe", "-s",
+    "random_seed=1;",
+    "avida_org.initial_genome_filename=\"" + settings_dir + "/VirtualCPUOrg/ancestor_default.org\";",
+    "avida_org.inst_set_input_filename=\"" + settings_dir + "/VirtualCPUOrg/inst_set_traditional.txt\";" + extra
+  };
+}
+
+emp::vector<char *> ToArgv(emp::vector<emp::String> & args) {
+  emp::vector<char *> argv;
+  for (auto & arg : args) argv.push_back(arg.data());
+  return argv;
+}
+
+void BenchVirtualCPU(mabe::bench::Suite & suite, const emp::String & mabe_root) {
+  emp::vector<emp::String> args = Logic9Args(mabe_root);
+  emp::vector<char *> argv = ToArgv(args);
+
+  mabe::MABE control((int) argv.size(), argv.data());
+  control.SetupEmpty<mabe::EmptyOrganismManager>();
+  if (!control.Setup()) return;
+  control.Inject(control.GetPopulation("main_pop"), "avida_org", POP_SIZE);
+
+  // Items are the number of instructions executed.
+  suite.Run("VirtualCPUOrg::ProcessStep (via SCHEDULE)", 20, [&](){
+    const uint64_t start_insts = control.GetRunStats().insts_executed;
+    control.Execute("scheduler.SCHEDULE()");
+    return control.GetRunStats().insts_executed - start_insts;
+  });
+}
+
+// Heap bytes per living organism after a population has grown by replication, with and
+// without compact_state.
+void BenchVirtualCPUMemory(mabe::bench::Suite & suite, const emp::String & mabe_root) {
+  if (mabe::bench::HeapBytesInUse() == 0) return;    // Not measurable on this platform.
+  for (int compact : {0, 1}) {
+    emp::vector<emp::String> args =
+      Logic9Args(mabe_root, emp::String("avida_org.compact_state=") + std::to_string(compact) + ";");
+    emp::vector<char *> argv = ToArgv(args);
+
+    mabe::MABE control((int) argv.size(), argv.data());
+    control.SetupEmpty<mabe::EmptyOrganismManager>();
+    if (!control.Setup()) return;
+    mabe::Population & pop = control.GetPopulation("main_pop");
+    const size_t start_bytes = mabe::bench::HeapBytesInUse();
+    control.Inject(pop, "avida_org", POP_SIZE);
+    for (size_t i = 0; i < 200; ++i) control.Execute("scheduler.SCHEDULE()");
+
+    const size_t num_orgs = pop.GetNumOrgs();
+    if (num_orgs == 0) continue;
+    const double bytes = (double) (mabe::bench::HeapBytesInUse() - start_bytes) / (double) num_orgs;
+    suite.Record(emp::String("VirtualCPUOrg heap per organism (compact_state=") +
+                 std::to_string(compact) + ")", bytes, "bytes");
+  }
+}
+
+int main(int argc, char * argv[]) {
+  const emp::String mabe_root = (argc > 1) ? argv[1] : "../..";
+  const emp::String out_filename = (argc > 2) ? argv[2] : "micro.json";
+
+  mabe::bench::Suite suite("micro");
+  BenchNK(suite);
+  BenchSelection(suite);
+  BenchMutation(suite);
+  BenchVirtualCPU(suite, mabe_root);
+  BenchVirtualCPUMemory(suite, mabe_root);
+
+  std::ofstream out(out_filename);
+  suite.WriteJSON(out);
+}
@@ -0,0 +1,47 @@
+#!/bin/bash
+# Time full MABE runs of standard configurations for a fixed number of updates.
+# Usage: run_macro.sh [mabe_executable] [output.json]
+# Runs are done inside ./run so that output files do not clutter the tree.
+
+THIS_DIR=`pwd`
+MABE_ROOT="${THIS_DIR}/../.."
+MABE_EXE="${1:-${MABE_ROOT}/build/MABE}"
+OUT_FILE="${2:-${THIS_DIR}/macro.json}"
+SETTINGS="${MABE_ROOT}/settings"
+
+# Each entry: name|config file|extra settings, each ending in ';' (must stop the run at a fixed update).
+RUNS=(
+  "NK|NK.mabe|max_ud=200;"
+  "Diagnostics|Diagnostics.mabe|num_gens=200;"
+  "logic_9|logic_9.mabe|max_updates=200; avida_org.initial_genome_filename=\"${SETTINGS}/VirtualCPUOrg/ancestor_default.org\"; avida_org.inst_set_input_filename=\"${SETTINGS}/VirtualCPUOrg/inst_set_traditional.txt\";"
+)
+
+mkdir -p "${THIS_DIR}/run/phylo"
+cd "${THIS_DIR}/run"
+
+echo "{" > "${OUT_FILE}"
+echo "  \"suite\": \"macro\"," >> "${OUT_FILE}"
+echo "  \"benchmarks\": [" >> "${OUT_FILE}"
+FIRST=1
+for RUN in "${RUNS[@]}"
+do
+  IFS='|' read -r NAME CONFIG SETTINGS_ARGS <<< "${RUN}"
+  echo "${NAME}"
+  START=`date +%s%N`
+  # Settings are split on whitespace (quotes are kept for MABE), so paths must not have spaces.
+  "${MABE_EXE}" -f "${SETTINGS}/${CONFIG}" -s random_seed=1\; ${SETTINGS_ARGS} > "${NAME}_output.txt"
+  ERROR_CODE=$?
+  END=`date +%s%N`
+  if ! test ${ERROR_CODE} -eq 0;
+  then
+    echo "Error! Run '${NAME}' failed; see ${THIS_DIR}/run/${NAME}_output.txt"
+    exit 1
+  fi
+  if test ${FIRST} -eq 0; then echo "," >> "${OUT_FILE}"; fi
+  FIRST=0
+  echo -n "    { \"name\": \"${NAME}\", \"total_ns\": $((END-START)) }" >> "${OUT_FILE}"
+done
+echo "" >> "${OUT_FILE}"
+echo "  ]" >> "${OUT_FILE}"
+echo "}" >> "${OUT_FILE}"
+echo "Results written to ${OUT_FILE}"
@@ -0,0 +1,72 @@
+"""Record and compare performance of regression projects.
+
+Usage: python3 perf.py run PERF_FILE COMMAND...            (run COMMAND and record its performance)
+       python3 perf.py compare PERF_FILE BASELINE TOLERANCE (report slowdowns beyond TOLERANCE)
+
+A perf file holds one 'name value' pair per line: wall time (seconds), peak RSS (KB) of the
+command and its children, and, if terminal_output.txt has 'UD:' lines, updates per second.
+compare exits with status 1 if any measure is worse than the baseline by more than TOLERANCE
+(e.g., 0.25 = 25%).
+"""
+import re
+import resource
+import subprocess
+import sys
+import time
+
+LOWER_IS_BETTER = {'wall_time': True, 'peak_rss_kb': True, 'updates_per_sec': False}
+
+
+def count_updates(filename='terminal_output.txt'):
+    try:
+        with open(filename) as f:
+            updates = [int(m.group(1)) for m in re.finditer(r'^UD:\s*(\d+)', f.read(), re.M)]
+    except OSError:
+        return None
+    return updates[-1] if updates else None
+
+
+def run(perf_file, command):
+    start = time.monotonic()
+    status = subprocess.call(command)
+    wall_time = time.monotonic() - start
+    peak_rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    if sys.platform == 'darwin':
+        peak_rss //= 1024                         # macOS reports bytes rather than KB.
+
+    stats = {'wall_time': wall_time, 'peak_rss_kb': peak_rss}
+    updates = count_updates()
+    if updates and wall_time > 0:
+        stats['updates_per_sec'] = updates / wall_time
+    with open(perf_file, 'w') as f:
+        for name, value in stats.items():
+            f.write(f"{name} {value:.6g}\n")
+    return status
+
+
+def read_perf(filename):
+    with open(filename) as f:
+        return {name: float(value) for name, value in (line.split() for line in f if line.strip())}
+
+
+def compare(perf_file, baseline_file, tolerance):
+    measured, baseline = read_perf(perf_file), read_perf(baseline_file)
+    slow = False
+    for name, lower_is_better in LOWER_IS_BETTER.items():
+        if name not in measured or not baseline.get(name):
+            continue
+        ratio = measured[name] / baseline[name]
+        worse = ratio > 1.0 + tolerance if lower_is_better else ratio < 1.0 / (1.0 + tolerance)
+        print(f"  {name}: {measured[name]:.6g} (baseline {baseline[name]:.6g}, {ratio:.2f}x)"
+              + ("  <-- WORSE THAN TOLERANCE" if worse else ""))
+        slow = slow or worse
+    return 1 if slow else 0
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 3 and sys.argv[1] == 'run':
+        sys.exit(run(sys.argv[2], sys.argv[3:]))
+    elif len(sys.argv) == 5 and sys.argv[1] == 'compare':
+        sys.exit(compare(sys.argv[2], sys.argv[3], float(sys.argv[4])))
+    print(__doc__)
+    sys.exit(2)
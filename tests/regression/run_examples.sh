@@ -4,6 +4,10 @@ THIS_DIR=`pwd`
 MABE_BUILD_DIR="${THIS_DIR}/${MABE_BUILD_DIR}"
 LOCAL_BUILD_DIR="${THIS_DIR}/build"
 PROJECTS=`ls "${THIS_DIR}/projects"`
+# Performance is compared against each project's perf_baseline.txt (from the regenerate
+# script); set MABE_PERF_TOLERANCE to the allowed slowdown, or MABE_SKIP_PERF=1 to skip.
+PERF_TOLERANCE="${MABE_PERF_TOLERANCE:-0.25}"
+PERF_FAILURES=""
 
 ### Compile
 mkdir -p "${LOCAL_BUILD_DIR}"
@@ -49,7 +53,7 @@ do
   cp "${LOCAL_BUILD_DIR}/MABE_debug" ./
   cp "${FILE_DIR}"/* ./
   # Run!
-  env MABE_IS_REGEN=0 ./run_regression_test.sh
+  env MABE_IS_REGEN=0 python3 "${THIS_DIR}/perf.py" run "${OUTPUT_DIR}/perf.txt" ./run_regression_test.sh
   TERMINAL_ERROR_CODE=$?
   if ! test ${TERMINAL_ERROR_CODE} -eq 0;
   then
@@ -83,8 +87,22 @@ do
       exit 1
     fi
   done
+  # Check performance against the baseline
+  if [ "${MABE_SKIP_PERF:-0}" != "1" ] && [ -e "${PROJ_DIR}/perf_baseline.txt" ]
+  then
+    python3 "${THIS_DIR}/perf.py" compare "${OUTPUT_DIR}/perf.txt" "${PROJ_DIR}/perf_baseline.txt" "${PERF_TOLERANCE}"
+    if ! test $? -eq 0;
+    then
+      PERF_FAILURES="${PERF_FAILURES} ${NAME}"
+    fi
+  fi
   # Reset back to original directory
   cd "${THIS_DIR}" 
 done
+if [ -n "${PERF_FAILURES}" ]
+then
+  echo "Error! Performance regressions beyond tolerance ${PERF_TOLERANCE} in:${PERF_FAILURES}"
+  exit 1
+fi
 echo "All examples successfully executed!"
 # Placeholder comment
@@ -0,0 +1,73 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Arena.cpp
+ *  @brief Tests for pooled allocation of Emplode objects.
+ */
+
+#include <string>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "Emplode/Arena.hpp"
+
+TEST_CASE("Arena_Blocks", "[Emplode]"){
+  emplode::Arena arena;
+  CHECK(arena.GetNumChunks() == 0);
+
+  void * block1 = arena.Allocate(24);
+  void * block2 = arena.Allocate(24);
+  CHECK(block1 != block2);
+  CHECK(arena.GetNumLive() == 2);
+  CHECK(arena.GetNumChunks() == 1);
+  CHECK((size_t) block1 % emplode::Arena::ALIGN == 0);
+  CHECK((size_t) block2 % emplode::Arena::ALIGN == 0);
+
+  // A freed block is reused by the next allocation of the same size class...
+  arena.Free(block1, 24);
+  CHECK(arena.GetNumLive() == 1);
+  CHECK(arena.Allocate(20) == block1);
+  // ...but not by one of another size.
+  arena.Free(block2, 24);
+  void * block3 = arena.Allocate(100);
+  CHECK(block3 != block2);
+
+  // Large blocks come from the regular heap.
+  void * big = arena.Allocate(emplode::Arena::MAX_BLOCK + 1);
+  CHECK(arena.GetNumLive() == 2);
+  arena.Free(big, emplode::Arena::MAX_BLOCK + 1);
+
+  // Filling a chunk starts another.
+  for (size_t i = 0; i < emplode::Arena::CHUNK_SIZE / 256 + 1; ++i) arena.Allocate(256);
+  CHECK(arena.GetNumChunks() == 2);
+}
+
+namespace {
+  struct TestBase : public emplode::ArenaAllocated {
+    virtual ~TestBase() { }
+  };
+  struct TestDerived : public TestBase {
+    std::string name;
+    double values[8] = {0.0};
+    TestDerived(const std::string & in_name) : name(in_name) { }
+  };
+}
+
+TEST_CASE("Arena_Allocated", "[Emplode]"){
+  emplode::Arena & shared = emplode::Arena::Shared();
+  const size_t start_live = shared.GetNumLive();
+
+  TestBase * obj = new TestDerived("test");
+  CHECK(shared.GetNumLive() == start_live + 1);
+  CHECK(static_cast<TestDerived *>(obj)->name == "test");
+  delete obj;                                  // Freed with the size of TestDerived.
+  CHECK(shared.GetNumLive() == start_live);
+
+  TestBase * obj2 = new TestDerived("again");
+  CHECK(obj2 == obj);                          // Same block is reused.
+  delete obj2;
+}
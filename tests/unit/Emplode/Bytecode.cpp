@@ -0,0 +1,17 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Bytecode.cpp
+ *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "Emplode/Bytecode.hpp"
+
+
+TEST_CASE("Bytecode_Placeholder", "[Emplode]"){ ; }
@@ -1,17 +1,92 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  DataFile.cpp
  *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
  */
 
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 // CATCH
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 // MABE
 #include "Emplode/DataFile.hpp"
+#include "Emplode/Emplode.hpp"
 
 
 TEST_CASE("DataFile_Placeholder", "[Emplode]"){ ; }
+
+// Write the same rows with and without async mode; the files should be identical.
+static std::string WriteTestFile(const emp::String & filename, bool async) {
+  {
+    emplode::Emplode script;
+    std::stringstream config;
+    config << "Var count = 0;\n"
+           << "DataFile df { filename = \"" << filename << "\"; async = " << async
+           << "; flush_interval = 3; };\n"
+           << "df.ADD_SETUP(\"count = count + 1\");\n"
+           << "df.ADD_COLUMN(\"count\", \"count\");\n"
+           << "df.ADD_COLUMN(\"double\", \"count * 2\");\n";
+    script.Load(config, "test_config");
+    for (size_t i = 0; i < 10; ++i) script.Execute("df.WRITE()");
+  } // Destroying the script must write out any buffered rows.
+
+  std::ifstream file(filename.str());
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+TEST_CASE("DataFile_Async", "[Emplode]"){
+  const std::string sync_output = WriteTestFile("DataFile_sync.csv", false);
+  const std::string async_output = WriteTestFile("DataFile_async.csv", true);
+  REQUIRE(sync_output.substr(0, 20) == "count,double\n1,2\n2,4");
+  CHECK(async_output == sync_output);
+}
+
+TEST_CASE("DataFile_Binary", "[Emplode]"){
+  {
+    emplode::Emplode script;
+    std::stringstream config(R"(
+      Var count = 0;
+      DataFile df { filename = "DataFile_binary.bin"; format = "binary"; flush_interval = 4; };
+      df.ADD_SETUP("count = count + 1");
+      df.ADD_COLUMN("count", "count");
+      df.ADD_COLUMN("label", "'row'");
+    )");
+    script.Load(config, "test_config");
+    for (size_t i = 0; i < 6; ++i) script.Execute("df.WRITE()");
+  }
+
+  std::ifstream file("DataFile_binary.bin", std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string data = contents.str();
+
+  // Header: magic, two columns ("count" as double, "label" as string).
+  REQUIRE(data.substr(0, 8) == "MABECOL1");
+  uint32_t num_cols = 0;
+  std::memcpy(&num_cols, data.data() + 8, sizeof(num_cols));
+  REQUIRE(num_cols == 2);
+  size_t pos = 12 + (4 + 5 + 1) + (4 + 5 + 1);
+  REQUIRE(data[12 + 4 + 5] == 0);
+  REQUIRE(data[pos - 1] == 1);
+
+  // First group has four rows (flush_interval); the second has the remaining two.
+  uint64_t num_rows = 0;
+  std::memcpy(&num_rows, data.data() + pos, sizeof(num_rows));
+  REQUIRE(num_rows == 4);
+  double values[4];
+  std::memcpy(values, data.data() + pos + 8, sizeof(values));
+  CHECK(values[0] == 1.0);
+  CHECK(values[3] == 4.0);
+  pos += 8 + 4 * 8 + 4 * 8 + 4 * 3;
+  std::memcpy(&num_rows, data.data() + pos, sizeof(num_rows));
+  CHECK(num_rows == 2);
+  CHECK(data.size() == pos + 8 + 2 * 8 + 2 * 8 + 2 * 3);
+}
@@ -0,0 +1,71 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  PopSnapshot.cpp
+ *  @brief Tests for writing, reading, and reloading column-oriented population snapshots.
+ */
+
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "core/MABE.hpp"
+#include "core/EmptyOrganism.hpp"
+#include "core/PopSnapshot.hpp"
+#include "evaluate/static/EvalDiagnostic.hpp"
+#include "orgs/ValsOrg.hpp"
+
+TEST_CASE("PopSnapshot_WriteLoad", "[core]"){
+  mabe::MABE control;
+  control.SetupEmpty<mabe::EmptyOrganismManager>();
+  std::stringstream config(R"(
+    random_seed = 5;
+    Population main_pop;
+    Population copy_pop;
+    ValsOrg vals_org { N = 4; init_random = 1; genome_name = "vals"; total_name = "total"; };
+    EvalDiagnostic diagnostics { vals_trait = "vals"; scores_trait = "scores"; N = 4;
+                                 total_trait = "fitness"; diagnostic = "exploit"; };
+  )");
+  control.Load(config, "snapshot_config");
+  REQUIRE(control.Setup());
+
+  mabe::Population & main_pop = control.GetPopulation("main_pop");
+  mabe::Population & copy_pop = control.GetPopulation("copy_pop");
+  control.Inject(main_pop, "vals_org", 10);
+  control.ClearOrgAt(main_pop.IteratorAt(3));
+  REQUIRE(control.WriteSnapshot(main_pop, "PopSnapshot_test.snap"));
+
+  mabe::PopSnapshot snapshot;
+  REQUIRE(snapshot.Load("PopSnapshot_test.snap"));
+  CHECK(snapshot.GetPopName() == "main_pop");
+  CHECK(snapshot.GetPopSize() == 10);
+  REQUIRE(snapshot.GetNumOrgs() == 9);
+  CHECK(snapshot.GetPositions()[3] == 4);
+  CHECK(snapshot.GetTypeName(0) == "vals_org");
+  CHECK(snapshot.HasGenomes());
+
+  std::span<const double> totals = snapshot.GetValues<double>("total");
+  std::span<const double> vals = snapshot.GetValues<double>("vals");
+  REQUIRE(totals.size() == 9);
+  REQUIRE(vals.size() == 36);
+  CHECK(snapshot.GetValues<int>("total").size() == 0);  // Wrong type gives no values.
+  for (size_t i = 0; i < 9; ++i) {
+    const mabe::Organism & org = main_pop[snapshot.GetPositions()[i]];
+    CHECK(totals[i] == org.GetTrait<double>("total"));
+    CHECK(vals[i*4+2] == org.GetTrait<double>("vals", 4)[2]);
+  }
+
+  // Reloading rebuilds the same organisms in the same positions.
+  REQUIRE(control.LoadSnapshot(copy_pop, "PopSnapshot_test.snap"));
+  REQUIRE(copy_pop.GetSize() == 10);
+  CHECK(copy_pop.GetNumOrgs() == 9);
+  CHECK(copy_pop.IsEmpty(3));
+  for (size_t pos = 0; pos < 10; ++pos) {
+    if (pos == 3) continue;
+    CHECK(copy_pop[pos].GetTrait<double>("total") == main_pop[pos].GetTrait<double>("total"));
+  }
+}
@@ -0,0 +1,49 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TraitColumns.cpp
+ *  @brief Tests for contiguous per-position trait columns.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/data/DataMap.hpp"
+// MABE
+#include "core/TraitColumns.hpp"
+
+TEST_CASE("TraitColumns_Rows", "[core]"){
+  emp::DataMap dmap;
+  const size_t x_id = dmap.AddVar<double>("x", 1.5);
+  const size_t y_id = dmap.AddVar<double>("y", -2.0);
+
+  mabe::TraitColumns columns;
+  columns.Resize(3);
+  CHECK(columns.AddColumn("x", x_id) == 0);
+  CHECK(columns.AddColumn("y", y_id) == 1);
+  CHECK(columns.AddColumn("x", x_id) == 0);  // Re-adding returns the existing column.
+  CHECK(columns.GetNumColumns() == 2);
+  CHECK(columns.GetColumnID("z") == -1);
+
+  columns.LoadRow(1, dmap);
+  CHECK(columns.IsOccupied(1));
+  CHECK(!columns.IsOccupied(0));
+  CHECK(columns.GetColumn(0)[1] == 1.5);
+  CHECK(columns.GetColumn(1)[1] == -2.0);
+
+  columns.Resize(5);
+  CHECK(columns.GetNumRows() == 5);
+  CHECK(columns.GetColumn(0).size() == 5);
+  CHECK(columns.GetColumn(0)[1] == 1.5);
+
+  dmap.Get<double>(x_id) = 0.0;
+  columns.StoreRow(1, dmap);
+  CHECK(dmap.Get<double>(x_id) == 1.5);
+
+  columns.ClearRow(1);
+  CHECK(!columns.IsOccupied(1));
+  CHECK(columns.GetColumn(0)[1] == 0.0);
+}
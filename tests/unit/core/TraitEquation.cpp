@@ -0,0 +1,112 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TraitEquation.cpp
+ *  @brief Tests for bytecode trait equations.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+#include "emp/data/DataMap.hpp"
+// MABE
+#include "core/TraitEquation.hpp"
+
+TEST_CASE("TraitEquation_Eval", "[core]"){
+  emp::DataMap base_map;
+  const size_t fit_id = base_map.AddVar<double>("fitness", 0.0);
+  const size_t len_id = base_map.AddVar<double>("genome_length", 0.0);
+  const emp::DataLayout & layout = base_map.GetLayout();
+
+  emp::vector<emp::DataMap> maps(600, base_map);
+  emp::vector<const emp::DataMap *> map_ptrs;
+  for (size_t i = 0; i < maps.size(); ++i) {
+    maps[i].Get<double>(fit_id) = (double) i;
+    maps[i].Get<double>(len_id) = (double) (2*i);
+    map_ptrs.push_back(&maps[i]);
+  }
+
+  mabe::TraitEquation equ;
+  REQUIRE(equ.Compile(layout, "fitness - 0.1*genome_length"));
+  emp::vector<double> results(maps.size());
+  equ.Eval(std::span<const emp::DataMap * const>(map_ptrs.data(), map_ptrs.size()),
+           std::span<double>(results.data(), results.size()));
+  for (size_t i = 0; i < maps.size(); ++i) {
+    CHECK(results[i] == Approx((double) i - 0.1 * (double) (2*i)));
+  }
+
+  // Pre-processed values, unary minus, and comparisons.
+  REQUIRE(equ.Compile(layout, "-(fitness + $0) * 2 >= -$1", {1.0, 50.0}));
+  CHECK(equ.Eval(maps[3]) == 1.0);
+  CHECK(equ.Eval(maps[30]) == 0.0);
+
+  // Unsupported features should fail to compile (to fall back to the full parser).
+  CHECK(!equ.Compile(layout, "SQRT(fitness)"));
+  CHECK(!equ.Compile(layout, "unknown_trait + 1"));
+  CHECK(!equ.Compile(layout, "fitness +"));
+  CHECK(!equ.Compile(layout, "fitness ** 2"));
+  CHECK(!equ.IsValid());
+}
+
+TEST_CASE("TraitEquation_BoundVars", "[core]"){
+  emp::DataMap dmap;
+  const size_t fit_id = dmap.AddVar<double>("fitness", 5.0);
+  const emp::DataLayout & layout = dmap.GetLayout();
+
+  // Names that are not traits are bound through the lookup, and read at each evaluation.
+  double cutoff = 10.0;
+  size_t num_lookups = 0;
+  auto lookup = [&cutoff, &num_lookups](const emp::String & name) {
+    ++num_lookups;
+    return (name == "cutoff") ? mabe::TraitEquation::var_fun_t([&cutoff](){ return cutoff; })
+                              : mabe::TraitEquation::var_fun_t();
+  };
+
+  mabe::TraitEquation equ;
+  REQUIRE(equ.Compile(layout, "fitness < cutoff + cutoff*0", {}, lookup));
+  CHECK(equ.GetNumVars() == 1);
+  CHECK(num_lookups == 1);          // Repeated names share one binding.
+  CHECK(equ.Eval(dmap) == 1.0);
+  cutoff = 2.0;
+  CHECK(equ.Eval(dmap) == 0.0);
+  dmap.Get<double>(fit_id) = 1.0;
+  CHECK(equ.Eval(dmap) == 1.0);
+
+  // Traits take priority over variables, and unknown names still fail.
+  CHECK(equ.Compile(layout, "fitness", {}, lookup));
+  CHECK(equ.GetNumVars() == 0);
+  CHECK(!equ.Compile(layout, "fitness < other", {}, lookup));
+}
+
+TEST_CASE("TraitEquation_Indexed", "[core]"){
+  emp::DataMap dmap;
+  const size_t fit_id = dmap.AddVar<double>("fitness", 5.0);
+  const size_t hist_id = dmap.AddVar<double>("fitness_history", 0.0, "", "", 3);
+  const emp::DataLayout & layout = dmap.GetLayout();
+  double * history = &dmap.Get<double>(hist_id);
+  history[0] = 4.0;                   // Most recent record first.
+  history[1] = 2.0;
+  history[2] = 1.0;
+
+  mabe::TraitEquation equ;
+  REQUIRE(equ.Compile(layout, "fitness - fitness[-3]"));
+  CHECK(equ.HasIndexedTraits());
+  CHECK(equ.Eval(dmap) == 4.0);
+  REQUIRE(equ.Compile(layout, "fitness_history[1] + fitness[ -1 ]"));
+  CHECK(equ.Eval(dmap) == 6.0);
+  dmap.Get<double>(fit_id) = 9.0;
+  REQUIRE(equ.Compile(layout, "fitness[0]"));
+  CHECK(equ.Eval(dmap) == 9.0);
+  REQUIRE(equ.Compile(layout, "fitness"));
+  CHECK(!equ.HasIndexedTraits());
+
+  // Out of range or missing histories fail to compile.
+  CHECK(!equ.Compile(layout, "fitness[-4]"));
+  CHECK(!equ.Compile(layout, "fitness[-0]"));
+  CHECK(!equ.Compile(layout, "fitness[1]"));
+  CHECK(!equ.Compile(layout, "other[-1]"));
+}
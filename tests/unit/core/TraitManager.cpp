@@ -635,3 +635,77 @@ TEST_CASE("TraitManager_Verify", "[core]") {
 }
 
 
+
+TEST_CASE("TraitManager_ResetImage", "[core]") {
+  //  [SETUP]
+  mabe::MABE control(0, NULL);
+  control.AddPopulation("test_pop");
+  mabe::EvalNK nk_mod(control);
+
+  mabe::TraitManager<mabe::ModuleBase> trait_man;
+  trait_man.Unlock();
+  trait_man.AddTrait<double>(&nk_mod, mabe::TraitInfo::Access::OWNED, "fitness", "a trait", 1.5, 1);
+  trait_man.AddTrait<int>(&nk_mod, mabe::TraitInfo::Access::OWNED, "steps", "a trait", 0, 1).SetPerLifetime();
+  trait_man.AddTrait<std::string>(&nk_mod, mabe::TraitInfo::Access::OWNED, "label", "a trait", "none", 1);
+  trait_man.AddTrait<int>(&nk_mod, mabe::TraitInfo::Access::OWNED, "counts", "a trait", 3, 4);
+
+  emp::DataMap data_map;
+  trait_man.RegisterAll(data_map);
+  data_map.LockLayout();
+  trait_man.BuildResetImage(data_map);
+
+  //  [BEGIN TESTS]
+  emp::DataMap org_map(data_map);
+  org_map.Get<double>("fitness") = 10.0;
+  org_map.Get<int>("steps") = 25;
+  org_map.Get<std::string>("label") = "changed";
+  int * counts = &org_map.Get<int>("counts");
+  for (size_t i = 0; i < 4; ++i) counts[i] = 100;
+
+  // A lifetime reset only restores the per-lifetime trait.
+  trait_man.ResetLifetime(org_map);
+  CHECK(org_map.Get<int>("steps") == 0);
+  CHECK(org_map.Get<double>("fitness") == 10.0);
+  CHECK(org_map.Get<std::string>("label") == "changed");
+
+  // A full reset restores everything, including every value of a multi-value trait.
+  trait_man.ResetAll(org_map);
+  CHECK(org_map.Get<double>("fitness") == 1.5);
+  CHECK(org_map.Get<int>("steps") == 0);
+  CHECK(org_map.Get<std::string>("label") == "none");
+  counts = &org_map.Get<int>("counts");
+  for (size_t i = 0; i < 4; ++i) CHECK(counts[i] == 3);
+}
+
+TEST_CASE("TraitManager_LayoutOrder", "[core]") {
+  //  [SETUP]
+  mabe::MABE control(0, NULL);
+  control.AddPopulation("test_pop");
+  mabe::EvalNK nk_mod(control);
+
+  mabe::TraitManager<mabe::ModuleBase> trait_man;
+  trait_man.Unlock();
+  trait_man.AddTrait<std::string>(&nk_mod, mabe::TraitInfo::Access::OWNED, "a_label", "a trait", "none", 1);
+  trait_man.AddTrait<int>(&nk_mod, mabe::TraitInfo::Access::OWNED, "b_archived", "a trait", 0, 1)
+    .SetUsage(mabe::TraitInfo::Usage::ARCHIVE);
+  trait_man.AddTrait<char>(&nk_mod, mabe::TraitInfo::Access::OWNED, "c_flag", "a trait", 'x', 1);
+  trait_man.AddTrait<double>(&nk_mod, mabe::TraitInfo::Access::OWNED, "d_eval", "a trait", 0.0, 1);
+  trait_man.AddTrait<double>(&nk_mod, mabe::TraitInfo::Access::OWNED, "e_merit", "a trait", 0.0, 1)
+    .SetUsage(mabe::TraitInfo::Usage::HOT);
+
+  //  [BEGIN TESTS]
+  // Hot first, then per-eval (largest alignment first), archival, and finally large traits.
+  auto order = trait_man.GetLayoutOrder();
+  REQUIRE(order.size() == 5);
+  CHECK(order[0]->GetName() == "e_merit");
+  CHECK(order[1]->GetName() == "d_eval");
+  CHECK(order[2]->GetName() == "c_flag");
+  CHECK(order[3]->GetName() == "b_archived");
+  CHECK(order[4]->GetName() == "a_label");
+
+  // Without separating large traits, the string falls back to its (default) usage group.
+  trait_man.SetSeparateLarge(false);
+  order = trait_man.GetLayoutOrder();
+  CHECK(order[0]->GetName() == "e_merit");
+  CHECK(order[4]->GetName() == "b_archived");
+}
@@ -0,0 +1,100 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file EvalLogicTasks.cpp
+ *  @brief Test file for the fused evaluation of all nine logic tasks
+ */
+
+// [X] Constructor
+// [ ] SetupConfig
+// [X] CalcTaskMask
+// [ ] SetupFunc
+// [ ] Evaluate
+// [ ] OnPlacement
+
+#define TDEBUG 1
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/base/assert.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "evaluate/callable/EvalLogicTasks.hpp"
+#include "evaluate/callable/EvalTaskNot.hpp"
+#include "evaluate/callable/EvalTaskNand.hpp"
+#include "evaluate/callable/EvalTaskAnd.hpp"
+#include "evaluate/callable/EvalTaskOrnot.hpp"
+#include "evaluate/callable/EvalTaskOr.hpp"
+#include "evaluate/callable/EvalTaskAndnot.hpp"
+#include "evaluate/callable/EvalTaskNor.hpp"
+#include "evaluate/callable/EvalTaskXor.hpp"
+#include "evaluate/callable/EvalTaskEqu.hpp"
+
+TEST_CASE("EvalLogicTasks", "[evaluate/callable]"){
+  using org_t = mabe::VirtualCPUOrg;
+  using data_t = org_t::data_t;
+  using eval_t = mabe::EvalLogicTasks;
+
+  mabe::MABE control = mabe::MABE(0, NULL);
+  control.AddPopulation("fake pop");
+  eval_t tasks(control);
+
+  // Each single-task answer should set exactly its own bit.
+  const data_t a = 0b1100, b = 0b1010;
+  const emp::vector<data_t> inputs{a, b};
+  CHECK(eval_t::CalcTaskMask(~a, inputs) & (1u << eval_t::NOT));
+  CHECK(eval_t::CalcTaskMask(~(a & b), inputs) == (1u << eval_t::NAND));
+  CHECK(eval_t::CalcTaskMask(a & b, inputs) == (1u << eval_t::AND));
+  CHECK(eval_t::CalcTaskMask(a | b, inputs) == (1u << eval_t::OR));
+  CHECK(eval_t::CalcTaskMask(~(a | b), inputs) == (1u << eval_t::NOR));
+  CHECK(eval_t::CalcTaskMask(a ^ b, inputs) == (1u << eval_t::XOR));
+  CHECK(eval_t::CalcTaskMask(~(a ^ b), inputs) == (1u << eval_t::EQU));
+  CHECK(eval_t::CalcTaskMask(a & ~b, inputs) == (1u << eval_t::ANDNOT));
+  CHECK(eval_t::CalcTaskMask(b | ~a, inputs) == (1u << eval_t::ORNOT));
+  CHECK(eval_t::CalcTaskMask(12345, inputs) == 0);
+
+  // Only the requested tasks should be reported.
+  CHECK(eval_t::CalcTaskMask(a & b, inputs, 1u << eval_t::OR) == 0);
+
+  // The mask should agree with the individual task modules on random inputs.
+  mabe::EvalTaskNot task_not(control);
+  mabe::EvalTaskNand task_nand(control);
+  mabe::EvalTaskAnd task_and(control);
+  mabe::EvalTaskOrnot task_ornot(control);
+  mabe::EvalTaskOr task_or(control);
+  mabe::EvalTaskAndnot task_andnot(control);
+  mabe::EvalTaskNor task_nor(control);
+  mabe::EvalTaskXor task_xor(control);
+  mabe::EvalTaskEqu task_equ(control);
+  emp::Random random(5);
+  for (size_t trial = 0; trial < 1000; ++trial) {
+    emp::vector<data_t> in_vec(1 + random.GetUInt(3));
+    for (data_t & x : in_vec) x = random.GetUInt(16);
+    const data_t x = in_vec[random.GetUInt(in_vec.size())];
+    const data_t y = in_vec[random.GetUInt(in_vec.size())];
+    const data_t outputs[] = { ~x, x & y, x | ~y, x ^ y, ~(x | y), (data_t) random.GetUInt(16) };
+    for (data_t output : outputs) {
+      bool expected[eval_t::NUM_TASKS] = {};
+      for (data_t in : in_vec) expected[eval_t::NOT] |= task_not.CheckOneArg(output, in);
+      for (size_t i = 0; i + 1 < in_vec.size(); ++i) {
+        for (size_t j = i + 1; j < in_vec.size(); ++j) {
+          expected[eval_t::NAND] |= task_nand.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::AND] |= task_and.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::ORNOT] |= task_ornot.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::OR] |= task_or.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::ANDNOT] |= task_andnot.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::NOR] |= task_nor.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::XOR] |= task_xor.CheckTwoArg(output, in_vec[i], in_vec[j]);
+          expected[eval_t::EQU] |= task_equ.CheckTwoArg(output, in_vec[i], in_vec[j]);
+        }
+      }
+      const uint32_t mask = eval_t::CalcTaskMask(output, in_vec);
+      for (size_t task_id = 0; task_id < eval_t::NUM_TASKS; ++task_id) {
+        CHECK( (bool) (mask & (1u << task_id)) == expected[task_id] );
+      }
+    }
+  }
+}
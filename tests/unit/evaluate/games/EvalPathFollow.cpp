@@ -888,3 +888,47 @@ TEST_CASE("EvalPathFollow_PathFollowEvaluator", "[evaluate/games]"){
     }
   }
 }
+
+TEST_CASE("EvalPathFollow_VisitedTilePool", "[evaluate/games]"){
+  { // Growing the pool keeps existing bits
+    mabe::VisitedTilePool pool;
+    pool.Reserve(25);
+    size_t block0 = pool.Acquire();
+    size_t block1 = pool.Acquire();
+    CHECK(pool.GetNumBlocks() == 2);
+    pool.Set(block0, 3);
+    pool.Set(block1, 24);
+    pool.Reserve(121);
+    CHECK(pool.Get(block0, 3));
+    CHECK(!pool.Get(block0, 24));
+    CHECK(pool.Get(block1, 24));
+    CHECK(!pool.Get(block1, 120));
+    pool.Set(block1, 120);
+    CHECK(pool.Get(block1, 120));
+    CHECK(!pool.Get(block0, 120));
+  }
+  { // Released states hand their block to the next new state, cleared
+    emp::Random rand(600);
+    mabe::PathFollowEvaluator evaluator(rand); 
+    evaluator.randomize_cues = false;
+    evaluator.LoadMap("path_follow_files/test_map_straight.txt");
+    mabe::PathFollowState state1;
+    evaluator.InitializeState(state1);
+    evaluator.Move(state1);
+    CHECK(state1.visited_tiles[7]);
+    size_t block = state1.visited_tiles.block;
+    evaluator.ReleaseState(state1);
+    CHECK(!state1.initialized);
+    CHECK(evaluator.visited_pool->GetNumFree() == 1);
+    mabe::PathFollowState state2;
+    evaluator.InitializeState(state2);
+    CHECK(state2.visited_tiles.block == block);
+    CHECK(!state2.visited_tiles[7]);
+    CHECK(evaluator.visited_pool->GetNumFree() == 0);
+    mabe::PathFollowState state3(state2);  // Copies get their own block when initialized
+    CHECK(!state3.initialized);
+    evaluator.InitializeState(state3);
+    CHECK(state3.visited_tiles.block != block);
+    CHECK(evaluator.visited_pool->GetNumBlocks() == 2);
+  }
+}
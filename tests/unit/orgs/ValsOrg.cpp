@@ -15,3 +15,24 @@
 
 
 TEST_CASE("ValsOrg_Placeholder", "[core]"){ ; }
+
+TEST_CASE("ValsOrg_Bounds", "[orgs]"){
+  using bounds_t = mabe::ValsBounds;
+  auto apply = [](bounds_t::BoundType lower, bounds_t::BoundType upper, double value) {
+    return bounds_t::Select(lower, upper, [value]<bounds_t::BoundType L, bounds_t::BoundType U>() {
+      return bounds_t::Apply<L, U>(value, 0.0, 100.0);
+    });
+  };
+
+  REQUIRE(apply(bounds_t::LIMIT_NONE, bounds_t::LIMIT_NONE, 103.0) == 103.0);
+  REQUIRE(apply(bounds_t::LIMIT_NONE, bounds_t::LIMIT_CLAMP, 103.0) == 100.0);
+  REQUIRE(apply(bounds_t::LIMIT_NONE, bounds_t::LIMIT_WRAP, 103.0) == 3.0);
+  REQUIRE(apply(bounds_t::LIMIT_NONE, bounds_t::LIMIT_REBOUND, 103.0) == 97.0);
+  REQUIRE(apply(bounds_t::LIMIT_CLAMP, bounds_t::LIMIT_NONE, -3.0) == 0.0);
+  REQUIRE(apply(bounds_t::LIMIT_WRAP, bounds_t::LIMIT_NONE, -3.0) == 97.0);
+  REQUIRE(apply(bounds_t::LIMIT_REBOUND, bounds_t::LIMIT_NONE, -3.0) == 3.0);
+  REQUIRE(apply(bounds_t::LIMIT_REBOUND, bounds_t::LIMIT_REBOUND, 50.0) == 50.0);
+  REQUIRE(apply(bounds_t::LIMIT_ERROR, bounds_t::LIMIT_ERROR, 103.0) == 103.0);
+
+  REQUIRE(bounds_t::Apply<bounds_t::LIMIT_REBOUND, bounds_t::LIMIT_REBOUND>(103.5f, 0.0f, 100.0f) == 96.5f);
+}
@@ -0,0 +1,55 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ActiveCases.cpp
+ *  @brief Tests for choosing the test cases active each update.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/ActiveCases.hpp"
+
+
+TEST_CASE("ActiveCases_Sample", "[tools]"){
+  // A sample is sorted, distinct, in range, and the requested size.
+  emp::vector<size_t> sample = mabe::ActiveCases::CalcSample(12345, 100, 10);
+  REQUIRE(sample.size() == 10);
+  for (size_t i = 0; i < sample.size(); ++i) {
+    REQUIRE(sample[i] < 100);
+    if (i > 0) REQUIRE(sample[i-1] < sample[i]);
+  }
+  REQUIRE(mabe::ActiveCases::CalcSample(12345, 100, 10) == sample);
+  REQUIRE(mabe::ActiveCases::CalcSample(54321, 100, 10) != sample);
+
+  // Samples at least as large as the case count use every case.
+  REQUIRE(mabe::ActiveCases::CalcSample(7, 5, 5) == emp::vector<size_t>{0, 1, 2, 3, 4});
+  REQUIRE(mabe::ActiveCases::CalcSample(7, 3, 8) == emp::vector<size_t>{0, 1, 2});
+}
+
+TEST_CASE("ActiveCases_Shared", "[tools]"){
+  mabe::RandomStreams streams(42);
+  mabe::ActiveCases selector_cases("errors");
+  mabe::ActiveCases eval_cases("errors");
+  REQUIRE(!selector_cases.IsSampling(50));
+  REQUIRE(selector_cases.GetSample(streams, 3, 4) == emp::vector<size_t>{0, 1, 2, 3});
+
+  // Two objects for the same case set agree on each update's sample.
+  selector_cases.SetSampleSize(5);
+  eval_cases.SetSampleSize(5);
+  REQUIRE(selector_cases.IsSampling(50));
+  REQUIRE(!selector_cases.IsSampling(5));
+  const emp::vector<size_t> sample = selector_cases.GetSample(streams, 3, 50);
+  REQUIRE(sample.size() == 5);
+  REQUIRE(eval_cases.GetSample(streams, 3, 50) == sample);
+
+  // Different updates, seeds, and case sets get different samples.
+  REQUIRE(selector_cases.GetSample(streams, 4, 50) != sample);
+  REQUIRE(selector_cases.GetSample(mabe::RandomStreams(43), 3, 50) != sample);
+  mabe::ActiveCases other_cases("other");
+  other_cases.SetSampleSize(5);
+  REQUIRE(other_cases.GetSample(streams, 3, 50) != sample);
+}
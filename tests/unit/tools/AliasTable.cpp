@@ -0,0 +1,53 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  AliasTable.cpp
+ *  @brief Tests for constant-time weighted sampling.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/AliasTable.hpp"
+
+
+TEST_CASE("AliasTable_Distribution", "[tools]"){
+  emp::vector<double> weights = { 1.0, 0.0, 3.0, 6.0, 0.0 };
+  mabe::AliasTable table(weights);
+  REQUIRE(table.GetSize() == 5);
+  REQUIRE(table.GetWeight() == 10.0);
+
+  emp::Random random(7);
+  emp::vector<size_t> counts(weights.size(), 0);
+  const size_t num_draws = 100000;
+  for (size_t i = 0; i < num_draws; ++i) counts[table.Draw(random)]++;
+
+  // Zero weights are never drawn; others come up in proportion to their weight.
+  REQUIRE(counts[1] == 0);
+  REQUIRE(counts[4] == 0);
+  for (size_t i : {0, 2, 3}) {
+    const double expected = num_draws * weights[i] / 10.0;
+    REQUIRE(counts[i] > expected * 0.95);
+    REQUIRE(counts[i] < expected * 1.05);
+  }
+}
+
+TEST_CASE("AliasTable_Rebuild", "[tools]"){
+  mabe::AliasTable table;
+  emp::Random random(1);
+
+  // A single positive weight is always drawn.
+  table.Build({0.0, 0.0, 2.5});
+  for (size_t i = 0; i < 100; ++i) REQUIRE(table.Draw(random) == 2);
+
+  // Equal weights use every bucket.
+  table.Build(emp::vector<double>(4, 1.0));
+  emp::vector<size_t> counts(4, 0);
+  for (size_t i = 0; i < 4000; ++i) counts[table.Draw(random)]++;
+  for (size_t count : counts) REQUIRE(count > 800);
+}
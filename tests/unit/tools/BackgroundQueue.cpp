@@ -0,0 +1,87 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BackgroundQueue.cpp
+ *  @brief Tests for running jobs in order on a background thread.
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/BackgroundQueue.hpp"
+
+#include "emp/base/vector.hpp"
+
+TEST_CASE("BackgroundQueue_Order", "[tools]"){
+  mabe::BackgroundQueue queue;
+  CHECK(queue.GetNumPending() == 0);
+  queue.Wait();                                // Nothing submitted; returns at once.
+
+  emp::vector<int> results;                    // Only touched by the worker until Wait().
+  std::thread::id worker_id;
+  for (int i = 0; i < 100; ++i) {
+    queue.Submit([&results, &worker_id, i](){
+      results.push_back(i);
+      worker_id = std::this_thread::get_id();
+    });
+  }
+  queue.Wait();
+  CHECK(queue.GetNumPending() == 0);
+  CHECK(queue.GetNumDone() == 100);
+  REQUIRE(results.size() == 100);
+  for (int i = 0; i < 100; ++i) CHECK(results[(size_t) i] == i);
+#ifndef EMP_TRACK_MEM
+  CHECK(worker_id != std::this_thread::get_id());   // Tracked builds run jobs in place.
+#endif
+}
+
+// Needs a real background thread to hold a job open.
+#ifndef EMP_TRACK_MEM
+TEST_CASE("BackgroundQueue_Backlog", "[tools]"){
+  mabe::BackgroundQueue queue;
+  std::atomic<bool> release{false};
+  std::atomic<int> count{0};
+  queue.Submit([&](){ while (!release) std::this_thread::yield(); ++count; });
+  queue.Submit([&](){ ++count; });
+  CHECK(queue.GetNumPending() == 2);
+  release = true;
+  queue.Wait(1);
+  CHECK(queue.GetNumPending() <= 1);
+  queue.Wait();
+  CHECK(count == 2);
+}
+#endif
+
+TEST_CASE("BackgroundQueue_Errors", "[tools]"){
+  mabe::BackgroundQueue queue;
+  int after = 0;
+  queue.Submit([](){ throw std::runtime_error("job failed"); });
+  queue.Submit([&after](){ after = 1; });
+  CHECK_THROWS_AS(queue.Wait(), std::runtime_error);
+  CHECK(after == 1);                           // Later jobs still ran.
+  queue.Wait();                                // The error is only reported once.
+
+  // Stop() finishes the jobs; the queue can still be used afterward.
+  int stopped = 0;
+  queue.Submit([&stopped](){ stopped = 1; });
+  queue.Stop();
+  CHECK(stopped == 1);
+  queue.Submit([&stopped](){ stopped = 2; });
+  queue.Wait();
+  CHECK(stopped == 2);
+
+  // Destroying a queue finishes its jobs first.
+  int total = 0;
+  {
+    mabe::BackgroundQueue temp_queue;
+    for (int i = 1; i <= 10; ++i) temp_queue.Submit([&total, i](){ total += i; });
+  }
+  CHECK(total == 55);
+}
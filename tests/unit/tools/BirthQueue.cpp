@@ -0,0 +1,57 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BirthQueue.cpp
+ *  @brief Tests for the multi-producer birth queue.
+ */
+
+#include <thread>
+#include <utility>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/BirthQueue.hpp"
+
+
+TEST_CASE("BirthQueue_Order", "[tools]"){
+  mabe::BirthQueue<int> queue;
+  REQUIRE(queue.IsEmpty());
+  queue.Push(5, 50);
+  queue.Push(2, 20);
+  queue.Push(5, 51);
+  queue.Push(0, 0);
+  REQUIRE(!queue.IsEmpty());
+
+  emp::vector<int> out;
+  REQUIRE(queue.Drain([&out](int & x){ out.push_back(x); }) == 4);
+  REQUIRE(out == emp::vector<int>{0, 20, 50, 51});   // Equal keys stay in push order.
+  REQUIRE(queue.IsEmpty());
+  REQUIRE(queue.Drain([](int &){ }) == 0);
+}
+
+TEST_CASE("BirthQueue_Threads", "[tools]"){
+  // Each thread owns a set of keys and pushes several records per key.
+  constexpr size_t NUM_THREADS = 4, KEYS_PER_THREAD = 250, PER_KEY = 3;
+  mabe::BirthQueue<std::pair<size_t, size_t>> queue;
+  emp::vector<std::thread> threads;
+  for (size_t t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&queue, t](){
+      for (size_t k = t; k < NUM_THREADS * KEYS_PER_THREAD; k += NUM_THREADS) {
+        for (size_t i = 0; i < PER_KEY; ++i) queue.Push(k, {k, i});
+      }
+    });
+  }
+  for (auto & thread : threads) thread.join();
+
+  emp::vector<std::pair<size_t, size_t>> out;
+  queue.Drain([&out](auto & rec){ out.push_back(rec); });
+  REQUIRE(out.size() == NUM_THREADS * KEYS_PER_THREAD * PER_KEY);
+  for (size_t i = 0; i < out.size(); ++i) {
+    REQUIRE(out[i].first == i / PER_KEY);
+    REQUIRE(out[i].second == i % PER_KEY);
+  }
+}
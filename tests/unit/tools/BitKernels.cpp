@@ -0,0 +1,81 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BitKernels.cpp
+ *  @brief Tests for the word-at-a-time bit sequence scans.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/BitKernels.hpp"
+
+
+TEST_CASE("BitKernels_LeadingOnes", "[tools]"){
+  REQUIRE(mabe::CountLeadingOnes(emp::BitVector(0)) == 0);
+  REQUIRE(mabe::CountLeadingOnes(emp::BitVector(100)) == 0);
+  REQUIRE(mabe::CountLeadingOnes(emp::BitVector(100, true)) == 100);
+  REQUIRE(mabe::CountLeadingOnes(emp::BitVector(128, true)) == 128);
+
+  // Runs ending on either side of a word boundary.
+  for (size_t length : {1, 63, 64, 65, 127, 128, 129, 199}) {
+    emp::BitVector bits(200, true);
+    bits.Set(length, false);
+    REQUIRE(mabe::CountLeadingOnes(bits) == length);
+  }
+}
+
+TEST_CASE("BitKernels_Matches", "[tools]"){
+  emp::Random random(5);
+  for (size_t size : {0, 1, 64, 100, 256, 333}) {
+    emp::BitVector bits1(size, random);
+    emp::BitVector bits2(size, random);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < size; ++i) mismatches += (bits1[i] != bits2[i]);
+    REQUIRE(mabe::CountMismatches(bits1, bits2) == mismatches);
+    REQUIRE(mabe::CountMatches(bits1, bits2) == size - mismatches);
+    REQUIRE(mabe::CountMismatches(bits1, bits1) == 0);
+  }
+}
+
+TEST_CASE("BitKernels_Runs", "[tools]"){
+  // Runs that cross word boundaries are reported whole.
+  emp::BitVector bits(200);
+  for (size_t i = 60; i < 130; ++i) bits.Set(i);
+  bits.Set(199);
+  emp::vector<size_t> starts, lengths;
+  emp::vector<bool> values;
+  mabe::ForEachRun(bits, [&](bool bit, size_t start, size_t length){
+    values.push_back(bit);
+    starts.push_back(start);
+    lengths.push_back(length);
+  });
+  REQUIRE(values == emp::vector<bool>{false, true, false, true});
+  REQUIRE(starts == emp::vector<size_t>{0, 60, 130, 199});
+  REQUIRE(lengths == emp::vector<size_t>{60, 70, 69, 1});
+}
+
+TEST_CASE("BitKernels_Packages", "[tools]"){
+  REQUIRE(mabe::CountPackages(emp::BitVector(""), 2, 3) == 0);
+  REQUIRE(mabe::CountPackages(emp::BitVector("0011100"), 2, 3) == 1);
+  REQUIRE(mabe::CountPackages(emp::BitVector("001110011100"), 2, 3) == 2);   // Shared padding
+  REQUIRE(mabe::CountPackages(emp::BitVector("11100"), 2, 3) == 1);          // Starts the bits
+  REQUIRE(mabe::CountPackages(emp::BitVector("00111"), 2, 3) == 1);          // Ends the bits
+  REQUIRE(mabe::CountPackages(emp::BitVector("0011110"), 2, 3) == 0);        // Too many ones
+  REQUIRE(mabe::CountPackages(emp::BitVector("111111111"), 0, 3) == 3);      // No padding
+  REQUIRE(mabe::CountPackages(emp::BitVector("111111111"), 3, 0) == 0);      // Empty package
+
+  // Packages spanning word boundaries.
+  emp::BitVector bits(300);
+  for (size_t i = 62; i < 68; ++i) bits.Set(i);
+  for (size_t i = 120; i < 126; ++i) bits.Set(i);
+  for (size_t i = 200; i < 207; ++i) bits.Set(i);                             // Seven ones
+  REQUIRE(mabe::CountPackages(bits, 3, 6) == 2);
+}
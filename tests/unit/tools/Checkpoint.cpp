@@ -0,0 +1,70 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Checkpoint.cpp
+ *  @brief Tests for writing and reading binary checkpoint streams.
+ */
+
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/Checkpoint.hpp"
+
+
+TEST_CASE("Checkpoint_Values", "[tools]"){
+  static_assert(mabe::IsCheckpointType<double>());
+  static_assert(mabe::IsCheckpointType<emp::vector<emp::String>>());
+  static_assert(!mabe::IsCheckpointType<emp::vector<const char *>>());
+
+  std::stringstream ss;
+  mabe::CheckpointWriter out(ss);
+  out.Write<int>(-17);
+  out.Write<double>(3.25);
+  out.Write<bool>(true);
+  out.Write(emp::String("main_pop"));
+  out.Write(emp::vector<double>{1.5, 2.5, 3.5});
+  out.Write(emp::vector<emp::String>{"a", "", "ccc"});
+  emp::BitVector bits(13);
+  bits.Set(0); bits.Set(7); bits.Set(8); bits.Set(12);
+  out.Write(bits);
+  REQUIRE(out.IsOK());
+
+  mabe::CheckpointReader in(ss);
+  REQUIRE(in.Read<int>() == -17);
+  REQUIRE(in.Read<double>() == 3.25);
+  REQUIRE(in.Read<bool>() == true);
+  REQUIRE(in.Read<emp::String>() == "main_pop");
+  REQUIRE(in.Read<emp::vector<double>>() == emp::vector<double>{1.5, 2.5, 3.5});
+  emp::vector<emp::String> strs = in.Read<emp::vector<emp::String>>();
+  REQUIRE(strs.size() == 3);
+  REQUIRE(strs[0] == "a");
+  REQUIRE(strs[1] == "");
+  REQUIRE(strs[2] == "ccc");
+  REQUIRE(in.Read<emp::BitVector>() == bits);
+  REQUIRE(in.IsOK());
+
+  // Reading past the end is reported.
+  in.Read<int>();
+  REQUIRE(!in.IsOK());
+}
+
+TEST_CASE("Checkpoint_Blocks", "[tools]"){
+  std::stringstream ss;
+  mabe::CheckpointWriter out(ss);
+  out.WriteBlock([](mabe::CheckpointWriter & block){ block.Write<int>(1); block.Write<int>(2); });
+  out.WriteBlock([](mabe::CheckpointWriter & block){ block.Write(emp::String("kept")); });
+  out.Write<int>(99);
+
+  mabe::CheckpointReader in(ss);
+  in.SkipBlock();
+  emp::String result;
+  in.ReadBlock([&result](mabe::CheckpointReader & block){ result = block.Read<emp::String>(); });
+  REQUIRE(result == "kept");
+  REQUIRE(in.Read<int>() == 99);
+  REQUIRE(in.IsOK());
+}
@@ -0,0 +1,70 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ConflictSchedule.cpp
+ *  @brief Tests for grouping ordered tasks into concurrent stages.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/ConflictSchedule.hpp"
+
+TEST_CASE("ConflictSchedule_Stages", "[tools]"){
+  mabe::ConflictSchedule schedule;
+
+  // No conflicts: everything runs at once.
+  schedule.Build(4, [](size_t, size_t){ return false; });
+  REQUIRE(schedule.GetNumStages() == 1);
+  CHECK(schedule.GetStage(0) == emp::vector<size_t>{0, 1, 2, 3});
+  CHECK(schedule.GetMaxWidth() == 4);
+
+  // Task 2 conflicts with everything, so it splits the others into before and after.
+  schedule.Build(5, [](size_t a, size_t b){ return a == 2 || b == 2; });
+  REQUIRE(schedule.GetNumStages() == 3);
+  CHECK(schedule.GetStage(0) == emp::vector<size_t>{0, 1});
+  CHECK(schedule.GetStage(1) == emp::vector<size_t>{2});
+  CHECK(schedule.GetStage(2) == emp::vector<size_t>{3, 4});
+
+  // A chain 0->1->3 with 2 independent: 2 can join the first stage.
+  schedule.Build(4, [](size_t a, size_t b){ return (a == 0 && b == 1) || (a == 1 && b == 3); });
+  REQUIRE(schedule.GetNumStages() == 3);
+  CHECK(schedule.GetStage(0) == emp::vector<size_t>{0, 2});
+  CHECK(schedule.GetStage(1) == emp::vector<size_t>{1});
+  CHECK(schedule.GetStage(2) == emp::vector<size_t>{3});
+  CHECK(!schedule.IsSerial());
+
+  // Everything conflicts: fully serial.
+  schedule.Build(3, [](size_t, size_t){ return true; });
+  CHECK(schedule.GetNumStages() == 3);
+  CHECK(schedule.IsSerial());
+}
+
+TEST_CASE("ConflictSchedule_OptIn", "[tools]"){
+  mabe::ConflictSchedule schedule;
+
+  // A PARALLEL block of two evaluations (opted in) and two selections (not opted in), with no
+  // trait conflicts: the evaluations overlap, but each selection runs alone, in order.
+  const emp::vector<bool> is_eval{true, true, false, false};
+  schedule.BuildOptIn(4, [&is_eval](size_t id){ return is_eval[id]; },
+                      [](size_t, size_t){ return false; });
+  REQUIRE(schedule.GetNumStages() == 3);
+  CHECK(schedule.GetStage(0) == emp::vector<size_t>{0, 1});
+  CHECK(schedule.GetStage(1) == emp::vector<size_t>{2});
+  CHECK(schedule.GetStage(2) == emp::vector<size_t>{3});
+
+  // Two selections alone are fully serial.
+  schedule.BuildOptIn(2, [](size_t){ return false; }, [](size_t, size_t){ return false; });
+  CHECK(schedule.GetNumStages() == 2);
+  CHECK(schedule.IsSerial());
+
+  // Opted-in tasks still respect conflicts.
+  schedule.BuildOptIn(3, [](size_t){ return true; },
+                      [](size_t a, size_t b){ return a == 0 && b == 2; });
+  REQUIRE(schedule.GetNumStages() == 2);
+  CHECK(schedule.GetStage(0) == emp::vector<size_t>{0, 1});
+  CHECK(schedule.GetStage(1) == emp::vector<size_t>{2});
+}
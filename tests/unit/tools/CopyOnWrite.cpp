@@ -0,0 +1,46 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  CopyOnWrite.cpp
+ *  @brief Tests for values shared between copies until modified.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+// MABE
+#include "tools/CopyOnWrite.hpp"
+
+
+TEST_CASE("CopyOnWrite_Sharing", "[tools]"){
+  mabe::CopyOnWrite<emp::vector<int>> original(5, 1);
+  REQUIRE(!original.IsShared());
+
+  // Copies share the same memory until one is modified.
+  mabe::CopyOnWrite<emp::vector<int>> copy(original);
+  REQUIRE(original.IsShared());
+  REQUIRE(original.GetShareCount() == 2);
+  REQUIRE(&original.Get() == &copy.Get());
+
+  copy.Modify()[0] = 7;
+  REQUIRE(!original.IsShared());
+  REQUIRE(!copy.IsShared());
+  REQUIRE(original->at(0) == 1);
+  REQUIRE((*copy)[0] == 7);
+
+  // Modifying an unshared value should not copy it.
+  const int * data_ptr = copy->data();
+  copy.Modify()[1] = 3;
+  REQUIRE(copy->data() == data_ptr);
+
+  // Assignment shares again; Set() replaces without touching the other copy.
+  original = copy;
+  REQUIRE(original.IsShared());
+  original.Set(emp::vector<int>{1, 2});
+  REQUIRE(original->size() == 2);
+  REQUIRE(copy->size() == 5);
+}
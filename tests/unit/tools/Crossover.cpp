@@ -0,0 +1,92 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Crossover.cpp
+ *  @brief Tests for the in-place crossover kernels.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/Crossover.hpp"
+
+using Crossover = mabe::Crossover;
+
+/// Count the blocks of consecutive positions taken from the second parent (marked by 'true').
+template <typename FUN_T>
+size_t CountBlocks(size_t size, FUN_T && from_other) {
+  size_t blocks = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (from_other(i) && (i == 0 || !from_other(i-1))) ++blocks;
+  }
+  return blocks;
+}
+
+TEST_CASE("Crossover_Bits", "[tools]"){
+  emp::Random random(3);
+  for (size_t size : {1, 63, 64, 65, 200}) {
+    const emp::BitVector ones(size, true);
+
+    // Point crossovers take a single block; one-point's block runs to the end.
+    for (size_t rep = 0; rep < 50; ++rep) {
+      emp::BitVector child(size, false);
+      Crossover::CrossBits(child, ones, Crossover::ONE_POINT, random);
+      REQUIRE(CountBlocks(size, [&child](size_t i){ return child.Get(i); }) <= 1);
+      if (child.Get(0) || child.Get(size/2)) REQUIRE(child.Get(size-1));
+
+      emp::BitVector child2(size, false);
+      Crossover::CrossBits(child2, ones, Crossover::TWO_POINT, random);
+      REQUIRE(CountBlocks(size, [&child2](size_t i){ return child2.Get(i); }) <= 1);
+    }
+
+    // Uniform crossover takes about half of the bits, and never sets bits past the end.
+    size_t num_ones = 0;
+    for (size_t rep = 0; rep < 50; ++rep) {
+      emp::BitVector child(size, false);
+      Crossover::CrossBits(child, ones, Crossover::UNIFORM, random);
+      REQUIRE(child.size() == size);
+      for (size_t i = 0; i < size; ++i) num_ones += child.Get(i);
+    }
+    REQUIRE(num_ones > size * 50 / 4);
+    REQUIRE(num_ones < size * 50 * 3 / 4);
+  }
+
+  // Bits beyond the shorter parent are left alone.
+  emp::BitVector child(100, false);
+  Crossover::CrossBits(child, emp::BitVector(10, true), Crossover::UNIFORM, random);
+  for (size_t i = 10; i < 100; ++i) REQUIRE(!child.Get(i));
+}
+
+TEST_CASE("Crossover_Span", "[tools]"){
+  emp::Random random(7);
+  const emp::vector<int> other(150, 1);
+  for (Crossover::Type type : {Crossover::ONE_POINT, Crossover::TWO_POINT}) {
+    for (size_t rep = 0; rep < 50; ++rep) {
+      emp::vector<int> child(150, 0);
+      Crossover::CrossSpan<int>(child, other, type, random);
+      REQUIRE(CountBlocks(child.size(), [&child](size_t i){ return child[i] == 1; }) <= 1);
+      if (type == Crossover::ONE_POINT && child[0] == 1) REQUIRE(child.back() == 1);
+    }
+  }
+
+  size_t num_taken = 0;
+  for (size_t rep = 0; rep < 20; ++rep) {
+    emp::vector<int> child(150, 0);
+    Crossover::CrossSpan<int>(child, other, Crossover::UNIFORM, random);
+    for (int value : child) num_taken += value;
+  }
+  REQUIRE(num_taken > 150 * 20 / 4);
+  REQUIRE(num_taken < 150 * 20 * 3 / 4);
+
+  // Only the common prefix is recombined.
+  emp::vector<int> child(20, 0);
+  Crossover::CrossSpan<int>(child, std::span<const int>(other.data(), 5), Crossover::ONE_POINT, random);
+  for (size_t i = 5; i < child.size(); ++i) REQUIRE(child[i] == 0);
+}
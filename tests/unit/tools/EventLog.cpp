@@ -0,0 +1,98 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EventLog.cpp
+ *  @brief Tests for the binary event log and its replay.
+ */
+
+#include <cstdio>
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/EventLog.hpp"
+
+namespace {
+  mabe::EventRecord MakeRecord(uint64_t update, mabe::EventRecord::Kind kind, uint32_t pos,
+                               uint32_t other_pos=mabe::EventRecord::NONE,
+                               uint64_t genome_id=mabe::EventRecord::NO_GENOME) {
+    mabe::EventRecord record;
+    record.update = update;
+    record.kind = kind;
+    record.pos = pos;
+    record.other_pos = other_pos;
+    record.genome_id = genome_id;
+    return record;
+  }
+}
+
+TEST_CASE("EventLog_RoundTrip", "[tools]"){
+  const std::string filename = "EventLog_test.mel";
+  emp::vector<mabe::EventRecord> records;
+  for (uint32_t i = 0; i < 10; ++i) records.push_back(MakeRecord(0, mabe::EventRecord::INJECT, i, mabe::EventRecord::NONE, i));
+  for (uint32_t i = 0; i < 100; ++i) {
+    records.push_back(MakeRecord(1 + i / 10, mabe::EventRecord::DEATH, i % 10));
+    records.push_back(MakeRecord(1 + i / 10, mabe::EventRecord::BIRTH, i % 10, (i + 3) % 10, 10 + i));
+  }
+  records.push_back(MakeRecord(11, mabe::EventRecord::SWAP, 2, 7));
+  records.back().other_pop = 1;
+
+  {
+    mabe::EventLogWriter writer;
+    REQUIRE(writer.Open(filename, 16));   // Small blocks, so several are written in the background.
+    for (size_t i = 0; i < records.size(); ++i) {
+      writer.Add(records[i]);
+      if (i == 50) writer.Flush();
+      if (i == 120) writer.Pause();       // Ends the writer thread; the next block restarts it.
+    }
+    CHECK(writer.GetNumEvents() == records.size());
+  }   // Closed by the destructor.
+
+  mabe::EventLogReader reader;
+  REQUIRE(reader.Load(filename));
+  REQUIRE(reader.GetSize() == records.size());
+  for (size_t i = 0; i < records.size(); ++i) CHECK(reader.Get(i) == records[i]);
+  std::remove(filename.c_str());
+
+  std::stringstream bad("MABEEVT0");
+  CHECK(reader.Load(bad) == false);
+}
+
+TEST_CASE("EventLog_Replay", "[tools]"){
+  using mabe::EventRecord;
+  mabe::EventReplay replay;
+  replay.Apply(MakeRecord(0, EventRecord::INJECT, 0, EventRecord::NONE, 100));   // Org 0
+  replay.Apply(MakeRecord(0, EventRecord::INJECT, 1, EventRecord::NONE, 101));   // Org 1
+  replay.Apply(MakeRecord(1, EventRecord::BIRTH, 2, 0, 102));                    // Org 2, from 0
+  replay.Apply(MakeRecord(2, EventRecord::SWAP, 2, 3));                          // Org 2 to pos 3
+  replay.Apply(MakeRecord(2, EventRecord::DEATH, 1));                            // Org 1 dies
+  replay.Apply(MakeRecord(3, EventRecord::BIRTH, 1, 3, 103));                    // Org 3, from 2
+
+  REQUIRE(replay.GetNumOrgs() == 4);
+  CHECK(replay.GetOrg(1).death_update == 2);
+  CHECK(replay.GetOrg(3).parent == 2);
+  CHECK(replay.GetOccupant(0, 1) == 3);
+  CHECK(replay.GetOccupant(0, 2) == mabe::EventReplay::NO_ORG);
+  CHECK(replay.GetLineage(3) == emp::vector<size_t>{3, 2, 0});
+
+  std::stringstream phylogeny;
+  replay.WritePhylogeny(phylogeny);
+  CHECK(phylogeny.str() == "id,ancestor_list,origin_time,destruction_time,genome_id\n"
+                           "0,[none],0,inf,100\n"
+                           "1,[none],0,2,101\n"
+                           "2,[0],1,inf,102\n"
+                           "3,[2],3,inf,103\n");
+
+  // Swapping whole populations moves every occupant.
+  EventRecord pop_swap;
+  pop_swap.kind = EventRecord::POP_SWAP;
+  pop_swap.pop = 0;
+  pop_swap.other_pop = 1;
+  replay.Apply(pop_swap);
+  CHECK(replay.GetOccupant(1, 1) == 3);
+  CHECK(replay.GetOccupant(0, 1) == mabe::EventReplay::NO_ORG);
+}
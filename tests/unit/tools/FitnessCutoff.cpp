@@ -0,0 +1,54 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  FitnessCutoff.cpp
+ *  @brief Tests for the cutoff used by bounded evaluation.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/FitnessCutoff.hpp"
+
+
+TEST_CASE("FitnessCutoff_Min", "[tools]"){
+  mabe::FitnessCutoff cutoff;
+  REQUIRE(cutoff.IsActive() == false);
+  REQUIRE(cutoff.CanStop(-1000.0) == false);
+
+  cutoff.Setup(10.0);
+  REQUIRE(cutoff.IsActive());
+  REQUIRE(cutoff.CanStop(9.5) == true);
+  REQUIRE(cutoff.CanStop(10.0) == false);    // Could tie the cutoff; keep going.
+  cutoff.Report(50.0);                       // No keep_top, so reports do not matter.
+  REQUIRE(cutoff.GetCutoff() == 10.0);
+  REQUIRE(cutoff.GetNumStopped() == 1);
+}
+
+TEST_CASE("FitnessCutoff_Top", "[tools]"){
+  mabe::FitnessCutoff cutoff(0.0, 3);
+  REQUIRE(cutoff.GetCutoff() == 0.0);
+
+  cutoff.Report(5.0);
+  cutoff.Report(2.0);
+  REQUIRE(cutoff.GetCutoff() == 0.0);        // Top 3 not yet known.
+  cutoff.Report(8.0);
+  REQUIRE(cutoff.GetCutoff() == 2.0);
+  cutoff.Report(1.0);                        // Not in the top 3.
+  REQUIRE(cutoff.GetCutoff() == 2.0);
+  cutoff.Report(6.0);                        // Top 3 are now 8, 6, 5.
+  REQUIRE(cutoff.GetCutoff() == 5.0);
+  REQUIRE(cutoff.CanStop(4.0) == true);
+  REQUIRE(cutoff.CanStop(7.0) == false);
+
+  cutoff.Reset();
+  REQUIRE(cutoff.GetCutoff() == 0.0);
+
+  cutoff.Setup(10.0, 2);                     // A fixed minimum above the top results wins.
+  cutoff.Report(3.0);
+  cutoff.Report(4.0);
+  REQUIRE(cutoff.GetCutoff() == 10.0);
+}
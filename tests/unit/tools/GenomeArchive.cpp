@@ -0,0 +1,76 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GenomeArchive.cpp
+ *  @brief Tests for writing and reading delta-encoded genome archives.
+ */
+
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/GenomeArchive.hpp"
+
+
+TEST_CASE("GenomeArchive_Encodings", "[tools]"){
+  const std::string parent(100, '0');
+  std::string flipped = parent;
+  flipped[3] = '1';
+  flipped[70] = '1';
+
+  // No parent: full genome.
+  REQUIRE(mabe::GenomeArchive::Encode(parent, nullptr)[0] == mabe::GenomeArchive::FULL);
+
+  // Two point mutations: two (gap, byte) edits.
+  const std::string edits = mabe::GenomeArchive::Encode(flipped, &parent);
+  REQUIRE(edits[0] == mabe::GenomeArchive::EDITS);
+  REQUIRE(edits.size() == 6);
+
+  // An insertion keeps the shared prefix and suffix.
+  std::string inserted = parent;
+  inserted.insert(50, "xyz");
+  const std::string splice = mabe::GenomeArchive::Encode(inserted, &parent);
+  REQUIRE(splice[0] == mabe::GenomeArchive::SPLICE);
+  REQUIRE(splice.size() < 10);
+
+  // A completely different genome is stored in full.
+  const std::string other(100, '1');
+  REQUIRE(mabe::GenomeArchive::Encode(other, &parent)[0] == mabe::GenomeArchive::FULL);
+}
+
+TEST_CASE("GenomeArchive_RoundTrip", "[tools]"){
+  std::string g0 = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  std::string g1 = g0;  g1[5] = 'x';  g1[300 % g1.size()] = 'y';
+  std::string g2 = g1;  g2.erase(10, 4);
+  std::string g3 = g2 + "tail";
+  std::string g4 = "unrelated";
+
+  std::stringstream ss;
+  mabe::GenomeArchiveWriter writer(ss);
+  REQUIRE(writer.Add(g0) == 0);
+  REQUIRE(writer.Add(g1, 0, &g0) == 1);
+  REQUIRE(writer.Add(g2, 1, &g1) == 2);
+  REQUIRE(writer.Add(g3, 2, &g2) == 3);
+  REQUIRE(writer.Add(g4, 0, &g0) == 4);
+  REQUIRE(writer.GetNumGenomes() == 5);
+  REQUIRE(writer.IsOK());
+  REQUIRE(writer.GetNumBytes() == ss.str().size());
+
+  mabe::GenomeArchiveReader reader;
+  REQUIRE(reader.Load(ss));
+  REQUIRE(reader.GetSize() == 5);
+  REQUIRE(reader.GetGenome(0) == g0);
+  REQUIRE(reader.GetGenome(1) == g1);
+  REQUIRE(reader.GetGenome(2) == g2);
+  REQUIRE(reader.GetGenome(3) == g3);
+  REQUIRE(reader.GetGenome(4) == g4);
+  REQUIRE(reader.GetParent(0) == mabe::GenomeArchive::NO_PARENT);
+  REQUIRE(reader.GetParent(3) == 2);
+
+  std::stringstream bad("NOTANARCHIVE");
+  REQUIRE(!reader.Load(bad));
+}
@@ -0,0 +1,56 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GenomeHash.cpp
+ *  @brief Tests for full and incremental genome hashing.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/GenomeHash.hpp"
+
+#include "emp/base/vector.hpp"
+
+
+TEST_CASE("GenomeHash_Values", "[tools]"){
+  emp::vector<double> vals(50, 1.5);
+  const uint64_t hash = mabe::GenomeHash::CalcValues<double>(vals);
+  REQUIRE(hash == mabe::GenomeHash::CalcValues<double>(vals));
+
+  // Changing one site can be applied incrementally.
+  const double old_val = vals[7];
+  vals[7] = 2.5;
+  const uint64_t new_hash = mabe::GenomeHash::CalcValues<double>(vals);
+  REQUIRE(new_hash != hash);
+  REQUIRE(mabe::GenomeHash::Update(hash, 7, mabe::GenomeHash::ToSite(old_val),
+                                   mabe::GenomeHash::ToSite(vals[7])) == new_hash);
+
+  // Moving a value to another site or changing the length changes the hash.
+  emp::vector<double> moved(50, 1.5);
+  moved[8] = 2.5;
+  REQUIRE(mabe::GenomeHash::CalcValues<double>(moved) != new_hash);
+  emp::vector<double> longer(51, 1.5);
+  REQUIRE(mabe::GenomeHash::CalcValues<double>(longer) != hash);
+
+  // Bytes include their exact length.
+  REQUIRE(mabe::GenomeHash::CalcBytes("abc") != mabe::GenomeHash::CalcBytes("abd"));
+  REQUIRE(mabe::GenomeHash::CalcBytes("abc") != mabe::GenomeHash::CalcBytes(std::string_view("abc\0", 4)));
+}
+
+TEST_CASE("GenomeHash_Bits", "[tools]"){
+  emp::BitVector bits(150);
+  bits.Set(3); bits.Set(100);
+  const uint64_t hash = mabe::GenomeHash::CalcBits(bits);
+
+  const uint64_t old_word = bits.GetUInt64(1);
+  bits.Toggle(70);
+  REQUIRE(mabe::GenomeHash::Update(hash, 1, old_word, bits.GetUInt64(1)) == mabe::GenomeHash::CalcBits(bits));
+
+  emp::BitVector shorter(149);
+  shorter.Set(3); shorter.Set(100);
+  REQUIRE(mabe::GenomeHash::CalcBits(shorter) != hash);
+}
@@ -0,0 +1,44 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Histogram.cpp
+ *  @brief Tests for fixed-bin histograms.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/Histogram.hpp"
+
+TEST_CASE("Histogram_Linear", "[tools]"){
+  mabe::Histogram hist(4, 0.0, 8.0);
+  for (double value : {0.0, 1.9, 2.0, 5.0, 8.0, -1.0, 9.0}) hist.Add(value);
+  CHECK(hist.GetNumBins() == 4);
+  CHECK(hist.GetCount(0) == 2);
+  CHECK(hist.GetCount(1) == 1);
+  CHECK(hist.GetCount(2) == 1);
+  CHECK(hist.GetCount(3) == 1);                     // The maximum goes in the last bin.
+  CHECK(hist.GetNumBelow() == 1);
+  CHECK(hist.GetNumAbove() == 1);
+  CHECK(hist.GetTotal() == 7);
+  CHECK(hist.GetBinMin(2) == 4.0);
+  CHECK(hist.ToString() == "[2,1,1,1]");
+
+  mabe::Histogram other(4, 0.0, 8.0);
+  other.Add(7.0);
+  hist.Merge(other);
+  CHECK(hist.GetCount(3) == 2);
+}
+
+TEST_CASE("Histogram_Log", "[tools]"){
+  mabe::Histogram hist(3, 1.0, 1000.0, true);
+  for (double value : {1.0, 5.0, 10.0, 50.0, 99.0, 100.0, 1000.0, 0.5}) hist.Add(value);
+  CHECK(hist.GetCount(0) == 2);                     // [1, 10)
+  CHECK(hist.GetCount(1) == 3);                     // [10, 100)
+  CHECK(hist.GetCount(2) == 2);                     // [100, 1000]
+  CHECK(hist.GetNumBelow() == 1);
+  CHECK(hist.GetBinMin(1) == Approx(10.0));
+}
@@ -0,0 +1,57 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  InstCounts.cpp
+ *  @brief Tests for per-thread instruction execution counts.
+ */
+
+#include <thread>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/InstCounts.hpp"
+
+TEST_CASE("InstCounts_Basic", "[tools]"){
+  mabe::InstCounts counts;
+  counts.Add(0, 3);
+  counts.Add(0, 3, 4);
+  counts.Add(1, 1, 2);
+  counts.Add(1, 3);
+
+  CHECK(counts.GetCount(3) == 6);
+  CHECK(counts.GetCount(3, 0) == 5);
+  CHECK(counts.GetCount(1, 0) == 0);
+  CHECK(counts.GetCount(7) == 0);
+  CHECK(counts.GetTotal() == 8);
+  CHECK(counts.GetTotal(1) == 3);
+  CHECK(counts.GetCounts() == emp::vector<uint64_t>{0, 2, 0, 6});
+  CHECK(counts.GetHottest(5) == emp::vector<size_t>{3, 1});
+  CHECK(counts.GetHottest(1, 1) == emp::vector<size_t>{1});
+
+  counts.Clear();
+  CHECK(counts.GetTotal() == 0);
+  CHECK(counts.GetHottest(5).size() == 0);
+}
+
+TEST_CASE("InstCounts_Threads", "[tools]"){
+  mabe::InstCounts counts1, counts2;
+  emp::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&counts1, &counts2, t](){
+      for (size_t i = 0; i < 1000; ++i) {
+        counts1.Add(0, i % 5);
+        counts2.Add(t, 0);     // Alternate between two counters on the same thread.
+      }
+    });
+  }
+  for (auto & thread : threads) thread.join();
+
+  CHECK(counts1.GetTotal() == 4000);
+  for (size_t inst_id = 0; inst_id < 5; ++inst_id) CHECK(counts1.GetCount(inst_id) == 800);
+  CHECK(counts2.GetTotal() == 4000);
+  for (size_t pop_id = 0; pop_id < 4; ++pop_id) CHECK(counts2.GetTotal(pop_id) == 1000);
+}
@@ -0,0 +1,79 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  LSHIndex.cpp
+ *  @brief Tests for the bounded approximate nearest-neighbor index.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/LSHIndex.hpp"
+
+
+TEST_CASE("LSHIndex_Basic", "[tools]"){
+  mabe::LSHIndex index(2, 4, 4, 2, 1.0, 7);
+  REQUIRE(index.GetSize() == 0);
+  index.Add(emp::vector<double>{0.0, 0.0});
+  index.Add(emp::vector<double>{3.0, 4.0});
+  index.Add(emp::vector<double>{0.0, 1.0});
+  REQUIRE(index.GetSize() == 3);
+
+  // With fewer candidates than requested, every point is scanned, so results are exact.
+  emp::vector<double> dists;
+  emp::vector<uint32_t> scratch;
+  index.FindNearest(emp::vector<double>{0.0, 0.0}, 3, dists, scratch);
+  REQUIRE(dists == emp::vector<double>{0.0, 1.0, 5.0});
+  index.FindNearest(emp::vector<double>{0.0, 0.0}, 2, dists, scratch, 0);
+  REQUIRE(dists == emp::vector<double>{1.0, 5.0});
+
+  // Once full, new points replace the oldest.
+  index.Add(emp::vector<double>{10.0, 10.0});
+  index.Add(emp::vector<double>{20.0, 20.0});
+  REQUIRE(index.GetSize() == 4);
+  REQUIRE(index.GetPoint(0)[0] == 20.0);
+  index.FindNearest(emp::vector<double>{0.0, 0.0}, 1, dists, scratch);
+  REQUIRE(dists == emp::vector<double>{1.0});
+
+  index.Clear();
+  index.FindNearest(emp::vector<double>{0.0, 0.0}, 3, dists, scratch);
+  REQUIRE(dists.size() == 0);
+}
+
+TEST_CASE("LSHIndex_Approximate", "[tools]"){
+  // Random points in a 4-D box; the nearest neighbor should usually be found exactly.
+  mabe::RandomStreams streams(11);
+  const size_t num_dims = 4, num_points = 2000;
+  mabe::LSHIndex index(num_dims, num_points, 10, 3, 2.0, 3);
+  emp::vector<double> values(num_points * num_dims);
+  for (size_t i = 0; i < values.size(); ++i) values[i] = (streams.CalcKey(i) % 10000) / 1000.0;
+  for (size_t i = 0; i < num_points; ++i) {
+    index.Add(std::span<const double>(values.data() + i * num_dims, num_dims));
+  }
+
+  emp::vector<double> dists;
+  emp::vector<uint32_t> scratch;
+  size_t num_exact = 0;
+  const size_t num_queries = 100;
+  for (size_t q = 0; q < num_queries; ++q) {
+    std::span<const double> query(values.data() + q * num_dims, num_dims);
+    double best = 1e300;
+    for (size_t i = 0; i < num_points; ++i) {
+      if (i == q) continue;
+      double dist2 = 0.0;
+      for (size_t d = 0; d < num_dims; ++d) {
+        dist2 += (values[i*num_dims+d] - query[d]) * (values[i*num_dims+d] - query[d]);
+      }
+      best = std::min(best, dist2);
+    }
+    index.FindNearest(query, 1, dists, scratch, q);
+    REQUIRE(dists.size() == 1);
+    REQUIRE(dists[0] >= std::sqrt(best) - 1e-9);   // Never closer than the true neighbor.
+    if (dists[0] <= std::sqrt(best) + 1e-9) ++num_exact;
+    REQUIRE(scratch.size() < num_points / 2);      // Only part of the index was examined.
+  }
+  REQUIRE(num_exact >= 75);
+}
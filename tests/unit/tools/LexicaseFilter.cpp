@@ -0,0 +1,82 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  LexicaseFilter.cpp
+ *  @brief Tests for the filtering steps of lexicase selection, with and without elite buckets.
+ */
+
+#include <algorithm>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/LexicaseFilter.hpp"
+
+namespace {
+  mabe::LexicaseFilter MakeFilter(const emp::vector<emp::vector<double>> & scores, double eps) {
+    mabe::LexicaseFilter filter(scores.size(), scores[0].size(), eps);
+    for (size_t t = 0; t < scores.size(); ++t) {
+      for (size_t o = 0; o < scores[t].size(); ++o) filter.Score(t, o) = scores[t][o];
+    }
+    return filter;
+  }
+
+  emp::vector<size_t> Survivors(const mabe::LexicaseFilter & filter, emp::vector<size_t> order) {
+    emp::vector<size_t> cur, next;
+    filter.Filter(order, cur, next);
+    std::sort(cur.begin(), cur.end());
+    return cur;
+  }
+}
+
+TEST_CASE("LexicaseFilter_Basic", "[tools]"){
+  // Trait 0 favors orgs 0 and 1; trait 1 favors orgs 1 and 2.
+  mabe::LexicaseFilter filter = MakeFilter({ {5, 5, 1, 0}, {0, 3, 3, 1} }, 0.0);
+  CHECK(Survivors(filter, {0}) == emp::vector<size_t>{0, 1});
+  CHECK(Survivors(filter, {1}) == emp::vector<size_t>{1, 2});
+  CHECK(Survivors(filter, {0, 1}) == emp::vector<size_t>{1});
+  CHECK(Survivors(filter, {}) == emp::vector<size_t>{0, 1, 2, 3});
+
+  filter.BuildBuckets();
+  CHECK(filter.HasBuckets());
+  CHECK(Survivors(filter, {0}) == emp::vector<size_t>{0, 1});
+  CHECK(Survivors(filter, {0, 1}) == emp::vector<size_t>{1});
+  CHECK(Survivors(filter, {}) == emp::vector<size_t>{0, 1, 2, 3});
+}
+
+TEST_CASE("LexicaseFilter_EpsilonBuckets", "[tools]"){
+  // With epsilon 1, trait 0 keeps orgs 0-2 (within 1 of 10), then trait 1 keeps orgs 1 and 2
+  // (within 1 of 5).  On trait 2, org 0 has the best score overall (20), so its bucket holds
+  // only orgs 0 and 1 (19.2); but the best REMAINING score is org 1's, so org 2 (18.5) is also
+  // within epsilon and must survive with or without buckets.
+  mabe::LexicaseFilter scalar = MakeFilter({ {10, 9.5, 9.2, 0}, {0, 5, 4.5, 0}, {20, 19.2, 18.5, 0} }, 1.0);
+  mabe::LexicaseFilter bucket = scalar;
+  bucket.BuildBuckets();
+  CHECK(Survivors(scalar, {0, 1}) == emp::vector<size_t>{1, 2});
+  CHECK(Survivors(scalar, {0, 1, 2}) == emp::vector<size_t>{1, 2});
+  CHECK(Survivors(bucket, {0, 1, 2}) == emp::vector<size_t>{1, 2});
+
+  // Random scores and orders: buckets never change the survivors, for any epsilon.
+  emp::Random random(17);
+  for (double eps : {0.0, 0.5, 2.0}) {
+    for (size_t trial = 0; trial < 50; ++trial) {
+      const size_t num_traits = 6, num_orgs = 40;
+      mabe::LexicaseFilter filter_s(num_traits, num_orgs, eps);
+      for (size_t t = 0; t < num_traits; ++t) {
+        if (trial % 2) filter_s.SetEpsilon(t, eps * random.GetDouble());   // Uneven epsilons.
+        for (size_t o = 0; o < num_orgs; ++o) filter_s.Score(t, o) = (double) random.GetUInt(8);
+      }
+      mabe::LexicaseFilter filter_b = filter_s;
+      filter_b.BuildBuckets();
+      emp::vector<size_t> order(num_traits);
+      for (size_t t = 0; t < num_traits; ++t) order[t] = t;
+      for (size_t t = num_traits - 1; t > 0; --t) std::swap(order[t], order[random.GetUInt(t + 1)]);
+      CHECK(Survivors(filter_s, order) == Survivors(filter_b, order));
+    }
+  }
+}
@@ -0,0 +1,58 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  MutationSites.cpp
+ *  @brief Tests for geometric-gap sampling of mutation sites.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/MutationSites.hpp"
+
+
+TEST_CASE("MutationSites_Edges", "[tools]"){
+  emp::Random random(3);
+  mabe::GeometricSites none(0.0);
+  REQUIRE(none.ForEachSite(1000, random, [](size_t){}) == 0);
+
+  mabe::GeometricSites all(1.0);
+  emp::vector<size_t> sites;
+  REQUIRE(all.ForEachSite(10, random, [&sites](size_t pos){ sites.push_back(pos); }) == 10);
+  for (size_t i = 0; i < 10; ++i) REQUIRE(sites[i] == i);
+
+  REQUIRE(all.ForEachSite(0, random, [](size_t){}) == 0);
+}
+
+TEST_CASE("MutationSites_Rate", "[tools]"){
+  emp::Random random(17);
+  mabe::GeometricSites sites(0.02);
+  const size_t num_sites = 1000;
+  const size_t num_trials = 2000;
+  emp::vector<size_t> hits(num_sites, 0);
+  size_t total = 0;
+  for (size_t trial = 0; trial < num_trials; ++trial) {
+    size_t prev = num_sites;
+    total += sites.ForEachSite(num_sites, random, [&](size_t pos){
+      REQUIRE(pos < num_sites);
+      REQUIRE((prev == num_sites || pos > prev));  // Strictly increasing; no duplicates.
+      prev = pos;
+      hits[pos]++;
+    });
+  }
+
+  // Expect 20 mutations per genome on average, spread evenly over the sites.
+  const double mean = (double) total / (double) num_trials;
+  REQUIRE(mean > 19.5);
+  REQUIRE(mean < 20.5);
+  size_t first_half = 0;
+  for (size_t i = 0; i < num_sites/2; ++i) first_half += hits[i];
+  REQUIRE((double) first_half / (double) total > 0.48);
+  REQUIRE((double) first_half / (double) total < 0.52);
+}
@@ -11,7 +11,28 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 // MABE
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
 #include "tools/NK-const.hpp"
+#include "tools/NK.hpp"
 
 
 TEST_CASE("NK-const_Placeholder", "[core]"){ ; }
+
+TEST_CASE("NK-const_Dispatch", "[tools]"){
+  // A compiled landscape should give exactly the same results as the runtime version.
+  emp::Random random1(11), random2(11), genome_random(4);
+  auto const_fun = mabe::MakeNKConstFitnessFun(50, 3, random1);
+  REQUIRE(const_fun);
+  mabe::NKLandscape landscape(50, 3, random2);
+  for (size_t i = 0; i < 20; ++i) {
+    emp::BitVector genome(50, genome_random);
+    REQUIRE(const_fun(genome) == landscape.GetFitness(genome));
+  }
+
+  // Unsupported sizes fall back to an empty function without using the random generator.
+  emp::Random random3(11);
+  REQUIRE(!mabe::MakeNKConstFitnessFun(51, 3, random3));
+  REQUIRE(!mabe::MakeNKConstFitnessFun(50, 9, random3));
+  REQUIRE(random3.GetDouble() == emp::Random(11).GetDouble());
+}
@@ -11,7 +11,61 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 // MABE
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
 #include "tools/NK.hpp"
 
 
 TEST_CASE("NK_Placeholder", "[core]"){ ; }
+
+TEST_CASE("NK_UpdateGeneFitnesses", "[tools]"){
+  emp::Random random(5);
+  mabe::NKLandscape landscape(40, 3, random);
+  emp::BitVector genome(40, random);
+  emp::vector<double> genes = landscape.GetGeneFitnesses(genome);
+  for (size_t i = 0; i < 40; ++i) REQUIRE(landscape.GetGeneFitness(genome, i) == genes[i]);
+
+  // Flip a few bits (including near the wrap-around) and update incrementally.
+  emp::BitVector mutant = genome;
+  mutant.Toggle(0);
+  mutant.Toggle(17);
+  mutant.Toggle(39);
+  const double total = landscape.UpdateGeneFitnesses(genome, mutant, genes);
+  REQUIRE(total == landscape.GetFitness(mutant));
+  REQUIRE(genes == landscape.GetGeneFitnesses(mutant));
+}
+
+TEST_CASE("NK_GetFitnesses", "[tools]"){
+  emp::Random random(9);
+  mabe::NKLandscape landscape(30, 4, random);
+  emp::vector<emp::BitVector> genomes;
+  for (size_t i = 0; i < 10; ++i) genomes.emplace_back(30, random);
+
+  emp::vector<double> fitnesses(genomes.size());
+  landscape.GetFitnesses(genomes, fitnesses);
+  for (size_t i = 0; i < genomes.size(); ++i) {
+    // Batch results should match single lookups and the sum of the gene fitnesses.
+    REQUIRE(fitnesses[i] == landscape.GetFitness(genomes[i]));
+    double total = 0.0;
+    for (size_t gene = 0; gene < 30; ++gene) {
+      total += landscape.GetFitness(gene, landscape.GetGeneState(genomes[i], gene));
+    }
+    REQUIRE(total == fitnesses[i]);
+  }
+}
+
+TEST_CASE("NK_Memo", "[tools]"){
+  emp::Random random1(3), random2(3);
+  mabe::NKLandscapeMemo landscape1(50, 24, random1);
+  mabe::NKLandscapeMemo landscape2(50, 24, random2);
+  emp::BitVector genome1(50, random1), genome2(50, random1);
+
+  // Values depend only on the seed, not on the order of lookups.
+  const double fit1 = landscape1.GetFitness(genome1);
+  const double fit2 = landscape1.GetFitness(genome2);
+  REQUIRE(landscape2.GetFitness(genome2) == fit2);
+  REQUIRE(landscape2.GetFitness(genome1) == fit1);
+  REQUIRE(fit1 != fit2);
+  REQUIRE(fit1 >= 0.0);
+  REQUIRE(fit1 < 50.0);
+}
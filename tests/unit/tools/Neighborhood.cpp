@@ -0,0 +1,108 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Neighborhood.cpp
+ *  @brief Tests for precomputed grid and graph neighbor tables.
+ */
+
+#include <algorithm>
+#include <set>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/Neighborhood.hpp"
+
+using mabe::Neighborhood;
+
+static std::set<size_t> NeighborSet(const Neighborhood & hood, size_t pos) {
+  auto neighbors = hood.GetNeighbors(pos);
+  return std::set<size_t>(neighbors.begin(), neighbors.end());
+}
+
+TEST_CASE("Neighborhood_Grid", "[tools]"){
+  Neighborhood hood;
+  REQUIRE(hood.SetupGrid(5, 4, false, Neighborhood::MOORE));
+  REQUIRE(hood.GetNumCells() == 20);
+  REQUIRE(hood.GetNumNeighbors(hood.GetPos(0,0)) == 3);   // Corner
+  REQUIRE(hood.GetNumNeighbors(hood.GetPos(2,0)) == 5);   // Edge
+  REQUIRE(hood.GetNumNeighbors(hood.GetPos(2,2)) == 8);   // Interior
+  REQUIRE(NeighborSet(hood, hood.GetPos(0,0)) ==
+          std::set<size_t>{hood.GetPos(1,0), hood.GetPos(0,1), hood.GetPos(1,1)});
+
+  REQUIRE(hood.SetupGrid(5, 4, true, Neighborhood::VON_NEUMANN));
+  REQUIRE(NeighborSet(hood, hood.GetPos(0,0)) ==
+          std::set<size_t>{hood.GetPos(4,0), hood.GetPos(1,0), hood.GetPos(0,3), hood.GetPos(0,1)});
+
+  // Tiny tori never list a cell as its own neighbor or repeat a neighbor.
+  REQUIRE(hood.SetupGrid(2, 1, true, Neighborhood::MOORE));
+  REQUIRE(hood.GetNumNeighbors(0) == 1);
+  REQUIRE(hood.GetNeighbors(0)[0] == 1);
+
+  // Random neighbors come from the table.
+  emp::Random random(1);
+  REQUIRE(hood.SetupGrid(10, 10, true, Neighborhood::MOORE));
+  for (size_t i = 0; i < 100; ++i) {
+    const size_t pos = random.GetUInt(100);
+    REQUIRE(NeighborSet(hood, pos).count(hood.GetRandomNeighbor(pos, random)) == 1);
+  }
+}
+
+TEST_CASE("Neighborhood_Tiles", "[tools]"){
+  Neighborhood hood;
+  for (bool toroidal : {false, true}) {
+    for (size_t tile_size : {2, 3}) {
+      REQUIRE(hood.SetupGrid(12, 6, toroidal, Neighborhood::MOORE, tile_size, 2));
+      REQUIRE(hood.GetNumTiles() == (12 / tile_size) * 3);
+      REQUIRE(hood.GetTileSize() == tile_size * 2);
+
+      // Tiles are contiguous and positions map back to the same coordinates.
+      for (size_t pos = 0; pos < hood.GetNumCells(); ++pos) {
+        const size_t tile = hood.GetTile(pos);
+        REQUIRE(hood.GetPos(hood.GetX(pos), hood.GetY(pos)) == pos);
+        REQUIRE(hood.GetX(pos) / tile_size == hood.GetX(tile * hood.GetTileSize()) / tile_size);
+        REQUIRE(hood.GetY(pos) / 2 == hood.GetY(tile * hood.GetTileSize()) / 2);
+      }
+
+      // Same-colored tiles never touch the same cells: collect each tile's cells plus its
+      // neighbors, and make sure no cell is reached from two tiles of one color.
+      for (size_t color = 0; color < hood.GetNumTileColors(); ++color) {
+        emp::vector<size_t> owner(hood.GetNumCells(), (size_t) -1);
+        for (size_t tile = 0; tile < hood.GetNumTiles(); ++tile) {
+          if (hood.GetTileColor(tile) != color) continue;
+          auto [first, last] = hood.GetTileRange(tile);
+          for (size_t pos = first; pos < last; ++pos) {
+            std::set<size_t> reach = NeighborSet(hood, pos);
+            reach.insert(pos);
+            for (size_t cell : reach) {
+              REQUIRE((owner[cell] == (size_t) -1 || owner[cell] == tile));
+              owner[cell] = tile;
+            }
+          }
+        }
+      }
+    }
+  }
+  REQUIRE(hood.GetNumTileColors() == 6);  // 4x3 tiles on a torus: 2 colors across, 3 down.
+
+  REQUIRE_FALSE(hood.SetupGrid(12, 6, false, Neighborhood::MOORE, 5, 2));
+  REQUIRE_FALSE(hood.SetupGrid(12, 6, false, Neighborhood::MOORE, 1, 1));
+}
+
+TEST_CASE("Neighborhood_Graph", "[tools]"){
+  Neighborhood hood;
+  REQUIRE(hood.SetupGraph(4, {{0,1}, {1,2}, {2,0}, {3,3}}));
+  REQUIRE(hood.GetNumCells() == 4);
+  REQUIRE(NeighborSet(hood, 0) == std::set<size_t>{1, 2});
+  REQUIRE(NeighborSet(hood, 1) == std::set<size_t>{0, 2});
+  REQUIRE(hood.GetNumNeighbors(3) == 0);
+  emp::Random random(2);
+  REQUIRE(hood.GetRandomNeighbor(3, random) == Neighborhood::NO_POS);
+  REQUIRE_FALSE(hood.SetupGraph(2, {{0,5}}));
+}
@@ -0,0 +1,88 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ParetoFronts.cpp
+ *  @brief Tests for non-dominated sorting and crowding distance.
+ */
+
+#include <cmath>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/ParetoFronts.hpp"
+#include "tools/RandomStreams.hpp"
+
+// Brute-force front of each point: one more than the highest front of any dominating point.
+static emp::vector<size_t> SlowRanks(const emp::vector<double> & values, size_t num_points) {
+  const size_t num_objs = values.size() / num_points;
+  auto dominates = [&](size_t a, size_t b) {
+    bool better = false;
+    for (size_t obj = 0; obj < num_objs; ++obj) {
+      if (values[obj*num_points + a] < values[obj*num_points + b]) return false;
+      if (values[obj*num_points + a] > values[obj*num_points + b]) better = true;
+    }
+    return better;
+  };
+  emp::vector<size_t> ranks(num_points, 0);
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (size_t a = 0; a < num_points; ++a) {
+      for (size_t b = 0; b < num_points; ++b) {
+        if (dominates(a, b) && ranks[b] <= ranks[a]) { ranks[b] = ranks[a] + 1; changed = true; }
+      }
+    }
+  }
+  return ranks;
+}
+
+TEST_CASE("ParetoFronts_Basic", "[tools]"){
+  // Five points on two objectives: (4,1) (3,3) (1,4) (2,2) (1,1)
+  const emp::vector<double> values = { 4, 3, 1, 2, 1,
+                                       1, 3, 4, 2, 1 };
+  mabe::ParetoFronts fronts;
+  fronts.Calc(values, 5);
+  REQUIRE(fronts.GetNumObjectives() == 2);
+  REQUIRE(fronts.GetNumFronts() == 3);
+  REQUIRE(fronts.GetFront(0) == emp::vector<size_t>{0, 1, 2});
+  REQUIRE(fronts.GetFront(1) == emp::vector<size_t>{3});
+  REQUIRE(fronts.GetRank(4) == 2);
+
+  // Front 0: ends are infinitely crowded; (3,3) spans (4-1)/3 + (4-1)/3.
+  REQUIRE(std::isinf(fronts.GetCrowding(0)));
+  REQUIRE(std::isinf(fronts.GetCrowding(2)));
+  REQUIRE(fronts.GetCrowding(1) == Approx(2.0));
+  REQUIRE(fronts.IsPreferred(1, 3));
+  REQUIRE(fronts.IsPreferred(0, 1));
+
+  // Identical points share a front.
+  fronts.Calc(emp::vector<double>{2, 2, 1,  5, 5, 1}, 3);
+  REQUIRE(fronts.GetNumFronts() == 2);
+  REQUIRE(fronts.GetRank(0) == 0);
+  REQUIRE(fronts.GetRank(1) == 0);
+
+  fronts.Calc(emp::vector<double>{}, 0);
+  REQUIRE(fronts.GetNumFronts() == 0);
+}
+
+TEST_CASE("ParetoFronts_Random", "[tools]"){
+  mabe::RandomStreams streams(5);
+  mabe::ParetoFronts fronts;
+  for (size_t num_objs = 1; num_objs <= 4; ++num_objs) {
+    for (size_t trial = 0; trial < 20; ++trial) {
+      const size_t num_points = 5 + trial * 3;
+      emp::vector<double> values(num_objs * num_points);
+      uint64_t state = streams.CalcKey(num_objs, trial);
+      for (double & value : values) {
+        state = mabe::RandomStreams::Mix(state);
+        value = (double) (state % 6);   // Few values, so ties are common.
+      }
+      fronts.Calc(values, num_points);
+      const emp::vector<size_t> ranks = SlowRanks(values, num_points);
+      for (size_t id = 0; id < num_points; ++id) REQUIRE(fronts.GetRank(id) == ranks[id]);
+    }
+  }
+}
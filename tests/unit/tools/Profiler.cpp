@@ -0,0 +1,57 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Profiler.cpp
+ *  @brief Tests for accumulating named call counts and timings.
+ */
+
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/Profiler.hpp"
+
+
+TEST_CASE("Profiler_Record", "[tools]"){
+  mabe::Profiler profiler;
+  const size_t slot_a = profiler.GetSlot("mod_a:on_update");
+  const size_t slot_b = profiler.GetSlot("mod_b:on_update");
+  REQUIRE(slot_a != slot_b);
+  REQUIRE(profiler.GetSlot("mod_a:on_update") == slot_a);
+
+  profiler.Record(slot_a, 100);
+  profiler.Record(slot_a, 300);
+  profiler.Record(slot_b, 1000);
+  profiler.Record("@UPDATE (line 7)", 50);
+
+  REQUIRE(profiler.GetSize() == 3);
+  REQUIRE(profiler.GetEntry(slot_a).count == 2);
+  REQUIRE(profiler.GetEntry(slot_a).total_ns == 400);
+  REQUIRE(profiler.GetEntry(slot_a).max_ns == 300);
+  REQUIRE(profiler.GetEntry(slot_a).GetMeanNS() == 200.0);
+
+  // Sorted output is by total time, largest first.
+  auto sorted = profiler.GetSorted();
+  REQUIRE(sorted.size() == 3);
+  REQUIRE(sorted[0].name == "mod_b:on_update");
+  REQUIRE(sorted[1].name == "mod_a:on_update");
+  REQUIRE(sorted[2].name == "@UPDATE (line 7)");
+
+  std::stringstream ss;
+  profiler.WriteCSV(ss);
+  std::string line;
+  std::getline(ss, line);
+  REQUIRE(line == "section,calls,total_ns,mean_ns,max_ns");
+  std::getline(ss, line);
+  REQUIRE(line == "\"mod_b:on_update\",1,1000,1000,1000");
+
+  // Clearing keeps slots but drops timings.
+  profiler.Clear();
+  REQUIRE(profiler.GetSize() == 3);
+  REQUIRE(profiler.GetSorted().size() == 0);
+  REQUIRE(profiler.GetSlot("mod_b:on_update") == slot_b);
+}
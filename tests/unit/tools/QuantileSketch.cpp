@@ -0,0 +1,54 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  QuantileSketch.cpp
+ *  @brief Tests for approximate quantiles in bounded memory.
+ */
+
+#include <cmath>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/QuantileSketch.hpp"
+
+TEST_CASE("QuantileSketch_Small", "[tools]"){
+  mabe::QuantileSketch sketch;
+  CHECK(std::isnan(sketch.GetQuantile(0.5)));
+
+  for (int i = 1; i <= 9; ++i) sketch.Add(i);       // Few enough values to be exact.
+  CHECK(sketch.GetCount() == 9);
+  CHECK(sketch.GetQuantile(0.0) == 1.0);
+  CHECK(sketch.GetQuantile(0.5) == 5.0);
+  CHECK(sketch.GetQuantile(1.0) == 9.0);
+  sketch.Add(std::nan(""));                          // NaN values are skipped.
+  CHECK(sketch.GetCount() == 9);
+}
+
+TEST_CASE("QuantileSketch_Large", "[tools]"){
+  const size_t N = 200000;
+  mabe::QuantileSketch sketch;
+  // Values 0 to N-1 in a scrambled order.
+  for (size_t i = 0; i < N; ++i) sketch.Add((double) ((i * 7919) % N));
+  CHECK(sketch.GetCount() == N);
+  CHECK(sketch.GetNumRetained() < 4 * sketch.GetK());
+  CHECK(sketch.GetMin() == 0.0);
+  CHECK(sketch.GetMax() == (double) (N - 1));
+  for (double q : {0.01, 0.25, 0.5, 0.75, 0.99}) {
+    CHECK(std::abs(sketch.GetQuantile(q) / N - q) < 0.02);
+  }
+
+  // Sketches of two halves, merged, agree with the whole.
+  mabe::QuantileSketch low, high;
+  for (size_t i = 0; i < N / 2; ++i) low.Add((double) i);
+  for (size_t i = N / 2; i < N; ++i) high.Add((double) i);
+  low.Merge(high);
+  CHECK(low.GetCount() == N);
+  CHECK(low.GetNumRetained() < 4 * low.GetK());
+  for (double q : {0.1, 0.5, 0.9}) {
+    CHECK(std::abs(low.GetQuantile(q) / N - q) < 0.02);
+  }
+}
@@ -0,0 +1,33 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  RandomStreams.cpp
+ *  @brief Tests for deriving reproducible random streams from a base seed.
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/RandomStreams.hpp"
+
+
+TEST_CASE("RandomStreams_Reproducible", "[tools]"){
+  mabe::RandomStreams streams(42);
+
+  // The same keys should always produce the same seed...
+  REQUIRE(streams.CalcSeed(10, 0, 5) == streams.CalcSeed(10, 0, 5));
+  REQUIRE(streams.CalcSeed(10, 0, 5) > 0);
+
+  // ...while neighboring keys or a different base seed should not.
+  REQUIRE(streams.CalcSeed(10, 0, 5) != streams.CalcSeed(10, 0, 6));
+  REQUIRE(streams.CalcSeed(10, 0, 5) != streams.CalcSeed(11, 0, 5));
+  REQUIRE(streams.CalcSeed(10, 0, 5) != mabe::RandomStreams(43).CalcSeed(10, 0, 5));
+
+  emp::Random rng1 = streams.Make(3, 1, 4);
+  emp::Random rng2(1);
+  streams.Reseed(rng2, 3, 1, 4);
+  for (size_t i = 0; i < 100; ++i) REQUIRE(rng1.GetUInt() == rng2.GetUInt());
+}
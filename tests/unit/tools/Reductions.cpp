@@ -0,0 +1,57 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  Reductions.cpp
+ *  @brief Tests for fixed-shape sums and maxima.
+ */
+
+#include <cmath>
+#include <limits>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/Reductions.hpp"
+
+
+TEST_CASE("Reductions_Sum", "[tools]"){
+  REQUIRE(mabe::Reduce::SumOf(0, [](size_t){ return 1.0; }) == 0.0);
+  REQUIRE(mabe::Reduce::SumOf(10, [](size_t id){ return (double) id; }) == 45.0);
+
+  // Integers are summed exactly, whatever the block layout.
+  for (size_t count : {63, 64, 65, 1000, 4097}) {
+    const double total = mabe::Reduce::SumOf(count, [](size_t id){ return (double) id; });
+    REQUIRE(total == (double) (count * (count - 1) / 2));
+  }
+
+  // Pairwise combination keeps rounding error small on long sums.
+  const size_t count = 1000000;
+  const double total = mabe::Reduce::SumOf(count, [](size_t){ return 0.1; });
+  REQUIRE(std::abs(total - 100000.0) < 1e-6);
+
+  emp::vector<double> vals{0.5, 1.5, 2.5};
+  REQUIRE(mabe::Reduce::Sum(vals) == 4.5);
+}
+
+TEST_CASE("Reductions_CombineBlocks", "[tools]"){
+  emp::vector<double> sums{1.0, 2.0, 3.0, 4.0, 5.0};
+  REQUIRE(mabe::Reduce::CombineBlocks(sums) == 15.0);
+  emp::vector<double> empty;
+  REQUIRE(mabe::Reduce::CombineBlocks(empty) == 0.0);
+}
+
+TEST_CASE("Reductions_ArgMax", "[tools]"){
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  emp::vector<double> vals{nan, 3.0, 7.0, 2.0, 7.0, nan};
+  auto get = [&vals](size_t id){ return vals[id]; };
+
+  // NaNs are skipped and ties go to the earliest position.
+  REQUIRE(mabe::Reduce::ArgMaxOf(vals.size(), get) == 2);
+  REQUIRE(mabe::Reduce::IsNewMax(1.0, nan));
+  REQUIRE(!mabe::Reduce::IsNewMax(nan, 1.0));
+  REQUIRE(!mabe::Reduce::IsNewMax(7.0, 7.0));
+  REQUIRE(mabe::Reduce::ArgMaxOf(0, get) == 0);
+}
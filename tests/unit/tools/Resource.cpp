@@ -1,10 +1,10 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  Resource.cpp
- *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ *  @brief Tests for resource pools.
  */
 
 // CATCH
@@ -13,5 +13,43 @@
 // MABE
 #include "tools/Resource.hpp"
 
+TEST_CASE("Resource_Update", "[tools]"){
+  mabe::Resource res(10.0, 2.0, 0.5);
+  CHECK(res.Update() == Approx(7.0));   // 10 + 2 - 10*0.5
+  CHECK(res.Dec(100.0) == 0.0);         // Never goes negative.
+}
 
-TEST_CASE("Resource_Placeholder", "[core]"){ ; }
+TEST_CASE("ResourcePools_Consume", "[tools]"){
+  mabe::ResourcePools pools;
+  pools.Setup(2, 100.0, 0.0, 0.0);
+  mabe::ResourcePools::Params params;
+  params.frac = 0.01;
+  params.max_bonus = 5.0;
+
+  // Earlier organisms deplete the pool, so later ones with the same score gain less.
+  emp::vector<double> scores{1.0, 1.0, 0.0, 3.0};
+  emp::vector<double> bonuses(scores.size());
+  pools.Consume(0, scores, bonuses, params);
+  CHECK(bonuses[0] == Approx(1.0));
+  CHECK(bonuses[1] == Approx(0.99));
+  CHECK(bonuses[2] == 0.0);
+  CHECK(bonuses[3] == Approx(5.0));     // 9 * 0.01 * 98.01 is capped at max_bonus.
+  CHECK(pools.GetAmount(0) == Approx(100.0 - 1.0 - 0.99 - 5.0));
+  CHECK(pools.GetAmount(1) == 100.0);   // Other pools are untouched.
+
+  // Inflow is spread across organisms; outflow is removed after feeding.
+  pools.Setup(1, 0.0, 4.0, 0.5);
+  scores.assign(4, 0.0);
+  pools.Consume(0, scores, bonuses, params);
+  CHECK(pools.GetAmount(0) == Approx(2.0));
+
+  // Costs are charged against the pool and each bonus.
+  pools.Setup(1, 10.0, 0.0, 0.0);
+  params.cost = 1.0;
+  params.frac = 0.5;
+  scores.assign(1, 1.0);
+  bonuses.resize(1);
+  pools.Consume(0, scores, bonuses, params);
+  CHECK(bonuses[0] == Approx(0.5 * 9.0 - 1.0));
+  CHECK(pools.GetAmount(0) == Approx(10.0 - 3.5));
+}
@@ -0,0 +1,93 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ShardComm.cpp
+ *  @brief Tests for collective exchanges between shard ranks.
+ */
+
+#include <string>
+#include <thread>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+// MABE
+#include "tools/ShardComm.hpp"
+
+/// Run fun(comm) on each rank of a ThreadShardGroup, each in its own thread.
+template <typename FUN_T>
+void RunRanks(mabe::ThreadShardGroup & group, FUN_T fun) {
+  emp::vector<std::thread> threads;
+  for (size_t rank = 0; rank < group.GetNumRanks(); ++rank) {
+    threads.emplace_back([&group, &fun, rank](){ fun(group.GetComm(rank)); });
+  }
+  for (auto & thread : threads) thread.join();
+}
+
+TEST_CASE("ShardComm_Local", "[tools]"){
+  mabe::LocalShardComm comm;
+  REQUIRE(comm.GetRank() == 0);
+  REQUIRE(comm.GetNumRanks() == 1);
+  REQUIRE(comm.AllGather(2.5) == emp::vector<double>{2.5});
+  emp::vector<std::string> out = comm.AllToAll(emp::vector<std::string>{"abc"});
+  REQUIRE(out.size() == 1);
+  REQUIRE(out[0] == "abc");
+
+  mabe::ShardLayout layout(comm, 7);
+  REQUIRE(layout.GetTotal() == 7);
+  REQUIRE(layout.ToShard(5) == mabe::ShardPos{0, 5});
+}
+
+TEST_CASE("ShardComm_Threads", "[tools]"){
+  const size_t N = 4;
+  mabe::ThreadShardGroup group(N);
+  emp::vector<emp::vector<double>> gathered(N);
+  emp::vector<emp::vector<std::string>> received(N);
+
+  RunRanks(group, [&](mabe::ShardComm & comm){
+    const size_t rank = comm.GetRank();
+    gathered[rank] = comm.AllGather((double) rank * 10.0);
+    emp::vector<std::string> send(N);
+    for (size_t to = 0; to < N; ++to) send[to] = std::to_string(rank) + ">" + std::to_string(to);
+    received[rank] = comm.AllToAll(send);
+    received[rank] = comm.AllToAll(received[rank]);   // Back again; checks repeated rounds.
+  });
+
+  for (size_t rank = 0; rank < N; ++rank) {
+    REQUIRE(gathered[rank] == emp::vector<double>{0.0, 10.0, 20.0, 30.0});
+    for (size_t from = 0; from < N; ++from) {
+      REQUIRE(received[rank][from] == std::to_string(rank) + ">" + std::to_string(from));
+    }
+  }
+}
+
+TEST_CASE("ShardComm_Layout", "[tools]"){
+  mabe::ThreadShardGroup group(3);
+  const emp::vector<size_t> sizes = {4, 0, 6};
+  emp::vector<mabe::ShardLayout> layouts(3);
+  RunRanks(group, [&](mabe::ShardComm & comm){
+    layouts[comm.GetRank()] = mabe::ShardLayout(comm, sizes[comm.GetRank()]);
+  });
+
+  const mabe::ShardLayout & layout = layouts[1];
+  REQUIRE(layout.GetNumRanks() == 3);
+  REQUIRE(layout.GetTotal() == 10);
+  REQUIRE(layout.GetOffset(2) == 4);
+  REQUIRE(layout.GetSize(1) == 0);
+  REQUIRE(layout.ToShard(3) == mabe::ShardPos{0, 3});
+  REQUIRE(layout.ToShard(4) == mabe::ShardPos{2, 0});   // Empty rank 1 is skipped.
+  REQUIRE(layout.ToGlobal(mabe::ShardPos{2, 5}) == 9);
+}
+
+TEST_CASE("ShardComm_Pack", "[tools]"){
+  std::string bytes;
+  const emp::vector<uint64_t> ids = {3, 1, 4, 1, 5};
+  mabe::PackValues<uint64_t>(bytes, ids);
+  REQUIRE(bytes.size() == 5 * sizeof(uint64_t));
+  REQUIRE(mabe::UnpackValues<uint64_t>(bytes) == ids);
+  REQUIRE(mabe::UnpackValues<double>(std::string()).size() == 0);
+}
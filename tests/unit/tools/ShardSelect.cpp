@@ -0,0 +1,124 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ShardSelect.cpp
+ *  @brief Tests for selection across population shards.
+ */
+
+#include <string>
+#include <thread>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "tools/ShardSelect.hpp"
+
+template <typename FUN_T>
+void RunRanks(mabe::ThreadShardGroup & group, FUN_T fun) {
+  emp::vector<std::thread> threads;
+  for (size_t rank = 0; rank < group.GetNumRanks(); ++rank) {
+    threads.emplace_back([&group, &fun, rank](){ fun(group.GetComm(rank)); });
+  }
+  for (auto & thread : threads) thread.join();
+}
+
+TEST_CASE("ShardSelect_Roulette", "[tools]"){
+  // Rank 0 holds weights {1, 0}, rank 1 holds {2}, and rank 2 holds {0, 7}.
+  const emp::vector<emp::vector<double>> weights = { {1.0, 0.0}, {2.0}, {0.0, 7.0} };
+  mabe::ThreadShardGroup group(3);
+  emp::vector<emp::vector<mabe::ShardPos>> picks(3);
+  const size_t count = 20000;
+  RunRanks(group, [&](mabe::ShardComm & comm){
+    const size_t rank = comm.GetRank();
+    emp::Random random(1 + (int) rank);
+    picks[rank] = mabe::ShardSelect::PickRoulette(comm, weights[rank], rank == 1 ? 0 : count, random);
+  });
+
+  REQUIRE(picks[1].size() == 0);           // Ranks with no births still take part.
+  for (size_t rank : {0, 2}) {
+    REQUIRE(picks[rank].size() == count);
+    emp::vector<size_t> hits(3, 0);
+    for (mabe::ShardPos pos : picks[rank]) {
+      REQUIRE(weights[pos.rank][pos.index] > 0.0);   // Zero weights are never drawn.
+      ++hits[pos.rank];
+    }
+    REQUIRE(hits[0] > count * 0.09);   // Expect 10%, 20%, and 70% from each rank.
+    REQUIRE(hits[0] < count * 0.11);
+    REQUIRE(hits[1] > count * 0.18);
+    REQUIRE(hits[1] < count * 0.22);
+  }
+}
+
+TEST_CASE("ShardSelect_Tournament", "[tools]"){
+  const emp::vector<emp::vector<double>> fitness = { {1.0, 5.0}, {}, {3.0, 9.0, 2.0} };
+  mabe::ThreadShardGroup group(3);
+  emp::vector<emp::vector<mabe::ShardPos>> winners(3);
+  RunRanks(group, [&](mabe::ShardComm & comm){
+    const size_t rank = comm.GetRank();
+    emp::Random random(5 + (int) rank);
+    winners[rank] = mabe::ShardSelect::PickTournament(comm, fitness[rank], 1000, 5, random);
+  });
+
+  for (size_t rank = 0; rank < 3; ++rank) {
+    REQUIRE(winners[rank].size() == 1000);
+    size_t best_wins = 0, worst_wins = 0;
+    for (mabe::ShardPos pos : winners[rank]) {
+      REQUIRE(pos.index < fitness[pos.rank].size());
+      if (pos == mabe::ShardPos{2, 1}) ++best_wins;
+      if (pos == mabe::ShardPos{0, 0}) ++worst_wins;
+    }
+    REQUIRE(best_wins > 600);   // The best wins 1 - (4/5)^5 = 67% of contests of five...
+    REQUIRE(best_wins < 740);
+    REQUIRE(worst_wins < 10);   // ...and the worst only (1/5)^5 = 0.03%.
+  }
+
+  // Each tournament of one returns its only contestant, so all entries come up.
+  mabe::LocalShardComm local;
+  emp::Random random(3);
+  const emp::vector<double> local_fit = {1.0, 2.0, 3.0};
+  emp::vector<size_t> seen(3, 0);
+  for (mabe::ShardPos pos : mabe::ShardSelect::PickTournament(local, local_fit, 300, 1, random)) {
+    ++seen[pos.index];
+  }
+  for (size_t hits : seen) REQUIRE(hits > 0);
+  REQUIRE(mabe::ShardSelect::PickTournament(local, std::span<const double>(), 10, 2, random).size() == 0);
+}
+
+TEST_CASE("ShardSelect_FetchParents", "[tools]"){
+  mabe::ThreadShardGroup group(3);
+  emp::vector<mabe::ShardParents> fetched(3);
+  emp::vector<size_t> saves(3, 0);
+  // Every rank asks for the same parents, including two copies of one and one of its own.
+  const emp::vector<mabe::ShardPos> parents = { {0, 2}, {2, 1}, {0, 2}, {1, 0}, {2, 4} };
+  RunRanks(group, [&](mabe::ShardComm & comm){
+    const size_t rank = comm.GetRank();
+    fetched[rank] = mabe::ShardSelect::FetchParents(comm, parents,
+      [&](size_t index, std::string & out){
+        ++saves[rank];
+        out += "r" + std::to_string(rank) + "i" + std::to_string(index);
+      });
+  });
+
+  for (size_t rank = 0; rank < 3; ++rank) {
+    const mabe::ShardParents & got = fetched[rank];
+    REQUIRE(got.payload_ids.size() == parents.size());
+    for (size_t i = 0; i < parents.size(); ++i) {
+      if (parents[i].rank == rank) {
+        REQUIRE(got.payload_ids[i] == mabe::ShardParents::LOCAL);
+        continue;
+      }
+      const std::string expect = "r" + std::to_string(parents[i].rank) + "i" + std::to_string(parents[i].index);
+      REQUIRE(got.payloads[got.payload_ids[i]] == expect);
+    }
+  }
+  REQUIRE(fetched[1].payload_ids[0] == fetched[1].payload_ids[2]);   // Duplicates sent once.
+  REQUIRE(saves[0] == 2);   // Rank 0's one distinct parent, sent to ranks 1 and 2.
+  REQUIRE(saves[1] == 2);
+  REQUIRE(saves[2] == 4);   // Two distinct parents, sent to ranks 0 and 1.
+}
@@ -0,0 +1,49 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SharedMemoryCache.cpp
+ *  @brief Tests for sharing read-only tables through memory-mapped files.
+ */
+
+#include <filesystem>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/SharedMemoryCache.hpp"
+
+
+TEST_CASE("SharedMemoryCache_Reuse", "[tools]"){
+  const std::string dir = std::filesystem::temp_directory_path().string();
+  const std::string key = "SharedMemoryCache_test:1000";
+  mabe::SharedMemoryCache::Remove(key, dir);
+
+  size_t num_fills = 0;
+  auto fill = [&num_fills](std::span<double> values){
+    ++num_fills;
+    for (size_t i = 0; i < values.size(); ++i) values[i] = (double) i / 2.0;
+  };
+
+  // The first request builds the table; later ones map the same file.
+  auto table1 = mabe::SharedMemoryCache::GetArray<double>(key, 1000, fill, dir);
+  REQUIRE(num_fills == 1);
+  REQUIRE(table1.get()[0] == 0.0);
+  REQUIRE(table1.get()[999] == 499.5);
+
+  auto table2 = mabe::SharedMemoryCache::GetArray<double>(key, 1000, fill, dir);
+  REQUIRE(num_fills == 1);
+  REQUIRE(table2.get()[999] == 499.5);
+
+  // A table of a different size for the same key does not match, so it is rebuilt.
+  auto table3 = mabe::SharedMemoryCache::GetArray<double>(key, 10, fill, dir);
+  REQUIRE(num_fills == 2);
+  REQUIRE(table3.get()[9] == 4.5);
+
+  // Removing the file leaves existing mappings intact.
+  REQUIRE(mabe::SharedMemoryCache::Remove(key, dir));
+  REQUIRE(table1.get()[500] == 250.0);
+  REQUIRE(!mabe::SharedMemoryCache::Remove(key, dir));
+}
@@ -0,0 +1,71 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SharedResources.cpp
+ *  @brief Tests for sharing immutable resources between controllers.
+ */
+
+#include <atomic>
+#include <thread>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "emp/base/vector.hpp"
+#include "tools/SharedResources.hpp"
+
+
+TEST_CASE("SharedResources_Reuse", "[tools]"){
+  mabe::SharedResources registry;
+  size_t num_built = 0;
+  auto build = [&num_built](){ ++num_built; return emp::vector<int>{1, 2, 3}; };
+
+  // The same key shares one resource while it is held.
+  auto table1 = registry.Get<emp::vector<int>>("table", build);
+  auto table2 = registry.Get<emp::vector<int>>("table", build);
+  REQUIRE(num_built == 1);
+  REQUIRE(table1 == table2);
+  REQUIRE(table1->size() == 3);
+  REQUIRE(registry.GetNumActive() == 1);
+
+  // A different key builds a different resource.
+  auto other = registry.Get<emp::vector<int>>("other", build);
+  REQUIRE(num_built == 2);
+  REQUIRE(other != table1);
+  REQUIRE(registry.GetNumActive() == 2);
+
+  // Once every holder lets go, the resource is freed and a new request rebuilds it.
+  table1.reset();
+  table2.reset();
+  REQUIRE(registry.GetNumActive() == 1);
+  auto table3 = registry.Get<emp::vector<int>>("table", build);
+  REQUIRE(num_built == 3);
+  REQUIRE(registry.GetNumBuilds() == 3);
+
+  other.reset();
+  registry.Prune();
+  REQUIRE(registry.GetNumActive() == 1);
+}
+
+TEST_CASE("SharedResources_Threads", "[tools]"){
+  mabe::SharedResources registry;
+  std::atomic<size_t> num_built = 0;
+  emp::vector<std::shared_ptr<const emp::vector<double>>> results(8);
+  emp::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&, i](){
+      results[i] = registry.Get<emp::vector<double>>("landscape", [&num_built](){
+        ++num_built;
+        return emp::vector<double>(1000, 0.5);
+      });
+    });
+  }
+  for (auto & thread : threads) thread.join();
+
+  // Every thread gets the single copy that was built.
+  REQUIRE(num_built == 1);
+  for (auto & result : results) REQUIRE(result == results[0]);
+}
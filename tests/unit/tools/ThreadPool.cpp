@@ -0,0 +1,140 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  ThreadPool.cpp
+ *  @brief Tests for chunked parallel loops in the ThreadPool tool.
+ */
+
+#include <atomic>
+#include <limits>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/ThreadPool.hpp"
+
+
+TEST_CASE("ThreadPool_ForEach", "[tools]"){
+  for (size_t num_threads : {1, 2, 4}) {
+    mabe::ThreadPool pool(num_threads);
+    emp::vector<size_t> vals(1000, 0);
+    pool.ForEach(vals.size(), [&vals](size_t id){ vals[id] = id * 2; });
+    for (size_t i = 0; i < vals.size(); ++i) REQUIRE(vals[i] == i * 2);
+
+    // Max should be the same regardless of the number of threads.
+    double max_val = pool.MaxOf(vals.size(), [](size_t id){ return (double) ((id * 37) % 101); });
+    REQUIRE(max_val == 100.0);
+    REQUIRE(pool.MaxOf(0, [](size_t){ return 1.0; }) == 0.0);
+  }
+}
+
+TEST_CASE("ThreadPool_PinThreads", "[tools]"){
+  mabe::ThreadPool pool(4);
+  pool.SetPinThreads(true);
+  REQUIRE(pool.GetPinThreads());
+
+  // Statically assigned chunks must still cover every id exactly once.
+  emp::vector<size_t> vals(1000, 0);
+  pool.ForEach(vals.size(), [&vals](size_t id){ vals[id] += id + 1; });
+  for (size_t i = 0; i < vals.size(); ++i) REQUIRE(vals[i] == i + 1);
+  REQUIRE(pool.MaxOf(vals.size(), [](size_t id){ return (double) ((id * 37) % 101); }) == 100.0);
+
+  pool.SetPinThreads(false);
+  REQUIRE(!pool.GetPinThreads());
+  pool.ForEach(vals.size(), [&vals](size_t id){ vals[id] = 0; });
+  for (size_t val : vals) REQUIRE(val == 0);
+}
+
+TEST_CASE("ThreadPool_Restart", "[tools]"){
+  // Workers restarted after a job has run must wait for the next job, not rerun the last one
+  // (which would let a job return before all of its chunks ran).
+  for (bool pinned : {false, true}) {
+    mabe::ThreadPool pool(4);
+    pool.SetPinThreads(pinned);
+    emp::vector<std::atomic<size_t>> visits(64);
+    size_t expected = 0;
+    for (size_t round = 0; round < 1000; ++round) {
+      pool.ForEach(visits.size(), [&visits](size_t id){ ++visits[id]; });
+      ++expected;
+      for (size_t i = 0; i < visits.size(); ++i) REQUIRE(visits[i] == expected);
+      pool.SetNumThreads(round % 2 ? 4 : 3);
+    }
+    pool.SetPinThreads(!pinned);
+    pool.ForEach(visits.size(), [&visits](size_t id){ ++visits[id]; });
+    for (size_t i = 0; i < visits.size(); ++i) REQUIRE(visits[i] == expected + 1);
+  }
+}
+
+TEST_CASE("ThreadPool_ForEachTask", "[tools]"){
+  mabe::ThreadPool pool(4);
+  // Each task runs a nested job, which must run serially inside the task rather than deadlock.
+  emp::vector<size_t> sums(6, 0);
+  pool.ForEachTask(sums.size(), [&pool, &sums](size_t task){
+    emp::vector<size_t> vals(500, 0);
+    pool.ForEach(vals.size(), [&vals, task](size_t id){ vals[id] = id + task; });
+    for (size_t val : vals) sums[task] += val;
+  });
+  for (size_t task = 0; task < sums.size(); ++task) REQUIRE(sums[task] == 124750 + 500 * task);
+
+  // The pool is still usable for ordinary jobs afterward.
+  emp::vector<size_t> vals(1000, 0);
+  pool.ForEach(vals.size(), [&vals](size_t id){ vals[id] = id; });
+  for (size_t i = 0; i < vals.size(); ++i) REQUIRE(vals[i] == i);
+}
+
+TEST_CASE("ThreadPool_Reductions", "[tools]"){
+  const size_t count = 100000;
+  auto get_val = [](size_t id){ return 1.0 / (double) (id + 1); };
+  const double serial_sum = mabe::Reduce::SumOf(count, get_val);
+
+  for (size_t num_threads : {1, 2, 3, 4, 7}) {
+    mabe::ThreadPool pool(num_threads);
+    // Sums must be bit-identical for any number of threads.
+    REQUIRE(pool.SumOf(count, get_val) == serial_sum);
+    REQUIRE(pool.SumOf(0, get_val) == 0.0);
+
+    // Ties go to the lowest position; NaNs are skipped.
+    auto get_tie = [](size_t id){
+      if (id % 1000 == 5) return std::numeric_limits<double>::quiet_NaN();
+      return (double) ((id * 37) % 101);
+    };
+    const size_t best = pool.ArgMaxOf(count, get_tie);
+    REQUIRE(best == mabe::Reduce::ArgMaxOf(count, get_tie));
+    REQUIRE(get_tie(best) == 100.0);
+    REQUIRE(pool.MaxOf(count, [](size_t id){ return id ? (double) id : std::numeric_limits<double>::quiet_NaN(); })
+            == (double) (count - 1));
+  }
+}
+
+TEST_CASE("ThreadPool_ForEachByCost", "[tools]"){
+  mabe::ThreadPool pool(4);
+  for (bool pinned : {false, true}) {
+    pool.SetPinThreads(pinned);
+
+    // Every id is visited exactly once, whatever the costs (unknown costs included).
+    emp::vector<double> costs(500);
+    for (size_t i = 0; i < costs.size(); ++i) costs[i] = (i % 7 == 0) ? 0.0 : (double) (i % 50) * 10.0;
+    costs[3] = std::numeric_limits<double>::quiet_NaN();
+    emp::vector<std::atomic<size_t>> visits(costs.size());
+    pool.ForEachByCost(costs, [&visits](size_t id){ ++visits[id]; });
+    for (size_t i = 0; i < visits.size(); ++i) REQUIRE(visits[i] == 1);
+
+    // With no estimates at all, it still visits everything.
+    emp::vector<double> no_costs(100, 0.0);
+    std::atomic<size_t> total{0};
+    pool.ForEachByCost(no_costs, [&total](size_t id){ total += id; });
+    REQUIRE(total == 99 * 100 / 2);
+
+    pool.ForEachByCost(std::span<const double>(), [](size_t){ REQUIRE(false); });
+  }
+  pool.SetPinThreads(false);
+
+  // Serially, ids are visited in order.
+  mabe::ThreadPool serial(1);
+  emp::vector<size_t> order;
+  serial.ForEachByCost(emp::vector<double>{1.0, 5.0, 3.0}, [&order](size_t id){ order.push_back(id); });
+  REQUIRE(order == emp::vector<size_t>{0, 1, 2});
+}
@@ -0,0 +1,70 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  TraceBuffer.cpp
+ *  @brief Tests for the trace ring buffer and its file format.
+ */
+
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "tools/TraceBuffer.hpp"
+
+
+TEST_CASE("TraceBuffer_Ring", "[tools]"){
+  mabe::TraceBuffer trace;
+  REQUIRE(!trace.IsActive());
+  trace.SetCapacity(4);
+  REQUIRE(trace.IsActive());
+  REQUIRE(trace.GetSize() == 0);
+
+  for (uint32_t i = 0; i < 3; ++i) trace.Add({i, 1, i, 2, 0});
+  REQUIRE(trace.GetSize() == 3);
+  REQUIRE(trace.Get(0).time == 0);
+  REQUIRE(trace.Get(2).time == 2);
+
+  // Overflow keeps the most recent records, oldest first.
+  for (uint32_t i = 3; i < 10; ++i) trace.Add({i, 1, i, 2, 0});
+  REQUIRE(trace.GetSize() == 4);
+  REQUIRE(trace.GetNumAdded() == 10);
+  REQUIRE(trace.GetNumDropped() == 6);
+  uint64_t expected = 6;
+  trace.ForEach([&expected](const mabe::TraceRecord & record){
+    REQUIRE(record.time == expected++);
+  });
+
+  trace.Clear();
+  REQUIRE(trace.GetSize() == 0);
+  REQUIRE(trace.GetCapacity() == 4);
+}
+
+TEST_CASE("TraceBuffer_File", "[tools]"){
+  mabe::TraceBuffer trace(8);
+  trace.Add({5, 12, 0, 1, 7});
+  trace.Add({5, 12, 1, 0, 8});
+  trace.Add({6, 3, 40, 9, 0xffffffff});
+  const emp::vector<std::string> names = {"nop-A", "h-copy"};
+
+  std::stringstream ss;
+  trace.Write(ss, names);
+
+  mabe::TraceReader reader;
+  REQUIRE(reader.Load(ss));
+  REQUIRE(reader.GetOpNames() == names);
+  REQUIRE(reader.GetSize() == 3);
+  for (size_t i = 0; i < 3; ++i) REQUIRE(reader.GetRecords()[i] == trace.Get(i));
+
+  std::stringstream direct, loaded;
+  trace.Print(direct, names);
+  reader.Print(loaded);
+  REQUIRE(direct.str() == loaded.str());
+  REQUIRE(direct.str() == "5 [12] 0: h-copy (7)\n5 [12] 1: nop-A (8)\n6 [3] 40: op9 (4294967295)\n");
+
+  std::stringstream bad("MABETRC1\x05");
+  REQUIRE(!reader.Load(bad));
+}